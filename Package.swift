@@ -17,10 +17,12 @@ var targetDependencies :[Target.Dependency] = [
     .byName(name: "Utils"),
     .byName(name: "libyuv"),
     .byName(name: "AudioCodecs"),
+    .byName(name: "MediaTransport"),
 ]
 
 var targets: [Target] = [
     .target(name: "AudioCodecs",
+            dependencies: ["libyuv"],
             exclude: [
                 "AmrWB/readme.txt",
                 "AmrWB/makefile.gcc",
@@ -34,11 +36,16 @@ var targets: [Target] = [
                 "AmrWB/qisf_ns.tab",
                 "AmrWB/qpisf_2s.tab",
     ]),
+    .target(name: "MediaTransport",
+            dependencies: ["libyuv"]),
     .target(name: "libyuv"),
     .target(name: "Media", dependencies: targetDependencies),
+    .target(name: "MediaTestSupport",
+            dependencies: ["libyuv", "AudioCodecs", "MediaTransport"],
+            path: "Tests/MediaTestSupport"),
     .testTarget(
         name: "MediaTests",
-        dependencies: ["Media"]),
+        dependencies: ["Media", "MediaTestSupport"]),
 ]
 
 let package = Package(
@@ -8,6 +8,7 @@
 #import <Foundation/Foundation.h>
 #include "amrwb_codec.h"
 #include "RTPAudioCodec.h"
+#include "../AudioLevel/audio_level.h"
 #include <iostream>
 #include <memory>
 @interface AmrWBCodec : NSObject<RTPAudioCodec> {
@@ -30,6 +31,8 @@ typedef NS_ENUM(NSInteger, BitrateMode) {
     BitrateModeMode_24k,
 };
 @synthesize codecType;
+@synthesize audioLevel;
+@synthesize voiceActivity;
 -(instancetype) init:(BitrateMode) bitmode {
     if( self = [super init] ) {
         mode = (int)bitmode;
@@ -49,6 +52,8 @@ typedef NS_ENUM(NSInteger, BitrateMode) {
 -(NSData*)encode:(NSData*)data {
     int length = [self encodedDataLength:(BitrateMode)mode];
     auto packets = std::make_unique<uint8_t[]>(length);
+    audioLevel = AudioLevel_Compute((const int16_t*)data.bytes, (int)(data.length / 2));
+    voiceActivity = audioLevel <= AUDIO_LEVEL_VOICE_THRESHOLD;
     codec->Encode((uint8_t*)data.bytes, packets.get(), mode);
     return [NSData dataWithBytes:packets.get() length:length];
 }
@@ -0,0 +1,257 @@
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+#include "audio_level.h"
+#include "../Dsp/pcm_simd.h"
+
+#define RTP_FIXED_HEADER_SIZE   12
+#define ONE_BYTE_PROFILE_ID     0xBEDE
+#define TWO_BYTE_PROFILE_ID     0x1000      // low 4 bits are appbits
+
+#define SPEAKER_SWITCH_MARGIN   (3 << 4)    // 3 dB before the dominant speaker changes
+#define SPEAKER_HOLD_MS         1000
+
+//-------------------------------------------------------------------------------------//
+
+int AudioLevel_Compute(const int16_t *pcm, int samples)
+{
+	uint64_t energy;
+	double dbov;
+	int level;
+
+	if (samples <= 0)
+		return AUDIO_LEVEL_SILENCE;
+
+	energy = PcmEnergy(pcm, samples);
+	if (energy == 0)
+		return AUDIO_LEVEL_SILENCE;
+
+	// mean square relative to the 16-bit overload point
+	dbov = 10.0 * log10((double)energy / samples / (32768.0 * 32768.0));
+	level = (int)(-dbov + 0.5);
+	if (level < 0) level = 0;
+	if (level > AUDIO_LEVEL_SILENCE) level = AUDIO_LEVEL_SILENCE;
+	return level;
+}
+
+//-------------------------------------------------------------------------------------//
+
+int AudioLevel_WriteExtension(uint8_t *packet, int length, int capacity, int id, int level, int voice)
+{
+	int offset;
+	uint8_t value = (uint8_t)((voice ? 0x80 : 0x00) | (level & 0x7F));
+	uint8_t *ext;
+
+	if (length < RTP_FIXED_HEADER_SIZE || id <= 0 || id > 255)
+		return -1;
+	offset = RTP_FIXED_HEADER_SIZE + 4 * (packet[0] & 0x0F);
+	if (length < offset)
+		return -1;
+
+	if (!(packet[0] & 0x10)) {
+		if (length + 8 > capacity)
+			return -1;
+		memmove(packet + offset + 8, packet + offset, length - offset);
+		ext = packet + offset;
+		if (id <= 14) {
+			ext[0] = ONE_BYTE_PROFILE_ID >> 8; ext[1] = ONE_BYTE_PROFILE_ID & 0xFF;
+			ext[4] = (uint8_t)(id << 4);        // len - 1 = 0
+			ext[5] = value;
+			ext[6] = 0;
+		} else {
+			ext[0] = TWO_BYTE_PROFILE_ID >> 8; ext[1] = TWO_BYTE_PROFILE_ID & 0xFF;
+			ext[4] = (uint8_t)id;
+			ext[5] = 1;
+			ext[6] = value;
+		}
+		ext[2] = 0; ext[3] = 1;                 // one 32-bit word
+		ext[7] = 0;
+		packet[0] |= 0x10;
+		return length + 8;
+	}
+
+	// append one word to the existing block, earlier padding bytes are skipped by readers
+	if (offset + 4 > length)
+		return -1;
+	int profile = (packet[offset] << 8) | packet[offset + 1];
+	int words = (packet[offset + 2] << 8) | packet[offset + 3];
+	int end = offset + 4 + 4 * words;
+	uint8_t element[4] = {0, 0, 0, 0};
+
+	if (profile == ONE_BYTE_PROFILE_ID && id <= 14) {
+		element[0] = (uint8_t)(id << 4);
+		element[1] = value;
+	} else if ((profile & 0xFFF0) == TWO_BYTE_PROFILE_ID) {
+		element[0] = (uint8_t)id;
+		element[1] = 1;
+		element[2] = value;
+	} else {
+		return -1;
+	}
+	if (end > length || length + 4 > capacity || words == 0xFFFF)
+		return -1;
+
+	memmove(packet + end + 4, packet + end, length - end);
+	memcpy(packet + end, element, 4);
+	words++;
+	packet[offset + 2] = (uint8_t)(words >> 8);
+	packet[offset + 3] = (uint8_t)words;
+	return length + 4;
+}
+
+int AudioLevel_ReadExtension(const uint8_t *packet, int length, int id, int *voice)
+{
+	int offset, profile, end, pos;
+
+	if (length < RTP_FIXED_HEADER_SIZE || (packet[0] >> 6) != 2 || !(packet[0] & 0x10))
+		return -1;
+
+	offset = RTP_FIXED_HEADER_SIZE + 4 * (packet[0] & 0x0F);
+	if (offset + 4 > length)
+		return -1;
+	profile = (packet[offset] << 8) | packet[offset + 1];
+	end = offset + 4 + 4 * ((packet[offset + 2] << 8) | packet[offset + 3]);
+	if (end > length)
+		return -1;
+
+	pos = offset + 4;
+	if (profile == ONE_BYTE_PROFILE_ID) {
+		while (pos < end) {
+			int eid = packet[pos] >> 4;
+			int elen = (packet[pos] & 0x0F) + 1;
+			if (packet[pos] == 0) {             // padding
+				pos++;
+				continue;
+			}
+			if (eid == 15 || pos + 1 + elen > end)
+				break;
+			if (eid == id) {
+				if (voice) *voice = packet[pos + 1] >> 7;
+				return packet[pos + 1] & 0x7F;
+			}
+			pos += 1 + elen;
+		}
+	} else if ((profile & 0xFFF0) == TWO_BYTE_PROFILE_ID) {
+		while (pos + 1 < end) {
+			int eid = packet[pos];
+			int elen = packet[pos + 1];
+			if (eid == 0) {
+				pos++;
+				continue;
+			}
+			if (pos + 2 + elen > end)
+				break;
+			if (eid == id && elen >= 1) {
+				if (voice) *voice = packet[pos + 2] >> 7;
+				return packet[pos + 2] & 0x7F;
+			}
+			pos += 2 + elen;
+		}
+	}
+	return -1;
+}
+
+//-------------------------------------------------------------------------------------//
+
+CActiveSpeakerDetector::CActiveSpeakerDetector(int extensionId, int maxStreams, bool voiceGate)
+	: extensionId(extensionId)
+	, maxStreams(maxStreams)
+	, voiceGate(voiceGate)
+	, holdMs(SPEAKER_HOLD_MS)
+	, dominant(0)
+{
+	streams.reserve(maxStreams);
+	order.reserve(maxStreams);
+	index.reserve(maxStreams);
+}
+
+CActiveSpeakerDetector::~CActiveSpeakerDetector()
+{
+}
+
+bool CActiveSpeakerDetector::OnPacket(const uint8_t *packet, int length, uint32_t nowMs)
+{
+	int voice = 1;
+	int level = AudioLevel_ReadExtension(packet, length, extensionId, &voice);
+
+	if (level < 0)
+		return false;
+
+	uint32_t ssrc = ((uint32_t)packet[8] << 24) | ((uint32_t)packet[9] << 16) |
+	                ((uint32_t)packet[10] << 8) | packet[11];
+	Update(ssrc, level, voice, nowMs);
+	return true;
+}
+
+void CActiveSpeakerDetector::Update(uint32_t ssrc, int level, int voice, uint32_t nowMs)
+{
+	auto it = index.find(ssrc);
+	int slot;
+
+	if (it == index.end()) {
+		if ((int)streams.size() >= maxStreams)
+			return;
+		slot = (int)streams.size();
+		streams.push_back(Stream{ssrc, nowMs - holdMs - 1, 0});
+		index[ssrc] = slot;
+	} else {
+		slot = it->second;
+	}
+
+	Stream &s = streams[slot];
+	bool active = voiceGate ? voice != 0 : level <= AUDIO_LEVEL_VOICE_THRESHOLD;
+	int sample = !voiceGate || voice ? (AUDIO_LEVEL_SILENCE - level) << 4 : 0;
+
+	// fast attack, slow decay, in 1/16 dB steps
+	s.score = sample > s.score ? (s.score + sample) >> 1 : (s.score * 7 + sample) >> 3;
+	if (active)
+		s.lastVoiceMs = nowMs;
+}
+
+void CActiveSpeakerDetector::RemoveStream(uint32_t ssrc)
+{
+	auto it = index.find(ssrc);
+	if (it == index.end())
+		return;
+
+	int slot = it->second;
+	int last = (int)streams.size() - 1;
+	index.erase(it);
+	if (slot != last) {
+		streams[slot] = streams[last];
+		index[streams[slot].ssrc] = slot;
+	}
+	streams.pop_back();
+	if (dominant == ssrc)
+		dominant = 0;
+}
+
+int CActiveSpeakerDetector::RankSpeakers(uint32_t *ssrcs, int maxCount, uint32_t nowMs)
+{
+	int count = 0;
+	int current = -1;
+
+	order.clear();
+	for (int i = 0; i < (int)streams.size(); i++) {
+		if (nowMs - streams[i].lastVoiceMs > holdMs)
+			continue;
+		order.push_back(i);
+		if (streams[i].ssrc == dominant)
+			current = i;
+	}
+
+	count = std::min(maxCount, (int)order.size());
+	std::partial_sort(order.begin(), order.begin() + count, order.end(),
+		[this](int a, int b) { return streams[a].score > streams[b].score; });
+
+	for (int i = 0; i < count; i++)
+		ssrcs[i] = streams[order[i]].ssrc;
+
+	if (count > 0) {
+		const Stream &top = streams[order[0]];
+		if (current < 0 || top.score > streams[current].score + SPEAKER_SWITCH_MARGIN)
+			dominant = top.ssrc;
+	}
+	return count;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include <unordered_map>
+
+//-------------------------------------------------------------------------------------//
+//
+// RFC 6464 client-to-mixer audio level indication
+//
+//  0                   1
+//  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+// |  ID   | len=0 |V| level       |
+// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//
+// level is -dBov of the frame in [0:127], 0 loudest, 127 silence.
+// The sender computes it from the PCM frame it is about to encode; the
+// forwarding side reads it back from the header alone, without decoding.
+//
+//-------------------------------------------------------------------------------------//
+
+#define AUDIO_LEVEL_SILENCE         127
+#define AUDIO_LEVEL_VOICE_THRESHOLD 50      // -50 dBov and louder counts as voice without a VAD
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int AudioLevel_Compute(const int16_t *pcm, int samples);
+
+// Inserts the extension after the fixed header and CSRCs of a built RTP packet,
+// moving the payload. Reuses an existing one- or two-byte extension block.
+// Returns the new packet length or -1 if it does not fit in capacity.
+int AudioLevel_WriteExtension(uint8_t *packet, int length, int capacity, int id, int level, int voice);
+
+// Returns the level carried by extension id or -1 when absent.
+int AudioLevel_ReadExtension(const uint8_t *packet, int length, int id, int *voice);
+
+#ifdef __cplusplus
+}
+#endif
+
+//-------------------------------------------------------------------------------------//
+//
+// SFU side ranking of streams by the levels carried in their packets.
+//
+//-------------------------------------------------------------------------------------//
+
+class CActiveSpeakerDetector
+{
+public:
+	// With voiceGate the V bit decides whether a packet counts as speech, otherwise
+	// the level alone does (AUDIO_LEVEL_VOICE_THRESHOLD), as many senders run
+	// without a VAD and always send V=0.
+	CActiveSpeakerDetector(int extensionId, int maxStreams, bool voiceGate = false);
+	virtual ~CActiveSpeakerDetector();
+
+	// Returns false when the packet carries no audio level extension.
+	bool OnPacket(const uint8_t *packet, int length, uint32_t nowMs);
+	void Update(uint32_t ssrc, int level, int voice, uint32_t nowMs);
+	void RemoveStream(uint32_t ssrc);
+
+	// Loudest first. Streams silent for longer than the hold time are skipped.
+	int RankSpeakers(uint32_t *ssrcs, int maxCount, uint32_t nowMs);
+	uint32_t DominantSpeaker() const { return dominant; }
+
+	void SetHoldTime(uint32_t ms) { holdMs = ms; }
+
+protected:
+	struct Stream {
+		uint32_t ssrc;
+		uint32_t lastVoiceMs;
+		int score;			// smoothed (127 - level) << 4
+	};
+
+	int extensionId;
+	int maxStreams;
+	bool voiceGate;
+	uint32_t holdMs;
+	uint32_t dominant;
+	std::vector<Stream> streams;
+	std::vector<int> order;
+	std::unordered_map<uint32_t, int> index;
+};
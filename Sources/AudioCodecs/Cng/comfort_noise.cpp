@@ -0,0 +1,203 @@
+#include <math.h>
+#include <string.h>
+
+#include "comfort_noise.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "../iLBC/iLBC_define.h"
+#include "../iLBC/constants.h"
+#include "../iLBC/helpfun.h"
+#include "../iLBC/syntFilter.h"
+#ifdef __cplusplus
+}
+#endif
+
+#define CN_CHUNK                480     // 30 ms at 16 kHz
+#define CN_SMOOTHING            0.7f    // weight of the previous estimate
+#define CN_FULL_SCALE           32768.0f
+
+//-------------------------------------------------------------------------------------//
+
+CComfortNoiseEncoder::CComfortNoiseEncoder(int order)
+	: order(order < 1 ? 1 : (order > CN_MAX_ORDER ? CN_MAX_ORDER : order))
+{
+	Reset();
+}
+
+CComfortNoiseEncoder::~CComfortNoiseEncoder()
+{
+}
+
+void CComfortNoiseEncoder::Reset()
+{
+	memset(acf, 0, sizeof(acf));
+	frames = 0;
+	lastLevel = -1;
+}
+
+void CComfortNoiseEncoder::Analyze(const short *frame, int samples)
+{
+	float buf[CN_CHUNK];
+	float r[CN_MAX_ORDER + 1];
+	float sum[CN_MAX_ORDER + 1] = {0};
+	int i, done, n;
+
+	if (samples <= order)
+		return;
+
+	for (done = 0; done < samples; done += n) {
+		n = samples - done < CN_CHUNK ? samples - done : CN_CHUNK;
+		if (n <= order)
+			break;
+		for (i = 0; i < n; i++)
+			buf[i] = (float)frame[done + i];
+		ilbc_autocorr(r, buf, n, order);
+		for (i = 0; i <= order; i++)
+			sum[i] += r[i];
+	}
+
+	for (i = 0; i <= order; i++) {
+		float v = sum[i] / samples;
+		acf[i] = frames ? CN_SMOOTHING * acf[i] + (1.0f - CN_SMOOTHING) * v : v;
+	}
+	frames++;
+}
+
+int CComfortNoiseEncoder::CurrentLevel() const
+{
+	if (acf[0] <= 1.0f)
+		return 127;
+
+	int level = (int)(-10.0f * log10f(acf[0] / (CN_FULL_SCALE * CN_FULL_SCALE)) + 0.5f);
+	return level < 0 ? 0 : (level > 127 ? 127 : level);
+}
+
+int CComfortNoiseEncoder::Encode(unsigned char *payload)
+{
+	float r[CN_MAX_ORDER + 1];
+	float lp[CN_MAX_ORDER + 1];
+	float k[CN_MAX_ORDER];
+	int i;
+
+	lastLevel = CurrentLevel();
+	payload[0] = (unsigned char)lastLevel;
+	if (frames == 0)
+		return 1;                       // level only, flat spectrum
+
+	// same conditioning as the iLBC analysis : lag window and white noise correction
+	window(r, acf, lpc_lagwinTbl, order + 1);
+	r[0] *= LPC_WN;
+	levdurb(lp, k, r, order);
+
+	for (i = 0; i < order; i++) {
+		int q = (int)floorf(k[i] * 128.0f + 127.5f);
+		payload[1 + i] = (unsigned char)(q < 0 ? 0 : (q > 255 ? 255 : q));
+	}
+	return 1 + order;
+}
+
+bool CComfortNoiseEncoder::NeedsUpdate() const
+{
+	if (frames == 0)
+		return false;
+	if (lastLevel < 0)
+		return true;
+
+	int drift = CurrentLevel() - lastLevel;
+	return drift > CN_UPDATE_THRESHOLD || drift < -CN_UPDATE_THRESHOLD;
+}
+
+//-------------------------------------------------------------------------------------//
+
+CComfortNoiseDecoder::CComfortNoiseDecoder()
+{
+	Reset();
+}
+
+CComfortNoiseDecoder::~CComfortNoiseDecoder()
+{
+}
+
+void CComfortNoiseDecoder::Reset()
+{
+	memset(a, 0, sizeof(a));
+	a[0] = 1.0f;
+	memset(mem, 0, sizeof(mem));
+	gain = 0.0f;
+	targetGain = 0.0f;
+	seed = 12345;
+	valid = false;
+}
+
+bool CComfortNoiseDecoder::Update(const unsigned char *payload, int length)
+{
+	float k[CN_MAX_ORDER];
+	float prev[CN_MAX_ORDER + 1];
+	float error = 1.0f;
+	int n, m, i;
+
+	if (length < 1)
+		return false;
+
+	n = length - 1 > CN_MAX_ORDER ? CN_MAX_ORDER : length - 1;
+	for (i = 0; i < n; i++)
+		k[i] = (payload[1 + i] - 127) / 128.0f;
+
+	// reflection -> direct form (step-up, same recursion as levdurb)
+	memset(a, 0, sizeof(a));
+	a[0] = 1.0f;
+	for (m = 0; m < n; m++) {
+		memcpy(prev, a, sizeof(a));
+		for (i = 1; i <= m; i++)
+			a[i] = prev[i] + k[m] * prev[m + 1 - i];
+		a[m + 1] = k[m];
+		error *= 1.0f - k[m] * k[m];
+	}
+	if (error < 1e-4f)
+		error = 1e-4f;
+
+	// excitation gain so that the filtered noise has the signalled level
+	float rms = CN_FULL_SCALE * powf(10.0f, -(payload[0] & 0x7F) / 20.0f);
+	targetGain = rms * sqrtf(error);
+	if (!valid)
+		gain = targetGain;
+	valid = true;
+	return true;
+}
+
+void CComfortNoiseDecoder::Generate(short *out, int samples)
+{
+	float buf[CN_CHUNK];
+	int i, done, n;
+
+	if (!valid || samples < CN_MAX_ORDER) {
+		memset(out, 0, samples * sizeof(short));
+		return;
+	}
+
+	for (done = 0; done < samples; done += n) {
+		n = samples - done < CN_CHUNK ? samples - done : CN_CHUNK;
+		if (samples - done - n > 0 && samples - done - n < CN_MAX_ORDER)
+			n -= CN_MAX_ORDER;          // keep the last chunk long enough for syntFilter
+
+		// ramp to the new gain over the chunk, uniform noise scaled to unit variance
+		float step = (targetGain - gain) / n;
+		for (i = 0; i < n; i++) {
+			seed = seed * 1103515245u + 12345u;
+			gain += step;
+			buf[i] = gain * 1.7320508f * ((int32_t)seed * (1.0f / 2147483648.0f));
+		}
+		gain = targetGain;
+
+		syntFilter(buf, a, n, mem);
+
+		for (i = 0; i < n; i++) {
+			float v = buf[i];
+			if (v > 32767.0f) v = 32767.0f;
+			if (v < -32768.0f) v = -32768.0f;
+			out[done + i] = (short)v;
+		}
+	}
+}
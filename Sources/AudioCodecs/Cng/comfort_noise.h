@@ -0,0 +1,71 @@
+#pragma once
+#include <stdint.h>
+
+//-------------------------------------------------------------------------------------//
+//
+// RFC 3389 comfort noise for codecs without DTX (G.711, iLBC)
+//
+// payload : | level | k1 | k2 | ... | kN |
+//   level : noise level in -dBov (0..127)
+//   kn    : reflection coefficient, q = round(k * 128) + 127
+//
+// The encoder averages the autocorrelation of the frames the VAD marked as
+// silence and runs the iLBC Levinson-Durbin (levdurb) on it. The decoder turns the
+// coefficients back into A(z) and shapes white noise with the iLBC syntFilter,
+// so one SID per silence period is enough to keep the far end filled.
+//
+//-------------------------------------------------------------------------------------//
+
+#define CN_PAYLOAD_TYPE         13
+#define CN_MAX_ORDER            10      // LPC_FILTERORDER of the iLBC filters
+#define CN_MAX_PAYLOAD          (1 + CN_MAX_ORDER)
+#define CN_UPDATE_THRESHOLD     3       // dB of level drift before a new SID is due
+
+class CComfortNoiseEncoder
+{
+public:
+	explicit CComfortNoiseEncoder(int order = CN_MAX_ORDER);
+	virtual ~CComfortNoiseEncoder();
+
+	void Reset();
+
+	// Adds a silent frame to the noise estimate.
+	void Analyze(const short *frame, int samples);
+
+	// Writes the SID for the current estimate, returns the payload length.
+	int Encode(unsigned char *payload);
+
+	// true when the level drifted from the last encoded SID
+	bool NeedsUpdate() const;
+
+protected:
+	int CurrentLevel() const;
+
+	int order;
+	int frames;
+	int lastLevel;
+	float acf[CN_MAX_ORDER + 1];        // smoothed autocorrelation per sample
+};
+
+class CComfortNoiseDecoder
+{
+public:
+	CComfortNoiseDecoder();
+	virtual ~CComfortNoiseDecoder();
+
+	void Reset();
+
+	// Takes a CN payload (without RTP header). Returns false if it is malformed.
+	bool Update(const unsigned char *payload, int length);
+
+	// Synthesizes samples of comfort noise (at least CN_MAX_ORDER per call).
+	void Generate(short *out, int samples);
+
+protected:
+	float a[CN_MAX_ORDER + 1];          // A(z), a[0] = 1
+	float mem[CN_MAX_ORDER];            // syntFilter state
+	float gain;                         // excitation gain in use
+	float targetGain;                   // excitation gain of the last SID
+	uint32_t seed;
+	bool valid;
+};
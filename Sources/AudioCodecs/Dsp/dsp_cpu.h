@@ -0,0 +1,46 @@
+//
+//  dsp_cpu.h
+//
+//  SIMD availability for the audio DSP kernels.
+//  Kernels are compiled per instruction set and picked at runtime with
+//  libyuv's cpu detection, the same way libyuv selects its row functions.
+//
+
+#ifndef DSP_CPU_H
+#define DSP_CPU_H
+
+#include "libyuv/cpu_id.h"
+
+#if defined(__has_feature)
+#if __has_feature(memory_sanitizer)
+#define DSP_DISABLE_X86
+#endif
+#endif
+
+#if !defined(DSP_DISABLE_X86) && defined(__SSE2__) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define DSP_HAS_SSE2
+#define DSP_HAS_AVX2
+#include <immintrin.h>
+#define DSP_TARGET_AVX2 __attribute__((target("avx2")))
+#define DSP_TARGET_AVX2_FMA __attribute__((target("avx2,fma")))
+#endif
+
+#if !defined(DSP_DISABLE_NEON) && (defined(__ARM_NEON__) || defined(__aarch64__))
+#define DSP_HAS_NEON
+#include <arm_neon.h>
+#endif
+
+#ifdef __cplusplus
+#define DSP_TEST_CPU(flag) libyuv::TestCpuFlag(libyuv::flag)
+#else
+#define DSP_TEST_CPU(flag) TestCpuFlag(flag)
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define DSP_ALIGNED(n) __attribute__((aligned(n)))
+#else
+#define DSP_ALIGNED(n)
+#endif
+
+#endif
@@ -0,0 +1,280 @@
+//
+//  pcm_simd.cpp
+//
+
+#include "pcm_simd.h"
+#include "dsp_cpu.h"
+
+//-------------------------------------------------------------------------------------//
+// scalar reference
+
+static inline int16_t sat16(int32_t v)
+{
+	if (v > 32767) return 32767;
+	if (v < -32768) return -32768;
+	return (int16_t)v;
+}
+
+static uint64_t PcmEnergy_C(const int16_t *src, int count)
+{
+	uint64_t energy = 0;
+	for (int i = 0; i < count; i++)
+		energy += (uint64_t)((int32_t)src[i] * src[i]);
+	return energy;
+}
+
+static void PcmAccumulate_C(int32_t *acc, const int16_t *src, int count)
+{
+	for (int i = 0; i < count; i++)
+		acc[i] += src[i];
+}
+
+static void PcmSaturate_C(int16_t *dst, const int32_t *acc, int count)
+{
+	for (int i = 0; i < count; i++)
+		dst[i] = sat16(acc[i]);
+}
+
+static void PcmSaturateMinus_C(int16_t *dst, const int32_t *acc, const int16_t *own, int count)
+{
+	for (int i = 0; i < count; i++)
+		dst[i] = sat16(acc[i] - own[i]);
+}
+
+
+//-------------------------------------------------------------------------------------//
+// SSE2 : 8 samples per step
+
+#if defined(DSP_HAS_SSE2)
+static uint64_t PcmEnergy_SSE2(const int16_t *src, int count)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i sum = _mm_setzero_si128();
+	uint64_t lanes[2];
+
+	for (int i = 0; i < count; i += 8) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+		__m128i sq = _mm_madd_epi16(v, v);	// <= 2^31 per lane, read as unsigned
+		sum = _mm_add_epi64(sum, _mm_unpacklo_epi32(sq, zero));
+		sum = _mm_add_epi64(sum, _mm_unpackhi_epi32(sq, zero));
+	}
+	_mm_storeu_si128((__m128i *)lanes, sum);
+	return lanes[0] + lanes[1];
+}
+
+static void PcmAccumulate_SSE2(int32_t *acc, const int16_t *src, int count)
+{
+	for (int i = 0; i < count; i += 8) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+		__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+		__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+		__m128i a0 = _mm_loadu_si128((const __m128i *)(acc + i));
+		__m128i a1 = _mm_loadu_si128((const __m128i *)(acc + i + 4));
+		_mm_storeu_si128((__m128i *)(acc + i), _mm_add_epi32(a0, lo));
+		_mm_storeu_si128((__m128i *)(acc + i + 4), _mm_add_epi32(a1, hi));
+	}
+}
+
+static void PcmSaturate_SSE2(int16_t *dst, const int32_t *acc, int count)
+{
+	for (int i = 0; i < count; i += 8) {
+		__m128i a0 = _mm_loadu_si128((const __m128i *)(acc + i));
+		__m128i a1 = _mm_loadu_si128((const __m128i *)(acc + i + 4));
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_packs_epi32(a0, a1));
+	}
+}
+
+static void PcmSaturateMinus_SSE2(int16_t *dst, const int32_t *acc, const int16_t *own, int count)
+{
+	for (int i = 0; i < count; i += 8) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(own + i));
+		__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+		__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+		__m128i a0 = _mm_sub_epi32(_mm_loadu_si128((const __m128i *)(acc + i)), lo);
+		__m128i a1 = _mm_sub_epi32(_mm_loadu_si128((const __m128i *)(acc + i + 4)), hi);
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_packs_epi32(a0, a1));
+	}
+}
+#endif
+
+//-------------------------------------------------------------------------------------//
+// AVX2 : 16 samples per step
+
+#if defined(DSP_HAS_AVX2)
+DSP_TARGET_AVX2
+static uint64_t PcmEnergy_AVX2(const int16_t *src, int count)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i sum = _mm256_setzero_si256();
+	uint64_t lanes[4];
+
+	for (int i = 0; i < count; i += 16) {
+		__m256i v = _mm256_loadu_si256((const __m256i *)(src + i));
+		__m256i sq = _mm256_madd_epi16(v, v);
+		sum = _mm256_add_epi64(sum, _mm256_unpacklo_epi32(sq, zero));
+		sum = _mm256_add_epi64(sum, _mm256_unpackhi_epi32(sq, zero));
+	}
+	_mm256_storeu_si256((__m256i *)lanes, sum);
+	return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+DSP_TARGET_AVX2
+static void PcmAccumulate_AVX2(int32_t *acc, const int16_t *src, int count)
+{
+	for (int i = 0; i < count; i += 16) {
+		__m256i lo = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(src + i)));
+		__m256i hi = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(src + i + 8)));
+		__m256i a0 = _mm256_loadu_si256((const __m256i *)(acc + i));
+		__m256i a1 = _mm256_loadu_si256((const __m256i *)(acc + i + 8));
+		_mm256_storeu_si256((__m256i *)(acc + i), _mm256_add_epi32(a0, lo));
+		_mm256_storeu_si256((__m256i *)(acc + i + 8), _mm256_add_epi32(a1, hi));
+	}
+}
+
+DSP_TARGET_AVX2
+static void PcmSaturate_AVX2(int16_t *dst, const int32_t *acc, int count)
+{
+	for (int i = 0; i < count; i += 16) {
+		__m256i a0 = _mm256_loadu_si256((const __m256i *)(acc + i));
+		__m256i a1 = _mm256_loadu_si256((const __m256i *)(acc + i + 8));
+		// packs works per 128-bit lane, restore sample order afterwards
+		__m256i p = _mm256_permute4x64_epi64(_mm256_packs_epi32(a0, a1), 0xD8);
+		_mm256_storeu_si256((__m256i *)(dst + i), p);
+	}
+}
+
+DSP_TARGET_AVX2
+static void PcmSaturateMinus_AVX2(int16_t *dst, const int32_t *acc, const int16_t *own, int count)
+{
+	for (int i = 0; i < count; i += 16) {
+		__m256i lo = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(own + i)));
+		__m256i hi = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(own + i + 8)));
+		__m256i a0 = _mm256_sub_epi32(_mm256_loadu_si256((const __m256i *)(acc + i)), lo);
+		__m256i a1 = _mm256_sub_epi32(_mm256_loadu_si256((const __m256i *)(acc + i + 8)), hi);
+		__m256i p = _mm256_permute4x64_epi64(_mm256_packs_epi32(a0, a1), 0xD8);
+		_mm256_storeu_si256((__m256i *)(dst + i), p);
+	}
+}
+#endif
+
+//-------------------------------------------------------------------------------------//
+// NEON : 8 samples per step
+
+#if defined(DSP_HAS_NEON)
+static uint64_t PcmEnergy_NEON(const int16_t *src, int count)
+{
+	int64x2_t sum = vdupq_n_s64(0);
+
+	for (int i = 0; i < count; i += 8) {
+		int16x8_t v = vld1q_s16(src + i);
+		int32x4_t lo = vmull_s16(vget_low_s16(v), vget_low_s16(v));
+		int32x4_t hi = vmull_s16(vget_high_s16(v), vget_high_s16(v));
+		sum = vpadalq_s32(sum, lo);
+		sum = vpadalq_s32(sum, hi);
+	}
+	return (uint64_t)(vgetq_lane_s64(sum, 0) + vgetq_lane_s64(sum, 1));
+}
+
+static void PcmAccumulate_NEON(int32_t *acc, const int16_t *src, int count)
+{
+	for (int i = 0; i < count; i += 8) {
+		int16x8_t v = vld1q_s16(src + i);
+		vst1q_s32(acc + i, vaddw_s16(vld1q_s32(acc + i), vget_low_s16(v)));
+		vst1q_s32(acc + i + 4, vaddw_s16(vld1q_s32(acc + i + 4), vget_high_s16(v)));
+	}
+}
+
+static void PcmSaturate_NEON(int16_t *dst, const int32_t *acc, int count)
+{
+	for (int i = 0; i < count; i += 8) {
+		int16x4_t lo = vqmovn_s32(vld1q_s32(acc + i));
+		int16x4_t hi = vqmovn_s32(vld1q_s32(acc + i + 4));
+		vst1q_s16(dst + i, vcombine_s16(lo, hi));
+	}
+}
+
+static void PcmSaturateMinus_NEON(int16_t *dst, const int32_t *acc, const int16_t *own, int count)
+{
+	for (int i = 0; i < count; i += 8) {
+		int16x8_t v = vld1q_s16(own + i);
+		int16x4_t lo = vqmovn_s32(vsubw_s16(vld1q_s32(acc + i), vget_low_s16(v)));
+		int16x4_t hi = vqmovn_s32(vsubw_s16(vld1q_s32(acc + i + 4), vget_high_s16(v)));
+		vst1q_s16(dst + i, vcombine_s16(lo, hi));
+	}
+}
+#endif
+
+//-------------------------------------------------------------------------------------//
+// dispatch : the vector row handles the multiple of its step, C the remainder
+
+#if defined(DSP_HAS_AVX2)
+#define PCM_SELECT_AVX2(fn)                      \
+	if (DSP_TEST_CPU(kCpuHasAVX2)) {             \
+		fn##Row = fn##_AVX2;                     \
+		step = 16;                               \
+	}
+#else
+#define PCM_SELECT_AVX2(fn)
+#endif
+#if defined(DSP_HAS_SSE2)
+#define PCM_SELECT_SSE2(fn)                      \
+	if (DSP_TEST_CPU(kCpuHasSSE2)) {             \
+		fn##Row = fn##_SSE2;                     \
+		step = 8;                                \
+	}
+#else
+#define PCM_SELECT_SSE2(fn)
+#endif
+#if defined(DSP_HAS_NEON)
+#define PCM_SELECT_NEON(fn)                      \
+	if (DSP_TEST_CPU(kCpuHasNEON)) {             \
+		fn##Row = fn##_NEON;                     \
+		step = 8;                                \
+	}
+#else
+#define PCM_SELECT_NEON(fn)
+#endif
+#define PCM_SELECT(fn) PCM_SELECT_SSE2(fn) PCM_SELECT_AVX2(fn) PCM_SELECT_NEON(fn)
+
+uint64_t PcmEnergy(const int16_t *src, int count)
+{
+	uint64_t (*PcmEnergyRow)(const int16_t *, int) = PcmEnergy_C;
+	int step = 1;
+	PCM_SELECT(PcmEnergy)
+
+	int body = count - count % step;
+	return PcmEnergyRow(src, body) + PcmEnergy_C(src + body, count - body);
+}
+
+void PcmAccumulate(int32_t *acc, const int16_t *src, int count)
+{
+	void (*PcmAccumulateRow)(int32_t *, const int16_t *, int) = PcmAccumulate_C;
+	int step = 1;
+	PCM_SELECT(PcmAccumulate)
+
+	int body = count - count % step;
+	PcmAccumulateRow(acc, src, body);
+	PcmAccumulate_C(acc + body, src + body, count - body);
+}
+
+void PcmSaturate(int16_t *dst, const int32_t *acc, int count)
+{
+	void (*PcmSaturateRow)(int16_t *, const int32_t *, int) = PcmSaturate_C;
+	int step = 1;
+	PCM_SELECT(PcmSaturate)
+
+	int body = count - count % step;
+	PcmSaturateRow(dst, acc, body);
+	PcmSaturate_C(dst + body, acc + body, count - body);
+}
+
+void PcmSaturateMinus(int16_t *dst, const int32_t *acc, const int16_t *own, int count)
+{
+	void (*PcmSaturateMinusRow)(int16_t *, const int32_t *, const int16_t *, int) = PcmSaturateMinus_C;
+	int step = 1;
+	PCM_SELECT(PcmSaturateMinus)
+
+	int body = count - count % step;
+	PcmSaturateMinusRow(dst, acc, own, body);
+	PcmSaturateMinus_C(dst + body, acc + body, own + body, count - body);
+}
@@ -0,0 +1,34 @@
+//
+//  pcm_simd.h
+//
+//  Vector kernels over 16-bit linear PCM shared by the mixer and the
+//  level/activity modules. Each entry point dispatches to SSE2/AVX2/NEON
+//  and falls back to the scalar loop for the tail.
+//
+
+#ifndef PCM_SIMD_H
+#define PCM_SIMD_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// sum(src[i]^2), exact for any count below 2^32 samples.
+uint64_t PcmEnergy(const int16_t *src, int count);
+
+// acc[i] += src[i], widened to 32 bits so no intermediate sum clips.
+void PcmAccumulate(int32_t *acc, const int16_t *src, int count);
+
+// dst[i] = sat16(acc[i])
+void PcmSaturate(int16_t *dst, const int32_t *acc, int count);
+
+// dst[i] = sat16(acc[i] - own[i]), the mix-minus of one contributor.
+void PcmSaturateMinus(int16_t *dst, const int32_t *acc, const int16_t *own, int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
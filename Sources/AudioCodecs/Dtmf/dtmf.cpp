@@ -0,0 +1,323 @@
+#include <math.h>
+#include <string.h>
+
+#include "dtmf.h"
+#include "../rtp.h"
+#include "../Dsp/dsp_cpu.h"
+#include "../Dsp/pcm_simd.h"
+
+#define DTMF_SAMPLE_RATE            8000
+#define DTMF_MIN_TONE_AMPLITUDE     400.0f  // about -38 dBov per tone
+#define DTMF_NORMAL_TWIST           6.3f    // column tone up to 8 dB above the row tone
+#define DTMF_REVERSE_TWIST          2.5f    // row tone up to 4 dB above the column tone
+#define DTMF_RELATIVE_PEAK          6.3f    // other tones of the group at least 8 dB down
+#define DTMF_TO_TOTAL_ENERGY        0.6f    // share of the block energy in the two tones
+
+static const float kDtmfFreqs[8] = {
+	697.0f, 770.0f, 852.0f, 941.0f,         // rows
+	1209.0f, 1336.0f, 1477.0f, 1633.0f      // columns
+};
+
+static const char kDtmfDigits[4][4] = {
+	{'1', '2', '3', 'A'},
+	{'4', '5', '6', 'B'},
+	{'7', '8', '9', 'C'},
+	{'*', '0', '#', 'D'},
+};
+
+//-------------------------------------------------------------------------------------//
+
+int Dtmf_EventFromDigit(char digit)
+{
+	if (digit >= '0' && digit <= '9') return digit - '0';
+	if (digit == '*') return DTMF_EVENT_STAR;
+	if (digit == '#') return DTMF_EVENT_POUND;
+	if (digit >= 'A' && digit <= 'D') return DTMF_EVENT_A + digit - 'A';
+	if (digit >= 'a' && digit <= 'd') return DTMF_EVENT_A + digit - 'a';
+	return -1;
+}
+
+char Dtmf_DigitFromEvent(int event)
+{
+	if (event >= 0 && event <= 9) return (char)('0' + event);
+	if (event == DTMF_EVENT_STAR) return '*';
+	if (event == DTMF_EVENT_POUND) return '#';
+	if (event >= DTMF_EVENT_A && event <= DTMF_EVENT_A + 3) return (char)('A' + event - DTMF_EVENT_A);
+	return 0;
+}
+
+//-------------------------------------------------------------------------------------//
+
+CDtmfSender::CDtmfSender(int payloadType, int ssrc, int packetSamples)
+	: payloadType(payloadType)
+	, ssrc(ssrc)
+	, packetSamples(packetSamples)
+	, active(false)
+	, first(false)
+	, event(0)
+	, volume(DTMF_DEFAULT_VOLUME)
+	, timestamp(0)
+	, duration(0)
+	, remaining(0)
+	, endPackets(0)
+{
+}
+
+CDtmfSender::~CDtmfSender()
+{
+}
+
+bool CDtmfSender::Start(int event, uint32_t timestamp, int durationSamples, int volume)
+{
+	if (active || event < 0 || event > 255 || durationSamples <= 0)
+		return false;
+
+	this->event = event;
+	this->volume = volume & 0x3F;
+	this->timestamp = timestamp;
+	duration = 0;
+	remaining = (uint32_t)durationSamples;
+	endPackets = 0;
+	first = true;
+	active = true;
+	return true;
+}
+
+void CDtmfSender::Stop()
+{
+	if (active && endPackets == 0) {
+		remaining = 0;
+		endPackets = DTMF_END_REDUNDANCY;
+	}
+}
+
+int CDtmfSender::NextPacket(unsigned char *packet, unsigned short seq)
+{
+	dtmf_stream stream;
+	bool end;
+
+	if (!active)
+		return 0;
+
+	if (endPackets == 0) {
+		uint32_t step = remaining < (uint32_t)packetSamples ? remaining : (uint32_t)packetSamples;
+
+		if (duration + step > 0xFFFF) {
+			// RFC 4733 2.5.1.3 : the duration field is full, close this segment
+			// and continue the same event from a new timestamp
+			remaining -= 0xFFFF - duration;
+			duration = 0xFFFF;
+			if (remaining == 0)
+				endPackets = DTMF_END_REDUNDANCY;
+		} else {
+			duration += step;
+			remaining -= step;
+			if (remaining == 0)
+				endPackets = DTMF_END_REDUNDANCY;
+		}
+	}
+	end = endPackets > 0;
+
+	stream.rHeader.v = 2;
+	stream.rHeader.p = 0;
+	stream.rHeader.x = 0;
+	stream.rHeader.cc = 0;
+	stream.rHeader.m = first ? 1 : 0;
+	stream.rHeader.pt = payloadType;
+	stream.rHeader.seq = htons(seq);
+	stream.rHeader.timestamp = htonl(timestamp);
+	stream.rHeader.ssrc = htonl(ssrc);
+
+	stream.event.events = (unsigned char)event;
+	stream.event.e = end ? 1 : 0;
+	stream.event.r = 0;
+	stream.event.volume = volume;
+	stream.event.duration = htons((unsigned short)duration);
+
+	memcpy(packet, &stream, sizeof(dtmf_stream));
+	first = false;
+
+	if (end) {
+		if (--endPackets == 0)
+			active = false;
+	} else if (duration == 0xFFFF) {
+		timestamp += 0xFFFF;
+		duration = 0;
+	}
+	return (int)sizeof(dtmf_stream);
+}
+
+//-------------------------------------------------------------------------------------//
+// Goertzel over the 8 DTMF frequencies : s = x + c * s1 - s2, one lane per tone
+
+static void Goertzel8_C(const short *x, int n, const float *coeff, float *power)
+{
+	float s1[8] = {0}, s2[8] = {0};
+	int i, k;
+
+	for (i = 0; i < n; i++) {
+		float v = (float)x[i];
+		for (k = 0; k < 8; k++) {
+			float s0 = v + coeff[k] * s1[k] - s2[k];
+			s2[k] = s1[k];
+			s1[k] = s0;
+		}
+	}
+	for (k = 0; k < 8; k++)
+		power[k] = s1[k] * s1[k] + s2[k] * s2[k] - coeff[k] * s1[k] * s2[k];
+}
+
+#if defined(DSP_HAS_SSE2)
+static void Goertzel8_SSE2(const short *x, int n, const float *coeff, float *power)
+{
+	__m128 c0 = _mm_loadu_ps(coeff), c1 = _mm_loadu_ps(coeff + 4);
+	__m128 a1 = _mm_setzero_ps(), a2 = _mm_setzero_ps();
+	__m128 b1 = _mm_setzero_ps(), b2 = _mm_setzero_ps();
+
+	for (int i = 0; i < n; i++) {
+		__m128 v = _mm_set1_ps((float)x[i]);
+		__m128 a0 = _mm_sub_ps(_mm_add_ps(v, _mm_mul_ps(c0, a1)), a2);
+		__m128 b0 = _mm_sub_ps(_mm_add_ps(v, _mm_mul_ps(c1, b1)), b2);
+		a2 = a1; a1 = a0;
+		b2 = b1; b1 = b0;
+	}
+	_mm_storeu_ps(power, _mm_sub_ps(_mm_add_ps(_mm_mul_ps(a1, a1), _mm_mul_ps(a2, a2)),
+	                                _mm_mul_ps(_mm_mul_ps(c0, a1), a2)));
+	_mm_storeu_ps(power + 4, _mm_sub_ps(_mm_add_ps(_mm_mul_ps(b1, b1), _mm_mul_ps(b2, b2)),
+	                                    _mm_mul_ps(_mm_mul_ps(c1, b1), b2)));
+}
+#endif
+
+#if defined(DSP_HAS_AVX2)
+DSP_TARGET_AVX2
+static void Goertzel8_AVX2(const short *x, int n, const float *coeff, float *power)
+{
+	__m256 c = _mm256_loadu_ps(coeff);
+	__m256 s1 = _mm256_setzero_ps(), s2 = _mm256_setzero_ps();
+
+	for (int i = 0; i < n; i++) {
+		__m256 v = _mm256_set1_ps((float)x[i]);
+		__m256 s0 = _mm256_sub_ps(_mm256_add_ps(v, _mm256_mul_ps(c, s1)), s2);
+		s2 = s1;
+		s1 = s0;
+	}
+	_mm256_storeu_ps(power, _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(s1, s1), _mm256_mul_ps(s2, s2)),
+	                                      _mm256_mul_ps(_mm256_mul_ps(c, s1), s2)));
+}
+#endif
+
+#if defined(DSP_HAS_NEON)
+static void Goertzel8_NEON(const short *x, int n, const float *coeff, float *power)
+{
+	float32x4_t c0 = vld1q_f32(coeff), c1 = vld1q_f32(coeff + 4);
+	float32x4_t a1 = vdupq_n_f32(0.0f), a2 = vdupq_n_f32(0.0f);
+	float32x4_t b1 = vdupq_n_f32(0.0f), b2 = vdupq_n_f32(0.0f);
+
+	for (int i = 0; i < n; i++) {
+		float32x4_t v = vdupq_n_f32((float)x[i]);
+		float32x4_t a0 = vsubq_f32(vaddq_f32(v, vmulq_f32(c0, a1)), a2);
+		float32x4_t b0 = vsubq_f32(vaddq_f32(v, vmulq_f32(c1, b1)), b2);
+		a2 = a1; a1 = a0;
+		b2 = b1; b1 = b0;
+	}
+	vst1q_f32(power, vsubq_f32(vaddq_f32(vmulq_f32(a1, a1), vmulq_f32(a2, a2)),
+	                           vmulq_f32(vmulq_f32(c0, a1), a2)));
+	vst1q_f32(power + 4, vsubq_f32(vaddq_f32(vmulq_f32(b1, b1), vmulq_f32(b2, b2)),
+	                               vmulq_f32(vmulq_f32(c1, b1), b2)));
+}
+#endif
+
+//-------------------------------------------------------------------------------------//
+
+CDtmfDetector::CDtmfDetector()
+{
+	for (int k = 0; k < 8; k++)
+		coeff[k] = (float)(2.0 * cos(2.0 * M_PI * kDtmfFreqs[k] / DTMF_SAMPLE_RATE));
+	Reset();
+}
+
+CDtmfDetector::~CDtmfDetector()
+{
+}
+
+void CDtmfDetector::Reset()
+{
+	filled = 0;
+	lastHit = 0;
+	current = 0;
+}
+
+char CDtmfDetector::DetectBlock()
+{
+	void (*Goertzel8)(const short *, int, const float *, float *) = Goertzel8_C;
+	float DSP_ALIGNED(32) power[8];
+	const float threshold = (DTMF_MIN_TONE_AMPLITUDE * DTMF_BLOCK_SIZE / 2) *
+	                        (DTMF_MIN_TONE_AMPLITUDE * DTMF_BLOCK_SIZE / 2);
+	int row = 0, col = 4, k;
+
+#if defined(DSP_HAS_SSE2)
+	if (DSP_TEST_CPU(kCpuHasSSE2)) Goertzel8 = Goertzel8_SSE2;
+#endif
+#if defined(DSP_HAS_AVX2)
+	if (DSP_TEST_CPU(kCpuHasAVX2)) Goertzel8 = Goertzel8_AVX2;
+#endif
+#if defined(DSP_HAS_NEON)
+	if (DSP_TEST_CPU(kCpuHasNEON)) Goertzel8 = Goertzel8_NEON;
+#endif
+	Goertzel8(block, DTMF_BLOCK_SIZE, coeff, power);
+
+	for (k = 1; k < 4; k++) {
+		if (power[k] > power[row]) row = k;
+		if (power[4 + k] > power[col]) col = 4 + k;
+	}
+	float rp = power[row], cp = power[col];
+
+	if (rp < threshold || cp < threshold)
+		return 0;
+	if (cp > rp * DTMF_NORMAL_TWIST || rp > cp * DTMF_REVERSE_TWIST)
+		return 0;
+	for (k = 0; k < 4; k++) {
+		if (k != row && power[k] * DTMF_RELATIVE_PEAK > rp)
+			return 0;
+		if (4 + k != col && power[4 + k] * DTMF_RELATIVE_PEAK > cp)
+			return 0;
+	}
+
+	// a pure tone of energy E gives a Goertzel power of E * N / 2
+	float energy = (float)PcmEnergy(block, DTMF_BLOCK_SIZE);
+	if (rp + cp < DTMF_TO_TOTAL_ENERGY * energy * (DTMF_BLOCK_SIZE / 2.0f))
+		return 0;
+
+	return kDtmfDigits[row][col - 4];
+}
+
+int CDtmfDetector::Process(const short *pcm, int samples, char *digits, int maxDigits)
+{
+	int count = 0;
+
+	while (samples > 0) {
+		int n = DTMF_BLOCK_SIZE - filled;
+		if (n > samples)
+			n = samples;
+		memcpy(block + filled, pcm, n * sizeof(short));
+		filled += n;
+		pcm += n;
+		samples -= n;
+		if (filled < DTMF_BLOCK_SIZE)
+			break;
+
+		// a digit needs two consecutive blocks, and two quiet blocks end it
+		char hit = DetectBlock();
+		memmove(block, block + DTMF_HOP_SIZE, (DTMF_BLOCK_SIZE - DTMF_HOP_SIZE) * sizeof(short));
+		filled = DTMF_BLOCK_SIZE - DTMF_HOP_SIZE;
+		if (hit && hit == lastHit && hit != current) {
+			current = hit;
+			if (count < maxDigits)
+				digits[count++] = hit;
+		}
+		if (!hit && !lastHit)
+			current = 0;
+		lastHit = hit;
+	}
+	return count;
+}
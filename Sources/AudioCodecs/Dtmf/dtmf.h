@@ -0,0 +1,81 @@
+#pragma once
+#include <stdint.h>
+
+//-------------------------------------------------------------------------------------//
+//
+// RFC 4733 telephone-event sender and in-band DTMF detector
+//
+// CDtmfSender builds dtmf_stream packets (rtp.h) for one event at a time.
+// All packets of an event carry the start timestamp, the first one has the
+// marker bit, and the final packet with the E bit is repeated so a single
+// loss does not leave the receiver playing the tone.
+//
+// CDtmfDetector runs Goertzel filters for the 4 row and 4 column tones over
+// 8 kHz PCM, e.g. the output of G711_Decode or va_g729a_decoder. The 8 filters
+// share one pass over the samples, one SIMD lane per tone. Blocks overlap by
+// half, so a digit of the 40 ms minimum spans two of them at any alignment.
+//
+//-------------------------------------------------------------------------------------//
+
+#define DTMF_EVENT_STAR             10
+#define DTMF_EVENT_POUND            11
+#define DTMF_EVENT_A                12      // A..D : 12..15
+
+#define DTMF_END_REDUNDANCY         3       // copies of the end packet
+#define DTMF_DEFAULT_VOLUME         10      // -dBm0
+#define DTMF_BLOCK_SIZE             205     // 25.6 ms at 8 kHz, bins line up with all 8 tones
+#define DTMF_HOP_SIZE               102     // half overlapping blocks, 40 ms digits give two hits
+
+int Dtmf_EventFromDigit(char digit);        // -1 if not a DTMF digit
+char Dtmf_DigitFromEvent(int event);        // 0 if not a DTMF event
+
+class CDtmfSender
+{
+public:
+	CDtmfSender(int payloadType, int ssrc, int packetSamples = 400);
+	virtual ~CDtmfSender();
+
+	// timestamp is the RTP timestamp at the start of the tone
+	bool Start(int event, uint32_t timestamp, int durationSamples, int volume = DTMF_DEFAULT_VOLUME);
+	void Stop();                    // ends the event early, the end packets still go out
+	bool IsActive() const { return active; }
+
+	// Call once per packet interval while IsActive(). Returns bytes written (16).
+	int NextPacket(unsigned char *packet, unsigned short seq);
+
+protected:
+	int payloadType;
+	int ssrc;
+	int packetSamples;
+
+	bool active;
+	bool first;
+	int event;
+	int volume;
+	uint32_t timestamp;
+	uint32_t duration;              // samples sent in the current segment
+	uint32_t remaining;             // samples of tone left after this segment
+	int endPackets;                 // end packets left to send
+};
+
+class CDtmfDetector
+{
+public:
+	CDtmfDetector();
+	virtual ~CDtmfDetector();
+
+	void Reset();
+
+	// Feeds 8 kHz PCM. Writes newly detected digits ('0'..'9', '*', '#', 'A'..'D')
+	// and returns how many were written.
+	int Process(const short *pcm, int samples, char *digits, int maxDigits);
+
+protected:
+	char DetectBlock();
+
+	float coeff[8];                 // 2cos(2 pi f / 8000) per tone
+	short block[DTMF_BLOCK_SIZE];
+	int filled;
+	char lastHit;
+	char current;
+};
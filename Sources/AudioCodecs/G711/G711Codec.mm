@@ -8,12 +8,15 @@
 #import <Foundation/Foundation.h>
 #import <RTPAudioCodec.h>
 #include "G711.h"
+#include "../AudioLevel/audio_level.h"
+#include "../Vad/voice_activity_detector.h"
 #include <iostream>
 #include <memory>
 
 
 @interface G711Codec : NSObject<RTPAudioCodec>{
     int mode;
+    std::unique_ptr<CVoiceActivityDetector> vad;
 }
 @end
 
@@ -25,10 +28,13 @@ typedef NS_ENUM(NSInteger, ConversionMode) {
     PCMUToLinear,
 };
 @synthesize codecType;
+@synthesize audioLevel;
+@synthesize voiceActivity;
 -(instancetype) init:(ConversionMode) conversionMode {
     if( self = [super init] ) {
         mode = (int)conversionMode;
         codecType = g711;
+        vad = std::make_unique<CVoiceActivityDetector>(8000);
     }
     return self;
 }
@@ -39,6 +45,11 @@ typedef NS_ENUM(NSInteger, ConversionMode) {
 
 -(NSData*)encode:(NSData*)data {
     NSInteger length = data.length / 2;
+    audioLevel = AudioLevel_Compute((const int16_t*)data.bytes, (int)length);
+    if (length == vad->FrameSamples())
+        voiceActivity = vad->Process((const int16_t*)data.bytes) != 0;
+    else
+        voiceActivity = audioLevel <= AUDIO_LEVEL_VOICE_THRESHOLD;
     auto packets = std::make_unique<uint8_t[]>(length);
     G711_Encode((unsigned char*)packets.get(), (unsigned char*)data.bytes, data.length, mode);
     return [NSData dataWithBytes:packets.get() length:length];
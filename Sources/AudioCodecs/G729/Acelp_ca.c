@@ -34,6 +34,7 @@
 
 #include "typedef.h"
 #include "ld8a.h"
+#include "ld8a_simd.h"
 
 /* local routines definition */
 
@@ -65,8 +66,19 @@ int ACELP_code_A(       /* (o) :index of pulses positions    */
 )
 {
   int i, index;
-  static FFLOAT Dn[L_SUBFR]; /* "static" to avoid stack overflow on PC */
-  static FFLOAT rr[DIM_RR];  /* "static" to avoid stack overflow on PC */
+  FFLOAT DSP_ALIGNED(32) Dn[L_SUBFR]; /* on the stack : nothing shared between encoders */
+  FFLOAT DSP_ALIGNED(32) rr[DIM_RR];
+  void (*CorH)(FFLOAT *, FFLOAT *) = cor_h;
+
+#if defined(DSP_HAS_SSE2)
+  if (DSP_TEST_CPU(kCpuHasSSE2)) CorH = cor_h_SSE2;
+#endif
+#if defined(DSP_HAS_AVX2)
+  if (DSP_TEST_CPU(kCpuHasAVX2) && DSP_TEST_CPU(kCpuHasFMA3)) CorH = cor_h_AVX2;
+#endif
+#if defined(DSP_HAS_NEON)
+  if (DSP_TEST_CPU(kCpuHasNEON)) CorH = cor_h_NEON;
+#endif
 
  /*-----------------------------------------------------------------*
   * Include fixed-gain pitch contribution into impulse resp. h[]    *
@@ -77,7 +89,7 @@ int ACELP_code_A(       /* (o) :index of pulses positions    */
      for (i = T0; i < L_SUBFR; i++)
         h[i] += pitch_sharp * h[i-T0];
 
-  cor_h(h, rr);
+  CorH(h, rr);
 
  /*-----------------------------------------------------------------*
   * Compute correlation of target vector with impulse response.     *
@@ -419,10 +431,12 @@ static int d4i40_17_fast(/*(o) : Index of pulses positions.               */
   FFLOAT psk, ps, ps0, ps1, ps2, sq, sq2;
   FFLOAT alpk, alp, max;
   FFLOAT s, alp0, alp1, alp2;
-  FFLOAT *p0, *p1, *p2, *p3, *p4;
+  FFLOAT *p0, *p1, *p2, *p3;
 
   FFLOAT sign_dn[L_SUBFR], sign_dn_inv[L_SUBFR], *psign;
   FFLOAT tmp_vect[NB_POS];
+  FFLOAT ps_row[NB_POS], alp_row[NB_POS], dn_col[NB_POS];
+  search_8x8_fn search_8x8 = search_8x8_C;
 
   FFLOAT *rri0i0, *rri1i1, *rri2i2, *rri3i3, *rri4i4;
   FFLOAT *rri0i1, *rri0i2, *rri0i3, *rri0i4;
@@ -434,6 +448,16 @@ static int d4i40_17_fast(/*(o) : Index of pulses positions.               */
   FFLOAT  *ptr_rri2i3_i4;
   FFLOAT  *ptr_rri3i3_i4;
 
+#if defined(DSP_HAS_SSE2)
+   if (DSP_TEST_CPU(kCpuHasSSE2)) search_8x8 = search_8x8_SSE2;
+#endif
+#if defined(DSP_HAS_AVX2)
+   if (DSP_TEST_CPU(kCpuHasAVX2) && DSP_TEST_CPU(kCpuHasFMA3)) search_8x8 = search_8x8_AVX2;
+#endif
+#if defined(DSP_HAS_NEON)
+   if (DSP_TEST_CPU(kCpuHasNEON)) search_8x8 = search_8x8_NEON;
+#endif
+
      /* Init pointers */
    rri0i0 = rr;
    rri1i1 = rri0i0 + NB_POS;
@@ -606,9 +630,6 @@ static int d4i40_17_fast(/*(o) : Index of pulses positions.               */
     ps0 = ps;
     alp0 = alp;
 
-    sq = (F)-1.0;
-    alp = (F)1.0;
-
     /* build vector for next loop to decrease complexity */
 
     p0 = rri1i2 + i0/5;
@@ -627,36 +648,20 @@ static int d4i40_17_fast(/*(o) : Index of pulses positions.               */
     p0 = rri0i2 + i0/5;
     p1 = ptr_rri0i3_i4 + i1/5;
     p2 = rri0i0;
-    p3 = rri0i1;
 
-    for (i2=0; i2<L_SUBFR; i2+=STEP)
+    for (i2=0, j=0; i2<L_SUBFR; i2+=STEP, j++)
     {
-      ps1 = ps0 + dn[i2];
-
-      alp1 = alp0 + *p0 + *p1 + *p2 * (F)0.5;
+      ps_row[j] = ps0 + dn[i2];
+      alp_row[j] = alp0 + *p0 + *p1 + *p2 * (F)0.5;
       p0 += NB_POS; p1 += NB_POS; p2++;
+      dn_col[j] = dn[i2+1];
+    }
 
-      /* i3 loop: 8 positions in track 1 */
-
-      p4 = tmp_vect;
-
-      for (i3=1; i3<L_SUBFR; i3+=STEP)
-      {
-        ps2 = ps1 + dn[i3];
+    /* i3 loop: 8 positions in track 1 */
 
-        alp2 = alp1 + *p3++ + *p4++;
-
-        sq2 = ps2 * ps2;
-        s = alp*sq2 - sq * alp2;
-        if (s > 0.0)
-        {
-          sq = sq2;
-          alp = alp2;
-          ix = i2;
-          iy = i3;
-        }
-      }
-    }
+    search_8x8(ps_row, alp_row, dn_col, rri0i1, tmp_vect, &ix, &iy, &sq, &alp);
+    ix = ix*STEP;
+    iy = iy*STEP + 1;
 
    /*----------------------------------------------------------------*
     * depth first search 3: compare codevector with the best case.   *
@@ -741,9 +746,6 @@ static int d4i40_17_fast(/*(o) : Index of pulses positions.               */
     ps0 = ps;
     alp0 = alp;
 
-    sq = (F)-1.0;
-    alp = (F)1.0;
-
     /* build vector for next loop to decrease complexity */
 
     p0 = ptr_rri2i3_i4 + i0/5;
@@ -762,34 +764,20 @@ static int d4i40_17_fast(/*(o) : Index of pulses positions.               */
     p0 = ptr_rri1i3_i4 + i0/5;
     p1 = rri0i1 + i1_offset;
     p2 = rri1i1;
-    p3 = rri1i2;
 
-    for (i2=1; i2<L_SUBFR; i2+=STEP)
+    for (i2=1, j=0; i2<L_SUBFR; i2+=STEP, j++)
     {
-      ps1 = ps0 + dn[i2];
-
-      alp1 = alp0 + *p0 + *p1 + *p2 * (F)0.5;
+      ps_row[j] = ps0 + dn[i2];
+      alp_row[j] = alp0 + *p0 + *p1 + *p2 * (F)0.5;
       p0 += NB_POS; p1++; p2++;
+      dn_col[j] = dn[i2+1];
+    }
 
-      /* i3 loop: 8 positions in track 2 */
-
-      p4 = tmp_vect;
+    /* i3 loop: 8 positions in track 2 */
 
-      for (i3=2; i3<L_SUBFR; i3+=STEP)
-      {
-        ps2 = ps1 + dn[i3];
-        alp2 = alp1 + *p3++ + *p4++;
-        sq2 = ps2 * ps2;
-        s = alp*sq2 - sq * alp2;
-        if (s > (F)0.0)
-        {
-          sq = sq2;
-          alp = alp2;
-          ix = i2;
-          iy = i3;
-        }
-      }
-    }
+    search_8x8(ps_row, alp_row, dn_col, rri1i2, tmp_vect, &ix, &iy, &sq, &alp);
+    ix = ix*STEP + 1;
+    iy = iy*STEP + 2;
 
    /*----------------------------------------------------------------*
     * depth first search 1: compare codevector with the best case.   *
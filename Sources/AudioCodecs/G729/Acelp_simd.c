@@ -0,0 +1,372 @@
+/*
+ File : ACELP_SIMD.C
+ SIMD kernels of the G.729A algebraic codebook search (see ld8a_simd.h)
+*/
+
+/*---------------------------------------------------------------------------*
+ * cor_h()   : the rr[] entries are partial sums of the autocorrelation of   *
+ *             h[] :  rr(p1,p2) = sum_{n=0}^{39-max(p1,p2)} h[n]*h[n+|p1-p2|] *
+ *             The kernels build every partial sum for every shift at once,  *
+ *             one lane per shift, then pick the 616 entries of rr[].        *
+ * cor_h_x() : one lane per output, d[i] = sum_k h[k]*x[i+k] with x[] padded *
+ *             with zeros, same summation order as the reference.            *
+ * search_8x8 : the 8 column candidates of a row in one vector, the best     *
+ *             candidate is kept per lane and the lanes are reduced in the   *
+ *             reference visiting order.                                     *
+ *---------------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "typedef.h"
+#include "ld8a.h"
+#include "ld8a_simd.h"
+
+#define NB_TRACK 5
+#define L_PAD    (L_SUBFR + L_SUBFR)    /* h[] followed by zeros */
+
+/*---------------------------------------------------------------------------*
+ * cor_h_gather : rr[] from the table of partial sums                        *
+ *   part[m*L_SUBFR + d] = sum_{n=0}^{m} h[n]*h[n+d]                          *
+ *---------------------------------------------------------------------------*/
+
+static void cor_h_gather(const FFLOAT *part, FFLOAT *rr)
+{
+  /* order of the rrixiy[] blocks after rri4i4[] */
+  static const int pair[9][2] = {
+    {0, 1}, {0, 2}, {0, 3}, {0, 4}, {1, 2}, {1, 3}, {1, 4}, {2, 3}, {2, 4}
+  };
+  int t, i, k, p1, p2;
+
+  for (t = 0; t < NB_TRACK; t++)
+    for (i = 0; i < NB_POS; i++)
+    {
+      p1 = i*STEP + t;
+      *rr++ = part[(L_SUBFR-1-p1)*L_SUBFR];
+    }
+
+  for (t = 0; t < 9; t++)
+    for (i = 0; i < NB_POS; i++)
+    {
+      p1 = i*STEP + pair[t][0];
+      for (k = 0; k < NB_POS; k++)
+      {
+        p2 = k*STEP + pair[t][1];
+        if (p1 > p2)
+          *rr++ = part[(L_SUBFR-1-p1)*L_SUBFR + p1-p2];
+        else
+          *rr++ = part[(L_SUBFR-1-p2)*L_SUBFR + p2-p1];
+      }
+    }
+}
+
+/*---------------------------------------------------------------------------*
+ * search_8x8 reference and lane reduction                                   *
+ *---------------------------------------------------------------------------*/
+
+void search_8x8_C(FFLOAT ps1[], FFLOAT alp1[], FFLOAT dn_col[], FFLOAT rr[],
+  FFLOAT tmp_vect[], int *row, int *col, FFLOAT *sq, FFLOAT *alp)
+{
+  int i2, i3;
+  FFLOAT ps2, alp2, sq2, s;
+  FFLOAT best_sq = (F)-1.0, best_alp = (F)1.0;
+
+  for (i2 = 0; i2 < NB_POS; i2++)
+  {
+    for (i3 = 0; i3 < NB_POS; i3++)
+    {
+      ps2 = ps1[i2] + dn_col[i3];
+      alp2 = alp1[i2] + *rr++ + tmp_vect[i3];
+      sq2 = ps2 * ps2;
+      s = best_alp*sq2 - best_sq * alp2;
+      if (s > (F)0.0)
+      {
+        best_sq = sq2;
+        best_alp = alp2;
+        *row = i2;
+        *col = i3;
+      }
+    }
+  }
+  *sq = best_sq;
+  *alp = best_alp;
+}
+
+/* lane k holds the first best row of column k : keep the earliest (row, col) */
+static void search_reduce(const FFLOAT lane_sq[], const FFLOAT lane_alp[],
+  const FFLOAT lane_row[], int *row, int *col, FFLOAT *sq, FFLOAT *alp)
+{
+  int k, best_row = NB_POS;
+  FFLOAT s, best_sq = (F)-1.0, best_alp = (F)1.0;
+
+  for (k = 0; k < NB_POS; k++)
+  {
+    s = best_alp*lane_sq[k] - best_sq*lane_alp[k];
+    if (s > (F)0.0 || (s == (F)0.0 && (int)lane_row[k] < best_row))
+    {
+      best_sq = lane_sq[k];
+      best_alp = lane_alp[k];
+      best_row = (int)lane_row[k];
+      *col = k;
+    }
+  }
+  *row = best_row;
+  *sq = best_sq;
+  *alp = best_alp;
+}
+
+/*---------------------------------------------------------------------------*
+ * SSE2 : 4 lanes                                                            *
+ *---------------------------------------------------------------------------*/
+
+#if defined(DSP_HAS_SSE2)
+void cor_h_SSE2(FFLOAT *h, FFLOAT *rr)
+{
+  FFLOAT DSP_ALIGNED(16) hpad[L_PAD];
+  FFLOAT DSP_ALIGNED(16) part[L_SUBFR*L_SUBFR];
+  __m128 acc[L_SUBFR/4];
+  int n, v;
+
+  memcpy(hpad, h, L_SUBFR*sizeof(FFLOAT));
+  memset(hpad + L_SUBFR, 0, (L_PAD-L_SUBFR)*sizeof(FFLOAT));
+  for (v = 0; v < L_SUBFR/4; v++)
+    acc[v] = _mm_setzero_ps();
+
+  for (n = 0; n < L_SUBFR; n++)
+  {
+    __m128 hn = _mm_set1_ps(hpad[n]);
+    for (v = 0; v < L_SUBFR/4; v++)
+    {
+      acc[v] = _mm_add_ps(acc[v], _mm_mul_ps(hn, _mm_loadu_ps(hpad + n + 4*v)));
+      _mm_store_ps(part + n*L_SUBFR + 4*v, acc[v]);
+    }
+  }
+  cor_h_gather(part, rr);
+}
+
+void cor_h_x_SSE2(FFLOAT h[], FFLOAT x[], FFLOAT d[])
+{
+  FFLOAT DSP_ALIGNED(16) xpad[L_SUBFR + 8];
+  int i, k;
+
+  memcpy(xpad, x, L_SUBFR*sizeof(FFLOAT));
+  memset(xpad + L_SUBFR, 0, 8*sizeof(FFLOAT));
+
+  for (i = 0; i < L_SUBFR; i += 4)
+  {
+    __m128 s = _mm_setzero_ps();
+    for (k = 0; k < L_SUBFR-i; k++)
+      s = _mm_add_ps(s, _mm_mul_ps(_mm_loadu_ps(xpad + i + k), _mm_set1_ps(h[k])));
+    _mm_storeu_ps(d + i, s);
+  }
+}
+
+static __inline __m128 select_ps(__m128 mask, __m128 a, __m128 b)
+{
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+void search_8x8_SSE2(FFLOAT ps1[], FFLOAT alp1[], FFLOAT dn_col[], FFLOAT rr[],
+  FFLOAT tmp_vect[], int *row, int *col, FFLOAT *sq, FFLOAT *alp)
+{
+  FFLOAT DSP_ALIGNED(16) lane_sq[NB_POS], lane_alp[NB_POS], lane_row[NB_POS];
+  const __m128 zero = _mm_setzero_ps();
+  int i2, h;
+
+  for (h = 0; h < NB_POS; h += 4)
+  {
+    __m128 dn = _mm_loadu_ps(dn_col + h);
+    __m128 tmp = _mm_loadu_ps(tmp_vect + h);
+    __m128 best_sq = _mm_set1_ps((F)-1.0);
+    __m128 best_alp = _mm_set1_ps((F)1.0);
+    __m128 best_row = zero;
+
+    for (i2 = 0; i2 < NB_POS; i2++)
+    {
+      __m128 ps2 = _mm_add_ps(_mm_set1_ps(ps1[i2]), dn);
+      __m128 alp2 = _mm_add_ps(_mm_add_ps(_mm_set1_ps(alp1[i2]),
+                                          _mm_loadu_ps(rr + i2*NB_POS + h)), tmp);
+      __m128 sq2 = _mm_mul_ps(ps2, ps2);
+      __m128 s = _mm_sub_ps(_mm_mul_ps(best_alp, sq2), _mm_mul_ps(best_sq, alp2));
+      __m128 gt = _mm_cmpgt_ps(s, zero);
+
+      best_sq = select_ps(gt, sq2, best_sq);
+      best_alp = select_ps(gt, alp2, best_alp);
+      best_row = select_ps(gt, _mm_set1_ps((FFLOAT)i2), best_row);
+    }
+    _mm_store_ps(lane_sq + h, best_sq);
+    _mm_store_ps(lane_alp + h, best_alp);
+    _mm_store_ps(lane_row + h, best_row);
+  }
+  search_reduce(lane_sq, lane_alp, lane_row, row, col, sq, alp);
+}
+#endif
+
+/*---------------------------------------------------------------------------*
+ * AVX2 + FMA : 8 lanes, one search row per vector                           *
+ *---------------------------------------------------------------------------*/
+
+#if defined(DSP_HAS_AVX2)
+DSP_TARGET_AVX2_FMA
+void cor_h_AVX2(FFLOAT *h, FFLOAT *rr)
+{
+  FFLOAT DSP_ALIGNED(32) hpad[L_PAD];
+  FFLOAT DSP_ALIGNED(32) part[L_SUBFR*L_SUBFR];
+  __m256 a0, a1, a2, a3, a4;
+  int n;
+
+  memcpy(hpad, h, L_SUBFR*sizeof(FFLOAT));
+  memset(hpad + L_SUBFR, 0, (L_PAD-L_SUBFR)*sizeof(FFLOAT));
+  a0 = a1 = a2 = a3 = a4 = _mm256_setzero_ps();
+
+  for (n = 0; n < L_SUBFR; n++)
+  {
+    __m256 hn = _mm256_set1_ps(hpad[n]);
+    FFLOAT *p = part + n*L_SUBFR;     /* 160 bytes per row, stays 32 byte aligned */
+    a0 = _mm256_fmadd_ps(hn, _mm256_loadu_ps(hpad + n), a0);
+    a1 = _mm256_fmadd_ps(hn, _mm256_loadu_ps(hpad + n + 8), a1);
+    a2 = _mm256_fmadd_ps(hn, _mm256_loadu_ps(hpad + n + 16), a2);
+    a3 = _mm256_fmadd_ps(hn, _mm256_loadu_ps(hpad + n + 24), a3);
+    a4 = _mm256_fmadd_ps(hn, _mm256_loadu_ps(hpad + n + 32), a4);
+    _mm256_store_ps(p, a0);
+    _mm256_store_ps(p + 8, a1);
+    _mm256_store_ps(p + 16, a2);
+    _mm256_store_ps(p + 24, a3);
+    _mm256_store_ps(p + 32, a4);
+  }
+  _mm256_zeroupper();                 /* the helper is SSE code */
+  cor_h_gather(part, rr);
+}
+
+DSP_TARGET_AVX2_FMA
+void cor_h_x_AVX2(FFLOAT h[], FFLOAT x[], FFLOAT d[])
+{
+  FFLOAT DSP_ALIGNED(32) xpad[L_SUBFR + 8];
+  int i, k;
+
+  memcpy(xpad, x, L_SUBFR*sizeof(FFLOAT));
+  memset(xpad + L_SUBFR, 0, 8*sizeof(FFLOAT));
+
+  for (i = 0; i < L_SUBFR; i += 8)
+  {
+    __m256 s = _mm256_setzero_ps();
+    for (k = 0; k < L_SUBFR-i; k++)
+      s = _mm256_fmadd_ps(_mm256_loadu_ps(xpad + i + k), _mm256_set1_ps(h[k]), s);
+    _mm256_storeu_ps(d + i, s);
+  }
+}
+
+DSP_TARGET_AVX2_FMA
+void search_8x8_AVX2(FFLOAT ps1[], FFLOAT alp1[], FFLOAT dn_col[], FFLOAT rr[],
+  FFLOAT tmp_vect[], int *row, int *col, FFLOAT *sq, FFLOAT *alp)
+{
+  FFLOAT DSP_ALIGNED(32) lane_sq[NB_POS], lane_alp[NB_POS], lane_row[NB_POS];
+  const __m256 zero = _mm256_setzero_ps();
+  __m256 dn = _mm256_loadu_ps(dn_col);
+  __m256 tmp = _mm256_loadu_ps(tmp_vect);
+  __m256 best_sq = _mm256_set1_ps((F)-1.0);
+  __m256 best_alp = _mm256_set1_ps((F)1.0);
+  __m256 best_row = zero;
+  int i2;
+
+  for (i2 = 0; i2 < NB_POS; i2++)
+  {
+    __m256 ps2 = _mm256_add_ps(_mm256_set1_ps(ps1[i2]), dn);
+    __m256 alp2 = _mm256_add_ps(_mm256_add_ps(_mm256_set1_ps(alp1[i2]),
+                                              _mm256_loadu_ps(rr + i2*NB_POS)), tmp);
+    __m256 sq2 = _mm256_mul_ps(ps2, ps2);
+    __m256 s = _mm256_fmsub_ps(best_alp, sq2, _mm256_mul_ps(best_sq, alp2));
+    __m256 gt = _mm256_cmp_ps(s, zero, _CMP_GT_OQ);
+
+    best_sq = _mm256_blendv_ps(best_sq, sq2, gt);
+    best_alp = _mm256_blendv_ps(best_alp, alp2, gt);
+    best_row = _mm256_blendv_ps(best_row, _mm256_set1_ps((FFLOAT)i2), gt);
+  }
+  _mm256_store_ps(lane_sq, best_sq);
+  _mm256_store_ps(lane_alp, best_alp);
+  _mm256_store_ps(lane_row, best_row);
+  _mm256_zeroupper();
+  search_reduce(lane_sq, lane_alp, lane_row, row, col, sq, alp);
+}
+#endif
+
+/*---------------------------------------------------------------------------*
+ * NEON : 4 lanes, multiply and add kept separate (bit exact)                *
+ *---------------------------------------------------------------------------*/
+
+#if defined(DSP_HAS_NEON)
+void cor_h_NEON(FFLOAT *h, FFLOAT *rr)
+{
+  FFLOAT DSP_ALIGNED(16) hpad[L_PAD];
+  FFLOAT DSP_ALIGNED(16) part[L_SUBFR*L_SUBFR];
+  float32x4_t acc[L_SUBFR/4];
+  int n, v;
+
+  memcpy(hpad, h, L_SUBFR*sizeof(FFLOAT));
+  memset(hpad + L_SUBFR, 0, (L_PAD-L_SUBFR)*sizeof(FFLOAT));
+  for (v = 0; v < L_SUBFR/4; v++)
+    acc[v] = vdupq_n_f32(0.0f);
+
+  for (n = 0; n < L_SUBFR; n++)
+  {
+    float32x4_t hn = vdupq_n_f32(hpad[n]);
+    for (v = 0; v < L_SUBFR/4; v++)
+    {
+      acc[v] = vaddq_f32(acc[v], vmulq_f32(hn, vld1q_f32(hpad + n + 4*v)));
+      vst1q_f32(part + n*L_SUBFR + 4*v, acc[v]);
+    }
+  }
+  cor_h_gather(part, rr);
+}
+
+void cor_h_x_NEON(FFLOAT h[], FFLOAT x[], FFLOAT d[])
+{
+  FFLOAT DSP_ALIGNED(16) xpad[L_SUBFR + 8];
+  int i, k;
+
+  memcpy(xpad, x, L_SUBFR*sizeof(FFLOAT));
+  memset(xpad + L_SUBFR, 0, 8*sizeof(FFLOAT));
+
+  for (i = 0; i < L_SUBFR; i += 4)
+  {
+    float32x4_t s = vdupq_n_f32(0.0f);
+    for (k = 0; k < L_SUBFR-i; k++)
+      s = vaddq_f32(s, vmulq_f32(vld1q_f32(xpad + i + k), vdupq_n_f32(h[k])));
+    vst1q_f32(d + i, s);
+  }
+}
+
+void search_8x8_NEON(FFLOAT ps1[], FFLOAT alp1[], FFLOAT dn_col[], FFLOAT rr[],
+  FFLOAT tmp_vect[], int *row, int *col, FFLOAT *sq, FFLOAT *alp)
+{
+  FFLOAT DSP_ALIGNED(16) lane_sq[NB_POS], lane_alp[NB_POS], lane_row[NB_POS];
+  const float32x4_t zero = vdupq_n_f32(0.0f);
+  int i2, h;
+
+  for (h = 0; h < NB_POS; h += 4)
+  {
+    float32x4_t dn = vld1q_f32(dn_col + h);
+    float32x4_t tmp = vld1q_f32(tmp_vect + h);
+    float32x4_t best_sq = vdupq_n_f32(-1.0f);
+    float32x4_t best_alp = vdupq_n_f32(1.0f);
+    float32x4_t best_row = zero;
+
+    for (i2 = 0; i2 < NB_POS; i2++)
+    {
+      float32x4_t ps2 = vaddq_f32(vdupq_n_f32(ps1[i2]), dn);
+      float32x4_t alp2 = vaddq_f32(vaddq_f32(vdupq_n_f32(alp1[i2]),
+                                             vld1q_f32(rr + i2*NB_POS + h)), tmp);
+      float32x4_t sq2 = vmulq_f32(ps2, ps2);
+      float32x4_t s = vsubq_f32(vmulq_f32(best_alp, sq2), vmulq_f32(best_sq, alp2));
+      uint32x4_t gt = vcgtq_f32(s, zero);
+
+      best_sq = vbslq_f32(gt, sq2, best_sq);
+      best_alp = vbslq_f32(gt, alp2, best_alp);
+      best_row = vbslq_f32(gt, vdupq_n_f32((FFLOAT)i2), best_row);
+    }
+    vst1q_f32(lane_sq + h, best_sq);
+    vst1q_f32(lane_alp + h, best_alp);
+    vst1q_f32(lane_row + h, best_row);
+  }
+  search_reduce(lane_sq, lane_alp, lane_row, row, col, sq, alp);
+}
+#endif
@@ -34,6 +34,8 @@
  #include "ld8k.h"
  #include "tab_ld8k.h"
 #endif
+#include "dtx.h"
+#include "tab_dtx.h"
 
 /* prototypes for local functions */
 
@@ -151,3 +153,86 @@ static int  bin2int(            /* output: decimal value of bit pattern */
    }
    return(value);
 }
+
+/*----------------------------------------------------------------------------
+ * prm2bytes_ld8k - packs the encoder parameters into FRAME_BYTES octets
+ * bytes2prm_ld8k - unpacks FRAME_BYTES octets into the parameters
+ * prm2bytes_sid  - packs the SID parameters into SID_BYTES octets
+ * bytes2prm_sid  - unpacks SID_BYTES octets into the SID parameters
+ *
+ * Same bit order as prm2bits_ld8k followed by packing the serial bits MSB
+ * first, which is the RTP payload format of G.729 (RFC 3551), without the
+ * intermediate one word per bit vector. The SID is padded with zero bits.
+ *----------------------------------------------------------------------------
+ */
+static void pack_prm(
+ int  prm[],            /* input : parameters           */
+ int  nbit[],           /* input : bits per parameter   */
+ int  n,                /* input : number of parameters */
+ unsigned char bytes[]  /* output: packed bits          */
+)
+{
+   unsigned int acc;
+   int  i, nbits;
+
+   acc   = 0;
+   nbits = 0;
+   for (i = 0; i < n; i++)
+   {
+      acc    = (acc << nbit[i]) | ((unsigned int)prm[i] & ((1u << nbit[i]) - 1));
+      nbits += nbit[i];
+      while (nbits >= 8)
+      {
+         nbits -= 8;
+         *bytes++ = (unsigned char)(acc >> nbits);
+      }
+   }
+   if (nbits > 0)
+      *bytes = (unsigned char)(acc << (8 - nbits));
+   return;
+}
+
+static void unpack_prm(
+ unsigned char bytes[], /* input : packed bits          */
+ int  nbit[],           /* input : bits per parameter   */
+ int  n,                /* input : number of parameters */
+ int  prm[]             /* output: parameters           */
+)
+{
+   unsigned int acc;
+   int  i, nbits;
+
+   acc   = 0;
+   nbits = 0;
+   for (i = 0; i < n; i++)
+   {
+      while (nbits < nbit[i])
+      {
+         acc    = (acc << 8) | *bytes++;
+         nbits += 8;
+      }
+      nbits -= nbit[i];
+      prm[i] = (int)((acc >> nbits) & ((1u << nbit[i]) - 1));
+   }
+   return;
+}
+
+void prm2bytes_ld8k(int prm[], unsigned char bytes[])
+{
+   pack_prm(prm, bitsno, PRM_SIZE, bytes);
+}
+
+void bytes2prm_ld8k(unsigned char bytes[], int prm[])
+{
+   unpack_prm(bytes, bitsno, PRM_SIZE, prm);
+}
+
+void prm2bytes_sid(int prm[], unsigned char bytes[])
+{
+   pack_prm(prm, bitsno_sid, PRM_SIZE_SID, bytes);
+}
+
+void bytes2prm_sid(unsigned char bytes[], int prm[])
+{
+   unpack_prm(bytes, bitsno_sid, PRM_SIZE_SID, prm);
+}
@@ -0,0 +1,142 @@
+/*
+ File : CALCEXC.C
+ Comfort noise excitation of G.729 Annex B
+*/
+
+/*---------------------------------------------------------------------------*
+ * The excitation of a silent subframe mixes a random adaptive codebook      *
+ * vector, gaussian noise and 4 random pulses. The pulse amplitude is solved *
+ * so that the subframe energy is cur_gain^2 * L_SUBFR.                      *
+ *---------------------------------------------------------------------------*/
+
+#include <math.h>
+#include "typedef.h"
+#include "ld8a.h"
+#include "dtx.h"
+
+static INT16 random_cng(INT16 *seed);
+static FFLOAT gauss(INT16 *seed);
+
+void calc_exc_rand(
+  FFLOAT cur_gain,      /* (i)   : target excitation gain         */
+  FFLOAT *exc,          /* (i/o) : excitation, exc[0..L_FRAME-1]   */
+  INT16 *seed,          /* (i/o) : noise generator                 */
+  int flag_cod          /* (i)   : 1 in the encoder (taming update) */
+)
+{
+  FFLOAT excg[L_SUBFR];
+  FFLOAT *cur_exc;
+  FFLOAT sign[4];
+  FFLOAT Gp, fact, ener, b, c, delta, x, x1, x2;
+  int pos[4];
+  int i, i_subfr, t0, frac;
+  INT16 temp1, temp2;
+
+  if (cur_gain == (F)0.) {
+    set_zero(exc, L_FRAME);
+    if (flag_cod != 0) {
+      update_exc_err((F)0., L_SUBFR+1);
+      update_exc_err((F)0., L_SUBFR+1);
+    }
+    return;
+  }
+
+  for (i_subfr = 0; i_subfr < L_FRAME; i_subfr += L_SUBFR) {
+    cur_exc = exc + i_subfr;
+
+    /* random pitch delay, pulse positions and signs */
+    temp1 = random_cng(seed);
+    frac = (temp1 & 3) - 1;
+    if (frac == 2) frac = 0;
+    temp1 >>= 2;
+    t0 = (temp1 & 0x3F) + 40;
+    temp1 >>= 6;
+    temp2 = temp1 & 7;
+    pos[0] = 5 * temp2;
+    temp1 >>= 3;
+    sign[0] = (temp1 & 1) ? (F)1.0 : (F)-1.0;
+    temp1 >>= 1;
+    temp2 = temp1 & 7;
+    pos[1] = 5 * temp2 + 1;
+    temp1 >>= 3;
+    sign[1] = (temp1 & 1) ? (F)1.0 : (F)-1.0;
+
+    temp1 = random_cng(seed);
+    temp2 = temp1 & 7;
+    pos[2] = 5 * temp2 + 2;
+    temp1 >>= 3;
+    sign[2] = (temp1 & 1) ? (F)1.0 : (F)-1.0;
+    temp1 >>= 1;
+    temp2 = temp1 & 0xF;
+    pos[3] = 5 * (temp2 >> 1) + (temp2 & 1) + 3;
+    temp1 >>= 4;
+    sign[3] = (temp1 & 1) ? (F)1.0 : (F)-1.0;
+
+    /* adaptive codebook gain, uniform in [0, 0.5) */
+    Gp = (FFLOAT)(random_cng(seed) & 0x1FFF) / (F)16384.0;
+
+    /* gaussian part scaled to FRAC_GAUSS * cur_gain rms */
+    ener = (F)0.;
+    for (i = 0; i < L_SUBFR; i++) {
+      excg[i] = gauss(seed);
+      ener += excg[i] * excg[i];
+    }
+    fact = FRAC_GAUSS * cur_gain * (FFLOAT)sqrt((FFLOAT)L_SUBFR / ener);
+    for (i = 0; i < L_SUBFR; i++)
+      excg[i] *= fact;
+
+    /* adaptive + gaussian excitation */
+    pred_lt_3(cur_exc, t0, frac, L_SUBFR);
+    for (i = 0; i < L_SUBFR; i++)
+      cur_exc[i] = Gp * cur_exc[i] + excg[i];
+
+    /* pulse amplitude x : 4 x^2 + 2 b x + c = 0 */
+    for (;;) {
+      b = (F)0.;
+      for (i = 0; i < 4; i++)
+        b += sign[i] * cur_exc[pos[i]];
+      c = -cur_gain * cur_gain * (FFLOAT)L_SUBFR;
+      for (i = 0; i < L_SUBFR; i++)
+        c += cur_exc[i] * cur_exc[i];
+      delta = b * b - (F)4.0 * c;
+      if (delta >= (F)0. || Gp == (F)0.)
+        break;
+
+      /* adaptive part too strong : keep the gaussian noise only */
+      Gp = (F)0.;
+      for (i = 0; i < L_SUBFR; i++)
+        cur_exc[i] = excg[i];
+    }
+    if (delta < (F)0.) delta = (F)0.;
+
+    delta = (FFLOAT)sqrt(delta);
+    x1 = (-b + delta) / (F)4.0;
+    x2 = (-b - delta) / (F)4.0;
+    x = ((FFLOAT)fabs(x1) < (FFLOAT)fabs(x2)) ? x1 : x2;
+
+    for (i = 0; i < 4; i++)
+      cur_exc[pos[i]] += x * sign[i];
+
+    if (flag_cod != 0) update_exc_err(Gp, t0);
+  }
+  return;
+}
+
+/* same generator as random_g729(), with its own seed */
+static INT16 random_cng(INT16 *seed)
+{
+  *seed = (INT16)(*seed * 31821L + 13849L);
+  return *seed;
+}
+
+/* sum of 12 uniform values, unit variance */
+static FFLOAT gauss(INT16 *seed)
+{
+  FFLOAT temp;
+  int i;
+
+  temp = (F)0.;
+  for (i = 0; i < 12; i++)
+    temp += (FFLOAT)random_cng(seed);
+  return temp * ((F)0.5 / (F)32768.0);
+}
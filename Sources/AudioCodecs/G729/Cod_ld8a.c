@@ -42,13 +42,15 @@
  *                                                                 *
  *  Ouputs:                                                        *
  *                                                                 *
- *    ana[]      ->analysis parameters.                            *
+ *    ana[0]     ->frame type (FR_SPEECH, FR_SID or FR_NOT_SENT)   *
+ *    ana[1..]   ->analysis parameters.                            *
  *                                                                 *
  *-----------------------------------------------------------------*/
 
 #include <math.h>
 #include "typedef.h"
 #include "ld8a.h"
+#include "dtx.h"
 
 
 /*-----------------------------------------------------------*
@@ -99,6 +101,13 @@
  static FFLOAT  mem_w0[M], mem_w[M], mem_zero[M];
  static FFLOAT  sharp;
 
+        /* Annex B : VAD and DTX */
+
+ static int    dtx_enable;
+ static int    pastVad, ppastVad;
+ static int    frame;
+ static INT16  seed;
+
 /*-----------------------------------------------------------------*
  *   Function  init_coder_ld8a                                     *
  *            ~~~~~~~~~~~~~~~                                      *
@@ -154,6 +163,28 @@ void init_coder_ld8a(void)
    lsp_encw_reset() ;
    init_exc_err();
 
+   /* Annex B */
+
+   pastVad  = 1;
+   ppastVad = 1;
+   frame    = 0;
+   seed     = INIT_SEED;
+   init_vad();
+   init_cod_cng();
+
+   return;
+}
+
+/*-----------------------------------------------------------------*
+ *   Function set_dtx_ld8a                                         *
+ *            ~~~~~~~~~~~~                                         *
+ *   ->Switches the Annex B VAD/DTX on or off. Off, every frame is *
+ *     a speech frame and the bitstream is plain G.729A.           *
+ *-----------------------------------------------------------------*/
+
+void set_dtx_ld8a(int enable)
+{
+   dtx_enable = enable ? 1 : 0;
    return;
 }
 
@@ -172,12 +203,13 @@ void init_coder_ld8a(void)
  *                                                                 *
  *  Ouputs:                                                        *
  *                                                                 *
- *    ana[]      ->analysis parameters.                            *
+ *    ana[0]     ->frame type (FR_SPEECH, FR_SID or FR_NOT_SENT)   *
+ *    ana[1..]   ->analysis parameters.                            *
  *                                                                 *
  *-----------------------------------------------------------------*/
 
 void coder_ld8a(
- int ana[]                   /* output: analysis parameters */
+ int ana[]                   /* output: frame type, analysis parameters */
 )
 {
    /* LPC coefficients */
@@ -216,18 +248,87 @@ void coder_ld8a(
  *------------------------------------------------------------------------*/
    {
       /* Temporary vectors */
-     FFLOAT r[MP1];                    /* Autocorrelations       */
+     FFLOAT r[NP+1];                   /* Autocorrelations       */
      FFLOAT rc[M];                     /* Reflexion coefficients */
      FFLOAT lsp_new[M];                /* lsp coefficients       */
      FFLOAT lsp_new_q[M];              /* Quantized lsp coeff.   */
+     FFLOAT lsf_new[M];                /* lsf for the VAD        */
+     int    Vad;
+
+     if (frame == 32767) frame = 256;
+     else frame++;
 
      /* LP analysis */
 
-     autocorr(p_window, M, r);             /* Autocorrelations */
-     lag_window_729(M, r);                     /* Lag windowing    */
+     if (dtx_enable)
+     {
+       autocorr(p_window, NP, r);          /* Autocorrelations */
+       lag_window_729(NP, r);              /* Lag windowing    */
+     }
+     else
+     {
+       autocorr(p_window, M, r);
+       lag_window_729(M, r);
+     }
      levinson(r, Ap_t, rc);                /* Levinson Durbin  */
      az_lsp(Ap_t, lsp_new, lsp_old);       /* Convert A(z) to lsp */
 
+     /* Voice activity detection (Annex B) */
+
+     if (dtx_enable)
+     {
+       for (i=0; i<M; i++)
+         lsf_new[i] = (FFLOAT)acos(lsp_new[i]);
+       Vad = vad(rc[1], lsf_new, r, p_window, frame, pastVad, ppastVad);
+       update_cng(r, Vad);
+     }
+     else
+       Vad = 1;
+
+     if (Vad == 0)
+     {
+       /*--------------------------------------------------------------*
+        * Silence : comfort noise excitation, maybe a SID frame. Only  *
+        * the memories of the weighting filters need an update.        *
+        *--------------------------------------------------------------*/
+
+       cod_cng(exc, pastVad, lsp_old_q, Aq_t, ana, &seed);
+       ppastVad = pastVad;
+       pastVad  = Vad;
+       copy(lsp_new, lsp_old, M);
+
+       Aq = Aq_t;
+       for (i_subfr = 0; i_subfr < L_FRAME; i_subfr += L_SUBFR)
+       {
+         FFLOAT Ap1[MP1];
+
+         residu(Aq, &speech[i_subfr], xn, L_SUBFR);
+         weight_az(Aq, GAMMA1, M, Ap_t);
+
+         Ap1[0] = (F)1.0;
+         for (i=1; i<=M; i++)
+           Ap1[i] = Ap_t[i] - (F)0.7 * Ap_t[i-1];
+         syn_filt(Ap1, xn, &wsp[i_subfr], L_SUBFR, mem_w, 1);
+
+         for (i=0; i<L_SUBFR; i++)
+           xn[i] -= exc[i_subfr+i];
+         syn_filt(Ap_t, xn, xn, L_SUBFR, mem_w0, 1);
+
+         Aq += MP1;
+       }
+       sharp = SHARPMIN;
+
+       copy(&old_speech[L_FRAME], &old_speech[0], L_TOTAL-L_FRAME);
+       copy(&old_wsp[L_FRAME], &old_wsp[0], PIT_MAX);
+       copy(&old_exc[L_FRAME], &old_exc[0], PIT_MAX+L_INTERPOL);
+       return;
+     }
+
+     ppastVad = pastVad;
+     pastVad  = Vad;
+     seed     = INIT_SEED;
+     *ana++   = FR_SPEECH;
+
      /* LSP quantization */
 
      qua_lsp(lsp_new, lsp_new_q, ana);
@@ -30,6 +30,7 @@
 #else
  #include "ld8k.h"
 #endif
+#include "ld8a_simd.h"
 
 /*----------------------------------------------------------------------------
  * corr_xy2 - compute the correlation products needed for gain computation
@@ -67,7 +68,7 @@ void corr_xy2(
  * Compute  correlations of input response h[] with the target vector X[].  *
  *--------------------------------------------------------------------------*/
 
-void cor_h_x(
+static void cor_h_x_C(
      FFLOAT h[],        /* (i) :Impulse response of filters      */
      FFLOAT x[],        /* (i) :Target vector                    */
      FFLOAT d[]         /* (o) :Correlations between h[] and x[] */
@@ -87,3 +88,23 @@ void cor_h_x(
    return;
 }
 
+void cor_h_x(
+     FFLOAT h[],        /* (i) :Impulse response of filters      */
+     FFLOAT x[],        /* (i) :Target vector                    */
+     FFLOAT d[]         /* (o) :Correlations between h[] and x[] */
+)
+{
+   void (*CorHX)(FFLOAT *, FFLOAT *, FFLOAT *) = cor_h_x_C;
+
+#if defined(DSP_HAS_SSE2)
+   if (DSP_TEST_CPU(kCpuHasSSE2)) CorHX = cor_h_x_SSE2;
+#endif
+#if defined(DSP_HAS_AVX2)
+   if (DSP_TEST_CPU(kCpuHasAVX2) && DSP_TEST_CPU(kCpuHasFMA3)) CorHX = cor_h_x_AVX2;
+#endif
+#if defined(DSP_HAS_NEON)
+   if (DSP_TEST_CPU(kCpuHasNEON)) CorHX = cor_h_x_NEON;
+#endif
+
+   CorHX(h, x, d);
+}
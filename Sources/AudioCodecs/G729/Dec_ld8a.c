@@ -21,6 +21,7 @@
 
 #include "typedef.h"
 #include "ld8a.h"
+#include "dtx.h"
 
 /*---------------------------------------------------------------*
  *   Decoder constant parameters (defined in "ld8a.h")           *
@@ -56,6 +57,12 @@
  static FFLOAT gain_code;        /* Code gain                          */
  static FFLOAT gain_pitch;       /* Pitch gain                         */
 
+        /* Annex B : comfort noise */
+
+ static int    past_ftyp;        /* type of the previous frame         */
+ static FFLOAT sid_sav;          /* excitation energy of last speech   */
+ static INT16  seed;             /* comfort noise generator            */
+
 
 /*-----------------------------------------------------------------*
  *   Function init_decod_ld8a                                      *
@@ -84,6 +91,11 @@ void init_decod_ld8a(void)
 
   lsp_decw_reset() ;
 
+  past_ftyp = FR_SPEECH;
+  sid_sav   = (F)0.0;
+  seed      = INIT_SEED;
+  init_dec_cng();
+
   return;
 }
 
@@ -110,12 +122,39 @@ void decod_ld8a(
 
    int i, i_subfr;
    int T0, T0_frac, index;
-   int  bfi, bad_pitch;
+   int  bfi, bad_pitch, ftyp;
    extern int bad_lsf;        /* bad LSF indicator   */
 
    /* Test bad frame indicator (bfi) */
 
    bfi = *parm++;
+   ftyp = *parm++;
+
+   /* An erased frame is concealed as speech during a talk spurt and as */
+   /* comfort noise during silence.                                     */
+
+   if (bfi != 0)
+     ftyp = (past_ftyp == FR_SPEECH) ? FR_SPEECH : FR_NOT_SENT;
+
+   if (ftyp != FR_SPEECH)
+   {
+     parm[-1] = ftyp;
+     dec_cng(past_ftyp, sid_sav, parm, exc, lsp_old, A_t, &seed);
+
+     Az = A_t;
+     for (i_subfr = 0; i_subfr < L_FRAME; i_subfr += L_SUBFR) {
+       syn_filt(Az, &exc[i_subfr], &synth[i_subfr], L_SUBFR, mem_syn, 1);
+       Az += MP1;
+       *T2++ = old_T0;
+     }
+     sharp = SHARPMIN;
+     past_ftyp = ftyp;
+
+     copy(&old_exc[L_FRAME], &old_exc[0], PIT_MAX+L_INTERPOL);
+     return;
+   }
+
+   seed = INIT_SEED;
 
    /* Decode the LSPs */
 
@@ -245,6 +284,13 @@ void decod_ld8a(
       Az  += MP1;        /* interpolated LPC parameters for next subframe */
    }
 
+   /* excitation energy, level of the comfort noise if the SID is lost */
+
+   sid_sav = (F)0.0;
+   for (i = 0; i < L_FRAME; i++)
+     sid_sav += exc[i] * exc[i];
+   past_ftyp = FR_SPEECH;
+
   /*--------------------------------------------------*
    * Update signal for next frame.                    *
    * -> shift to the left by L_FRAME  exc[]           *
@@ -0,0 +1,68 @@
+/*
+ File : DEC_SID.C
+ Comfort noise generation of the G.729 Annex B decoder
+*/
+
+#include "typedef.h"
+#include "ld8a.h"
+#include "dtx.h"
+#include "tab_dtx.h"
+
+/* static memory */
+static FFLOAT lspSid[M];
+static FFLOAT cur_gain;
+static FFLOAT sid_gain;
+
+static FFLOAT lspSid_reset[M] = {
+ (F)0.9595,  (F)0.8413,  (F)0.6549,  (F)0.4154,  (F)0.1423,
+(F)-0.1423, (F)-0.4154, (F)-0.6549, (F)-0.8413, (F)-0.9595
+};
+
+/*---------------------------------------------------------------------------*
+ * init_dec_cng - reset the comfort noise memories                           *
+ *---------------------------------------------------------------------------*/
+void init_dec_cng(void)
+{
+  copy(lspSid_reset, lspSid, M);
+  cur_gain = (F)0.;
+  sid_gain = tab_Sidgain[0];
+  return;
+}
+
+/*---------------------------------------------------------------------------*
+ * dec_cng - excitation and LP filters of a SID or untransmitted frame       *
+ *---------------------------------------------------------------------------*/
+void dec_cng(
+  int past_ftyp,
+  FFLOAT sid_sav,
+  int *parm,
+  FFLOAT *exc,
+  FFLOAT *lsp_old,
+  FFLOAT *A_t,
+  INT16 *seed
+)
+{
+  FFLOAT temp;
+  int ind;
+
+  if (parm[-1] == FR_SID) {
+    sid_gain = tab_Sidgain[parm[3]];
+    d_lsp_sid(parm, lspSid);
+  }
+  else if (past_ftyp == FR_SPEECH) {
+    /* first SID of the silence lost : level of the last speech frame */
+    qua_sid_gain(&sid_sav, 0, &temp, &ind);
+    sid_gain = tab_Sidgain[ind];
+  }
+
+  if (past_ftyp == FR_SPEECH)
+    cur_gain = sid_gain;
+  else
+    cur_gain = A_GAIN0 * cur_gain + A_GAIN1 * sid_gain;
+
+  calc_exc_rand(cur_gain, exc, seed, 0);
+
+  int_qlpc(lsp_old, lspSid, A_t);
+  copy(lspSid, lsp_old, M);
+  return;
+}
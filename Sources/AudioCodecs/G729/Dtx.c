@@ -0,0 +1,302 @@
+/*
+ File : DTX.C
+ Discontinuous transmission of G.729 Annex B (encoder side)
+*/
+
+/*---------------------------------------------------------------------------*
+ * During silence the encoder keeps the autocorrelations of the last frames. *
+ * A SID frame is sent on the first silent frame and then only when the      *
+ * spectrum or the energy of the noise changes, at most every FR_SID_MIN     *
+ * frames. The coder runs the same comfort noise generator as the decoder,   *
+ * so both keep identical excitation and LSP memories.                       *
+ *---------------------------------------------------------------------------*/
+
+#include <math.h>
+#include "typedef.h"
+#include "ld8a.h"
+#include "dtx.h"
+#include "tab_dtx.h"
+
+static void update_sum_acf(void);
+static void calc_sum_acf(FFLOAT *acf, FFLOAT *sum, int nb);
+static void calc_past_filt(FFLOAT *Coeff);
+static void calc_rcoeff(FFLOAT *Coeff, FFLOAT *RCoeff);
+static int  cmp_filt(FFLOAT *RCoeff, FFLOAT *acf, FFLOAT alpha, FFLOAT thresh);
+static int  quant_energy(FFLOAT ener, FFLOAT *enerq);
+
+/* static memory */
+static FFLOAT lspSid_q[M];
+static FFLOAT pastCoeff[MP1];
+static FFLOAT RCoeff[MP1];
+static FFLOAT Acf[SIZ_ACF];
+static FFLOAT sumAcf[SIZ_SUMACF];
+static FFLOAT ener[NB_GAIN];
+static int fr_cur;
+static FFLOAT cur_gain;
+static int nb_ener;
+static FFLOAT sid_gain;
+static int flag_chang;
+static FFLOAT prev_energy;
+static int count_fr0;
+
+/*---------------------------------------------------------------------------*
+ * init_cod_cng - reset the DTX memories                                     *
+ *---------------------------------------------------------------------------*/
+void init_cod_cng(void)
+{
+  set_zero(sumAcf, SIZ_SUMACF);
+  set_zero(Acf, SIZ_ACF);
+  set_zero(ener, NB_GAIN);
+  set_zero(pastCoeff, MP1);
+  set_zero(RCoeff, MP1);
+  set_zero(lspSid_q, M);
+  cur_gain = (F)0.;
+  sid_gain = (F)0.;
+  prev_energy = (F)0.;
+  fr_cur = 0;
+  nb_ener = 0;
+  flag_chang = 0;
+  count_fr0 = 0;
+  return;
+}
+
+/*---------------------------------------------------------------------------*
+ * update_cng - store the autocorrelations r[0..M] of the current frame      *
+ *---------------------------------------------------------------------------*/
+void update_cng(
+  FFLOAT *r,            /* (i) : lag windowed autocorrelations */
+  int vad               /* (i) : VAD decision of the frame     */
+)
+{
+  int i;
+
+  for (i = SIZ_ACF-1; i >= MP1; i--)
+    Acf[i] = Acf[i-MP1];
+  for (i = 0; i < MP1; i++)
+    Acf[i] = r[i];
+
+  fr_cur++;
+  if (fr_cur == NB_CURACF) {
+    fr_cur = 0;
+    if (vad != 0) update_sum_acf();
+  }
+  return;
+}
+
+/*---------------------------------------------------------------------------*
+ * cod_cng - comfort noise frame of the encoder, decides on a SID update     *
+ *---------------------------------------------------------------------------*/
+void cod_cng(
+  FFLOAT *exc,
+  int past_vad,
+  FFLOAT *lsp_old_q,
+  FFLOAT *Aq,
+  int *ana,
+  INT16 *seed
+)
+{
+  FFLOAT curAcf[MP1];
+  FFLOAT curCoeff[MP1];
+  FFLOAT rc[M];
+  FFLOAT lsp_new[M];
+  FFLOAT *lpcCoeff;
+  FFLOAT energyq;
+  int i, cur_igain;
+
+  /* residual energy of the current filter */
+  for (i = NB_GAIN-1; i >= 1; i--)
+    ener[i] = ener[i-1];
+
+  calc_sum_acf(Acf, curAcf, NB_CURACF);
+  if (curAcf[0] == (F)0.) {
+    ener[0] = (F)0.;
+    curCoeff[0] = (F)1.;
+    set_zero(&curCoeff[1], M);
+  }
+  else
+    ener[0] = levinson(curAcf, curCoeff, rc);
+
+  if (past_vad != 0) {
+    /* first frame of silence : always a SID */
+    ana[0] = FR_SID;
+    count_fr0 = 0;
+    nb_ener = 1;
+    qua_sid_gain(ener, nb_ener, &energyq, &cur_igain);
+  }
+  else {
+    nb_ener++;
+    if (nb_ener > NB_GAIN) nb_ener = NB_GAIN;
+    qua_sid_gain(ener, nb_ener, &energyq, &cur_igain);
+
+    /* has the spectrum or the energy moved since the last SID ? */
+    if (cmp_filt(RCoeff, curAcf, ener[0], THRESH1) != 0)
+      flag_chang = 1;
+    if ((FFLOAT)fabs(prev_energy - energyq) > (F)2.0)
+      flag_chang = 1;
+
+    count_fr0++;
+    if (count_fr0 < FR_SID_MIN)
+      ana[0] = FR_NOT_SENT;
+    else {
+      ana[0] = (flag_chang != 0) ? FR_SID : FR_NOT_SENT;
+      count_fr0 = FR_SID_MIN;
+    }
+  }
+
+  if (ana[0] == FR_SID) {
+    count_fr0 = 0;
+    flag_chang = 0;
+
+    /* send the average filter of the past frames if it still matches the
+       current spectrum, the current filter otherwise */
+    calc_past_filt(pastCoeff);
+    calc_rcoeff(pastCoeff, RCoeff);
+    if (cmp_filt(RCoeff, curAcf, ener[0], THRESH2) == 0)
+      lpcCoeff = pastCoeff;
+    else {
+      lpcCoeff = curCoeff;
+      calc_rcoeff(curCoeff, RCoeff);
+    }
+
+    az_lsp(lpcCoeff, lsp_new, lsp_old_q);
+    qua_lsp_sid(lsp_new, lspSid_q, &ana[1]);
+
+    prev_energy = energyq;
+    ana[4] = cur_igain;
+    sid_gain = tab_Sidgain[cur_igain];
+  }
+
+  /* comfort noise excitation, same as the decoder */
+  if (past_vad != 0)
+    cur_gain = sid_gain;
+  else
+    cur_gain = A_GAIN0 * cur_gain + A_GAIN1 * sid_gain;
+
+  calc_exc_rand(cur_gain, exc, seed, 1);
+
+  int_qlpc(lsp_old_q, lspSid_q, Aq);
+  copy(lspSid_q, lsp_old_q, M);
+
+  if (fr_cur == 0) update_sum_acf();
+  return;
+}
+
+/*---------------------------------------------------------------------------*
+ * qua_sid_gain - quantize the average residual energy of the last frames    *
+ *---------------------------------------------------------------------------*/
+void qua_sid_gain(
+  FFLOAT *ener,         /* (i) : residual energies (nb_ener = 0 : sid_sav) */
+  int nb_ener,          /* (i) : number of energies to average            */
+  FFLOAT *enerq,        /* (o) : quantized energy in dB                   */
+  int *idx              /* (o) : quantization index                       */
+)
+{
+  FFLOAT x;
+  int i;
+
+  if (nb_ener == 0)
+    x = ener[0] * fact_sid[0];
+  else {
+    x = (F)0.;
+    for (i = 0; i < nb_ener; i++)
+      x += ener[i];
+    x *= fact_sid[nb_ener];
+  }
+
+  *idx = quant_energy(x, enerq);
+  return;
+}
+
+static int quant_energy(FFLOAT ener, FFLOAT *enerq)
+{
+  FFLOAT ener_dB;
+  int index;
+
+  ener_dB = (ener > (F)1.0e-10) ? (F)10.0 * (FFLOAT)log10(ener) : (F)-100.0;
+
+  if (ener_dB <= (F)-8.0) {
+    *enerq = (F)-12.0;
+    return 0;
+  }
+  if (ener_dB >= (F)65.0) {
+    *enerq = (F)66.0;
+    return NB_SIDGAIN-1;
+  }
+  if (ener_dB <= (F)14.0) {
+    index = (int)((ener_dB + (F)10.0) * (F)0.25);
+    if (index < 1) index = 1;
+    *enerq = (F)4.0 * (FFLOAT)index - (F)8.0;
+    return index;
+  }
+  index = (int)((ener_dB - (F)3.0) * (F)0.5);
+  if (index < 6) index = 6;
+  *enerq = (F)2.0 * (FFLOAT)index + (F)4.0;
+  return index;
+}
+
+/*---------------------------------------------------------------------------*
+ * local functions                                                           *
+ *---------------------------------------------------------------------------*/
+static void update_sum_acf(void)
+{
+  int i;
+
+  for (i = SIZ_SUMACF-1; i >= MP1; i--)
+    sumAcf[i] = sumAcf[i-MP1];
+  calc_sum_acf(Acf, sumAcf, NB_CURACF);
+  return;
+}
+
+static void calc_sum_acf(FFLOAT *acf, FFLOAT *sum, int nb)
+{
+  int i, j;
+
+  for (j = 0; j < MP1; j++)
+    sum[j] = (F)0.;
+  for (i = 0; i < nb; i++)
+    for (j = 0; j < MP1; j++)
+      sum[j] += acf[i*MP1 + j];
+  return;
+}
+
+static void calc_past_filt(FFLOAT *Coeff)
+{
+  FFLOAT s_sumAcf[MP1];
+  FFLOAT rc[M];
+
+  calc_sum_acf(sumAcf, s_sumAcf, NB_SUMACF);
+  if (s_sumAcf[0] == (F)0.) {
+    Coeff[0] = (F)1.;
+    set_zero(&Coeff[1], M);
+    return;
+  }
+  levinson(s_sumAcf, Coeff, rc);
+  return;
+}
+
+/* autocorrelation of A(z), the lags > 0 counted twice */
+static void calc_rcoeff(FFLOAT *Coeff, FFLOAT *RCoeff)
+{
+  FFLOAT temp;
+  int i, j;
+
+  for (i = 0; i <= M; i++) {
+    temp = (F)0.;
+    for (j = 0; j <= M-i; j++)
+      temp += Coeff[j] * Coeff[j+i];
+    RCoeff[i] = (i == 0) ? temp : (F)2.0 * temp;
+  }
+  return;
+}
+
+/* 1 when filtering acf with A(z) leaves more than thresh * alpha */
+static int cmp_filt(FFLOAT *RCoeff, FFLOAT *acf, FFLOAT alpha, FFLOAT thresh)
+{
+  FFLOAT temp;
+  int i;
+
+  temp = (F)0.;
+  for (i = 0; i <= M; i++)
+    temp += RCoeff[i] * acf[i];
+  return (temp > alpha * thresh) ? 1 : 0;
+}
@@ -0,0 +1,125 @@
+/*
+ File : LSP_SIMD.C
+ Distance engine of the G.729A LSP quantizer (see ld8a_simd.h)
+*/
+
+/*---------------------------------------------------------------------------*
+ * The codebooks are stored transposed (lspcb1_t, lspcb2_t in Tab_ld8a.c) so *
+ * that one load brings the same coefficient of 4/8 consecutive rows. Each   *
+ * pass over j updates the distance of 16 rows, the caller then picks the    *
+ * first minimum like the reference loops.                                   *
+ *---------------------------------------------------------------------------*/
+
+#include "typedef.h"
+#include "ld8a.h"
+#include "ld8a_simd.h"
+
+void lsp_dist_C(FFLOAT *cb_t, int rows, FFLOAT target[], FFLOAT wegt[],
+  int j0, int j1, FFLOAT dist[])
+{
+  int i, j;
+  FFLOAT w, tmp;
+
+  for (i = 0; i < rows; i++)
+    dist[i] = (F)0.0;
+
+  for (j = j0; j < j1; j++)
+  {
+    w = wegt ? wegt[j] : (F)1.0;
+    for (i = 0; i < rows; i++)
+    {
+      tmp = target[j] - cb_t[j*rows + i];
+      dist[i] += w * tmp * tmp;
+    }
+  }
+}
+
+#if defined(DSP_HAS_SSE2)
+void lsp_dist_SSE2(FFLOAT *cb_t, int rows, FFLOAT target[], FFLOAT wegt[],
+  int j0, int j1, FFLOAT dist[])
+{
+  int i, j;
+
+  for (i = 0; i < rows; i += 16)
+  {
+    __m128 d0 = _mm_setzero_ps(), d1 = d0, d2 = d0, d3 = d0;
+    for (j = j0; j < j1; j++)
+    {
+      const FFLOAT *c = cb_t + j*rows + i;
+      __m128 t = _mm_set1_ps(target[j]);
+      __m128 w = _mm_set1_ps(wegt ? wegt[j] : (F)1.0);
+      __m128 e0 = _mm_sub_ps(t, _mm_loadu_ps(c));
+      __m128 e1 = _mm_sub_ps(t, _mm_loadu_ps(c + 4));
+      __m128 e2 = _mm_sub_ps(t, _mm_loadu_ps(c + 8));
+      __m128 e3 = _mm_sub_ps(t, _mm_loadu_ps(c + 12));
+      d0 = _mm_add_ps(d0, _mm_mul_ps(_mm_mul_ps(w, e0), e0));
+      d1 = _mm_add_ps(d1, _mm_mul_ps(_mm_mul_ps(w, e1), e1));
+      d2 = _mm_add_ps(d2, _mm_mul_ps(_mm_mul_ps(w, e2), e2));
+      d3 = _mm_add_ps(d3, _mm_mul_ps(_mm_mul_ps(w, e3), e3));
+    }
+    _mm_storeu_ps(dist + i, d0);
+    _mm_storeu_ps(dist + i + 4, d1);
+    _mm_storeu_ps(dist + i + 8, d2);
+    _mm_storeu_ps(dist + i + 12, d3);
+  }
+}
+#endif
+
+/* no FMA here : the distances stay bit exact with the reference */
+#if defined(DSP_HAS_AVX2)
+DSP_TARGET_AVX2
+void lsp_dist_AVX2(FFLOAT *cb_t, int rows, FFLOAT target[], FFLOAT wegt[],
+  int j0, int j1, FFLOAT dist[])
+{
+  int i, j;
+
+  for (i = 0; i < rows; i += 16)
+  {
+    __m256 d0 = _mm256_setzero_ps(), d1 = d0;
+    for (j = j0; j < j1; j++)
+    {
+      const FFLOAT *c = cb_t + j*rows + i;
+      __m256 t = _mm256_set1_ps(target[j]);
+      __m256 w = _mm256_set1_ps(wegt ? wegt[j] : (F)1.0);
+      __m256 e0 = _mm256_sub_ps(t, _mm256_loadu_ps(c));
+      __m256 e1 = _mm256_sub_ps(t, _mm256_loadu_ps(c + 8));
+      d0 = _mm256_add_ps(d0, _mm256_mul_ps(_mm256_mul_ps(w, e0), e0));
+      d1 = _mm256_add_ps(d1, _mm256_mul_ps(_mm256_mul_ps(w, e1), e1));
+    }
+    _mm256_storeu_ps(dist + i, d0);
+    _mm256_storeu_ps(dist + i + 8, d1);
+  }
+  _mm256_zeroupper();
+}
+#endif
+
+#if defined(DSP_HAS_NEON)
+void lsp_dist_NEON(FFLOAT *cb_t, int rows, FFLOAT target[], FFLOAT wegt[],
+  int j0, int j1, FFLOAT dist[])
+{
+  int i, j;
+
+  for (i = 0; i < rows; i += 16)
+  {
+    float32x4_t d0 = vdupq_n_f32(0.0f), d1 = d0, d2 = d0, d3 = d0;
+    for (j = j0; j < j1; j++)
+    {
+      const FFLOAT *c = cb_t + j*rows + i;
+      float32x4_t t = vdupq_n_f32(target[j]);
+      float32x4_t w = vdupq_n_f32(wegt ? wegt[j] : (F)1.0);
+      float32x4_t e0 = vsubq_f32(t, vld1q_f32(c));
+      float32x4_t e1 = vsubq_f32(t, vld1q_f32(c + 4));
+      float32x4_t e2 = vsubq_f32(t, vld1q_f32(c + 8));
+      float32x4_t e3 = vsubq_f32(t, vld1q_f32(c + 12));
+      d0 = vaddq_f32(d0, vmulq_f32(vmulq_f32(w, e0), e0));
+      d1 = vaddq_f32(d1, vmulq_f32(vmulq_f32(w, e1), e1));
+      d2 = vaddq_f32(d2, vmulq_f32(vmulq_f32(w, e2), e2));
+      d3 = vaddq_f32(d3, vmulq_f32(vmulq_f32(w, e3), e3));
+    }
+    vst1q_f32(dist + i, d0);
+    vst1q_f32(dist + i + 4, d1);
+    vst1q_f32(dist + i + 8, d2);
+    vst1q_f32(dist + i + 12, d3);
+  }
+}
+#endif
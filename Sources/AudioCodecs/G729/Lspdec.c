@@ -30,6 +30,8 @@
  #include "ld8k.h"
  #include "tab_ld8k.h"
 #endif
+#include "dtx.h"
+#include "tab_dtx.h"
 
 /* Prototype definitions of static functions */
 static void lsp_iqua_cs( int prm[], FFLOAT lsp[], int erase);
@@ -61,6 +63,7 @@ void lsp_decw_reset(void)
 
    copy (freq_prev_reset, prev_lsp, M );
 
+   init_lsfq_noise();
    return;
 }
 
@@ -128,3 +131,30 @@ void d_lsp(
    return;
 }
 
+/*----------------------------------------------------------------------------
+ * d_lsp_sid - decode the LSP of a SID frame (Annex B)
+ *----------------------------------------------------------------------------
+ */
+void d_lsp_sid(
+    int     index[],    /* input : predictor, 1st and 2nd stage index */
+    FFLOAT   lsp_q[]     /* output: decoded lsp                        */
+)
+{
+   int i, mode_index, code0, code1;
+
+   mode_index = index[0] & 1;
+   code0 = index[1] & (NC0_SID - 1);
+   code1 = index[2] & (NC1_SID - 1);
+
+   lsp_get_quant(lspcb1, lspcb2, PtrTab_1[code0], PtrTab_2[0][code1],
+                 PtrTab_2[1][code1], noise_fg[mode_index], freq_prev, lsp_q,
+                 noise_fg_sum[mode_index]);
+
+   copy(lsp_q, prev_lsp, M );
+
+   for (i=0; i<M; i++ )
+     lsp_q[i] = (FFLOAT)cos(lsp_q[i]);
+
+   return;
+}
+
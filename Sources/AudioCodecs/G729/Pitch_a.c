@@ -22,6 +22,12 @@
 #include <math.h>
 #include "typedef.h"
 #include "ld8a.h"
+#include "ld8a_simd.h"
+
+/* even and odd samples of s[-PIT_MAX : L_FRAME-1] : the lags of the  */
+/* decimated open loop correlation become unit stride                 */
+#define OL_HALF_MAX  ((PIT_MAX+1)/2)
+#define OL_HALF_LEN  (OL_HALF_MAX + L_FRAME/2)
 
 /* prototypes for local functions */
 
@@ -41,6 +47,9 @@ int pitch_ol_fast(         /* output: open-loop pitch lag       */
     int  T1, T2, T3;
     FFLOAT  max1, max2, max3;
     FFLOAT  *p, *p1, sum;
+    FFLOAT  even[OL_HALF_LEN], odd[OL_HALF_LEN];
+    FFLOAT  *s_even, *s_odd;
+    FFLOAT  c_even[(PIT_MAX-PIT_MIN)/2+1], c_odd[(PIT_MAX-PIT_MIN)/2+1];
 
 
    /*--------------------------------------------------------------------*
@@ -54,16 +63,29 @@ int pitch_ol_fast(         /* output: open-loop pitch lag       */
     *  Third section:  lag delay = 80 to 143                             *
     *--------------------------------------------------------------------*/
 
+   /*--------------------------------------------------------------------*
+    *  With the decimation by 2, the correlation at lag 2q is the         *
+    *  correlation of the even samples at lag q, the one at lag 2q+1 the  *
+    *  correlation of the even samples with the odd samples at lag q+1.   *
+    *  s_even[n] = s[2n] and s_odd[n] = s[2n+1], n >= -OL_HALF_MAX.        *
+    *--------------------------------------------------------------------*/
+
+    s_even = even + OL_HALF_MAX;
+    s_odd  = odd + OL_HALF_MAX;
+    for (i = 1-OL_HALF_MAX; i < l_frame/2; i++)
+        s_even[i] = signal[2*i];
+    for (i = -OL_HALF_MAX; i < l_frame/2; i++)
+        s_odd[i] = signal[2*i+1];
+
     /* First section */
 
+    corr_lags(s_even, s_even - 10, l_frame/2, 10, (F)0.0, c_even);
+    corr_lags(s_even, s_odd - 11, l_frame/2, 10, (F)0.0, c_odd);
+
     max1 = FLT_MIN_G729;
     for (i = 20; i < 40; i++) {
-        p  = signal;
-        p1 = &signal[-i];
-        sum = (F)0.0;
         /* Dot product with decimation by 2 */
-        for (j=0; j<l_frame; j+=2, p+=2, p1+=2)
-            sum += *p * *p1;
+        sum = (i & 1) ? c_odd[(i-21)/2] : c_even[(i-20)/2];
         if (sum > max1) { max1 = sum; T1 = i;}
     }
 
@@ -79,14 +101,13 @@ int pitch_ol_fast(         /* output: open-loop pitch lag       */
 
     /* Second section */
 
+    corr_lags(s_even, s_even - 20, l_frame/2, 20, (F)0.0, c_even);
+    corr_lags(s_even, s_odd - 21, l_frame/2, 20, (F)0.0, c_odd);
+
     max2 = FLT_MIN_G729;
     for (i = 40; i < 80; i++) {
-        p  = signal;
-        p1 = &signal[-i];
-        sum = (F)0.0;
         /* Dot product with decimation by 2 */
-        for (j=0; j<l_frame; j+=2, p+=2, p1+=2)
-            sum += *p * *p1;
+        sum = (i & 1) ? c_odd[(i-41)/2] : c_even[(i-40)/2];
         if (sum > max2) { max2 = sum; T2 = i;}
     }
 
@@ -101,15 +122,13 @@ int pitch_ol_fast(         /* output: open-loop pitch lag       */
 
     /* Third section */
 
+    /* decimation by 2 for the possible delay : even lags only */
+    corr_lags(s_even, s_even - 40, l_frame/2, 32, (F)0.0, c_even);
+
     max3 = FLT_MIN_G729;
-    /* decimation by 2 for the possible delay */
     for (i = 80; i < 143; i+=2) {
-        p  = signal;
-        p1 = &signal[-i];
-        sum = (F)0.0;
         /* Dot product with decimation by 2 */
-        for (j=0; j<l_frame; j+=2, p+=2, p1+=2)
-            sum += *p * *p1;
+        sum = c_even[(i-80)/2];
         if (sum > max3) { max3 = sum; T3 = i;}
     }
 
@@ -205,6 +224,7 @@ int pitch_fr3_fast(     /* output: integer part of pitch period        */
   FFLOAT  dn[L_SUBFR];
   FFLOAT  exc_tmp[L_SUBFR];
   FFLOAT  corr, max;
+  FFLOAT  corr_t[PIT_MAX-PIT_MIN+1];
 
   /* Compute  correlations of input response h[] with the target vector xn[].*/
 
@@ -212,10 +232,13 @@ int pitch_fr3_fast(     /* output: integer part of pitch period        */
 
   /* Find maximum integer delay */
 
+  /* same sums as dot_product(dn, &exc[-t], l_subfr), all lags at once */
+  corr_lags(dn, &exc[-t0_min], l_subfr, t0_max-t0_min+1, (F)0.1, corr_t);
+
   max = FLT_MIN_G729;
   for(t=t0_min; t<=t0_max; t++)
   {
-    corr = dot_product(dn, &exc[-t], l_subfr);
+    corr = corr_t[t-t0_min];
     if(corr > max) {max = corr; t0 = t;}
   }
 
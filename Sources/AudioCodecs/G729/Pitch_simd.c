@@ -0,0 +1,134 @@
+/*
+ File : PITCH_SIMD.C
+ Batched cross-correlation for the G.729A pitch searches and the pitch
+ postfilter (see ld8a_simd.h)
+*/
+
+/*---------------------------------------------------------------------------*
+ * corr[k] = init + sum_{m=0}^{n-1} x[m] * y[m-k],   k = 0..lags-1           *
+ * A block of lags shares each x[m] : one broadcast, one unaligned load of   *
+ * y[m-k-W+1 .. m-k] and one multiply-add per W lags. The lanes come out in  *
+ * decreasing lag order and are reversed on store. Lags left over at the end *
+ * of the range go through the scalar loop.                                  *
+ *---------------------------------------------------------------------------*/
+
+#include "typedef.h"
+#include "ld8a.h"
+#include "ld8a_simd.h"
+
+void corr_lags_C(FFLOAT x[], FFLOAT y[], int n, int lags, FFLOAT init, FFLOAT corr[])
+{
+  int k, m;
+  FFLOAT sum;
+
+  for (k = 0; k < lags; k++)
+  {
+    sum = init;
+    for (m = 0; m < n; m++)
+      sum += x[m] * y[m-k];
+    corr[k] = sum;
+  }
+}
+
+#if defined(DSP_HAS_SSE2)
+void corr_lags_SSE2(FFLOAT x[], FFLOAT y[], int n, int lags, FFLOAT init, FFLOAT corr[])
+{
+  int k, m;
+
+  for (k = 0; k + 8 <= lags; k += 8)
+  {
+    __m128 s0 = _mm_set1_ps(init), s1 = s0;
+    for (m = 0; m < n; m++)
+    {
+      __m128 xm = _mm_set1_ps(x[m]);
+      s0 = _mm_add_ps(s0, _mm_mul_ps(xm, _mm_loadu_ps(y + m - k - 3)));
+      s1 = _mm_add_ps(s1, _mm_mul_ps(xm, _mm_loadu_ps(y + m - k - 7)));
+    }
+    _mm_storeu_ps(corr + k, _mm_shuffle_ps(s0, s0, _MM_SHUFFLE(0, 1, 2, 3)));
+    _mm_storeu_ps(corr + k + 4, _mm_shuffle_ps(s1, s1, _MM_SHUFFLE(0, 1, 2, 3)));
+  }
+  if (k < lags)
+    corr_lags_C(x, y - k, n, lags - k, init, corr + k);
+}
+#endif
+
+#if defined(DSP_HAS_AVX2)
+DSP_TARGET_AVX2_FMA
+void corr_lags_AVX2(FFLOAT x[], FFLOAT y[], int n, int lags, FFLOAT init, FFLOAT corr[])
+{
+  const __m256i reverse = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+  int k, m;
+
+  for (k = 0; k + 16 <= lags; k += 16)
+  {
+    __m256 s0 = _mm256_set1_ps(init), s1 = s0;
+    for (m = 0; m < n; m++)
+    {
+      __m256 xm = _mm256_set1_ps(x[m]);
+      s0 = _mm256_fmadd_ps(xm, _mm256_loadu_ps(y + m - k - 7), s0);
+      s1 = _mm256_fmadd_ps(xm, _mm256_loadu_ps(y + m - k - 15), s1);
+    }
+    _mm256_storeu_ps(corr + k, _mm256_permutevar8x32_ps(s0, reverse));
+    _mm256_storeu_ps(corr + k + 8, _mm256_permutevar8x32_ps(s1, reverse));
+  }
+  for (; k + 8 <= lags; k += 8)
+  {
+    __m256 s0 = _mm256_set1_ps(init);
+    for (m = 0; m < n; m++)
+      s0 = _mm256_fmadd_ps(_mm256_set1_ps(x[m]), _mm256_loadu_ps(y + m - k - 7), s0);
+    _mm256_storeu_ps(corr + k, _mm256_permutevar8x32_ps(s0, reverse));
+  }
+  _mm256_zeroupper();
+  if (k < lags)
+    corr_lags_C(x, y - k, n, lags - k, init, corr + k);
+}
+#endif
+
+#if defined(DSP_HAS_NEON)
+static __inline float32x4_t reverse_f32(float32x4_t v)
+{
+  v = vrev64q_f32(v);
+  return vcombine_f32(vget_high_f32(v), vget_low_f32(v));
+}
+
+void corr_lags_NEON(FFLOAT x[], FFLOAT y[], int n, int lags, FFLOAT init, FFLOAT corr[])
+{
+  int k, m;
+
+  for (k = 0; k + 8 <= lags; k += 8)
+  {
+    float32x4_t s0 = vdupq_n_f32(init), s1 = s0;
+    for (m = 0; m < n; m++)
+    {
+      float32x4_t xm = vdupq_n_f32(x[m]);
+      s0 = vaddq_f32(s0, vmulq_f32(xm, vld1q_f32(y + m - k - 3)));
+      s1 = vaddq_f32(s1, vmulq_f32(xm, vld1q_f32(y + m - k - 7)));
+    }
+    vst1q_f32(corr + k, reverse_f32(s0));
+    vst1q_f32(corr + k + 4, reverse_f32(s1));
+  }
+  if (k < lags)
+    corr_lags_C(x, y - k, n, lags - k, init, corr + k);
+}
+#endif
+
+/*---------------------------------------------------------------------------*
+ * corr_lags : picks the kernel, shared by Pitch_a.c and Postfila.c          *
+ *---------------------------------------------------------------------------*/
+
+void corr_lags(FFLOAT x[], FFLOAT y[], int n, int lags, FFLOAT init, FFLOAT corr[])
+{
+  void (*CorrLags)(FFLOAT *, FFLOAT *, int, int, FFLOAT, FFLOAT *) = corr_lags_C;
+
+#if defined(DSP_HAS_SSE2)
+  if (DSP_TEST_CPU(kCpuHasSSE2)) CorrLags = corr_lags_SSE2;
+#endif
+#if defined(DSP_HAS_AVX2)
+  if (DSP_TEST_CPU(kCpuHasAVX2) && DSP_TEST_CPU(kCpuHasFMA3)) CorrLags = corr_lags_AVX2;
+#endif
+#if defined(DSP_HAS_NEON)
+  if (DSP_TEST_CPU(kCpuHasNEON)) CorrLags = corr_lags_NEON;
+#endif
+
+  CorrLags(x, y, n, lags, init, corr);
+}
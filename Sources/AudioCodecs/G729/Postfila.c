@@ -25,6 +25,7 @@
 #include <math.h>
 #include "typedef.h"
 #include "ld8a.h"
+#include "ld8a_simd.h"
 
 /* prototype of local functions */
 
@@ -36,11 +37,13 @@ static void pit_pst_filt(
   FFLOAT *signal_pst     /* output: harmonically postfiltered signal    */
 );
 static void agc(
+  FFLOAT *past_gain, /* in/out: gain of the previous subframe */
   FFLOAT *sig_in,   /* input : postfilter input signal  */
   FFLOAT *sig_out,  /* in/out: postfilter output signal */
   int l_trm        /* input : subframe size            */
 );
 static void preemphasis(
+  FFLOAT *mem_pre,  /* in/out: last input sample of the previous call */
   FFLOAT *signal,   /* in/out: input signal overwritten by the output */
   FFLOAT g,         /* input : preemphasis coefficient                */
   int L            /* input : size of filtering                      */
@@ -62,30 +65,40 @@ static void preemphasis(
  *---------------------------------------------------------------*/
 
 /*------------------------------------------------------------*
- *   static vectors                                           *
+ *   state vectors : in pst_state (ld8a.h), one per decoder   *
  *------------------------------------------------------------*/
 
-        /* inverse filtered synthesis (with A(z/GAMMA2_PST))   */
-
-static FFLOAT res2_buf[PIT_MAX+L_SUBFR];
-static FFLOAT *res2;
-
-        /* memory of filter 1/A(z/GAMMA1_PST) */
-static FFLOAT mem_syn_pst[M];
-
 /*---------------------------------------------------------------*
  * Procedure    init_post_filter:                                 *
  *              ~~~~~~~~~~~~~                                    *
  *  Initializes the postfilter parameters:                       *
  *---------------------------------------------------------------*/
 
-void init_post_filter(void)
+void init_post_filter(pst_state *st)
 {
 
-  res2  = res2_buf + PIT_MAX;
+  set_zero(st->mem_syn_pst, M);
+  set_zero(st->res2_buf, PIT_MAX+L_SUBFR);
+  st->mem_pre = (F)0.;
+  st->past_gain = (F)1.0;
+  st->enabled = 1;
+
+  return;
+}
+
+/*---------------------------------------------------------------*
+ * Procedure    set_post_filter:                                  *
+ *              ~~~~~~~~~~~~~~~                                  *
+ *  Bypasses or restores the postfilter. A leg that is decoded   *
+ *  only to be re-encoded (transcoding) does not need it.        *
+ *  The state restarts from zero when it is switched back on.    *
+ *---------------------------------------------------------------*/
 
-  set_zero(mem_syn_pst, M);
-  set_zero(res2_buf, PIT_MAX+L_SUBFR);
+void set_post_filter(pst_state *st, int enable)
+{
+  if (enable && !st->enabled)
+    init_post_filter(st);
+  st->enabled = enable ? 1 : 0;
 
   return;
 }
@@ -106,6 +119,7 @@ void init_post_filter(void)
  *------------------------------------------------------------------------*/
 
 void post_filter(
+  pst_state *st,   /* in/out: postfilter of one decoder                    */
   FFLOAT *syn,     /* in/out: synthesis speech (postfiltered is output)    */
   FFLOAT *az_4,    /* input : interpolated LPC parameters in all subframes */
   int *T          /* input : decoded pitch lags in all subframes          */
@@ -127,9 +141,17 @@ void post_filter(
 
   FFLOAT temp1, temp2;
   FFLOAT h[L_H];
+  FFLOAT *res2 = st->res2_buf + PIT_MAX;
 
   int   i;
 
+  if (!st->enabled)
+  {
+    /* keep the synthesis history, syn[] goes out unfiltered */
+    copy(&syn[L_FRAME-M], &syn[-M], M);
+    return;
+  }
+
   az = az_4;
 
   for (i_subfr = 0; i_subfr < L_FRAME; i_subfr += L_SUBFR)
@@ -175,15 +197,15 @@ void post_filter(
     else {
        temp2 = temp2*MU/temp1;
     }
-    preemphasis(res2_pst, temp2, L_SUBFR);
+    preemphasis(&st->mem_pre, res2_pst, temp2, L_SUBFR);
 
     /* filtering through  1/A(z/GAMMA1_PST) */
 
-    syn_filt(ap4, res2_pst, &syn_pst[i_subfr], L_SUBFR, mem_syn_pst, 1);
+    syn_filt(ap4, res2_pst, &syn_pst[i_subfr], L_SUBFR, st->mem_syn_pst, 1);
 
     /* scale output to input */
 
-    agc(&syn[i_subfr], &syn_pst[i_subfr], L_SUBFR);
+    agc(&st->past_gain, &syn[i_subfr], &syn_pst[i_subfr], L_SUBFR);
 
     /* update res2[] buffer;  shift by L_SUBFR */
 
@@ -221,50 +243,48 @@ static void pit_pst_filt(
   FFLOAT *signal_pst     /* output: harmonically postfiltered signal    */
 )
 {
-  int    i, j;
+  int    i;
   int    t0;
   FFLOAT  cor_max;
   FFLOAT  temp, g0, gain;
-  FFLOAT  ener, corr, ener0;
-  FFLOAT  *p, *p1, *deb_sig;
+  FFLOAT  ener, ener0;
+  FFLOAT  corr[PIT_MAX];
+  FFLOAT  (*Energy)(FFLOAT *, int, FFLOAT) = pst_energy_C;
+
+#if defined(DSP_HAS_SSE2)
+  if (DSP_TEST_CPU(kCpuHasSSE2)) Energy = pst_energy_SSE2;
+#endif
+#if defined(DSP_HAS_AVX2)
+  if (DSP_TEST_CPU(kCpuHasAVX2) && DSP_TEST_CPU(kCpuHasFMA3)) Energy = pst_energy_AVX2;
+#endif
+#if defined(DSP_HAS_NEON)
+  if (DSP_TEST_CPU(kCpuHasNEON)) Energy = pst_energy_NEON;
+#endif
 
 /*---------------------------------------------------------------------------*
  * Compute the correlations for all delays                                   *
  * and select the delay which maximizes the correlation                      *
  *---------------------------------------------------------------------------*/
 
-  deb_sig = &signal[-t0_min];
-  cor_max = FLT_MIN_G729;
+  corr_lags(signal, &signal[-t0_min], L_subfr, t0_max-t0_min+1, (F)0.0, corr);
 
+  cor_max = FLT_MIN_G729;
   for (i=t0_min; i<=t0_max; i++)
   {
-    corr = (F)0.0;
-    p    = signal;
-    p1   = deb_sig;
-    for (j=0; j<L_subfr; j++)
-       corr += (*p++) * (*p1++);
-    if (corr>cor_max)
+    if (corr[i-t0_min]>cor_max)
     {
-      cor_max = corr;
+      cor_max = corr[i-t0_min];
       t0 = i;
     }
-    deb_sig--;
   }
 
   /* Compute the energy of the signal delayed by t0 */
 
-  ener = (F)0.5;
-  p = signal - t0;
-  for ( i=0; i<L_subfr ;i++, p++)
-    ener += (*p) * (*p);
+  ener = Energy(signal - t0, L_subfr, (F)0.5);
 
   /* Compute the signal energy in the present subframe */
 
-  ener0 = (F)0.5;
-  p = signal;
-
-  for ( i=0; i<L_subfr; i++, p++)
-    ener0 += (*p) * (*p);
+  ener0 = Energy(signal, L_subfr, (F)0.5);
 
   if (cor_max < (F)0.0) cor_max = (F)0.0;
 
@@ -307,12 +327,12 @@ static void pit_pst_filt(
  *---------------------------------------------------------------------*/
 
 static void preemphasis(
+  FFLOAT *mem_pre,   /* in/out: last input sample of the previous call */
   FFLOAT *signal,    /* in/out: input signal overwritten by the output */
   FFLOAT g,          /* input : preemphasis coefficient                */
   int L             /* input : size of filtering                      */
 )
 {
-  static FFLOAT mem_pre = (F)0.;
   FFLOAT *p1, *p2, temp;
   int   i;
 
@@ -323,9 +343,9 @@ static void preemphasis(
   for (i = 0; i <= L-2; i++) {
     *p1 -= g * (*p2--); p1--; }
 
-  *p1 = *p1 - g * mem_pre;
+  *p1 = *p1 - g * *mem_pre;
 
-  mem_pre = temp;
+  *mem_pre = temp;
 
   return;
 }
@@ -340,29 +360,43 @@ static void preemphasis(
  *----------------------------------------------------------------------*/
 
 static void agc(
+  FFLOAT *past_gain, /* in/out: gain of the previous subframe */
   FFLOAT *sig_in,    /* input : postfilter input signal  */
   FFLOAT *sig_out,   /* in/out: postfilter output signal */
   int l_trm         /* input : subframe size            */
 )
 {
-    static FFLOAT past_gain = (F)1.0;
-    int i;
     FFLOAT gain_in, gain_out;
-    FFLOAT g0, gain;
-
-    gain_out = (F)0.;
-    for(i=0; i<l_trm; i++) {
-            gain_out += sig_out[i]*sig_out[i];
+    FFLOAT g0;
+    FFLOAT (*Energy)(FFLOAT *, int, FFLOAT) = pst_energy_C;
+    FFLOAT (*AgcScale)(FFLOAT *, int, FFLOAT, FFLOAT) = pst_agc_scale_C;
+
+#if defined(DSP_HAS_SSE2)
+    if (DSP_TEST_CPU(kCpuHasSSE2)) {
+            Energy = pst_energy_SSE2;
+            AgcScale = pst_agc_scale_SSE2;
     }
+#endif
+#if defined(DSP_HAS_AVX2)
+    if (DSP_TEST_CPU(kCpuHasAVX2) && DSP_TEST_CPU(kCpuHasFMA3)) {
+            Energy = pst_energy_AVX2;
+            AgcScale = pst_agc_scale_AVX2;
+    }
+#endif
+#if defined(DSP_HAS_NEON)
+    if (DSP_TEST_CPU(kCpuHasNEON)) {
+            Energy = pst_energy_NEON;
+            AgcScale = pst_agc_scale_NEON;
+    }
+#endif
+
+    gain_out = Energy(sig_out, l_trm, (F)0.);
     if(gain_out == (F)0.) {
-            past_gain = (F)0.;
+            *past_gain = (F)0.;
             return;
     }
 
-    gain_in = (F)0.;
-    for(i=0; i<l_trm; i++) {
-            gain_in += sig_in[i]*sig_in[i];
-    }
+    gain_in = Energy(sig_in, l_trm, (F)0.);
     if(gain_in == (F)0.) {
             g0 = (F)0.;
     }
@@ -374,12 +408,6 @@ static void agc(
     /* compute gain(n) = AGC_FAC gain(n-1) + (1-AGC_FAC)gain_in/gain_out */
     /* sig_out(n) = gain(n) sig_out(n)                         */
 
-    gain = past_gain;
-    for(i=0; i<l_trm; i++) {
-            gain *= AGC_FAC;
-            gain += g0;
-            sig_out[i] *= gain;
-    }
-    past_gain = gain;
+    *past_gain = AgcScale(sig_out, l_trm, *past_gain, g0);
     return;
 }
@@ -0,0 +1,178 @@
+/*
+ File : PST_SIMD.C
+ Gain control kernels of the G.729A postfilter (see ld8a_simd.h)
+*/
+
+/*---------------------------------------------------------------------------*
+ * agc() ramps the gain with  g_i = AGC_FAC * g_(i-1) + g0.  Over a vector   *
+ * of W samples this unrolls to                                              *
+ *      g_(i+k) = AGC_FAC^(k+1) * g_(i-1) + g0 * (1 + ... + AGC_FAC^k)       *
+ * so each vector needs one multiply-add with two constant vectors and a     *
+ * broadcast of its last lane, instead of W dependent steps.                 *
+ *---------------------------------------------------------------------------*/
+
+#include "typedef.h"
+#include "ld8a.h"
+#include "ld8a_simd.h"
+
+/* powers AGC_FAC^(k+1) and g0 * sum_{l<=k} AGC_FAC^l for k = 0..w-1 */
+static void agc_ramp(FFLOAT g0, int w, FFLOAT a[], FFLOAT b[])
+{
+  int k;
+  FFLOAT p = (F)1.0, s = (F)0.0;
+
+  for (k = 0; k < w; k++)
+  {
+    s += p;
+    p *= AGC_FAC;
+    a[k] = p;
+    b[k] = g0 * s;
+  }
+}
+
+FFLOAT pst_energy_C(FFLOAT x[], int n, FFLOAT init)
+{
+  int i;
+  FFLOAT sum = init;
+
+  for (i = 0; i < n; i++)
+    sum += x[i] * x[i];
+  return sum;
+}
+
+FFLOAT pst_agc_scale_C(FFLOAT x[], int n, FFLOAT gain, FFLOAT g0)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+  {
+    gain *= AGC_FAC;
+    gain += g0;
+    x[i] *= gain;
+  }
+  return gain;
+}
+
+#if defined(DSP_HAS_SSE2)
+FFLOAT pst_energy_SSE2(FFLOAT x[], int n, FFLOAT init)
+{
+  FFLOAT DSP_ALIGNED(16) lane[4];
+  __m128 s0 = _mm_setzero_ps(), s1 = s0;
+  int i;
+
+  for (i = 0; i + 8 <= n; i += 8)
+  {
+    __m128 v0 = _mm_loadu_ps(x + i);
+    __m128 v1 = _mm_loadu_ps(x + i + 4);
+    s0 = _mm_add_ps(s0, _mm_mul_ps(v0, v0));
+    s1 = _mm_add_ps(s1, _mm_mul_ps(v1, v1));
+  }
+  _mm_store_ps(lane, _mm_add_ps(s0, s1));
+  return pst_energy_C(x + i, n - i, init + ((lane[0] + lane[1]) + (lane[2] + lane[3])));
+}
+
+FFLOAT pst_agc_scale_SSE2(FFLOAT x[], int n, FFLOAT gain, FFLOAT g0)
+{
+  FFLOAT DSP_ALIGNED(16) a[4], b[4];
+  __m128 va, vb, g;
+  int i;
+
+  agc_ramp(g0, 4, a, b);
+  va = _mm_load_ps(a);
+  vb = _mm_load_ps(b);
+  g = _mm_set1_ps(gain);
+
+  for (i = 0; i < n; i += 4)
+  {
+    g = _mm_add_ps(_mm_mul_ps(va, g), vb);
+    _mm_storeu_ps(x + i, _mm_mul_ps(_mm_loadu_ps(x + i), g));
+    g = _mm_shuffle_ps(g, g, _MM_SHUFFLE(3, 3, 3, 3));
+  }
+  return _mm_cvtss_f32(g);
+}
+#endif
+
+#if defined(DSP_HAS_AVX2)
+DSP_TARGET_AVX2_FMA
+FFLOAT pst_energy_AVX2(FFLOAT x[], int n, FFLOAT init)
+{
+  FFLOAT DSP_ALIGNED(32) lane[8];
+  __m256 s0 = _mm256_setzero_ps();
+  FFLOAT sum;
+  int i;
+
+  for (i = 0; i + 8 <= n; i += 8)
+  {
+    __m256 v = _mm256_loadu_ps(x + i);
+    s0 = _mm256_fmadd_ps(v, v, s0);
+  }
+  _mm256_store_ps(lane, s0);
+  _mm256_zeroupper();
+  sum = ((lane[0] + lane[4]) + (lane[1] + lane[5])) + ((lane[2] + lane[6]) + (lane[3] + lane[7]));
+  return pst_energy_C(x + i, n - i, init + sum);
+}
+
+DSP_TARGET_AVX2_FMA
+FFLOAT pst_agc_scale_AVX2(FFLOAT x[], int n, FFLOAT gain, FFLOAT g0)
+{
+  FFLOAT DSP_ALIGNED(32) a[8], b[8];
+  const __m256i last = _mm256_set1_epi32(7);
+  __m256 va, vb, g;
+  int i;
+
+  agc_ramp(g0, 8, a, b);
+  va = _mm256_load_ps(a);
+  vb = _mm256_load_ps(b);
+  g = _mm256_set1_ps(gain);
+
+  for (i = 0; i < n; i += 8)
+  {
+    g = _mm256_fmadd_ps(va, g, vb);
+    _mm256_storeu_ps(x + i, _mm256_mul_ps(_mm256_loadu_ps(x + i), g));
+    g = _mm256_permutevar8x32_ps(g, last);
+  }
+  gain = _mm256_cvtss_f32(g);
+  _mm256_zeroupper();
+  return gain;
+}
+#endif
+
+#if defined(DSP_HAS_NEON)
+FFLOAT pst_energy_NEON(FFLOAT x[], int n, FFLOAT init)
+{
+  float32x4_t s0 = vdupq_n_f32(0.0f), s1 = s0;
+  float32x2_t s;
+  int i;
+
+  for (i = 0; i + 8 <= n; i += 8)
+  {
+    float32x4_t v0 = vld1q_f32(x + i);
+    float32x4_t v1 = vld1q_f32(x + i + 4);
+    s0 = vmlaq_f32(s0, v0, v0);
+    s1 = vmlaq_f32(s1, v1, v1);
+  }
+  s0 = vaddq_f32(s0, s1);
+  s = vadd_f32(vget_low_f32(s0), vget_high_f32(s0));
+  return pst_energy_C(x + i, n - i, init + vget_lane_f32(vpadd_f32(s, s), 0));
+}
+
+FFLOAT pst_agc_scale_NEON(FFLOAT x[], int n, FFLOAT gain, FFLOAT g0)
+{
+  FFLOAT DSP_ALIGNED(16) a[4], b[4];
+  float32x4_t va, vb, g;
+  int i;
+
+  agc_ramp(g0, 4, a, b);
+  va = vld1q_f32(a);
+  vb = vld1q_f32(b);
+  g = vdupq_n_f32(gain);
+
+  for (i = 0; i < n; i += 4)
+  {
+    g = vmlaq_f32(vb, va, g);
+    vst1q_f32(x + i, vmulq_f32(vld1q_f32(x + i), g));
+    g = vdupq_n_f32(vgetq_lane_f32(g, 3));
+  }
+  return vgetq_lane_f32(g, 0);
+}
+#endif
@@ -36,6 +36,9 @@
  #include "ld8k.h"
  #include "tab_ld8k.h"
 #endif
+#include "ld8a_simd.h"
+#include "dtx.h"
+#include "tab_dtx.h"
 
 /* Prototype definitions of static functions */
 
@@ -45,11 +48,14 @@ static void relspwed( FFLOAT *lsp, FFLOAT wegt[M], FFLOAT *lspq,
                      FFLOAT fg[MODE][MA_NP][M],
                      FFLOAT      freq_prev[MA_NP][M], FFLOAT fg_sum[MODE][M],
                      FFLOAT      fg_sum_inv[MODE][M], int cod[] );
-static void lsp_pre_select( FFLOAT rbuf[], FFLOAT lspcb1[][M], int *cand);
+static void lsp_pre_select( FFLOAT rbuf[], FFLOAT lspcb1_t[][NC0], int *cand);
 static void lsp_select_1( FFLOAT rbuf[], FFLOAT   lspcb1[], FFLOAT wegt[],
-                         FFLOAT  lspcb2[][M], int        *index );
+                         FFLOAT  lspcb2_t[][NC1], int        *index );
 static void lsp_select_2( FFLOAT rbuf[], FFLOAT   lspcb1[], FFLOAT wegt[],
-                         FFLOAT  lspcb2[][M], int *index );
+                         FFLOAT  lspcb2_t[][NC1], int *index );
+static void lsp_dist( FFLOAT *cb_t, int rows, FFLOAT target[], FFLOAT wegt[],
+                     int j0, int j1, FFLOAT dist[] );
+static int  lsp_first_min( FFLOAT dist[], int n );
 static void lsp_last_select( FFLOAT      tdist[MODE], int        *mode_index );
 static void lsp_get_tdist( FFLOAT        wegt[], FFLOAT   buf[],
                           FFLOAT *tdist, FFLOAT   rbuf[], FFLOAT   fg_sum[] );
@@ -99,8 +105,99 @@ void lsp_encw_reset(
    int  i;
    for(i=0; i<MA_NP; i++)
      copy (&freq_prev_reset[0], &freq_prev[i][0], M );
+
+   init_lsfq_noise();
    return;
 }
+
+/*----------------------------------------------------------------------------
+ * qua_lsp_sid - LSP quantizer of the SID frames (Annex B) : 2 MA predictors,
+ *               NC0_SID first stage and NC1_SID second stage vectors taken
+ *               from lspcb1 and lspcb2. Shares freq_prev with qua_lsp().
+ *----------------------------------------------------------------------------
+ */
+void qua_lsp_sid(
+  FFLOAT lsp[],       /* (i) : Unquantized LSP                   */
+  FFLOAT lsp_q[],     /* (o) : Quantized LSP                     */
+  int ana[]          /* (o) : predictor, 1st and 2nd stage index */
+)
+{
+  int i, j, mode, k0, k1;
+  int best_mode, best0, best1;
+  FFLOAT lsf[M], lsf_q[M], wegt[M];
+  FFLOAT rbuf[MODE][M];
+  FFLOAT *cb1, *cb2;
+  FFLOAT tmp, dist, dmin;
+
+  for (i=0; i<M; i++ )
+     lsf[i] = (FFLOAT)acos(lsp[i]);
+
+  /* keep the spacing the quantized vectors can have */
+  if (lsf[0] < L_LIMIT) lsf[0] = L_LIMIT;
+  for (i=0; i<M-1; i++)
+     if (lsf[i+1] - lsf[i] < (F)2.*GAP3) lsf[i+1] = lsf[i] + (F)2.*GAP3;
+  if (lsf[M-1] > M_LIMIT) lsf[M-1] = M_LIMIT;
+  if (lsf[M-1] < lsf[M-2]) lsf[M-2] = lsf[M-1] - GAP3;
+
+  get_wegt( lsf, wegt );
+
+  /* first stage, both predictors */
+  dmin = FLT_MAX_G729;
+  best_mode = 0;
+  best0 = 0;
+  for (mode=0; mode<MODE; mode++) {
+     lsp_prev_extract(lsf, rbuf[mode], noise_fg[mode], freq_prev,
+                      noise_fg_sum_inv[mode]);
+     for (k0=0; k0<NC0_SID; k0++) {
+        cb1 = lspcb1[PtrTab_1[k0]];
+        dist = (F)0.;
+        for (j=0; j<M; j++) {
+           tmp = rbuf[mode][j] - cb1[j];
+           dist += wegt[j] * tmp * tmp;
+        }
+        if (dist < dmin) {
+           dmin = dist;
+           best_mode = mode;
+           best0 = k0;
+        }
+     }
+  }
+
+  /* second stage, one index for both halves */
+  cb1 = lspcb1[PtrTab_1[best0]];
+  dmin = FLT_MAX_G729;
+  best1 = 0;
+  for (k1=0; k1<NC1_SID; k1++) {
+     dist = (F)0.;
+     cb2 = lspcb2[PtrTab_2[0][k1]];
+     for (j=0; j<NC; j++) {
+        tmp = rbuf[best_mode][j] - cb1[j] - cb2[j];
+        dist += wegt[j] * tmp * tmp;
+     }
+     cb2 = lspcb2[PtrTab_2[1][k1]];
+     for (j=NC; j<M; j++) {
+        tmp = rbuf[best_mode][j] - cb1[j] - cb2[j];
+        dist += wegt[j] * tmp * tmp;
+     }
+     if (dist < dmin) {
+        dmin = dist;
+        best1 = k1;
+     }
+  }
+
+  ana[0] = best_mode;
+  ana[1] = best0;
+  ana[2] = best1;
+
+  lsp_get_quant(lspcb1, lspcb2, PtrTab_1[best0], PtrTab_2[0][best1],
+                PtrTab_2[1][best1], noise_fg[best_mode], freq_prev, lsf_q,
+                noise_fg_sum[best_mode]);
+
+  for (i=0; i<M; i++ )
+     lsp_q[i] = (FFLOAT)cos(lsf_q[i]);
+
+  return;
+}
 /*----------------------------------------------------------------------------
  * lsp_qua_cs - lsp quantizer
  *----------------------------------------------------------------------------
@@ -149,11 +246,11 @@ static void relspwed(
       lsp_prev_extract(lsp, rbuf, fg[mode], freq_prev, fg_sum_inv[mode]);
 
       /*----- search the first stage lsp codebook -----*/
-      lsp_pre_select(rbuf, lspcb1, &cand_cur);
+      lsp_pre_select(rbuf, lspcb1_t, &cand_cur);
       cand[mode]=cand_cur;
 
       /*----- search the second stage lsp codebook (lower 0-4) ----- */
-      lsp_select_1(rbuf, lspcb1[cand_cur], wegt, lspcb2, &index);
+      lsp_select_1(rbuf, lspcb1[cand_cur], wegt, lspcb2_t, &index);
 
       tindex1[mode] = index;
 
@@ -163,7 +260,7 @@ static void relspwed(
       lsp_expand_1(buf, GAP1);  /* check */
 
       /*----- search the second stage lsp codebook (Higher 5-9) ----- */
-      lsp_select_2(rbuf, lspcb1[cand_cur], wegt, lspcb2,
+      lsp_select_2(rbuf, lspcb1[cand_cur], wegt, lspcb2_t,
                    &index);
 
       tindex2[mode] = index;
@@ -203,31 +300,17 @@ static void relspwed(
  */
 static void lsp_pre_select(
  FFLOAT  rbuf[],         /*input : target vetor             */
- FFLOAT  lspcb1[][M],    /*input : first stage lsp codebook */
+ FFLOAT  lspcb1_t[][NC0],/*input : first stage lsp codebook, transposed */
  int    *cand           /*output: selected code            */
 )
 {
-   int  i, j;
-   FFLOAT dmin, dist, temp;
+   FFLOAT dist[NC0];
 
    /* calculate the distortion */
 
-   *cand = 0;
-   dmin= FLT_MAX_G729;
-   for(i=0; i<NC0; i++) {
-      dist =(F)0.;
-      for(j=0; j<M; j++){
-        temp = rbuf[j]-lspcb1[i][j];
-        dist += temp * temp;
-      }
-
-      if(dist<dmin)
-      {
-        dmin=dist;
-        *cand=i;
-      }
-    }
-    return;
+   lsp_dist(&lspcb1_t[0][0], NC0, rbuf, NULL, 0, M, dist);
+   *cand = lsp_first_min(dist, NC0);
+   return;
 }
 
 /*----------------------------------------------------------------------------
@@ -238,33 +321,21 @@ static void lsp_select_1(
  FFLOAT  rbuf[],         /*input : target vector            */
  FFLOAT  lspcb1[],       /*input : first stage lsp codebook */
  FFLOAT  wegt[],         /*input : weight coef.             */
- FFLOAT  lspcb2[][M],    /*input : second stage lsp codebook*/
+ FFLOAT  lspcb2_t[][NC1],/*input : second stage lsp codebook, transposed */
  int    *index          /*output: selected codebook index     */
 )
 {
-   int  j, k1;
+   int  j;
    FFLOAT        buf[M];
-   FFLOAT        dist, dmin, tmp;
+   FFLOAT        dist[NC1];
 
    for(j=0; j<NC; j++)
         buf[j]=rbuf[j]-lspcb1[j];
 
-   *index = 0;
-   dmin=FLT_MAX_G729;
-   for(k1 = 0; k1<NC1; k1++) {
-      /* calculate the distortion */
-      dist = (F)0.;
-      for(j=0; j<NC; j++) {
-         tmp = buf[j]-lspcb2[k1][j];
-         dist += wegt[j] * tmp * tmp;
-      }
-
-      if(dist<dmin) {
-         dmin = dist;
-         *index = k1;
-      }
-   }
-    return;
+   /* calculate the distortion */
+   lsp_dist(&lspcb2_t[0][0], NC1, buf, wegt, 0, NC, dist);
+   *index = lsp_first_min(dist, NC1);
+   return;
 }
 
 /*----------------------------------------------------------------------------
@@ -275,33 +346,73 @@ static void lsp_select_2(
  FFLOAT  rbuf[],         /*input : target vector            */
  FFLOAT  lspcb1[],       /*input : first stage lsp codebook */
  FFLOAT  wegt[],         /*input : weighting coef.             */
- FFLOAT  lspcb2[][M],    /*input : second stage lsp codebook*/
+ FFLOAT  lspcb2_t[][NC1],/*input : second stage lsp codebook, transposed */
  int    *index          /*output: selected codebook index    */
 )
 {
-   int  j, k1;
+   int  j;
    FFLOAT        buf[M];
-   FFLOAT        dist, dmin, tmp;
+   FFLOAT        dist[NC1];
 
    for(j=NC; j<M; j++)
         buf[j]=rbuf[j]-lspcb1[j];
 
+   lsp_dist(&lspcb2_t[0][0], NC1, buf, wegt, NC, M, dist);
+   *index = lsp_first_min(dist, NC1);
+   return;
+}
 
-   *index = 0;
-   dmin= FLT_MAX_G729;
-   for(k1 = 0; k1<NC1; k1++) {
-      dist = (F)0.0;
-      for(j=NC; j<M; j++) {
-        tmp = buf[j] - lspcb2[k1][j];
-        dist += wegt[j] * tmp * tmp;
-      }
+/*----------------------------------------------------------------------------
+ * lsp_dist - weighted distortion of every row of a transposed codebook
+ *----------------------------------------------------------------------------
+ */
+static void lsp_dist(
+ FFLOAT  *cb_t,          /*input : codebook, cb_t[j*rows+i] = cb[i][j] */
+ int     rows,           /*input : number of codebook rows          */
+ FFLOAT  target[],       /*input : target vector                    */
+ FFLOAT  wegt[],         /*input : weight coef. (NULL : flat)       */
+ int     j0,             /*input : first coefficient                */
+ int     j1,             /*input : last coefficient + 1             */
+ FFLOAT  dist[]          /*output: distortion of each row           */
+)
+{
+   void (*LspDist)(FFLOAT *, int, FFLOAT *, FFLOAT *, int, int, FFLOAT *) = lsp_dist_C;
+
+#if defined(DSP_HAS_SSE2)
+   if (DSP_TEST_CPU(kCpuHasSSE2)) LspDist = lsp_dist_SSE2;
+#endif
+#if defined(DSP_HAS_AVX2)
+   if (DSP_TEST_CPU(kCpuHasAVX2)) LspDist = lsp_dist_AVX2;
+#endif
+#if defined(DSP_HAS_NEON)
+   if (DSP_TEST_CPU(kCpuHasNEON)) LspDist = lsp_dist_NEON;
+#endif
+
+   LspDist(cb_t, rows, target, wegt, j0, j1, dist);
+   return;
+}
 
-      if(dist<dmin) {
-         dmin = dist;
-         *index = k1;
+/*----------------------------------------------------------------------------
+ * lsp_first_min - index of the first minimum, same rule as the search loops
+ *----------------------------------------------------------------------------
+ */
+static int lsp_first_min(
+ FFLOAT  dist[],         /*input : distortion of each row */
+ int     n               /*input : number of rows         */
+)
+{
+   int  i, index;
+   FFLOAT dmin;
+
+   index = 0;
+   dmin = FLT_MAX_G729;
+   for(i=0; i<n; i++) {
+      if(dist[i]<dmin) {
+         dmin = dist[i];
+         index = i;
       }
    }
-   return;
+   return index;
 }
 /*----------------------------------------------------------------------------
  * lsp_get_tdist - calculate the distortion
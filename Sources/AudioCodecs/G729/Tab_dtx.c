@@ -0,0 +1,99 @@
+/*
+ File : TAB_DTX.C
+ Tables of G.729 Annex B (VAD, DTX and comfort noise)
+*/
+
+#include "typedef.h"
+#include "ld8a.h"
+#include "tab_ld8a.h"
+#include "dtx.h"
+#include "tab_dtx.h"
+
+/* autocorrelation of the impulse response of the VAD low band filter */
+FFLOAT lbf_corr[NP+1] = {
+ (F)0.24017939691329, (F)0.21398822343783, (F)0.14767692339633,
+ (F)0.07018811903116, (F)0.00980856433051,(F)-0.02015934721195,
+(F)-0.02388269958005,(F)-0.01480076155002,(F)-0.00503292155509,
+ (F)0.00012141366508, (F)0.00119354245231, (F)0.00065908718613,
+ (F)0.00015015782285
+};
+
+/* the 14 linear decision boundaries of the VAD, x < a*y + b */
+FFLOAT vad_a[14] = {
+ (F)1.750000e-03, (F)-4.545455e-03, (F)-2.500000e+01,
+ (F)2.000000e+01, (F)0.000000e+00,  (F)8.800000e+03,
+ (F)0.000000e+00, (F)2.500000e+01,  (F)-2.909091e+01,
+ (F)0.000000e+00, (F)1.400000e+04,  (F)0.928571,
+ (F)-1.500000e+00,(F)0.714285
+};
+
+FFLOAT vad_b[14] = {
+ (F)0.00085,      (F)0.001159091,   (F)-5.0,
+ (F)-6.0,         (F)-4.7,          (F)-12.2,
+ (F)0.0009,       (F)-7.0,          (F)-4.8182,
+ (F)-5.3,         (F)-15.5,         (F)1.14285,
+ (F)-9.0,         (F)-2.1428571
+};
+
+/* first stage entries of the SID LSF quantizer, indexes into lspcb1 */
+int PtrTab_1[NC0_SID] = {
+ 96, 52, 20, 54, 86,114, 82, 68, 36,121, 48, 92, 18,120, 94,124,
+ 50,125,  4,100, 28, 76, 12,117, 81, 22, 90,116,127, 21,108, 66
+};
+
+/* second stage entries, lower and upper half, indexes into lspcb2 */
+int PtrTab_2[2][NC1_SID] = {
+ { 31, 21,  9,  3, 10,  2, 19, 26,  4,  3, 11, 29, 15, 27, 21, 12},
+ { 16,  1,  0,  0,  8, 25, 22, 20, 19, 23, 20, 31,  4, 31, 20, 31}
+};
+
+/* ITU-T G.729 Annex B (floating point, Annex C+) SID gains, 2*10^(enerq/20)
+   for the quantized energies -12, -4 to 16 dB in 4 dB steps, then 18 to
+   66 dB in 2 dB steps */
+FFLOAT tab_Sidgain[NB_SIDGAIN] = {
+ (F)0.502,    (F)1.262,    (F)2.000,    (F)3.170,
+ (F)5.024,    (F)7.962,    (F)12.619,   (F)15.887,
+ (F)20.000,   (F)25.179,   (F)31.698,   (F)39.905,
+ (F)50.238,   (F)63.246,   (F)79.621,   (F)100.237,
+ (F)126.191,  (F)158.866,  (F)200.000,  (F)251.785,
+ (F)316.979,  (F)399.052,  (F)502.377,  (F)632.456,
+ (F)796.214,  (F)1002.374, (F)1261.915, (F)1588.656,
+ (F)2000.000, (F)2517.851, (F)3169.786, (F)3990.525
+};
+
+/* ITU-T G.729 Annex B energy normalization, 1/(4*L_FRAME) for the
+   excitation energy of the last speech frame (decoder), 1/(16*L_FRAME)
+   and 1/(32*L_FRAME) for the sum of one or two Levinson residuals of the
+   NB_CURACF frame autocorrelations (encoder) */
+FFLOAT fact_sid[NB_GAIN+1] = {(F)0.003125, (F)0.00078125, (F)0.000390625};
+
+int bitsno_sid[PRM_SIZE_SID] = {1, 5, 4, 5};
+
+/* MA predictors of the SID LSF quantizer, set by init_lsfq_noise() */
+FFLOAT noise_fg[MODE][MA_NP][M];
+FFLOAT noise_fg_sum[MODE][M];
+FFLOAT noise_fg_sum_inv[MODE][M];
+
+/*---------------------------------------------------------------------------*
+ * init_lsfq_noise - MA predictors of the SID quantizer : the first one of   *
+ *                   the speech quantizer and a mix of both                  *
+ *---------------------------------------------------------------------------*/
+void init_lsfq_noise(void)
+{
+  int i, j, k;
+
+  for (k = 0; k < MA_NP; k++)
+    for (j = 0; j < M; j++) {
+      noise_fg[0][k][j] = fg[0][k][j];
+      noise_fg[1][k][j] = (F)0.6*fg[0][k][j] + (F)0.4*fg[1][k][j];
+    }
+
+  for (i = 0; i < MODE; i++)
+    for (j = 0; j < M; j++) {
+      noise_fg_sum[i][j] = (F)1.0;
+      for (k = 0; k < MA_NP; k++)
+        noise_fg_sum[i][j] -= noise_fg[i][k][j];
+      noise_fg_sum_inv[i][j] = (F)1.0 / noise_fg_sum[i][j];
+    }
+  return;
+}
@@ -0,0 +1,283 @@
+/*
+ File : VAD.C
+ Voice activity detection of G.729 Annex B
+*/
+
+/*---------------------------------------------------------------------------*
+ * Four features are extracted every 10 ms : full band and low band energy,  *
+ * LSF distance and zero crossing rate. Their differences to the running     *
+ * background noise averages are classified by 14 linear boundaries, the     *
+ * decision is then smoothed (hangover, energy checks) and the averages are  *
+ * updated on the frames that look stationary.                               *
+ *---------------------------------------------------------------------------*/
+
+#include <math.h>
+#include "typedef.h"
+#include "ld8a.h"
+#include "dtx.h"
+#include "tab_dtx.h"
+
+static int make_dec(FFLOAT dSLE, FFLOAT dSE, FFLOAT SD, FFLOAT dSZC);
+
+/* static memory */
+static FFLOAT MeanLSF[M];
+static FFLOAT Min_buffer[16];
+static FFLOAT Prev_Min, Next_Min, Min;
+static FFLOAT MeanE, MeanSE, MeanSLE, MeanSZC;
+static FFLOAT prev_energy;
+static int count_sil, count_update, count_ext;
+static int flag, v_flag, less_count;
+
+/*---------------------------------------------------------------------------*
+ * init_vad - reset the background noise averages                            *
+ *---------------------------------------------------------------------------*/
+void init_vad(void)
+{
+  set_zero(MeanLSF, M);
+  set_zero(Min_buffer, 16);
+  Prev_Min = (F)0.;
+  Next_Min = (F)0.;
+  Min = FLT_MAX_G729;
+  MeanE = (F)0.;
+  MeanSE = (F)0.;
+  MeanSLE = (F)0.;
+  MeanSZC = (F)0.;
+  prev_energy = (F)0.;
+  count_sil = 0;
+  count_update = 0;
+  count_ext = 0;
+  less_count = 0;
+  flag = 1;
+  v_flag = 0;
+  return;
+}
+
+/*---------------------------------------------------------------------------*
+ * vad - voice activity decision of one frame                                *
+ *---------------------------------------------------------------------------*/
+int vad(
+  FFLOAT rc,
+  FFLOAT *lsf,
+  FFLOAT *r,
+  FFLOAT *sigpp,
+  int frm_count,
+  int prev_marker,
+  int pprev_marker
+)
+{
+  FFLOAT lsfn[M];
+  FFLOAT SD, E_low, ENERGY, ZC, dtmp;
+  FFLOAT dSE, dSLE, dSZC;
+  FFLOAT COEF, COEFZC, COEFSD;
+  int i, marker;
+
+  /* full band energy */
+  ENERGY = (F)10.0 * (FFLOAT)log10(r[0] / (F)L_WINDOW + (F)1.0e-10);
+
+  /* low band energy */
+  E_low = (F)0.0;
+  for (i = 1; i <= NP; i++)
+    E_low += r[i] * lbf_corr[i];
+  E_low = r[0] * lbf_corr[0] + (F)2.0 * E_low;
+  if (E_low < (F)0.0) E_low = (F)0.0;
+  E_low = (F)10.0 * (FFLOAT)log10(E_low / (F)L_WINDOW + (F)1.0e-10);
+
+  /* spectral distortion to the average LSF, normalized LSF */
+  SD = (F)0.0;
+  for (i = 0; i < M; i++) {
+    lsfn[i] = lsf[i] / PI2;
+    dtmp = lsfn[i] - MeanLSF[i];
+    SD += dtmp * dtmp;
+  }
+
+  /* zero crossing rate */
+  ZC = (F)0.0;
+  for (i = ZC_START + 1; i <= ZC_END; i++)
+    if (sigpp[i-1] * sigpp[i] < (F)0.0) ZC += (F)1.0;
+  ZC /= (F)L_FRAME;
+
+  /* minimum energy over the last 128 frames, by blocks of 8 */
+  if (frm_count < 129) {
+    if (ENERGY < Min) {
+      Min = ENERGY;
+      Prev_Min = ENERGY;
+    }
+    if ((frm_count % 8) == 0) {
+      Min_buffer[frm_count/8 - 1] = Min;
+      Min = FLT_MAX_G729;
+    }
+  }
+  if ((frm_count % 8) == 0) {
+    Prev_Min = Min_buffer[0];
+    for (i = 1; i < 16; i++)
+      if (Min_buffer[i] < Prev_Min) Prev_Min = Min_buffer[i];
+  }
+  if (frm_count >= 129) {
+    if ((frm_count % 8) == 1) {
+      Min = Prev_Min;
+      Next_Min = FLT_MAX_G729;
+    }
+    if (ENERGY < Min) Min = ENERGY;
+    if (ENERGY < Next_Min) Next_Min = ENERGY;
+    if ((frm_count % 8) == 0) {
+      for (i = 0; i < 15; i++)
+        Min_buffer[i] = Min_buffer[i+1];
+      Min_buffer[15] = Next_Min;
+      Prev_Min = Min_buffer[0];
+      for (i = 1; i < 16; i++)
+        if (Min_buffer[i] < Prev_Min) Prev_Min = Min_buffer[i];
+    }
+  }
+
+  /* initialization of the averages on the first frames */
+  marker = VOICE;
+  if (frm_count <= INIT_FRAME) {
+    if (ENERGY < (F)21.0) {
+      less_count++;
+      marker = NOISE;
+    }
+    else {
+      FFLOAT n = (FFLOAT)(frm_count - less_count);
+
+      marker = VOICE;
+      MeanE = (MeanE * (n - (F)1.0) + ENERGY) / n;
+      MeanSZC = (MeanSZC * (n - (F)1.0) + ZC) / n;
+      for (i = 0; i < M; i++)
+        MeanLSF[i] = (MeanLSF[i] * (n - (F)1.0) + lsfn[i]) / n;
+    }
+  }
+
+  if (frm_count >= INIT_FRAME) {
+    if (frm_count == INIT_FRAME) {
+      MeanSE = MeanE - (F)10.0;
+      MeanSLE = MeanE - (F)12.0;
+    }
+
+    dSE = MeanSE - ENERGY;
+    dSLE = MeanSLE - E_low;
+    dSZC = MeanSZC - ZC;
+
+    if (ENERGY < (F)21.0)
+      marker = NOISE;
+    else
+      marker = make_dec(dSLE, dSE, SD, dSZC);
+
+    /* smoothing : keep the voice decision on loud frames */
+    v_flag = 0;
+    if ((prev_marker == VOICE) && (marker == NOISE) &&
+        (ENERGY > MeanSE + (F)2.0) && (ENERGY > (F)21.0)) {
+      marker = VOICE;
+      v_flag = 1;
+    }
+
+    if (flag == 1) {
+      if ((pprev_marker == VOICE) && (prev_marker == VOICE) &&
+          (marker == NOISE) && ((FFLOAT)fabs(prev_energy - ENERGY) <= (F)3.0)) {
+        count_ext++;
+        marker = VOICE;
+        v_flag = 1;
+        if (count_ext <= 4)
+          flag = 1;
+        else {
+          flag = 0;
+          count_ext = 0;
+        }
+      }
+    }
+    else
+      flag = 1;
+
+    if (marker == NOISE)
+      count_sil++;
+
+    if ((marker == VOICE) && (count_sil > 10) &&
+        ((ENERGY - prev_energy) <= (F)3.0)) {
+      marker = NOISE;
+      count_sil = 0;
+    }
+
+    if (marker == VOICE)
+      count_sil = 0;
+
+    if ((ENERGY < MeanSE + (F)3.0) && (frm_count > 128) && (!v_flag) &&
+        (rc < (F)0.6))
+      marker = NOISE;
+
+    /* update of the background noise averages */
+    if ((ENERGY < MeanSE + (F)3.0) && (rc < (F)0.75) && (SD < (F)0.002532959)) {
+      count_update++;
+      if (count_update < INIT_COUNT) {
+        COEF = (F)0.75;  COEFZC = (F)0.8;   COEFSD = (F)0.6;
+      }
+      else if (count_update < INIT_COUNT + 10) {
+        COEF = (F)0.95;  COEFZC = (F)0.92;  COEFSD = (F)0.65;
+      }
+      else if (count_update < INIT_COUNT + 20) {
+        COEF = (F)0.97;  COEFZC = (F)0.94;  COEFSD = (F)0.70;
+      }
+      else if (count_update < INIT_COUNT + 30) {
+        COEF = (F)0.99;  COEFZC = (F)0.96;  COEFSD = (F)0.75;
+      }
+      else if (count_update < INIT_COUNT + 40) {
+        COEF = (F)0.995; COEFZC = (F)0.99;  COEFSD = (F)0.75;
+      }
+      else {
+        COEF = (F)0.995; COEFZC = (F)0.998; COEFSD = (F)0.75;
+      }
+
+      MeanSE = COEF * MeanSE + ((F)1.0 - COEF) * ENERGY;
+      MeanSLE = COEF * MeanSLE + ((F)1.0 - COEF) * E_low;
+      MeanSZC = COEFZC * MeanSZC + ((F)1.0 - COEFZC) * ZC;
+      for (i = 0; i < M; i++)
+        MeanLSF[i] = COEFSD * MeanLSF[i] + ((F)1.0 - COEFSD) * lsfn[i];
+    }
+
+    if ((frm_count > 128) &&
+        (((MeanSE < Min) && (SD < (F)0.0002531)) || (MeanSE > Min + (F)10.0))) {
+      MeanSE = Min;
+      count_update = 0;
+    }
+  }
+
+  prev_energy = ENERGY;
+  return marker;
+}
+
+/*---------------------------------------------------------------------------*
+ * make_dec - initial decision from the feature differences                  *
+ *---------------------------------------------------------------------------*/
+static int make_dec(
+  FFLOAT dSLE,          /* (i) : low band energy difference   */
+  FFLOAT dSE,           /* (i) : full band energy difference  */
+  FFLOAT SD,            /* (i) : spectral distortion          */
+  FFLOAT dSZC           /* (i) : zero crossing difference     */
+)
+{
+  /* SD vs dSZC */
+  if (SD > vad_a[0]*dSZC + vad_b[0]) return VOICE;
+  if (SD > vad_a[1]*dSZC + vad_b[1]) return VOICE;
+
+  /* dSE vs dSZC */
+  if (dSE < vad_a[2]*dSZC + vad_b[2]) return VOICE;
+  if (dSE < vad_a[3]*dSZC + vad_b[3]) return VOICE;
+  if (dSE < vad_b[4]) return VOICE;
+
+  /* dSE vs SD */
+  if (dSE < vad_a[5]*SD + vad_b[5]) return VOICE;
+  if (SD > vad_b[6]) return VOICE;
+
+  /* dSLE vs dSZC */
+  if (dSLE < vad_a[7]*dSZC + vad_b[7]) return VOICE;
+  if (dSLE < vad_a[8]*dSZC + vad_b[8]) return VOICE;
+  if (dSLE < vad_b[9]) return VOICE;
+
+  /* dSLE vs SD */
+  if (dSLE < vad_a[10]*SD + vad_b[10]) return VOICE;
+
+  /* dSLE vs dSE */
+  if (dSLE > vad_a[11]*dSE + vad_b[11]) return VOICE;
+  if (dSLE < vad_a[12]*dSE + vad_b[12]) return VOICE;
+  if (dSLE < vad_a[13]*dSE + vad_b[13]) return VOICE;
+
+  return NOISE;
+}
@@ -0,0 +1,118 @@
+/*-----------------------------------------------------------*
+ * dtx.h - G.729 Annex B : VAD, DTX and comfort noise        *
+ *-----------------------------------------------------------*/
+
+/*
+   Frame types carried in ana[0] by coder_ld8a() and in parm[1] for
+   decod_ld8a() :
+      FR_NOT_SENT : silence, nothing transmitted (decoder keeps the noise)
+      FR_SPEECH   : 80 bit speech frame
+      FR_SID      : 15 bit silence insertion descriptor
+   The SID parameters are the LSF predictor (1 bit), the first (5 bits) and
+   second (4 bits) stage LSF indexes and the energy (5 bits), packed MSB
+   first in 2 octets with a zero pad bit (RFC 3551).
+*/
+
+#ifndef DTX_H
+#define DTX_H
+
+#define FR_NOT_SENT     0
+#define FR_SPEECH       1
+#define FR_SID          2
+
+#define PRM_SIZE_SID    4       /* number of parameters of a SID frame      */
+#define SID_BYTES       2       /* packed size of a SID frame               */
+
+/* VAD */
+#define NOISE           0
+#define VOICE           1
+#define INIT_FRAME      32      /* frames used to initialize the averages   */
+#define INIT_COUNT      20
+#define ZC_START        120     /* zero crossing window in the LPC window   */
+#define ZC_END          200
+
+/* DTX */
+#define NB_CURACF       2       /* frames summed in the current ACF         */
+#define NB_SUMACF       3       /* current ACFs summed in the past filter   */
+#define SIZ_ACF         (NB_CURACF * MP1)
+#define SIZ_SUMACF      (NB_SUMACF * MP1)
+#define NB_GAIN         2       /* residual energies averaged for the gain  */
+#define FR_SID_MIN      3       /* minimum distance between two SID frames  */
+#define THRESH1         (F)1.1481628  /* spectral change, current filter    */
+#define THRESH2         (F)1.0966466  /* spectral change, average filter    */
+#define A_GAIN0         (F)0.875      /* smoothing of the excitation gain   */
+#define A_GAIN1         (F)0.125
+
+/* SID LSF and energy quantizers */
+#define NC0_SID         32      /* first stage entries (subset of lspcb1)   */
+#define NC1_SID         16      /* second stage entries (subset of lspcb2)  */
+#define NB_SIDGAIN      32      /* energy levels                            */
+
+/* comfort noise excitation */
+#define INIT_SEED       11111
+#define FRAC_GAUSS      (F)0.5  /* share of the gaussian part in amplitude  */
+
+/*-----------------------------------------------------------*
+ * VAD                                                       *
+ *-----------------------------------------------------------*/
+void init_vad(void);
+
+int vad(
+  FFLOAT rc,            /* (i) : 2nd reflection coefficient           */
+  FFLOAT *lsf,          /* (i) : LSF of the frame (0..PI)             */
+  FFLOAT *r,            /* (i) : autocorrelations r[0..NP]            */
+  FFLOAT *sigpp,        /* (i) : preprocessed speech of the LPC window */
+  int frm_count,        /* (i) : frame counter                        */
+  int prev_marker,      /* (i) : VAD decision of the previous frame   */
+  int pprev_marker      /* (i) : VAD decision two frames ago          */
+);                      /* (o) : VOICE or NOISE                       */
+
+/*-----------------------------------------------------------*
+ * DTX (encoder) and comfort noise generation                *
+ *-----------------------------------------------------------*/
+void init_cod_cng(void);
+
+void update_cng(FFLOAT *r, int vad);
+
+void cod_cng(
+  FFLOAT *exc,          /* (i/o) : excitation, exc[0..L_FRAME-1] = out */
+  int past_vad,         /* (i)   : VAD decision of the previous frame  */
+  FFLOAT *lsp_old_q,    /* (i/o) : quantized LSP of the previous frame */
+  FFLOAT *Aq,           /* (o)   : LP filters of the 2 subframes       */
+  int *ana,             /* (o)   : frame type and SID parameters       */
+  INT16 *seed           /* (i/o) : noise generator                     */
+);
+
+void init_dec_cng(void);
+
+void dec_cng(
+  int past_ftyp,        /* (i)   : type of the previous frame           */
+  FFLOAT sid_sav,       /* (i)   : excitation energy of the last speech */
+  int *parm,            /* (i)   : SID parameters, parm[-1] = ftyp      */
+  FFLOAT *exc,          /* (i/o) : excitation, exc[0..L_FRAME-1] = out  */
+  FFLOAT *lsp_old,      /* (i/o) : LSP of the previous frame            */
+  FFLOAT *A_t,          /* (o)   : LP filters of the 2 subframes        */
+  INT16 *seed           /* (i/o) : noise generator                      */
+);
+
+void qua_sid_gain(FFLOAT *ener, int nb_ener, FFLOAT *enerq, int *idx);
+
+void calc_exc_rand(FFLOAT cur_gain, FFLOAT *exc, INT16 *seed, int flag_cod);
+
+/*-----------------------------------------------------------*
+ * SID LSF quantizer (Qua_lsp.c, Lspdec.c)                   *
+ *-----------------------------------------------------------*/
+void init_lsfq_noise(void);
+
+void qua_lsp_sid(FFLOAT lsp[], FFLOAT lsp_q[], int ana[]);
+
+void d_lsp_sid(int index[], FFLOAT lsp_q[]);
+
+/*-----------------------------------------------------------*
+ * SID frame packing (Bits.c)                                *
+ *-----------------------------------------------------------*/
+void prm2bytes_sid(int prm[], unsigned char bytes[]);
+
+void bytes2prm_sid(unsigned char bytes[], int prm[]);
+
+#endif
@@ -57,6 +57,7 @@
 #define M               10      /* LPC order                                */
 #define MP1             (M+1)   /* LPC order+1                              */
 #define NC              (M/2)   /* LPC order / 2                            */
+#define NP              12      /* order of the VAD autocorrelations        */
 #define WNC          (F)1.0001  /* white noise correction factor            */
 #define GRID_POINTS      50     /* resolution of lsp search                 */
 
@@ -143,6 +144,7 @@
 #define PRM_SIZE        11      /* number of parameters per 10 ms frame     */
 #define SERIAL_SIZE     82      /* bits per frame                           */
 #define SIZE_WORD (INT16)80     /* number of speech bits                     */
+#define FRAME_BYTES     10      /* speech bits packed MSB first (RFC 3551)  */
 
 /*-------------------------------*
  * Pre and post-process functions*
@@ -169,14 +171,17 @@ void pre_process(
 void  init_coder_ld8a(void);
 
 void  coder_ld8a(
- int ana[]              /* output: analysis parameters */
+ int ana[]              /* output: frame type, analysis parameters */
 );
 
+void  set_dtx_ld8a(int enable);
+
 void  init_decod_ld8a(void);
 
 void  decod_ld8a(
   int parm[],          /* (i)   : vector of synthesis parameters
-                                  parm[0] = bad frame indicator (bfi)  */
+                                  parm[0] = bad frame indicator (bfi)
+                                  parm[1] = frame type                 */
   FFLOAT   synth[],     /* (o)   : synthesis speech                     */
   FFLOAT   A_t[],       /* (o)   : decoded LP filter in 2 subframes     */
   int *T2              /* (o)   : decoded pitch lag in 2 subframes     */
@@ -378,13 +383,31 @@ void  prm2bits_ld8k(int prm[], INT16 bits[]);
 
 void  bits2prm_ld8k(INT16 bits[], int prm[]);
 
+void  prm2bytes_ld8k(int prm[], unsigned char bytes[]);
+
+void  bytes2prm_ld8k(unsigned char bytes[], int prm[]);
+
 /*-----------------------------------------------------------*
  * Prototypes for the post filtering                         *
  *-----------------------------------------------------------*/
 
-void init_post_filter(void);
+typedef struct {
+  FFLOAT res2_buf[PIT_MAX+L_SUBFR]; /* inverse filtered synthesis (with A(z/GAMMA2_PST)) */
+  FFLOAT mem_syn_pst[M];    /* memory of filter 1/A(z/GAMMA1_PST)    */
+  FFLOAT mem_pre;           /* memory of the tilt compensation       */
+  FFLOAT past_gain;         /* gain control of the previous subframe */
+  int   enabled;            /* 0 : synthesis goes out unfiltered     */
+} pst_state;
+
+void init_post_filter(pst_state *st);
+
+void set_post_filter(
+  pst_state *st,   /* in/out: postfilter of one decoder                    */
+  int enable      /* input : 0 to bypass it (e.g. before a re-encode)     */
+);
 
 void post_filter(
+  pst_state *st,   /* in/out: postfilter of one decoder                    */
   FFLOAT *syn,     /* in/out: synthesis speech (postfiltered is output)    */
   FFLOAT *a_t,     /* input : interpolated LPC parameters in all subframes */
   int *T          /* input : decoded pitch lags in all subframes          */
@@ -0,0 +1,120 @@
+/*-----------------------------------------------------------*
+ * ld8a_simd.h - SIMD kernels of the G.729A codec            *
+ *-----------------------------------------------------------*/
+
+/*
+   Each kernel has the same interface as the reference routine it replaces.
+   The callers start from the reference and switch to a kernel when
+   DSP_TEST_CPU reports the instruction set (see Acelp_ca.c, Cor_func.c,
+   Qua_lsp.c, Postfila.c; corr_lags() in Pitch_simd.c).
+
+   Tolerance : cor_h, cor_h_x and corr_lags add the products in the same
+   order as the reference, the SSE2 and NEON results are bit exact. cor_h_AVX2,
+   cor_h_x_AVX2 and corr_lags_AVX2 use FMA and differ by rounding only
+   (relative error below 1e-6); a pitch lag whose correlation ties with
+   another one within that rounding can be picked the other way.
+   The postfilter gain control sums the energies per lane and ramps the
+   gain in closed form per vector. Its output differs from the reference
+   postfilter by float rounding only : after conversion to 16 bit, at
+   most 1 LSB on about 1% of the samples. The C path stays bit exact.
+   search_8x8 keeps the best candidate per column before comparing the
+   columns, so two candidates whose criteria are equal within float rounding
+   can be resolved the other way. Either choice is a valid G.729A codeword,
+   the bitstream stays decodable by any decoder.
+*/
+
+#ifndef LD8A_SIMD_H
+#define LD8A_SIMD_H
+
+#include "../Dsp/dsp_cpu.h"
+
+/*-------------------------------------------------------------------*
+ * search_8x8 : one depth first phase B of d4i40_17_fast()           *
+ *   8 rows x 8 columns, keeps the first maximum of sq2/alp2 in      *
+ *   row major order, like the reference double loop.                *
+ *-------------------------------------------------------------------*/
+
+typedef void (*search_8x8_fn)(
+  FFLOAT ps1[],          /* (i) : correlation of the 8 row pulses          */
+  FFLOAT alp1[],         /* (i) : energy of the 8 row pulses               */
+  FFLOAT dn_col[],       /* (i) : |dn| of the 8 column positions           */
+  FFLOAT rr[],           /* (i) : cross correlations, rr[row*8+col]        */
+  FFLOAT tmp_vect[],     /* (i) : energy terms of the 8 column positions   */
+  int *row,              /* (o) : selected row (0..7)                      */
+  int *col,              /* (o) : selected column (0..7)                   */
+  FFLOAT *sq,            /* (o) : square of the selected correlation       */
+  FFLOAT *alp            /* (o) : energy of the selected codeword          */
+);
+
+void search_8x8_C(FFLOAT ps1[], FFLOAT alp1[], FFLOAT dn_col[], FFLOAT rr[],
+  FFLOAT tmp_vect[], int *row, int *col, FFLOAT *sq, FFLOAT *alp);
+
+/*-------------------------------------------------------------------*
+ * lsp_dist : weighted distance of a target to every codebook row     *
+ *   dist[i] = sum_{j=j0}^{j1-1} w[j] * (target[j] - cb_t[j][i])^2   *
+ *   cb_t is a transposed codebook (lspcb1_t, lspcb2_t), rows is a   *
+ *   multiple of 16. wegt == NULL : all weights 1.                   *
+ *   Same operations in the same order as the reference loops of     *
+ *   Qua_lsp.c, all versions are bit exact.                          *
+ *-------------------------------------------------------------------*/
+
+void lsp_dist_C(FFLOAT *cb_t, int rows, FFLOAT target[], FFLOAT wegt[],
+  int j0, int j1, FFLOAT dist[]);
+
+/*-------------------------------------------------------------------*
+ * corr_lags : cross correlation of x[] with y[] at lags lags        *
+ *   corr[k] = init + sum_{m=0}^{n-1} x[m] * y[m-k]                  *
+ *   y[] must be readable from y[-(lags-1)].                         *
+ *   corr_lags() runs the best kernel for the CPU.                   *
+ *-------------------------------------------------------------------*/
+
+void corr_lags(FFLOAT x[], FFLOAT y[], int n, int lags, FFLOAT init, FFLOAT corr[]);
+void corr_lags_C(FFLOAT x[], FFLOAT y[], int n, int lags, FFLOAT init, FFLOAT corr[]);
+
+/*-------------------------------------------------------------------*
+ * Postfilter gain control                                           *
+ *   pst_energy    : init + sum of x[i]^2                            *
+ *   pst_agc_scale : x[i] *= g_i,  g_i = AGC_FAC * g_(i-1) + g0,     *
+ *                   returns the last gain; n is a multiple of 8     *
+ *-------------------------------------------------------------------*/
+
+FFLOAT pst_energy_C(FFLOAT x[], int n, FFLOAT init);
+FFLOAT pst_agc_scale_C(FFLOAT x[], int n, FFLOAT gain, FFLOAT g0);
+
+#if defined(DSP_HAS_SSE2)
+void cor_h_SSE2(FFLOAT *h, FFLOAT *rr);
+void cor_h_x_SSE2(FFLOAT h[], FFLOAT x[], FFLOAT d[]);
+void search_8x8_SSE2(FFLOAT ps1[], FFLOAT alp1[], FFLOAT dn_col[], FFLOAT rr[],
+  FFLOAT tmp_vect[], int *row, int *col, FFLOAT *sq, FFLOAT *alp);
+void lsp_dist_SSE2(FFLOAT *cb_t, int rows, FFLOAT target[], FFLOAT wegt[],
+  int j0, int j1, FFLOAT dist[]);
+void corr_lags_SSE2(FFLOAT x[], FFLOAT y[], int n, int lags, FFLOAT init, FFLOAT corr[]);
+FFLOAT pst_energy_SSE2(FFLOAT x[], int n, FFLOAT init);
+FFLOAT pst_agc_scale_SSE2(FFLOAT x[], int n, FFLOAT gain, FFLOAT g0);
+#endif
+
+#if defined(DSP_HAS_AVX2)
+void cor_h_AVX2(FFLOAT *h, FFLOAT *rr);
+void cor_h_x_AVX2(FFLOAT h[], FFLOAT x[], FFLOAT d[]);
+void search_8x8_AVX2(FFLOAT ps1[], FFLOAT alp1[], FFLOAT dn_col[], FFLOAT rr[],
+  FFLOAT tmp_vect[], int *row, int *col, FFLOAT *sq, FFLOAT *alp);
+void lsp_dist_AVX2(FFLOAT *cb_t, int rows, FFLOAT target[], FFLOAT wegt[],
+  int j0, int j1, FFLOAT dist[]);
+void corr_lags_AVX2(FFLOAT x[], FFLOAT y[], int n, int lags, FFLOAT init, FFLOAT corr[]);
+FFLOAT pst_energy_AVX2(FFLOAT x[], int n, FFLOAT init);
+FFLOAT pst_agc_scale_AVX2(FFLOAT x[], int n, FFLOAT gain, FFLOAT g0);
+#endif
+
+#if defined(DSP_HAS_NEON)
+void cor_h_NEON(FFLOAT *h, FFLOAT *rr);
+void cor_h_x_NEON(FFLOAT h[], FFLOAT x[], FFLOAT d[]);
+void search_8x8_NEON(FFLOAT ps1[], FFLOAT alp1[], FFLOAT dn_col[], FFLOAT rr[],
+  FFLOAT tmp_vect[], int *row, int *col, FFLOAT *sq, FFLOAT *alp);
+void lsp_dist_NEON(FFLOAT *cb_t, int rows, FFLOAT target[], FFLOAT wegt[],
+  int j0, int j1, FFLOAT dist[]);
+void corr_lags_NEON(FFLOAT x[], FFLOAT y[], int n, int lags, FFLOAT init, FFLOAT corr[]);
+FFLOAT pst_energy_NEON(FFLOAT x[], int n, FFLOAT init);
+FFLOAT pst_agc_scale_NEON(FFLOAT x[], int n, FFLOAT gain, FFLOAT g0);
+#endif
+
+#endif
@@ -0,0 +1,15 @@
+/*-----------------------------------------------------------*
+ * tab_dtx.h - tables of G.729 Annex B (see Tab_dtx.c)       *
+ *-----------------------------------------------------------*/
+
+extern FFLOAT lbf_corr[NP+1];
+extern FFLOAT vad_a[14];
+extern FFLOAT vad_b[14];
+extern int    PtrTab_1[NC0_SID];
+extern int    PtrTab_2[2][NC1_SID];
+extern FFLOAT tab_Sidgain[NB_SIDGAIN];
+extern FFLOAT fact_sid[NB_GAIN+1];
+extern int    bitsno_sid[PRM_SIZE_SID];
+extern FFLOAT noise_fg[MODE][MA_NP][M];
+extern FFLOAT noise_fg_sum[MODE][M];
+extern FFLOAT noise_fg_sum_inv[MODE][M];
@@ -16,9 +16,11 @@
 */
 
 extern FFLOAT hamwindow[L_WINDOW];
-extern FFLOAT lwindow[MP1];
+extern FFLOAT lwindow[NP+1];
 extern FFLOAT lspcb1[NC0][M];
 extern FFLOAT lspcb2[NC1][M];
+extern FFLOAT lspcb1_t[M][NC0];
+extern FFLOAT lspcb2_t[M][NC1];
 extern FFLOAT fg[2][MA_NP][M];
 extern FFLOAT fg_sum[2][M];
 extern FFLOAT fg_sum_inv[2][M];
@@ -29,14 +29,18 @@
 #include <time.h>
 #include "typedef.h"
 #include "ld8a.h"
+#include "dtx.h"
 #include "../rtp.h"
 #include <string.h>
 
+#define G729_MAX_FRAMES     6       /* ptime 60 ms */
+
 static FFLOAT m_synth_buf[L_FRAME+M];
 static FFLOAT *m_synth;
 int bad_lsf;        /* bad LSF indicator   */
 static FFLOAT  m_Az_dec[MP1*2];            /* Decoded Az for post-filter */
 static int    m_T2[2];
+static pst_state m_pst;                    /* Post-filter of the decoder */
 static int m_prm[PRM_SIZE+2];
 
 static int bMarker;
@@ -46,6 +50,12 @@ static int bMarker;
 static int wTimeStamp;
 static int seq;
 static int ssrc;
+static int m_frames = 2;                   /* 10 ms frames per RTP packet */
+
+/* coded frames not sent yet, wTimeStamp is the time of the first one */
+static unsigned char m_queue[2*G729_MAX_FRAMES][FRAME_BYTES];
+static int m_queue_len[2*G729_MAX_FRAMES];
+static int m_queued;
 
 
 void va_g729a_init_encoder()
@@ -73,17 +83,27 @@ void va_g729a_init_encoder()
 
 }
 
-void va_g729a_encoder(short *speech, unsigned char *bitstream)
+/*
+   1 : Annex B VAD/DTX, silence is coded as SID frames or not at all.
+   Only built with G729_ANNEX_B : the SID coding has not been run against the
+   ITU Annex B conformance vectors yet, without it every frame is speech.
+*/
+void va_g729a_set_dtx(int enable)
+{
+#ifdef G729_ANNEX_B
+	set_dtx_ld8a(enable);
+#else
+	(void)enable;
+	set_dtx_ld8a(0);
+#endif
+}
+
+/* returns the coded size : FRAME_BYTES, SID_BYTES or 0 (DTX, nothing to send) */
+int va_g729a_encoder(short *speech, unsigned char *bitstream)
 {
 	extern FFLOAT *new_speech;           /* Pointer to new speech data   */
-	static int prm[PRM_SIZE];           /* Transmitted parameters        */
-	static INT16 serial[SERIAL_SIZE];   /* Output bit stream buffer      */
-	int i,j,k;
-	INT16 nb_words;
-	int length;
-	char buffer[20];
-	unsigned char data,mask;
-	 
+	int prm[PRM_SIZE+1];                /* Frame type and parameters     */
+	int i;
 
 	for (i = 0; i < L_FRAME; i++)  new_speech[i] = (FFLOAT) speech[i];
 
@@ -91,58 +111,32 @@ void va_g729a_encoder(short *speech, unsigned char *bitstream)
 
 	coder_ld8a(prm);
 
-	prm2bits_ld8k(prm, serial);
-	nb_words = serial[1] +  2;
-	length=0;
-	switch( serial[1] )
+	switch( prm[0] )
 	{
-	  case 0:
-		  length=0;
-		  for(i=0;i<10;i++)
-		  {
-			buffer[i]=0;
-		  }
-		  break;
-	  case 15:
-	  case 16:
-		  length+=2;
-		  k=2;
-		  for(i=0;i<2;i++)
-		  {
-			data=0;
-			mask=0x80;
-			for(j=0;j<8;j++)
-			{
-				if( serial[k++]==BIT_1 )
-					data|=mask;
-				mask>>=1;
-			}
-			buffer[i]=data;
-		  }
-		  for(i=2;i<10;i++)
-		  {
-			buffer[i]=0;
-		  }
-			//  buffer+=10;
-		  break;
-	  case 80:
-		  length+=10;
-		  k=2;
-		  for(i=0;i<10;i++)
-		  {
-			data=0; // buffer[i];
-			mask=0x80;
-			for(j=0;j<8;j++)
-			{
-				if( serial[k++]==BIT_1 )
-					data|=mask;
-				mask>>=1;
-			}
-			buffer[i]=data;
-		  }
-		  break;
+	case FR_SPEECH:
+		prm2bytes_ld8k(&prm[1], bitstream);
+		return FRAME_BYTES;
+	case FR_SID:
+		prm2bytes_sid(&prm[1], bitstream);
+		return SID_BYTES;
+	default:
+		return 0;
 	}
-	memcpy(bitstream,buffer,10);
+}
+
+/*
+   frames consecutive 10 ms frames into one RTP payload, returns its length.
+   The frames are appended as coded, with DTX the caller has to keep the
+   payload contiguous itself (see G729_Encode).
+*/
+int va_g729a_encode_frames(short *speech, int frames, unsigned char *payload)
+{
+	int n, length;
+
+	length = 0;
+	for (n = 0; n < frames; n++)
+		length += va_g729a_encoder(speech + n*L_FRAME, payload + length);
+	return length;
 }
 
 void va_g729a_init_decoder()
@@ -171,168 +165,44 @@ void va_g729a_init_decoder()
 
 	bad_lsf = 0;          /* Initialize bad LSF indicator */
 	init_decod_ld8a();
-	init_post_filter();
+	init_post_filter(&m_pst);
 	init_post_process();
 	
 }
 
-void va_g729a_decoder(unsigned char *buffer, short *synth_short, int bfi)
+/* 0 : skip the post-filter, for decoded audio that is re-encoded right away */
+void va_g729a_set_postfilter(int enable)
 {
-	int i,j,k;
-	unsigned char data;
-	unsigned char mask;
-	int length;
-	int written;
-	INT16 serial[SERIAL_SIZE];       /* Serial stream              */
+	set_post_filter(&m_pst, enable);
+}
+
+static void va_g729a_decode(unsigned char *buffer, int length, short *synth_short, int bfi)
+{
+	int i;
 	FFLOAT temp;
 
-	if( bfi )
-		length=0;
-	else
-		length=10;
+	for (i=2; i < PRM_SIZE+2; i++) m_prm[i] = 0;
+	m_prm[0] = bfi;                       /* frame erased     */
 
-	written = 0;
-	serial[0] = SYNC_WORD;
-	switch( length )
+	if( bfi || length >= FRAME_BYTES )
 	{
-	case 0:
-		serial[1]=80;
-		for(i=0;i<80;i++)
-			serial[i+2]=0;
-		break;
-	case 1:
-		serial[1]=16 /*RATE_SID_OCTET*/;
-		k=2;
-		for(i=0;i<1;i++)
-		{
-			data=buffer[i];
-			mask=0x80;
-			for(j=0;j<8;j++)
-			{
-				if( data&mask )
-					serial[k++]=BIT_1;
-				else
-					serial[k++]=BIT_0;
-				mask>>=1;
-			}
-		}
-		for(i=1;i<10;i++)
-		{
-			for(j=0;j<8;j++)
-			{
-				serial[k++]=BIT_0;
-			}
-		}
-		written=1;
-		break;
-	case 4:
-		serial[1]=80;
-		k=2;
-		for(i=0;i<4;i++)
-		{
-			data=buffer[i];
-			mask=0x80;
-			for(j=0;j<8;j++)
-			{
-				if( data&mask )
-					serial[k++]=BIT_0;
-				else
-					serial[k++]=BIT_0;
-				mask>>=1;
-			}
-		}
-		for(i=4;i<10;i++)
-		{
-			for(j=0;j<8;j++)
-			{
-				serial[k++]=BIT_0;
-			}
-		}
-		written=length;
-		break;
-	case 2:
-		serial[1]=80 /*RATE_8000*/;
-		k=2;
-		for(i=0;i<2;i++)
-		{
-			data=buffer[i];
-			mask=0x80;
-			for(j=0;j<8;j++)
-			{
-				if( data&mask )
-					serial[k++]=BIT_0;
-				else
-					serial[k++]=BIT_0;
-				mask>>=1;
-			}
-		}
-		for(i=2;i<10;i++)
-		{
-			for(j=0;j<8;j++)
-			{
-				serial[k++]=BIT_0;
-			}
-		}
-		written=length;
-		break;
-	case 10:
-		serial[1]=80 /*RATE_8000*/;
-		k=2;
-		for(i=0;i<10;i++)
-		{
-			data=buffer[i];
-			mask=0x80;
-			for(j=0;j<8;j++)
-			{
-				if( data&mask )
-					serial[k++]=BIT_1;
-				else
-					serial[k++]=BIT_0;
-				mask>>=1;
-			}
-		}
-		written+=10;
-		break;
-	default:
-		if( length>=10 )
-		{
-			serial[1]=80 /*RATE_8000*/;
-			k=2;
-			for(i=0;i<10;i++)
-			{
-				data=buffer[i];
-				mask=0x80;
-				for(j=0;j<8;j++)
-				{
-					if( data&mask )
-						serial[k++]=BIT_1;
-					else
-						serial[k++]=BIT_0;
-					mask>>=1;
-				}
-			}
-			written+=10;
-		}
-		else
-			serial[1]=0;
-		break;
-	}
-
-    bits2prm_ld8k(&serial[2], &m_prm[1]);
-
-	m_prm[0] = 0;           /* No frame erasure */
-
-    if(serial[1] != 0) {
-		for (i=0; i < serial[1]; i++)
-		if (serial[i+2] == 0 ) m_prm[0] = 1;  /* frame erased     */
-	}
-	else if(serial[0] != SYNC_WORD) m_prm[0] = 1;
+		m_prm[1] = FR_SPEECH;
+		if( !bfi )
+			bytes2prm_ld8k(buffer, &m_prm[2]);
 
 		/* check parity and put 1 in parm[5] if parity error */
-	m_prm[4] = check_parity_pitch(m_prm[3], m_prm[4]);
+		m_prm[5] = check_parity_pitch(m_prm[4], m_prm[5]);
+	}
+	else if( length >= SID_BYTES )
+	{
+		m_prm[1] = FR_SID;
+		bytes2prm_sid(buffer, &m_prm[2]);
+	}
+	else
+		m_prm[1] = FR_NOT_SENT;
 
     decod_ld8a(m_prm, m_synth, m_Az_dec, m_T2);             /* decoder */
-    post_filter(m_synth, m_Az_dec, m_T2);                  /* Post-filter */
+    post_filter(&m_pst, m_synth, m_Az_dec, m_T2);          /* Post-filter */
     post_process(m_synth, L_FRAME);                    /* Highpass filter */
 
 	for (i=0; i<L_FRAME; i++) {
@@ -350,6 +220,40 @@ void va_g729a_decoder(unsigned char *buffer, short *synth_short, int bfi)
 
 }
 
+void va_g729a_decoder(unsigned char *buffer, short *synth_short, int bfi)
+{
+	va_g729a_decode(buffer, FRAME_BYTES, synth_short, bfi);
+}
+
+/*
+   One frame as sent with DTX : FRAME_BYTES for speech, SID_BYTES for a SID,
+   0 for a silent frame that was not transmitted (the comfort noise goes on).
+*/
+void va_g729a_decode_frame(unsigned char *buffer, int length, short *synth_short)
+{
+	va_g729a_decode(buffer, length, synth_short, 0);
+}
+
+/*
+   Decodes the 10 ms frames of one RTP payload, returns the number of samples.
+   A trailing SID (length % FRAME_BYTES == SID_BYTES) is decoded as the last
+   frame. A lost payload (bfi) conceals length/FRAME_BYTES frames.
+*/
+int va_g729a_decode_frames(unsigned char *payload, int length, short *synth_short, int bfi)
+{
+	int n, frames;
+
+	frames = length / FRAME_BYTES;
+	for (n = 0; n < frames; n++)
+		va_g729a_decode(payload + n*FRAME_BYTES, FRAME_BYTES, synth_short + n*L_FRAME, bfi);
+	if( !bfi && length - frames*FRAME_BYTES >= SID_BYTES )
+	{
+		va_g729a_decode(payload + n*FRAME_BYTES, SID_BYTES, synth_short + n*L_FRAME, 0);
+		frames++;
+	}
+	return frames*L_FRAME;
+}
+
 void G729_InitCodec()
 {
     va_g729a_init_encoder();
@@ -362,21 +266,79 @@ void G729_InitVar()
     
     bMarker = 1;
     wTimeStamp = MIN_TIMESTAMP;
+    m_queued = 0;
     seq = MIN_SEQUENCE;
     ssrc = randomR(31415621, 100000000);
 }
 
-void G729_Encode(short *speech, int offset, unsigned char *bitstream, int payloadType)
+// ptime : 10 to 60 ms, in steps of 10 ms
+void G729_SetPtime(int ms)
+{
+    m_frames = ms / 10;
+    if (m_frames < 1)
+        m_frames = 1;
+    if (m_frames > G729_MAX_FRAMES)
+        m_frames = G729_MAX_FRAMES;
+}
+
+// 1 : send SID frames or nothing during silence (G.729 Annex B)
+void G729_SetDtx(int enable)
+{
+    va_g729a_set_dtx(enable);
+}
+
+static int next_timestamp(int ts, int samples)
+{
+    if ((ts += samples) >= MAX_TIMESTAMP)
+        ts = MIN_TIMESTAMP;
+    return ts;
+}
+
+/*
+   Codes one ptime of speech and returns the RTP packet length, 0 when there
+   is nothing to send (DTX). A packet carries speech frames followed by at
+   most one SID (RFC 3551) ; frames coded after a SID wait for the next one.
+*/
+int G729_Encode(short *speech, int offset, unsigned char *bitstream, int payloadType)
 {
     _rtp_header header;
-    unsigned char encPkt[20];
+    short *pcm = (short *)((unsigned char *)speech + offset);
+    int n, first, count, length, timestamp;
     
-    va_g729a_encoder((short *)((unsigned char *)speech + offset), encPkt);
-    va_g729a_encoder((short *)((unsigned char *)speech + offset + 160), encPkt + 10);
+    for (n = 0; n < m_frames; n++, m_queued++)
+        m_queue_len[m_queued] = va_g729a_encoder(pcm + n*L_FRAME, m_queue[m_queued]);
+
+    // silent frames DTX did not code, the next talk spurt gets the marker
+    for (first = 0; first < m_queued && m_queue_len[first] == 0; first++)
+        bMarker = 1;
+
+    length = 0;
+    for (count = 0; first + count < m_queued && count < m_frames; ) {
+        n = m_queue_len[first + count];
+        if (n == 0)
+            break;
+        memcpy(bitstream + 12 + length, m_queue[first + count], n);
+        length += n;
+        count++;
+        if (n != FRAME_BYTES)
+            break;
+    }
+    timestamp = next_timestamp(wTimeStamp, first * L_FRAME);
+
+    // shift out what was sent, keep at most G729_MAX_FRAMES for later
+    n = first + count;
+    if (m_queued - n > G729_MAX_FRAMES) {
+        n = m_queued - G729_MAX_FRAMES;
+        bMarker = 1;
+    }
+    memmove(m_queue, m_queue[n], (m_queued - n) * sizeof(m_queue[0]));
+    memmove(m_queue_len, &m_queue_len[n], (m_queued - n) * sizeof(m_queue_len[0]));
+    m_queued -= n;
+    wTimeStamp = next_timestamp(wTimeStamp, n * L_FRAME);
+
+    if (length == 0)
+        return 0;
 
-    if ((wTimeStamp += TIME_SLICE) >= MAX_TIMESTAMP)
-        wTimeStamp = MIN_TIMESTAMP;
-    
     if (++seq > MAX_SEQUENCE)
         seq = MIN_SEQUENCE;
     
@@ -385,7 +347,7 @@ void G729_Encode(short *speech, int offset, unsigned char *bitstream, int payloa
     header.x = 0;      // OPTION FIELD
     header.cc = 0;     // CSRC COUNT
     
-    if( bMarker )                 // MARKER BIT
+    if( bMarker && length >= FRAME_BYTES )  // MARKER BIT, not on a lone SID
         header.m = 1;
     else
         header.m = 0;
@@ -393,19 +355,27 @@ void G729_Encode(short *speech, int offset, unsigned char *bitstream, int payloa
     header.pt = payloadType;
     
     header.seq = htons((unsigned short)seq); // SEQUENCE NUMBER
-    header.timestamp = htonl(wTimeStamp);    // TIMESTAMP
+    header.timestamp = htonl(timestamp);     // TIMESTAMP
     header.ssrc = htonl(ssrc);
     
     memcpy(bitstream, (unsigned char *)&header, 12);
-    memcpy(bitstream + 12, encPkt, 20);
     
-    if (bMarker)
+    if (header.m)
         bMarker = 0;
+
+    return 12 + length;
 }
 
-void G729_Decode(unsigned char *buffer, int offset, short *synth_short, int bfi)
+/*
+   Decodes one RTP payload of length bytes, returns the number of samples :
+   speech frames, a trailing SID, or nothing for an empty payload. A lost
+   payload (bfi) conceals a full ptime.
+*/
+int G729_Decode(unsigned char *buffer, int length, int offset, short *synth_short, int bfi)
 {
-    va_g729a_decoder((unsigned char *)buffer, (short *)((unsigned char *)synth_short + offset), bfi);
-    va_g729a_decoder((unsigned char *)buffer + 10, (short *)((unsigned char *)synth_short + offset + 160), bfi);
+    if (bfi)
+        length = m_frames * FRAME_BYTES;
+    return va_g729a_decode_frames(buffer, length,
+                                  (short *)((unsigned char *)synth_short + offset), bfi);
 }
 
@@ -0,0 +1,102 @@
+#include <string.h>
+#include <algorithm>
+
+#include "audio_mixer.h"
+#include "../Dsp/pcm_simd.h"
+
+CAudioMixer::CAudioMixer(int frameSamples, int maxParticipants)
+	: frameSamples(frameSamples)
+	, maxParticipants(maxParticipants)
+	, maxActive(0)
+	, mixedCount(0)
+	, acc(frameSamples)
+	, mixed(frameSamples)
+	, minus((size_t)frameSamples * maxParticipants)
+	, level(maxParticipants)
+	, order(maxParticipants)
+	, rank(maxParticipants)
+{
+	Reset();
+}
+
+CAudioMixer::~CAudioMixer()
+{
+}
+
+void CAudioMixer::SetMaxActiveSpeakers(int count)
+{
+	maxActive = count < 0 ? 0 : count;
+}
+
+void CAudioMixer::Reset()
+{
+	std::fill(level.begin(), level.end(), 0);
+	std::fill(rank.begin(), rank.end(), -1);
+	std::fill(mixed.begin(), mixed.end(), 0);
+	mixedCount = 0;
+}
+
+//-------------------------------------------------------------------------------------//
+
+void CAudioMixer::SelectSpeakers(const int16_t * const *frames, int count)
+{
+	int candidates = 0;
+	int i;
+
+	for (i = 0; i < count; i++) {
+		uint64_t energy = frames[i] ? PcmEnergy(frames[i], frameSamples) : 0;
+
+		// attack immediately, release over a few frames so talkers do not flap
+		level[i] = energy > level[i] ? energy : (level[i] * 3 + energy) >> 2;
+		if (frames[i])
+			order[candidates++] = i;
+	}
+	for (; i < maxParticipants; i++)
+		level[i] = 0;
+
+	mixedCount = candidates;
+	if (maxActive > 0 && candidates > maxActive) {
+		std::nth_element(order.begin(), order.begin() + maxActive, order.begin() + candidates,
+			[this](int a, int b) { return level[a] > level[b]; });
+		mixedCount = maxActive;
+	}
+}
+
+void CAudioMixer::Mix(const int16_t * const *frames, int count)
+{
+	int i;
+
+	if (count > maxParticipants)
+		count = maxParticipants;
+
+	for (i = 0; i < maxParticipants; i++)
+		rank[i] = -1;
+
+	SelectSpeakers(frames, count);
+
+	memset(acc.data(), 0, sizeof(int32_t) * frameSamples);
+	for (i = 0; i < mixedCount; i++)
+		PcmAccumulate(acc.data(), frames[order[i]], frameSamples);
+
+	PcmSaturate(mixed.data(), acc.data(), frameSamples);
+
+	for (i = 0; i < mixedCount; i++) {
+		int participant = order[i];
+		rank[participant] = i;
+		PcmSaturateMinus(&minus[(size_t)i * frameSamples], acc.data(), frames[participant], frameSamples);
+	}
+}
+
+//-------------------------------------------------------------------------------------//
+
+const int16_t *CAudioMixer::MixMinusFrame(int participant) const
+{
+	if (participant < 0 || participant >= maxParticipants || rank[participant] < 0)
+		return mixed.data();
+	return &minus[(size_t)rank[participant] * frameSamples];
+}
+
+bool CAudioMixer::IsMixed(int participant) const
+{
+	return participant >= 0 && participant < maxParticipants && rank[participant] >= 0;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+//-------------------------------------------------------------------------------------//
+//
+// N-party conference mixer over decoded 16-bit PCM.
+//
+// Every call to Mix() sums the selected talkers once into a 32-bit accumulator
+// and derives each talker's mix-minus by subtracting its own frame, so one
+// frame costs O(N) instead of summing N-1 streams for each of N listeners.
+// Participants that are not mixed hear the full mix and share its buffer.
+//
+// With SetMaxActiveSpeakers(k) only the k loudest participants (by smoothed
+// frame energy) are summed, which keeps large rooms at the cost of a k-party mix.
+//
+//-------------------------------------------------------------------------------------//
+
+class CAudioMixer
+{
+public:
+	CAudioMixer(int frameSamples, int maxParticipants);
+	virtual ~CAudioMixer();
+
+	void SetMaxActiveSpeakers(int count);	// 0 : mix every participant
+	void Reset();
+
+	// frames[i] is participant i's frame or NULL when nothing was received.
+	// Participant slots must stay stable between calls for speaker ranking.
+	void Mix(const int16_t * const *frames, int count);
+
+	const int16_t *MixedFrame() const { return mixed.data(); }
+	const int16_t *MixMinusFrame(int participant) const;
+
+	bool IsMixed(int participant) const;
+	int MixedCount() const { return mixedCount; }
+	const int *MixedParticipants() const { return order.data(); }
+	int FrameSamples() const { return frameSamples; }
+
+protected:
+	void SelectSpeakers(const int16_t * const *frames, int count);
+
+	int frameSamples;
+	int maxParticipants;
+	int maxActive;
+	int mixedCount;
+
+	std::vector<int32_t> acc;		// frameSamples
+	std::vector<int16_t> mixed;		// frameSamples
+	std::vector<int16_t> minus;		// maxParticipants * frameSamples, by mix rank
+	std::vector<uint64_t> level;	// smoothed energy per participant
+	std::vector<int> order;			// participants ranked for this frame
+	std::vector<int> rank;			// participant -> rank in order, -1 if not mixed
+};
@@ -0,0 +1,114 @@
+#include <string.h>
+
+#include "voice_activity_detector.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include "../AmrWB/typedef.h"
+#include "../AmrWB/basic_op.h"
+#include "../AmrWB/acelp.h"
+#include "../AmrWB/cnst.h"
+#include "../AmrWB/wb_vad.h"
+#ifdef __cplusplus
+}
+#endif
+
+CVoiceActivityDetector::CVoiceActivityDetector(int sampleRate)
+	: vadSt(NULL)
+	, sampleRate(sampleRate == 16000 ? 16000 : 8000)
+	, sidInterval(0)
+{
+	frameSamples = this->sampleRate * VAD_FRAME_MS / 1000;
+	VadVars *st = NULL;
+	wb_vad_init(&st);
+	vadSt = st;
+	Reset();
+}
+
+CVoiceActivityDetector::~CVoiceActivityDetector()
+{
+	VadVars *st = (VadVars *)vadSt;
+	wb_vad_exit(&st);
+}
+
+void CVoiceActivityDetector::Reset()
+{
+	wb_vad_reset((VadVars *)vadSt);
+	Init_Decim_12k8(memDecim);
+	Init_HP50_12k8(memHp50);
+	memPreemph = 0;
+	memset(memUp, 0, sizeof(memUp));
+	speech = 0;
+	silentFrames = 0;
+}
+
+//-------------------------------------------------------------------------------------//
+// 8 kHz -> 16 kHz, 4 point halfband interpolation, 2 input samples of delay
+
+void CVoiceActivityDetector::Upsample16k(const int16_t *in, int16_t *out)
+{
+	int32_t e[3 + L_FRAME16k / 2];
+	int n, half = frameSamples;
+
+	e[0] = memUp[0]; e[1] = memUp[1]; e[2] = memUp[2];
+	for (n = 0; n < half; n++)
+		e[n + 3] = in[n];
+
+	for (n = 0; n < half; n++) {
+		int32_t v = (9 * (e[n + 1] + e[n + 2]) - (e[n] + e[n + 3]) + 8) >> 4;
+		if (v > 32767) v = 32767;
+		if (v < -32768) v = -32768;
+		out[2 * n] = (int16_t)e[n + 1];
+		out[2 * n + 1] = (int16_t)v;
+	}
+
+	memUp[0] = in[half - 3]; memUp[1] = in[half - 2]; memUp[2] = in[half - 1];
+}
+
+//-------------------------------------------------------------------------------------//
+
+int CVoiceActivityDetector::Process(const int16_t *frame)
+{
+	Word16 sig16k[L_FRAME16k];
+	Word16 sig12k8[L_FRAME];
+
+	if (sampleRate == 8000)
+		Upsample16k(frame, sig16k);
+	else
+		memcpy(sig16k, frame, sizeof(sig16k));
+
+	// same front end as coder() : 12.8 kHz, 50 Hz high pass, preemphasis
+	Decim_12k8(sig16k, L_FRAME16k, sig12k8, memDecim);
+	HP50_12k8(sig12k8, L_FRAME, memHp50);
+	Preemph(sig12k8, PREEMPH_FAC, L_FRAME, &memPreemph);
+
+	speech = wb_vad((VadVars *)vadSt, sig12k8);
+	return speech;
+}
+
+int CVoiceActivityDetector::ProcessFrames(const int16_t *pcm, int frames, uint8_t *flags)
+{
+	int count = 0;
+
+	for (int i = 0; i < frames; i++) {
+		flags[i] = (uint8_t)Process(pcm + i * frameSamples);
+		count += flags[i];
+	}
+	return count;
+}
+
+VadGate CVoiceActivityDetector::Gate(const int16_t *frame)
+{
+	if (Process(frame)) {
+		silentFrames = 0;
+		return VAD_GATE_ENCODE;
+	}
+
+	// wb_vad already applies its hangover, the first noise frame starts the silence period
+	if (silentFrames++ == 0)
+		return VAD_GATE_SEND_SID;
+	if (sidInterval > 0 && (silentFrames - 1) % sidInterval == 0)
+		return VAD_GATE_SEND_SID;
+	return VAD_GATE_SKIP;
+}
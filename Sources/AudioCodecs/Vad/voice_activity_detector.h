@@ -0,0 +1,62 @@
+#pragma once
+#include <stdint.h>
+
+//-------------------------------------------------------------------------------------//
+//
+// Codec independent voice activity detection on top of the AMR-WB filter bank VAD
+// (AmrWB/wb_vad.c).
+//
+// wb_vad works on 20 ms frames at 12.8 kHz after the AMR-WB front end.
+// 16 kHz input goes through the same Decim_12k8 / HP50_12k8 / Preemph chain as
+// coder(); 8 kHz input is first interpolated to 16 kHz. One instance per stream.
+//
+// Gate() turns the per-frame decision into a send decision for legs without a
+// native DTX (G.711, G.729A, iLBC): encode speech, send one SID/CN frame when
+// speech ends (and every sidInterval frames of silence if set), skip the rest.
+//
+//-------------------------------------------------------------------------------------//
+
+#define VAD_FRAME_MS            20
+
+enum VadGate
+{
+	VAD_GATE_ENCODE = 0,        // speech (or hangover) : encode and send
+	VAD_GATE_SEND_SID,          // silence update : send a comfort noise frame
+	VAD_GATE_SKIP,              // silence : send nothing
+};
+
+class CVoiceActivityDetector
+{
+public:
+	explicit CVoiceActivityDetector(int sampleRate);	// 8000 or 16000
+	virtual ~CVoiceActivityDetector();
+
+	void Reset();
+	int FrameSamples() const { return frameSamples; }
+
+	// One 20 ms frame. Returns 1 for speech, 0 for noise.
+	int Process(const int16_t *frame);
+
+	// frames consecutive 20 ms frames, flags[i] is the decision of frame i.
+	// Returns the number of speech frames.
+	int ProcessFrames(const int16_t *pcm, int frames, uint8_t *flags);
+
+	VadGate Gate(const int16_t *frame);
+	void SetSidInterval(int frames) { sidInterval = frames; }	// 0 : one SID per silence period
+
+protected:
+	void Upsample16k(const int16_t *in, int16_t *out);
+
+	void *vadSt;
+	int sampleRate;
+	int frameSamples;
+
+	int16_t memDecim[30];       // 2 * NB_COEF_DOWN
+	int16_t memHp50[6];
+	int16_t memPreemph;
+	int16_t memUp[3];           // last input samples for the 8 kHz interpolator
+
+	int speech;                 // decision of the previous frame
+	int silentFrames;
+	int sidInterval;
+};
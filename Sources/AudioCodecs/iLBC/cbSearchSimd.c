@@ -0,0 +1,460 @@
+/******************************************************************
+
+    iLBC Speech Coder ANSI-C Source Code
+
+    cbSearchSimd.c
+
+    SIMD kernels of the codebook search (see cbSearchSimd.h)
+
+******************************************************************/
+
+#include "iLBC_define.h"
+#include "constants.h"
+#include "cbSearchSimd.h"
+
+/*----------------------------------------------------------------*
+ *  Reference kernels
+ *---------------------------------------------------------------*/
+
+void cbCorr_C(
+    float *target,  /* (i) Target vector */
+    float *cb,      /* (i) Codebook vector of lag 0 */
+    int n,          /* (i) Length of the vectors */
+    int lags,       /* (i) Number of lags */
+    float *corr     /* (o) Cross dot products */
+){
+    int j, k;
+    float crossDot;
+
+    for (k=0; k<lags; k++) {
+        crossDot=0.0;
+        for (j=0; j<n; j++) {
+            crossDot += target[j]*cb[j-k];
+        }
+        corr[k] = crossDot;
+    }
+}
+
+void cbInvEnergy_C(
+    float *energy,      /* (i) Energies */
+    int n,              /* (i) Number of energies */
+    float *invenergy    /* (o) Inverse energies */
+){
+    int k;
+
+    for (k=0; k<n; k++) {
+        if (energy[k]>0.0) {
+            invenergy[k] = (float)1.0/(energy[k]+EPS);
+        } else {
+            invenergy[k] = (float)0.0;
+        }
+    }
+}
+
+void cbAugSums_C(
+    float *target,      /* (i) Target vector */
+    float *aug,         /* (i) Augmented vectors, one per column */
+    int ilow,           /* (i) First interpolated sample of
+                               vector 0 */
+    float *crossDot,    /* (o) Cross dot products */
+    float *energy       /* (i/o) Energies */
+){
+    int j, k;
+    float *pp;
+
+    for (k=0; k<CB_AUGLANES; k++) {
+        crossDot[k] = 0.0;
+        pp = aug + k;
+        for (j=0; j<SUBL; j++) {
+            crossDot[k] += target[j]*pp[j*CB_AUGLANES];
+        }
+        for (j=ilow+k; j<SUBL; j++) {
+            energy[k] += pp[j*CB_AUGLANES]*pp[j*CB_AUGLANES];
+        }
+    }
+}
+
+void cbFilter_C(
+    float *in,      /* (i) Zero padded buffer */
+    int n,          /* (i) Number of output samples */
+    float *out      /* (o) Filtered buffer */
+){
+    int j, k;
+    float *pp, *pp1;
+
+    for (k=0; k<n; k++) {
+        pp=&in[k];
+        pp1=&cbfiltersTbl[CB_FILTERLEN-1];
+        out[k]=0.0;
+        for (j=0;j<CB_FILTERLEN;j++) {
+            out[k]+=(*pp++)*(*pp1--);
+        }
+    }
+}
+
+/*----------------------------------------------------------------*
+ *  SSE2
+ *  cbCorr : a block of 8 lags shares each target[j], the lanes
+ *  load cb[j-k-7 .. j-k] and come out in decreasing lag order.
+ *---------------------------------------------------------------*/
+
+#if defined(DSP_HAS_SSE2)
+void cbCorr_SSE2(float *target, float *cb, int n, int lags, float *corr)
+{
+    int j, k;
+
+    for (k=0; k+8<=lags; k+=8) {
+        __m128 s0 = _mm_setzero_ps(), s1 = s0;
+        for (j=0; j<n; j++) {
+            __m128 t = _mm_set1_ps(target[j]);
+            s0 = _mm_add_ps(s0, _mm_mul_ps(t, _mm_loadu_ps(cb+j-k-3)));
+            s1 = _mm_add_ps(s1, _mm_mul_ps(t, _mm_loadu_ps(cb+j-k-7)));
+        }
+        _mm_storeu_ps(corr+k, _mm_shuffle_ps(s0, s0, _MM_SHUFFLE(0,1,2,3)));
+        _mm_storeu_ps(corr+k+4, _mm_shuffle_ps(s1, s1, _MM_SHUFFLE(0,1,2,3)));
+    }
+    if (k<lags) {
+        cbCorr_C(target, cb-k, n, lags-k, corr+k);
+    }
+}
+
+void cbInvEnergy_SSE2(float *energy, int n, float *invenergy)
+{
+    const __m128 one = _mm_set1_ps(1.0f), eps = _mm_set1_ps(EPS);
+    int k;
+
+    for (k=0; k+4<=n; k+=4) {
+        __m128 e = _mm_loadu_ps(energy+k);
+        __m128 r = _mm_div_ps(one, _mm_add_ps(e, eps));
+        _mm_storeu_ps(invenergy+k,
+            _mm_and_ps(r, _mm_cmpgt_ps(e, _mm_setzero_ps())));
+    }
+    if (k<n) {
+        cbInvEnergy_C(energy+k, n-k, invenergy+k);
+    }
+}
+
+void cbAugSums_SSE2(float *target, float *aug, int ilow,
+    float *crossDot, float *energy)
+{
+    __m128 c[CB_AUGLANES/4], e[CB_AUGLANES/4], lane[CB_AUGLANES/4];
+    int i, j;
+
+    for (i=0; i<CB_AUGLANES/4; i++) {
+        c[i] = _mm_setzero_ps();
+        e[i] = _mm_loadu_ps(energy+4*i);
+        lane[i] = _mm_setr_ps((float)(4*i), (float)(4*i+1),
+            (float)(4*i+2), (float)(4*i+3));
+    }
+    for (j=0; j<SUBL; j++) {
+        __m128 t = _mm_set1_ps(target[j]);
+        __m128 last = _mm_set1_ps((float)(j-ilow));
+        for (i=0; i<CB_AUGLANES/4; i++) {
+            __m128 a = _mm_loadu_ps(aug+j*CB_AUGLANES+4*i);
+            c[i] = _mm_add_ps(c[i], _mm_mul_ps(t, a));
+            e[i] = _mm_add_ps(e[i], _mm_and_ps(_mm_mul_ps(a, a),
+                _mm_cmple_ps(lane[i], last)));
+        }
+    }
+    for (i=0; i<CB_AUGLANES/4; i++) {
+        _mm_storeu_ps(crossDot+4*i, c[i]);
+        _mm_storeu_ps(energy+4*i, e[i]);
+    }
+}
+
+void cbFilter_SSE2(float *in, int n, float *out)
+{
+    int j, k;
+
+    for (k=0; k+4<=n; k+=4) {
+        __m128 s = _mm_setzero_ps();
+        for (j=0; j<CB_FILTERLEN; j++) {
+            s = _mm_add_ps(s, _mm_mul_ps(_mm_loadu_ps(in+k+j),
+                _mm_set1_ps(cbfiltersTbl[CB_FILTERLEN-1-j])));
+        }
+        _mm_storeu_ps(out+k, s);
+    }
+    if (k<n) {
+        cbFilter_C(in+k, n-k, out+k);
+    }
+}
+#endif
+
+/*----------------------------------------------------------------*
+ *  AVX2, same layout on 8 lanes. No FMA : the fused rounding
+ *  would change the search decisions.
+ *---------------------------------------------------------------*/
+
+#if defined(DSP_HAS_AVX2)
+DSP_TARGET_AVX2
+void cbCorr_AVX2(float *target, float *cb, int n, int lags, float *corr)
+{
+    const __m256i reverse = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    int j, k;
+
+    for (k=0; k+16<=lags; k+=16) {
+        __m256 s0 = _mm256_setzero_ps(), s1 = s0;
+        for (j=0; j<n; j++) {
+            __m256 t = _mm256_set1_ps(target[j]);
+            s0 = _mm256_add_ps(s0,
+                _mm256_mul_ps(t, _mm256_loadu_ps(cb+j-k-7)));
+            s1 = _mm256_add_ps(s1,
+                _mm256_mul_ps(t, _mm256_loadu_ps(cb+j-k-15)));
+        }
+        _mm256_storeu_ps(corr+k, _mm256_permutevar8x32_ps(s0, reverse));
+        _mm256_storeu_ps(corr+k+8, _mm256_permutevar8x32_ps(s1, reverse));
+    }
+    for (; k+8<=lags; k+=8) {
+        __m256 s0 = _mm256_setzero_ps();
+        for (j=0; j<n; j++) {
+            s0 = _mm256_add_ps(s0, _mm256_mul_ps(
+                _mm256_set1_ps(target[j]), _mm256_loadu_ps(cb+j-k-7)));
+        }
+        _mm256_storeu_ps(corr+k, _mm256_permutevar8x32_ps(s0, reverse));
+    }
+    _mm256_zeroupper();
+    if (k<lags) {
+        cbCorr_C(target, cb-k, n, lags-k, corr+k);
+    }
+}
+
+DSP_TARGET_AVX2
+void cbInvEnergy_AVX2(float *energy, int n, float *invenergy)
+{
+    const __m256 one = _mm256_set1_ps(1.0f), eps = _mm256_set1_ps(EPS);
+    int k;
+
+    for (k=0; k+8<=n; k+=8) {
+        __m256 e = _mm256_loadu_ps(energy+k);
+        __m256 r = _mm256_div_ps(one, _mm256_add_ps(e, eps));
+        _mm256_storeu_ps(invenergy+k, _mm256_and_ps(r,
+            _mm256_cmp_ps(e, _mm256_setzero_ps(), _CMP_GT_OQ)));
+    }
+    _mm256_zeroupper();
+    if (k<n) {
+        cbInvEnergy_C(energy+k, n-k, invenergy+k);
+    }
+}
+
+DSP_TARGET_AVX2
+void cbAugSums_AVX2(float *target, float *aug, int ilow,
+    float *crossDot, float *energy)
+{
+    __m256 c[CB_AUGLANES/8], e[CB_AUGLANES/8], lane[CB_AUGLANES/8];
+    int i, j;
+
+    for (i=0; i<CB_AUGLANES/8; i++) {
+        c[i] = _mm256_setzero_ps();
+        e[i] = _mm256_loadu_ps(energy+8*i);
+        lane[i] = _mm256_add_ps(_mm256_set1_ps((float)(8*i)),
+            _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f));
+    }
+    for (j=0; j<SUBL; j++) {
+        __m256 t = _mm256_set1_ps(target[j]);
+        __m256 last = _mm256_set1_ps((float)(j-ilow));
+        for (i=0; i<CB_AUGLANES/8; i++) {
+            __m256 a = _mm256_loadu_ps(aug+j*CB_AUGLANES+8*i);
+            c[i] = _mm256_add_ps(c[i], _mm256_mul_ps(t, a));
+            e[i] = _mm256_add_ps(e[i], _mm256_and_ps(_mm256_mul_ps(a, a),
+                _mm256_cmp_ps(lane[i], last, _CMP_LE_OQ)));
+        }
+    }
+    for (i=0; i<CB_AUGLANES/8; i++) {
+        _mm256_storeu_ps(crossDot+8*i, c[i]);
+        _mm256_storeu_ps(energy+8*i, e[i]);
+    }
+    _mm256_zeroupper();
+}
+
+DSP_TARGET_AVX2
+void cbFilter_AVX2(float *in, int n, float *out)
+{
+    int j, k;
+
+    for (k=0; k+8<=n; k+=8) {
+        __m256 s = _mm256_setzero_ps();
+        for (j=0; j<CB_FILTERLEN; j++) {
+            s = _mm256_add_ps(s, _mm256_mul_ps(_mm256_loadu_ps(in+k+j),
+                _mm256_set1_ps(cbfiltersTbl[CB_FILTERLEN-1-j])));
+        }
+        _mm256_storeu_ps(out+k, s);
+    }
+    _mm256_zeroupper();
+    if (k<n) {
+        cbFilter_C(in+k, n-k, out+k);
+    }
+}
+#endif
+
+/*----------------------------------------------------------------*
+ *  NEON, same layout as SSE2. vmlaq_f32 may be fused, the
+ *  products and sums are kept apart.
+ *---------------------------------------------------------------*/
+
+#if defined(DSP_HAS_NEON)
+static __inline float32x4_t reverse_f32(float32x4_t v)
+{
+    v = vrev64q_f32(v);
+    return vcombine_f32(vget_high_f32(v), vget_low_f32(v));
+}
+
+void cbCorr_NEON(float *target, float *cb, int n, int lags, float *corr)
+{
+    int j, k;
+
+    for (k=0; k+8<=lags; k+=8) {
+        float32x4_t s0 = vdupq_n_f32(0.0f), s1 = s0;
+        for (j=0; j<n; j++) {
+            float32x4_t t = vdupq_n_f32(target[j]);
+            s0 = vaddq_f32(s0, vmulq_f32(t, vld1q_f32(cb+j-k-3)));
+            s1 = vaddq_f32(s1, vmulq_f32(t, vld1q_f32(cb+j-k-7)));
+        }
+        vst1q_f32(corr+k, reverse_f32(s0));
+        vst1q_f32(corr+k+4, reverse_f32(s1));
+    }
+    if (k<lags) {
+        cbCorr_C(target, cb-k, n, lags-k, corr+k);
+    }
+}
+
+void cbInvEnergy_NEON(float *energy, int n, float *invenergy)
+{
+    int k = 0;
+
+#if defined(__aarch64__)
+    /* ARMv7 has no exact divide, it keeps the scalar loop */
+    const float32x4_t one = vdupq_n_f32(1.0f), eps = vdupq_n_f32(EPS);
+
+    for (; k+4<=n; k+=4) {
+        float32x4_t e = vld1q_f32(energy+k);
+        float32x4_t r = vdivq_f32(one, vaddq_f32(e, eps));
+        uint32x4_t m = vcgtq_f32(e, vdupq_n_f32(0.0f));
+        vst1q_f32(invenergy+k,
+            vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(r), m)));
+    }
+#endif
+    if (k<n) {
+        cbInvEnergy_C(energy+k, n-k, invenergy+k);
+    }
+}
+
+void cbAugSums_NEON(float *target, float *aug, int ilow,
+    float *crossDot, float *energy)
+{
+    static const float lane0[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+    float32x4_t c[CB_AUGLANES/4], e[CB_AUGLANES/4], lane[CB_AUGLANES/4];
+    int i, j;
+
+    for (i=0; i<CB_AUGLANES/4; i++) {
+        c[i] = vdupq_n_f32(0.0f);
+        e[i] = vld1q_f32(energy+4*i);
+        lane[i] = vaddq_f32(vld1q_f32(lane0), vdupq_n_f32((float)(4*i)));
+    }
+    for (j=0; j<SUBL; j++) {
+        float32x4_t t = vdupq_n_f32(target[j]);
+        float32x4_t last = vdupq_n_f32((float)(j-ilow));
+        for (i=0; i<CB_AUGLANES/4; i++) {
+            float32x4_t a = vld1q_f32(aug+j*CB_AUGLANES+4*i);
+            uint32x4_t m = vcleq_f32(lane[i], last);
+            c[i] = vaddq_f32(c[i], vmulq_f32(t, a));
+            e[i] = vaddq_f32(e[i], vreinterpretq_f32_u32(vandq_u32(
+                vreinterpretq_u32_f32(vmulq_f32(a, a)), m)));
+        }
+    }
+    for (i=0; i<CB_AUGLANES/4; i++) {
+        vst1q_f32(crossDot+4*i, c[i]);
+        vst1q_f32(energy+4*i, e[i]);
+    }
+}
+
+void cbFilter_NEON(float *in, int n, float *out)
+{
+    int j, k;
+
+    for (k=0; k+4<=n; k+=4) {
+        float32x4_t s = vdupq_n_f32(0.0f);
+        for (j=0; j<CB_FILTERLEN; j++) {
+            s = vaddq_f32(s, vmulq_f32(vld1q_f32(in+k+j),
+                vdupq_n_f32(cbfiltersTbl[CB_FILTERLEN-1-j])));
+        }
+        vst1q_f32(out+k, s);
+    }
+    if (k<n) {
+        cbFilter_C(in+k, n-k, out+k);
+    }
+}
+#endif
+
+/*----------------------------------------------------------------*
+ *  Dispatch
+ *---------------------------------------------------------------*/
+
+void cbCorr(float *target, float *cb, int n, int lags, float *corr)
+{
+    void (*CbCorr)(float *, float *, int, int, float *) = cbCorr_C;
+
+#if defined(DSP_HAS_SSE2)
+    if (DSP_TEST_CPU(kCpuHasSSE2)) CbCorr = cbCorr_SSE2;
+#endif
+#if defined(DSP_HAS_AVX2)
+    if (DSP_TEST_CPU(kCpuHasAVX2)) CbCorr = cbCorr_AVX2;
+#endif
+#if defined(DSP_HAS_NEON)
+    if (DSP_TEST_CPU(kCpuHasNEON)) CbCorr = cbCorr_NEON;
+#endif
+
+    CbCorr(target, cb, n, lags, corr);
+}
+
+void cbInvEnergy(float *energy, int n, float *invenergy)
+{
+    void (*CbInvEnergy)(float *, int, float *) = cbInvEnergy_C;
+
+#if defined(DSP_HAS_SSE2)
+    if (DSP_TEST_CPU(kCpuHasSSE2)) CbInvEnergy = cbInvEnergy_SSE2;
+#endif
+#if defined(DSP_HAS_AVX2)
+    if (DSP_TEST_CPU(kCpuHasAVX2)) CbInvEnergy = cbInvEnergy_AVX2;
+#endif
+#if defined(DSP_HAS_NEON)
+    if (DSP_TEST_CPU(kCpuHasNEON)) CbInvEnergy = cbInvEnergy_NEON;
+#endif
+
+    CbInvEnergy(energy, n, invenergy);
+}
+
+void cbAugSums(float *target, float *aug, int ilow, float *crossDot,
+    float *energy)
+{
+    void (*CbAugSums)(float *, float *, int, float *, float *) =
+        cbAugSums_C;
+
+#if defined(DSP_HAS_SSE2)
+    if (DSP_TEST_CPU(kCpuHasSSE2)) CbAugSums = cbAugSums_SSE2;
+#endif
+#if defined(DSP_HAS_AVX2)
+    if (DSP_TEST_CPU(kCpuHasAVX2)) CbAugSums = cbAugSums_AVX2;
+#endif
+#if defined(DSP_HAS_NEON)
+    if (DSP_TEST_CPU(kCpuHasNEON)) CbAugSums = cbAugSums_NEON;
+#endif
+
+    CbAugSums(target, aug, ilow, crossDot, energy);
+}
+
+void cbFilter(float *in, int n, float *out)
+{
+    void (*CbFilter)(float *, int, float *) = cbFilter_C;
+
+#if defined(DSP_HAS_SSE2)
+    if (DSP_TEST_CPU(kCpuHasSSE2)) CbFilter = cbFilter_SSE2;
+#endif
+#if defined(DSP_HAS_AVX2)
+    if (DSP_TEST_CPU(kCpuHasAVX2)) CbFilter = cbFilter_AVX2;
+#endif
+#if defined(DSP_HAS_NEON)
+    if (DSP_TEST_CPU(kCpuHasNEON)) CbFilter = cbFilter_NEON;
+#endif
+
+    CbFilter(in, n, out);
+}
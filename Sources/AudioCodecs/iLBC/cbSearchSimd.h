@@ -0,0 +1,91 @@
+/******************************************************************
+
+    iLBC Speech Coder ANSI-C Source Code
+
+    cbSearchSimd.h
+
+    SIMD kernels of the codebook search (iCBSearch.c, createCB.c)
+
+******************************************************************/
+
+/*
+   The kernels compute one lag (or one output sample) per vector
+   lane and add the products in the same order as the reference
+   loops, with separate multiplies and adds. The C, SSE2, AVX2 and
+   NEON versions give the same floats, so the bitstream does not
+   depend on the instruction set (as long as the compiler does not
+   contract the reference loops into fused multiply-adds). The _C
+   functions are the reference; cbCorr(), cbInvEnergy(),
+   cbAugSums() and cbFilter() pick the best kernel with
+   DSP_TEST_CPU.
+*/
+
+#ifndef __iLBC_CBSEARCHSIMD_H
+#define __iLBC_CBSEARCHSIMD_H
+
+#include "../Dsp/dsp_cpu.h"
+
+#define CB_AUGLANES     24  /* lanes of the augmented vector
+                               matrix, >= 20 and a multiple of 8 */
+
+/*----------------------------------------------------------------*
+ *  corr[k] = sum_{j=0}^{n-1} target[j]*cb[j-k], k = 0..lags-1
+ *  cb[] must be readable from cb[-(lags-1)].
+ *---------------------------------------------------------------*/
+
+void cbCorr(float *target, float *cb, int n, int lags, float *corr);
+void cbCorr_C(float *target, float *cb, int n, int lags, float *corr);
+
+/*----------------------------------------------------------------*
+ *  invenergy[k] = 1/(energy[k]+EPS) if energy[k] > 0, 0 otherwise
+ *---------------------------------------------------------------*/
+
+void cbInvEnergy(float *energy, int n, float *invenergy);
+void cbInvEnergy_C(float *energy, int n, float *invenergy);
+
+/*----------------------------------------------------------------*
+ *  Cross dot products and energies of the augmented vectors,
+ *  aug[j*CB_AUGLANES+k] is sample j of vector k :
+ *    crossDot[k] = sum_{j=0}^{SUBL-1} target[j]*aug[j][k]
+ *    energy[k] += sum_{j=ilow+k}^{SUBL-1} aug[j][k]^2
+ *  for k = 0..CB_AUGLANES-1.
+ *---------------------------------------------------------------*/
+
+void cbAugSums(float *target, float *aug, int ilow, float *crossDot,
+    float *energy);
+void cbAugSums_C(float *target, float *aug, int ilow, float *crossDot,
+    float *energy);
+
+/*----------------------------------------------------------------*
+ *  out[k] = sum_{j=0}^{CB_FILTERLEN-1} in[k+j]*cbfiltersTbl[
+ *  CB_FILTERLEN-1-j], k = 0..n-1
+ *---------------------------------------------------------------*/
+
+void cbFilter(float *in, int n, float *out);
+void cbFilter_C(float *in, int n, float *out);
+
+#if defined(DSP_HAS_SSE2)
+void cbCorr_SSE2(float *target, float *cb, int n, int lags, float *corr);
+void cbInvEnergy_SSE2(float *energy, int n, float *invenergy);
+void cbAugSums_SSE2(float *target, float *aug, int ilow, float *crossDot,
+    float *energy);
+void cbFilter_SSE2(float *in, int n, float *out);
+#endif
+
+#if defined(DSP_HAS_AVX2)
+void cbCorr_AVX2(float *target, float *cb, int n, int lags, float *corr);
+void cbInvEnergy_AVX2(float *energy, int n, float *invenergy);
+void cbAugSums_AVX2(float *target, float *aug, int ilow, float *crossDot,
+    float *energy);
+void cbFilter_AVX2(float *in, int n, float *out);
+#endif
+
+#if defined(DSP_HAS_NEON)
+void cbCorr_NEON(float *target, float *cb, int n, int lags, float *corr);
+void cbInvEnergy_NEON(float *energy, int n, float *invenergy);
+void cbAugSums_NEON(float *target, float *aug, int ilow, float *crossDot,
+    float *energy);
+void cbFilter_NEON(float *in, int n, float *out);
+#endif
+
+#endif
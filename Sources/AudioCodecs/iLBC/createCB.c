@@ -11,6 +11,7 @@
 
 #include "iLBC_define.h"
 #include "constants.h"
+#include "cbSearchSimd.h"
 #include <string.h>
 #include <math.h>
 
@@ -27,10 +28,7 @@ void filteredCBvecs(
                                vector from */
     int lMem        	/* (i) Length of buffer */
 ){
-    int j, k;
-    float *pp, *pp1;
     float tempbuff2[CB_MEML+CB_FILTERLEN];
-    float *pos;
 
     memset(tempbuff2, 0, (CB_HALFFILTERLEN-1)*sizeof(float));
     memcpy(&tempbuff2[CB_HALFFILTERLEN-1], mem, lMem*sizeof(float));
@@ -40,16 +38,7 @@ void filteredCBvecs(
     /* Create codebook vector for higher section by filtering */
 
     /* do filtering */
-    pos=cbvectors;
-    memset(pos, 0, lMem*sizeof(float));
-    for (k=0; k<lMem; k++) {
-        pp=&tempbuff2[k];
-        pp1=&cbfiltersTbl[CB_FILTERLEN-1];
-        for (j=0;j<CB_FILTERLEN;j++) {
-            (*pos)+=(*pp++)*(*pp1--);
-        }
-        pos++;
-    }
+    cbFilter(tempbuff2, lMem, cbvectors);
 }
 
 /*----------------------------------------------------------------*
@@ -74,10 +63,16 @@ void searchAugmentedCB(
     float *invenergy	/* (o) Inv energy of augmented codebook
                                vectors */
 ) {
-    int icount, ilow, j, tmpIndex;
-    float *pp, *ppo, *ppi, *ppe, crossDot, alfa;
+    int icount, ilow, j, k, tmpIndex, lags;
+    float *pp, *ppo, *ppi, *ppe, alfa;
     float weighted, measure, nrjRecursive;
     float ftmp;
+    float aug[SUBL*CB_AUGLANES] DSP_ALIGNED(32);
+    float crossDot[CB_AUGLANES], nrj[CB_AUGLANES];
+
+    lags = high-low+1;
+    memset(aug, 0, sizeof(aug));
+    memset(nrj, 0, sizeof(nrj));
 
     /* Compute the energy for the first (low-5)
        noninterpolated samples */
@@ -89,27 +84,23 @@ void searchAugmentedCB(
     }
     ppe = buffer - low;
 
+    /* Build the codebook vectors, vector k in column k */
 
-    for (icount=low; icount<=high; icount++) {
-
-        /* Index of the codebook vector used for retrieving
-           energy values */
-        tmpIndex = startIndex+icount-20;
+    for (k=0, icount=low; icount<=high; k++, icount++) {
 
         ilow = icount-4;
 
-        /* Update the energy recursively to save complexity */
+        /* Update the energy recursively to save complexity,
+           the sums below add the interpolated part and the
+           remaining samples */
         nrjRecursive = nrjRecursive + (*ppe)*(*ppe);
         ppe--;
-        energy[tmpIndex] = nrjRecursive;
+        nrj[k] = nrjRecursive;
 
-        /* Compute cross dot product for the first (low-5)
-           samples */
-
-        crossDot = (float) 0.0;
+        /* the first noninterpolated samples */
         pp = buffer-icount;
         for (j=0; j<ilow; j++) {
-            crossDot += target[j]*(*pp++);
+            aug[j*CB_AUGLANES+k] = *pp++;
         }
 
         /* interpolation */
@@ -120,38 +111,44 @@ void searchAugmentedCB(
             weighted = ((float)1.0-alfa)*(*ppo)+alfa*(*ppi);
             ppo++;
             ppi++;
-            energy[tmpIndex] += weighted*weighted;
-            crossDot += target[j]*weighted;
+            aug[j*CB_AUGLANES+k] = weighted;
             alfa += (float)0.2;
         }
 
-        /* Compute energy and cross dot product for the
-           remaining samples */
+        /* the remaining samples */
         pp = buffer - icount;
         for (j=icount; j<SUBL; j++) {
-            energy[tmpIndex] += (*pp)*(*pp);
-            crossDot += target[j]*(*pp++);
+            aug[j*CB_AUGLANES+k] = *pp++;
         }
+    }
 
-        if (energy[tmpIndex]>0.0) {
-            invenergy[tmpIndex]=(float)1.0/(energy[tmpIndex]+EPS);
-        } else {
-            invenergy[tmpIndex] = (float) 0.0;
-        }
+    /* Cross dot products and energies of all vectors */
+
+    cbAugSums(target, aug, low-4, crossDot, nrj);
+
+    tmpIndex = startIndex+low-20;
+    memcpy(&energy[tmpIndex], nrj, lags*sizeof(float));
+    cbInvEnergy(&energy[tmpIndex], lags, &invenergy[tmpIndex]);
+
+    for (k=0, icount=low; icount<=high; k++, icount++) {
+
+        /* Index of the codebook vector used for retrieving
+           energy values */
+        tmpIndex = startIndex+icount-20;
 
         if (stage==0) {
             measure = (float)-10000000.0;
 
-            if (crossDot > 0.0) {
-                measure = crossDot*crossDot*invenergy[tmpIndex];
+            if (crossDot[k] > 0.0) {
+                measure = crossDot[k]*crossDot[k]*invenergy[tmpIndex];
             }
         }
         else {
-            measure = crossDot*crossDot*invenergy[tmpIndex];
+            measure = crossDot[k]*crossDot[k]*invenergy[tmpIndex];
         }
 
         /* check if measure is better */
-        ftmp = crossDot*invenergy[tmpIndex];
+        ftmp = crossDot[k]*invenergy[tmpIndex];
 
         if ((measure>*max_measure) && (fabs(ftmp)<CB_MAXGAIN)) {
             *best_index = tmpIndex;
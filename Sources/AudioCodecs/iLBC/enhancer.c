@@ -14,6 +14,7 @@
 #include "iLBC_define.h"
 #include "constants.h"
 #include "filter.h"
+#include "enhancerSimd.h"
 
 /*----------------------------------------------------------------*
  * Find index in array such that the array element with said
@@ -55,14 +56,19 @@ void mycorr1(
     const float *seq2,  /* (i) second sequence */
     int dim2        	/* (i) dimension seq2 */
 ){
-    int i,j;
-
-    for (i=0; i<=dim1-dim2; i++) {
-        corr[i]=0.0;
-        for (j=0; j<dim2; j++) {
-            corr[i] += seq1[i+j] * seq2[j];
-        }
-    }
+    enh_corr_fn Corr = enh_corr_C;
+
+#if defined(DSP_HAS_SSE2)
+    if (DSP_TEST_CPU(kCpuHasSSE2)) Corr = enh_corr_SSE2;
+#endif
+#if defined(DSP_HAS_AVX2)
+    if (DSP_TEST_CPU(kCpuHasAVX2)) Corr = enh_corr_AVX2;
+#endif
+#if defined(DSP_HAS_NEON)
+    if (DSP_TEST_CPU(kCpuHasNEON)) Corr = enh_corr_NEON;
+#endif
+
+    Corr(corr, seq1, dim1, seq2, dim2);
 }
 
 /*----------------------------------------------------------------*
@@ -75,10 +81,18 @@ void enh_upsample(
     int dim1,       /* (i) dimension seq1 */
     int hfl         /* (i) polyphase filter length=2*hfl+1 */
 ){
-    float *pu,*ps;
+    float *pu;
     int i,j,k,q,filterlength,hfl2;
     const float *polyp[ENH_UPS0]; /* pointers to polyphase columns */
-    const float *pp;
+    float polyT[(2*ENH_FL0+1)*ENH_UPS0]; /* phases interleaved */
+    enh_ups4_fn Ups4 = enh_ups4_C;
+
+#if defined(DSP_HAS_SSE2)
+    if (DSP_TEST_CPU(kCpuHasSSE2)) Ups4 = enh_ups4_SSE2;
+#endif
+#if defined(DSP_HAS_NEON)
+    if (DSP_TEST_CPU(kCpuHasNEON)) Ups4 = enh_ups4_NEON;
+#endif
 
     /* define pointers for filter */
 
@@ -98,47 +112,32 @@ void enh_upsample(
         }
     }
 
+    for (k=0; k<filterlength; k++) {
+        for (j=0; j<ENH_UPS0; j++) {
+            polyT[k*ENH_UPS0+j]=polyp[j][k];
+        }
+    }
+
     /* filtering: filter overhangs left side of sequence */
 
     pu=useq1;
     for (i=hfl; i<filterlength; i++) {
-        for (j=0; j<ENH_UPS0; j++) {
-            *pu=0.0;
-            pp = polyp[j];
-            ps = seq1+i;
-            for (k=0; k<=i; k++) {
-                *pu += *ps-- * *pp++;
-            }
-            pu++;
-        }
+        Ups4(pu, seq1+i, polyT, i+1);
+        pu+=ENH_UPS0;
     }
 
     /* filtering: simple convolution=inner products */
 
     for (i=filterlength; i<dim1; i++) {
-        for (j=0;j<ENH_UPS0; j++){
-            *pu=0.0;
-            pp = polyp[j];
-            ps = seq1+i;
-            for (k=0; k<filterlength; k++) {
-                *pu += *ps-- * *pp++;
-            }
-            pu++;
-        }
+        Ups4(pu, seq1+i, polyT, filterlength);
+        pu+=ENH_UPS0;
     }
 
     /* filtering: filter overhangs right side of sequence */
 
     for (q=1; q<=hfl; q++) {
-        for (j=0; j<ENH_UPS0; j++) {
-            *pu=0.0;
-            pp = polyp[j]+q;
-            ps = seq1+dim1-1;
-            for (k=0; k<filterlength-q; k++) {
-                *pu += *ps-- * *pp++;
-            }
-            pu++;
-        }
+        Ups4(pu, seq1+dim1-1, polyT+q*ENH_UPS0, filterlength-q);
+        pu+=ENH_UPS0;
     }
 }
 
@@ -0,0 +1,151 @@
+/******************************************************************
+
+    iLBC Speech Coder ANSI-C Source Code
+
+    enhancerSimd.c
+
+    SIMD kernels of the enhancer (see enhancerSimd.h)
+
+******************************************************************/
+
+#include "iLBC_define.h"
+#include "enhancerSimd.h"
+
+/*----------------------------------------------------------------*
+ *  Reference kernels
+ *---------------------------------------------------------------*/
+
+void enh_corr_C(
+    float* corr,        /* (o) correlation of seq1 and seq2 */
+    float* seq1,        /* (i) first sequence */
+    int dim1,           /* (i) dimension first seq1 */
+    const float *seq2,  /* (i) second sequence */
+    int dim2            /* (i) dimension seq2 */
+){
+    int i,j;
+
+    for (i=0; i<=dim1-dim2; i++) {
+        corr[i]=0.0;
+        for (j=0; j<dim2; j++) {
+            corr[i] += seq1[i+j] * seq2[j];
+        }
+    }
+}
+
+void enh_ups4_C(
+    float *pu,          /* (o) ENH_UPS0 upsampled samples */
+    float *ps,          /* (i) last input sample of the filter */
+    const float *polyT, /* (i) interleaved polyphase filters */
+    int taps            /* (i) number of filter taps used */
+){
+    int k,q;
+
+    for (q=0; q<ENH_UPS0; q++) {
+        pu[q]=0.0;
+        for (k=0; k<taps; k++) {
+            pu[q] += ps[-k] * polyT[k*ENH_UPS0+q];
+        }
+    }
+}
+
+/*----------------------------------------------------------------*
+ *  SSE2 : 4 correlation lags per vector, the lanes load
+ *  seq1[i+j .. i+j+3] and share seq2[j].
+ *---------------------------------------------------------------*/
+
+#if defined(DSP_HAS_SSE2)
+void enh_corr_SSE2(float *corr, float *seq1, int dim1,
+    const float *seq2, int dim2)
+{
+    int i,j,n;
+
+    n=dim1-dim2+1;
+    for (i=0; i+4<=n; i+=4) {
+        __m128 s = _mm_setzero_ps();
+        for (j=0; j<dim2; j++) {
+            s = _mm_add_ps(s, _mm_mul_ps(_mm_loadu_ps(seq1+i+j),
+                _mm_set1_ps(seq2[j])));
+        }
+        _mm_storeu_ps(corr+i, s);
+    }
+    if (i<n) {
+        enh_corr_C(corr+i, seq1+i, dim1-i, seq2, dim2);
+    }
+}
+
+void enh_ups4_SSE2(float *pu, float *ps, const float *polyT, int taps)
+{
+    __m128 s = _mm_setzero_ps();
+    int k;
+
+    for (k=0; k<taps; k++) {
+        s = _mm_add_ps(s, _mm_mul_ps(_mm_set1_ps(ps[-k]),
+            _mm_loadu_ps(polyT+k*ENH_UPS0)));
+    }
+    _mm_storeu_ps(pu, s);
+}
+#endif
+
+#if defined(DSP_HAS_AVX2)
+DSP_TARGET_AVX2
+void enh_corr_AVX2(float *corr, float *seq1, int dim1,
+    const float *seq2, int dim2)
+{
+    int i,j,n;
+
+    n=dim1-dim2+1;
+    for (i=0; i+8<=n; i+=8) {
+        __m256 s = _mm256_setzero_ps();
+        for (j=0; j<dim2; j++) {
+            s = _mm256_add_ps(s, _mm256_mul_ps(_mm256_loadu_ps(seq1+i+j),
+                _mm256_set1_ps(seq2[j])));
+        }
+        _mm256_storeu_ps(corr+i, s);
+    }
+    for (; i+4<=n; i+=4) {
+        __m128 s = _mm_setzero_ps();
+        for (j=0; j<dim2; j++) {
+            s = _mm_add_ps(s, _mm_mul_ps(_mm_loadu_ps(seq1+i+j),
+                _mm_set1_ps(seq2[j])));
+        }
+        _mm_storeu_ps(corr+i, s);
+    }
+    _mm256_zeroupper();
+    if (i<n) {
+        enh_corr_C(corr+i, seq1+i, dim1-i, seq2, dim2);
+    }
+}
+#endif
+
+#if defined(DSP_HAS_NEON)
+void enh_corr_NEON(float *corr, float *seq1, int dim1,
+    const float *seq2, int dim2)
+{
+    int i,j,n;
+
+    n=dim1-dim2+1;
+    for (i=0; i+4<=n; i+=4) {
+        float32x4_t s = vdupq_n_f32(0.0f);
+        for (j=0; j<dim2; j++) {
+            s = vaddq_f32(s, vmulq_f32(vld1q_f32(seq1+i+j),
+                vdupq_n_f32(seq2[j])));
+        }
+        vst1q_f32(corr+i, s);
+    }
+    if (i<n) {
+        enh_corr_C(corr+i, seq1+i, dim1-i, seq2, dim2);
+    }
+}
+
+void enh_ups4_NEON(float *pu, float *ps, const float *polyT, int taps)
+{
+    float32x4_t s = vdupq_n_f32(0.0f);
+    int k;
+
+    for (k=0; k<taps; k++) {
+        s = vaddq_f32(s, vmulq_f32(vdupq_n_f32(ps[-k]),
+            vld1q_f32(polyT+k*ENH_UPS0)));
+    }
+    vst1q_f32(pu, s);
+}
+#endif
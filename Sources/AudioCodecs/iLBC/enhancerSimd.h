@@ -0,0 +1,64 @@
+/******************************************************************
+
+    iLBC Speech Coder ANSI-C Source Code
+
+    enhancerSimd.h
+
+    SIMD kernels of the enhancer (enhancer.c)
+
+******************************************************************/
+
+/*
+   mycorr1() and enh_upsample() pick a kernel with DSP_TEST_CPU and
+   call it through the function types below. The kernels compute
+   one output per lane and add the products in the reference order,
+   with separate multiplies and adds: the enhanced signal is the
+   same on every instruction set. enh_ups4 has 4 lanes only, the
+   AVX2 machines use the SSE2 version.
+*/
+
+#ifndef __iLBC_ENHANCERSIMD_H
+#define __iLBC_ENHANCERSIMD_H
+
+#include "../Dsp/dsp_cpu.h"
+
+/*----------------------------------------------------------------*
+ *  corr[i] = sum_{j=0}^{dim2-1} seq1[i+j]*seq2[j],
+ *  i = 0..dim1-dim2
+ *---------------------------------------------------------------*/
+
+typedef void (*enh_corr_fn)(float *corr, float *seq1, int dim1,
+    const float *seq2, int dim2);
+
+void enh_corr_C(float *corr, float *seq1, int dim1,
+    const float *seq2, int dim2);
+
+/*----------------------------------------------------------------*
+ *  The ENH_UPS0 phases of one upsampled sample,
+ *  pu[q] = sum_{k=0}^{taps-1} ps[-k]*polyT[k*ENH_UPS0+q]
+ *  polyT holds the polyphase filters interleaved by phase.
+ *---------------------------------------------------------------*/
+
+typedef void (*enh_ups4_fn)(float *pu, float *ps, const float *polyT,
+    int taps);
+
+void enh_ups4_C(float *pu, float *ps, const float *polyT, int taps);
+
+#if defined(DSP_HAS_SSE2)
+void enh_corr_SSE2(float *corr, float *seq1, int dim1,
+    const float *seq2, int dim2);
+void enh_ups4_SSE2(float *pu, float *ps, const float *polyT, int taps);
+#endif
+
+#if defined(DSP_HAS_AVX2)
+void enh_corr_AVX2(float *corr, float *seq1, int dim1,
+    const float *seq2, int dim2);
+#endif
+
+#if defined(DSP_HAS_NEON)
+void enh_corr_NEON(float *corr, float *seq1, int dim1,
+    const float *seq2, int dim2);
+void enh_ups4_NEON(float *pu, float *ps, const float *polyT, int taps);
+#endif
+
+#endif
@@ -0,0 +1,280 @@
+/******************************************************************
+
+    iLBC Speech Coder ANSI-C Source Code
+
+    LPCFix.c
+
+    Fixed point LPC analysis, quantization and interpolation
+    (LPCencode.c, LPCdecode.c)
+
+******************************************************************/
+
+#include <string.h>
+
+#include "iLBC_defineFix.h"
+#include "constantsFix.h"
+#include "helpfunFix.h"
+#include "lsfFix.h"
+#include "LPCFix.h"
+#include "../constants.h"
+
+/*----------------------------------------------------------------*
+ *  lpc analysis (subrutine to LPCencodeFix)
+ *---------------------------------------------------------------*/
+
+static void SimpleAnalysisFix(
+    int16_t *lsf,       /* (o) lsf coefficients */
+    const int16_t *data,/* (i) new data vector */
+    iLBCfix_Enc_Inst_t *iLBCenc_inst
+                        /* (i/o) the encoder state structure */
+){
+    int k, i, is;
+    int16_t temp[BLOCKL_MAX];
+    const int16_t *win, *x;
+    int32_t r[LPC_FILTERORDER + 1], lp[LPC_FILTERORDER + 1];
+
+    is=LPC_LOOKBACK+BLOCKL_MAX-iLBCenc_inst->blockl;
+    memcpy(iLBCenc_inst->lpc_buffer+is,data,
+        iLBCenc_inst->blockl*sizeof(int16_t));
+
+    /* No lookahead, last window is asymmetric */
+
+    for (k = 0; k < iLBCenc_inst->lpc_n; k++) {
+
+        if (k < (iLBCenc_inst->lpc_n - 1)) {
+            win = lpc_winTblFix;
+            x = iLBCenc_inst->lpc_buffer;
+        } else {
+            win = lpc_asymwinTblFix;
+            x = iLBCenc_inst->lpc_buffer + LPC_LOOKBACK;
+        }
+        for (i = 0; i < BLOCKL_MAX; i++) {
+            temp[i] = (int16_t)(((int32_t)x[i] * win[i] + 16384) >> 15);
+        }
+
+        autocorrFix(r, temp, BLOCKL_MAX, LPC_FILTERORDER);
+
+        /* lag window, the white noise correction is in lag 0 */
+
+        for (i = 0; i <= LPC_FILTERORDER; i++) {
+            r[i] = (int32_t)(((int64_t)r[i] * lpc_lagwinTblFix[i]) >> 30);
+        }
+
+        levdurbFix(lp, r, LPC_FILTERORDER);
+
+        /* bandwidth expansion in Q24 */
+
+        for (i = 1; i <= LPC_FILTERORDER; i++) {
+            lp[i] = (int32_t)(((int64_t)lp[i] * chirp_syntdenumTblFix[i] +
+                16384) >> 15);
+        }
+
+        a2lsfFix(lsf + k*LPC_FILTERORDER, lp);
+    }
+
+    is=LPC_LOOKBACK+BLOCKL_MAX-iLBCenc_inst->blockl;
+    memmove(iLBCenc_inst->lpc_buffer,
+        iLBCenc_inst->lpc_buffer+LPC_LOOKBACK+BLOCKL_MAX-is,
+        is*sizeof(int16_t));
+}
+
+/*----------------------------------------------------------------*
+ *  lsf interpolator and conversion from lsf to a coefficients
+ *---------------------------------------------------------------*/
+
+static void LSFinterpolate2aFix(
+    int16_t *a,         /* (o) lpc coefficients, Q12 */
+    const int16_t *lsf1,/* (i) first set of lsf coefficients */
+    const int16_t *lsf2,/* (i) second set of lsf coefficients */
+    int16_t coef        /* (i) weight of lsf1, Q14 */
+){
+    int16_t lsftmp[LPC_FILTERORDER];
+
+    interpolateFix(lsftmp, lsf1, lsf2, coef, LPC_FILTERORDER);
+    lsf2aFix(a, lsftmp);
+}
+
+/*----------------------------------------------------------------*
+ *  lsf interpolator (subrutine to LPCencodeFix)
+ *---------------------------------------------------------------*/
+
+static void SimpleInterpolateLSFFix(
+    int16_t *syntdenum, /* (o) the synthesis filter denominator
+                               resulting from the quantized
+                               interpolated lsf */
+    int16_t *weightdenum,/* (o) the weighting filter denominator
+                               resulting from the unquantized
+                               interpolated lsf */
+    const int16_t *lsf, /* (i) the unquantized lsf coefficients */
+    const int16_t *lsfdeq,/* (i) the dequantized lsf coefficients */
+    iLBCfix_Enc_Inst_t *iLBCenc_inst
+                        /* (i/o) the encoder state structure */
+){
+    int i, pos, lp_length;
+    int16_t lp[LPC_FILTERORDER + 1];
+    const int16_t *lsf2, *lsfdeq2, *weights;
+
+    lsf2 = lsf + LPC_FILTERORDER;
+    lsfdeq2 = lsfdeq + LPC_FILTERORDER;
+    lp_length = LPC_FILTERORDER + 1;
+
+    if (iLBCenc_inst->mode==30) {
+
+        /* sub-frame 1: Interpolation between old and first
+           set of lsf coefficients */
+
+        LSFinterpolate2aFix(lp, iLBCenc_inst->lsfdeqold, lsfdeq,
+            lsf_weightTbl_30msFix[0]);
+        memcpy(syntdenum,lp,lp_length*sizeof(int16_t));
+        LSFinterpolate2aFix(lp, iLBCenc_inst->lsfold, lsf,
+            lsf_weightTbl_30msFix[0]);
+        bwexpandFix(weightdenum, lp, chirp_weightdenumTblFix, lp_length);
+
+        /* sub-frame 2 to 6: Interpolation between first
+           and second set of lsf coefficients */
+
+        pos = lp_length;
+        for (i = 1; i < iLBCenc_inst->nsub; i++) {
+            LSFinterpolate2aFix(lp, lsfdeq, lsfdeq2,
+                lsf_weightTbl_30msFix[i]);
+            memcpy(syntdenum + pos,lp,lp_length*sizeof(int16_t));
+
+            LSFinterpolate2aFix(lp, lsf, lsf2,
+                lsf_weightTbl_30msFix[i]);
+            bwexpandFix(weightdenum + pos, lp,
+                chirp_weightdenumTblFix, lp_length);
+            pos += lp_length;
+        }
+
+        memcpy(iLBCenc_inst->lsfold, lsf2,
+            LPC_FILTERORDER*sizeof(int16_t));
+        memcpy(iLBCenc_inst->lsfdeqold, lsfdeq2,
+            LPC_FILTERORDER*sizeof(int16_t));
+    }
+    else {
+        weights = lsf_weightTbl_20msFix;
+        pos = 0;
+        for (i = 0; i < iLBCenc_inst->nsub; i++) {
+            LSFinterpolate2aFix(lp, iLBCenc_inst->lsfdeqold, lsfdeq,
+                weights[i]);
+            memcpy(syntdenum+pos,lp,lp_length*sizeof(int16_t));
+            LSFinterpolate2aFix(lp, iLBCenc_inst->lsfold, lsf,
+                weights[i]);
+            bwexpandFix(weightdenum+pos, lp,
+                chirp_weightdenumTblFix, lp_length);
+            pos += lp_length;
+        }
+
+        memcpy(iLBCenc_inst->lsfold, lsf,
+            LPC_FILTERORDER*sizeof(int16_t));
+        memcpy(iLBCenc_inst->lsfdeqold, lsfdeq,
+            LPC_FILTERORDER*sizeof(int16_t));
+    }
+}
+
+/*----------------------------------------------------------------*
+ *  lpc encoder
+ *---------------------------------------------------------------*/
+
+void LPCencodeFix(
+    int16_t *syntdenum, /* (o) synthesis filter coefficients, Q12 */
+    int16_t *weightdenum,/* (o) weighting denumerator coefficients,
+                               Q12 */
+    int *lsf_index,     /* (o) lsf quantization index */
+    const int16_t *data,/* (i) speech to analyse */
+    iLBCfix_Enc_Inst_t *iLBCenc_inst
+                        /* (i/o) the encoder state structure */
+){
+    int16_t lsf[LPC_FILTERORDER * LPC_N_MAX];
+    int16_t lsfdeq[LPC_FILTERORDER * LPC_N_MAX];
+
+    SimpleAnalysisFix(lsf, data, iLBCenc_inst);
+
+    /* Quantize the LSF with memoryless split VQ */
+
+    SplitVQFix(lsfdeq, lsf_index, lsf, lsfCbTblFix, LSF_NSPLIT,
+        dim_lsfCbTbl, size_lsfCbTbl);
+    if (iLBCenc_inst->lpc_n==2) {
+        SplitVQFix(lsfdeq + LPC_FILTERORDER, lsf_index + LSF_NSPLIT,
+            lsf + LPC_FILTERORDER, lsfCbTblFix, LSF_NSPLIT,
+            dim_lsfCbTbl, size_lsfCbTbl);
+    }
+
+    LSF_checkFix(lsfdeq, LPC_FILTERORDER, iLBCenc_inst->lpc_n);
+    SimpleInterpolateLSFFix(syntdenum, weightdenum,
+        lsf, lsfdeq, iLBCenc_inst);
+}
+
+/*---------------------------------------------------------------*
+ *  obtain dequantized lsf coefficients from quantization index
+ *--------------------------------------------------------------*/
+
+void SimplelsfDEQFix(
+    int16_t *lsfdeq,    /* (o) dequantized lsf coefficients, Q13 */
+    int *index,         /* (i) quantization index */
+    int lpc_n           /* (i) number of LPCs */
+){
+    int i, j, k, pos, cb_pos;
+
+    for (k = 0; k < lpc_n; k++) {
+        pos = 0;
+        cb_pos = 0;
+        for (i = 0; i < LSF_NSPLIT; i++) {
+            for (j = 0; j < dim_lsfCbTbl[i]; j++) {
+                lsfdeq[k*LPC_FILTERORDER + pos + j] = lsfCbTblFix[cb_pos +
+                    index[k*LSF_NSPLIT + i]*dim_lsfCbTbl[i] + j];
+            }
+            pos += dim_lsfCbTbl[i];
+            cb_pos += size_lsfCbTbl[i]*dim_lsfCbTbl[i];
+        }
+    }
+}
+
+/*----------------------------------------------------------------*
+ *  obtain synthesis filters from lsf coefficients
+ *---------------------------------------------------------------*/
+
+void DecoderInterpolateLSFFix(
+    int16_t *syntdenum, /* (o) synthesis filter coefficients, Q12 */
+    int16_t *lsfdeq,    /* (i) dequantized lsf coefficients */
+    iLBCfix_Dec_Inst_t *iLBCdec_inst
+                        /* (i/o) the decoder state structure */
+){
+    int i, pos, lp_length;
+    int16_t *lsfdeq2;
+
+    lsfdeq2 = lsfdeq + LPC_FILTERORDER;
+    lp_length = LPC_FILTERORDER + 1;
+
+    if (iLBCdec_inst->mode==30) {
+
+        /* sub-frame 1: Interpolation between old and first */
+
+        LSFinterpolate2aFix(syntdenum, iLBCdec_inst->lsfdeqold, lsfdeq,
+            lsf_weightTbl_30msFix[0]);
+
+        /* sub-frames 2 to 6: interpolation between first
+           and last LSF */
+
+        pos = lp_length;
+        for (i = 1; i < 6; i++) {
+            LSFinterpolate2aFix(syntdenum + pos, lsfdeq, lsfdeq2,
+                lsf_weightTbl_30msFix[i]);
+            pos += lp_length;
+        }
+
+        memcpy(iLBCdec_inst->lsfdeqold, lsfdeq2,
+            LPC_FILTERORDER*sizeof(int16_t));
+    }
+    else {
+        pos = 0;
+        for (i = 0; i < iLBCdec_inst->nsub; i++) {
+            LSFinterpolate2aFix(syntdenum+pos, iLBCdec_inst->lsfdeqold,
+                lsfdeq, lsf_weightTbl_20msFix[i]);
+            pos += lp_length;
+        }
+
+        memcpy(iLBCdec_inst->lsfdeqold, lsfdeq,
+            LPC_FILTERORDER*sizeof(int16_t));
+    }
+}
@@ -0,0 +1,39 @@
+/******************************************************************
+
+    iLBC Speech Coder ANSI-C Source Code
+
+    LPCFix.h
+
+    Fixed point LPC analysis, quantization and interpolation
+
+******************************************************************/
+
+#ifndef __iLBC_LPCFIX_H
+#define __iLBC_LPCFIX_H
+
+#include "iLBC_defineFix.h"
+
+void LPCencodeFix(
+    int16_t *syntdenum, /* (o) synthesis filter coefficients, Q12 */
+    int16_t *weightdenum,/* (o) weighting denumerator coefficients,
+                               Q12 */
+    int *lsf_index,     /* (o) lsf quantization index */
+    const int16_t *data,/* (i) speech to analyse */
+    iLBCfix_Enc_Inst_t *iLBCenc_inst
+                        /* (i/o) the encoder state structure */
+);
+
+void SimplelsfDEQFix(
+    int16_t *lsfdeq,    /* (o) dequantized lsf coefficients, Q13 */
+    int *index,         /* (i) quantization index */
+    int lpc_n           /* (i) number of LPCs */
+);
+
+void DecoderInterpolateLSFFix(
+    int16_t *syntdenum, /* (o) synthesis filter coefficients, Q12 */
+    int16_t *lsfdeq,    /* (i) dequantized lsf coefficients */
+    iLBCfix_Dec_Inst_t *iLBCdec_inst
+                        /* (i/o) the decoder state structure */
+);
+
+#endif
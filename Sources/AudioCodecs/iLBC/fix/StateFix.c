@@ -0,0 +1,268 @@
+/******************************************************************
+
+    iLBC Speech Coder ANSI-C Source Code
+
+    StateFix.c
+
+    Fixed point start state encoding and decoding
+    (StateSearchW.c, StateConstructW.c)
+
+******************************************************************/
+
+#include <string.h>
+
+#include "iLBC_defineFix.h"
+#include "constantsFix.h"
+#include "helpfunFix.h"
+#include "StateFix.h"
+
+/* bits of the start state residual in the all-pass filtering, leaves
+   room for the gain of the filter before the int16 saturation */
+#define STATE_FILT_BITS     10
+
+/*----------------------------------------------------------------*
+ *  predictive noise shaping encoding of scaled start state
+ *  (subrutine for StateSearchWFix)
+ *---------------------------------------------------------------*/
+
+static void AbsQuantWFix(
+    iLBCfix_Enc_Inst_t *iLBCenc_inst,
+                        /* (i) Encoder instance */
+    int16_t *in,        /* (i) vector to encode, Q11, in[-10..-1]
+                               must be zero */
+    const int16_t *syntDenum,/* (i) denominator of synthesis filter */
+    const int16_t *weightDenum,/* (i) denominator of weighting
+                               filter */
+    int *out,           /* (o) vector of quantizer indexes */
+    int len,            /* (i) length of vector to encode and
+                               vector of quantizer indexes */
+    int state_first     /* (i) position of start state in the
+                               80 vec */
+){
+    int16_t *syntOut;
+    int16_t syntOutBuf[LPC_FILTERORDER+STATE_SHORT_LEN_30MS];
+    int16_t toQ;
+    int n;
+    int index;
+
+    /* initialization of buffer for filtering */
+
+    memset(syntOutBuf, 0, LPC_FILTERORDER*sizeof(int16_t));
+
+    /* initialization of pointer for filtering */
+
+    syntOut = &syntOutBuf[LPC_FILTERORDER];
+
+    /* synthesis and weighting filters on input */
+
+    if (state_first) {
+        AllPoleFilterFix(in, weightDenum, SUBL, LPC_FILTERORDER);
+    } else {
+        AllPoleFilterFix(in, weightDenum,
+            iLBCenc_inst->state_short_len-SUBL,
+            LPC_FILTERORDER);
+    }
+
+    /* encoding loop */
+
+    for (n=0; n<len; n++) {
+
+        /* time update of filter coefficients */
+
+        if ((state_first)&&(n==SUBL)){
+            syntDenum += (LPC_FILTERORDER+1);
+            weightDenum += (LPC_FILTERORDER+1);
+
+            /* synthesis and weighting filters on input */
+            AllPoleFilterFix(&in[n], weightDenum, len-n,
+                LPC_FILTERORDER);
+
+        } else if ((state_first==0)&&
+            (n==(iLBCenc_inst->state_short_len-SUBL))) {
+            syntDenum += (LPC_FILTERORDER+1);
+            weightDenum += (LPC_FILTERORDER+1);
+
+            /* synthesis and weighting filters on input */
+            AllPoleFilterFix(&in[n], weightDenum, len-n,
+                LPC_FILTERORDER);
+
+        }
+
+        /* prediction of synthesized and weighted input */
+
+        syntOut[n] = 0;
+        AllPoleFilterFix(&syntOut[n], weightDenum, 1,
+            LPC_FILTERORDER);
+
+        /* quantization, the index is the number of decision
+           levels below the value */
+
+        toQ = sat16((int32_t)in[n]-syntOut[n]);
+
+        index = 0;
+        while (index < 7 && toQ > state_sq3MidTblFix[index]) {
+            index++;
+        }
+        out[n]=index;
+        syntOut[n] = state_sq3TblFix[index];
+
+        /* update of the prediction filter */
+
+        AllPoleFilterFix(&syntOut[n], weightDenum, 1,
+            LPC_FILTERORDER);
+    }
+}
+
+/*----------------------------------------------------------------*
+ *  encoding of start state
+ *---------------------------------------------------------------*/
+
+void StateSearchWFix(
+    iLBCfix_Enc_Inst_t *iLBCenc_inst,
+                        /* (i) Encoder instance */
+    const int16_t *residual,/* (i) target residual vector */
+    const int16_t *syntDenum,/* (i) lpc synthesis filter, Q12 */
+    const int16_t *weightDenum,/* (i) weighting filter denuminator,
+                               Q12 */
+    int *idxForMax,     /* (o) quantizer index for maximum
+                               amplitude */
+    int *idxVec,        /* (o) vector of quantization indexes */
+    int len,            /* (i) length of all vectors */
+    int state_first     /* (i) position of start state in the
+                               80 vec */
+){
+    int16_t tmpbuf[LPC_FILTERORDER+2*STATE_SHORT_LEN_30MS];
+    int16_t *tmp, numerator[1+LPC_FILTERORDER];
+    int16_t foutbuf[LPC_FILTERORDER+2*STATE_SHORT_LEN_30MS], *fout;
+    int32_t maxVal, scal;
+    int k, sh;
+
+    /* initialization of buffers and filter coefficients */
+
+    memset(tmpbuf, 0, LPC_FILTERORDER*sizeof(int16_t));
+    memset(foutbuf, 0, LPC_FILTERORDER*sizeof(int16_t));
+    for (k=0; k<LPC_FILTERORDER; k++) {
+        numerator[k]=syntDenum[LPC_FILTERORDER-k];
+    }
+    numerator[LPC_FILTERORDER]=syntDenum[0];
+    tmp = &tmpbuf[LPC_FILTERORDER];
+    fout = &foutbuf[LPC_FILTERORDER];
+
+    /* scale the residual to STATE_FILT_BITS, the filtered vector
+       is then fout*2^sh */
+
+    sh = bitsFix((uint32_t)maxAbsFix(residual, len)) - STATE_FILT_BITS;
+    shiftFix(tmp, residual, len, sh);
+
+    /* circular convolution with the all-pass filter */
+
+    memset(tmp+len, 0, len*sizeof(int16_t));
+    ZeroPoleFilterFix(tmp, numerator, syntDenum, 2*len,
+        LPC_FILTERORDER, fout);
+    for (k=0; k<len; k++) {
+        fout[k] = sat16((int32_t)fout[k] + fout[k+len]);
+    }
+
+    /* identification of the maximum amplitude value, in Q4 */
+
+    maxVal = maxAbsFix(fout, len);
+    if (sh + 4 >= 0) {
+        maxVal <<= sh + 4;
+    } else {
+        maxVal >>= -(sh + 4);
+    }
+
+    /* encoding of the maximum amplitude value, the decision levels
+       are in the linear domain */
+
+    if (maxVal < 160) {
+        maxVal = 160;
+    }
+    *idxForMax = 0;
+    while (*idxForMax < 63 &&
+        maxVal > state_frgqMidTblFix[*idxForMax]) {
+        (*idxForMax)++;
+    }
+
+    /* scaling of start state with 4.5/qmax to Q11 */
+
+    scal = state_frgqScalTblFix[*idxForMax];
+    for (k=0; k<len; k++){
+        fout[k] = sat16_64(((int64_t)fout[k] * scal +
+            ((int64_t)1 << (19 - sh))) >> (20 - sh));
+    }
+
+    /* predictive noise shaping encoding of scaled start state */
+
+    AbsQuantWFix(iLBCenc_inst, fout, syntDenum,
+        weightDenum, idxVec, len, state_first);
+}
+
+/*----------------------------------------------------------------*
+ *  decoding of the start state
+ *---------------------------------------------------------------*/
+
+void StateConstructWFix(
+    int idxForMax,      /* (i) 6-bit index for the quantization of
+                               max amplitude */
+    const int *idxVec,  /* (i) vector of quantization indexes */
+    const int16_t *syntDenum,/* (i) synthesis filter denumerator,
+                               Q12 */
+    int16_t *out,       /* (o) the decoded state vector */
+    int len             /* (i) length of a state vector */
+){
+    int16_t tmpbuf[LPC_FILTERORDER+2*STATE_LEN], *tmp,
+        numerator[LPC_FILTERORDER+1];
+    int16_t foutbuf[LPC_FILTERORDER+2*STATE_LEN], *fout;
+    int64_t maxVal, val[STATE_LEN], maxAbs;
+    int k, tmpi, sh;
+
+    /* decoding of the maximum value, qmax/4.5 in Q16 */
+
+    maxVal = state_frgqDeqTblFix[idxForMax];
+
+    /* initialization of buffers and coefficients */
+
+    memset(tmpbuf, 0, LPC_FILTERORDER*sizeof(int16_t));
+    memset(foutbuf, 0, LPC_FILTERORDER*sizeof(int16_t));
+    for (k=0; k<LPC_FILTERORDER; k++) {
+        numerator[k]=syntDenum[LPC_FILTERORDER-k];
+    }
+    numerator[LPC_FILTERORDER]=syntDenum[0];
+    tmp = &tmpbuf[LPC_FILTERORDER];
+    fout = &foutbuf[LPC_FILTERORDER];
+
+    /* decoding of the sample values in Q27 */
+
+    maxAbs = 0;
+    for (k=0; k<len; k++) {
+        tmpi = len-1-k;
+        val[k] = maxVal*state_sq3TblFix[idxVec[tmpi]];
+        if ((val[k] < 0 ? -val[k] : val[k]) > maxAbs) {
+            maxAbs = val[k] < 0 ? -val[k] : val[k];
+        }
+    }
+
+    /* the filtering runs on the samples scaled up by 2^sh to
+       STATE_FILT_BITS */
+
+    sh = STATE_FILT_BITS - bitsFix((uint32_t)(maxAbs >> 27));
+    for (k=0; k<len; k++) {
+        tmp[k] = sat16_64((val[k] + ((int64_t)1 << (26 - sh))) >>
+            (27 - sh));
+    }
+
+    /* circular convolution with all-pass filter */
+
+    memset(tmp+len, 0, len*sizeof(int16_t));
+    ZeroPoleFilterFix(tmp, numerator, syntDenum, 2*len,
+        LPC_FILTERORDER, fout);
+    for (k=0;k<len;k++) {
+        tmpi = (int32_t)fout[len-1-k] + fout[2*len-1-k];
+        if (sh >= 0) {
+            out[k] = sat16((tmpi + ((1 << sh) >> 1)) >> sh);
+        } else {
+            out[k] = sat16_64((int64_t)tmpi * ((int64_t)1 << -sh));
+        }
+    }
+}
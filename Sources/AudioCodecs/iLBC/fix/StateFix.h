@@ -0,0 +1,41 @@
+/******************************************************************
+
+    iLBC Speech Coder ANSI-C Source Code
+
+    StateFix.h
+
+    Fixed point start state encoding and decoding
+
+******************************************************************/
+
+#ifndef __iLBC_STATEFIX_H
+#define __iLBC_STATEFIX_H
+
+#include "iLBC_defineFix.h"
+
+void StateSearchWFix(
+    iLBCfix_Enc_Inst_t *iLBCenc_inst,
+                        /* (i) Encoder instance */
+    const int16_t *residual,/* (i) target residual vector */
+    const int16_t *syntDenum,/* (i) lpc synthesis filter, Q12 */
+    const int16_t *weightDenum,/* (i) weighting filter denuminator,
+                               Q12 */
+    int *idxForMax,     /* (o) quantizer index for maximum
+                               amplitude */
+    int *idxVec,        /* (o) vector of quantization indexes */
+    int len,            /* (i) length of all vectors */
+    int state_first     /* (i) position of start state in the
+                               80 vec */
+);
+
+void StateConstructWFix(
+    int idxForMax,      /* (i) 6-bit index for the quantization of
+                               max amplitude */
+    const int *idxVec,  /* (i) vector of quantization indexes */
+    const int16_t *syntDenum,/* (i) synthesis filter denumerator,
+                               Q12 */
+    int16_t *out,       /* (o) the decoded state vector */
+    int len             /* (i) length of a state vector */
+);
+
+#endif
@@ -0,0 +1,801 @@
+/******************************************************************
+
+    iLBC Speech Coder ANSI-C Source Code
+
+    cbFix.c
+
+    Fixed point codebook search, construction and gain quantization
+    (iCBSearch.c, createCB.c, getCBvec.c, iCBConstruct.c,
+    gainquant.c)
+
+******************************************************************/
+
+#include <string.h>
+
+#include "iLBC_defineFix.h"
+#include "constantsFix.h"
+#include "helpfunFix.h"
+#include "cbSearchSimdFix.h"
+#include "cbFix.h"
+#include "../constants.h"
+
+/* bits of the weighted codebook buffer and target, the correlations
+   and energies of SUBL samples then fit the 32 bit sums also after
+   the codebook filter */
+#define CB_SEARCH_BITS      11
+
+#define CB_MAXGAIN_Q14      21299   /* 1.3 */
+#define GAIN_MIN_Q14        1638    /* 0.1 */
+
+/* interpolation weights 0.0, 0.2, .., 0.8 of the augmented vectors,
+   Q15 */
+static const int16_t alfaTblFix[5] = {0, 6554, 13107, 19661, 26214};
+
+/*----------------------------------------------------------------*
+ *  quantizer for the gain in the gain-shape coding of residual
+ *---------------------------------------------------------------*/
+
+int16_t gainquantFix(   /* (o) quantized gain value, Q14 */
+    int16_t in,         /* (i) gain value, Q14 */
+    int16_t maxIn,      /* (i) maximum of gain value, Q14 */
+    int cblen,          /* (i) number of quantization indices */
+    int *index          /* (o) quantization index */
+){
+    int i, tindex;
+    int32_t scale, q, tq;
+    int64_t minmeasure, measure;
+    const int16_t *cb;
+
+    /* ensure a lower bound on the scaling factor */
+
+    scale=maxIn;
+
+    if (scale<GAIN_MIN_Q14) {
+        scale=GAIN_MIN_Q14;
+    }
+
+    /* select the quantization table */
+
+    if (cblen == 8) {
+        cb = gain_sq3TblFix;
+    } else if (cblen == 16) {
+        cb = gain_sq4TblFix;
+    } else  {
+        cb = gain_sq5TblFix;
+    }
+
+    /* select the best index in the quantization table */
+
+    minmeasure=INT64_MAX;
+    tindex=0;
+    tq=0;
+    for (i=0; i<cblen; i++) {
+        q=(scale*cb[i]+8192)>>14;
+        measure=(int64_t)(in-q)*(in-q);
+
+        if (measure<minmeasure) {
+            tindex=i;
+            tq=q;
+            minmeasure=measure;
+        }
+    }
+    *index=tindex;
+
+    /* return the quantized value */
+
+    return sat16(tq);
+}
+
+/*----------------------------------------------------------------*
+ *  decoder for quantized gains in the gain-shape coding of
+ *  residual
+ *---------------------------------------------------------------*/
+
+int16_t gaindequantFix( /* (o) quantized gain value, Q14 */
+    int index,          /* (i) quantization index */
+    int16_t maxIn,      /* (i) maximum of unquantized gain, Q14 */
+    int cblen           /* (i) number of quantization indices */
+){
+    int32_t scale;
+
+    /* obtain correct scale factor */
+
+    scale=maxIn<0 ? -(int32_t)maxIn : maxIn;
+
+    if (scale<GAIN_MIN_Q14) {
+        scale=GAIN_MIN_Q14;
+    }
+
+    /* select the quantization table and return the decoded value */
+
+    if (cblen==8) {
+        return sat16((scale*gain_sq3TblFix[index]+8192)>>14);
+    } else if (cblen==16) {
+        return sat16((scale*gain_sq4TblFix[index]+8192)>>14);
+    }
+    else if (cblen==32) {
+        return sat16((scale*gain_sq5TblFix[index]+8192)>>14);
+    }
+
+    return 0;
+}
+
+/*----------------------------------------------------------------*
+ *  (1-alfa)*a + alfa*b for the interpolated codebook vectors
+ *---------------------------------------------------------------*/
+
+static __inline int16_t cbInterpolFix(int16_t a, int16_t b, int16_t alfa)
+{
+    return (int16_t)(((int32_t)a*(32768-alfa) + (int32_t)b*alfa +
+        16384) >> 15);
+}
+
+/*----------------------------------------------------------------*
+ *  Construct codebook vector for given index.
+ *---------------------------------------------------------------*/
+
+void getCBvecFix(
+    int16_t *cbvec,     /* (o) Constructed codebook vector */
+    const int16_t *mem, /* (i) Codebook buffer */
+    int index,          /* (i) Codebook index */
+    int lMem,           /* (i) Length of codebook buffer */
+    int cbveclen        /* (i) Codebook vector length */
+){
+    int j, k, memInd, sFilt;
+    int16_t tmpbuf[CB_MEML];
+    int16_t tempbuff2[CB_MEML+CB_FILTERLEN+1];
+    int base_size;
+    int ilow, ihigh;
+
+    /* Determine size of codebook sections */
+
+    base_size=lMem-cbveclen+1;
+
+    if (cbveclen==SUBL) {
+        base_size+=cbveclen/2;
+    }
+
+    /* No filter -> First codebook section */
+
+    if (index<lMem-cbveclen+1) {
+
+        /* first non-interpolated vectors */
+
+        k=index+cbveclen;
+        /* get vector */
+        memcpy(cbvec, mem+lMem-k, cbveclen*sizeof(int16_t));
+
+    } else if (index < base_size) {
+
+        k=2*(index-(lMem-cbveclen+1))+cbveclen;
+
+        ihigh=k/2;
+        ilow=ihigh-5;
+
+        /* Copy first noninterpolated part */
+
+        memcpy(cbvec, mem+lMem-k/2, ilow*sizeof(int16_t));
+
+        /* interpolation */
+
+        for (j=ilow; j<ihigh; j++) {
+            cbvec[j]=cbInterpolFix(mem[lMem-k/2+j], mem[lMem-k+j],
+                alfaTblFix[j-ilow]);
+        }
+
+        /* Copy second noninterpolated part */
+
+        memcpy(cbvec+ihigh, mem+lMem-k+ihigh,
+            (cbveclen-ihigh)*sizeof(int16_t));
+
+    }
+
+    /* Higher codebook section based on filtering */
+
+    else {
+
+        memset(tempbuff2, 0,
+            CB_HALFFILTERLEN*sizeof(int16_t));
+        memcpy(&tempbuff2[CB_HALFFILTERLEN], mem,
+            lMem*sizeof(int16_t));
+        memset(&tempbuff2[lMem+CB_HALFFILTERLEN], 0,
+            (CB_HALFFILTERLEN+1)*sizeof(int16_t));
+
+        /* first non-interpolated vectors */
+
+        if (index-base_size<lMem-cbveclen+1) {
+
+            k=index-base_size+cbveclen;
+            sFilt=lMem-k;
+            memInd=sFilt+1-CB_HALFFILTERLEN;
+
+            /* do filtering */
+            cbFilterFix(&tempbuff2[memInd+CB_HALFFILTERLEN], cbveclen,
+                cbvec);
+        }
+
+        /* interpolated vectors */
+
+        else {
+
+            k=2*(index-base_size-
+                (lMem-cbveclen+1))+cbveclen;
+            sFilt=lMem-k;
+            memInd=sFilt+1-CB_HALFFILTERLEN;
+
+            /* do filtering */
+            cbFilterFix(&tempbuff2[memInd+CB_HALFFILTERLEN], k,
+                &tmpbuf[sFilt]);
+
+            ihigh=k/2;
+            ilow=ihigh-5;
+
+            /* Copy first noninterpolated part */
+
+            memcpy(cbvec, tmpbuf+lMem-k/2,
+                ilow*sizeof(int16_t));
+
+            /* interpolation */
+
+            for (j=ilow; j<ihigh; j++) {
+                cbvec[j]=cbInterpolFix(tmpbuf[lMem-k/2+j],
+                    tmpbuf[lMem-k+j], alfaTblFix[j-ilow]);
+            }
+
+            /* Copy second noninterpolated part */
+
+            memcpy(cbvec+ihigh, tmpbuf+lMem-k+ihigh,
+                (cbveclen-ihigh)*sizeof(int16_t));
+        }
+    }
+}
+
+/*----------------------------------------------------------------*
+ *  Construct decoded vector from codebook and gains.
+ *---------------------------------------------------------------*/
+
+void iCBConstructFix(
+    int16_t *decvector, /* (o) Decoded vector */
+    const int *index,   /* (i) Codebook indices */
+    const int *gain_index,/* (i) Gain quantization indices */
+    const int16_t *mem, /* (i) Buffer for codevector construction */
+    int lMem,           /* (i) Length of buffer */
+    int veclen,         /* (i) Length of vector */
+    int nStages         /* (i) Number of codebook stages */
+){
+    int j,k;
+    int16_t gain[CB_NSTAGES];
+    int16_t cbvec[SUBL];
+    int64_t acc[SUBL];
+
+    /* gain de-quantization */
+
+    gain[0] = gaindequantFix(gain_index[0], 16384, 32);
+    if (nStages > 1) {
+        gain[1] = gaindequantFix(gain_index[1], gain[0], 16);
+    }
+    if (nStages > 2) {
+        gain[2] = gaindequantFix(gain_index[2], gain[1], 8);
+    }
+
+    /* codebook vector construction and construction of
+    total vector */
+
+    getCBvecFix(cbvec, mem, index[0], lMem, veclen);
+    for (j=0;j<veclen;j++){
+        acc[j] = (int32_t)gain[0]*cbvec[j];
+    }
+    for (k=1; k<nStages; k++) {
+        getCBvecFix(cbvec, mem, index[k], lMem, veclen);
+        for (j=0;j<veclen;j++) {
+            acc[j] += (int32_t)gain[k]*cbvec[j];
+        }
+    }
+    for (j=0;j<veclen;j++) {
+        decvector[j] = sat16_64((acc[j] + 8192) >> 14);
+    }
+}
+
+/*----------------------------------------------------------------*
+ *  Construct an additional codebook vector by filtering the
+ *  initial codebook buffer. This vector is then used to expand
+ *  the codebook with an additional section.
+ *---------------------------------------------------------------*/
+
+static void filteredCBvecsFix(
+    int16_t *cbvectors, /* (o) Codebook vectors for the
+                               higher section */
+    const int16_t *mem, /* (i) Buffer to create codebook
+                               vector from */
+    int lMem            /* (i) Length of buffer */
+){
+    int16_t tempbuff2[CB_MEML+CB_FILTERLEN];
+
+    memset(tempbuff2, 0, (CB_HALFFILTERLEN-1)*sizeof(int16_t));
+    memcpy(&tempbuff2[CB_HALFFILTERLEN-1], mem, lMem*sizeof(int16_t));
+    memset(&tempbuff2[lMem+CB_HALFFILTERLEN-1], 0,
+        (CB_HALFFILTERLEN+1)*sizeof(int16_t));
+
+    /* Create codebook vector for higher section by filtering */
+
+    cbFilterFix(tempbuff2, lMem, cbvectors);
+}
+
+/*----------------------------------------------------------------*
+ *  Compare the measure crossDot^2/energy of a codebook vector
+ *  with the best one so far, the gain crossDot/energy must stay
+ *  below CB_MAXGAIN. In the first stage only vectors with a
+ *  positive correlation take part.
+ *---------------------------------------------------------------*/
+
+static void cbMeasureFix(
+    int32_t crossDot,   /* (i) Cross dot product with the target */
+    int32_t energy,     /* (i) Energy of the codebook vector */
+    int stage,          /* (i) Current stage */
+    int icount,         /* (i) Index of the codebook vector */
+    int64_t *max_measure,/* (i/o) Currently maximum measure */
+    int *best_index,    /* (i/o) Currently the best index */
+    int16_t *gain       /* (i/o) Currently the best gain, Q14 */
+){
+    int64_t measure, absDot;
+    int16_t ftmp;
+
+    if (stage==0 && crossDot <= 0) {
+        return;
+    }
+    if (energy <= 0) {
+        measure = 0;
+        ftmp = 0;
+    } else {
+        absDot = crossDot < 0 ? -(int64_t)crossDot : crossDot;
+        if (absDot*10 >= (int64_t)energy*13) {
+            return;
+        }
+        measure = (int64_t)crossDot*crossDot/energy;
+        ftmp = (int16_t)((int64_t)crossDot * (1 << 14)/energy);
+    }
+
+    /* check if measure is better */
+
+    if (measure > *max_measure) {
+        *best_index = icount;
+        *max_measure = measure;
+        *gain = ftmp;
+    }
+}
+
+/*----------------------------------------------------------------*
+ *  Search the augmented part of the codebook to find the best
+ *  measure.
+ *----------------------------------------------------------------*/
+
+static void searchAugmentedCBFix(
+    int low,            /* (i) Start index for the search */
+    int high,           /* (i) End index for the search */
+    int stage,          /* (i) Current stage */
+    int startIndex,     /* (i) Codebook index for the first
+                               aug vector */
+    dot16_fn dot,       /* (i) dot product kernel */
+    const int16_t *target,/* (i) Target vector for encoding */
+    const int16_t *buffer,/* (i) Pointer to the end of the buffer for
+                               augmented codebook construction */
+    int64_t *max_measure,/* (i/o) Currently maximum measure */
+    int *best_index,    /* (o) Currently the best index */
+    int16_t *gain       /* (o) Currently the best gain */
+) {
+    int icount, ilow, j;
+    const int16_t *ppo, *ppi;
+    int16_t aug[SUBL];
+
+    for (icount=low; icount<=high; icount++) {
+
+        /* Build the codebook vector: the first noninterpolated
+           samples, the interpolation and the remaining samples */
+
+        ilow = icount-4;
+        memcpy(aug, buffer-icount, ilow*sizeof(int16_t));
+        ppo = buffer-4;
+        ppi = buffer-icount-4;
+        for (j=ilow; j<icount; j++) {
+            aug[j] = cbInterpolFix(*ppo++, *ppi++,
+                alfaTblFix[j-ilow+1]);
+        }
+        memcpy(aug+icount, buffer-icount,
+            (SUBL-icount)*sizeof(int16_t));
+
+        cbMeasureFix(dot(target, aug, SUBL), dot(aug, aug, SUBL),
+            stage, startIndex+icount-20, max_measure, best_index,
+            gain);
+    }
+}
+
+/*----------------------------------------------------------------*
+ *  Recreate a specific codebook vector from the augmented part.
+ *
+ *----------------------------------------------------------------*/
+
+static void createAugmentedVecFix(
+    int index,          /* (i) Index for the augmented vector
+                               to be created */
+    const int16_t *buffer,/* (i) Pointer to the end of the buffer for
+                               augmented codebook construction */
+    int16_t *cbVec      /* (o) The construced codebook vector */
+) {
+    int ilow, j;
+    const int16_t *ppo, *ppi;
+
+    ilow = index-5;
+
+    /* copy the first noninterpolated part */
+
+    memcpy(cbVec,buffer-index,sizeof(int16_t)*index);
+
+    /* interpolation */
+
+    ppo = buffer-5;
+    ppi = buffer-index-5;
+    for (j=ilow; j<index; j++) {
+        cbVec[j] = cbInterpolFix(*ppo++, *ppi++, alfaTblFix[j-ilow]);
+    }
+
+    /* copy the second noninterpolated part */
+
+    memcpy(cbVec+index,buffer-index,sizeof(int16_t)*(SUBL-index));
+}
+
+/*----------------------------------------------------------------*
+ *  Search routine for codebook encoding and gain quantization.
+ *---------------------------------------------------------------*/
+
+void iCBSearchFix(
+    iLBCfix_Enc_Inst_t *iLBCenc_inst,
+                        /* (i) the encoder state structure */
+    int *index,         /* (o) Codebook indices */
+    int *gain_index,    /* (o) Gain quantization indices */
+    const int16_t *intarget,/* (i) Target vector for encoding */
+    const int16_t *mem, /* (i) Buffer for codebook construction */
+    int lMem,           /* (i) Length of buffer */
+    int lTarget,        /* (i) Length of vector */
+    int nStages,        /* (i) Number of codebook stages */
+    const int16_t *weightDenum,/* (i) weighting filter coefficients,
+                               Q12 */
+    const int16_t *weightState,/* (i) weighting filter state */
+    int block           /* (i) the sub-block number */
+){
+    int i, j, icount, stage, best_index, range, counter, sh;
+    int64_t max_measure, tene, cene;
+    int32_t maxAbs, gsq0;
+    int16_t gain;
+    int16_t gains[CB_NSTAGES];
+    int16_t target[SUBL];
+    int base_index, sInd, eInd, base_size;
+    int sIndAug=0, eIndAug=0;
+    int16_t buf[CB_MEML+SUBL+2*LPC_FILTERORDER];
+    int32_t energy[CB_EXPAND*128];
+    const int16_t *pp, *ppi, *ppo;
+    int16_t cbvectors[CB_MEML];
+    int32_t crossDots[CB_MEML];
+    int32_t cvec[SUBL];
+    int16_t aug_vec[SUBL];
+    dot16_fn dot = dot16Select();
+
+    memset(cvec,0,SUBL*sizeof(int32_t));
+
+    /* Determine size of codebook sections */
+
+    base_size=lMem-lTarget+1;
+
+    if (lTarget==SUBL) {
+        base_size=lMem-lTarget+1+lTarget/2;
+    }
+
+    /* setup buffer for weighting, scaled to CB_SEARCH_BITS; the
+       measures and the gains do not depend on the scaling */
+
+    maxAbs = maxAbsFix(mem, lMem);
+    if (maxAbsFix(intarget, lTarget) > maxAbs) {
+        maxAbs = maxAbsFix(intarget, lTarget);
+    }
+    sh = bitsFix((uint32_t)maxAbs) - CB_SEARCH_BITS;
+    shiftFix(buf, weightState, LPC_FILTERORDER, sh);
+    shiftFix(buf+LPC_FILTERORDER, mem, lMem, sh);
+    shiftFix(buf+LPC_FILTERORDER+lMem, intarget, lTarget, sh);
+
+    /* weighting, and scaling back to CB_SEARCH_BITS if the filter
+       has gain */
+
+    AllPoleFilterFix(buf+LPC_FILTERORDER, weightDenum,
+        lMem+lTarget, LPC_FILTERORDER);
+    sh = headroomFix(maxAbsFix(buf+LPC_FILTERORDER, lMem+lTarget),
+        CB_SEARCH_BITS);
+    shiftFix(buf+LPC_FILTERORDER, buf+LPC_FILTERORDER, lMem+lTarget, sh);
+
+    /* Construct the codebook and target needed */
+
+    memcpy(target, buf+LPC_FILTERORDER+lMem, lTarget*sizeof(int16_t));
+
+    tene = dot(target, target, lTarget);
+
+    /* Prepare search over one more codebook section. This section
+       is created by filtering the original buffer with a filter. */
+
+    filteredCBvecsFix(cbvectors, buf+LPC_FILTERORDER, lMem);
+
+    /* The Main Loop over stages */
+
+    for (stage=0; stage<nStages; stage++) {
+
+        range = search_rangeTbl[block][stage];
+
+        /* initialize search measure */
+
+        max_measure = -1;
+        gain = 0;
+        best_index = 0;
+
+        /* Compute cross dot products between the target
+           and the CB memory for the main first codebook
+           section */
+
+        cbCorrFix(target, buf+LPC_FILTERORDER+lMem-lTarget, lTarget,
+            range, crossDots);
+
+        if (stage==0) {
+
+            /* Calculate energy in the first block of
+              'lTarget' samples, then recursively for the
+              other vectors. */
+
+            pp=buf+LPC_FILTERORDER+lMem-lTarget;
+            energy[0]=dot(pp, pp, lTarget);
+
+            ppi = buf+LPC_FILTERORDER+lMem-lTarget-1;
+            ppo = buf+LPC_FILTERORDER+lMem-1;
+            for (icount=1; icount<range; icount++) {
+                energy[icount] = energy[icount-1] +
+                    (int32_t)(*ppi)*(*ppi) - (int32_t)(*ppo)*(*ppo);
+                ppo--;
+                ppi--;
+            }
+        }
+
+        /* loop over the main first codebook section,
+           full search */
+
+        for (icount=0; icount<range; icount++) {
+            cbMeasureFix(crossDots[icount], energy[icount], stage,
+                icount, &max_measure, &best_index, &gain);
+        }
+
+        /* Loop over augmented part in the first codebook
+         * section, full search.
+         * The vectors are interpolated.
+         */
+
+        if (lTarget==SUBL) {
+
+            /* Search for best possible cb vector and
+               compute the CB-vectors' energy. */
+            searchAugmentedCBFix(20, 39, stage, base_size-lTarget/2,
+                dot, target, buf+LPC_FILTERORDER+lMem,
+                &max_measure, &best_index, &gain);
+        }
+
+        /* set search range for following codebook sections */
+
+        base_index=best_index;
+
+        /* unrestricted search */
+
+        if (CB_RESRANGE == -1) {
+            sInd=0;
+            eInd=range-1;
+            sIndAug=20;
+            eIndAug=39;
+        }
+
+        /* restricted search around best index from first
+        codebook section */
+
+        else {
+            /* Initialize search indices */
+            sIndAug=0;
+            eIndAug=0;
+            sInd=base_index-CB_RESRANGE/2;
+            eInd=sInd+CB_RESRANGE;
+
+            if (lTarget==SUBL) {
+
+                if (sInd<0) {
+
+                    sIndAug = 40 + sInd;
+                    eIndAug = 39;
+                    sInd=0;
+
+                } else if ( base_index < (base_size-20) ) {
+
+                    if (eInd > range) {
+                        sInd -= (eInd-range);
+                        eInd = range;
+                    }
+                } else { /* base_index >= (base_size-20) */
+
+                    if (sInd < (base_size-20)) {
+                        sIndAug = 20;
+                        sInd = 0;
+                        eInd = 0;
+                        eIndAug = 19 + CB_RESRANGE;
+
+                        if(eIndAug > 39) {
+                            eInd = eIndAug-39;
+                            eIndAug = 39;
+                        }
+                    } else {
+                        sIndAug = 20 + sInd - (base_size-20);
+                        eIndAug = 39;
+                        sInd = 0;
+                        eInd = CB_RESRANGE - (eIndAug-sIndAug+1);
+                    }
+                }
+
+            } else { /* lTarget = 22 or 23 */
+
+                if (sInd < 0) {
+                    eInd -= sInd;
+                    sInd = 0;
+                }
+
+                if(eInd > range) {
+                    sInd -= (eInd - range);
+                    eInd = range;
+                }
+            }
+        }
+
+        /* search of higher codebook section */
+
+        /* index search range */
+        counter = sInd;
+        sInd += base_size;
+        eInd += base_size;
+
+
+        if (stage==0) {
+            pp=cbvectors+lMem-lTarget;
+            energy[base_size]=dot(pp, pp, lTarget);
+
+            ppi = cbvectors + lMem - 1 - lTarget;
+            ppo = cbvectors + lMem - 1;
+
+            for (j=0; j<(range-1); j++) {
+                energy[base_size+j+1] = energy[base_size+j] +
+                    (int32_t)(*ppi)*(*ppi) - (int32_t)(*ppo)*(*ppo);
+                ppo--;
+                ppi--;
+            }
+        }
+
+        /* loop over search range */
+
+        if (eInd>sInd) {
+            cbCorrFix(target, cbvectors+lMem-lTarget-counter, lTarget,
+                eInd-sInd, crossDots);
+        }
+
+        for (icount=sInd; icount<eInd; icount++) {
+            cbMeasureFix(crossDots[icount-sInd], energy[icount], stage,
+                icount, &max_measure, &best_index, &gain);
+        }
+
+        /* Search the augmented CB inside the limited range. */
+
+        if ((lTarget==SUBL)&&(sIndAug!=0)) {
+            searchAugmentedCBFix(sIndAug, eIndAug, stage,
+                2*base_size-20, dot, target, cbvectors+lMem,
+                &max_measure, &best_index, &gain);
+        }
+
+        /* record best index */
+
+        index[stage] = best_index;
+
+        /* gain quantization */
+
+        if (stage==0){
+            if (gain<0){
+                gain = 0;
+            }
+
+            if (gain>CB_MAXGAIN_Q14) {
+                gain = CB_MAXGAIN_Q14;
+            }
+            gain = gainquantFix(gain, 16384, 32, &gain_index[stage]);
+        }
+        else {
+            if (stage==1) {
+                gain = gainquantFix(gain, (int16_t)(gains[stage-1] < 0 ?
+                    -gains[stage-1] : gains[stage-1]),
+                    16, &gain_index[stage]);
+            } else {
+                gain = gainquantFix(gain, (int16_t)(gains[stage-1] < 0 ?
+                    -gains[stage-1] : gains[stage-1]),
+                    8, &gain_index[stage]);
+            }
+        }
+
+        /* Extract the best (according to measure)
+           codebook vector */
+
+        if (lTarget==(STATE_LEN-iLBCenc_inst->state_short_len)) {
+
+            if (index[stage]<base_size) {
+                pp=buf+LPC_FILTERORDER+lMem-lTarget-index[stage];
+            } else {
+                pp=cbvectors+lMem-lTarget-
+                    index[stage]+base_size;
+            }
+        } else {
+
+            if (index[stage]<base_size) {
+                if (index[stage]<(base_size-20)) {
+                    pp=buf+LPC_FILTERORDER+lMem-
+                        lTarget-index[stage];
+                } else {
+                    createAugmentedVecFix(index[stage]-base_size+40,
+                            buf+LPC_FILTERORDER+lMem,aug_vec);
+                    pp=aug_vec;
+                }
+            } else {
+                int filterno, position;
+
+                filterno=index[stage]/base_size;
+                position=index[stage]-filterno*base_size;
+
+                if (position<(base_size-20)) {
+                    pp=cbvectors+filterno*lMem-lTarget-
+                        index[stage]+filterno*base_size;
+                } else {
+                    createAugmentedVecFix(
+                        index[stage]-(filterno+1)*base_size+40,
+                        cbvectors+filterno*lMem,aug_vec);
+                    pp=aug_vec;
+                }
+            }
+        }
+
+        /* Subtract the best codebook vector, according
+           to measure, from the target vector */
+
+        for (j=0;j<lTarget;j++) {
+            cvec[j] += (int32_t)gain*(*pp);
+            target[j] = sat16(target[j] -
+                (((int32_t)gain*(*pp++) + 8192) >> 14));
+        }
+
+        /* record quantized gain */
+
+        gains[stage]=gain;
+
+    }/* end of Main Loop. for (stage=0;... */
+
+    /* Gain adjustment for energy matching, the squared gains
+       in Q14 */
+
+    cene=0;
+    for (i=0; i<lTarget; i++) {
+        j = (cvec[i] + 8192) >> 14;
+        cene+=(int64_t)j*j;
+    }
+    gsq0=((int32_t)gains[0]*gains[0]) >> 14;
+    j=gain_index[0];
+
+    for (i=gain_index[0]; i<32; i++) {
+
+        if ((cene*(((int32_t)gain_sq5TblFix[i]*gain_sq5TblFix[i]) >>
+                14) < tene*gsq0) &&
+            (gain_sq5TblFix[j] < 2*(int32_t)gains[0])) {
+            j=i;
+        }
+    }
+    gain_index[0]=j;
+}
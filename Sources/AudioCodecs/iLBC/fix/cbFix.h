@@ -0,0 +1,63 @@
+/******************************************************************
+
+    iLBC Speech Coder ANSI-C Source Code
+
+    cbFix.h
+
+    Fixed point codebook search, construction and gain quantization
+
+******************************************************************/
+
+#ifndef __iLBC_CBFIX_H
+#define __iLBC_CBFIX_H
+
+#include "iLBC_defineFix.h"
+
+int16_t gainquantFix(   /* (o) quantized gain value, Q14 */
+    int16_t in,         /* (i) gain value, Q14 */
+    int16_t maxIn,      /* (i) maximum of gain value, Q14 */
+    int cblen,          /* (i) number of quantization indices */
+    int *index          /* (o) quantization index */
+);
+
+int16_t gaindequantFix( /* (o) quantized gain value, Q14 */
+    int index,          /* (i) quantization index */
+    int16_t maxIn,      /* (i) maximum of unquantized gain, Q14 */
+    int cblen           /* (i) number of quantization indices */
+);
+
+void getCBvecFix(
+    int16_t *cbvec,     /* (o) Constructed codebook vector */
+    const int16_t *mem, /* (i) Codebook buffer */
+    int index,          /* (i) Codebook index */
+    int lMem,           /* (i) Length of codebook buffer */
+    int cbveclen        /* (i) Codebook vector length */
+);
+
+void iCBConstructFix(
+    int16_t *decvector, /* (o) Decoded vector */
+    const int *index,   /* (i) Codebook indices */
+    const int *gain_index,/* (i) Gain quantization indices */
+    const int16_t *mem, /* (i) Buffer for codevector construction */
+    int lMem,           /* (i) Length of buffer */
+    int veclen,         /* (i) Length of vector */
+    int nStages         /* (i) Number of codebook stages */
+);
+
+void iCBSearchFix(
+    iLBCfix_Enc_Inst_t *iLBCenc_inst,
+                        /* (i) the encoder state structure */
+    int *index,         /* (o) Codebook indices */
+    int *gain_index,    /* (o) Gain quantization indices */
+    const int16_t *intarget,/* (i) Target vector for encoding */
+    const int16_t *mem, /* (i) Buffer for codebook construction */
+    int lMem,           /* (i) Length of buffer */
+    int lTarget,        /* (i) Length of vector */
+    int nStages,        /* (i) Number of codebook stages */
+    const int16_t *weightDenum,/* (i) weighting filter coefficients,
+                               Q12 */
+    const int16_t *weightState,/* (i) weighting filter state */
+    int block           /* (i) the sub-block number */
+);
+
+#endif
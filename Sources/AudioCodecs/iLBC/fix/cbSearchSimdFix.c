@@ -0,0 +1,178 @@
+/******************************************************************
+
+    iLBC Speech Coder ANSI-C Source Code
+
+    cbSearchSimdFix.c
+
+    16 bit dot product kernels (see cbSearchSimdFix.h)
+
+******************************************************************/
+
+#include "iLBC_defineFix.h"
+#include "constantsFix.h"
+#include "helpfunFix.h"
+#include "cbSearchSimdFix.h"
+
+/*----------------------------------------------------------------*
+ *  Reference kernel, unsigned to get the wrap around of the
+ *  vector adds.
+ *---------------------------------------------------------------*/
+
+int32_t dot16_C(
+    const int16_t *x,   /* (i) first vector */
+    const int16_t *y,   /* (i) second vector */
+    int n               /* (i) length of the vectors */
+){
+    uint32_t sum = 0;
+    int j;
+
+    for (j=0; j<n; j++) {
+        sum += (uint32_t)((int32_t)x[j]*y[j]);
+    }
+    return (int32_t)sum;
+}
+
+/*----------------------------------------------------------------*
+ *  SSE2 : pmaddwd on 8 samples, 4 partial sums per vector
+ *---------------------------------------------------------------*/
+
+#if defined(DSP_HAS_SSE2)
+int32_t dot16_SSE2(const int16_t *x, const int16_t *y, int n)
+{
+    __m128i s = _mm_setzero_si128();
+    uint32_t sum;
+    int j;
+
+    for (j=0; j+8<=n; j+=8) {
+        s = _mm_add_epi32(s, _mm_madd_epi16(
+            _mm_loadu_si128((const __m128i *)(x+j)),
+            _mm_loadu_si128((const __m128i *)(y+j))));
+    }
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4E));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xB1));
+    sum = (uint32_t)_mm_cvtsi128_si32(s);
+    for (; j<n; j++) {
+        sum += (uint32_t)((int32_t)x[j]*y[j]);
+    }
+    return (int32_t)sum;
+}
+#endif
+
+#if defined(DSP_HAS_AVX2)
+DSP_TARGET_AVX2
+int32_t dot16_AVX2(const int16_t *x, const int16_t *y, int n)
+{
+    __m256i s8 = _mm256_setzero_si256();
+    __m128i s;
+    uint32_t sum;
+    int j;
+
+    for (j=0; j+16<=n; j+=16) {
+        s8 = _mm256_add_epi32(s8, _mm256_madd_epi16(
+            _mm256_loadu_si256((const __m256i *)(x+j)),
+            _mm256_loadu_si256((const __m256i *)(y+j))));
+    }
+    s = _mm_add_epi32(_mm256_castsi256_si128(s8),
+        _mm256_extracti128_si256(s8, 1));
+    if (j+8<=n) {
+        s = _mm_add_epi32(s, _mm_madd_epi16(
+            _mm_loadu_si128((const __m128i *)(x+j)),
+            _mm_loadu_si128((const __m128i *)(y+j))));
+        j+=8;
+    }
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4E));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xB1));
+    sum = (uint32_t)_mm_cvtsi128_si32(s);
+    _mm256_zeroupper();
+    for (; j<n; j++) {
+        sum += (uint32_t)((int32_t)x[j]*y[j]);
+    }
+    return (int32_t)sum;
+}
+#endif
+
+#if defined(DSP_HAS_NEON)
+int32_t dot16_NEON(const int16_t *x, const int16_t *y, int n)
+{
+    int32x4_t s = vdupq_n_s32(0);
+    int32x2_t s2;
+    uint32_t sum;
+    int j;
+
+    for (j=0; j+8<=n; j+=8) {
+        int16x8_t a = vld1q_s16(x+j);
+        int16x8_t b = vld1q_s16(y+j);
+        s = vaddq_s32(s, vmull_s16(vget_low_s16(a), vget_low_s16(b)));
+        s = vaddq_s32(s, vmull_s16(vget_high_s16(a), vget_high_s16(b)));
+    }
+    s2 = vadd_s32(vget_low_s32(s), vget_high_s32(s));
+    s2 = vpadd_s32(s2, s2);
+    sum = (uint32_t)vget_lane_s32(s2, 0);
+    for (; j<n; j++) {
+        sum += (uint32_t)((int32_t)x[j]*y[j]);
+    }
+    return (int32_t)sum;
+}
+#endif
+
+dot16_fn dot16Select(void)
+{
+    dot16_fn Dot = dot16_C;
+
+#if defined(DSP_HAS_SSE2)
+    if (DSP_TEST_CPU(kCpuHasSSE2)) {
+        Dot = dot16_SSE2;
+    }
+#endif
+#if defined(DSP_HAS_AVX2)
+    if (DSP_TEST_CPU(kCpuHasAVX2)) {
+        Dot = dot16_AVX2;
+    }
+#endif
+#if defined(DSP_HAS_NEON)
+    if (DSP_TEST_CPU(kCpuHasNEON)) {
+        Dot = dot16_NEON;
+    }
+#endif
+    return Dot;
+}
+
+/*----------------------------------------------------------------*
+ *  Correlation of the target with the codebook memory
+ *---------------------------------------------------------------*/
+
+void cbCorrFix(
+    const int16_t *target,  /* (i) target vector */
+    const int16_t *cb,      /* (i) codebook vector for lag 0 */
+    int n,                  /* (i) length of the vectors */
+    int lags,               /* (i) number of lags */
+    int32_t *corr           /* (o) correlation for every lag */
+){
+    dot16_fn Dot = dot16Select();
+    int k;
+
+    for (k=0; k<lags; k++) {
+        corr[k] = Dot(target, cb-k, n);
+    }
+}
+
+/*----------------------------------------------------------------*
+ *  Codebook expansion filter, one dot product per sample
+ *---------------------------------------------------------------*/
+
+void cbFilterFix(
+    const int16_t *in,  /* (i) input, in[0..n+CB_FILTERLEN-2] */
+    int n,              /* (i) number of output samples */
+    int16_t *out        /* (o) filtered samples */
+){
+    dot16_fn Dot = dot16Select();
+    int16_t taps[CB_FILTERLEN];
+    int j, k;
+
+    for (j=0; j<CB_FILTERLEN; j++) {
+        taps[j] = cbfiltersTblFix[CB_FILTERLEN-1-j];
+    }
+    for (k=0; k<n; k++) {
+        out[k] = sat16((Dot(in+k, taps, CB_FILTERLEN) + 8192) >> 14);
+    }
+}
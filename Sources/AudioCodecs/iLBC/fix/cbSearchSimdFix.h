@@ -0,0 +1,64 @@
+/******************************************************************
+
+    iLBC Speech Coder ANSI-C Source Code
+
+    cbSearchSimdFix.h
+
+    16 bit dot product kernels of the fixed point codec
+
+******************************************************************/
+
+/*
+   The correlations and energies of the fixed point codec are sums
+   of 16x16 bit products in 32 bit. The callers scale the vectors so
+   that the sums do not overflow; the kernels add with wrap around,
+   so the result does not depend on the order of the additions and
+   the C, SSE2, AVX2 and NEON versions give the same bits.
+   dot16Select() returns the best kernel for the running CPU, the
+   callers fetch it once and keep it for their loops.
+*/
+
+#ifndef __iLBC_CBSEARCHSIMDFIX_H
+#define __iLBC_CBSEARCHSIMDFIX_H
+
+#include <stdint.h>
+#include "../../Dsp/dsp_cpu.h"
+
+/*----------------------------------------------------------------*
+ *  sum_{j=0}^{n-1} x[j]*y[j]
+ *---------------------------------------------------------------*/
+
+typedef int32_t (*dot16_fn)(const int16_t *x, const int16_t *y, int n);
+
+int32_t dot16_C(const int16_t *x, const int16_t *y, int n);
+
+#if defined(DSP_HAS_SSE2)
+int32_t dot16_SSE2(const int16_t *x, const int16_t *y, int n);
+#endif
+
+#if defined(DSP_HAS_AVX2)
+int32_t dot16_AVX2(const int16_t *x, const int16_t *y, int n);
+#endif
+
+#if defined(DSP_HAS_NEON)
+int32_t dot16_NEON(const int16_t *x, const int16_t *y, int n);
+#endif
+
+dot16_fn dot16Select(void);
+
+/*----------------------------------------------------------------*
+ *  corr[k] = sum_{j=0}^{n-1} target[j]*cb[j-k], k = 0..lags-1
+ *  cb[] must be readable from cb[-(lags-1)].
+ *---------------------------------------------------------------*/
+
+void cbCorrFix(const int16_t *target, const int16_t *cb, int n, int lags,
+    int32_t *corr);
+
+/*----------------------------------------------------------------*
+ *  out[k] = (sum_{j=0}^{CB_FILTERLEN-1} in[k+j]*cbfiltersTblFix[
+ *  CB_FILTERLEN-1-j]) in Q0, k = 0..n-1
+ *---------------------------------------------------------------*/
+
+void cbFilterFix(const int16_t *in, int n, int16_t *out);
+
+#endif
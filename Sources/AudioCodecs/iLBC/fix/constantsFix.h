@@ -0,0 +1,51 @@
+/******************************************************************
+
+    iLBC Speech Coder ANSI-C Source Code
+
+    constantsFix.h
+
+    Fixed point versions of the tables in constants.c
+
+******************************************************************/
+
+#ifndef __iLBC_CONSTANTSFIX_H
+#define __iLBC_CONSTANTSFIX_H
+
+#include "iLBC_defineFix.h"
+
+/* high pass filters, Q28 */
+
+extern const int32_t hpi_zero_coefsTblFix[];
+extern const int32_t hpi_pole_coefsTblFix[];
+extern const int32_t hpo_zero_coefsTblFix[];
+extern const int32_t hpo_pole_coefsTblFix[];
+
+/* state quantization tables */
+
+extern const int16_t state_sq3TblFix[];
+extern const int16_t state_sq3MidTblFix[];
+extern const int32_t state_frgqDeqTblFix[];
+extern const int32_t state_frgqScalTblFix[];
+extern const int32_t state_frgqMidTblFix[];
+
+/* adaptive codebook and gain quantization tables */
+
+extern const int16_t cbfiltersTblFix[CB_FILTERLEN];
+extern const int16_t gain_sq3TblFix[];
+extern const int16_t gain_sq4TblFix[];
+extern const int16_t gain_sq5TblFix[];
+
+/* LPC analysis and quantization */
+
+extern const int16_t lsfmeanTblFix[];
+extern const int16_t lsf_weightTbl_30msFix[];
+extern const int16_t lsf_weightTbl_20msFix[];
+extern const int16_t lsfCbTblFix[];
+extern const int16_t lpc_winTblFix[];
+extern const int16_t lpc_asymwinTblFix[];
+extern const int32_t lpc_lagwinTblFix[];
+extern const int16_t chirp_syntdenumTblFix[];
+extern const int16_t chirp_weightdenumTblFix[];
+extern const int16_t cosTblFix[];
+
+#endif
@@ -0,0 +1,246 @@
+/******************************************************************
+
+    iLBC Speech Coder ANSI-C Source Code
+
+    doCPLCFix.c
+
+    Fixed point packet loss concealment (doCPLC.c)
+
+******************************************************************/
+
+#include <string.h>
+
+#include "iLBC_defineFix.h"
+#include "helpfunFix.h"
+#include "cbSearchSimdFix.h"
+#include "doCPLCFix.h"
+
+/* bits of the residual in the correlations, 60 squares of 12 bit
+   samples fit the 32 bit sums */
+#define PLC_CORR_BITS       12
+
+/*----------------------------------------------------------------*
+ *  Compute cross correlation and periodicity for pitch prediction
+ *  of last subframe at given lag.
+ *---------------------------------------------------------------*/
+
+static void compCorrFix(
+    int64_t *cc,        /* (o) cross correlation coefficient */
+    int16_t *pm,        /* (o) periodicity, Q15 */
+    dot16_fn dot,       /* (i) dot product kernel */
+    const int16_t *buffer,/* (i) signal buffer, PLC_CORR_BITS */
+    int lag,            /* (i) pitch lag */
+    int bLen,           /* (i) length of buffer */
+    int sRange          /* (i) correlation search length */
+){
+    int32_t ftmp1, ftmp2, ftmp3;
+    uint32_t den;
+    int64_t num;
+
+    /* Guard against getting outside buffer */
+    if ((bLen-sRange-lag)<0) {
+        sRange=bLen-lag;
+    }
+
+    ftmp1 = dot(buffer+bLen-sRange, buffer+bLen-sRange-lag, sRange);
+    ftmp2 = dot(buffer+bLen-sRange-lag, buffer+bLen-sRange-lag, sRange);
+    ftmp3 = dot(buffer+bLen-sRange, buffer+bLen-sRange, sRange);
+
+    if (ftmp2 > 0) {
+        *cc = (int64_t)ftmp1*ftmp1/ftmp2;
+        den = sqrtFix((uint64_t)ftmp2*(uint32_t)ftmp3);
+        num = ftmp1 < 0 ? -(int64_t)ftmp1 : ftmp1;
+        num = den > 0 ? (num << 15)/den : 0;
+        *pm = (int16_t)(num > 32767 ? 32767 : num);
+    }
+    else {
+        *cc = 0;
+        *pm = 0;
+    }
+}
+
+/*----------------------------------------------------------------*
+ *  Packet loss concealment routine. Conceals a residual signal
+ *  and LP parameters. If no packet loss, update state.
+ *---------------------------------------------------------------*/
+
+void doThePLCFix(
+    int16_t *PLCresidual,/* (o) concealed residual */
+    int16_t *PLClpc,    /* (o) concealed LP parameters, Q12 */
+    int PLI,            /* (i) packet loss indicator
+                               0 - no PL, 1 = PL */
+    const int16_t *decresidual,/* (i) decoded residual */
+    const int16_t *lpc, /* (i) decoded LPC (only used for no PL) */
+    int inlag,          /* (i) pitch lag */
+    iLBCfix_Dec_Inst_t *iLBCdec_inst
+                        /* (i/o) decoder instance */
+){
+    int lag=20, randlag;
+    int64_t maxcc, maxcc_comp, energy;
+    int32_t use_gain, gain, ftmp, pitchfact, mix;
+    int16_t per, max_per=0;
+    int i, pick, use_lag;
+    int16_t randvec[BLOCKL_MAX], scaled[BLOCKL_MAX];
+    dot16_fn dot;
+
+    /* Packet Loss */
+
+    if (PLI == 1) {
+
+        iLBCdec_inst->consPLICount += 1;
+
+        /* if previous frame not lost,
+           determine pitch pred. gain */
+
+        if (iLBCdec_inst->prevPLI != 1) {
+
+            /* Search around the previous lag to find the
+               best pitch period */
+
+            dot = dot16Select();
+            shiftFix(scaled, iLBCdec_inst->prevResidual,
+                iLBCdec_inst->blockl, headroomFix(maxAbsFix(
+                iLBCdec_inst->prevResidual, iLBCdec_inst->blockl),
+                PLC_CORR_BITS));
+
+            lag=inlag-3;
+            compCorrFix(&maxcc, &max_per, dot, scaled,
+                lag, iLBCdec_inst->blockl, 60);
+            for (i=inlag-2;i<=inlag+3;i++) {
+                compCorrFix(&maxcc_comp, &per, dot, scaled,
+                    i, iLBCdec_inst->blockl, 60);
+
+                if (maxcc_comp>maxcc) {
+                    maxcc=maxcc_comp;
+                    lag=i;
+                    max_per=per;
+                }
+            }
+
+        }
+
+        /* previous frame lost, use recorded lag and periodicity */
+
+        else {
+            lag=iLBCdec_inst->prevLag;
+            max_per=iLBCdec_inst->per;
+        }
+
+        /* downscaling, Q14 */
+
+        use_gain=16384;
+        if (iLBCdec_inst->consPLICount*iLBCdec_inst->blockl>320)
+            use_gain=14746;
+        else if (iLBCdec_inst->consPLICount*
+                        iLBCdec_inst->blockl>2*320)
+            use_gain=11469;
+        else if (iLBCdec_inst->consPLICount*
+                        iLBCdec_inst->blockl>3*320)
+            use_gain=8192;
+        else if (iLBCdec_inst->consPLICount*
+                        iLBCdec_inst->blockl>4*320)
+            use_gain=0;
+
+        /* mix noise and pitch repeatition, sqrt(max_per) in Q15
+           and pitchfact in Q14 */
+
+        ftmp=(int32_t)sqrtFix((uint64_t)max_per << 15);
+        if (ftmp>22938)
+            pitchfact=16384;
+        else if (ftmp>13107)
+            pitchfact=((ftmp-13107)*16384)/(22938-13107);
+        else
+            pitchfact=0;
+
+
+        /* avoid repetition of same pitch cycle */
+        use_lag=lag;
+        if (lag<80) {
+            use_lag=2*lag;
+        }
+
+        /* compute concealed residual */
+
+        energy = 0;
+        for (i=0; i<iLBCdec_inst->blockl; i++) {
+
+            /* noise component */
+
+            iLBCdec_inst->seed=(iLBCdec_inst->seed*69069L+1) &
+                (0x80000000L-1);
+            randlag = 50 + ((signed long) iLBCdec_inst->seed)%70;
+            pick = i - randlag;
+
+            if (pick < 0) {
+                randvec[i] =
+                    iLBCdec_inst->prevResidual[
+                                iLBCdec_inst->blockl+pick];
+            } else {
+                randvec[i] =  randvec[pick];
+            }
+
+            /* pitch repeatition component */
+            pick = i - use_lag;
+
+            if (pick < 0) {
+                PLCresidual[i] =
+                    iLBCdec_inst->prevResidual[
+                                iLBCdec_inst->blockl+pick];
+            } else {
+                PLCresidual[i] = PLCresidual[pick];
+            }
+
+            /* mix random and periodicity component */
+
+            mix = (pitchfact*PLCresidual[i] +
+                (16384-pitchfact)*randvec[i] + 8192) >> 14;
+
+            if (i<80)
+                gain = use_gain;
+            else if (i<160)
+                gain = (use_gain*31130 + 16384) >> 15;   /* 0.95 */
+            else
+                gain = (use_gain*29491 + 16384) >> 15;   /* 0.9 */
+
+            PLCresidual[i] = sat16((gain*mix + 8192) >> 14);
+
+            energy += (int32_t)PLCresidual[i] * PLCresidual[i];
+        }
+
+        /* less than 30 dB, use only noise */
+
+        if (energy < (int64_t)900*iLBCdec_inst->blockl) {
+            for (i=0; i<iLBCdec_inst->blockl; i++) {
+                PLCresidual[i] = randvec[i];
+            }
+        }
+
+        /* use old LPC */
+
+        memcpy(PLClpc,iLBCdec_inst->prevLpc,
+            (LPC_FILTERORDER+1)*sizeof(int16_t));
+
+    }
+
+    /* no packet loss, copy input */
+
+    else {
+        memcpy(PLCresidual, decresidual,
+            iLBCdec_inst->blockl*sizeof(int16_t));
+        memcpy(PLClpc, lpc, (LPC_FILTERORDER+1)*sizeof(int16_t));
+        iLBCdec_inst->consPLICount = 0;
+    }
+
+    /* update state */
+
+    if (PLI) {
+        iLBCdec_inst->prevLag = lag;
+        iLBCdec_inst->per=max_per;
+    }
+
+    iLBCdec_inst->prevPLI = PLI;
+    memcpy(iLBCdec_inst->prevLpc, PLClpc,
+        (LPC_FILTERORDER+1)*sizeof(int16_t));
+    memcpy(iLBCdec_inst->prevResidual, PLCresidual,
+        iLBCdec_inst->blockl*sizeof(int16_t));
+}
@@ -0,0 +1,28 @@
+/******************************************************************
+
+    iLBC Speech Coder ANSI-C Source Code
+
+    doCPLCFix.h
+
+    Fixed point packet loss concealment
+
+******************************************************************/
+
+#ifndef __iLBC_DOPLCFIX_H
+#define __iLBC_DOPLCFIX_H
+
+#include "iLBC_defineFix.h"
+
+void doThePLCFix(
+    int16_t *PLCresidual,/* (o) concealed residual */
+    int16_t *PLClpc,    /* (o) concealed LP parameters, Q12 */
+    int PLI,            /* (i) packet loss indicator
+                               0 - no PL, 1 = PL */
+    const int16_t *decresidual,/* (i) decoded residual */
+    const int16_t *lpc, /* (i) decoded LPC (only used for no PL) */
+    int inlag,          /* (i) pitch lag */
+    iLBCfix_Dec_Inst_t *iLBCdec_inst
+                        /* (i/o) decoder instance */
+);
+
+#endif
@@ -0,0 +1,466 @@
+/******************************************************************
+
+    iLBC Speech Coder ANSI-C Source Code
+
+    helpfunFix.c
+
+    Fixed point arithmetic, filters and LPC helper functions
+
+******************************************************************/
+
+#include <string.h>
+
+#include "iLBC_defineFix.h"
+#include "helpfunFix.h"
+#include "cbSearchSimdFix.h"
+
+/*----------------------------------------------------------------*
+ *  maximum absolute value of a vector
+ *---------------------------------------------------------------*/
+
+int32_t maxAbsFix(
+    const int16_t *x,   /* (i) vector */
+    int len             /* (i) length of the vector */
+){
+    int32_t m = 0, t;
+    int i;
+
+    for (i=0; i<len; i++) {
+        t = x[i] < 0 ? -(int32_t)x[i] : x[i];
+        if (t > m) {
+            m = t;
+        }
+    }
+    return m;
+}
+
+/*----------------------------------------------------------------*
+ *  right shift that brings samples of magnitude maxAbs to at
+ *  most maxBits bits
+ *---------------------------------------------------------------*/
+
+int headroomFix(
+    int32_t maxAbs,     /* (i) max |x[i]| of the vectors */
+    int maxBits         /* (i) bits allowed for the samples */
+){
+    int nb = bitsFix((uint32_t)maxAbs);
+
+    return nb > maxBits ? nb - maxBits : 0;
+}
+
+void shiftFix(
+    int16_t *out,       /* (o) x[i] >> shift, may be x */
+    const int16_t *x,   /* (i) vector */
+    int len,            /* (i) length of the vector */
+    int shift           /* (i) right shift, left when negative */
+){
+    int i;
+
+    if (shift >= 0) {
+        for (i=0; i<len; i++) {
+            out[i] = (int16_t)(x[i] >> shift);
+        }
+    } else {
+        for (i=0; i<len; i++) {
+            out[i] = sat16_64((int64_t)x[i] * ((int64_t)1 << -shift));
+        }
+    }
+}
+
+/*----------------------------------------------------------------*
+ *  integer square root
+ *---------------------------------------------------------------*/
+
+uint32_t sqrtFix(
+    uint64_t x          /* (i) value */
+){
+    uint64_t res = 0, bit = (uint64_t)1 << 62;
+
+    while (bit > x) {
+        bit >>= 2;
+    }
+    while (bit) {
+        if (x >= res + bit) {
+            x -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)res;
+}
+
+/*----------------------------------------------------------------*
+ *  all-pole filter
+ *---------------------------------------------------------------*/
+
+void AllPoleFilterFix(
+    int16_t *InOut,     /* (i/o) InOut[-orderCoef..-1] is the
+                               state, InOut[0..lengthInOut-1] the
+                               input and on exit the output */
+    const int16_t *Coef,/* (i) filter coefficients */
+    int lengthInOut,    /* (i) number of input/output samples */
+    int orderCoef       /* (i) number of filter coefficients */
+){
+    int n,k;
+    int64_t acc;
+
+    for(n=0;n<lengthInOut;n++){
+        acc = (int64_t)InOut[0] * (1 << 12);
+        for(k=1;k<=orderCoef;k++){
+            acc -= (int32_t)Coef[k]*InOut[-k];
+        }
+        *InOut = sat16_64((acc + 2048) >> 12);
+        InOut++;
+    }
+}
+
+/*----------------------------------------------------------------*
+ *  all-zero filter
+ *---------------------------------------------------------------*/
+
+void AllZeroFilterFix(
+    const int16_t *In,  /* (i) In[-orderCoef..lengthInOut-1] */
+    const int16_t *Coef,/* (i) filter coefficients */
+    int lengthInOut,    /* (i) number of input/output samples */
+    int orderCoef,      /* (i) number of filter coefficients */
+    int16_t *Out        /* (o) filtered samples */
+){
+    int n,k;
+    int64_t acc;
+
+    for(n=0;n<lengthInOut;n++){
+        acc = 0;
+        for(k=0;k<=orderCoef;k++){
+            acc += (int32_t)Coef[k]*In[-k];
+        }
+        *Out++ = sat16_64((acc + 2048) >> 12);
+        In++;
+    }
+}
+
+/*----------------------------------------------------------------*
+ *  pole-zero filter
+ *---------------------------------------------------------------*/
+
+void ZeroPoleFilterFix(
+    const int16_t *In,      /* (i) In[-orderCoef..lengthInOut-1] */
+    const int16_t *ZeroCoef,/* (i) all-zero section coefficients */
+    const int16_t *PoleCoef,/* (i) all-pole section coefficients */
+    int lengthInOut,        /* (i) number of input/output samples */
+    int orderCoef,          /* (i) number of filter coefficients */
+    int16_t *Out            /* (i/o) Out[-orderCoef..-1] is the state
+                                   of the all-pole section, on exit
+                                   Out[0..lengthInOut-1] is the
+                                   output */
+){
+    AllZeroFilterFix(In,ZeroCoef,lengthInOut,orderCoef,Out);
+    AllPoleFilterFix(Out,PoleCoef,lengthInOut,orderCoef);
+}
+
+/*----------------------------------------------------------------*
+ *  LP synthesis filter
+ *---------------------------------------------------------------*/
+
+void syntFilterFix(
+    int16_t *Out,       /* (i/o) Signal to be filtered */
+    const int16_t *a,   /* (i) LP parameters */
+    int len,            /* (i) Length of signal */
+    int16_t *mem        /* (i/o) Filter state */
+){
+    int16_t buf[LPC_FILTERORDER+BLOCKL_MAX];
+
+    memcpy(buf, mem, LPC_FILTERORDER*sizeof(int16_t));
+    memcpy(buf+LPC_FILTERORDER, Out, len*sizeof(int16_t));
+    AllPoleFilterFix(buf+LPC_FILTERORDER, a, len, LPC_FILTERORDER);
+    memcpy(Out, buf+LPC_FILTERORDER, len*sizeof(int16_t));
+    memcpy(mem, buf+len, LPC_FILTERORDER*sizeof(int16_t));
+}
+
+/*----------------------------------------------------------------*
+ *  LP analysis filter
+ *---------------------------------------------------------------*/
+
+void anaFilterFix(
+    const int16_t *In,  /* (i) Signal to be filtered */
+    const int16_t *a,   /* (i) LP parameters */
+    int len,            /* (i) Length of signal */
+    int16_t *Out,       /* (o) Filtered signal */
+    int16_t *mem        /* (i/o) Filter state */
+){
+    int16_t buf[LPC_FILTERORDER+BLOCKL_MAX];
+
+    memcpy(buf, mem, LPC_FILTERORDER*sizeof(int16_t));
+    memcpy(buf+LPC_FILTERORDER, In, len*sizeof(int16_t));
+    AllZeroFilterFix(buf+LPC_FILTERORDER, a, len, LPC_FILTERORDER, Out);
+    memcpy(mem, buf+len, LPC_FILTERORDER*sizeof(int16_t));
+}
+
+/*----------------------------------------------------------------*
+ *  Input and output high-pass filters (hpInput.c, hpOutput.c)
+ *---------------------------------------------------------------*/
+
+void hpFilterFix(
+    const int16_t *In,      /* (i) vector to filter */
+    int len,                /* (i) length of vector to filter */
+    int16_t *Out,           /* (o) the resulting filtered vector */
+    int32_t *mem,           /* (i/o) the filter state */
+    const int32_t *zero,    /* (i) numerator, Q28 */
+    const int32_t *pole     /* (i) denominator, Q28 */
+){
+    int i;
+    int64_t acc;
+    int32_t y;
+
+    for (i=0; i<len; i++) {
+
+        /* all-zero section, Q28 to Q36 */
+
+        acc = (int64_t)zero[0]*In[i] + (int64_t)zero[1]*mem[0] +
+            (int64_t)zero[2]*mem[1];
+        acc *= 256;
+
+        /* all-pole section, the output is kept in Q8 */
+
+        acc -= (int64_t)pole[1]*mem[2] + (int64_t)pole[2]*mem[3];
+        y = (int32_t)((acc + ((int64_t)1 << 27)) >> 28);
+
+        mem[1] = mem[0];
+        mem[0] = In[i];
+        mem[3] = mem[2];
+        mem[2] = y;
+
+        Out[i] = sat16((y + 128) >> 8);
+    }
+}
+
+/*----------------------------------------------------------------*
+ *  calculation of auto correlation, on a copy of the data
+ *  scaled so that the sums fit in 32 bit
+ *---------------------------------------------------------------*/
+
+void autocorrFix(
+    int32_t *r,         /* (o) autocorrelation vector */
+    const int16_t *x,   /* (i) data vector */
+    int N,              /* (i) length of data vector */
+    int order           /* (i) largest lag */
+){
+    int16_t xs[BLOCKL_MAX];
+    dot16_fn Dot = dot16Select();
+    int lag, shift;
+
+    shift = headroomFix(maxAbsFix(x, N), (30 - bitsFix(N)) / 2);
+    shiftFix(xs, x, N, shift);
+
+    for (lag = 0; lag <= order; lag++) {
+        r[lag] = Dot(xs, xs+lag, N-lag);
+    }
+}
+
+/*----------------------------------------------------------------*
+ *  levinson-durbin solution for lpc coefficients, in 64 bit on
+ *  the autocorrelation normalized to 24 bits
+ *---------------------------------------------------------------*/
+
+void levdurbFix(
+    int32_t *a,         /* (o) lpc coefficients, Q24 */
+    const int32_t *r,   /* (i) autocorrelation vector */
+    int order           /* (i) order of lpc filter */
+){
+    int64_t A[LPC_FILTERORDER+1], R[LPC_FILTERORDER+1];
+    int64_t k, sum, alpha, tmp;
+    int m, m_h, i, sh;
+
+    memset(A, 0, sizeof(A));
+    A[0] = (int64_t)1 << 28;
+
+    if (r[0] > 0) {
+        sh = bitsFix((uint32_t)r[0]) - 24;
+        for (i = 0; i <= order; i++) {
+            R[i] = sh > 0 ? (int64_t)(r[i] >> sh) :
+                (int64_t)r[i] * ((int64_t)1 << -sh);
+        }
+
+        k = -(R[1] * ((int64_t)1 << 28)) / R[0];
+        A[1] = k;
+        alpha = R[0] - ((((k * k) >> 28) * R[0]) >> 28);
+
+        for (m = 1; m < order && alpha > 0; m++) {
+            sum = R[m + 1] * ((int64_t)1 << 28);
+            for (i = 0; i < m; i++) {
+                sum += A[i+1] * R[m - i];
+            }
+            k = -sum / alpha;
+
+            /* keep the stable lower order filter */
+            if (k >= ((int64_t)1 << 28) || k <= -((int64_t)1 << 28)) {
+                break;
+            }
+            alpha -= (((k * k) >> 28) * alpha) >> 28;
+
+            m_h = (m + 1) >> 1;
+            for (i = 0; i < m_h; i++) {
+                tmp = A[i+1] + ((k * A[m - i]) >> 28);
+                A[m - i] += (k * A[i+1]) >> 28;
+                A[i+1] = tmp;
+            }
+            A[m+1] = k;
+        }
+    }
+
+    for (i = 0; i <= order; i++) {
+        a[i] = (int32_t)((A[i] + 8) >> 4);
+    }
+}
+
+/*----------------------------------------------------------------*
+ *  interpolation between vectors
+ *---------------------------------------------------------------*/
+
+void interpolateFix(
+    int16_t *out,       /* (o) coef*in1 + (1-coef)*in2 */
+    const int16_t *in1, /* (i) first vector */
+    const int16_t *in2, /* (i) second vector */
+    int16_t coef,       /* (i) interpolation weight, Q14 */
+    int length          /* (i) length of all vectors */
+){
+    int i;
+    int32_t invcoef = 16384 - coef;
+
+    for (i = 0; i < length; i++) {
+        out[i] = (int16_t)((coef * in1[i] + invcoef * in2[i] + 8192)
+            >> 14);
+    }
+}
+
+/*----------------------------------------------------------------*
+ *  lpc bandwidth expansion
+ *---------------------------------------------------------------*/
+
+void bwexpandFix(
+    int16_t *out,       /* (o) bandwidth expanded coefficients */
+    const int16_t *in,  /* (i) lpc coefficients */
+    const int16_t *chirp,/* (i) coef^k, Q15 */
+    int length          /* (i) length of the coefficient vectors */
+){
+    int i;
+
+    out[0] = in[0];
+    for (i = 1; i < length; i++) {
+        out[i] = (int16_t)(((int32_t)in[i] * chirp[i] + 16384) >> 15);
+    }
+}
+
+/*----------------------------------------------------------------*
+ *  vector quantization
+ *---------------------------------------------------------------*/
+
+static void vqFix(
+    int16_t *Xq,        /* (o) the quantized vector */
+    int *index,         /* (o) the quantization index */
+    const int16_t *CB,  /* (i) the vector quantization codebook */
+    const int16_t *X,   /* (i) the vector to quantize */
+    int n_cb,           /* (i) the number of vectors in the codebook */
+    int dim             /* (i) the dimension of all vectors */
+){
+    int i, j;
+    int pos, minindex;
+    int32_t tmp;
+    int64_t dist, mindist;
+
+    pos = 0;
+    mindist = INT64_MAX;
+    minindex = 0;
+    for (j = 0; j < n_cb; j++) {
+        dist = 0;
+        for (i = 0; i < dim; i++) {
+            tmp = X[i] - CB[pos + i];
+            dist += tmp*tmp;
+        }
+        if (dist < mindist) {
+            mindist = dist;
+            minindex = j;
+        }
+        pos += dim;
+    }
+    for (i = 0; i < dim; i++) {
+        Xq[i] = CB[minindex*dim + i];
+    }
+    *index = minindex;
+}
+
+/*----------------------------------------------------------------*
+ *  split vector quantization
+ *---------------------------------------------------------------*/
+
+void SplitVQFix(
+    int16_t *qX,        /* (o) the quantized vector */
+    int *index,         /* (o) the indexes of the splits */
+    const int16_t *X,   /* (i) the vector to quantize */
+    const int16_t *CB,  /* (i) the quantizer codebook */
+    int nsplit,         /* (i) the number of vector splits */
+    const int *dim,     /* (i) the dimension of the splits */
+    const int *cbsize   /* (i) the number of vectors per split */
+){
+    int cb_pos, X_pos, i;
+
+    cb_pos = 0;
+    X_pos= 0;
+    for (i = 0; i < nsplit; i++) {
+        vqFix(qX + X_pos, index + i, CB + cb_pos, X + X_pos,
+            cbsize[i], dim[i]);
+        X_pos += dim[i];
+        cb_pos += dim[i] * cbsize[i];
+    }
+}
+
+/*----------------------------------------------------------------*
+ *  check for stability of lsf coefficients
+ *---------------------------------------------------------------*/
+
+int LSF_checkFix(
+    int16_t *lsf,       /* (i/o) lsf vectors, Q13 */
+    int dim,            /* (i) the dimension of each lsf vector */
+    int NoAn            /* (i) the number of lsf vectors */
+){
+    int k,n,m, Nit=2, change=0,pos;
+    const int16_t eps=319;      /* 0.039, 50 Hz */
+    const int16_t eps2=160;     /* 0.0195 */
+    const int16_t maxlsf=25723; /* 3.14, 4000 Hz */
+    const int16_t minlsf=82;    /* 0.01, 0 Hz */
+
+    /* LSF separation check*/
+
+    for (n=0; n<Nit; n++) { /* Run through a couple of times */
+        for (m=0; m<NoAn; m++) { /* Number of analyses per frame */
+            for (k=0; k<(dim-1); k++) {
+                pos=m*dim+k;
+
+                if ((lsf[pos+1]-lsf[pos])<eps) {
+
+                    if (lsf[pos+1]<lsf[pos]) {
+                        lsf[pos+1]= lsf[pos]+eps2;
+                        lsf[pos]= lsf[pos+1]-eps2;
+                    } else {
+                        lsf[pos]-=eps2;
+                        lsf[pos+1]+=eps2;
+                    }
+                    change=1;
+                }
+
+                if (lsf[pos]<minlsf) {
+                    lsf[pos]=minlsf;
+                    change=1;
+                }
+
+                if (lsf[pos]>maxlsf) {
+                    lsf[pos]=maxlsf;
+                    change=1;
+                }
+            }
+        }
+    }
+
+    return change;
+}
@@ -0,0 +1,171 @@
+/******************************************************************
+
+    iLBC Speech Coder ANSI-C Source Code
+
+    helpfunFix.h
+
+    Fixed point arithmetic, filters and LPC helper functions
+
+******************************************************************/
+
+#ifndef __iLBC_HELPFUNFIX_H
+#define __iLBC_HELPFUNFIX_H
+
+#include "iLBC_defineFix.h"
+
+/*----------------------------------------------------------------*
+ *  saturation to 16 bit
+ *---------------------------------------------------------------*/
+
+static __inline int16_t sat16(int32_t x)
+{
+    return (int16_t)(x > 32767 ? 32767 : (x < -32768 ? -32768 : x));
+}
+
+static __inline int16_t sat16_64(int64_t x)
+{
+    return (int16_t)(x > 32767 ? 32767 : (x < -32768 ? -32768 : x));
+}
+
+/*----------------------------------------------------------------*
+ *  number of significant bits of x, 0 for x = 0
+ *---------------------------------------------------------------*/
+
+static __inline int bitsFix(uint32_t x)
+{
+    int n = 0;
+
+    while (x) {
+        n++;
+        x >>= 1;
+    }
+    return n;
+}
+
+int32_t maxAbsFix(         /* (o) max |x[i]| */
+    const int16_t *x,   /* (i) vector */
+    int len             /* (i) length of the vector */
+);
+
+int headroomFix(        /* (o) right shift of the samples */
+    int32_t maxAbs,     /* (i) max |x[i]| of the vectors */
+    int maxBits         /* (i) bits allowed for the samples */
+);
+
+void shiftFix(
+    int16_t *out,       /* (o) x[i] >> shift, may be x */
+    const int16_t *x,   /* (i) vector */
+    int len,            /* (i) length of the vector */
+    int shift           /* (i) right shift, left when negative */
+);
+
+uint32_t sqrtFix(       /* (o) floor(sqrt(x)) */
+    uint64_t x          /* (i) value */
+);
+
+/*----------------------------------------------------------------*
+ *  filters, Q12 coefficients with Coef[0] = 1.0
+ *---------------------------------------------------------------*/
+
+void AllPoleFilterFix(
+    int16_t *InOut,     /* (i/o) InOut[-orderCoef..-1] is the
+                               state, InOut[0..lengthInOut-1] the
+                               input and on exit the output */
+    const int16_t *Coef,/* (i) filter coefficients */
+    int lengthInOut,    /* (i) number of input/output samples */
+    int orderCoef       /* (i) number of filter coefficients */
+);
+
+void AllZeroFilterFix(
+    const int16_t *In,  /* (i) In[-orderCoef..lengthInOut-1] */
+    const int16_t *Coef,/* (i) filter coefficients */
+    int lengthInOut,    /* (i) number of input/output samples */
+    int orderCoef,      /* (i) number of filter coefficients */
+    int16_t *Out        /* (o) filtered samples */
+);
+
+void ZeroPoleFilterFix(
+    const int16_t *In,      /* (i) In[-orderCoef..lengthInOut-1] */
+    const int16_t *ZeroCoef,/* (i) all-zero section coefficients */
+    const int16_t *PoleCoef,/* (i) all-pole section coefficients */
+    int lengthInOut,        /* (i) number of input/output samples */
+    int orderCoef,          /* (i) number of filter coefficients */
+    int16_t *Out            /* (i/o) Out[-orderCoef..-1] is the state
+                                   of the all-pole section, on exit
+                                   Out[0..lengthInOut-1] is the
+                                   output */
+);
+
+void syntFilterFix(
+    int16_t *Out,       /* (i/o) Signal to be filtered */
+    const int16_t *a,   /* (i) LP parameters */
+    int len,            /* (i) Length of signal */
+    int16_t *mem        /* (i/o) Filter state */
+);
+
+void anaFilterFix(
+    const int16_t *In,  /* (i) Signal to be filtered */
+    const int16_t *a,   /* (i) LP parameters */
+    int len,            /* (i) Length of signal */
+    int16_t *Out,       /* (o) Filtered signal */
+    int16_t *mem        /* (i/o) Filter state */
+);
+
+void hpFilterFix(
+    const int16_t *In,      /* (i) vector to filter */
+    int len,                /* (i) length of vector to filter */
+    int16_t *Out,           /* (o) the resulting filtered vector */
+    int32_t *mem,           /* (i/o) the filter state */
+    const int32_t *zero,    /* (i) numerator, Q28 */
+    const int32_t *pole     /* (i) denominator, Q28 */
+);
+
+/*----------------------------------------------------------------*
+ *  LPC helpers
+ *---------------------------------------------------------------*/
+
+void autocorrFix(
+    int32_t *r,         /* (o) autocorrelation vector */
+    const int16_t *x,   /* (i) data vector */
+    int N,              /* (i) length of data vector */
+    int order           /* (i) largest lag */
+);
+
+void levdurbFix(
+    int32_t *a,         /* (o) lpc coefficients, Q24 */
+    const int32_t *r,   /* (i) autocorrelation vector */
+    int order           /* (i) order of lpc filter */
+);
+
+void interpolateFix(
+    int16_t *out,       /* (o) coef*in1 + (1-coef)*in2 */
+    const int16_t *in1, /* (i) first vector */
+    const int16_t *in2, /* (i) second vector */
+    int16_t coef,       /* (i) interpolation weight, Q14 */
+    int length          /* (i) length of all vectors */
+);
+
+void bwexpandFix(
+    int16_t *out,       /* (o) bandwidth expanded coefficients */
+    const int16_t *in,  /* (i) lpc coefficients */
+    const int16_t *chirp,/* (i) coef^k, Q15 */
+    int length          /* (i) length of the coefficient vectors */
+);
+
+void SplitVQFix(
+    int16_t *qX,        /* (o) the quantized vector */
+    int *index,         /* (o) the indexes of the splits */
+    const int16_t *X,   /* (i) the vector to quantize */
+    const int16_t *CB,  /* (i) the quantizer codebook */
+    int nsplit,         /* (i) the number of vector splits */
+    const int *dim,     /* (i) the dimension of the splits */
+    const int *cbsize   /* (i) the number of vectors per split */
+);
+
+int LSF_checkFix(       /* (o) 1 if the lsf vectors changed */
+    int16_t *lsf,       /* (i/o) lsf vectors, Q13 */
+    int dim,            /* (i) the dimension of each lsf vector */
+    int NoAn            /* (i) the number of lsf vectors */
+);
+
+#endif
@@ -0,0 +1,554 @@
+/******************************************************************
+
+    iLBC Speech Coder ANSI-C Source Code
+
+    iLBC_decodeFix.c
+
+    Fixed point decoder (iLBC_decode.c)
+
+******************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "iLBC_defineFix.h"
+#include "constantsFix.h"
+#include "helpfunFix.h"
+#include "cbSearchSimdFix.h"
+#include "LPCFix.h"
+#include "StateFix.h"
+#include "cbFix.h"
+#include "doCPLCFix.h"
+#include "iLBC_decodeFix.h"
+#include "../constants.h"
+#include "../packing.h"
+#include "../iCBConstruct.h"
+
+/* bits of the residual in the last lag search, 80 squares of 12 bit
+   samples fit the 32 bit sums */
+#define LAG_CORR_BITS       12
+
+/*----------------------------------------------------------------*
+ *  Initiation of decoder instance.
+ *---------------------------------------------------------------*/
+
+short initDecodeFix(                /* (o) Number of decoded samples */
+    iLBCfix_Dec_Inst_t *iLBCdec_inst,/* (i/o) Decoder instance */
+    int mode                        /* (i) frame size mode */
+){
+    iLBCdec_inst->mode = mode;
+
+    if (mode==30) {
+        iLBCdec_inst->blockl = BLOCKL_30MS;
+        iLBCdec_inst->nsub = NSUB_30MS;
+        iLBCdec_inst->nasub = NASUB_30MS;
+        iLBCdec_inst->lpc_n = LPC_N_30MS;
+        iLBCdec_inst->no_of_bytes = NO_OF_BYTES_30MS;
+        iLBCdec_inst->no_of_words = NO_OF_WORDS_30MS;
+        iLBCdec_inst->state_short_len=STATE_SHORT_LEN_30MS;
+        /* ULP init */
+        iLBCdec_inst->ULP_inst=&ULP_30msTbl;
+    }
+    else if (mode==20) {
+        iLBCdec_inst->blockl = BLOCKL_20MS;
+        iLBCdec_inst->nsub = NSUB_20MS;
+        iLBCdec_inst->nasub = NASUB_20MS;
+        iLBCdec_inst->lpc_n = LPC_N_20MS;
+        iLBCdec_inst->no_of_bytes = NO_OF_BYTES_20MS;
+        iLBCdec_inst->no_of_words = NO_OF_WORDS_20MS;
+        iLBCdec_inst->state_short_len=STATE_SHORT_LEN_20MS;
+        /* ULP init */
+        iLBCdec_inst->ULP_inst=&ULP_20msTbl;
+    }
+    else {
+        exit(2);
+    }
+
+    memset(iLBCdec_inst->syntMem, 0,
+        LPC_FILTERORDER*sizeof(int16_t));
+    memcpy((*iLBCdec_inst).lsfdeqold, lsfmeanTblFix,
+        LPC_FILTERORDER*sizeof(int16_t));
+
+    iLBCdec_inst->last_lag = 20;
+
+    iLBCdec_inst->prevLag = 120;
+    iLBCdec_inst->per = 0;
+    iLBCdec_inst->consPLICount = 0;
+    iLBCdec_inst->prevPLI = 0;
+    iLBCdec_inst->prevLpc[0] = LPC_ONE_Q12;
+    memset(iLBCdec_inst->prevLpc+1,0,
+        LPC_FILTERORDER*sizeof(int16_t));
+    memset(iLBCdec_inst->prevResidual, 0, BLOCKL_MAX*sizeof(int16_t));
+    iLBCdec_inst->seed=777;
+
+    memset(iLBCdec_inst->hpomem, 0, 4*sizeof(int32_t));
+
+    return (iLBCdec_inst->blockl);
+}
+
+/*----------------------------------------------------------------*
+ *  frame residual decoder function (subrutine to iLBC_decodeFix)
+ *---------------------------------------------------------------*/
+
+static void DecodeFix(
+    iLBCfix_Dec_Inst_t *iLBCdec_inst,/* (i/o) the decoder state
+                                             structure */
+    int16_t *decresidual,           /* (o) decoded residual frame */
+    int start,                      /* (i) location of start
+                                           state */
+    int idxForMax,                  /* (i) codebook index for the
+                                           maximum value */
+    const int *idxVec,              /* (i) codebook indexes for the
+                                           samples  in the start
+                                           state */
+    const int16_t *syntdenum,       /* (i) the decoded synthesis
+                                           filter coefficients */
+    const int *cb_index,            /* (i) the indexes for the
+                                           adaptive codebook */
+    const int *gain_index,          /* (i) the indexes for the
+                                           corresponding gains */
+    const int *extra_cb_index,      /* (i) the indexes for the
+                                           adaptive codebook part
+                                           of start state */
+    const int *extra_gain_index,    /* (i) the indexes for the
+                                           corresponding gains */
+    int state_first                 /* (i) 1 if non adaptive part
+                                           of start state comes
+                                           first 0 if that part
+                                           comes last */
+){
+    int16_t reverseDecresidual[BLOCKL_MAX], mem[CB_MEML];
+    int k, meml_gotten, Nfor, Nback, i;
+    int diff, start_pos;
+    int subcount, subframe;
+
+    diff = STATE_LEN - iLBCdec_inst->state_short_len;
+
+    if (state_first == 1) {
+        start_pos = (start-1)*SUBL;
+    } else {
+        start_pos = (start-1)*SUBL + diff;
+    }
+
+    /* decode scalar part of start state */
+
+    StateConstructWFix(idxForMax, idxVec,
+        &syntdenum[(start-1)*(LPC_FILTERORDER+1)],
+        &decresidual[start_pos], iLBCdec_inst->state_short_len);
+
+
+    if (state_first) { /* put adaptive part in the end */
+
+        /* setup memory */
+
+        memset(mem, 0,
+            (CB_MEML-iLBCdec_inst->state_short_len)*sizeof(int16_t));
+        memcpy(mem+CB_MEML-iLBCdec_inst->state_short_len,
+            decresidual+start_pos,
+            iLBCdec_inst->state_short_len*sizeof(int16_t));
+
+        /* construct decoded vector */
+
+        iCBConstructFix(
+            &decresidual[start_pos+iLBCdec_inst->state_short_len],
+            extra_cb_index, extra_gain_index, mem+CB_MEML-stMemLTbl,
+            stMemLTbl, diff, CB_NSTAGES);
+
+    }
+    else {/* put adaptive part in the beginning */
+
+        /* create reversed vectors for prediction */
+
+        for (k=0; k<diff; k++) {
+            reverseDecresidual[k] =
+                decresidual[(start+1)*SUBL-1-
+                        (k+iLBCdec_inst->state_short_len)];
+        }
+
+        /* setup memory */
+
+        meml_gotten = iLBCdec_inst->state_short_len;
+        for (k=0; k<meml_gotten; k++){
+            mem[CB_MEML-1-k] = decresidual[start_pos + k];
+        }
+        memset(mem, 0, (CB_MEML-k)*sizeof(int16_t));
+
+        /* construct decoded vector */
+
+        iCBConstructFix(reverseDecresidual, extra_cb_index,
+            extra_gain_index, mem+CB_MEML-stMemLTbl, stMemLTbl,
+            diff, CB_NSTAGES);
+
+        /* get decoded residual from reversed vector */
+
+        for (k=0; k<diff; k++) {
+            decresidual[start_pos-1-k] = reverseDecresidual[k];
+        }
+    }
+
+    /* counter for predicted sub-frames */
+
+    subcount=0;
+
+    /* forward prediction of sub-frames */
+
+    Nfor = iLBCdec_inst->nsub-start-1;
+
+    if ( Nfor > 0 ){
+
+        /* setup memory */
+
+        memset(mem, 0, (CB_MEML-STATE_LEN)*sizeof(int16_t));
+        memcpy(mem+CB_MEML-STATE_LEN, decresidual+(start-1)*SUBL,
+            STATE_LEN*sizeof(int16_t));
+
+        /* loop over sub-frames to encode */
+
+        for (subframe=0; subframe<Nfor; subframe++) {
+
+            /* construct decoded vector */
+
+            iCBConstructFix(&decresidual[(start+1+subframe)*SUBL],
+                cb_index+subcount*CB_NSTAGES,
+                gain_index+subcount*CB_NSTAGES,
+                mem+CB_MEML-memLfTbl[subcount],
+                memLfTbl[subcount], SUBL, CB_NSTAGES);
+
+            /* update memory */
+
+            memmove(mem, mem+SUBL, (CB_MEML-SUBL)*sizeof(int16_t));
+            memcpy(mem+CB_MEML-SUBL,
+                &decresidual[(start+1+subframe)*SUBL],
+                SUBL*sizeof(int16_t));
+
+            subcount++;
+
+        }
+
+    }
+
+    /* backward prediction of sub-frames */
+
+    Nback = start-1;
+
+    if ( Nback > 0 ) {
+
+        /* setup memory */
+
+        meml_gotten = SUBL*(iLBCdec_inst->nsub+1-start);
+
+        if ( meml_gotten > CB_MEML ) {
+            meml_gotten=CB_MEML;
+        }
+        for (k=0; k<meml_gotten; k++) {
+            mem[CB_MEML-1-k] = decresidual[(start-1)*SUBL + k];
+        }
+        memset(mem, 0, (CB_MEML-k)*sizeof(int16_t));
+
+        /* loop over subframes to decode */
+
+        for (subframe=0; subframe<Nback; subframe++) {
+
+            /* construct decoded vector */
+
+            iCBConstructFix(&reverseDecresidual[subframe*SUBL],
+                cb_index+subcount*CB_NSTAGES,
+                gain_index+subcount*CB_NSTAGES,
+                mem+CB_MEML-memLfTbl[subcount], memLfTbl[subcount],
+                SUBL, CB_NSTAGES);
+
+            /* update memory */
+
+            memmove(mem, mem+SUBL, (CB_MEML-SUBL)*sizeof(int16_t));
+            memcpy(mem+CB_MEML-SUBL,
+                &reverseDecresidual[subframe*SUBL],
+                SUBL*sizeof(int16_t));
+
+            subcount++;
+        }
+
+        /* get decoded residual from reversed vector */
+
+        for (i=0; i<SUBL*Nback; i++)
+            decresidual[SUBL*Nback - i - 1] =
+            reverseDecresidual[i];
+    }
+}
+
+/*----------------------------------------------------------------*
+ *  pitch lag of the last ENH_BLOCKL samples of the decoded
+ *  residual, kept for the PLC of the next frame. The float decoder
+ *  searches at BLOCKL_MAX-ENH_BLOCKL also in the 20 ms mode; here
+ *  the search stays inside the frame.
+ *---------------------------------------------------------------*/
+
+static int lastLagFix(          /* (o) pitch lag */
+    const int16_t *decresidual, /* (i) decoded residual frame */
+    int blockl                  /* (i) frame length */
+){
+    int16_t scaled[BLOCKL_MAX];
+    const int16_t *target;
+    int64_t cc, maxcc;
+    int32_t ftmp1, ftmp2;
+    int lag, ilag, maxlag;
+    dot16_fn dot = dot16Select();
+
+    shiftFix(scaled, decresidual, blockl,
+        headroomFix(maxAbsFix(decresidual, blockl), LAG_CORR_BITS));
+    target = scaled+blockl-ENH_BLOCKL;
+
+    maxlag = blockl-ENH_BLOCKL;
+    if (maxlag > 119) {
+        maxlag = 119;
+    }
+
+    lag = 20;
+    maxcc = -1;
+    for (ilag=20; ilag<=maxlag; ilag++) {
+        ftmp1 = dot(target, target-ilag, ENH_BLOCKL);
+        ftmp2 = dot(target-ilag, target-ilag, ENH_BLOCKL);
+        cc = 0;
+        if (ftmp1 > 0) {
+            cc = (int64_t)ftmp1*ftmp1/ftmp2;
+        }
+        if (cc > maxcc) {
+            maxcc = cc;
+            lag = ilag;
+        }
+    }
+
+    return lag;
+}
+
+/*----------------------------------------------------------------*
+ *  main decoder function
+ *---------------------------------------------------------------*/
+
+void iLBC_decodeFix(
+    short *decblock,                /* (o) decoded signal block */
+    unsigned char *bytes,           /* (i) encoded signal bits */
+    iLBCfix_Dec_Inst_t *iLBCdec_inst,/* (i/o) the decoder state
+                                           structure */
+    int mode                        /* (i) 0: bad packet, PLC,
+                                           1: normal */
+){
+    int16_t data[BLOCKL_MAX];
+    int16_t lsfdeq[LPC_FILTERORDER*LPC_N_MAX];
+    int16_t PLCresidual[BLOCKL_MAX], PLClpc[LPC_FILTERORDER + 1];
+    int16_t zeros[BLOCKL_MAX], one[LPC_FILTERORDER + 1];
+    int k, i, start, idxForMax, pos, lastpart, ulp;
+    int idxVec[STATE_LEN];
+    int gain_index[NASUB_MAX*CB_NSTAGES],
+        extra_gain_index[CB_NSTAGES];
+    int cb_index[CB_NSTAGES*NASUB_MAX], extra_cb_index[CB_NSTAGES];
+    int lsf_i[LSF_NSPLIT*LPC_N_MAX];
+    int state_first;
+    int last_bit;
+    unsigned char *pbytes;
+    int order_plus_one;
+    int16_t syntdenum[NSUB_MAX*(LPC_FILTERORDER+1)];
+    int16_t decresidual[BLOCKL_MAX];
+
+    if (mode>0) { /* the data are good */
+
+        /* decode data */
+
+        pbytes=bytes;
+        pos=0;
+
+        /* Set everything to zero before decoding */
+
+        for (k=0; k<LSF_NSPLIT*LPC_N_MAX; k++) {
+            lsf_i[k]=0;
+        }
+        start=0;
+        state_first=0;
+        idxForMax=0;
+        for (k=0; k<iLBCdec_inst->state_short_len; k++) {
+            idxVec[k]=0;
+        }
+        for (k=0; k<CB_NSTAGES; k++) {
+            extra_cb_index[k]=0;
+        }
+        for (k=0; k<CB_NSTAGES; k++) {
+            extra_gain_index[k]=0;
+        }
+        for (i=0; i<iLBCdec_inst->nasub; i++) {
+            for (k=0; k<CB_NSTAGES; k++) {
+                cb_index[i*CB_NSTAGES+k]=0;
+            }
+        }
+        for (i=0; i<iLBCdec_inst->nasub; i++) {
+            for (k=0; k<CB_NSTAGES; k++) {
+                gain_index[i*CB_NSTAGES+k]=0;
+            }
+        }
+
+        /* loop over ULP classes */
+
+        for (ulp=0; ulp<3; ulp++) {
+
+            /* LSF */
+            for (k=0; k<LSF_NSPLIT*iLBCdec_inst->lpc_n; k++){
+                unpack( &pbytes, &lastpart,
+                    iLBCdec_inst->ULP_inst->lsf_bits[k][ulp], &pos);
+                packcombine(&lsf_i[k], lastpart,
+                    iLBCdec_inst->ULP_inst->lsf_bits[k][ulp]);
+            }
+
+            /* Start block info */
+
+            unpack( &pbytes, &lastpart,
+                iLBCdec_inst->ULP_inst->start_bits[ulp], &pos);
+            packcombine(&start, lastpart,
+                iLBCdec_inst->ULP_inst->start_bits[ulp]);
+
+            unpack( &pbytes, &lastpart,
+                iLBCdec_inst->ULP_inst->startfirst_bits[ulp], &pos);
+
+            packcombine(&state_first, lastpart,
+                iLBCdec_inst->ULP_inst->startfirst_bits[ulp]);
+
+            unpack( &pbytes, &lastpart,
+                iLBCdec_inst->ULP_inst->scale_bits[ulp], &pos);
+            packcombine(&idxForMax, lastpart,
+                iLBCdec_inst->ULP_inst->scale_bits[ulp]);
+
+            for (k=0; k<iLBCdec_inst->state_short_len; k++) {
+                unpack( &pbytes, &lastpart,
+                    iLBCdec_inst->ULP_inst->state_bits[ulp], &pos);
+                packcombine(idxVec+k, lastpart,
+                    iLBCdec_inst->ULP_inst->state_bits[ulp]);
+            }
+
+            /* 23/22 (20ms/30ms) sample block */
+
+            for (k=0; k<CB_NSTAGES; k++) {
+                unpack( &pbytes, &lastpart,
+                    iLBCdec_inst->ULP_inst->extra_cb_index[k][ulp],
+                    &pos);
+                packcombine(extra_cb_index+k, lastpart,
+                    iLBCdec_inst->ULP_inst->extra_cb_index[k][ulp]);
+            }
+            for (k=0; k<CB_NSTAGES; k++) {
+                unpack( &pbytes, &lastpart,
+                    iLBCdec_inst->ULP_inst->extra_cb_gain[k][ulp],
+                    &pos);
+                packcombine(extra_gain_index+k, lastpart,
+                    iLBCdec_inst->ULP_inst->extra_cb_gain[k][ulp]);
+            }
+
+            /* The two/four (20ms/30ms) 40 sample sub-blocks */
+
+            for (i=0; i<iLBCdec_inst->nasub; i++) {
+                for (k=0; k<CB_NSTAGES; k++) {
+                    unpack( &pbytes, &lastpart,
+                    iLBCdec_inst->ULP_inst->cb_index[i][k][ulp],
+                        &pos);
+                    packcombine(cb_index+i*CB_NSTAGES+k, lastpart,
+                    iLBCdec_inst->ULP_inst->cb_index[i][k][ulp]);
+                }
+            }
+
+            for (i=0; i<iLBCdec_inst->nasub; i++) {
+                for (k=0; k<CB_NSTAGES; k++) {
+                    unpack( &pbytes, &lastpart,
+                    iLBCdec_inst->ULP_inst->cb_gain[i][k][ulp],
+                        &pos);
+                    packcombine(gain_index+i*CB_NSTAGES+k, lastpart,
+                        iLBCdec_inst->ULP_inst->cb_gain[i][k][ulp]);
+                }
+            }
+        }
+        /* Extract last bit. If it is 1 this indicates an
+           empty/lost frame */
+        unpack( &pbytes, &last_bit, 1, &pos);
+
+        /* Check for bit errors or empty/lost frames */
+        if (start<1)
+            mode = 0;
+        if (iLBCdec_inst->mode==20 && start>3)
+            mode = 0;
+        if (iLBCdec_inst->mode==30 && start>5)
+            mode = 0;
+        if (last_bit==1)
+            mode = 0;
+
+        if (mode==1) { /* No bit errors was detected,
+                          continue decoding */
+
+            /* adjust index */
+            index_conv_dec(cb_index);
+
+            /* decode the lsf */
+
+            SimplelsfDEQFix(lsfdeq, lsf_i, iLBCdec_inst->lpc_n);
+            LSF_checkFix(lsfdeq, LPC_FILTERORDER,
+                iLBCdec_inst->lpc_n);
+            DecoderInterpolateLSFFix(syntdenum, lsfdeq, iLBCdec_inst);
+
+            DecodeFix(iLBCdec_inst, decresidual, start, idxForMax,
+                idxVec, syntdenum, cb_index, gain_index,
+                extra_cb_index, extra_gain_index,
+                state_first);
+
+            /* preparing the plc for a future loss! */
+
+            doThePLCFix(PLCresidual, PLClpc, 0, decresidual,
+                syntdenum +
+                (LPC_FILTERORDER + 1)*(iLBCdec_inst->nsub - 1),
+                (*iLBCdec_inst).last_lag, iLBCdec_inst);
+
+            memcpy(decresidual, PLCresidual,
+                iLBCdec_inst->blockl*sizeof(int16_t));
+        }
+
+    }
+
+    if (mode == 0) {
+        /* the data is bad (either a PLC call
+         * was made or a severe bit error was detected)
+         */
+
+        /* packet loss conceal */
+
+        memset(zeros, 0, BLOCKL_MAX*sizeof(int16_t));
+
+        one[0] = LPC_ONE_Q12;
+        memset(one+1, 0, LPC_FILTERORDER*sizeof(int16_t));
+
+        start=0;
+
+        doThePLCFix(PLCresidual, PLClpc, 1, zeros, one,
+            (*iLBCdec_inst).last_lag, iLBCdec_inst);
+        memcpy(decresidual, PLCresidual,
+            iLBCdec_inst->blockl*sizeof(int16_t));
+
+        order_plus_one = LPC_FILTERORDER + 1;
+        for (i = 0; i < iLBCdec_inst->nsub; i++) {
+            memcpy(syntdenum+(i*order_plus_one), PLClpc,
+                order_plus_one*sizeof(int16_t));
+        }
+    }
+
+    /* Find last lag */
+
+    iLBCdec_inst->last_lag = lastLagFix(decresidual,
+        iLBCdec_inst->blockl);
+
+    /* copy data and run synthesis filter */
+
+    memcpy(data, decresidual,
+        iLBCdec_inst->blockl*sizeof(int16_t));
+    for (i=0; i < iLBCdec_inst->nsub; i++) {
+        syntFilterFix(data + i*SUBL,
+            syntdenum + i*(LPC_FILTERORDER+1), SUBL,
+            iLBCdec_inst->syntMem);
+    }
+
+    /* high pass filtering on output */
+
+    hpFilterFix(data, iLBCdec_inst->blockl, decblock,
+        iLBCdec_inst->hpomem, hpo_zero_coefsTblFix,
+        hpo_pole_coefsTblFix);
+}
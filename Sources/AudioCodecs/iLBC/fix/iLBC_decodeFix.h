@@ -0,0 +1,30 @@
+/******************************************************************
+
+    iLBC Speech Coder ANSI-C Source Code
+
+    iLBC_decodeFix.h
+
+    Fixed point decoder
+
+******************************************************************/
+
+#ifndef __iLBC_ILBCDECODEFIX_H
+#define __iLBC_ILBCDECODEFIX_H
+
+#include "iLBC_defineFix.h"
+
+short initDecodeFix(                /* (o) Number of decoded samples */
+    iLBCfix_Dec_Inst_t *iLBCdec_inst,/* (i/o) Decoder instance */
+    int mode                        /* (i) frame size mode */
+);
+
+void iLBC_decodeFix(
+    short *decblock,                /* (o) decoded signal block */
+    unsigned char *bytes,           /* (i) encoded signal bits */
+    iLBCfix_Dec_Inst_t *iLBCdec_inst,/* (i/o) the decoder state
+                                           structure */
+    int mode                        /* (i) 0: bad packet, PLC,
+                                           1: normal */
+);
+
+#endif
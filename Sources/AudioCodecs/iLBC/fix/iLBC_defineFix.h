@@ -0,0 +1,104 @@
+/******************************************************************
+
+    iLBC Speech Coder ANSI-C Source Code
+
+    iLBC_defineFix.h
+
+    Fixed point encoder and decoder instances
+
+******************************************************************/
+
+/*
+   The fixed point codec writes and reads the same bitstream as the
+   float one (iLBC_encode.c, iLBC_decode.c) and shares its packing,
+   ULP and codebook search tables. The signals are 16 bit :
+
+      speech, residual, codebook memory    Q0
+      LPC coefficients (a[0] = 1.0)        Q12
+      LSF                                  Q13 radians
+      gains                                Q14
+      scaled start state                   Q11
+
+   The decoder has no enhancer, its output is the one of the float
+   decoder with use_enhancer = 0.
+*/
+
+#ifndef __iLBC_ILBCDEFINEFIX_H
+#define __iLBC_ILBCDEFINEFIX_H
+
+#include <stdint.h>
+#include "../iLBC_define.h"
+
+#define LPC_ONE_Q12             4096
+#define COS_TBL_LEN             128 /* cos table entries over [0,pi] */
+
+/* type definition fixed point encoder instance */
+
+typedef struct iLBCfix_Enc_Inst_t_ {
+
+    /* flag for frame size mode */
+    int mode;
+
+    /* basic parameters for different frame sizes */
+    int blockl;
+    int nsub;
+    int nasub;
+    int no_of_bytes, no_of_words;
+    int lpc_n;
+    int state_short_len;
+    const iLBC_ULP_Inst_t *ULP_inst;
+
+    /* analysis filter state */
+    int16_t anaMem[LPC_FILTERORDER];
+
+    /* old lsf parameters for interpolation */
+    int16_t lsfold[LPC_FILTERORDER];
+    int16_t lsfdeqold[LPC_FILTERORDER];
+
+    /* signal buffer for LP analysis */
+    int16_t lpc_buffer[LPC_LOOKBACK + BLOCKL_MAX];
+
+    /* state of input HP filter, x[n-1], x[n-2] in Q0 and
+       y[n-1], y[n-2] in Q8 */
+    int32_t hpimem[4];
+
+} iLBCfix_Enc_Inst_t;
+
+/* type definition fixed point decoder instance */
+
+typedef struct iLBCfix_Dec_Inst_t_ {
+
+    /* flag for frame size mode */
+    int mode;
+
+    /* basic parameters for different frame sizes */
+    int blockl;
+    int nsub;
+    int nasub;
+    int no_of_bytes, no_of_words;
+    int lpc_n;
+    int state_short_len;
+    const iLBC_ULP_Inst_t *ULP_inst;
+
+    /* synthesis filter state */
+    int16_t syntMem[LPC_FILTERORDER];
+
+    /* old LSF for interpolation */
+    int16_t lsfdeqold[LPC_FILTERORDER];
+
+    /* pitch lag of the last frame, used in PLC */
+    int last_lag;
+
+    /* PLC state information */
+    int prevLag, consPLICount, prevPLI;
+    int16_t prevLpc[LPC_FILTERORDER+1];
+    int16_t prevResidual[NSUB_MAX*SUBL];
+    int16_t per;                    /* periodicity, Q15 */
+    unsigned long seed;
+
+    /* state of output HP filter, as hpimem */
+    int32_t hpomem[4];
+
+} iLBCfix_Dec_Inst_t;
+
+#endif
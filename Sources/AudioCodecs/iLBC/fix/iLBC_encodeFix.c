@@ -0,0 +1,576 @@
+/******************************************************************
+
+    iLBC Speech Coder ANSI-C Source Code
+
+    iLBC_encodeFix.c
+
+    Fixed point encoder (iLBC_encode.c, FrameClassify.c)
+
+******************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "iLBC_defineFix.h"
+#include "constantsFix.h"
+#include "helpfunFix.h"
+#include "LPCFix.h"
+#include "StateFix.h"
+#include "cbFix.h"
+#include "iLBC_encodeFix.h"
+#include "../constants.h"
+#include "../packing.h"
+#include "../iCBConstruct.h"
+
+/*----------------------------------------------------------------*
+ *  Initiation of encoder instance.
+ *---------------------------------------------------------------*/
+
+short initEncodeFix(                /* (o) Number of bytes encoded */
+    iLBCfix_Enc_Inst_t *iLBCenc_inst,/* (i/o) Encoder instance */
+    int mode                        /* (i) frame size mode */
+){
+    iLBCenc_inst->mode = mode;
+    if (mode==30) {
+        iLBCenc_inst->blockl = BLOCKL_30MS;
+        iLBCenc_inst->nsub = NSUB_30MS;
+        iLBCenc_inst->nasub = NASUB_30MS;
+        iLBCenc_inst->lpc_n = LPC_N_30MS;
+        iLBCenc_inst->no_of_bytes = NO_OF_BYTES_30MS;
+        iLBCenc_inst->no_of_words = NO_OF_WORDS_30MS;
+        iLBCenc_inst->state_short_len = STATE_SHORT_LEN_30MS;
+        /* ULP init */
+        iLBCenc_inst->ULP_inst = &ULP_30msTbl;
+    }
+    else if (mode==20) {
+        iLBCenc_inst->blockl = BLOCKL_20MS;
+        iLBCenc_inst->nsub = NSUB_20MS;
+        iLBCenc_inst->nasub = NASUB_20MS;
+        iLBCenc_inst->lpc_n = LPC_N_20MS;
+        iLBCenc_inst->no_of_bytes = NO_OF_BYTES_20MS;
+        iLBCenc_inst->no_of_words = NO_OF_WORDS_20MS;
+        iLBCenc_inst->state_short_len = STATE_SHORT_LEN_20MS;
+        /* ULP init */
+        iLBCenc_inst->ULP_inst = &ULP_20msTbl;
+    }
+    else {
+        exit(2);
+    }
+
+    memset((*iLBCenc_inst).anaMem, 0,
+        LPC_FILTERORDER*sizeof(int16_t));
+    memcpy((*iLBCenc_inst).lsfold, lsfmeanTblFix,
+        LPC_FILTERORDER*sizeof(int16_t));
+    memcpy((*iLBCenc_inst).lsfdeqold, lsfmeanTblFix,
+        LPC_FILTERORDER*sizeof(int16_t));
+    memset((*iLBCenc_inst).lpc_buffer, 0,
+        (LPC_LOOKBACK+BLOCKL_MAX)*sizeof(int16_t));
+    memset((*iLBCenc_inst).hpimem, 0, 4*sizeof(int32_t));
+
+    return (iLBCenc_inst->no_of_bytes);
+}
+
+/*----------------------------------------------------------------*
+ *  classification of subframes to localize start state, the
+ *  sample windows in Q15 and the subframe windows in Q14
+ *---------------------------------------------------------------*/
+
+static int FrameClassifyFix(/* index to the max-energy sub-frame */
+    iLBCfix_Enc_Inst_t *iLBCenc_inst,
+                        /* (i/o) the encoder state structure */
+    const int16_t *residual/* (i) lpc residual signal */
+) {
+    int64_t max_ssqEn, ssqEn, fssqEn[NSUB_MAX], bssqEn[NSUB_MAX];
+    int32_t sq;
+    const int16_t *pp;
+    int n, l, max_ssqEn_n;
+    static const int16_t ssqEn_win[NSUB_MAX-1]={13107, 14746,
+        16384, 14746, 13107};
+    static const int16_t sampEn_win[5]={5461, 10923, 16384,
+        21845, 27307};
+
+    /* init the front and back energies to zero */
+
+    memset(fssqEn, 0, NSUB_MAX*sizeof(int64_t));
+    memset(bssqEn, 0, NSUB_MAX*sizeof(int64_t));
+
+    /* Calculate front of first seqence */
+
+    n=0;
+    pp=residual;
+    for (l=0; l<5; l++) {
+        sq = (int32_t)(*pp) * (*pp);
+        fssqEn[n] += ((int64_t)sampEn_win[l] * sq) >> 15;
+        pp++;
+    }
+    for (l=5; l<SUBL; l++) {
+        fssqEn[n] += (int32_t)(*pp) * (*pp);
+        pp++;
+    }
+
+    /* Calculate front and back of all middle sequences */
+
+    for (n=1; n<iLBCenc_inst->nsub-1; n++) {
+        pp=residual+n*SUBL;
+        for (l=0; l<5; l++) {
+            sq = (int32_t)(*pp) * (*pp);
+            fssqEn[n] += ((int64_t)sampEn_win[l] * sq) >> 15;
+            bssqEn[n] += sq;
+            pp++;
+        }
+        for (l=5; l<SUBL-5; l++) {
+            sq = (int32_t)(*pp) * (*pp);
+            fssqEn[n] += sq;
+            bssqEn[n] += sq;
+            pp++;
+        }
+        for (l=SUBL-5; l<SUBL; l++) {
+            sq = (int32_t)(*pp) * (*pp);
+            fssqEn[n] += sq;
+            bssqEn[n] += ((int64_t)sampEn_win[SUBL-l-1] * sq) >> 15;
+            pp++;
+        }
+    }
+
+    /* Calculate back of last seqence */
+
+    n=iLBCenc_inst->nsub-1;
+    pp=residual+n*SUBL;
+    for (l=0; l<SUBL-5; l++) {
+        bssqEn[n] += (int32_t)(*pp) * (*pp);
+        pp++;
+    }
+    for (l=SUBL-5; l<SUBL; l++) {
+        sq = (int32_t)(*pp) * (*pp);
+        bssqEn[n] += ((int64_t)sampEn_win[SUBL-l-1] * sq) >> 15;
+        pp++;
+    }
+
+    /* find the index to the weighted 80 sample with
+       most energy */
+
+    if (iLBCenc_inst->mode==20) l=1;
+    else                        l=0;
+
+    max_ssqEn=(fssqEn[0]+bssqEn[1])*ssqEn_win[l];
+    max_ssqEn_n=1;
+    for (n=2; n<iLBCenc_inst->nsub; n++) {
+        l++;
+        ssqEn=(fssqEn[n-1]+bssqEn[n])*ssqEn_win[l];
+        if (ssqEn > max_ssqEn) {
+            max_ssqEn=ssqEn;
+            max_ssqEn_n=n;
+        }
+    }
+
+    return max_ssqEn_n;
+}
+
+/*----------------------------------------------------------------*
+ *  main encoder function
+ *---------------------------------------------------------------*/
+
+void iLBC_encodeFix(
+    unsigned char *bytes,           /* (o) encoded data bits iLBC */
+    const short *block,             /* (i) speech vector to encode */
+    iLBCfix_Enc_Inst_t *iLBCenc_inst/* (i/o) the general encoder
+                                           state */
+){
+
+    int16_t data[BLOCKL_MAX];
+    int16_t residual[BLOCKL_MAX], reverseResidual[BLOCKL_MAX];
+
+    int start, idxForMax, idxVec[STATE_LEN];
+    int16_t reverseDecresidual[BLOCKL_MAX], mem[CB_MEML];
+    int n, k, meml_gotten, Nfor, Nback, i, pos;
+    int gain_index[CB_NSTAGES*NASUB_MAX],
+        extra_gain_index[CB_NSTAGES];
+    int cb_index[CB_NSTAGES*NASUB_MAX],extra_cb_index[CB_NSTAGES];
+    int lsf_i[LSF_NSPLIT*LPC_N_MAX];
+    unsigned char *pbytes;
+    int diff, start_pos, state_first;
+    int64_t en1, en2;
+    int index, ulp, firstpart;
+    int subcount, subframe;
+    int16_t weightState[LPC_FILTERORDER];
+    int16_t syntdenum[NSUB_MAX*(LPC_FILTERORDER+1)];
+    int16_t weightdenum[NSUB_MAX*(LPC_FILTERORDER+1)];
+    int16_t decresidual[BLOCKL_MAX];
+
+    /* high pass filtering of input signal */
+
+    hpFilterFix(block, iLBCenc_inst->blockl, data,
+        iLBCenc_inst->hpimem, hpi_zero_coefsTblFix,
+        hpi_pole_coefsTblFix);
+
+    /* LPC of hp filtered input data */
+
+    LPCencodeFix(syntdenum, weightdenum, lsf_i, data, iLBCenc_inst);
+
+
+    /* inverse filter to get residual */
+
+    for (n=0; n<iLBCenc_inst->nsub; n++) {
+        anaFilterFix(&data[n*SUBL], &syntdenum[n*(LPC_FILTERORDER+1)],
+            SUBL, &residual[n*SUBL], iLBCenc_inst->anaMem);
+    }
+
+    /* find state location */
+
+    start = FrameClassifyFix(iLBCenc_inst, residual);
+
+    /* check if state should be in first or last part of the
+    two subframes */
+
+    diff = STATE_LEN - iLBCenc_inst->state_short_len;
+    en1 = 0;
+    index = (start-1)*SUBL;
+
+    for (i = 0; i < iLBCenc_inst->state_short_len; i++) {
+        en1 += (int32_t)residual[index+i]*residual[index+i];
+    }
+    en2 = 0;
+    index = (start-1)*SUBL+diff;
+    for (i = 0; i < iLBCenc_inst->state_short_len; i++) {
+        en2 += (int32_t)residual[index+i]*residual[index+i];
+    }
+
+
+    if (en1 > en2) {
+        state_first = 1;
+        start_pos = (start-1)*SUBL;
+    } else {
+        state_first = 0;
+        start_pos = (start-1)*SUBL + diff;
+    }
+
+    /* scalar quantization of state */
+
+    StateSearchWFix(iLBCenc_inst, &residual[start_pos],
+        &syntdenum[(start-1)*(LPC_FILTERORDER+1)],
+        &weightdenum[(start-1)*(LPC_FILTERORDER+1)], &idxForMax,
+        idxVec, iLBCenc_inst->state_short_len, state_first);
+
+    StateConstructWFix(idxForMax, idxVec,
+        &syntdenum[(start-1)*(LPC_FILTERORDER+1)],
+        &decresidual[start_pos], iLBCenc_inst->state_short_len);
+
+    /* predictive quantization in state */
+
+    if (state_first) { /* put adaptive part in the end */
+
+        /* setup memory */
+
+        memset(mem, 0,
+            (CB_MEML-iLBCenc_inst->state_short_len)*sizeof(int16_t));
+        memcpy(mem+CB_MEML-iLBCenc_inst->state_short_len,
+            decresidual+start_pos,
+            iLBCenc_inst->state_short_len*sizeof(int16_t));
+        memset(weightState, 0, LPC_FILTERORDER*sizeof(int16_t));
+
+        /* encode sub-frames */
+
+        iCBSearchFix(iLBCenc_inst, extra_cb_index, extra_gain_index,
+            &residual[start_pos+iLBCenc_inst->state_short_len],
+            mem+CB_MEML-stMemLTbl,
+            stMemLTbl, diff, CB_NSTAGES,
+            &weightdenum[start*(LPC_FILTERORDER+1)],
+            weightState, 0);
+
+        /* construct decoded vector */
+
+        iCBConstructFix(
+            &decresidual[start_pos+iLBCenc_inst->state_short_len],
+            extra_cb_index, extra_gain_index,
+            mem+CB_MEML-stMemLTbl,
+            stMemLTbl, diff, CB_NSTAGES);
+
+    }
+    else { /* put adaptive part in the beginning */
+
+        /* create reversed vectors for prediction */
+
+        for (k=0; k<diff; k++) {
+            reverseResidual[k] = residual[(start+1)*SUBL-1
+                -(k+iLBCenc_inst->state_short_len)];
+        }
+
+        /* setup memory */
+
+        meml_gotten = iLBCenc_inst->state_short_len;
+        for (k=0; k<meml_gotten; k++) {
+            mem[CB_MEML-1-k] = decresidual[start_pos + k];
+        }
+        memset(mem, 0, (CB_MEML-k)*sizeof(int16_t));
+        memset(weightState, 0, LPC_FILTERORDER*sizeof(int16_t));
+
+        /* encode sub-frames */
+
+        iCBSearchFix(iLBCenc_inst, extra_cb_index, extra_gain_index,
+            reverseResidual, mem+CB_MEML-stMemLTbl, stMemLTbl,
+            diff, CB_NSTAGES,
+            &weightdenum[(start-1)*(LPC_FILTERORDER+1)],
+            weightState, 0);
+
+        /* construct decoded vector */
+
+        iCBConstructFix(reverseDecresidual, extra_cb_index,
+            extra_gain_index, mem+CB_MEML-stMemLTbl, stMemLTbl,
+            diff, CB_NSTAGES);
+
+        /* get decoded residual from reversed vector */
+
+        for (k=0; k<diff; k++) {
+            decresidual[start_pos-1-k] = reverseDecresidual[k];
+
+        }
+    }
+
+    /* counter for predicted sub-frames */
+
+    subcount=0;
+
+    /* forward prediction of sub-frames */
+
+    Nfor = iLBCenc_inst->nsub-start-1;
+
+    if ( Nfor > 0 ) {
+
+        /* setup memory */
+
+        memset(mem, 0, (CB_MEML-STATE_LEN)*sizeof(int16_t));
+        memcpy(mem+CB_MEML-STATE_LEN, decresidual+(start-1)*SUBL,
+            STATE_LEN*sizeof(int16_t));
+        memset(weightState, 0, LPC_FILTERORDER*sizeof(int16_t));
+
+        /* loop over sub-frames to encode */
+
+        for (subframe=0; subframe<Nfor; subframe++) {
+
+            /* encode sub-frame */
+
+            iCBSearchFix(iLBCenc_inst, cb_index+subcount*CB_NSTAGES,
+                gain_index+subcount*CB_NSTAGES,
+                &residual[(start+1+subframe)*SUBL],
+                mem+CB_MEML-memLfTbl[subcount],
+                memLfTbl[subcount], SUBL, CB_NSTAGES,
+                &weightdenum[(start+1+subframe)*
+                            (LPC_FILTERORDER+1)],
+                weightState, subcount+1);
+
+            /* construct decoded vector */
+
+            iCBConstructFix(&decresidual[(start+1+subframe)*SUBL],
+                cb_index+subcount*CB_NSTAGES,
+                gain_index+subcount*CB_NSTAGES,
+                mem+CB_MEML-memLfTbl[subcount],
+                memLfTbl[subcount], SUBL, CB_NSTAGES);
+
+            /* update memory */
+
+            memmove(mem, mem+SUBL, (CB_MEML-SUBL)*sizeof(int16_t));
+            memcpy(mem+CB_MEML-SUBL,
+                &decresidual[(start+1+subframe)*SUBL],
+                SUBL*sizeof(int16_t));
+            memset(weightState, 0, LPC_FILTERORDER*sizeof(int16_t));
+
+            subcount++;
+        }
+    }
+
+
+    /* backward prediction of sub-frames */
+
+    Nback = start-1;
+
+
+    if ( Nback > 0 ) {
+
+        /* create reverse order vectors */
+
+        for (n=0; n<Nback; n++) {
+            for (k=0; k<SUBL; k++) {
+                reverseResidual[n*SUBL+k] =
+                    residual[(start-1)*SUBL-1-n*SUBL-k];
+                reverseDecresidual[n*SUBL+k] =
+                    decresidual[(start-1)*SUBL-1-n*SUBL-k];
+            }
+        }
+
+        /* setup memory */
+
+        meml_gotten = SUBL*(iLBCenc_inst->nsub+1-start);
+
+
+        if ( meml_gotten > CB_MEML ) {
+            meml_gotten=CB_MEML;
+        }
+        for (k=0; k<meml_gotten; k++) {
+            mem[CB_MEML-1-k] = decresidual[(start-1)*SUBL + k];
+        }
+        memset(mem, 0, (CB_MEML-k)*sizeof(int16_t));
+        memset(weightState, 0, LPC_FILTERORDER*sizeof(int16_t));
+
+        /* loop over sub-frames to encode */
+
+        for (subframe=0; subframe<Nback; subframe++) {
+
+            /* encode sub-frame */
+
+            iCBSearchFix(iLBCenc_inst, cb_index+subcount*CB_NSTAGES,
+                gain_index+subcount*CB_NSTAGES,
+                &reverseResidual[subframe*SUBL],
+                mem+CB_MEML-memLfTbl[subcount],
+                memLfTbl[subcount], SUBL, CB_NSTAGES,
+                &weightdenum[(start-2-subframe)*
+                            (LPC_FILTERORDER+1)],
+                weightState, subcount+1);
+
+            /* construct decoded vector */
+
+            iCBConstructFix(&reverseDecresidual[subframe*SUBL],
+                cb_index+subcount*CB_NSTAGES,
+                gain_index+subcount*CB_NSTAGES,
+                mem+CB_MEML-memLfTbl[subcount],
+                memLfTbl[subcount], SUBL, CB_NSTAGES);
+
+            /* update memory */
+
+            memmove(mem, mem+SUBL, (CB_MEML-SUBL)*sizeof(int16_t));
+            memcpy(mem+CB_MEML-SUBL,
+                &reverseDecresidual[subframe*SUBL],
+                SUBL*sizeof(int16_t));
+            memset(weightState, 0, LPC_FILTERORDER*sizeof(int16_t));
+
+            subcount++;
+
+        }
+
+        /* get decoded residual from reversed vector */
+
+        for (i=0; i<SUBL*Nback; i++) {
+            decresidual[SUBL*Nback - i - 1] =
+                reverseDecresidual[i];
+        }
+    }
+    /* end encoding part */
+
+    /* adjust index */
+    index_conv_enc(cb_index);
+
+    /* pack bytes */
+
+    pbytes=bytes;
+    pos=0;
+
+    /* loop over the 3 ULP classes */
+
+    for (ulp=0; ulp<3; ulp++) {
+        /* LSF */
+        for (k=0; k<LSF_NSPLIT*iLBCenc_inst->lpc_n; k++) {
+            packsplit(&lsf_i[k], &firstpart, &lsf_i[k],
+                iLBCenc_inst->ULP_inst->lsf_bits[k][ulp],
+                iLBCenc_inst->ULP_inst->lsf_bits[k][ulp]+
+                iLBCenc_inst->ULP_inst->lsf_bits[k][ulp+1]+
+                iLBCenc_inst->ULP_inst->lsf_bits[k][ulp+2]);
+            dopack( &pbytes, firstpart,
+                iLBCenc_inst->ULP_inst->lsf_bits[k][ulp], &pos);
+        }
+
+        /* Start block info */
+
+        packsplit(&start, &firstpart, &start,
+            iLBCenc_inst->ULP_inst->start_bits[ulp],
+            iLBCenc_inst->ULP_inst->start_bits[ulp]+
+            iLBCenc_inst->ULP_inst->start_bits[ulp+1]+
+            iLBCenc_inst->ULP_inst->start_bits[ulp+2]);
+        dopack( &pbytes, firstpart,
+            iLBCenc_inst->ULP_inst->start_bits[ulp], &pos);
+
+        packsplit(&state_first, &firstpart, &state_first,
+            iLBCenc_inst->ULP_inst->startfirst_bits[ulp],
+            iLBCenc_inst->ULP_inst->startfirst_bits[ulp]+
+            iLBCenc_inst->ULP_inst->startfirst_bits[ulp+1]+
+            iLBCenc_inst->ULP_inst->startfirst_bits[ulp+2]);
+        dopack( &pbytes, firstpart,
+            iLBCenc_inst->ULP_inst->startfirst_bits[ulp], &pos);
+
+        packsplit(&idxForMax, &firstpart, &idxForMax,
+            iLBCenc_inst->ULP_inst->scale_bits[ulp],
+            iLBCenc_inst->ULP_inst->scale_bits[ulp]+
+            iLBCenc_inst->ULP_inst->scale_bits[ulp+1]+
+            iLBCenc_inst->ULP_inst->scale_bits[ulp+2]);
+        dopack( &pbytes, firstpart,
+            iLBCenc_inst->ULP_inst->scale_bits[ulp], &pos);
+
+        for (k=0; k<iLBCenc_inst->state_short_len; k++) {
+            packsplit(idxVec+k, &firstpart, idxVec+k,
+                iLBCenc_inst->ULP_inst->state_bits[ulp],
+                iLBCenc_inst->ULP_inst->state_bits[ulp]+
+                iLBCenc_inst->ULP_inst->state_bits[ulp+1]+
+                iLBCenc_inst->ULP_inst->state_bits[ulp+2]);
+            dopack( &pbytes, firstpart,
+                iLBCenc_inst->ULP_inst->state_bits[ulp], &pos);
+        }
+
+        /* 23/22 (20ms/30ms) sample block */
+
+        for (k=0;k<CB_NSTAGES;k++) {
+            packsplit(extra_cb_index+k, &firstpart,
+                extra_cb_index+k,
+                iLBCenc_inst->ULP_inst->extra_cb_index[k][ulp],
+                iLBCenc_inst->ULP_inst->extra_cb_index[k][ulp]+
+                iLBCenc_inst->ULP_inst->extra_cb_index[k][ulp+1]+
+                iLBCenc_inst->ULP_inst->extra_cb_index[k][ulp+2]);
+            dopack( &pbytes, firstpart,
+                iLBCenc_inst->ULP_inst->extra_cb_index[k][ulp],
+                &pos);
+        }
+
+        for (k=0;k<CB_NSTAGES;k++) {
+            packsplit(extra_gain_index+k, &firstpart,
+                extra_gain_index+k,
+                iLBCenc_inst->ULP_inst->extra_cb_gain[k][ulp],
+                iLBCenc_inst->ULP_inst->extra_cb_gain[k][ulp]+
+                iLBCenc_inst->ULP_inst->extra_cb_gain[k][ulp+1]+
+                iLBCenc_inst->ULP_inst->extra_cb_gain[k][ulp+2]);
+            dopack( &pbytes, firstpart,
+                iLBCenc_inst->ULP_inst->extra_cb_gain[k][ulp],
+                &pos);
+        }
+
+        /* The two/four (20ms/30ms) 40 sample sub-blocks */
+
+        for (i=0; i<iLBCenc_inst->nasub; i++) {
+            for (k=0; k<CB_NSTAGES; k++) {
+                packsplit(cb_index+i*CB_NSTAGES+k, &firstpart,
+                    cb_index+i*CB_NSTAGES+k,
+                    iLBCenc_inst->ULP_inst->cb_index[i][k][ulp],
+                    iLBCenc_inst->ULP_inst->cb_index[i][k][ulp]+
+                    iLBCenc_inst->ULP_inst->cb_index[i][k][ulp+1]+
+                    iLBCenc_inst->ULP_inst->cb_index[i][k][ulp+2]);
+                dopack( &pbytes, firstpart,
+                    iLBCenc_inst->ULP_inst->cb_index[i][k][ulp],
+                    &pos);
+            }
+        }
+
+        for (i=0; i<iLBCenc_inst->nasub; i++) {
+            for (k=0; k<CB_NSTAGES; k++) {
+                packsplit(gain_index+i*CB_NSTAGES+k, &firstpart,
+                    gain_index+i*CB_NSTAGES+k,
+                    iLBCenc_inst->ULP_inst->cb_gain[i][k][ulp],
+                    iLBCenc_inst->ULP_inst->cb_gain[i][k][ulp]+
+                    iLBCenc_inst->ULP_inst->cb_gain[i][k][ulp+1]+
+                    iLBCenc_inst->ULP_inst->cb_gain[i][k][ulp+2]);
+                dopack( &pbytes, firstpart,
+                    iLBCenc_inst->ULP_inst->cb_gain[i][k][ulp],
+                    &pos);
+            }
+        }
+    }
+
+    /* set the last bit to zero (otherwise the decoder
+       will treat it as a lost frame) */
+    dopack( &pbytes, 0, 1, &pos);
+}
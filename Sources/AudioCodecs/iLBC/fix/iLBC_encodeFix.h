@@ -0,0 +1,28 @@
+/******************************************************************
+
+    iLBC Speech Coder ANSI-C Source Code
+
+    iLBC_encodeFix.h
+
+    Fixed point encoder
+
+******************************************************************/
+
+#ifndef __iLBC_ILBCENCODEFIX_H
+#define __iLBC_ILBCENCODEFIX_H
+
+#include "iLBC_defineFix.h"
+
+short initEncodeFix(                /* (o) Number of bytes encoded */
+    iLBCfix_Enc_Inst_t *iLBCenc_inst,/* (i/o) Encoder instance */
+    int mode                        /* (i) frame size mode */
+);
+
+void iLBC_encodeFix(
+    unsigned char *bytes,           /* (o) encoded data bits iLBC */
+    const short *block,             /* (i) speech vector to encode */
+    iLBCfix_Enc_Inst_t *iLBCenc_inst/* (i/o) the general encoder
+                                           state */
+);
+
+#endif
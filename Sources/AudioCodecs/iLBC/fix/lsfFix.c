@@ -0,0 +1,246 @@
+/******************************************************************
+
+    iLBC Speech Coder ANSI-C Source Code
+
+    lsfFix.c
+
+    Fixed point LSF and LPC conversions
+
+******************************************************************/
+
+#include <string.h>
+
+#include "iLBC_defineFix.h"
+#include "constantsFix.h"
+#include "helpfunFix.h"
+#include "lsfFix.h"
+
+#define PI_Q13          25736
+#define LSF_GRID_Q16    2677525 /* 0.00079375*2*pi in Q13, times 2^16 */
+#define LSF_GRID_HALF   630     /* first grid point >= 0.5 */
+
+/*----------------------------------------------------------------*
+ *  cos by linear interpolation in cosTblFix
+ *---------------------------------------------------------------*/
+
+int16_t cosFix(
+    int32_t x           /* (i) angle in [0,2*pi], Q13 */
+){
+    int32_t pos, idx, frac;
+
+    if (x > PI_Q13) {
+        x = 2*PI_Q13 - x;
+    }
+    if (x < 0) {
+        x = 0;
+    }
+
+    /* table position in Q16, COS_TBL_LEN/pi in Q13 is 333772/2^10 */
+    pos = (int32_t)(((int64_t)x * 333772) >> 10);
+    idx = pos >> 16;
+    if (idx >= COS_TBL_LEN) {
+        return cosTblFix[COS_TBL_LEN];
+    }
+    frac = pos & 0xFFFF;
+    return (int16_t)(cosTblFix[idx] + (((cosTblFix[idx+1] -
+        cosTblFix[idx]) * frac) >> 16));
+}
+
+/*----------------------------------------------------------------*
+ *  conversion from lpc coefficients to lsf coefficients, the grid
+ *  search of a2lsf() with omega counted in units of the finest
+ *  step 0.00079375
+ *---------------------------------------------------------------*/
+
+void a2lsfFix(
+    int16_t *freq,      /* (o) lsf coefficients, Q13 */
+    const int32_t *a    /* (i) lpc coefficients, Q24 */
+){
+    static const int steps[LSF_NUMBER_OF_STEPS] = {8, 4, 2, 1};
+    const int64_t one = (int64_t)1 << 24;
+    int step;
+    int step_idx;
+    int lsp_index;
+    int64_t p[LPC_HALFORDER];
+    int64_t q[LPC_HALFORDER];
+    int64_t p_pre[LPC_HALFORDER];
+    int64_t q_pre[LPC_HALFORDER];
+    int64_t old_p, old_q, *old;
+    int64_t *pq_coef;
+    int omega, old_omega;
+    int i;
+    int64_t hlp, hlp1, hlp2, hlp3, hlp4, hlp5;
+
+    for (i=0; i<LPC_HALFORDER; i++) {
+        p[i] = -((int64_t)a[i + 1] + a[LPC_FILTERORDER - i]);
+        q[i] = (int64_t)a[LPC_FILTERORDER - i] - a[i + 1];
+    }
+
+    p_pre[0] = -one - p[0];
+    p_pre[1] = - p_pre[0] - p[1];
+    p_pre[2] = - p_pre[1] - p[2];
+    p_pre[3] = - p_pre[2] - p[3];
+    p_pre[4] = - p_pre[3] - p[4];
+    p_pre[4] = p_pre[4] / 2;
+
+    q_pre[0] = one - q[0];
+    q_pre[1] = q_pre[0] - q[1];
+    q_pre[2] = q_pre[1] - q[2];
+    q_pre[3] = q_pre[2] - q[3];
+    q_pre[4] = q_pre[3] - q[4];
+    q_pre[4] = q_pre[4] / 2;
+
+    omega = 0;
+    old_omega = 0;
+
+    old_p = INT64_MAX;
+    old_q = INT64_MAX;
+
+    /* Here we loop through lsp_index to find all the
+       LPC_FILTERORDER roots for omega. */
+
+    for (lsp_index = 0; lsp_index<LPC_FILTERORDER; lsp_index++) {
+
+        /* Depending on lsp_index being even or odd, we
+        alternatively solve the roots for the two LSP equations. */
+
+        if ((lsp_index & 0x1) == 0) {
+            pq_coef = p_pre;
+            old = &old_p;
+        } else {
+            pq_coef = q_pre;
+            old = &old_q;
+        }
+
+        /* Start with low resolution grid */
+
+        for (step_idx = 0, step = steps[step_idx];
+            step_idx < LSF_NUMBER_OF_STEPS;){
+
+            /*  cos(10piw) + pq(0)cos(8piw) + pq(1)cos(6piw) +
+            pq(2)cos(4piw) + pq(3)cod(2piw) + pq(4) */
+
+            hlp = (int64_t)cosFix((int32_t)(((int64_t)omega *
+                LSF_GRID_Q16 + 32768) >> 16)) * (1 << 9);
+            hlp1 = 2 * hlp + pq_coef[0];
+            hlp2 = ((2 * hlp * hlp1) >> 24) - one + pq_coef[1];
+            hlp3 = ((2 * hlp * hlp2) >> 24) - hlp1 + pq_coef[2];
+            hlp4 = ((2 * hlp * hlp3) >> 24) - hlp2 + pq_coef[3];
+            hlp5 = ((hlp * hlp4) >> 24) - hlp3 + pq_coef[4];
+
+            if ((hlp5 <= 0 && *old >= 0) || (hlp5 >= 0 && *old <= 0) ||
+                (omega >= LSF_GRID_HALF)){
+
+                if (step_idx == (LSF_NUMBER_OF_STEPS - 1)){
+
+                    if ((hlp5 < 0 ? -hlp5 : hlp5) >=
+                        (*old < 0 ? -*old : *old)) {
+                        omega -= step;
+                    }
+                    freq[lsp_index] = (int16_t)(((int64_t)omega *
+                        LSF_GRID_Q16 + 32768) >> 16);
+
+                    if ((*old) >= 0){
+                        *old = -INT64_MAX;
+                    } else {
+                        *old = INT64_MAX;
+                    }
+
+                    omega = old_omega;
+                    step_idx = LSF_NUMBER_OF_STEPS;
+                } else {
+
+                    if (step_idx == 0) {
+                        old_omega = omega;
+                    }
+
+                    step_idx++;
+                    omega -= steps[step_idx];
+
+                    /* Go back one grid step */
+
+                    step = steps[step_idx];
+                }
+            } else {
+
+            /* increment omega until they are of different sign,
+            and we know there is at least one root between omega
+            and old_omega */
+                *old = hlp5;
+                omega += step;
+            }
+        }
+    }
+}
+
+/*----------------------------------------------------------------*
+ *  conversion from lsf coefficients to lpc coefficients, the
+ *  sum and difference polynomials are expanded from the cosines
+ *  of the even and odd lsf (Q24)
+ *---------------------------------------------------------------*/
+
+static void getPolyFix(
+    int64_t *f,         /* (o) polynomial f[0..LPC_HALFORDER], Q24 */
+    const int16_t *lsp  /* (i) cosines, every second one, Q15 */
+){
+    int i, j;
+    int64_t b;
+
+    f[0] = (int64_t)1 << 24;
+    f[1] = -(int64_t)lsp[0] * (1 << 10);
+    for (i = 2; i <= LPC_HALFORDER; i++) {
+        b = -(int64_t)lsp[2*i-2] * (1 << 10);
+        f[i] = ((b * f[i-1]) >> 24) + 2 * f[i-2];
+        for (j = i-1; j > 1; j--) {
+            f[j] += ((b * f[j-1]) >> 24) + f[j-2];
+        }
+        f[1] += b;
+    }
+}
+
+void lsf2aFix(
+    int16_t *a_coef,    /* (o) lpc coefficients, Q12 */
+    const int16_t *freq /* (i) lsf coefficients, Q13 */
+){
+    int i;
+    int32_t hlp;
+    int16_t lsf[LPC_FILTERORDER], lsp[LPC_FILTERORDER];
+    int64_t f1[LPC_HALFORDER+1], f2[LPC_HALFORDER+1];
+
+    memcpy(lsf, freq, LPC_FILTERORDER*sizeof(int16_t));
+
+    /* Check input for ill-conditioned cases (see lsf2a()) */
+
+    if ((lsf[0] <= 0) || (lsf[LPC_FILTERORDER - 1] >= PI_Q13)){
+        if (lsf[0] <= 0) {
+            lsf[0] = 1132;      /* 0.022*2*pi */
+        }
+        if (lsf[LPC_FILTERORDER - 1] >= PI_Q13) {
+            lsf[LPC_FILTERORDER - 1] = 25684;  /* 0.499*2*pi */
+        }
+        hlp = (lsf[LPC_FILTERORDER - 1] - lsf[0]) /
+            (LPC_FILTERORDER - 1);
+        for (i=1; i<LPC_FILTERORDER; i++) {
+            lsf[i] = (int16_t)(lsf[i - 1] + hlp);
+        }
+    }
+
+    for (i=0; i<LPC_FILTERORDER; i++) {
+        lsp[i] = cosFix(lsf[i]);
+    }
+
+    getPolyFix(f1, lsp);
+    getPolyFix(f2, lsp + 1);
+
+    for (i = LPC_HALFORDER; i > 0; i--) {
+        f1[i] += f1[i-1];
+        f2[i] -= f2[i-1];
+    }
+
+    a_coef[0] = LPC_ONE_Q12;
+    for (i = 1; i <= LPC_HALFORDER; i++) {
+        a_coef[i] = sat16_64((f1[i] + f2[i] + 4096) >> 13);
+        a_coef[LPC_FILTERORDER + 1 - i] =
+            sat16_64((f1[i] - f2[i] + 4096) >> 13);
+    }
+}
@@ -0,0 +1,30 @@
+/******************************************************************
+
+    iLBC Speech Coder ANSI-C Source Code
+
+    lsfFix.h
+
+    Fixed point LSF and LPC conversions
+
+******************************************************************/
+
+#ifndef __iLBC_LSFFIX_H
+#define __iLBC_LSFFIX_H
+
+#include "iLBC_defineFix.h"
+
+int16_t cosFix(         /* (o) cos(x), Q15 */
+    int32_t x           /* (i) angle in [0,2*pi], Q13 */
+);
+
+void a2lsfFix(
+    int16_t *freq,      /* (o) lsf coefficients, Q13 */
+    const int32_t *a    /* (i) lpc coefficients, Q24 */
+);
+
+void lsf2aFix(
+    int16_t *a_coef,    /* (o) lpc coefficients, Q12 */
+    const int16_t *freq /* (i) lsf coefficients, Q13 */
+);
+
+#endif
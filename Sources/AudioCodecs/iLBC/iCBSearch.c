@@ -15,6 +15,7 @@
 #include "iLBC_define.h"
 #include "gainquant.h"
 #include "createCB.h"
+#include "cbSearchSimd.h"
 #include "filter.h"
 #include "constants.h"
 
@@ -47,6 +48,7 @@ void iCBSearch(
     float invenergy[CB_EXPAND*128], energy[CB_EXPAND*128];
     float *pp, *ppi=0, *ppo=0, *ppe=0;
     float cbvectors[CB_MEML];
+    float crossDots[CB_MEML];
     float tene, cene, cvec[SUBL];
     float aug_vec[SUBL];
 
@@ -98,19 +100,18 @@ void iCBSearch(
         gain = (float)0.0;
         best_index = 0;
 
-        /* Compute cross dot product between the target
-           and the CB memory */
+        /* Compute cross dot products between the target
+           and the CB memory for the main first codebook
+           section */
 
-        crossDot=0.0;
-        pp=buf+LPC_FILTERORDER+lMem-lTarget;
-        for (j=0; j<lTarget; j++) {
-            crossDot += target[j]*(*pp++);
-        }
+        cbCorr(target, buf+LPC_FILTERORDER+lMem-lTarget, lTarget,
+            range, crossDots);
 
         if (stage==0) {
 
             /* Calculate energy in the first block of
-              'lTarget' samples. */
+              'lTarget' samples, then recursively for the
+              other vectors. */
             ppe = energy;
             ppi = buf+LPC_FILTERORDER+lMem-lTarget-1;
             ppo = buf+LPC_FILTERORDER+lMem-1;
@@ -120,60 +121,28 @@ void iCBSearch(
             for (j=0; j<lTarget; j++) {
                 *ppe+=(*pp)*(*pp++);
             }
-
-            if (*ppe>0.0) {
-                invenergy[0] = (float) 1.0 / (*ppe + EPS);
-            } else {
-                invenergy[0] = (float) 0.0;
-            }
             ppe++;
 
-            measure=(float)-10000000.0;
-
-            if (crossDot > 0.0) {
-                   measure = crossDot*crossDot*invenergy[0];
+            for (icount=1; icount<range; icount++) {
+                *ppe++ = energy[icount-1] + (*ppi)*(*ppi) -
+                    (*ppo)*(*ppo);
+                ppo--;
+                ppi--;
             }
-        }
-        else {
-            measure = crossDot*crossDot*invenergy[0];
-        }
 
-        /* check if measure is better */
-        ftmp = crossDot*invenergy[0];
-
-        if ((measure>max_measure) && (fabs(ftmp)<CB_MAXGAIN)) {
-            best_index = 0;
-            max_measure = measure;
-            gain = ftmp;
+            cbInvEnergy(energy, range, invenergy);
         }
 
         /* loop over the main first codebook section,
            full search */
 
-        for (icount=1; icount<range; icount++) {
+        for (icount=0; icount<range; icount++) {
 
             /* calculate measure */
 
-            crossDot=0.0;
-            pp = buf+LPC_FILTERORDER+lMem-lTarget-icount;
-
-            for (j=0; j<lTarget; j++) {
-                crossDot += target[j]*(*pp++);
-            }
+            crossDot = crossDots[icount];
 
             if (stage==0) {
-                *ppe++ = energy[icount-1] + (*ppi)*(*ppi) -
-                    (*ppo)*(*ppo);
-                ppo--;
-                ppi--;
-
-                if (energy[icount]>0.0) {
-                    invenergy[icount] =
-                        (float)1.0/(energy[icount]+EPS);
-                } else {
-                    invenergy[icount] = (float) 0.0;
-                }
-
                 measure=(float)-10000000.0;
 
                 if (crossDot > 0.0) {
@@ -310,22 +279,17 @@ void iCBSearch(
 
         /* loop over search range */
 
+        if (eInd>sInd) {
+            cbCorr(target, cbvectors+lMem-lTarget-counter, lTarget,
+                eInd-sInd, crossDots);
+            cbInvEnergy(energy+sInd, eInd-sInd, invenergy+sInd);
+        }
+
         for (icount=sInd; icount<eInd; icount++) {
 
             /* calculate measure */
 
-            crossDot=0.0;
-            pp=cbvectors + lMem - (counter++) - lTarget;
-
-            for (j=0;j<lTarget;j++) {
-                crossDot += target[j]*(*pp++);
-            }
-
-            if (energy[icount]>0.0) {
-                invenergy[icount] =(float)1.0/(energy[icount]+EPS);
-            } else {
-                invenergy[icount] =(float)0.0;
-            }
+            crossDot = crossDots[icount-sInd];
 
             if (stage==0) {
 
@@ -4,119 +4,206 @@
 //     Cybertel bridge/Loche
 //		    07/16/2013 
 //
-// rawbuf : 320 bytes (160 short)
-// encbuf : 38 bytes (19 short)
-// data per 20ms
-// enhance mode decoding
+// rawbuf : 320 bytes (160 short), 480 bytes (240 short) in 30ms mode
+// encbuf : 12 bytes RTP header + 38 bytes (19 short), 50 bytes (25 short) in 30ms mode
+// data per 20ms or 30ms, iLBC_SetMode / iLBC_NegotiateMode (SDP mode=30)
+// enhance mode decoding, iLBC_SetFixedPoint for the 16 bit codec (no enhancer)
+//
+// every call takes the iLBC_Codec_Inst_t of its stream (iLBC_Codec.h), there is
+// no process-wide state : streams can be coded on different threads
 //
 //-------------------------------------------------------------------------------------//
 
 #include <time.h>
+#include <string.h>
 #include "../rtp.h"
 
-#include "iLBC_define.h"
+#include "iLBC_Codec.h"
 #include "iLBC_encode.h"
 #include "iLBC_decode.h"
+#include "fix/iLBC_encodeFix.h"
+#include "fix/iLBC_decodeFix.h"
 
-#define ILBCNOOFWORDS_MAX   (NO_OF_BYTES_20MS/2)
+#define ILBCNOOFWORDS_MAX   (NO_OF_BYTES_30MS/2)
 
-static iLBC_Enc_Inst_t Enc_Inst;
-static iLBC_Dec_Inst_t Dec_Inst;
 
-static int bMarker;
-//static long wTimeStamp;
-//static long seq;
-//static long ssrc;
-static int wTimeStamp;
-static int seq;
-static int ssrc;
+//-------------------------------------------------------------------------------------//
+// a new stream : 20 ms mode, enhancer on, float codec, new RTP sequence and SSRC
 
+void iLBC_InitInst(iLBC_Codec_Inst_t *inst)
+{
+    memset(inst, 0, sizeof(*inst));
+    inst->mode = 20;
+    inst->enhancer = 1;
+    iLBC_InitCodec(inst);
+    iLBC_InitVar(inst);
+}
 
 //-------------------------------------------------------------------------------------//
 
-void iLBC_InitCodec()
+void iLBC_InitCodec(iLBC_Codec_Inst_t *inst)
+{
+    initEncode(&inst->Enc_Inst, inst->mode);
+    initDecode(&inst->Dec_Inst, inst->mode, inst->enhancer);
+    initEncodeFix(&inst->EncFix_Inst, inst->mode);
+    initDecodeFix(&inst->DecFix_Inst, inst->mode);
+}
+
+//-------------------------------------------------------------------------------------//
+// frame size mode : 20 or 30 (ms), restarts the codec when it changes
+
+void iLBC_SetMode(iLBC_Codec_Inst_t *inst, int mode)
+{
+    mode = (mode == 30) ? 30 : 20;
+    if (mode != inst->mode) {
+        inst->mode = mode;
+        iLBC_InitCodec(inst);
+    }
+}
+
+int iLBC_GetMode(const iLBC_Codec_Inst_t *inst)
 {
-    initEncode(&Enc_Inst, 20);		// frame size mode : 20ms
-    initDecode(&Dec_Inst, 20, 1);	// enhance mode : 1
+    return inst->mode;
 }
 
 //-------------------------------------------------------------------------------------//
+// mode of an SDP fmtp line ("mode=20", "mode=30"), 30 when absent (RFC 3952)
 
-void iLBC_InitVar()
+int iLBC_FmtpMode(const char *fmtp)
 {
-    bMarker = 1;
-    wTimeStamp = MIN_TIMESTAMP;
-    seq = MIN_SEQUENCE;
-    ssrc = randomR(31415621, 100000000);
+    const char *p = fmtp ? strstr(fmtp, "mode=") : NULL;
+
+    if (p == NULL)
+        return 30;
+    return (atoi(p + 5) == 20) ? 20 : 30;
+}
+
+// offer/answer : 20 ms only when both sides ask for it, the mode is applied
+int iLBC_NegotiateMode(iLBC_Codec_Inst_t *inst, const char *localFmtp, const char *remoteFmtp)
+{
+    if (iLBC_FmtpMode(localFmtp) == 20 && iLBC_FmtpMode(remoteFmtp) == 20)
+        iLBC_SetMode(inst, 20);
+    else
+        iLBC_SetMode(inst, 30);
+    return inst->mode;
 }
 
 //-------------------------------------------------------------------------------------//
 
-int iLBC_Encode(short *rawbuf, short *encbuf, int payloadType)
+void iLBC_InitVar(iLBC_Codec_Inst_t *inst)
 {
-    short encoded_data[ILBCNOOFWORDS_MAX];  // 19
-    float block[BLOCKL_20MS];               // 160
+    inst->bMarker = 1;
+    inst->wTimeStamp = MIN_TIMESTAMP;
+    inst->seq = MIN_SEQUENCE;
+    inst->ssrc = randomR(31415621, 100000000);
+}
+
+//-------------------------------------------------------------------------------------//
+// enhancer : 1 (default) for playout, 0 when the output is encoded again
+
+void iLBC_SetEnhancer(iLBC_Codec_Inst_t *inst, int enable)
+{
+    inst->enhancer = (enable != 0);
+    setEnhancer(&inst->Dec_Inst, inst->enhancer);
+}
+
+//-------------------------------------------------------------------------------------//
+// fixed point : 1 to run the 16 bit encoder and decoder (same bitstream, no enhancer),
+// for targets without a fast FPU, restarts the codec when it changes
+
+void iLBC_SetFixedPoint(iLBC_Codec_Inst_t *inst, int enable)
+{
+    enable = (enable != 0);
+    if (enable != inst->fixed) {
+        inst->fixed = enable;
+        iLBC_InitCodec(inst);
+    }
+}
+
+//-------------------------------------------------------------------------------------//
+
+int iLBC_Encode(iLBC_Codec_Inst_t *inst, short *rawbuf, short *encbuf, int payloadType)
+{
+    short encoded_data[ILBCNOOFWORDS_MAX];  // 19 or 25
+    float block[BLOCKL_MAX];                // 160 or 240
     int k;
     
     _rtp_header header;
 
-    /* convert signal to float */
+    if (inst->fixed) {
+
+        /* the fixed point encoder takes the samples as they are */
+
+        iLBC_encodeFix((unsigned char *)encoded_data, rawbuf, &inst->EncFix_Inst);
+    }
+    else {
+
+        /* convert signal to float */
 
-    for (k=0; k<Enc_Inst.blockl; k++)
-    	block[k] = (float)rawbuf[k];
+        for (k=0; k<inst->Enc_Inst.blockl; k++)
+            block[k] = (float)rawbuf[k];
 
-    /* do the actual encoding */
+        /* do the actual encoding */
 
-    iLBC_encode((unsigned char *)encoded_data, block, &Enc_Inst);
+        iLBC_encode((unsigned char *)encoded_data, block, &inst->Enc_Inst);
+    }
     
-    if ((wTimeStamp += TIME_SLICE) >= MAX_TIMESTAMP)
-        wTimeStamp = MIN_TIMESTAMP;
+    if ((inst->wTimeStamp += inst->Enc_Inst.blockl) >= MAX_TIMESTAMP)
+        inst->wTimeStamp = MIN_TIMESTAMP;
     
-    if (++seq > MAX_SEQUENCE)
-        seq = MIN_SEQUENCE;
+    if (++inst->seq > MAX_SEQUENCE)
+        inst->seq = MIN_SEQUENCE;
     
     header.v = 2;       // Version
     header.p = 0;       // Padding Bit
     header.x = 0;       // Option Field
     header.cc = 0;      // CSRC Count
     
-    if (bMarker)
+    if (inst->bMarker)
         header.m = 1;   // Marker Bit
     else
         header.m = 0;
     
     header.pt = payloadType;
     
-    header.seq = htons((unsigned short)seq);    // Sequence Number
-    header.timestamp = htonl(wTimeStamp);       // TimeStamp
-    header.ssrc = htonl(ssrc);
+    header.seq = htons((unsigned short)inst->seq);  // Sequence Number
+    header.timestamp = htonl(inst->wTimeStamp);     // TimeStamp
+    header.ssrc = htonl(inst->ssrc);
     
     memcpy((unsigned char *)encbuf, (unsigned char *)&header, 12);
-    memcpy((unsigned char *)encbuf + 12, (unsigned char *)encoded_data, 38);
+    memcpy((unsigned char *)encbuf + 12, (unsigned char *)encoded_data, inst->Enc_Inst.no_of_bytes);
     
-    if (bMarker)
-        bMarker = 0;
+    if (inst->bMarker)
+        inst->bMarker = 0;
 
-    return (Enc_Inst.no_of_bytes);
+    return (inst->Enc_Inst.no_of_bytes);
 }
 
 //-------------------------------------------------------------------------------------//
 
-int iLBC_Decode(short *encbuf, short *rawbuf)
+int iLBC_Decode(iLBC_Codec_Inst_t *inst, short *encbuf, short *rawbuf)
 {
     int k;
-    float decblock[BLOCKL_20MS], dtmp;
-    short encoded_data[ILBCNOOFWORDS_MAX];  // 19
+    float decblock[BLOCKL_MAX], dtmp;
+    short encoded_data[ILBCNOOFWORDS_MAX];  // 19 or 25
     
-    memcpy((unsigned char *)encoded_data, (unsigned char *)encbuf + 12, NO_OF_BYTES_20MS);
+    memcpy((unsigned char *)encoded_data, (unsigned char *)encbuf + 12, inst->Dec_Inst.no_of_bytes);
+
+    if (inst->fixed) {
+
+        /* the fixed point decoder writes the samples as they are */
+
+        iLBC_decodeFix(rawbuf, (unsigned char *)encoded_data, &inst->DecFix_Inst, 1);
+        return (inst->DecFix_Inst.blockl);
+    }
 
     /* do actual decoding of block */
 
-    iLBC_decode(decblock, (unsigned char *)encbuf, &Dec_Inst, 1);
+    iLBC_decode(decblock, (unsigned char *)encoded_data, &inst->Dec_Inst, 1);
 
     /* convert to short */
 
-    for (k=0; k<Dec_Inst.blockl; k++){
+    for (k=0; k<inst->Dec_Inst.blockl; k++){
         dtmp = decblock[k];
 
         if (dtmp < MIN_SAMPLE)
@@ -127,7 +214,7 @@ int iLBC_Decode(short *encbuf, short *rawbuf)
         rawbuf[k] = (short)dtmp;
     }
 
-    return (Dec_Inst.blockl);
+    return (inst->Dec_Inst.blockl);
 }
 
 //-------------------------------------------------------------------------------------//
@@ -0,0 +1,48 @@
+//-------------------------------------------------------------------------------------//
+//
+// iLBC Codec For Harbour Interface
+//
+// one iLBC_Codec_Inst_t per stream : the float and fixed point codec states, the
+// frame size mode, the enhancer and fixed point switches and the RTP header fields
+// of the stream. Calls on different instances can run at the same time.
+//
+//-------------------------------------------------------------------------------------//
+
+#ifndef __iLBC_ILBCCODEC_H
+#define __iLBC_ILBCCODEC_H
+
+#include "iLBC_define.h"
+#include "fix/iLBC_defineFix.h"
+
+typedef struct iLBC_Codec_Inst_t_ {
+    iLBC_Enc_Inst_t Enc_Inst;
+    iLBC_Dec_Inst_t Dec_Inst;
+    iLBCfix_Enc_Inst_t EncFix_Inst;
+    iLBCfix_Dec_Inst_t DecFix_Inst;
+
+    int mode;           // frame size mode : 20 or 30 ms
+    int enhancer;
+    int fixed;          // 1 : fixed point encoder and decoder
+
+    int bMarker;
+    int wTimeStamp;
+    int seq;
+    int ssrc;
+} iLBC_Codec_Inst_t;
+
+void iLBC_InitInst(iLBC_Codec_Inst_t *inst);
+void iLBC_InitCodec(iLBC_Codec_Inst_t *inst);
+void iLBC_InitVar(iLBC_Codec_Inst_t *inst);
+
+void iLBC_SetMode(iLBC_Codec_Inst_t *inst, int mode);
+int iLBC_GetMode(const iLBC_Codec_Inst_t *inst);
+int iLBC_FmtpMode(const char *fmtp);
+int iLBC_NegotiateMode(iLBC_Codec_Inst_t *inst, const char *localFmtp, const char *remoteFmtp);
+
+void iLBC_SetEnhancer(iLBC_Codec_Inst_t *inst, int enable);
+void iLBC_SetFixedPoint(iLBC_Codec_Inst_t *inst, int enable);
+
+int iLBC_Encode(iLBC_Codec_Inst_t *inst, short *rawbuf, short *encbuf, int payloadType);
+int iLBC_Decode(iLBC_Codec_Inst_t *inst, short *encbuf, short *rawbuf);
+
+#endif
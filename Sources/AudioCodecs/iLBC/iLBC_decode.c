@@ -13,6 +13,7 @@
 #include <stdlib.h>
 
 #include "iLBC_define.h"
+#include "iLBC_decode.h"
 #include "StateConstructW.h"
 #include "LPCdecode.h"
 #include "iCBConstruct.h"
@@ -89,16 +90,39 @@ short initDecode(                   /* (o) Number of decoded samples */
 
     memset(iLBCdec_inst->hpomem, 0, 4*sizeof(float));
 
-    iLBCdec_inst->use_enhancer = use_enhancer;
-    memset(iLBCdec_inst->enh_buf, 0, ENH_BUFL*sizeof(float));
-    for (i=0;i<ENH_NBLOCKS_TOT;i++)
-        iLBCdec_inst->enh_period[i]=(float)40.0;
-
-    iLBCdec_inst->prev_enh_pl = 0;
+    iLBCdec_inst->use_enhancer = -1;
+    setEnhancer(iLBCdec_inst, use_enhancer);
 
     return (iLBCdec_inst->blockl);
 }
 
+/*----------------------------------------------------------------*
+ *  Turn the enhancer on or off, also between two frames of a
+ *  running decoder. A decoder whose output is encoded again
+ *  (transcoding) can skip it. The enhancer starts from an empty
+ *  history when it is turned on; the output delay changes by 40
+ *  (20 ms) or 80 (30 ms) samples at the switch.
+ *---------------------------------------------------------------*/
+
+void setEnhancer(
+    iLBC_Dec_Inst_t *iLBCdec_inst,  /* (i/o) Decoder instance */
+    int use_enhancer                /* (i) 1 to use enhancer
+                                           0 to run without enhancer */
+){
+    int i;
+
+    use_enhancer = (use_enhancer != 0);
+
+    if (use_enhancer && iLBCdec_inst->use_enhancer != 1) {
+        memset(iLBCdec_inst->enh_buf, 0, ENH_BUFL*sizeof(float));
+        for (i=0;i<ENH_NBLOCKS_TOT;i++)
+            iLBCdec_inst->enh_period[i]=(float)40.0;
+
+        iLBCdec_inst->prev_enh_pl = 0;
+    }
+    iLBCdec_inst->use_enhancer = use_enhancer;
+}
+
 /*----------------------------------------------------------------*
  *  frame residual decoder function (subrutine to iLBC_decode)
  *---------------------------------------------------------------*/
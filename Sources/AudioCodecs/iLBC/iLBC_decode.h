@@ -21,6 +21,12 @@ short initDecode(                   /* (o) Number of decoded samples */
                                            0 to run without enhancer */
 );
 
+void setEnhancer(
+    iLBC_Dec_Inst_t *iLBCdec_inst,  /* (i/o) Decoder instance */
+    int use_enhancer                /* (i) 1 to use enhancer
+                                           0 to run without enhancer */
+);
+
 void iLBC_decode(
     float *decblock,            	/* (o) decoded signal block */
     unsigned char *bytes,           /* (i) encoded signal bits */
@@ -13,6 +13,9 @@ typedef NS_ENUM(NSInteger, AudioCodecType) {
 @protocol RTPAudioCodec <NSObject>
 @required
 @property (readonly) AudioCodecType codecType;
+// RFC 6464 level (-dBov, 0..127) and voice flag of the last frame passed to encode
+@property (readonly) int audioLevel;
+@property (readonly) BOOL voiceActivity;
 -(NSData*)encode:(NSData*)data;
 -(NSData*)decode:(NSData*)data;
 @end
@@ -8,16 +8,17 @@
 import Foundation
 import AVFoundation
 import VideoToolbox
+import MediaTransport
 
 class AnnexBBufferReader : NSObject {
     var data : UnsafePointer<UInt8>
     var length: Int
-    var indices: [NaluIndex]
+    var indices: [H264NaluIndex]
     var index: Int = 0
     init(data: UnsafePointer<UInt8>, count: Int) {
         self.data = data
         self.length = count
-        self.indices = findNaluIndices(buffer: self.data, count: self.length)
+        self.indices = scanNaluIndices(buffer: self.data, count: self.length)
         super.init()
     }
     
@@ -30,7 +31,7 @@ class AnnexBBufferReader : NSObject {
             return false
         }
         let nalUType = indices[index]
-        count = nalUType.payloadSize
+        count = Int32(nalUType.payloadSize)
         buffer = data + Int(nalUType.payloadStartOffset)
         index += 1
         return true
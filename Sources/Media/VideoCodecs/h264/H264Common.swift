@@ -8,6 +8,7 @@
 import Foundation
 import AVFoundation
 import VideoToolbox
+import MediaTransport
 
 public let kNaluLongStartSequenceSize = 4
 public let kNaluShortStartSequenceSize = 3
@@ -52,34 +53,24 @@ public class NaluIndex {
  * 입력된 AnnexBuffer에서 각각의 NalUnit에 대한 정보 위치 파싱
  */
 public func findNaluIndices(buffer: UnsafePointer<UInt8>, count: Int) -> [NaluIndex] {
-    let end = count - kNaluShortStartSequenceSize // start bit는 0001,001 둘다 가능
-    var indices: [NaluIndex] = []
-    var i : Int = 0
-    while (i < end ) {
-        if buffer[i + 2] > 1 {
-            i += 3
-        } else if buffer[i + 2] == 1 {
-            if buffer[i + 1] == 0 && buffer[i] == 0 { // StartBit 를 찾은 경우 '001'
-                let index =
-                    NaluIndex(startOffset: Int32(i), payloadStartOffset: Int32(i + 3))
-                if index.startOffset > 0 && buffer[Int(index.startOffset - 1)] == 0 { // 0001 인 경우 처리
-                    index.startOffset -= 1
-                }
-                //이 전 저장된 NalUnit의 정보가 있는 경우 이전 NalUnit의 크기는 이전 유닛의 페이로드 시작 위치에서 현재 startbit의 시작점 까지
-                if let last = indices.last {
-                    last.payloadSize = index.startOffset - last.payloadStartOffset //
-                }
-                indices.append(index)
-            }
-            i += 3;
-        } else {
-            i += 1
-        }
+    return scanNaluIndices(buffer: buffer, count: count).map {
+        let index = NaluIndex(startOffset: Int32($0.startOffset), payloadStartOffset: Int32($0.payloadStartOffset))
+        index.payloadSize = Int32($0.payloadSize)
+        return index
     }
-    // 마지막 NalUnit의 페이로드 데이터 크기 계산
-    if let last = indices.last {
-        last.payloadSize = Int32(count) - last.payloadStartOffset
+}
+
+/*
+ * SIMD start code 스캐너(H264FindNaluIndices)로 NalUnit 위치 파싱, NalUnit 마다 객체를 만들지 않음
+ */
+public func scanNaluIndices(buffer: UnsafePointer<UInt8>, count: Int) -> [H264NaluIndex] {
+    var indices = [H264NaluIndex](repeating: H264NaluIndex(), count: Int(H264_NALU_INDEX_CAPACITY))
+    var found = Int(H264FindNaluIndices(buffer, count, &indices, Int32(indices.count)))
+    if found > indices.count { // 용량보다 NalUnit이 많은 경우 한번 더 스캔
+        indices = [H264NaluIndex](repeating: H264NaluIndex(), count: found)
+        found = Int(H264FindNaluIndices(buffer, count, &indices, Int32(indices.count)))
     }
+    indices.removeLast(indices.count - found)
     return indices
 }
 
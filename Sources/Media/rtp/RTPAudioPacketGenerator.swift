@@ -27,6 +27,8 @@ public class RTPAudioPacketGenerator {
     let logger = Logger(label: "RTPAudioPacketGenerator")
     let sendBytes: Int
     let timestampUnit: UInt32
+    // RFC 6464 audio level 확장 헤더 ID (SDP extmap 으로 협상), nil 이면 사용 안함
+    public var audioLevelExtensionId: Int? = nil
     lazy var encodeQueue: DispatchQueue = { [unowned self] in
         return DispatchQueue(label: "com.encodeQueue.\(self)"/*, qos: .userInteractive*/)
     }()
@@ -70,6 +72,11 @@ extension RTPAudioPacketGenerator : AudioDeviceDelegate {
                         }
                         guard let packetizer = packetizer else { return }
                         let rtpPacket = RTPPacket(capacity: 1500)
+                        // 확장 헤더는 페이로드 보다 먼저 작성
+                        if let id = self.audioLevelExtensionId,
+                           let location = rtpPacket.AllocateExtension(id: id, length: AudioLevel.valueSizeBytes) {
+                            AudioLevel.write(data: location, voiceActivity: self.codec.voiceActivity, level: Int(self.codec.audioLevel))
+                        }
                         if packetizer.nextPacket(rtpPacket: rtpPacket) {
                             rtpPacket.setSsrc(ssrc: self.ssrc)
                             rtpPacket.setSequenceNumber(seqNo: self.sequenceNumber)
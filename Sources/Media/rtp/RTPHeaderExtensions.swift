@@ -10,6 +10,7 @@ import Foundation
 public enum RTPExtensionType: Int {
     case kRTPExtensionNone
     case kRTPExtensionVideoRotation
+    case kRTPExtensionAudioLevel
     case kRTPExtensionNumberOfExtensions
 }
 
@@ -74,10 +75,40 @@ class VideoOrientation : ExtensionInfo {
     }
 }
 
+// RFC 6464 : |V| level |, level in -dBov (0..127), V set for voice
+class AudioLevel : ExtensionInfo {
+    static var kId: RTPExtensionType = .kRTPExtensionAudioLevel
+    static var valueSizeBytes = 1
+    static var uri = "urn:ietf:params:rtp-hdrext:ssrc-audio-level"
+    // carries no rotation
+    static func write(data: UnsafeMutableRawPointer?, rotation: VideoRotation) -> Bool {
+        return false
+    }
+    static func parse(data: UnsafeMutableRawPointer?, rotation: inout VideoRotation) -> Bool {
+        return false
+    }
+    @discardableResult
+    static func write(data: UnsafeMutableRawPointer?, voiceActivity: Bool, level: Int) -> Bool {
+        guard let data = data else { return false }
+        let levelBits = UInt8(min(max(level, 0), 127))
+        data.storeBytes(of: voiceActivity ? levelBits | 0x80 : levelBits, as: UInt8.self)
+        return true
+    }
+    @discardableResult
+    static func parse(data: UnsafeMutableRawPointer?, voiceActivity: inout Bool, level: inout Int) -> Bool {
+        guard let data = data else { return false }
+        let rawValue = data.assumingMemoryBound(to: UInt8.self).pointee
+        voiceActivity = (rawValue & 0x80) != 0
+        level = Int(rawValue & 0x7F)
+        return true
+    }
+}
+
 public class ExtensionHeaderMap {
     var map: [RTPExtensionType : ExtensionInfo.Type] = [:]
     public init() {
         map[VideoOrientation.kId] = (VideoOrientation.self as ExtensionInfo.Type)
+        map[AudioLevel.kId] = (AudioLevel.self as ExtensionInfo.Type)
     }
     
     public func findExtensinInfo(type: RTPExtensionType) -> ExtensionInfo.Type? {
@@ -5,6 +5,7 @@
 //  Created by HYEONJUN PARK on 2021/03/08.
 
 import Foundation
+import MediaTransport
 class RTPPacketizerH264: RtpPacketizer {
     static var kNalHeaderSize: Int = 1
     static var kFuAHeaderSize: Int = 2
@@ -56,7 +57,7 @@ class RTPPacketizerH264: RtpPacketizer {
         super.init()
         guard let buf = payload.withUnsafeBytes({ return $0 }).bindMemory(to: UInt8.self).baseAddress else { return }
         
-        for nalu in findNaluIndices(buffer: buf, count: payload.count) {
+        for nalu in scanNaluIndices(buffer: buf, count: payload.count) {
             inputFragments.append(Data(bytes: buf + Int(nalu.payloadStartOffset), count: Int(nalu.payloadSize)))
         }
         if !self.generatePacket(mode: mode) {
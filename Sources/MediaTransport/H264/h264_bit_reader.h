@@ -0,0 +1,142 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+//-------------------------------------------------------------------------------------//
+//
+// MSB-first bit reader over an RBSP with Exp-Golomb codes (H.264 9.1).
+//
+// The next bits sit left aligned in a 64-bit cache that is refilled a whole
+// word at a time, so a read is a shift, and ue(v) finds its prefix with one
+// count-leading-zeros. Reading past the end returns 0 and sets Overrun(),
+// callers check it once after a parse.
+//
+//-------------------------------------------------------------------------------------//
+
+#if defined(__GNUC__) || defined(__clang__)
+#define H264_CLZ64(x) __builtin_clzll(x)
+#else
+static inline int H264_CLZ64(uint64_t x)
+{
+	int n = 0;
+	while (!(x & 0x8000000000000000ULL)) {
+		x <<= 1;
+		n++;
+	}
+	return n;
+}
+#endif
+
+class CH264BitReader
+{
+public:
+	CH264BitReader(const uint8_t *data, size_t size)
+		: pos(data), end(data + size), cache(0), cacheBits(0), overrun(false)
+	{
+		Refill();
+	}
+
+	bool Overrun() const { return overrun; }
+	size_t BitsLeft() const { return (size_t)(end - pos) * 8 + cacheBits; }
+
+	// n in 1..32
+	uint32_t ReadBits(int n)
+	{
+		if (cacheBits < n) {
+			Refill();
+			if (cacheBits < n)
+				return Fail();
+		}
+		uint32_t value = (uint32_t)(cache >> (64 - n));
+		cache <<= n;
+		cacheBits -= n;
+		return value;
+	}
+
+	bool ReadFlag() { return ReadBits(1) != 0; }
+
+	void SkipBits(size_t n)
+	{
+		if (n > BitsLeft()) {
+			Fail();
+			return;
+		}
+		while (n > 32) {
+			ReadBits(32);
+			n -= 32;
+		}
+		if (n > 0)
+			ReadBits((int)n);
+	}
+
+	// ue(v) : n leading zeros, a 1, then n bits, value 2^n - 1 + bits
+	uint32_t ReadUe()
+	{
+		if (cacheBits < 63)
+			Refill();
+		if (cache == 0)
+			return Fail();
+		int zeros = H264_CLZ64(cache);
+		int length = 2 * zeros + 1;
+		if (zeros > 31)
+			return Fail();
+		if (length > cacheBits) {
+			// a code longer than the refill, only near the top of the range
+			cache <<= zeros;
+			cacheBits -= zeros;
+			uint32_t bits = ReadBits(zeros + 1);    // starts with the 1, 0 only on overrun
+			return bits ? bits - 1 : 0;
+		}
+		uint32_t value = (uint32_t)((cache >> (64 - length)) - 1);
+		cache <<= length;
+		cacheBits -= length;
+		return value;
+	}
+
+	// se(v) : ue(v) k maps to (-1)^(k+1) * ceil(k / 2)
+	int32_t ReadSe()
+	{
+		uint32_t k = ReadUe();
+		return (k & 1) ? (int32_t)((k >> 1) + 1) : -(int32_t)(k >> 1);
+	}
+
+protected:
+	uint32_t Fail()
+	{
+		overrun = true;
+		cacheBits = 0;
+		cache = 0;
+		pos = end;
+		return 0;
+	}
+
+	// tops the cache up to at least 57 bits, or to the end of the data
+	void Refill()
+	{
+		if (end - pos >= 8) {
+			uint64_t word = ((uint64_t)pos[0] << 56) | ((uint64_t)pos[1] << 48) |
+				((uint64_t)pos[2] << 40) | ((uint64_t)pos[3] << 32) |
+				((uint64_t)pos[4] << 24) | ((uint64_t)pos[5] << 16) |
+				((uint64_t)pos[6] << 8) | (uint64_t)pos[7];
+			int bytes = (64 - cacheBits) >> 3;
+			if (bytes == 0)
+				return;
+			cache |= word >> cacheBits;
+			cacheBits += bytes * 8;
+			pos += bytes;
+			if (cacheBits < 64)
+				cache &= ~0ULL << (64 - cacheBits);  // drop the bits of the partial byte
+			return;
+		}
+		while (cacheBits <= 56 && pos < end) {
+			cache |= (uint64_t)*pos++ << (56 - cacheBits);
+			cacheBits += 8;
+		}
+	}
+
+	const uint8_t *pos;
+	const uint8_t *end;
+	uint64_t cache;                 // next bits, left aligned
+	int cacheBits;
+	bool overrun;
+};
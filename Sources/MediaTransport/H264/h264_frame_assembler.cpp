@@ -0,0 +1,270 @@
+//
+//  h264_frame_assembler.cpp
+//
+
+#include <string.h>
+
+#include "h264_frame_assembler.h"
+
+#define RTP_HEADER_SIZE         12
+#define NAL_TYPE_MASK           0x1F
+#define NAL_FNRI_MASK           0xE0
+#define NAL_TYPE_IDR            5
+#define NAL_TYPE_SPS            7
+#define NAL_TYPE_PPS            8
+#define NAL_TYPE_AUD            9
+#define NAL_TYPE_STAPA          24
+#define NAL_TYPE_FUA            28
+#define FU_S_BIT                0x80
+#define STAPA_HEADER_SIZE       1
+#define LENGTH_FIELD_SIZE       2
+#define FUA_HEADER_SIZE         2
+
+static const uint8_t kStartCode[4] = { 0, 0, 0, 1 };
+
+//-------------------------------------------------------------------------------------//
+
+CH264FrameAssembler::CH264FrameAssembler(int slotCount, size_t maxFrameSize)
+	: maxFrameSize(maxFrameSize)
+{
+	int n = 1;
+	while (n < slotCount && n < 32768)
+		n <<= 1;
+	mask = n - 1;
+	slots.resize(n);
+	storage.resize((size_t)n * H264_ASSEMBLER_MAX_PAYLOAD);
+	output.resize(maxFrameSize);
+	frames.reserve(16);
+	Reset();
+}
+
+CH264FrameAssembler::~CH264FrameAssembler()
+{
+}
+
+void CH264FrameAssembler::Reset()
+{
+	memset(slots.data(), 0, slots.size() * sizeof(Slot));
+	frames.clear();
+	outputSize = 0;
+	droppedPackets = 0;
+	droppedFrames = 0;
+}
+
+CH264FrameAssembler::Slot *CH264FrameAssembler::Find(uint16_t seq)
+{
+	Slot *slot = &slots[seq & mask];
+	return slot->used && slot->seq == seq ? slot : NULL;
+}
+
+//-------------------------------------------------------------------------------------//
+
+int CH264FrameAssembler::Insert(const uint8_t *packet, size_t size)
+{
+	frames.clear();
+	outputSize = 0;
+
+	// RTP header : version 2, CSRCs, header extension and padding are skipped
+	if (size < RTP_HEADER_SIZE || (packet[0] >> 6) != 2) {
+		droppedPackets++;
+		return 0;
+	}
+	size_t offset = RTP_HEADER_SIZE + (packet[0] & 0x0F) * 4;
+	if ((packet[0] & 0x10) && offset + 4 <= size)
+		offset += 4 + (size_t)((packet[offset + 2] << 8) | packet[offset + 3]) * 4;
+	if (packet[0] & 0x20)
+		size -= packet[size - 1];
+	if (offset >= size || size - offset > H264_ASSEMBLER_MAX_PAYLOAD) {
+		droppedPackets++;
+		return 0;
+	}
+
+	bool marker = (packet[1] & 0x80) != 0;
+	uint16_t seq = (uint16_t)((packet[2] << 8) | packet[3]);
+	uint32_t timestamp = ((uint32_t)packet[4] << 24) | ((uint32_t)packet[5] << 16) |
+		((uint32_t)packet[6] << 8) | packet[7];
+	const uint8_t *payload = packet + offset;
+	size_t payloadSize = size - offset;
+
+	// a duplicate, or part of a frame already assembled
+	if (Find(seq) != NULL) {
+		droppedPackets++;
+		return 0;
+	}
+
+	uint8_t type = payload[0] & NAL_TYPE_MASK;
+	uint8_t firstType = type;
+	bool beginsNal = true;
+	if (type == NAL_TYPE_FUA) {
+		if (payloadSize < FUA_HEADER_SIZE) {
+			droppedPackets++;
+			return 0;
+		}
+		beginsNal = (payload[1] & FU_S_BIT) != 0;
+		firstType = payload[1] & NAL_TYPE_MASK;
+	}
+	else if (type == NAL_TYPE_STAPA) {
+		if (payloadSize < STAPA_HEADER_SIZE + LENGTH_FIELD_SIZE + 1) {
+			droppedPackets++;
+			return 0;
+		}
+		firstType = payload[STAPA_HEADER_SIZE + LENGTH_FIELD_SIZE] & NAL_TYPE_MASK;
+	}
+
+	// the slot may hold a packet one ring length away, the newer one stays
+	Slot *slot = &slots[seq & mask];
+	if (slot->used && (int16_t)(seq - slot->seq) < 0) {
+		droppedPackets++;
+		return 0;
+	}
+	if (slot->used && !slot->assembled)
+		droppedPackets++;               // an older packet that never made a frame
+	slot->used = true;
+	slot->continuous = false;
+	slot->assembled = false;
+	slot->marker = marker;
+	slot->beginsNal = beginsNal;
+	slot->beginsAccessUnit = beginsNal && (firstType == NAL_TYPE_AUD || firstType == NAL_TYPE_SPS);
+	slot->seq = seq;
+	slot->frameStart = seq;
+	slot->timestamp = timestamp;
+	slot->size = (uint16_t)payloadSize;
+	memcpy(Payload(seq), payload, payloadSize);
+
+	Advance(seq);
+	return (int)frames.size();
+}
+
+//-------------------------------------------------------------------------------------//
+// marks seq and the packets after it continuous for as long as they qualify,
+// assembling each frame whose marker packet is reached
+
+void CH264FrameAssembler::Advance(uint16_t seq)
+{
+	for (;; seq++) {
+		Slot *slot = Find(seq);
+		if (slot == NULL || slot->continuous)
+			return;
+
+		Slot *prev = Find((uint16_t)(seq - 1));
+		if (prev != NULL && prev->continuous && !prev->marker && prev->timestamp == slot->timestamp) {
+			// a frame longer than the ring has pushed out its own first packets
+			if ((uint16_t)(seq - prev->frameStart) > mask)
+				return;
+			slot->frameStart = prev->frameStart;
+		}
+		else if (slot->beginsNal &&
+		         ((prev != NULL && prev->timestamp != slot->timestamp) ||
+		          (prev == NULL && slot->beginsAccessUnit))) {
+			slot->frameStart = seq;
+		}
+		else {
+			return;
+		}
+		slot->continuous = true;
+
+		if (slot->marker)
+			Assemble(slot->frameStart, seq);
+	}
+}
+
+//-------------------------------------------------------------------------------------//
+
+bool CH264FrameAssembler::WriteNalu(size_t &offset, const uint8_t *nal, size_t size, H264AssembledFrame &frame)
+{
+	if (size == 0 || offset + sizeof(kStartCode) + size > output.size())
+		return false;
+	memcpy(&output[offset], kStartCode, sizeof(kStartCode));
+	memcpy(&output[offset + sizeof(kStartCode)], nal, size);
+	offset += sizeof(kStartCode) + size;
+
+	uint8_t type = nal[0] & NAL_TYPE_MASK;
+	if (type == NAL_TYPE_IDR)
+		frame.keyframe = true;
+	return true;
+}
+
+void CH264FrameAssembler::Assemble(uint16_t first, uint16_t last)
+{
+	H264AssembledFrame frame;
+	size_t offset = outputSize;
+	bool ok = true, sps = false, pps = false;
+
+	frame.timestamp = Find(last)->timestamp;
+	frame.firstSequenceNumber = first;
+	frame.lastSequenceNumber = last;
+	frame.keyframe = false;
+
+	for (uint16_t seq = first; ok; seq++) {
+		// a packet of the frame was pushed out by one a ring length later
+		const Slot *slot = Find(seq);
+		if (slot == NULL) {
+			ok = false;
+			break;
+		}
+		const uint8_t *payload = Payload(seq);
+		size_t size = slot->size;
+		uint8_t type = payload[0] & NAL_TYPE_MASK;
+
+		if (type == NAL_TYPE_FUA) {
+			// the first fragment rebuilds the NAL header from the FU indicator and header
+			if (payload[1] & FU_S_BIT) {
+				uint8_t nalHeader = (payload[0] & NAL_FNRI_MASK) | (payload[1] & NAL_TYPE_MASK);
+				ok = WriteNalu(offset, &nalHeader, 1, frame);
+				sps |= (nalHeader & NAL_TYPE_MASK) == NAL_TYPE_SPS;
+			}
+			else if (seq == first) {
+				ok = false;
+			}
+			if (ok && offset + size - FUA_HEADER_SIZE <= output.size()) {
+				memcpy(&output[offset], payload + FUA_HEADER_SIZE, size - FUA_HEADER_SIZE);
+				offset += size - FUA_HEADER_SIZE;
+			}
+			else {
+				ok = false;
+			}
+		}
+		else if (type == NAL_TYPE_STAPA) {
+			size_t pos = STAPA_HEADER_SIZE;
+			while (ok && pos < size) {
+				size_t length = pos + LENGTH_FIELD_SIZE <= size ?
+					(size_t)((payload[pos] << 8) | payload[pos + 1]) : 0;
+				pos += LENGTH_FIELD_SIZE;
+				ok = length > 0 && pos + length <= size &&
+					WriteNalu(offset, payload + pos, length, frame);
+				if (ok) {
+					sps |= (payload[pos] & NAL_TYPE_MASK) == NAL_TYPE_SPS;
+					pps |= (payload[pos] & NAL_TYPE_MASK) == NAL_TYPE_PPS;
+				}
+				pos += length;
+			}
+		}
+		else {
+			ok = WriteNalu(offset, payload, size, frame);
+			sps |= type == NAL_TYPE_SPS;
+			pps |= type == NAL_TYPE_PPS;
+		}
+		if (seq == last)
+			break;
+	}
+
+	// the packets stay until their slots are reused, so late duplicates are caught
+	// and the next frame sees its start
+	for (uint16_t seq = first; ; seq++) {
+		Slot *slot = Find(seq);
+		if (slot != NULL)
+			slot->assembled = true;
+		if (seq == last)
+			break;
+	}
+
+	if (!ok) {
+		droppedFrames++;
+		return;
+	}
+	frame.data = &output[outputSize];
+	frame.size = offset - outputSize;
+	frame.hasParameterSets = sps && pps;
+	outputSize = offset;
+	frames.push_back(frame);
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+//-------------------------------------------------------------------------------------//
+//
+// RFC 6184 depacketizer and frame assembler, the C++ counterpart of
+// RTPH264VideoPacketFramer.swift and RTPDepacketizerH264.swift.
+//
+// Packets go into a ring of slots indexed by sequence number, so inserting and
+// finding a neighbour are O(1). A packet becomes "continuous" when it starts a
+// frame or follows a continuous packet of the same frame. Every packet is marked
+// once, and a frame is complete when its marker packet becomes continuous.
+//
+// A packet starts a frame when it begins a NAL unit and
+//   - the packet before it is here with another timestamp, or
+//   - the packet before it is missing and its first NAL unit is an AUD or SPS,
+//     which only open an access unit. This is how the first frame is found,
+//     and how the assembler resyncs after a frame whose marker packet was lost.
+//
+// A complete frame is depacketized (single NAL, STAP-A, FU-A) straight into one
+// preallocated Annex-B output buffer, each NAL unit behind 00 00 00 01.
+//
+// All the packets of a frame have to be in the ring at once. A frame spanning
+// more packets than there are slots never completes, and a frame that lost a
+// packet to a newer one a ring length later is dropped.
+//
+//-------------------------------------------------------------------------------------//
+
+#define H264_ASSEMBLER_SLOTS            1024        // power of two
+#define H264_ASSEMBLER_MAX_PAYLOAD      1500
+#define H264_ASSEMBLER_MAX_FRAME        (4 * 1024 * 1024)
+
+struct H264AssembledFrame {
+	const uint8_t *data;            // Annex-B, valid until the next Insert()
+	size_t size;
+	uint32_t timestamp;
+	uint16_t firstSequenceNumber;
+	uint16_t lastSequenceNumber;
+	bool keyframe;                  // carries an IDR slice
+	bool hasParameterSets;          // carries SPS and PPS
+};
+
+class CH264FrameAssembler
+{
+public:
+	CH264FrameAssembler(int slots = H264_ASSEMBLER_SLOTS, size_t maxFrameSize = H264_ASSEMBLER_MAX_FRAME);
+	virtual ~CH264FrameAssembler();
+
+	void Reset();
+
+	// Takes one RTP packet (header included). Returns the number of frames it
+	// completed, they stay readable with Frame() until the next call.
+	int Insert(const uint8_t *packet, size_t size);
+
+	int FrameCount() const { return (int)frames.size(); }
+	const H264AssembledFrame &Frame(int index) const { return frames[index]; }
+
+	// packets that were malformed, duplicated or pushed out of the ring before completing
+	int DroppedPackets() const { return droppedPackets; }
+	// complete frames that did not fit maxFrameSize, had a malformed payload or lost a packet to the ring
+	int DroppedFrames() const { return droppedFrames; }
+
+protected:
+	struct Slot {
+		bool used;
+		bool continuous;
+		bool assembled;             // its frame was output
+		bool marker;
+		bool beginsNal;             // single NAL, STAP-A or first FU-A fragment
+		bool beginsAccessUnit;      // first NAL unit is an AUD or SPS
+		uint16_t seq;
+		uint16_t frameStart;        // sequence number of the frame's first packet, once continuous
+		uint32_t timestamp;
+		uint16_t size;
+	};
+
+	Slot *Find(uint16_t seq);
+	uint8_t *Payload(uint16_t seq) { return &storage[(size_t)(seq & mask) * H264_ASSEMBLER_MAX_PAYLOAD]; }
+	void Advance(uint16_t seq);
+	void Assemble(uint16_t first, uint16_t last);
+	bool WriteNalu(size_t &offset, const uint8_t *nal, size_t size, H264AssembledFrame &frame);
+
+	int mask;
+	size_t maxFrameSize;
+	std::vector<Slot> slots;
+	std::vector<uint8_t> storage;       // H264_ASSEMBLER_MAX_PAYLOAD per slot
+	std::vector<uint8_t> output;        // maxFrameSize, frames of one Insert() back to back
+	size_t outputSize;
+	std::vector<H264AssembledFrame> frames;
+	int droppedPackets;
+	int droppedFrames;
+};
@@ -0,0 +1,48 @@
+//
+//  h264_nalu.cpp
+//
+
+#include "h264_nalu.h"
+#include "h264_scan.h"
+
+#define START_CODE_BYTE         1       // 00 00 01
+
+size_t H264FindStartCode(const uint8_t *buffer, size_t from, size_t count)
+{
+	if (count < 3 || from >= count - 2)
+		return count;
+	size_t p = H264SelectScan()(buffer, from, count - 2, START_CODE_BYTE, START_CODE_BYTE);
+	return p < count - 2 ? p : count;
+}
+
+int H264FindNaluIndices(const uint8_t *buffer, size_t count, H264NaluIndex *indices, int capacity)
+{
+	H264ScanFn scan = H264SelectScan();
+	H264NaluIndex *last = NULL;
+	int found = 0;
+
+	// as in findNaluIndices, a start code in the last 3 bytes carries no NAL unit
+	if (count <= 3)
+		return 0;
+	size_t end = count - 3;
+
+	for (size_t p = scan(buffer, 0, end, START_CODE_BYTE, START_CODE_BYTE); p < end;
+	     p = scan(buffer, p + 3, end, START_CODE_BYTE, START_CODE_BYTE)) {
+		uint32_t start = (uint32_t)p;
+		if (start > 0 && buffer[start - 1] == 0)     // 00 00 00 01
+			start--;
+		if (last != NULL)
+			last->payloadSize = start - last->payloadStartOffset;
+		last = NULL;
+		if (found < capacity) {
+			last = &indices[found];
+			last->startOffset = start;
+			last->payloadStartOffset = (uint32_t)p + 3;
+			last->payloadSize = 0;
+		}
+		found++;
+	}
+	if (last != NULL)
+		last->payloadSize = (uint32_t)count - last->payloadStartOffset;
+	return found;
+}
@@ -0,0 +1,362 @@
+//
+//  h264_parser.cpp
+//
+
+#include <string.h>
+
+#include "h264_parser.h"
+#include "h264_rbsp.h"
+#include "h264_bit_reader.h"
+
+#define NAL_TYPE_MASK           0x1F
+#define NAL_TYPE_SLICE          1
+#define NAL_TYPE_IDR            5
+#define NAL_TYPE_SPS            7
+#define NAL_TYPE_PPS            8
+
+// The parsers unescape at most this much of a NAL unit, which covers any
+// parameter set short of pathological scaling lists or slice group maps, and
+// the fields of a slice header read here, so a large slice is never copied.
+#define PARAMETER_SET_MAX_BYTES 2048
+#define SLICE_HEADER_MAX_BYTES  64
+
+static bool IsHighProfile(int profileIdc)
+{
+	switch (profileIdc) {
+	case 100: case 110: case 122: case 244: case 44:
+	case 83: case 86: case 118: case 128: case 138:
+	case 139: case 134: case 135:
+		return true;
+	}
+	return false;
+}
+
+// scaling_list() : only the deltas are read, the lists themselves are not kept
+static bool SkipScalingList(CH264BitReader &br, int size)
+{
+	int lastScale = 8, nextScale = 8;
+	for (int j = 0; j < size && nextScale != 0; j++) {
+		int32_t delta = br.ReadSe();
+		if (delta < -128 || delta > 127)
+			return false;
+		nextScale = (lastScale + delta + 256) % 256;
+		if (nextScale != 0)
+			lastScale = nextScale;
+	}
+	return true;
+}
+
+static int CeilLog2(uint32_t n)
+{
+	int bits = 0;
+	while ((1u << bits) < n)
+		bits++;
+	return bits;
+}
+
+//-------------------------------------------------------------------------------------//
+
+int H264ParseSps(const uint8_t *nal, size_t size, H264Sps *sps)
+{
+	uint8_t scratch[PARAMETER_SET_MAX_BYTES];
+
+	if (size < 2 || (nal[0] & NAL_TYPE_MASK) != NAL_TYPE_SPS)
+		return 0;
+	nal++;
+	size--;
+	if (size > PARAMETER_SET_MAX_BYTES)
+		size = PARAMETER_SET_MAX_BYTES;
+	H264RbspView rbsp = H264RbspViewOf(nal, size, scratch);
+	CH264BitReader br(rbsp.data, rbsp.size);
+
+	memset(sps, 0, sizeof(*sps));
+	sps->profileIdc = (uint8_t)br.ReadBits(8);
+	sps->constraintFlags = (uint8_t)br.ReadBits(8);
+	sps->levelIdc = (uint8_t)br.ReadBits(8);
+	uint32_t spsId = br.ReadUe();
+	if (spsId >= H264_MAX_SPS_COUNT)
+		return 0;
+	sps->spsId = (uint8_t)spsId;
+
+	uint32_t chromaFormatIdc = 1, bitDepthLuma = 0, bitDepthChroma = 0;
+	if (IsHighProfile(sps->profileIdc)) {
+		chromaFormatIdc = br.ReadUe();
+		if (chromaFormatIdc > 3)
+			return 0;
+		if (chromaFormatIdc == 3)
+			sps->separateColourPlane = br.ReadFlag();
+		bitDepthLuma = br.ReadUe();
+		bitDepthChroma = br.ReadUe();
+		if (bitDepthLuma > 6 || bitDepthChroma > 6)
+			return 0;
+		br.SkipBits(1);                         // qpprime_y_zero_transform_bypass_flag
+		if (br.ReadFlag()) {                    // seq_scaling_matrix_present_flag
+			int lists = chromaFormatIdc != 3 ? 8 : 12;
+			for (int i = 0; i < lists; i++) {
+				if (br.ReadFlag() && !SkipScalingList(br, i < 6 ? 16 : 64))
+					return 0;
+			}
+		}
+	}
+	sps->chromaFormatIdc = (uint8_t)chromaFormatIdc;
+	sps->bitDepthLuma = (uint8_t)(bitDepthLuma + 8);
+	sps->bitDepthChroma = (uint8_t)(bitDepthChroma + 8);
+
+	uint32_t log2MaxFrameNum = br.ReadUe() + 4;
+	if (log2MaxFrameNum > 16)
+		return 0;
+	sps->log2MaxFrameNum = (uint8_t)log2MaxFrameNum;
+
+	uint32_t pocType = br.ReadUe();
+	if (pocType > 2)
+		return 0;
+	sps->picOrderCntType = (uint8_t)pocType;
+	if (pocType == 0) {
+		uint32_t log2MaxPocLsb = br.ReadUe() + 4;
+		if (log2MaxPocLsb > 16)
+			return 0;
+		sps->log2MaxPicOrderCntLsb = (uint8_t)log2MaxPocLsb;
+	}
+	else if (pocType == 1) {
+		sps->deltaPicOrderAlwaysZero = br.ReadFlag();
+		br.ReadSe();                            // offset_for_non_ref_pic
+		br.ReadSe();                            // offset_for_top_to_bottom_field
+		uint32_t cycle = br.ReadUe();
+		if (cycle > 255)
+			return 0;
+		for (uint32_t i = 0; i < cycle; i++)
+			br.ReadSe();                        // offset_for_ref_frame
+	}
+
+	uint32_t maxNumRefFrames = br.ReadUe();
+	if (maxNumRefFrames > 16)
+		return 0;
+	sps->maxNumRefFrames = (uint8_t)maxNumRefFrames;
+	br.SkipBits(1);                             // gaps_in_frame_num_value_allowed_flag
+
+	uint32_t widthInMbs = br.ReadUe() + 1;
+	uint32_t heightInMapUnits = br.ReadUe() + 1;
+	if (widthInMbs > 4096 || heightInMapUnits > 4096)
+		return 0;
+	sps->widthInMbs = widthInMbs;
+	sps->heightInMapUnits = heightInMapUnits;
+	sps->frameMbsOnly = br.ReadFlag();
+	if (!sps->frameMbsOnly)
+		br.SkipBits(1);                         // mb_adaptive_frame_field_flag
+	br.SkipBits(1);                             // direct_8x8_inference_flag
+
+	uint32_t width = widthInMbs * 16;
+	uint32_t height = (2 - sps->frameMbsOnly) * heightInMapUnits * 16;
+	sps->frameCropping = br.ReadFlag();
+	if (sps->frameCropping) {
+		uint32_t left = br.ReadUe(), right = br.ReadUe();
+		uint32_t top = br.ReadUe(), bottom = br.ReadUe();
+		// CropUnitX/Y (7-19..7-22), monochrome and separate planes crop in luma samples
+		uint32_t unitX = 1, unitY = 2 - sps->frameMbsOnly;
+		if (chromaFormatIdc != 0 && !sps->separateColourPlane) {
+			unitX = chromaFormatIdc == 3 ? 1 : 2;
+			unitY *= chromaFormatIdc == 1 ? 2 : 1;
+		}
+		uint64_t cropX = (uint64_t)unitX * ((uint64_t)left + right);
+		uint64_t cropY = (uint64_t)unitY * ((uint64_t)top + bottom);
+		if (cropX >= width || cropY >= height)
+			return 0;
+		width -= (uint32_t)cropX;
+		height -= (uint32_t)cropY;
+	}
+	sps->width = width;
+	sps->height = height;
+	sps->vuiPresent = br.ReadFlag();
+	return !br.Overrun();
+}
+
+int H264ParsePps(const uint8_t *nal, size_t size, H264Pps *pps)
+{
+	uint8_t scratch[PARAMETER_SET_MAX_BYTES];
+
+	if (size < 2 || (nal[0] & NAL_TYPE_MASK) != NAL_TYPE_PPS)
+		return 0;
+	nal++;
+	size--;
+	if (size > PARAMETER_SET_MAX_BYTES)
+		size = PARAMETER_SET_MAX_BYTES;
+	H264RbspView rbsp = H264RbspViewOf(nal, size, scratch);
+	CH264BitReader br(rbsp.data, rbsp.size);
+
+	memset(pps, 0, sizeof(*pps));
+	uint32_t ppsId = br.ReadUe();
+	uint32_t spsId = br.ReadUe();
+	if (ppsId >= H264_MAX_PPS_COUNT || spsId >= H264_MAX_SPS_COUNT)
+		return 0;
+	pps->ppsId = (uint8_t)ppsId;
+	pps->spsId = (uint8_t)spsId;
+	pps->entropyCodingMode = br.ReadFlag();
+	pps->bottomFieldPicOrderInFramePresent = br.ReadFlag();
+
+	uint32_t numSliceGroups = br.ReadUe() + 1;
+	if (numSliceGroups > 8)
+		return 0;
+	pps->numSliceGroups = (uint8_t)numSliceGroups;
+	if (numSliceGroups > 1) {
+		uint32_t mapType = br.ReadUe();
+		if (mapType == 0) {
+			for (uint32_t i = 0; i < numSliceGroups; i++)
+				br.ReadUe();                    // run_length_minus1
+		}
+		else if (mapType == 2) {
+			for (uint32_t i = 0; i + 1 < numSliceGroups; i++) {
+				br.ReadUe();                    // top_left
+				br.ReadUe();                    // bottom_right
+			}
+		}
+		else if (mapType >= 3 && mapType <= 5) {
+			br.SkipBits(1);                     // slice_group_change_direction_flag
+			br.ReadUe();                        // slice_group_change_rate_minus1
+		}
+		else if (mapType == 6) {
+			uint32_t mapUnits = br.ReadUe() + 1;
+			if (mapUnits > 4096 * 4096)
+				return 0;
+			br.SkipBits((size_t)mapUnits * CeilLog2(numSliceGroups));
+		}
+		else if (mapType > 6) {
+			return 0;
+		}
+	}
+
+	uint32_t refIdxL0 = br.ReadUe() + 1;
+	uint32_t refIdxL1 = br.ReadUe() + 1;
+	if (refIdxL0 > 32 || refIdxL1 > 32)
+		return 0;
+	pps->numRefIdxL0Default = (uint8_t)refIdxL0;
+	pps->numRefIdxL1Default = (uint8_t)refIdxL1;
+	pps->weightedPred = br.ReadFlag();
+	pps->weightedBipredIdc = (uint8_t)br.ReadBits(2);
+	if (pps->weightedBipredIdc > 2)
+		return 0;
+	int32_t qp = br.ReadSe() + 26;
+	int32_t qs = br.ReadSe() + 26;
+	int32_t chromaQpOffset = br.ReadSe();
+	// QpBdOffsetY is at most 36 (14 bit luma)
+	if (qp < -36 || qp > 51 || qs < 0 || qs > 51 || chromaQpOffset < -12 || chromaQpOffset > 12)
+		return 0;
+	pps->picInitQp = (int8_t)qp;
+	pps->picInitQs = (int8_t)qs;
+	pps->chromaQpIndexOffset = (int8_t)chromaQpOffset;
+	pps->deblockingFilterControlPresent = br.ReadFlag();
+	pps->constrainedIntraPred = br.ReadFlag();
+	pps->redundantPicCntPresent = br.ReadFlag();
+	return !br.Overrun();
+}
+
+int H264ParseSliceHeader(const uint8_t *nal, size_t size, const H264Sps *sps, const H264Pps *pps, H264SliceHeader *header)
+{
+	uint8_t scratch[SLICE_HEADER_MAX_BYTES];
+
+	if (size < 2)
+		return 0;
+	int nalType = nal[0] & NAL_TYPE_MASK;
+	if (nalType != NAL_TYPE_SLICE && nalType != NAL_TYPE_IDR)
+		return 0;
+
+	memset(header, 0, sizeof(*header));
+	header->nalRefIdc = (nal[0] >> 5) & 3;
+	header->nalUnitType = (uint8_t)nalType;
+	header->idr = nalType == NAL_TYPE_IDR;
+	nal++;
+	size--;
+	if (size > SLICE_HEADER_MAX_BYTES)
+		size = SLICE_HEADER_MAX_BYTES;
+	H264RbspView rbsp = H264RbspViewOf(nal, size, scratch);
+	CH264BitReader br(rbsp.data, rbsp.size);
+
+	header->firstMbInSlice = br.ReadUe();
+	uint32_t sliceType = br.ReadUe();
+	uint32_t ppsId = br.ReadUe();
+	if (sliceType > 9 || ppsId != pps->ppsId || pps->spsId != sps->spsId)
+		return 0;
+	header->sliceType = (uint8_t)(sliceType % 5);
+	header->ppsId = (uint8_t)ppsId;
+	if (sps->separateColourPlane)
+		header->colourPlaneId = (uint8_t)br.ReadBits(2);
+	header->frameNum = br.ReadBits(sps->log2MaxFrameNum);
+	if (!sps->frameMbsOnly) {
+		header->fieldPic = br.ReadFlag();
+		if (header->fieldPic)
+			header->bottomField = br.ReadFlag();
+	}
+	if (header->idr) {
+		header->idrPicId = br.ReadUe();
+		if (header->idrPicId > 65535)
+			return 0;
+	}
+	if (sps->picOrderCntType == 0) {
+		header->picOrderCntLsb = br.ReadBits(sps->log2MaxPicOrderCntLsb);
+		if (pps->bottomFieldPicOrderInFramePresent && !header->fieldPic)
+			header->deltaPicOrderCntBottom = br.ReadSe();
+	}
+	else if (sps->picOrderCntType == 1 && !sps->deltaPicOrderAlwaysZero) {
+		header->deltaPicOrderCnt[0] = br.ReadSe();
+		if (pps->bottomFieldPicOrderInFramePresent && !header->fieldPic)
+			header->deltaPicOrderCnt[1] = br.ReadSe();
+	}
+	if (pps->redundantPicCntPresent) {
+		header->redundantPicCnt = br.ReadUe();
+		if (header->redundantPicCnt > 127)
+			return 0;
+	}
+	return !br.Overrun();
+}
+
+//-------------------------------------------------------------------------------------//
+
+void H264ParameterSetsReset(H264ParameterSets *sets)
+{
+	sets->spsValid = 0;
+	memset(sets->ppsValid, 0, sizeof(sets->ppsValid));
+}
+
+int H264ParameterSetsUpdate(H264ParameterSets *sets, const uint8_t *nal, size_t size)
+{
+	if (size < 1)
+		return 0;
+	int nalType = nal[0] & NAL_TYPE_MASK;
+	if (nalType == NAL_TYPE_SPS) {
+		H264Sps sps;
+		if (!H264ParseSps(nal, size, &sps))
+			return 0;
+		sets->sps[sps.spsId] = sps;
+		sets->spsValid |= 1u << sps.spsId;
+		return 1;
+	}
+	if (nalType == NAL_TYPE_PPS) {
+		H264Pps pps;
+		if (!H264ParsePps(nal, size, &pps))
+			return 0;
+		sets->pps[pps.ppsId] = pps;
+		sets->ppsValid[pps.ppsId >> 5] |= 1u << (pps.ppsId & 31);
+		return 1;
+	}
+	return 0;
+}
+
+int H264ParseSliceHeaderWith(const H264ParameterSets *sets, const uint8_t *nal, size_t size, H264SliceHeader *header)
+{
+	if (size < 2)
+		return 0;
+
+	// pps_id is the third ue(v) of the header, peek at it before the full parse
+	uint8_t scratch[SLICE_HEADER_MAX_BYTES];
+	size_t prefix = size - 1 < sizeof(scratch) ? size - 1 : sizeof(scratch);
+	H264RbspView rbsp = H264RbspViewOf(nal + 1, prefix, scratch);
+	CH264BitReader br(rbsp.data, rbsp.size);
+	br.ReadUe();
+	br.ReadUe();
+	uint32_t ppsId = br.ReadUe();
+	if (br.Overrun() || ppsId >= H264_MAX_PPS_COUNT || !(sets->ppsValid[ppsId >> 5] & (1u << (ppsId & 31))))
+		return 0;
+	const H264Pps *pps = &sets->pps[ppsId];
+	if (!(sets->spsValid & (1u << pps->spsId)))
+		return 0;
+	return H264ParseSliceHeader(nal, size, &sets->sps[pps->spsId], pps, header);
+}
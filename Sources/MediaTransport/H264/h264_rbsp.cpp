@@ -0,0 +1,109 @@
+//
+//  h264_rbsp.cpp
+//
+
+#include <string.h>
+
+#include "h264_rbsp.h"
+#include "h264_scan.h"
+
+#define EPB                     3       // emulation prevention byte
+
+//-------------------------------------------------------------------------------------//
+// unescape : every 00 00 03 found by the scan drops its 03 and the scan resumes
+// after it, the spans in between are moved as a whole. first is the position
+// of the first 00 00 03 when the caller already looked for it.
+
+static size_t UnescapeFrom(uint8_t *dst, const uint8_t *src, size_t count, H264ScanFn scan, size_t first)
+{
+	size_t out = 0, start = 0;
+
+	if (count < 3) {
+		memmove(dst, src, count);
+		return count;
+	}
+
+	size_t end = count - 2;
+	for (size_t q = first; q < end; q = scan(src, q + 3, end, EPB, EPB)) {
+		memmove(dst + out, src + start, q + 2 - start);
+		out += q + 2 - start;
+		start = q + 3;
+	}
+	memmove(dst + out, src + start, count - start);
+	return out + count - start;
+}
+
+size_t H264UnescapeRbsp(uint8_t *dst, const uint8_t *src, size_t count)
+{
+	H264ScanFn scan = H264SelectScan();
+	size_t first = count < 3 ? count : scan(src, 0, count - 2, EPB, EPB);
+	return UnescapeFrom(dst, src, count, scan, first);
+}
+
+H264RbspView H264RbspViewOf(const uint8_t *nal, size_t count, uint8_t *scratch)
+{
+	H264RbspView view = { nal, count, 0 };
+	H264ScanFn scan = H264SelectScan();
+
+	if (count < 3)
+		return view;
+	size_t first = scan(nal, 0, count - 2, EPB, EPB);
+	if (first >= count - 2)
+		return view;
+	view.data = scratch;
+	view.size = UnescapeFrom(scratch, nal, count, scan, first);
+	view.copied = 1;
+	return view;
+}
+
+//-------------------------------------------------------------------------------------//
+// escape : a 03 goes before the third byte of every 00 00 0x (x <= 3), that byte
+// starts a new zero run so the scan resumes on it
+
+// 1 when the data ends in a 00 00 run (cabac_zero_words), which gets a final 03
+static inline int TrailingEpb(const uint8_t *rbsp, size_t start, size_t count)
+{
+	return count - start >= 2 && rbsp[count - 1] == 0 && rbsp[count - 2] == 0;
+}
+
+size_t H264EscapedSize(const uint8_t *rbsp, size_t count)
+{
+	size_t size = count, start = 0;
+
+	if (count >= 3) {
+		H264ScanFn scan = H264SelectScan();
+		size_t end = count - 2;
+		for (size_t q = scan(rbsp, 0, end, 0, EPB); q < end; q = scan(rbsp, q + 2, end, 0, EPB)) {
+			size++;
+			start = q + 2;
+		}
+	}
+	return size + TrailingEpb(rbsp, start, count);
+}
+
+size_t H264EscapeRbsp(uint8_t *dst, size_t capacity, const uint8_t *rbsp, size_t count)
+{
+	size_t out = 0, start = 0;
+
+	if (count >= 3) {
+		H264ScanFn scan = H264SelectScan();
+		size_t end = count - 2;
+		for (size_t q = scan(rbsp, 0, end, 0, EPB); q < end; q = scan(rbsp, q + 2, end, 0, EPB)) {
+			size_t n = q + 2 - start;
+			if (out + n + 1 > capacity)
+				return 0;
+			memcpy(dst + out, rbsp + start, n);
+			out += n;
+			dst[out++] = EPB;
+			start = q + 2;
+		}
+	}
+	int trailing = TrailingEpb(rbsp, start, count);
+	if (out + count - start + trailing > capacity)
+		return 0;
+	memcpy(dst + out, rbsp + start, count - start);
+	out += count - start;
+	if (trailing)
+		dst[out++] = EPB;
+	return out;
+}
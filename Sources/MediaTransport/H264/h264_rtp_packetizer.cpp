@@ -0,0 +1,316 @@
+//
+//  h264_rtp_packetizer.cpp
+//
+
+#include "h264_rtp_packetizer.h"
+
+#define NAL_F_BIT               0x80
+#define NAL_NRI_MASK            0x60
+#define NAL_TYPE_MASK           0x1F
+#define NAL_TYPE_STAPA          24
+#define NAL_TYPE_FUA            28
+#define FU_S_BIT                0x80
+#define FU_E_BIT                0x40
+
+//-------------------------------------------------------------------------------------//
+
+void H264SeparateEqually(std::vector<int> &sizes, int payloadLength, const H264PayloadSizeLimits &limits)
+{
+	sizes.clear();
+
+	// fits in a single packet
+	if (limits.maxPayloadLength >= limits.singlePacketReductionLength + payloadLength) {
+		sizes.push_back(payloadLength);
+		return;
+	}
+	// no room for even one byte in the first or last packet
+	if (limits.maxPayloadLength - limits.firstPacketReductionLength < 1 ||
+	    limits.maxPayloadLength - limits.lastPacketReductionLength < 1)
+		return;
+
+	// the reductions are spread like payload so every packet ends up the same size
+	int totalBytes = payloadLength + limits.firstPacketReductionLength + limits.lastPacketReductionLength;
+	int leftPackets = (totalBytes + limits.maxPayloadLength - 1) / limits.maxPayloadLength;
+	if (leftPackets == 1)
+		leftPackets = 2;
+	if (payloadLength < leftPackets)
+		return;
+
+	int bytesPerPacket = totalBytes / leftPackets;
+	int numLargerPackets = totalBytes % leftPackets;
+	int remainingData = payloadLength;
+	bool firstPacket = true;
+
+	while (remainingData > 0) {
+		if (leftPackets == numLargerPackets)
+			bytesPerPacket++;
+		int currentPacketBytes = bytesPerPacket;
+		if (firstPacket) {
+			if (currentPacketBytes > limits.firstPacketReductionLength + 1)
+				currentPacketBytes -= limits.firstPacketReductionLength;
+			else
+				currentPacketBytes = 1;
+		}
+		if (currentPacketBytes > remainingData)
+			currentPacketBytes = remainingData;
+		if (leftPackets == 2 && currentPacketBytes == remainingData)
+			currentPacketBytes--;
+		sizes.push_back(currentPacketBytes);
+		remainingData -= currentPacketBytes;
+		leftPackets--;
+		firstPacket = false;
+	}
+}
+
+//-------------------------------------------------------------------------------------//
+
+CH264RtpPacketizer::CH264RtpPacketizer(int payloadType, uint32_t ssrc, uint16_t sequenceNumber,
+                                       H264PacketizationMode mode)
+	: payloadType(payloadType & 0x7F)
+	, ssrc(ssrc)
+	, sequenceNumber(sequenceNumber)
+	, mode(mode)
+	, aggregation(true)
+	, indices(H264_NALU_INDEX_CAPACITY)
+{
+}
+
+CH264RtpPacketizer::~CH264RtpPacketizer()
+{
+}
+
+int CH264RtpPacketizer::Packetize(const uint8_t *frame, size_t size, uint32_t timestamp)
+{
+	bool ok = true;
+
+	fragments.clear();
+	packets.clear();
+	pieces.clear();
+
+	int found = H264FindNaluIndices(frame, size, indices.data(), (int)indices.size());
+	if (found > (int)indices.size()) {
+		indices.resize(found);
+		found = H264FindNaluIndices(frame, size, indices.data(), found);
+	}
+	for (int i = 0; i < found; i++) {
+		if (indices[i].payloadSize > 0)
+			fragments.push_back({ frame + indices[i].payloadStartOffset, indices[i].payloadSize });
+	}
+
+	int count = (int)fragments.size();
+	for (int i = 0; ok && i < count; ) {
+		if (mode == kH264SingleNalUnit)
+			ok = PacketizeSingleNalu(i++);
+		else if ((int)fragments[i].size > SinglePacketCapacity(i))
+			ok = PacketizeFuA(i++);
+		else if (aggregation)
+			i = PacketizeStapA(i);
+		else
+			ok = PacketizeSingleNalu(i++);
+	}
+	if (!ok) {
+		packets.clear();
+		pieces.clear();
+		return 0;
+	}
+
+	WriteRtpHeaders(timestamp);
+	return (int)packets.size();
+}
+
+//-------------------------------------------------------------------------------------//
+// payload room of a packet that carries NAL unit index alone
+
+int CH264RtpPacketizer::SinglePacketCapacity(int index) const
+{
+	int count = (int)fragments.size();
+
+	if (count == 1)
+		return limits.maxPayloadLength - limits.singlePacketReductionLength;
+	if (index == 0)
+		return limits.maxPayloadLength - limits.firstPacketReductionLength;
+	if (index == count - 1)
+		return limits.maxPayloadLength - limits.lastPacketReductionLength;
+	return limits.maxPayloadLength;
+}
+
+CH264RtpPacketizer::Packet &CH264RtpPacketizer::AddPacket(int payloadHeaderSize)
+{
+	packets.emplace_back();
+	Packet &packet = packets.back();
+	packet.headerSize = H264_RTP_HEADER_SIZE + payloadHeaderSize;
+	packet.firstPiece = (int)pieces.size();
+	packet.pieceCount = 0;
+	packet.size = packet.headerSize;
+	return packet;
+}
+
+void CH264RtpPacketizer::AddPiece(Packet &packet, const uint8_t *data, size_t size, bool aggregated)
+{
+	Piece piece;
+	piece.data = data;
+	piece.size = (uint32_t)size;
+	piece.length[0] = (uint8_t)(size >> 8);
+	piece.length[1] = (uint8_t)size;
+	piece.aggregated = aggregated;
+	pieces.push_back(piece);
+	packet.pieceCount++;
+	packet.size += size + (aggregated ? H264_LENGTH_FIELD_SIZE : 0);
+}
+
+bool CH264RtpPacketizer::PacketizeSingleNalu(int index)
+{
+	const Fragment &fragment = fragments[index];
+
+	if (SinglePacketCapacity(index) < (int)fragment.size)
+		return false;
+	AddPiece(AddPacket(0), fragment.data, fragment.size, false);
+	return true;
+}
+
+//-------------------------------------------------------------------------------------//
+// FU-A : the NAL header moves into the FU indicator/header, the rest is split
+// into equal parts. Only the packet that is first (last) of the frame keeps the
+// first (last) packet reduction.
+
+bool CH264RtpPacketizer::PacketizeFuA(int index)
+{
+	const Fragment &fragment = fragments[index];
+	int count = (int)fragments.size();
+	H264PayloadSizeLimits fuLimits = limits;
+
+	fuLimits.maxPayloadLength -= H264_FUA_HEADER_SIZE;
+	if (count != 1) {
+		if (index == count - 1)
+			fuLimits.singlePacketReductionLength = limits.lastPacketReductionLength;
+		else if (index == 0)
+			fuLimits.singlePacketReductionLength = limits.firstPacketReductionLength;
+		else
+			fuLimits.singlePacketReductionLength = 0;
+	}
+	if (index != 0)
+		fuLimits.firstPacketReductionLength = 0;
+	if (index != count - 1)
+		fuLimits.lastPacketReductionLength = 0;
+
+	H264SeparateEqually(sizes, (int)fragment.size - H264_NAL_HEADER_SIZE, fuLimits);
+	if (sizes.empty())
+		return false;
+
+	uint8_t nalHeader = fragment.data[0];
+	size_t offset = H264_NAL_HEADER_SIZE;
+	for (size_t i = 0; i < sizes.size(); i++) {
+		Packet &packet = AddPacket(H264_FUA_HEADER_SIZE);
+		packet.header[H264_RTP_HEADER_SIZE] = (nalHeader & (NAL_F_BIT | NAL_NRI_MASK)) | NAL_TYPE_FUA;
+		packet.header[H264_RTP_HEADER_SIZE + 1] = (uint8_t)((i == 0 ? FU_S_BIT : 0) |
+			(i == sizes.size() - 1 ? FU_E_BIT : 0) | (nalHeader & NAL_TYPE_MASK));
+		AddPiece(packet, fragment.data + offset, sizes[i], false);
+		offset += sizes[i];
+	}
+	return true;
+}
+
+//-------------------------------------------------------------------------------------//
+// STAP-A : consecutive NAL units that fit one packet, each behind a 16 bit size.
+// A run of one goes out as a single NAL unit packet. Returns the next NAL unit.
+
+int CH264RtpPacketizer::PacketizeStapA(int index)
+{
+	int count = (int)fragments.size();
+	int payloadLeft = limits.maxPayloadLength;
+	int headersLength = 0;
+	int end = index;
+
+	if (count == 1)
+		payloadLeft -= limits.singlePacketReductionLength;
+	else if (index == 0)
+		payloadLeft -= limits.firstPacketReductionLength;
+
+	while (end < count && end - index < H264_STAPA_MAX_NALUS) {
+		int needed = (int)fragments[end].size + headersLength;
+		if (count != 1 && end == count - 1) {
+			// may be the last packet, or the only one when the run started at the first unit
+			int reduction = limits.lastPacketReductionLength;
+			if (index == 0 && limits.singlePacketReductionLength - limits.firstPacketReductionLength > reduction)
+				reduction = limits.singlePacketReductionLength - limits.firstPacketReductionLength;
+			needed += reduction;
+		}
+		if (payloadLeft < needed)
+			break;
+		payloadLeft -= (int)fragments[end].size + headersLength;
+		// the first unit added to the run brings the STAP-A header and its own size field
+		headersLength = H264_LENGTH_FIELD_SIZE;
+		if (end == index)
+			headersLength += H264_NAL_HEADER_SIZE + H264_LENGTH_FIELD_SIZE;
+		end++;
+	}
+
+	if (end - index == 1) {
+		AddPiece(AddPacket(0), fragments[index].data, fragments[index].size, false);
+		return end;
+	}
+
+	// F is set when any unit has it, NRI is the highest of the units (RFC 6184 5.7)
+	uint8_t f = 0, nri = 0;
+	for (int i = index; i < end; i++) {
+		uint8_t nalHeader = fragments[i].data[0];
+		f |= nalHeader & NAL_F_BIT;
+		if ((nalHeader & NAL_NRI_MASK) > nri)
+			nri = nalHeader & NAL_NRI_MASK;
+	}
+	Packet &packet = AddPacket(H264_NAL_HEADER_SIZE);
+	packet.header[H264_RTP_HEADER_SIZE] = f | nri | NAL_TYPE_STAPA;
+	for (int i = index; i < end; i++)
+		AddPiece(packet, fragments[i].data, fragments[i].size, true);
+	return end;
+}
+
+//-------------------------------------------------------------------------------------//
+
+void CH264RtpPacketizer::WriteRtpHeaders(uint32_t timestamp)
+{
+	int count = (int)packets.size();
+
+	for (int i = 0; i < count; i++) {
+		uint8_t *h = packets[i].header;
+		uint16_t seq = (uint16_t)(sequenceNumber + i);
+		h[0] = 0x80;                                            // V = 2
+		h[1] = (uint8_t)((i == count - 1 ? 0x80 : 0) | payloadType);
+		h[2] = (uint8_t)(seq >> 8);
+		h[3] = (uint8_t)seq;
+		h[4] = (uint8_t)(timestamp >> 24);
+		h[5] = (uint8_t)(timestamp >> 16);
+		h[6] = (uint8_t)(timestamp >> 8);
+		h[7] = (uint8_t)timestamp;
+		h[8] = (uint8_t)(ssrc >> 24);
+		h[9] = (uint8_t)(ssrc >> 16);
+		h[10] = (uint8_t)(ssrc >> 8);
+		h[11] = (uint8_t)ssrc;
+	}
+	sequenceNumber = (uint16_t)(sequenceNumber + count);
+}
+
+uint16_t CH264RtpPacketizer::PacketSequenceNumber(int index) const
+{
+	const uint8_t *h = packets[index].header;
+	return (uint16_t)((h[2] << 8) | h[3]);
+}
+
+int CH264RtpPacketizer::PacketIov(int index, struct iovec *iov) const
+{
+	const Packet &packet = packets[index];
+	int n = 0;
+
+	iov[n].iov_base = (void *)packet.header;
+	iov[n++].iov_len = packet.headerSize;
+	for (int i = 0; i < packet.pieceCount; i++) {
+		const Piece &piece = pieces[packet.firstPiece + i];
+		if (piece.aggregated) {
+			iov[n].iov_base = (void *)piece.length;
+			iov[n++].iov_len = H264_LENGTH_FIELD_SIZE;
+		}
+		iov[n].iov_base = (void *)piece.data;
+		iov[n++].iov_len = piece.size;
+	}
+	return n;
+}
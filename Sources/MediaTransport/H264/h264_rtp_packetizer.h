@@ -0,0 +1,119 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/uio.h>
+#include <vector>
+
+#include "h264_nalu.h"
+
+//-------------------------------------------------------------------------------------//
+//
+// RFC 6184 packetizer for packetization modes 0 (single NAL unit) and 1
+// (non-interleaved : single NAL unit, STAP-A, FU-A), the C++ counterpart of
+// RTPPacketizerH264.swift with the same equal-size FU-A split (seperateEqually).
+//
+// Packetize() only plans the packets of an Annex-B frame. PacketIov() then
+// describes a packet as an iovec list for sendmsg/sendmmsg :
+//
+//   single NAL   | RTP header | -> NAL
+//   FU-A         | RTP header, FU indicator, FU header | -> NAL fragment
+//   STAP-A       | RTP header, STAP-A header, size | -> NAL | size | -> NAL ...
+//
+// The headers live in the packetizer and the payload entries point into the
+// frame, so no payload byte is copied. Both must stay untouched until the
+// packets are sent. The buffers are kept between frames, so a stream stops
+// allocating once it has seen its largest frame.
+//
+//-------------------------------------------------------------------------------------//
+
+#define H264_RTP_HEADER_SIZE        12
+#define H264_NAL_HEADER_SIZE        1
+#define H264_FUA_HEADER_SIZE        2
+#define H264_LENGTH_FIELD_SIZE      2
+#define H264_RTP_MAX_IOV            32      // RTP header + 15 STAP-A size/NAL pairs
+#define H264_STAPA_MAX_NALUS        ((H264_RTP_MAX_IOV - 1) / 2)
+
+enum H264PacketizationMode {
+	kH264SingleNalUnit = 0,
+	kH264NonInterleaved = 1,
+};
+
+// PayloadSizeLimits of RTPPacketizer.swift
+struct H264PayloadSizeLimits {
+	int maxPayloadLength = 1200;
+	int firstPacketReductionLength = 0;
+	int lastPacketReductionLength = 0;
+	int singlePacketReductionLength = 0;
+};
+
+class CH264RtpPacketizer
+{
+public:
+	CH264RtpPacketizer(int payloadType, uint32_t ssrc, uint16_t sequenceNumber,
+	                   H264PacketizationMode mode = kH264NonInterleaved);
+	virtual ~CH264RtpPacketizer();
+
+	void SetLimits(const H264PayloadSizeLimits &limits) { this->limits = limits; }
+	// off : every NAL unit that fits goes alone, as RTPPacketizerH264.swift does
+	void SetAggregation(bool enable) { aggregation = enable; }
+
+	// Plans the packets of one Annex-B frame, all with the given timestamp and the
+	// marker on the last one. Returns the packet count, 0 when a NAL unit does not
+	// fit the limits (nothing is sent and no sequence number is used).
+	int Packetize(const uint8_t *frame, size_t size, uint32_t timestamp);
+
+	int PacketCount() const { return (int)packets.size(); }
+	size_t PacketSize(int index) const { return packets[index].size; }
+	uint16_t PacketSequenceNumber(int index) const;
+
+	// Writes the iovecs of packet index (at most H264_RTP_MAX_IOV), returns their count.
+	int PacketIov(int index, struct iovec *iov) const;
+
+	uint16_t SequenceNumber() const { return sequenceNumber; }  // of the next frame's first packet
+
+protected:
+	struct Fragment {
+		const uint8_t *data;
+		size_t size;
+	};
+
+	struct Piece {
+		const uint8_t *data;
+		uint32_t size;
+		uint8_t length[H264_LENGTH_FIELD_SIZE];     // STAP-A size field, big endian
+		bool aggregated;
+	};
+
+	struct Packet {
+		uint8_t header[H264_RTP_HEADER_SIZE + H264_FUA_HEADER_SIZE];
+		int headerSize;
+		int firstPiece;
+		int pieceCount;
+		size_t size;
+	};
+
+	bool PacketizeFuA(int index);
+	int PacketizeStapA(int index);
+	bool PacketizeSingleNalu(int index);
+	int SinglePacketCapacity(int index) const;
+	Packet &AddPacket(int payloadHeaderSize);
+	void AddPiece(Packet &packet, const uint8_t *data, size_t size, bool aggregated);
+	void WriteRtpHeaders(uint32_t timestamp);
+
+	int payloadType;
+	uint32_t ssrc;
+	uint16_t sequenceNumber;
+	H264PacketizationMode mode;
+	H264PayloadSizeLimits limits;
+	bool aggregation;
+
+	std::vector<H264NaluIndex> indices;
+	std::vector<Fragment> fragments;
+	std::vector<Packet> packets;
+	std::vector<Piece> pieces;
+	std::vector<int> sizes;                 // FU-A split of one NAL unit
+};
+
+// seperateEqually of RTPPacketizer.swift : payload sizes of the packets a payload
+// is split into, empty when the limits leave no room.
+void H264SeparateEqually(std::vector<int> &sizes, int payloadLength, const H264PayloadSizeLimits &limits);
@@ -0,0 +1,146 @@
+//
+//  h264_scan.cpp
+//
+
+#include "h264_scan.h"
+#include "../Simd/simd_cpu.h"
+
+//-------------------------------------------------------------------------------------//
+// scalar : a byte above 0 in the third slot rules out the next two positions as well
+
+static size_t H264Scan_C(const uint8_t *buf, size_t p, size_t end, uint8_t lo, uint8_t hi)
+{
+	while (p < end) {
+		uint8_t c = buf[p + 2];
+		if (c > hi)
+			p += 3;
+		else if (c >= lo && buf[p + 1] == 0 && buf[p] == 0)
+			return p;
+		else
+			p += c ? 3 : 1;
+	}
+	return end;
+}
+
+//-------------------------------------------------------------------------------------//
+// SSE2 : 32 positions per step
+
+#if defined(SIMD_HAS_SSE2)
+static inline __m128i H264ScanMask_SSE2(const uint8_t *p, __m128i lo, __m128i range)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i b0 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)p), zero);
+	__m128i b1 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(p + 1)), zero);
+	__m128i c = _mm_sub_epi8(_mm_loadu_si128((const __m128i *)(p + 2)), lo);
+	__m128i b2 = _mm_cmpeq_epi8(_mm_min_epu8(c, range), c);  // c <= range, unsigned
+	return _mm_and_si128(_mm_and_si128(b0, b1), b2);
+}
+
+static size_t H264Scan_SSE2(const uint8_t *buf, size_t p, size_t end, uint8_t lo, uint8_t hi)
+{
+	const __m128i vlo = _mm_set1_epi8((char)lo);
+	const __m128i range = _mm_set1_epi8((char)(hi - lo));
+
+	for (; p + 32 <= end; p += 32) {
+		uint32_t mask0 = (uint32_t)_mm_movemask_epi8(H264ScanMask_SSE2(buf + p, vlo, range));
+		uint32_t mask1 = (uint32_t)_mm_movemask_epi8(H264ScanMask_SSE2(buf + p + 16, vlo, range));
+		uint32_t mask = mask0 | (mask1 << 16);
+		if (SIMD_UNLIKELY(mask != 0))
+			return p + SIMD_CTZ32(mask);
+	}
+	return H264Scan_C(buf, p, end, lo, hi);
+}
+#endif
+
+//-------------------------------------------------------------------------------------//
+// AVX2 : 64 positions per step
+
+#if defined(SIMD_HAS_AVX2)
+SIMD_TARGET_AVX2
+static inline __m256i H264ScanMask_AVX2(const uint8_t *p, __m256i lo, __m256i range)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i b0 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)p), zero);
+	__m256i b1 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(p + 1)), zero);
+	__m256i c = _mm256_sub_epi8(_mm256_loadu_si256((const __m256i *)(p + 2)), lo);
+	__m256i b2 = _mm256_cmpeq_epi8(_mm256_min_epu8(c, range), c);
+	return _mm256_and_si256(_mm256_and_si256(b0, b1), b2);
+}
+
+SIMD_TARGET_AVX2
+static size_t H264Scan_AVX2(const uint8_t *buf, size_t p, size_t end, uint8_t lo, uint8_t hi)
+{
+	const __m256i vlo = _mm256_set1_epi8((char)lo);
+	const __m256i range = _mm256_set1_epi8((char)(hi - lo));
+
+	for (; p + 64 <= end; p += 64) {
+		__m256i m0 = H264ScanMask_AVX2(buf + p, vlo, range);
+		__m256i m1 = H264ScanMask_AVX2(buf + p + 32, vlo, range);
+		__m256i any = _mm256_or_si256(m0, m1);
+		if (SIMD_LIKELY(_mm256_testz_si256(any, any)))
+			continue;
+		uint64_t mask = (uint32_t)_mm256_movemask_epi8(m0) |
+			((uint64_t)(uint32_t)_mm256_movemask_epi8(m1) << 32);
+		return p + SIMD_CTZ64(mask);
+	}
+	return H264Scan_C(buf, p, end, lo, hi);
+}
+#endif
+
+//-------------------------------------------------------------------------------------//
+// NEON : 32 positions per step, the lane is found by the scalar scan of the block
+
+#if defined(SIMD_HAS_NEON)
+static inline uint8x16_t H264ScanMask_NEON(const uint8_t *p, uint8x16_t lo, uint8x16_t range)
+{
+	const uint8x16_t zero = vdupq_n_u8(0);
+	uint8x16_t b0 = vceqq_u8(vld1q_u8(p), zero);
+	uint8x16_t b1 = vceqq_u8(vld1q_u8(p + 1), zero);
+	uint8x16_t b2 = vcleq_u8(vsubq_u8(vld1q_u8(p + 2), lo), range);
+	return vandq_u8(vandq_u8(b0, b1), b2);
+}
+
+static inline bool H264AnyLane_NEON(uint8x16_t v)
+{
+#if defined(__aarch64__)
+	return vmaxvq_u8(v) != 0;
+#else
+	uint32x2_t h = vreinterpret_u32_u8(vorr_u8(vget_low_u8(v), vget_high_u8(v)));
+	return (vget_lane_u32(h, 0) | vget_lane_u32(h, 1)) != 0;
+#endif
+}
+
+static size_t H264Scan_NEON(const uint8_t *buf, size_t p, size_t end, uint8_t lo, uint8_t hi)
+{
+	const uint8x16_t vlo = vdupq_n_u8(lo);
+	const uint8x16_t range = vdupq_n_u8((uint8_t)(hi - lo));
+
+	for (; p + 32 <= end; p += 32) {
+		uint8x16_t m = vorrq_u8(H264ScanMask_NEON(buf + p, vlo, range),
+		                        H264ScanMask_NEON(buf + p + 16, vlo, range));
+		if (H264AnyLane_NEON(m))
+			return H264Scan_C(buf, p, p + 32, lo, hi);
+	}
+	return H264Scan_C(buf, p, end, lo, hi);
+}
+#endif
+
+//-------------------------------------------------------------------------------------//
+
+H264ScanFn H264SelectScan()
+{
+	H264ScanFn fn = H264Scan_C;
+#if defined(SIMD_HAS_SSE2)
+	if (SIMD_TEST_CPU(kCpuHasSSE2))
+		fn = H264Scan_SSE2;
+#endif
+#if defined(SIMD_HAS_AVX2)
+	if (SIMD_TEST_CPU(kCpuHasAVX2))
+		fn = H264Scan_AVX2;
+#endif
+#if defined(SIMD_HAS_NEON)
+	if (SIMD_TEST_CPU(kCpuHasNEON))
+		fn = H264Scan_NEON;
+#endif
+	return fn;
+}
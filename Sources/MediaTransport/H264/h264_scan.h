@@ -0,0 +1,24 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+//-------------------------------------------------------------------------------------//
+//
+// Zero-run scanner shared by the Annex-B and emulation prevention code
+//
+// Finds the first p in [from, end) where buf[p] == 0, buf[p + 1] == 0 and
+// lo <= buf[p + 2] <= hi, or returns end. Reads up to buf[end + 1].
+//
+//   start code                  00 00 01        lo = hi = 1
+//   emulation prevention byte   00 00 03        lo = hi = 3
+//   byte to escape              00 00 00..03    lo = 0, hi = 3
+//
+// The vector rows test 32 (SSE2, NEON) or 64 (AVX2) positions per step
+// against the three shifted loads, the byte-wise scan handles the tail.
+//
+//-------------------------------------------------------------------------------------//
+
+typedef size_t (*H264ScanFn)(const uint8_t *buf, size_t from, size_t end, uint8_t lo, uint8_t hi);
+
+// picks the kernel for the cpu, once per call site
+H264ScanFn H264SelectScan();
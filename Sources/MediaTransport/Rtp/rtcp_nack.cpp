@@ -0,0 +1,46 @@
+//
+//  rtcp_nack.cpp
+//
+
+#include "rtcp_nack.h"
+
+#define RTCP_VERSION            2
+#define NACK_FIXED_SIZE         8       // sender and media SSRC
+#define NACK_FCI_SIZE           4
+
+static inline uint32_t Read32(const uint8_t *p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+int RtcpParseNack(const uint8_t *packet, size_t size, uint32_t mediaSsrc, uint16_t *seqs, int capacity)
+{
+	int count = 0;
+
+	while (size > 0) {
+		if (size < RTCP_HEADER_SIZE || (packet[0] >> 6) != RTCP_VERSION)
+			return -1;
+		size_t length = ((size_t)((packet[2] << 8) | packet[3]) + 1) * 4;
+		if (length > size)
+			return -1;
+
+		int fmt = packet[0] & 0x1F;
+		if (packet[1] == RTCP_PT_RTPFB && fmt == RTCP_FMT_GENERIC_NACK &&
+		    length >= RTCP_HEADER_SIZE + NACK_FIXED_SIZE &&
+		    Read32(packet + RTCP_HEADER_SIZE + 4) == mediaSsrc) {
+			for (size_t i = RTCP_HEADER_SIZE + NACK_FIXED_SIZE; i + NACK_FCI_SIZE <= length; i += NACK_FCI_SIZE) {
+				uint16_t pid = (uint16_t)((packet[i] << 8) | packet[i + 1]);
+				uint16_t blp = (uint16_t)((packet[i + 2] << 8) | packet[i + 3]);
+				if (count < capacity)
+					seqs[count++] = pid;
+				for (int bit = 0; blp != 0 && count < capacity; bit++, blp >>= 1) {
+					if (blp & 1)
+						seqs[count++] = (uint16_t)(pid + bit + 1);
+				}
+			}
+		}
+		packet += length;
+		size -= length;
+	}
+	return count;
+}
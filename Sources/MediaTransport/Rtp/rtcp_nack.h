@@ -0,0 +1,25 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+//-------------------------------------------------------------------------------------//
+//
+// RFC 4585 generic NACK (RTPFB, FMT 1) :
+//
+//   |V=2|P| FMT=1 |  PT=205  |    length    |
+//   |          SSRC of packet sender         |
+//   |          SSRC of media source          |
+//   |      PID      |      BLP      |  ... one FCI per 17 packets
+//
+// PID is a lost sequence number, bit i of BLP reports PID + i + 1 as lost too.
+//
+//-------------------------------------------------------------------------------------//
+
+#define RTCP_HEADER_SIZE            4
+#define RTCP_PT_RTPFB               205
+#define RTCP_FMT_GENERIC_NACK       1
+
+// Walks a compound RTCP packet and writes the sequence numbers that the generic
+// NACKs for mediaSsrc report as lost, in order and at most capacity of them.
+// Returns the number written, -1 when the compound packet is malformed.
+int RtcpParseNack(const uint8_t *packet, size_t size, uint32_t mediaSsrc, uint16_t *seqs, int capacity);
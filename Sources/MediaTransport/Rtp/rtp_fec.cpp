@@ -0,0 +1,402 @@
+//
+//  rtp_fec.cpp
+//
+
+#include <string.h>
+
+#include "rtp_fec.h"
+#include "rtp_packet_history.h"
+#include "../Simd/simd_cpu.h"
+
+#define RTP_VERSION             2
+#define RTP_HEADER_SIZE         12
+#define FEC_E_BIT               0x80
+#define FEC_L_BIT               0x40
+#define FEC_RECOVERY_BITS       0x3F    // P X CC
+
+static inline uint16_t Read16(const uint8_t *p)
+{
+	return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static inline uint32_t Read32(const uint8_t *p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline void Write16(uint8_t *p, uint16_t v)
+{
+	p[0] = (uint8_t)(v >> 8);
+	p[1] = (uint8_t)v;
+}
+
+static inline void Write32(uint8_t *p, uint32_t v)
+{
+	p[0] = (uint8_t)(v >> 24);
+	p[1] = (uint8_t)(v >> 16);
+	p[2] = (uint8_t)(v >> 8);
+	p[3] = (uint8_t)v;
+}
+
+void RtpFecGenerateMasks(uint64_t *masks, int mediaCount, int fecCount, RtpFecMaskType type)
+{
+	for (int j = 0; j < fecCount; j++)
+		masks[j] = 0;
+	for (int i = 0; i < mediaCount; i++) {
+		int j = type == kRtpFecMaskBursty ? i * fecCount / mediaCount : i % fecCount;
+		masks[j] |= 1ULL << i;
+	}
+}
+
+//-------------------------------------------------------------------------------------//
+
+CRtpFecEncoder::CRtpFecEncoder(int payloadType, uint32_t ssrc, uint16_t sequenceNumber)
+	: payloadType(payloadType), ssrc(ssrc), sequenceNumber(sequenceNumber)
+{
+	xorFn = RtpFecSelectXor();
+	packets.reserve(RTP_FEC_MAX_MEDIA);
+	storage.resize((size_t)RTP_FEC_MAX_MEDIA * RTP_FEC_MAX_PACKET);
+}
+
+CRtpFecEncoder::~CRtpFecEncoder()
+{
+}
+
+int CRtpFecEncoder::Encode(const struct iovec *media, int mediaCount, int fecCount, RtpFecMaskType type)
+{
+	if (mediaCount < 1 || mediaCount > RTP_FEC_MAX_MEDIA)
+		return 0;
+	if (fecCount > mediaCount)
+		fecCount = mediaCount;
+	if (fecCount < 1)
+		return 0;
+	RtpFecGenerateMasks(masks, mediaCount, fecCount, type);
+	return Encode(media, mediaCount, masks, fecCount);
+}
+
+int CRtpFecEncoder::Encode(const struct iovec *media, int mediaCount, const uint64_t *masks, int fecCount)
+{
+	packets.clear();
+	if (mediaCount < 1 || mediaCount > RTP_FEC_MAX_MEDIA || fecCount < 1 || fecCount > RTP_FEC_MAX_MEDIA)
+		return 0;
+
+	uint16_t first = 0;
+	for (int i = 0; i < mediaCount; i++) {
+		const uint8_t *p = (const uint8_t *)media[i].iov_base;
+		if (media[i].iov_len < RTP_HEADER_SIZE || (p[0] >> 6) != RTP_VERSION)
+			return 0;
+		if (i == 0)
+			first = Read16(p + 2);
+		else if (Read16(p + 2) != (uint16_t)(first + i))
+			return 0;
+	}
+
+	uint64_t valid = (1ULL << mediaCount) - 1;
+	for (int j = 0; j < fecCount; j++) {
+		size_t size;
+		if (masks[j] == 0 || (masks[j] & ~valid) != 0 ||
+		    !EncodeOne(&storage[(size_t)j * RTP_FEC_MAX_PACKET], size, media, mediaCount, first, masks[j])) {
+			packets.clear();
+			return 0;
+		}
+		packets.push_back(size);
+	}
+
+	for (int j = 0; j < fecCount; j++)
+		Write16(&storage[(size_t)j * RTP_FEC_MAX_PACKET + 2], sequenceNumber++);
+	return fecCount;
+}
+
+// writes all of the packet but its sequence number
+bool CRtpFecEncoder::EncodeOne(uint8_t *dst, size_t &size, const struct iovec *media, int mediaCount, uint16_t first, uint64_t mask)
+{
+	int shift = SIMD_CTZ64(mask);
+	uint64_t protect = mask >> shift;
+	bool longMask = (protect >> RTP_FEC_SHORT_MASK_MEDIA) != 0;
+	int maskBits = longMask ? RTP_FEC_MAX_MEDIA : RTP_FEC_SHORT_MASK_MEDIA;
+	size_t headerSize = RTP_HEADER_SIZE + RTP_FEC_HEADER_SIZE + RTP_FEC_LEVEL_HEADER_SIZE +
+		(longMask ? RTP_FEC_LONG_MASK_EXTRA : 0);
+
+	size_t protectionLength = 0;
+	for (int i = shift; i < mediaCount; i++) {
+		if ((mask >> i) & 1) {
+			size_t length = media[i].iov_len - RTP_HEADER_SIZE;
+			if (length > protectionLength)
+				protectionLength = length;
+		}
+	}
+	if (headerSize + protectionLength > RTP_FEC_MAX_PACKET)
+		return false;
+
+	uint8_t bits0 = 0, bits1 = 0;
+	uint32_t timestamp = 0;
+	uint16_t length = 0;
+	uint8_t *payload = dst + headerSize;
+	bool firstPacket = true;
+	for (int i = shift; i < mediaCount; i++) {
+		if (!((mask >> i) & 1))
+			continue;
+		const uint8_t *p = (const uint8_t *)media[i].iov_base;
+		size_t n = media[i].iov_len - RTP_HEADER_SIZE;
+		bits0 ^= p[0];
+		bits1 ^= p[1];
+		timestamp ^= Read32(p + 4);
+		length ^= (uint16_t)n;
+		if (firstPacket) {
+			memcpy(payload, p + RTP_HEADER_SIZE, n);
+			memset(payload + n, 0, protectionLength - n);
+			firstPacket = false;
+		}
+		else {
+			xorFn(payload, p + RTP_HEADER_SIZE, n);
+		}
+	}
+
+	// RTP header, the timestamp is the one of the last media packet
+	const uint8_t *last = (const uint8_t *)media[mediaCount - 1].iov_base;
+	dst[0] = RTP_VERSION << 6;
+	dst[1] = (uint8_t)(payloadType & 0x7F);
+	memcpy(dst + 4, last + 4, 4);
+	Write32(dst + 8, ssrc);
+
+	uint8_t *fec = dst + RTP_HEADER_SIZE;
+	fec[0] = (uint8_t)((longMask ? FEC_L_BIT : 0) | (bits0 & FEC_RECOVERY_BITS));
+	fec[1] = bits1;
+	Write16(fec + 2, (uint16_t)(first + shift));
+	Write32(fec + 4, timestamp);
+	Write16(fec + 8, length);
+
+	// level 0 header, the mask is MSB first from SN base
+	uint8_t *level = fec + RTP_FEC_HEADER_SIZE;
+	uint64_t bits = 0;
+	for (int i = 0; i < maskBits; i++) {
+		if ((protect >> i) & 1)
+			bits |= 1ULL << (maskBits - 1 - i);
+	}
+	Write16(level, (uint16_t)protectionLength);
+	if (longMask) {
+		Write16(level + 2, (uint16_t)(bits >> 32));
+		Write32(level + 4, (uint32_t)bits);
+	}
+	else {
+		Write16(level + 2, (uint16_t)bits);
+	}
+
+	size = headerSize + protectionLength;
+	return true;
+}
+
+//-------------------------------------------------------------------------------------//
+
+CRtpFecDecoder::CRtpFecDecoder(int fecPayloadType, int slotCount)
+	: fecPayloadType(fecPayloadType)
+{
+	int n = 1;
+	while (n < slotCount && n < 32768)
+		n <<= 1;
+	mask = n - 1;
+	xorFn = RtpFecSelectXor();
+	slots.resize(n);
+	storage.resize((size_t)n * RTP_FEC_MAX_PACKET);
+	fecs.resize(RTP_FEC_PENDING);
+	fecStorage.resize((size_t)RTP_FEC_PENDING * RTP_FEC_MAX_PACKET);
+	recovered.reserve(RTP_FEC_MAX_MEDIA);
+	Reset();
+}
+
+CRtpFecDecoder::~CRtpFecDecoder()
+{
+}
+
+void CRtpFecDecoder::Reset()
+{
+	for (Slot &slot : slots)
+		slot.used = false;
+	for (Fec &fec : fecs)
+		fec.used = false;
+	recovered.clear();
+	newest = 0;
+	mediaSsrc = 0;
+	started = false;
+	fecOrder = 0;
+	recoveredPackets = 0;
+	droppedPackets = 0;
+}
+
+CRtpFecDecoder::Slot *CRtpFecDecoder::Find(uint16_t seq)
+{
+	Slot &slot = slots[seq & mask];
+	return slot.used && slot.seq == seq ? &slot : NULL;
+}
+
+int CRtpFecDecoder::Insert(const uint8_t *packet, size_t size)
+{
+	recovered.clear();
+	if (size < RTP_HEADER_SIZE || size > RTP_FEC_MAX_PACKET || (packet[0] >> 6) != RTP_VERSION) {
+		droppedPackets++;
+		return 0;
+	}
+	if ((packet[1] & 0x7F) == fecPayloadType)
+		InsertFec(packet, size);
+	else
+		InsertMedia(packet, size);
+	RecoverAll();
+	return (int)recovered.size();
+}
+
+void CRtpFecDecoder::InsertMedia(const uint8_t *packet, size_t size)
+{
+	uint16_t seq = Read16(packet + 2);
+	Slot &slot = slots[seq & mask];
+
+	// a duplicate, or older than what the slot holds
+	if (slot.used && (int16_t)(seq - slot.seq) <= 0)
+		return;
+	memcpy(Media(seq), packet, size);
+	slot.used = true;
+	slot.seq = seq;
+	slot.size = (uint16_t)size;
+	if (!started || (int16_t)(seq - newest) > 0)
+		newest = seq;
+	mediaSsrc = Read32(packet + 8);
+	started = true;
+}
+
+void CRtpFecDecoder::InsertFec(const uint8_t *packet, size_t size)
+{
+	size_t padding;
+	size_t header = RtpHeaderSize(packet, size, &padding);
+	if (header == 0 || header + padding + RTP_FEC_HEADER_SIZE + RTP_FEC_LEVEL_HEADER_SIZE > size) {
+		droppedPackets++;
+		return;
+	}
+
+	const uint8_t *fec = packet + header;
+	size_t body = size - header - padding;
+	bool longMask = (fec[0] & FEC_L_BIT) != 0;
+	size_t fecHeaderSize = RTP_FEC_HEADER_SIZE + RTP_FEC_LEVEL_HEADER_SIZE + (longMask ? RTP_FEC_LONG_MASK_EXTRA : 0);
+	if ((fec[0] & FEC_E_BIT) || body < fecHeaderSize) {
+		droppedPackets++;
+		return;
+	}
+	const uint8_t *level = fec + RTP_FEC_HEADER_SIZE;
+	size_t protectionLength = Read16(level);
+	int maskBits = longMask ? RTP_FEC_MAX_MEDIA : RTP_FEC_SHORT_MASK_MEDIA;
+	uint64_t bits = longMask ? ((uint64_t)Read16(level + 2) << 32) | Read32(level + 4) : Read16(level + 2);
+	if (bits == 0 || body < fecHeaderSize + protectionLength) {
+		droppedPackets++;
+		return;
+	}
+
+	// the free entry, or the one that waited longest
+	Fec *entry = &fecs[0];
+	for (Fec &candidate : fecs) {
+		if (!candidate.used) {
+			entry = &candidate;
+			break;
+		}
+		if (candidate.order < entry->order)
+			entry = &candidate;
+	}
+	uint8_t *dst = &fecStorage[(size_t)(entry - &fecs[0]) * RTP_FEC_MAX_PACKET];
+	memcpy(dst, fec, fecHeaderSize + protectionLength);
+
+	entry->used = true;
+	entry->seqBase = Read16(fec + 2);
+	entry->protectionLength = (uint16_t)protectionLength;
+	entry->mask = 0;
+	for (int i = 0; i < maskBits; i++) {
+		if ((bits >> (maskBits - 1 - i)) & 1)
+			entry->mask |= 1ULL << i;
+	}
+	entry->order = fecOrder++;
+	entry->header = dst;
+	entry->payload = dst + fecHeaderSize;
+}
+
+void CRtpFecDecoder::RecoverAll()
+{
+	bool progress = true;
+	while (progress) {
+		progress = false;
+		for (Fec &fec : fecs) {
+			if (!fec.used)
+				continue;
+
+			int missing = 0;
+			uint16_t lost = 0;
+			bool stale = false;
+			for (uint64_t m = fec.mask; m != 0; m &= m - 1) {
+				uint16_t seq = (uint16_t)(fec.seqBase + SIMD_CTZ64(m));
+				if (Find(seq))
+					continue;
+				// its slot went to a newer packet, or it is far behind the newest
+				const Slot &slot = slots[seq & mask];
+				if ((slot.used && (int16_t)(slot.seq - seq) > 0) || (started && (int16_t)(newest - seq) > mask / 2)) {
+					stale = true;
+					break;
+				}
+				missing++;
+				lost = seq;
+			}
+			if (stale || missing == 0) {
+				fec.used = false;
+			}
+			else if (missing == 1) {
+				fec.used = false;
+				if (Recover(fec, lost))
+					progress = true;
+			}
+		}
+	}
+}
+
+bool CRtpFecDecoder::Recover(Fec &fec, uint16_t seq)
+{
+	size_t protectionLength = fec.protectionLength;
+	uint8_t bits0 = fec.header[0], bits1 = fec.header[1];
+	uint32_t timestamp = Read32(fec.header + 4);
+	uint16_t length = Read16(fec.header + 8);
+	uint32_t ssrc = mediaSsrc;          // a mask of one packet has no other to take it from
+
+	// the packets in the slot's place are older than seq, the slot is free to use
+	uint8_t *dst = Media(seq);
+	memcpy(dst + RTP_HEADER_SIZE, fec.payload, protectionLength);
+	for (uint64_t m = fec.mask; m != 0; m &= m - 1) {
+		uint16_t other = (uint16_t)(fec.seqBase + SIMD_CTZ64(m));
+		if (other == seq)
+			continue;
+		const uint8_t *p = Media(other);
+		size_t n = slots[other & mask].size - RTP_HEADER_SIZE;
+		if (n > protectionLength) {
+			droppedPackets++;
+			return false;
+		}
+		bits0 ^= p[0];
+		bits1 ^= p[1];
+		timestamp ^= Read32(p + 4);
+		length ^= (uint16_t)n;
+		ssrc = Read32(p + 8);
+		xorFn(dst + RTP_HEADER_SIZE, p + RTP_HEADER_SIZE, n);
+	}
+	if (length > protectionLength) {
+		droppedPackets++;
+		return false;
+	}
+
+	dst[0] = (uint8_t)((RTP_VERSION << 6) | (bits0 & FEC_RECOVERY_BITS));
+	dst[1] = bits1;
+	Write16(dst + 2, seq);
+	Write32(dst + 4, timestamp);
+	Write32(dst + 8, ssrc);
+
+	Slot &slot = slots[seq & mask];
+	slot.used = true;
+	slot.seq = seq;
+	slot.size = (uint16_t)(RTP_HEADER_SIZE + length);
+	if ((int16_t)(seq - newest) > 0)
+		newest = seq;
+	recovered.push_back(seq);
+	recoveredPackets++;
+	return true;
+}
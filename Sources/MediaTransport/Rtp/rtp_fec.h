@@ -0,0 +1,156 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/uio.h>
+#include <vector>
+
+#include "rtp_fec_xor.h"
+
+//-------------------------------------------------------------------------------------//
+//
+// RFC 5109 (ULPFEC) parity packets, sent as a separate RTP stream with their
+// own payload type and sequence numbers (RFC 5109 14.).
+//
+// A FEC packet protects the media packets set in its mask, up to 48 packets
+// from the lowest sequence number it protects (SN base). Its payload is
+//
+//   | E L P X CC | M PT recovery |        SN base          |   FEC header
+//   |                   TS recovery                       |
+//   |        length recovery      |                             (10 bytes)
+//   |     protection length       |  mask (16 or 48 bits)   |   level 0 header
+//   | XOR of the protected packets after their 12 byte RTP header,
+//   | each zero padded to the protection length                          |
+//
+// where P X CC, M PT, the timestamp and the length (the packet size less 12)
+// of the protected packets are XORed into the recovery fields as well. When
+// all but one of the protected packets are there the missing one is the XOR
+// of them and the FEC packet. FlexFEC (RFC 8627) puts a different header on
+// the same parity, only this header is written here.
+//
+//-------------------------------------------------------------------------------------//
+
+#define RTP_FEC_MAX_MEDIA           48      // mask bits with the long (L = 1) mask
+#define RTP_FEC_SHORT_MASK_MEDIA    16
+#define RTP_FEC_HEADER_SIZE         10
+#define RTP_FEC_LEVEL_HEADER_SIZE   4       // protection length, 16 bit mask
+#define RTP_FEC_LONG_MASK_EXTRA     4       // the other 32 bits of the long mask
+#define RTP_FEC_MAX_PACKET          1500
+
+enum RtpFecMaskType {
+	kRtpFecMaskInterleaved = 0,     // media packet i in FEC packet i % fecCount, for random loss
+	kRtpFecMaskBursty = 1,          // consecutive runs per FEC packet, for burst loss
+};
+
+// Masks of fecCount FEC packets over mediaCount media packets, bit i for the
+// i-th media packet. Every media packet is in exactly one mask.
+void RtpFecGenerateMasks(uint64_t *masks, int mediaCount, int fecCount, RtpFecMaskType type);
+
+//-------------------------------------------------------------------------------------//
+
+class CRtpFecEncoder
+{
+public:
+	CRtpFecEncoder(int payloadType, uint32_t ssrc, uint16_t sequenceNumber);
+	virtual ~CRtpFecEncoder();
+
+	// Builds FEC packets over media packets with consecutive sequence numbers (one
+	// iovec per serialized packet, at most RTP_FEC_MAX_MEDIA). Returns the FEC
+	// packet count, 0 when the media packets are malformed or too long for a
+	// FEC packet. They are readable until the next call.
+	int Encode(const struct iovec *media, int mediaCount, int fecCount, RtpFecMaskType type);
+	int Encode(const struct iovec *media, int mediaCount, const uint64_t *masks, int fecCount);
+
+	int PacketCount() const { return (int)packets.size(); }
+	const uint8_t *Packet(int index) const { return &storage[(size_t)index * RTP_FEC_MAX_PACKET]; }
+	size_t PacketSize(int index) const { return packets[index]; }
+
+	uint16_t SequenceNumber() const { return sequenceNumber; }
+
+protected:
+	bool EncodeOne(uint8_t *dst, size_t &size, const struct iovec *media, int mediaCount, uint16_t first, uint64_t mask);
+
+	int payloadType;
+	uint32_t ssrc;
+	uint16_t sequenceNumber;
+	RtpFecXorFn xorFn;
+
+	std::vector<size_t> packets;
+	std::vector<uint8_t> storage;
+	uint64_t masks[RTP_FEC_MAX_MEDIA];
+};
+
+//-------------------------------------------------------------------------------------//
+//
+// Receive side : media packets go into a ring of slots indexed by sequence
+// number and FEC packets wait in a small table until all but one of what they
+// protect has arrived, then the missing packet is rebuilt into its slot. A
+// rebuilt packet can complete another FEC packet, so this repeats until
+// nothing changes. It gets the SSRC of the media packets it was protected with,
+// the FEC stream has its own.
+//
+//-------------------------------------------------------------------------------------//
+
+#define RTP_FEC_DECODER_SLOTS       1024    // power of two
+#define RTP_FEC_PENDING             64      // FEC packets waiting for media
+
+class CRtpFecDecoder
+{
+public:
+	CRtpFecDecoder(int fecPayloadType, int slots = RTP_FEC_DECODER_SLOTS);
+	virtual ~CRtpFecDecoder();
+
+	void Reset();
+
+	// Takes an RTP packet, FEC or media by payload type. Returns the number of
+	// media packets it let the decoder rebuild, readable with Recovered() until
+	// the next call.
+	int Insert(const uint8_t *packet, size_t size);
+
+	int RecoveredCount() const { return (int)recovered.size(); }
+	const uint8_t *Recovered(int index) const { return Media(recovered[index]); }
+	size_t RecoveredSize(int index) const { return slots[recovered[index] & mask].size; }
+
+	int RecoveredPackets() const { return recoveredPackets; }
+	int DroppedPackets() const { return droppedPackets; }      // malformed or too long
+
+protected:
+	struct Slot {
+		bool used;
+		uint16_t seq;
+		uint16_t size;
+	};
+
+	struct Fec {
+		bool used;
+		uint16_t seqBase;
+		uint16_t protectionLength;
+		uint64_t mask;              // bit i for seqBase + i
+		uint32_t order;             // insertion count, the oldest is replaced
+		const uint8_t *header;      // FEC header in storage
+		const uint8_t *payload;
+	};
+
+	Slot *Find(uint16_t seq);
+	uint8_t *Media(uint16_t seq) { return &storage[(size_t)(seq & mask) * RTP_FEC_MAX_PACKET]; }
+	const uint8_t *Media(uint16_t seq) const { return &storage[(size_t)(seq & mask) * RTP_FEC_MAX_PACKET]; }
+	void InsertMedia(const uint8_t *packet, size_t size);
+	void InsertFec(const uint8_t *packet, size_t size);
+	bool Recover(Fec &fec, uint16_t seq);
+	void RecoverAll();
+
+	int fecPayloadType;
+	int mask;
+	uint16_t newest;
+	uint32_t mediaSsrc;             // of the last media packet
+	bool started;
+	uint32_t fecOrder;
+	int recoveredPackets;
+	int droppedPackets;
+	RtpFecXorFn xorFn;
+
+	std::vector<Slot> slots;
+	std::vector<uint8_t> storage;
+	std::vector<Fec> fecs;
+	std::vector<uint8_t> fecStorage;
+	std::vector<uint16_t> recovered;
+};
@@ -0,0 +1,108 @@
+//
+//  rtp_fec_xor.cpp
+//
+
+#include <string.h>
+
+#include "rtp_fec_xor.h"
+#include "../Simd/simd_cpu.h"
+
+//-------------------------------------------------------------------------------------//
+// scalar : 8 bytes per step through unaligned word copies
+
+static void RtpFecXor_C(uint8_t *dst, const uint8_t *src, size_t count)
+{
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		uint64_t a, b;
+		memcpy(&a, dst + i, 8);
+		memcpy(&b, src + i, 8);
+		a ^= b;
+		memcpy(dst + i, &a, 8);
+	}
+	for (; i < count; i++)
+		dst[i] ^= src[i];
+}
+
+//-------------------------------------------------------------------------------------//
+// SSE2 : 32 bytes per step
+
+#if defined(SIMD_HAS_SSE2)
+static void RtpFecXor_SSE2(uint8_t *dst, const uint8_t *src, size_t count)
+{
+	size_t i = 0;
+	for (; i + 32 <= count; i += 32) {
+		__m128i a0 = _mm_loadu_si128((const __m128i *)(dst + i));
+		__m128i a1 = _mm_loadu_si128((const __m128i *)(dst + i + 16));
+		__m128i b0 = _mm_loadu_si128((const __m128i *)(src + i));
+		__m128i b1 = _mm_loadu_si128((const __m128i *)(src + i + 16));
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_xor_si128(a0, b0));
+		_mm_storeu_si128((__m128i *)(dst + i + 16), _mm_xor_si128(a1, b1));
+	}
+	RtpFecXor_C(dst + i, src + i, count - i);
+}
+#endif
+
+//-------------------------------------------------------------------------------------//
+// AVX2 : 64 bytes per step, the tail goes through one 16 byte row if it can
+
+#if defined(SIMD_HAS_AVX2)
+SIMD_TARGET_AVX2
+static void RtpFecXor_AVX2(uint8_t *dst, const uint8_t *src, size_t count)
+{
+	size_t i = 0;
+	for (; i + 64 <= count; i += 64) {
+		__m256i a0 = _mm256_loadu_si256((const __m256i *)(dst + i));
+		__m256i a1 = _mm256_loadu_si256((const __m256i *)(dst + i + 32));
+		__m256i b0 = _mm256_loadu_si256((const __m256i *)(src + i));
+		__m256i b1 = _mm256_loadu_si256((const __m256i *)(src + i + 32));
+		_mm256_storeu_si256((__m256i *)(dst + i), _mm256_xor_si256(a0, b0));
+		_mm256_storeu_si256((__m256i *)(dst + i + 32), _mm256_xor_si256(a1, b1));
+	}
+	for (; i + 16 <= count; i += 16) {
+		__m128i a = _mm_loadu_si128((const __m128i *)(dst + i));
+		__m128i b = _mm_loadu_si128((const __m128i *)(src + i));
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_xor_si128(a, b));
+	}
+	RtpFecXor_C(dst + i, src + i, count - i);
+}
+#endif
+
+//-------------------------------------------------------------------------------------//
+// NEON : 32 bytes per step
+
+#if defined(SIMD_HAS_NEON)
+static void RtpFecXor_NEON(uint8_t *dst, const uint8_t *src, size_t count)
+{
+	size_t i = 0;
+	for (; i + 32 <= count; i += 32) {
+		uint8x16_t a0 = vld1q_u8(dst + i);
+		uint8x16_t a1 = vld1q_u8(dst + i + 16);
+		uint8x16_t b0 = vld1q_u8(src + i);
+		uint8x16_t b1 = vld1q_u8(src + i + 16);
+		vst1q_u8(dst + i, veorq_u8(a0, b0));
+		vst1q_u8(dst + i + 16, veorq_u8(a1, b1));
+	}
+	RtpFecXor_C(dst + i, src + i, count - i);
+}
+#endif
+
+//-------------------------------------------------------------------------------------//
+
+RtpFecXorFn RtpFecSelectXor()
+{
+	RtpFecXorFn fn = RtpFecXor_C;
+#if defined(SIMD_HAS_SSE2)
+	if (SIMD_TEST_CPU(kCpuHasSSE2))
+		fn = RtpFecXor_SSE2;
+#endif
+#if defined(SIMD_HAS_AVX2)
+	if (SIMD_TEST_CPU(kCpuHasAVX2))
+		fn = RtpFecXor_AVX2;
+#endif
+#if defined(SIMD_HAS_NEON)
+	if (SIMD_TEST_CPU(kCpuHasNEON))
+		fn = RtpFecXor_NEON;
+#endif
+	return fn;
+}
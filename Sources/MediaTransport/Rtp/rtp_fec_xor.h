@@ -0,0 +1,19 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+//-------------------------------------------------------------------------------------//
+//
+// XOR kernel of the FEC encoder and decoder : dst[i] ^= src[i] for i < count.
+// A packet shorter than the protected length is XORed over its own length
+// only, the zero padding RFC 5109 asks for leaves dst as it is.
+//
+// The vector rows take 32 (SSE2, NEON) or 64 (AVX2) bytes per step, a packet
+// of 1200 bytes is 19 AVX2 steps and a tail.
+//
+//-------------------------------------------------------------------------------------//
+
+typedef void (*RtpFecXorFn)(uint8_t *dst, const uint8_t *src, size_t count);
+
+// picks the kernel for the cpu, once per call site
+RtpFecXorFn RtpFecSelectXor();
@@ -0,0 +1,366 @@
+//
+//  rtp_header_extensions.cpp
+//
+
+#include <string.h>
+
+#include "rtp_header_extensions.h"
+
+#define RTP_VERSION             2
+#define RTP_HEADER_SIZE         12
+#define RTP_CC_MASK             0x0F
+#define RTP_EXTENSION_BIT       0x10
+#define RTP_EXTENSION_ONE_BYTE_RESERVED_ID  15  // stops the parse
+#define RTP_EXTENSION_PROFILE_MASK          0xFFF0
+#define ABS_SEND_TIME_PERIOD_US             64000000    // the 6 bit seconds wrap
+
+static const struct {
+	const char *uri;
+	int size;
+} kRtpExtensions[kRtpExtensionNumberOfExtensions] = {
+	{ "", 0 },
+	{ "urn:3gpp:video-orientation", 1 },
+	{ "urn:ietf:params:rtp-hdrext:ssrc-audio-level", 1 },
+	{ "http://www.webrtc.org/experiments/rtp-hdrext/abs-send-time", 3 },
+	{ "http://www.ietf.org/id/draft-holmer-rmcat-transport-wide-cc-extensions-01", 2 },
+};
+
+static inline uint16_t Read16(const uint8_t *p)
+{
+	return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static inline void Write16(uint8_t *p, uint16_t v)
+{
+	p[0] = (uint8_t)(v >> 8);
+	p[1] = (uint8_t)v;
+}
+
+static inline void Write24(uint8_t *p, uint32_t v)
+{
+	p[0] = (uint8_t)(v >> 16);
+	p[1] = (uint8_t)(v >> 8);
+	p[2] = (uint8_t)v;
+}
+
+// 6.18 fixed point seconds, wrapping every 64 s : the time is reduced to the
+// period first so the shift stays within 64 bits
+static uint32_t AbsoluteSendTime(int64_t timeUs)
+{
+	int64_t periodUs = timeUs % ABS_SEND_TIME_PERIOD_US;
+	if (periodUs < 0)
+		periodUs += ABS_SEND_TIME_PERIOD_US;
+	return (uint32_t)((((uint64_t)periodUs << 18) + 500000) / 1000000) & 0xFFFFFF;
+}
+
+const char *RtpExtensionUri(RtpExtensionType type)
+{
+	return type > kRtpExtensionNone && type < kRtpExtensionNumberOfExtensions ? kRtpExtensions[type].uri : NULL;
+}
+
+int RtpExtensionValueSize(RtpExtensionType type)
+{
+	return type > kRtpExtensionNone && type < kRtpExtensionNumberOfExtensions ? kRtpExtensions[type].size : 0;
+}
+
+RtpExtensionType RtpExtensionTypeFromUri(const char *uri)
+{
+	for (int type = kRtpExtensionNone + 1; type < kRtpExtensionNumberOfExtensions; type++) {
+		if (strcmp(uri, kRtpExtensions[type].uri) == 0)
+			return (RtpExtensionType)type;
+	}
+	return kRtpExtensionNone;
+}
+
+uint8_t *RtpFindExtension(uint8_t *packet, size_t size, int id, size_t *length)
+{
+	if (id <= 0 || size < RTP_HEADER_SIZE || (packet[0] >> 6) != RTP_VERSION || !(packet[0] & RTP_EXTENSION_BIT))
+		return NULL;
+	size_t offset = RTP_HEADER_SIZE + (size_t)(packet[0] & RTP_CC_MASK) * 4;
+	if (offset + 4 > size)
+		return NULL;
+	uint16_t profile = Read16(packet + offset);
+	size_t end = offset + 4 + (size_t)Read16(packet + offset + 2) * 4;
+	if (end > size)
+		return NULL;
+
+	size_t p = offset + 4;
+	if (profile == RTP_EXTENSION_ONE_BYTE_PROFILE) {
+		while (p < end) {
+			if (packet[p] == 0) {
+				p++;
+				continue;
+			}
+			int entryId = packet[p] >> 4;
+			size_t entryLength = (size_t)(packet[p] & 0x0F) + 1;
+			if (entryId == RTP_EXTENSION_ONE_BYTE_RESERVED_ID || p + 1 + entryLength > end)
+				break;
+			if (entryId == id) {
+				*length = entryLength;
+				return packet + p + 1;
+			}
+			p += 1 + entryLength;
+		}
+	}
+	else if ((profile & RTP_EXTENSION_PROFILE_MASK) == RTP_EXTENSION_TWO_BYTE_PROFILE) {
+		while (p < end) {
+			if (packet[p] == 0) {
+				p++;
+				continue;
+			}
+			if (p + 2 > end)
+				break;
+			int entryId = packet[p];
+			size_t entryLength = packet[p + 1];
+			if (p + 2 + entryLength > end)
+				break;
+			if (entryId == id) {
+				*length = entryLength;
+				return packet + p + 2;
+			}
+			p += 2 + entryLength;
+		}
+	}
+	return NULL;
+}
+
+//-------------------------------------------------------------------------------------//
+
+CRtpHeaderExtensionMap::CRtpHeaderExtensionMap()
+{
+	memset(types, 0, sizeof(types));
+	memset(ids, 0, sizeof(ids));
+}
+
+CRtpHeaderExtensionMap::~CRtpHeaderExtensionMap()
+{
+}
+
+bool CRtpHeaderExtensionMap::Register(RtpExtensionType type, int id)
+{
+	if (type <= kRtpExtensionNone || type >= kRtpExtensionNumberOfExtensions || id <= 0 || id > RTP_EXTENSION_MAX_ID)
+		return false;
+	if (types[id] != kRtpExtensionNone && types[id] != type)
+		return false;
+	Unregister(type);
+	types[id] = (uint8_t)type;
+	ids[type] = (uint8_t)id;
+	return true;
+}
+
+bool CRtpHeaderExtensionMap::Register(const char *uri, int id)
+{
+	return Register(RtpExtensionTypeFromUri(uri), id);
+}
+
+void CRtpHeaderExtensionMap::Unregister(RtpExtensionType type)
+{
+	if (type <= kRtpExtensionNone || type >= kRtpExtensionNumberOfExtensions)
+		return;
+	if (ids[type])
+		types[ids[type]] = kRtpExtensionNone;
+	ids[type] = 0;
+}
+
+uint8_t *CRtpHeaderExtensionMap::Find(uint8_t *packet, size_t size, RtpExtensionType type, size_t *length) const
+{
+	if (type <= kRtpExtensionNone || type >= kRtpExtensionNumberOfExtensions || ids[type] == 0)
+		return NULL;
+	size_t found;
+	uint8_t *value = RtpFindExtension(packet, size, ids[type], &found);
+	if (value == NULL || found < (size_t)kRtpExtensions[type].size)
+		return NULL;
+	if (length)
+		*length = found;
+	return value;
+}
+
+bool CRtpHeaderExtensionMap::GetVideoRotation(uint8_t *packet, size_t size, int *rotation) const
+{
+	// |0 0 0 0 C F R R|
+	const uint8_t *value = Find(packet, size, kRtpExtensionVideoRotation, NULL);
+	if (value == NULL)
+		return false;
+	*rotation = (value[0] & 0x03) * 90;
+	return true;
+}
+
+bool CRtpHeaderExtensionMap::GetAudioLevel(uint8_t *packet, size_t size, bool *voiceActivity, int *level) const
+{
+	// |V| level|
+	const uint8_t *value = Find(packet, size, kRtpExtensionAudioLevel, NULL);
+	if (value == NULL)
+		return false;
+	*voiceActivity = (value[0] & 0x80) != 0;
+	*level = value[0] & 0x7F;
+	return true;
+}
+
+bool CRtpHeaderExtensionMap::GetAbsoluteSendTime(uint8_t *packet, size_t size, uint32_t *sendTime) const
+{
+	const uint8_t *value = Find(packet, size, kRtpExtensionAbsoluteSendTime, NULL);
+	if (value == NULL)
+		return false;
+	*sendTime = ((uint32_t)value[0] << 16) | ((uint32_t)value[1] << 8) | value[2];
+	return true;
+}
+
+bool CRtpHeaderExtensionMap::GetTransportSequenceNumber(uint8_t *packet, size_t size, uint16_t *sequenceNumber) const
+{
+	const uint8_t *value = Find(packet, size, kRtpExtensionTransportSequenceNumber, NULL);
+	if (value == NULL)
+		return false;
+	*sequenceNumber = Read16(value);
+	return true;
+}
+
+bool CRtpHeaderExtensionMap::RewriteAbsoluteSendTime(uint8_t *packet, size_t size, int64_t timeUs) const
+{
+	uint8_t *value = Find(packet, size, kRtpExtensionAbsoluteSendTime, NULL);
+	if (value == NULL)
+		return false;
+	Write24(value, AbsoluteSendTime(timeUs));
+	return true;
+}
+
+bool CRtpHeaderExtensionMap::RewriteTransportSequenceNumber(uint8_t *packet, size_t size, uint16_t sequenceNumber) const
+{
+	uint8_t *value = Find(packet, size, kRtpExtensionTransportSequenceNumber, NULL);
+	if (value == NULL)
+		return false;
+	Write16(value, sequenceNumber);
+	return true;
+}
+
+//-------------------------------------------------------------------------------------//
+
+CRtpHeaderExtensionWriter::CRtpHeaderExtensionWriter(const CRtpHeaderExtensionMap &map)
+	: map(map), packet(NULL), capacity(0), blockOffset(0), dataSize(0), twoByte(false), count(0)
+{
+}
+
+CRtpHeaderExtensionWriter::~CRtpHeaderExtensionWriter()
+{
+}
+
+void CRtpHeaderExtensionWriter::Reset(uint8_t *packet, size_t capacity)
+{
+	this->packet = packet;
+	this->capacity = capacity;
+	packet[0] &= ~RTP_EXTENSION_BIT;
+	blockOffset = RTP_HEADER_SIZE + (size_t)(packet[0] & RTP_CC_MASK) * 4;
+	dataSize = 0;
+	twoByte = false;
+	count = 0;
+}
+
+size_t CRtpHeaderExtensionWriter::HeaderSize() const
+{
+	return count ? blockOffset + 4 + (dataSize + 3) / 4 * 4 : blockOffset;
+}
+
+uint8_t *CRtpHeaderExtensionWriter::Allocate(int id, size_t length)
+{
+	if (packet == NULL || id <= 0 || id > RTP_EXTENSION_MAX_ID || length > RTP_EXTENSION_MAX_SIZE)
+		return NULL;
+	uint8_t *data = packet + blockOffset + 4;
+	for (int i = 0; i < count; i++) {
+		if (entries[i].id == id)
+			return entries[i].length == length ? data + entries[i].offset : NULL;
+	}
+	if (count == RTP_EXTENSION_MAX_ENTRIES)
+		return NULL;
+
+	bool needTwoByte = id > RTP_EXTENSION_ONE_BYTE_MAX_ID || length == 0 || length > RTP_EXTENSION_ONE_BYTE_MAX_SIZE;
+	if (count == 0)
+		twoByte = needTwoByte;
+	size_t entryHeader = twoByte || needTwoByte ? 2 : 1;
+	size_t promotion = needTwoByte && !twoByte ? count : 0;
+	size_t size = dataSize + promotion + entryHeader + length;
+	if (blockOffset + 4 + (size + 3) / 4 * 4 > capacity)
+		return NULL;
+	if (promotion)
+		PromoteToTwoByte();
+
+	if (count == 0) {
+		packet[0] |= RTP_EXTENSION_BIT;
+		Write16(packet + blockOffset, twoByte ? RTP_EXTENSION_TWO_BYTE_PROFILE : RTP_EXTENSION_ONE_BYTE_PROFILE);
+	}
+	uint8_t *entry = data + dataSize;
+	if (twoByte) {
+		entry[0] = (uint8_t)id;
+		entry[1] = (uint8_t)length;
+	}
+	else
+		entry[0] = (uint8_t)((id << 4) | (length - 1));
+	memset(entry + entryHeader, 0, length);
+
+	entries[count].id = (uint8_t)id;
+	entries[count].length = (uint8_t)length;
+	entries[count].offset = (uint16_t)(dataSize + entryHeader);
+	count++;
+	dataSize = size;
+	WriteLength();
+	return entry + entryHeader;
+}
+
+// Each value moves right by one byte per entry up to it, the last one first.
+void CRtpHeaderExtensionWriter::PromoteToTwoByte()
+{
+	uint8_t *data = packet + blockOffset + 4;
+	for (int i = count - 1; i >= 0; i--) {
+		Entry &entry = entries[i];
+		size_t offset = entry.offset + i + 1;
+		memmove(data + offset, data + entry.offset, entry.length);
+		data[offset - 2] = entry.id;
+		data[offset - 1] = entry.length;
+		entry.offset = (uint16_t)offset;
+	}
+	dataSize += count;
+	twoByte = true;
+	Write16(packet + blockOffset, RTP_EXTENSION_TWO_BYTE_PROFILE);
+	WriteLength();
+}
+
+void CRtpHeaderExtensionWriter::WriteLength()
+{
+	size_t words = (dataSize + 3) / 4;
+	Write16(packet + blockOffset + 2, (uint16_t)words);
+	memset(packet + blockOffset + 4 + dataSize, 0, words * 4 - dataSize);
+}
+
+bool CRtpHeaderExtensionWriter::SetVideoRotation(int rotation)
+{
+	uint8_t *value = Allocate(kRtpExtensionVideoRotation, 1);
+	if (value == NULL)
+		return false;
+	value[0] = (uint8_t)((rotation / 90) & 0x03);
+	return true;
+}
+
+bool CRtpHeaderExtensionWriter::SetAudioLevel(bool voiceActivity, int level)
+{
+	uint8_t *value = Allocate(kRtpExtensionAudioLevel, 1);
+	if (value == NULL)
+		return false;
+	value[0] = (uint8_t)((voiceActivity ? 0x80 : 0) | (level < 0 ? 0 : level > 127 ? 127 : level));
+	return true;
+}
+
+bool CRtpHeaderExtensionWriter::SetAbsoluteSendTime(int64_t timeUs)
+{
+	uint8_t *value = Allocate(kRtpExtensionAbsoluteSendTime, 3);
+	if (value == NULL)
+		return false;
+	Write24(value, AbsoluteSendTime(timeUs));
+	return true;
+}
+
+bool CRtpHeaderExtensionWriter::SetTransportSequenceNumber(uint16_t sequenceNumber)
+{
+	uint8_t *value = Allocate(kRtpExtensionTransportSequenceNumber, 2);
+	if (value == NULL)
+		return false;
+	Write16(value, sequenceNumber);
+	return true;
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+//-------------------------------------------------------------------------------------//
+//
+// RTP header extensions (RFC 8285) without allocation on the packet path.
+//
+// CRtpHeaderExtensionMap is the negotiated extmap : a flat table indexed by the
+// ID (1..14 for the one-byte form, up to 255 for the two-byte form) holding the
+// extension type, and the reverse table from type to ID. Lookups either way are
+// a single array read.
+//
+// CRtpHeaderExtensionWriter builds the extension block right after the CSRCs of
+// a packet being assembled and keeps its entries in a fixed table. It starts in
+// the one-byte form (0xBEDE) and moves to the two-byte form (0x100X) only when an
+// ID above 14 or a value above 16 bytes comes in, shifting the values already
+// written in place :
+//
+//   one-byte   | BE DE | words | ID len-1 | value | ID len-1 | value | 0 pad |
+//   two-byte   | 10 00 | words | ID | len | value | ID | len | value | 0 pad |
+//
+// The block is written before the payload, like RTPPacket.AllocateExtension.
+//
+// The Find / Get / Rewrite calls work on received packets in place, the
+// forwarding path rewrites the transport-wide sequence number or abs-send-time
+// without copying the packet.
+//
+//-------------------------------------------------------------------------------------//
+
+#define RTP_EXTENSION_ONE_BYTE_PROFILE      0xBEDE
+#define RTP_EXTENSION_TWO_BYTE_PROFILE      0x1000  // low 4 bits are appbits
+#define RTP_EXTENSION_ONE_BYTE_MAX_ID       14
+#define RTP_EXTENSION_ONE_BYTE_MAX_SIZE     16
+#define RTP_EXTENSION_MAX_ID                255
+#define RTP_EXTENSION_MAX_SIZE              255
+#define RTP_EXTENSION_MAX_ENTRIES           16      // in one writer
+
+enum RtpExtensionType {
+	kRtpExtensionNone = 0,
+	kRtpExtensionVideoRotation,             // urn:3gpp:video-orientation
+	kRtpExtensionAudioLevel,                // RFC 6464
+	kRtpExtensionAbsoluteSendTime,
+	kRtpExtensionTransportSequenceNumber,
+	kRtpExtensionNumberOfExtensions
+};
+
+// URI of the extmap attribute, and the value size in bytes
+const char *RtpExtensionUri(RtpExtensionType type);
+int RtpExtensionValueSize(RtpExtensionType type);
+RtpExtensionType RtpExtensionTypeFromUri(const char *uri);
+
+// Extension value of 'id' in an RTP packet, NULL when it is not there. Both forms
+// are read, padding is skipped.
+uint8_t *RtpFindExtension(uint8_t *packet, size_t size, int id, size_t *length);
+
+class CRtpHeaderExtensionMap
+{
+public:
+	CRtpHeaderExtensionMap();
+	virtual ~CRtpHeaderExtensionMap();
+
+	// false for an ID out of range or taken by another type
+	bool Register(RtpExtensionType type, int id);
+	bool Register(const char *uri, int id);
+	void Unregister(RtpExtensionType type);
+
+	// 0 when the type is not registered
+	int Id(RtpExtensionType type) const { return ids[type]; }
+	RtpExtensionType Type(int id) const { return id > 0 && id <= RTP_EXTENSION_MAX_ID ? (RtpExtensionType)types[id] : kRtpExtensionNone; }
+
+	uint8_t *Find(uint8_t *packet, size_t size, RtpExtensionType type, size_t *length) const;
+
+	// Values of a received packet, false when the extension is missing or too short.
+	// The rotation is in degrees, the audio level in -dBov (0..127), the send time
+	// the 24 bit 6.18 fixed point seconds.
+	bool GetVideoRotation(uint8_t *packet, size_t size, int *rotation) const;
+	bool GetAudioLevel(uint8_t *packet, size_t size, bool *voiceActivity, int *level) const;
+	bool GetAbsoluteSendTime(uint8_t *packet, size_t size, uint32_t *sendTime) const;
+	bool GetTransportSequenceNumber(uint8_t *packet, size_t size, uint16_t *sequenceNumber) const;
+
+	// In place for forwarding, false when the packet does not carry the extension
+	bool RewriteAbsoluteSendTime(uint8_t *packet, size_t size, int64_t timeUs) const;
+	bool RewriteTransportSequenceNumber(uint8_t *packet, size_t size, uint16_t sequenceNumber) const;
+
+protected:
+	uint8_t types[RTP_EXTENSION_MAX_ID + 1];
+	uint8_t ids[kRtpExtensionNumberOfExtensions];
+};
+
+class CRtpHeaderExtensionWriter
+{
+public:
+	CRtpHeaderExtensionWriter(const CRtpHeaderExtensionMap &map);
+	virtual ~CRtpHeaderExtensionWriter();
+
+	// Starts the extension block of a packet whose fixed header and CSRCs are
+	// written, clearing the X bit. capacity is the size of the packet buffer.
+	void Reset(uint8_t *packet, size_t capacity);
+
+	// Room for a value of 'length' bytes, zero filled, NULL when the ID is invalid,
+	// the buffer is full or the ID is already there with another length.
+	uint8_t *Allocate(int id, size_t length);
+	uint8_t *Allocate(RtpExtensionType type, size_t length) { return map.Id(type) ? Allocate(map.Id(type), length) : NULL; }
+
+	// false when the type is not registered or there is no room
+	bool SetVideoRotation(int rotation);
+	bool SetAudioLevel(bool voiceActivity, int level);
+	bool SetAbsoluteSendTime(int64_t timeUs);
+	bool SetTransportSequenceNumber(uint16_t sequenceNumber);
+
+	// fixed header, CSRCs and the padded extension block : where the payload goes
+	size_t HeaderSize() const;
+	bool TwoByte() const { return twoByte; }
+
+protected:
+	struct Entry {
+		uint8_t id;
+		uint8_t length;
+		uint16_t offset;            // of the value from the start of the block data
+	};
+
+	void PromoteToTwoByte();
+	void WriteLength();
+
+	const CRtpHeaderExtensionMap &map;
+	uint8_t *packet;
+	size_t capacity;
+	size_t blockOffset;             // of the 4 byte profile / length word
+	size_t dataSize;                // without padding
+	bool twoByte;
+	int count;
+	Entry entries[RTP_EXTENSION_MAX_ENTRIES];
+};
@@ -0,0 +1,330 @@
+//
+//  rtp_pacer.cpp
+//
+
+#include <string.h>
+
+#include "rtp_pacer.h"
+#include "../Simd/simd_cpu.h"
+
+#define US_PER_SECOND           1000000
+
+//-------------------------------------------------------------------------------------//
+
+CRtpPacer::CRtpPacer(RtpPacerSendFn send, void *context, int queueCapacity)
+	: send(send), context(context), bitrate(0), maxQueueUs(RTP_PACER_MAX_QUEUE_US), budget(0), lastUs(0),
+	  started(false), queuedBytes(0), pacedBytes(0), sentBytes(0),
+	  scheduler(NULL), next(NULL), prev(NULL), deadline(0), wheelSlot(-1)
+{
+	int n = 1;
+	while (n < queueCapacity && n < (1 << 20))
+		n <<= 1;
+	for (Queue &queue : queues) {
+		queue.ring.resize(n);
+		queue.head = 0;
+		queue.count = 0;
+	}
+}
+
+CRtpPacer::~CRtpPacer()
+{
+	if (scheduler)
+		scheduler->Remove(this);
+}
+
+void CRtpPacer::SetBitrate(int64_t bitsPerSecond, double multiplier)
+{
+	bitrate = (int64_t)(bitsPerSecond * multiplier);
+}
+
+int64_t CRtpPacer::PacingRate() const
+{
+	if (bitrate <= 0 || maxQueueUs <= 0)
+		return bitrate;
+	int64_t drain = (int64_t)((double)pacedBytes * 8 * US_PER_SECOND / maxQueueUs);
+	return drain > bitrate ? drain : bitrate;
+}
+
+void CRtpPacer::Refill(int64_t nowUs)
+{
+	if (!started) {
+		started = true;
+		lastUs = nowUs;
+	}
+	int64_t elapsed = nowUs - lastUs;
+	if (elapsed <= 0)
+		return;
+	lastUs = nowUs;
+
+	// past the time it takes to fill the bucket a gap adds nothing, which
+	// also keeps the product in range after a long idle period
+	int64_t rate = PacingRate();
+	if (rate <= 0)
+		return;
+	int64_t capacity = rate * RTP_PACER_MAX_BURST_US;
+	int64_t fill = (capacity - budget) / rate + 1;
+	if (elapsed > fill)
+		elapsed = fill;
+	budget += elapsed * rate;
+	if (budget > capacity)
+		budget = capacity;
+}
+
+int CRtpPacer::NextPriority() const
+{
+	for (int i = 0; i < kRtpPacerPriorities; i++) {
+		if (queues[i].count > 0)
+			return i;
+	}
+	return -1;
+}
+
+bool CRtpPacer::Enqueue(RtpPacerPriority priority, const uint8_t *data, size_t size, void *user, int64_t nowUs)
+{
+	Queue &queue = queues[priority];
+	int capacity = (int)queue.ring.size();
+	if (queue.count == capacity)
+		return false;
+
+	RtpPacedPacket &packet = queue.ring[(queue.head + queue.count) & (capacity - 1)];
+	packet.data = data;
+	packet.size = size;
+	packet.user = user;
+	packet.enqueueUs = nowUs;
+	packet.priority = priority;
+	queue.count++;
+	queuedBytes += size;
+	if (priority == kRtpPacerRetransmission || priority == kRtpPacerVideo)
+		pacedBytes += size;
+
+	if (scheduler) {
+		int64_t sendUs = NextSendTime(nowUs);
+		if (wheelSlot == -1 || sendUs < deadline)
+			scheduler->Schedule(this, sendUs);
+	}
+	return true;
+}
+
+int64_t CRtpPacer::NextSendTime(int64_t nowUs)
+{
+	int priority = NextPriority();
+	if (priority < 0)
+		return RTP_PACER_IDLE;
+	Refill(nowUs);
+	int64_t rate = PacingRate();
+	if (priority == kRtpPacerAudio || rate <= 0 || budget > 0)
+		return nowUs;
+	return nowUs + (-budget) / rate + 1;
+}
+
+int64_t CRtpPacer::Process(int64_t nowUs)
+{
+	Refill(nowUs);
+	for (;;) {
+		int priority = NextPriority();
+		if (priority < 0)
+			break;
+		if (priority != kRtpPacerAudio && bitrate > 0 && budget <= 0)
+			break;
+
+		Queue &queue = queues[priority];
+		RtpPacedPacket packet = queue.ring[queue.head];
+		queue.head = (queue.head + 1) & ((int)queue.ring.size() - 1);
+		queue.count--;
+		queuedBytes -= packet.size;
+		if (priority == kRtpPacerRetransmission || priority == kRtpPacerVideo)
+			pacedBytes -= packet.size;
+		if (bitrate > 0)
+			budget -= (int64_t)packet.size * 8 * US_PER_SECOND;
+		sentBytes += packet.size;
+		send(context, packet);
+	}
+	return NextSendTime(nowUs);
+}
+
+//-------------------------------------------------------------------------------------//
+
+CRtpPacerScheduler::CRtpPacerScheduler()
+	: started(false), currentUs(0)
+{
+	memset(slots, 0, sizeof(slots));
+	memset(occupied, 0, sizeof(occupied));
+	due.reserve(64);
+}
+
+CRtpPacerScheduler::~CRtpPacerScheduler()
+{
+	for (int level = 0; level < RTP_PACER_WHEEL_LEVELS; level++) {
+		for (int i = 0; i < RTP_PACER_WHEEL_SLOTS; i++) {
+			while (slots[level][i])
+				Remove(slots[level][i]);
+		}
+	}
+}
+
+void CRtpPacerScheduler::Add(CRtpPacer *pacer, int64_t nowUs)
+{
+	if (!started) {
+		started = true;
+		currentUs = nowUs;
+	}
+	if (pacer->scheduler)
+		pacer->scheduler->Remove(pacer);
+	pacer->scheduler = this;
+	int64_t sendUs = pacer->NextSendTime(nowUs);
+	if (sendUs != RTP_PACER_IDLE)
+		Schedule(pacer, sendUs);
+}
+
+void CRtpPacerScheduler::Remove(CRtpPacer *pacer)
+{
+	Unlink(pacer);
+	pacer->scheduler = NULL;
+}
+
+void CRtpPacerScheduler::Link(int wheelSlot, CRtpPacer *pacer)
+{
+	int level = wheelSlot >> RTP_PACER_WHEEL_BITS;
+	int slot = wheelSlot & (RTP_PACER_WHEEL_SLOTS - 1);
+	CRtpPacer *&head = slots[level][slot];
+	pacer->prev = NULL;
+	pacer->next = head;
+	if (head)
+		head->prev = pacer;
+	head = pacer;
+	occupied[level][slot >> 6] |= 1ULL << (slot & 63);
+	pacer->wheelSlot = wheelSlot;
+}
+
+void CRtpPacerScheduler::Unlink(CRtpPacer *pacer)
+{
+	if (pacer->wheelSlot == -1)
+		return;
+	int level = pacer->wheelSlot >> RTP_PACER_WHEEL_BITS;
+	int slot = pacer->wheelSlot & (RTP_PACER_WHEEL_SLOTS - 1);
+	CRtpPacer *&head = slots[level][slot];
+	if (pacer->prev)
+		pacer->prev->next = pacer->next;
+	else
+		head = pacer->next;
+	if (pacer->next)
+		pacer->next->prev = pacer->prev;
+	if (head == NULL)
+		occupied[level][slot >> 6] &= ~(1ULL << (slot & 63));
+	pacer->next = pacer->prev = NULL;
+	pacer->wheelSlot = -1;
+}
+
+// The fine level holds deadlines in [currentUs, currentUs + RTP_PACER_WHEEL_SLOTS),
+// the coarse one the later ones, by block of RTP_PACER_WHEEL_SLOTS us. A block is
+// always after the one of currentUs and at most RTP_PACER_WHEEL_SLOTS - 1 blocks
+// after it, so every coarse slot holds a single block.
+void CRtpPacerScheduler::Schedule(CRtpPacer *pacer, int64_t deadline)
+{
+	Unlink(pacer);
+	if (deadline < currentUs)
+		deadline = currentUs;
+	else if (deadline - currentUs > RTP_PACER_WHEEL_HORIZON)
+		deadline = currentUs + RTP_PACER_WHEEL_HORIZON;
+	pacer->deadline = deadline;
+	if (deadline - currentUs < RTP_PACER_WHEEL_SLOTS)
+		Link((int)(deadline & (RTP_PACER_WHEEL_SLOTS - 1)), pacer);
+	else
+		Link(RTP_PACER_WHEEL_SLOTS + (int)((deadline >> RTP_PACER_WHEEL_BITS) & (RTP_PACER_WHEEL_SLOTS - 1)), pacer);
+}
+
+// Index of the first non-empty slot of the level among the count slots from
+// start + i, word by word, -1 when there is none.
+int CRtpPacerScheduler::NextOccupied(int level, int start, int i, int count) const
+{
+	while (i < count) {
+		int slot = (start + i) & (RTP_PACER_WHEEL_SLOTS - 1);
+		uint64_t word = occupied[level][slot >> 6] >> (slot & 63);
+		if (word == 0) {
+			i += 64 - (slot & 63);
+			continue;
+		}
+		i += SIMD_CTZ64(word);
+		return i < count ? i : -1;
+	}
+	return -1;
+}
+
+int CRtpPacerScheduler::Run(int64_t nowUs)
+{
+	if (!started || nowUs < currentUs)
+		return 0;
+
+	// the fine slots from currentUs to nowUs, at most one revolution
+	due.clear();
+	int64_t span = nowUs - currentUs + 1;
+	int count = span < RTP_PACER_WHEEL_SLOTS ? (int)span : RTP_PACER_WHEEL_SLOTS;
+	int start = (int)(currentUs & (RTP_PACER_WHEEL_SLOTS - 1));
+	for (int i = 0; (i = NextOccupied(0, start, i, count)) >= 0; i++) {
+		int slot = (start + i) & (RTP_PACER_WHEEL_SLOTS - 1);
+		while (slots[0][slot]) {
+			CRtpPacer *pacer = slots[0][slot];
+			Unlink(pacer);
+			due.push_back(pacer);
+		}
+	}
+
+	// the coarse slots of the blocks entered, down to the fine level or due
+	int64_t block = currentUs >> RTP_PACER_WHEEL_BITS;
+	currentUs = nowUs + 1;
+	int64_t blocks = (currentUs >> RTP_PACER_WHEEL_BITS) - block;
+	count = blocks < RTP_PACER_WHEEL_SLOTS ? (int)blocks : RTP_PACER_WHEEL_SLOTS;
+	start = (int)((block + 1) & (RTP_PACER_WHEEL_SLOTS - 1));
+	for (int i = 0; (i = NextOccupied(1, start, i, count)) >= 0; i++) {
+		int slot = (start + i) & (RTP_PACER_WHEEL_SLOTS - 1);
+		while (slots[1][slot]) {
+			CRtpPacer *pacer = slots[1][slot];
+			Unlink(pacer);
+			if (pacer->deadline <= nowUs)
+				due.push_back(pacer);
+			else
+				Schedule(pacer, pacer->deadline);
+		}
+	}
+
+	// a send function may queue more packets and schedule a pacer again,
+	// what Process() returns is the final word
+	for (CRtpPacer *pacer : due) {
+		int64_t sendUs = pacer->Process(nowUs);
+		if (sendUs == RTP_PACER_IDLE)
+			Unlink(pacer);
+		else
+			Schedule(pacer, sendUs);
+	}
+	return (int)due.size();
+}
+
+int64_t CRtpPacerScheduler::EarliestDeadline(const CRtpPacer *pacer) const
+{
+	int64_t earliest = pacer->deadline;
+	for (pacer = pacer->next; pacer; pacer = pacer->next) {
+		if (pacer->deadline < earliest)
+			earliest = pacer->deadline;
+	}
+	return earliest;
+}
+
+int64_t CRtpPacerScheduler::NextDeadline() const
+{
+	// a fine slot holds one deadline, a coarse one a block of them, and the
+	// first coarse block can come before the end of the fine level
+	int64_t earliest = RTP_PACER_IDLE;
+	int start = (int)(currentUs & (RTP_PACER_WHEEL_SLOTS - 1));
+	int i = NextOccupied(0, start, 0, RTP_PACER_WHEEL_SLOTS);
+	if (i >= 0)
+		earliest = slots[0][(start + i) & (RTP_PACER_WHEEL_SLOTS - 1)]->deadline;
+
+	start = (int)(((currentUs >> RTP_PACER_WHEEL_BITS) + 1) & (RTP_PACER_WHEEL_SLOTS - 1));
+	i = NextOccupied(1, start, 0, RTP_PACER_WHEEL_SLOTS - 1);
+	if (i >= 0) {
+		int64_t coarse = EarliestDeadline(slots[1][(start + i) & (RTP_PACER_WHEEL_SLOTS - 1)]);
+		if (earliest == RTP_PACER_IDLE || coarse < earliest)
+			earliest = coarse;
+	}
+	return earliest;
+}
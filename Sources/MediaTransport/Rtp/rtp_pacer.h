@@ -0,0 +1,166 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+//-------------------------------------------------------------------------------------//
+//
+// Token bucket pacer for the packets of one RTP session.
+//
+// The bucket fills at the target bitrate times a multiplier (pacing faster than
+// the encoder leaves room for bursts without letting a keyframe out at line rate)
+// and holds at most RTP_PACER_MAX_BURST_US of it. A packet goes out while the
+// bucket is above zero and takes its size out, so it may go negative by one
+// packet and the next one waits until it is refilled.
+//
+// Four queues, served in order :
+//
+//   audio            sent at once, charged to the bucket
+//   retransmission   before new video, the receiver is already waiting for it
+//   video
+//   padding          only when the others are empty
+//
+// Packets are not copied, the pointers must stay valid until they are sent (the
+// packet history slots are). When video and retransmissions queue up for more
+// than the maximum queue time at the current rate, the rate is raised to drain
+// them in that time.
+//
+// All times are in microseconds from any monotonic clock.
+//
+//-------------------------------------------------------------------------------------//
+
+#define RTP_PACER_QUEUE_CAPACITY        4096        // packets per priority, power of two
+#define RTP_PACER_DEFAULT_MULTIPLIER    2.5
+#define RTP_PACER_MAX_BURST_US          5000
+#define RTP_PACER_MAX_QUEUE_US          2000000
+#define RTP_PACER_IDLE                  (-1)
+
+enum RtpPacerPriority {
+	kRtpPacerAudio = 0,
+	kRtpPacerRetransmission = 1,
+	kRtpPacerVideo = 2,
+	kRtpPacerPadding = 3,
+	kRtpPacerPriorities = 4,
+};
+
+struct RtpPacedPacket {
+	const uint8_t *data;
+	size_t size;
+	void *user;                     // passed back to the send function
+	int64_t enqueueUs;
+	RtpPacerPriority priority;
+};
+
+typedef void (*RtpPacerSendFn)(void *context, const RtpPacedPacket &packet);
+
+class CRtpPacerScheduler;
+
+class CRtpPacer
+{
+	friend class CRtpPacerScheduler;
+
+public:
+	CRtpPacer(RtpPacerSendFn send, void *context, int queueCapacity = RTP_PACER_QUEUE_CAPACITY);
+	virtual ~CRtpPacer();
+
+	// 0, the default, sends everything at once
+	void SetBitrate(int64_t bitsPerSecond, double multiplier = RTP_PACER_DEFAULT_MULTIPLIER);
+	void SetMaxQueueTime(int64_t us) { maxQueueUs = us; }
+
+	// Queues a packet, false when its queue is full. A pacer on a scheduler is
+	// woken up when the packet can go out earlier than it planned to run.
+	bool Enqueue(RtpPacerPriority priority, const uint8_t *data, size_t size, void *user, int64_t nowUs);
+
+	// Sends what the bucket allows. Returns when it has to run again, RTP_PACER_IDLE
+	// when nothing is queued.
+	int64_t Process(int64_t nowUs);
+
+	// When the first queued packet can go out, RTP_PACER_IDLE when nothing is queued.
+	int64_t NextSendTime(int64_t nowUs);
+
+	int QueuedPackets(RtpPacerPriority priority) const { return queues[priority].count; }
+	size_t QueuedBytes() const { return queuedBytes; }
+	int64_t SentBytes() const { return sentBytes; }
+
+protected:
+	struct Queue {
+		std::vector<RtpPacedPacket> ring;
+		int head;
+		int count;
+	};
+
+	void Refill(int64_t nowUs);
+	int NextPriority() const;
+	int64_t PacingRate() const;
+
+	RtpPacerSendFn send;
+	void *context;
+	int64_t bitrate;                // bits per second after the multiplier
+	int64_t maxQueueUs;
+	int64_t budget;                 // bit-microseconds, a packet costs size * 8 * 10^6
+	int64_t lastUs;
+	bool started;
+	size_t queuedBytes;
+	size_t pacedBytes;              // retransmission and video, for the drain rate
+	int64_t sentBytes;
+	Queue queues[kRtpPacerPriorities];
+
+	// scheduler state, see CRtpPacerScheduler
+	CRtpPacerScheduler *scheduler;
+	CRtpPacer *next;
+	CRtpPacer *prev;
+	int64_t deadline;
+	int wheelSlot;                  // -1 unscheduled, level * RTP_PACER_WHEEL_SLOTS + slot
+};
+
+//-------------------------------------------------------------------------------------//
+//
+// Runs the pacers of many sessions from one thread.
+//
+// A pacer with packets waits in a hashed timer wheel of two levels : 1 us slots
+// for the next RTP_PACER_WHEEL_SLOTS us, and slots of that many us for the next
+// 16 s. A coarse slot moves down to the fine level when the current time enters
+// it, so a deadline is looked at once per level, whatever the number of pacers.
+// A later deadline is brought in to the end of the coarse level, the pacer runs
+// early and schedules itself again. A bitmap of the non-empty slots per level
+// lets Run() and NextDeadline() skip idle time a word at a time instead of a
+// slot at a time, so the thread can sleep until the exact next deadline.
+// Pacers must not be added or removed from within a send function.
+//
+//-------------------------------------------------------------------------------------//
+
+#define RTP_PACER_WHEEL_BITS        12
+#define RTP_PACER_WHEEL_SLOTS       (1 << RTP_PACER_WHEEL_BITS)     // per level
+#define RTP_PACER_WHEEL_LEVELS      2
+#define RTP_PACER_WHEEL_HORIZON     ((int64_t)(RTP_PACER_WHEEL_SLOTS - 1) << RTP_PACER_WHEEL_BITS)
+
+class CRtpPacerScheduler
+{
+public:
+	CRtpPacerScheduler();
+	virtual ~CRtpPacerScheduler();
+
+	void Add(CRtpPacer *pacer, int64_t nowUs);
+	void Remove(CRtpPacer *pacer);
+
+	// Runs every pacer due at nowUs, returns how many ran.
+	int Run(int64_t nowUs);
+
+	// Earliest deadline, RTP_PACER_IDLE when no pacer has packets.
+	int64_t NextDeadline() const;
+
+protected:
+	friend class CRtpPacer;
+
+	void Schedule(CRtpPacer *pacer, int64_t deadline);
+	void Unlink(CRtpPacer *pacer);
+	void Link(int wheelSlot, CRtpPacer *pacer);
+	int NextOccupied(int level, int start, int i, int count) const;
+	int64_t EarliestDeadline(const CRtpPacer *pacer) const;
+
+	bool started;
+	int64_t currentUs;              // every deadline before it has been run
+	CRtpPacer *slots[RTP_PACER_WHEEL_LEVELS][RTP_PACER_WHEEL_SLOTS];
+	uint64_t occupied[RTP_PACER_WHEEL_LEVELS][RTP_PACER_WHEEL_SLOTS / 64];
+	std::vector<CRtpPacer *> due;
+};
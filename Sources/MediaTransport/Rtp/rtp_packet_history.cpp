@@ -0,0 +1,218 @@
+//
+//  rtp_packet_history.cpp
+//
+
+#include <string.h>
+
+#include "rtp_packet_history.h"
+#include "rtcp_nack.h"
+
+#define RTP_VERSION             2
+#define RTP_HEADER_SIZE         12
+#define RTP_PADDING_BIT         0x20
+#define RTP_EXTENSION_BIT       0x10
+#define RTP_CC_MASK             0x0F
+#define RTP_MARKER_BIT          0x80
+
+size_t RtpHeaderSize(const uint8_t *packet, size_t size, size_t *paddingSize)
+{
+	if (size < RTP_HEADER_SIZE || (packet[0] >> 6) != RTP_VERSION)
+		return 0;
+	size_t header = RTP_HEADER_SIZE + (size_t)(packet[0] & RTP_CC_MASK) * 4;
+	if (packet[0] & RTP_EXTENSION_BIT) {
+		if (header + 4 > size)
+			return 0;
+		header += 4 + (size_t)((packet[header + 2] << 8) | packet[header + 3]) * 4;
+	}
+	if (header > size)
+		return 0;
+
+	size_t padding = 0;
+	if (packet[0] & RTP_PADDING_BIT) {
+		padding = packet[size - 1];
+		if (padding == 0 || header + padding > size)
+			return 0;
+	}
+	*paddingSize = padding;
+	return header;
+}
+
+//-------------------------------------------------------------------------------------//
+
+CRtpPacketHistory::CRtpPacketHistory(uint32_t ssrc, int slotCount, size_t maxPacketSize)
+	: ssrc(ssrc), maxPacketSize(maxPacketSize), rtxPayloadType(-1), rtxSsrc(0), rtxSequenceNumber(0), rttMs(0)
+{
+	int n = 1;
+	while (n < slotCount && n < 32768)
+		n <<= 1;
+	mask = n - 1;
+	slots.resize(n);
+	storage.resize((size_t)n * maxPacketSize);
+	nacked.resize(RTP_HISTORY_MAX_RESEND);
+	resends.reserve(RTP_HISTORY_MAX_RESEND);
+	rtxHeaders.resize((size_t)RTP_HISTORY_MAX_RESEND * RTP_RTX_MAX_HEADER);
+	Reset();
+}
+
+CRtpPacketHistory::~CRtpPacketHistory()
+{
+}
+
+void CRtpPacketHistory::Reset()
+{
+	for (Slot &slot : slots)
+		slot.used = false;
+	resends.clear();
+	nackRound = 0;
+	resentPackets = 0;
+	missedPackets = 0;
+}
+
+void CRtpPacketHistory::SetRtx(int payloadType, uint32_t ssrc, uint16_t sequenceNumber)
+{
+	rtxPayloadType = payloadType;
+	rtxSsrc = ssrc;
+	rtxSequenceNumber = sequenceNumber;
+}
+
+CRtpPacketHistory::Slot *CRtpPacketHistory::Find(uint16_t seq)
+{
+	Slot &slot = slots[seq & mask];
+	return slot.used && slot.seq == seq ? &slot : NULL;
+}
+
+const uint8_t *CRtpPacketHistory::Put(const struct iovec *iov, int count, int64_t nowMs)
+{
+	size_t size = 0;
+	for (int i = 0; i < count; i++)
+		size += iov[i].iov_len;
+	if (size < RTP_HEADER_SIZE || size > maxPacketSize || iov[0].iov_len < 4)
+		return NULL;
+
+	const uint8_t *first = (const uint8_t *)iov[0].iov_base;
+	uint16_t seq = (uint16_t)((first[2] << 8) | first[3]);
+	uint8_t *dst = Packet(seq);
+	size_t offset = 0;
+	for (int i = 0; i < count; i++) {
+		memcpy(dst + offset, iov[i].iov_base, iov[i].iov_len);
+		offset += iov[i].iov_len;
+	}
+	return Store(dst, size, nowMs);
+}
+
+const uint8_t *CRtpPacketHistory::Put(const uint8_t *packet, size_t size, int64_t nowMs)
+{
+	if (size < RTP_HEADER_SIZE || size > maxPacketSize)
+		return NULL;
+	uint16_t seq = (uint16_t)((packet[2] << 8) | packet[3]);
+	uint8_t *dst = Packet(seq);
+	if (dst != packet)
+		memmove(dst, packet, size);
+	return Store(dst, size, nowMs);
+}
+
+// packet is already in the slot of its sequence number
+const uint8_t *CRtpPacketHistory::Store(const uint8_t *packet, size_t size, int64_t nowMs)
+{
+	uint16_t seq = (uint16_t)((packet[2] << 8) | packet[3]);
+	Slot &slot = slots[seq & mask];
+	size_t padding;
+	size_t header = RtpHeaderSize(packet, size, &padding);
+
+	// the old packet of this slot is gone either way
+	slot.used = false;
+	if (header == 0 || header + RTP_RTX_OSN_SIZE > RTP_RTX_MAX_HEADER)
+		return NULL;
+	slot.used = true;
+	slot.seq = seq;
+	slot.size = (uint16_t)size;
+	slot.headerSize = (uint16_t)header;
+	slot.paddingSize = (uint16_t)padding;
+	slot.timesResent = 0;
+	slot.nackRound = nackRound;
+	slot.sentMs = nowMs;
+	return packet;
+}
+
+//-------------------------------------------------------------------------------------//
+
+int CRtpPacketHistory::OnNack(const uint8_t *rtcp, size_t size, int64_t nowMs)
+{
+	resends.clear();
+	nackRound++;
+	int count = RtcpParseNack(rtcp, size, ssrc, nacked.data(), (int)nacked.size());
+	for (int i = 0; i < count; i++) {
+		Slot *slot = Find(nacked[i]);
+		if (slot == NULL) {
+			missedPackets++;
+			continue;
+		}
+		// a sequence number the same NACK names twice is sent once, and a resent
+		// packet not again before the NACK could have seen the copy. The first
+		// retransmission is never held back : a NACK that beats the smoothed RTT
+		// by some jitter still reports a loss.
+		if (slot->nackRound == nackRound)
+			continue;
+		if (slot->timesResent > 0 && nowMs - slot->sentMs < rttMs)
+			continue;
+		Resend(*slot, Packet(slot->seq));
+		slot->nackRound = nackRound;
+		slot->timesResent++;
+		slot->sentMs = nowMs;
+		resentPackets++;
+	}
+	return (int)resends.size();
+}
+
+void CRtpPacketHistory::Resend(const Slot &slot, const uint8_t *packet)
+{
+	RtpRetransmission resend;
+	resend.sequenceNumber = slot.seq;
+	if (rtxPayloadType < 0) {
+		resend.header = NULL;
+		resend.headerSize = 0;
+		resend.payload = packet;
+		resend.payloadSize = slot.size;
+		resends.push_back(resend);
+		return;
+	}
+
+	// RFC 4588 4. : same header but for the RTX payload type, sequence number
+	// and SSRC, the padding is not carried over
+	uint8_t *header = &rtxHeaders[resends.size() * RTP_RTX_MAX_HEADER];
+	memcpy(header, packet, slot.headerSize);
+	header[0] &= ~RTP_PADDING_BIT;
+	header[1] = (uint8_t)((packet[1] & RTP_MARKER_BIT) | (rtxPayloadType & 0x7F));
+	header[2] = (uint8_t)(rtxSequenceNumber >> 8);
+	header[3] = (uint8_t)rtxSequenceNumber;
+	header[8] = (uint8_t)(rtxSsrc >> 24);
+	header[9] = (uint8_t)(rtxSsrc >> 16);
+	header[10] = (uint8_t)(rtxSsrc >> 8);
+	header[11] = (uint8_t)rtxSsrc;
+	header[slot.headerSize] = (uint8_t)(slot.seq >> 8);
+	header[slot.headerSize + 1] = (uint8_t)slot.seq;
+	rtxSequenceNumber++;
+
+	resend.header = header;
+	resend.headerSize = (uint16_t)(slot.headerSize + RTP_RTX_OSN_SIZE);
+	resend.payload = packet + slot.headerSize;
+	resend.payloadSize = slot.size - slot.headerSize - slot.paddingSize;
+	resends.push_back(resend);
+}
+
+int CRtpPacketHistory::RetransmissionIov(int index, struct iovec *iov) const
+{
+	const RtpRetransmission &resend = resends[index];
+	int count = 0;
+	if (resend.headerSize > 0) {
+		iov[count].iov_base = (void *)resend.header;
+		iov[count].iov_len = resend.headerSize;
+		count++;
+	}
+	if (resend.payloadSize > 0) {
+		iov[count].iov_base = (void *)resend.payload;
+		iov[count].iov_len = resend.payloadSize;
+		count++;
+	}
+	return count;
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/uio.h>
+#include <vector>
+
+//-------------------------------------------------------------------------------------//
+//
+// Send side packet history for NACK based retransmission.
+//
+// Sent packets go into a ring of slots indexed by sequence number, each slot
+// with room for one serialized packet. Put() gathers the packetizer's iovecs
+// into the slot once and returns it, so the socket sends the stored copy and
+// the history costs no serialization of its own. The slot holds bytes, not the
+// iovecs : those point into packetizer headers that the next frame rewrites and
+// into the encoded frame, which the sender lets go once it is sent, long before
+// a NACK can come back. A slot is reused after 'slots' packets, older packets
+// can no longer be resent.
+//
+// OnNack() takes an RTCP compound packet, and each generic NACK for the media
+// SSRC (RFC 4585) becomes a retransmission. With RTX (RFC 4588) configured the
+// packet goes out on the RTX SSRC and payload type with its own sequence number
+// and the original one (OSN) in front of the payload :
+//
+//   | RTX RTP header, CSRCs, extensions | OSN | -> original payload
+//
+// The rewritten header lives in the history and the payload entry points into
+// the slot, like CH264RtpPacketizer's iovecs. Without RTX the stored packet is
+// resent as it is.
+//
+//-------------------------------------------------------------------------------------//
+
+#define RTP_HISTORY_SLOTS           1024        // power of two
+#define RTP_HISTORY_MAX_PACKET      1500
+#define RTP_HISTORY_MAX_RESEND      256         // retransmissions per NACK packet
+#define RTP_RTX_OSN_SIZE            2
+#define RTP_RTX_MAX_HEADER          256         // RTP header with CSRCs and extensions, plus OSN
+
+struct RtpRetransmission {
+	uint16_t sequenceNumber;        // of the original packet
+	uint16_t headerSize;            // RTX header and OSN, 0 without RTX
+	const uint8_t *header;
+	const uint8_t *payload;         // the stored packet without RTX, its payload with RTX
+	size_t payloadSize;
+};
+
+class CRtpPacketHistory
+{
+public:
+	CRtpPacketHistory(uint32_t ssrc, int slots = RTP_HISTORY_SLOTS, size_t maxPacketSize = RTP_HISTORY_MAX_PACKET);
+	virtual ~CRtpPacketHistory();
+
+	void Reset();
+
+	// RTX payload type (the one whose apt is the media payload type), SSRC and first
+	// sequence number. A negative payload type turns RTX off.
+	void SetRtx(int payloadType, uint32_t ssrc, uint16_t sequenceNumber);
+
+	// A resent packet is not resent again within this time of its last sending,
+	// the NACK could not have seen that copy yet. The first NACK is always served.
+	void SetRtt(int64_t rttMs) { this->rttMs = rttMs; }
+
+	// Stores a serialized RTP packet and returns the stored copy to send, NULL
+	// when it is malformed or larger than maxPacketSize.
+	const uint8_t *Put(const struct iovec *iov, int count, int64_t nowMs);
+	const uint8_t *Put(const uint8_t *packet, size_t size, int64_t nowMs);
+
+	// Handles an RTCP compound packet. Returns the number of retransmissions,
+	// they stay valid with Retransmission() until the next Put() or OnNack().
+	int OnNack(const uint8_t *rtcp, size_t size, int64_t nowMs);
+
+	int RetransmissionCount() const { return (int)resends.size(); }
+	const RtpRetransmission &Retransmission(int index) const { return resends[index]; }
+	size_t RetransmissionSize(int index) const { return resends[index].headerSize + resends[index].payloadSize; }
+	// Writes the one or two iovecs of a retransmission, returns their count.
+	int RetransmissionIov(int index, struct iovec *iov) const;
+
+	int ResentPackets() const { return resentPackets; }
+	// NACKed packets that were no longer (or never) in the history
+	int MissedPackets() const { return missedPackets; }
+
+protected:
+	struct Slot {
+		bool used;
+		uint16_t seq;
+		uint16_t size;
+		uint16_t headerSize;        // RTP header with CSRCs and extensions
+		uint16_t paddingSize;
+		uint16_t timesResent;       // the RTT only holds back a packet already resent
+		uint32_t nackRound;         // last OnNack() that resent it
+		int64_t sentMs;             // last sending, first or resent
+	};
+
+	Slot *Find(uint16_t seq);
+	uint8_t *Packet(uint16_t seq) { return &storage[(size_t)(seq & mask) * maxPacketSize]; }
+	const uint8_t *Store(const uint8_t *packet, size_t size, int64_t nowMs);
+	void Resend(const Slot &slot, const uint8_t *packet);
+
+	uint32_t ssrc;
+	size_t maxPacketSize;
+	int mask;
+	int rtxPayloadType;
+	uint32_t rtxSsrc;
+	uint16_t rtxSequenceNumber;
+	int64_t rttMs;
+	uint32_t nackRound;
+	int resentPackets;
+	int missedPackets;
+
+	std::vector<Slot> slots;
+	std::vector<uint8_t> storage;
+	std::vector<uint16_t> nacked;
+	std::vector<RtpRetransmission> resends;
+	std::vector<uint8_t> rtxHeaders;        // RTP_RTX_MAX_HEADER per retransmission
+};
+
+// Size of the RTP header with CSRCs and extensions, 0 when the packet is malformed.
+// paddingSize receives the padding length when the P bit is set.
+size_t RtpHeaderSize(const uint8_t *packet, size_t size, size_t *paddingSize);
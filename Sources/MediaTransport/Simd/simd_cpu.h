@@ -0,0 +1,56 @@
+//
+//  simd_cpu.h
+//
+//  SIMD availability for the bitstream and packet kernels.
+//  Same scheme as AudioCodecs/Dsp/dsp_cpu.h : kernels are compiled per
+//  instruction set and picked at runtime with libyuv's cpu detection.
+//
+
+#ifndef SIMD_CPU_H
+#define SIMD_CPU_H
+
+#include "libyuv/cpu_id.h"
+
+#if defined(__has_feature)
+#if __has_feature(memory_sanitizer)
+#define SIMD_DISABLE_X86
+#endif
+#endif
+
+#if !defined(SIMD_DISABLE_X86) && defined(__SSE2__) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define SIMD_HAS_SSE2
+#define SIMD_HAS_AVX2
+#include <immintrin.h>
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+// crypto extensions, libyuv does not report them, see SrtpHasAesInstructions()
+#define SIMD_HAS_X86_CRYPTO
+#define SIMD_TARGET_AESNI __attribute__((target("aes,sse4.1")))
+#define SIMD_TARGET_CLMUL __attribute__((target("pclmul,sse4.1")))
+#define SIMD_TARGET_SHANI __attribute__((target("sha,sse4.1")))
+#endif
+
+#if !defined(SIMD_DISABLE_NEON) && (defined(__ARM_NEON__) || defined(__aarch64__))
+#define SIMD_HAS_NEON
+#include <arm_neon.h>
+// the crypto extension only where the compiler targets it, which all arm64
+// Apple targets do
+#if defined(__aarch64__) && (defined(__ARM_FEATURE_CRYPTO) || \
+    (defined(__ARM_FEATURE_AES) && defined(__ARM_FEATURE_SHA2)))
+#define SIMD_HAS_ARM_CRYPTO
+#endif
+#endif
+
+#define SIMD_TEST_CPU(flag) libyuv::TestCpuFlag(libyuv::flag)
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SIMD_CTZ32(x) __builtin_ctz(x)
+#define SIMD_CTZ64(x) __builtin_ctzll(x)
+#define SIMD_LIKELY(x) __builtin_expect(!!(x), 1)
+#define SIMD_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#else
+#define SIMD_LIKELY(x) (x)
+#define SIMD_UNLIKELY(x) (x)
+#endif
+
+#endif
@@ -0,0 +1,560 @@
+//
+//  srtp.cpp
+//
+
+#include <string.h>
+
+#include "srtp.h"
+
+#define RTP_VERSION             2
+#define RTP_HEADER_SIZE         12
+#define RTP_CC_MASK             0x0F
+#define RTP_EXTENSION_BIT       0x10
+#define RTCP_HEADER_SIZE        8       // V P RC PT length SSRC
+
+#define SRTP_LABEL_RTP_ENCRYPTION   0
+#define SRTP_LABEL_RTP_AUTH         1
+#define SRTP_LABEL_RTP_SALT         2
+#define SRTP_LABEL_RTCP_ENCRYPTION  3
+#define SRTP_LABEL_RTCP_AUTH        4
+#define SRTP_LABEL_RTCP_SALT        5
+
+#define SRTP_CM_SALT_SIZE       14
+#define SRTP_GCM_SALT_SIZE      12
+#define SRTP_GCM_TAG_SIZE       16
+#define SRTP_HMAC_KEY_SIZE      20
+#define SRTCP_INDEX_SIZE        4
+#define SRTCP_E_BIT             0x80000000u
+#define SRTCP_INDEX_MASK        0x7FFFFFFFu
+
+static inline uint16_t Read16(const uint8_t *p)
+{
+	return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static inline uint32_t Read32(const uint8_t *p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline void Write32(uint8_t *p, uint32_t v)
+{
+	p[0] = (uint8_t)(v >> 24);
+	p[1] = (uint8_t)(v >> 16);
+	p[2] = (uint8_t)(v >> 8);
+	p[3] = (uint8_t)v;
+}
+
+// The P bit is left alone, the padding is inside the encrypted payload.
+static size_t SrtpRtpHeaderSize(const uint8_t *packet, size_t size)
+{
+	if (size < RTP_HEADER_SIZE || (packet[0] >> 6) != RTP_VERSION)
+		return 0;
+	size_t header = RTP_HEADER_SIZE + (size_t)(packet[0] & RTP_CC_MASK) * 4;
+	if (packet[0] & RTP_EXTENSION_BIT) {
+		if (header + 4 > size)
+			return 0;
+		header += 4 + (size_t)Read16(packet + header + 2) * 4;
+	}
+	return header <= size ? header : 0;
+}
+
+static bool SrtpTagEqual(const uint8_t *a, const uint8_t *b, size_t size)
+{
+	uint8_t diff = 0;
+	for (size_t i = 0; i < size; i++)
+		diff |= a[i] ^ b[i];
+	return diff == 0;
+}
+
+int SrtpMasterKeyLength(SrtpProfile profile)
+{
+	switch (profile) {
+	case kSrtpAes128CmHmacSha1_80:
+	case kSrtpAes128CmHmacSha1_32:
+	case kSrtpAeadAes128Gcm:
+		return 16;
+	case kSrtpAeadAes256Gcm:
+		return 32;
+	}
+	return 0;
+}
+
+int SrtpMasterSaltLength(SrtpProfile profile)
+{
+	switch (profile) {
+	case kSrtpAes128CmHmacSha1_80:
+	case kSrtpAes128CmHmacSha1_32:
+		return SRTP_CM_SALT_SIZE;
+	case kSrtpAeadAes128Gcm:
+	case kSrtpAeadAes256Gcm:
+		return SRTP_GCM_SALT_SIZE;
+	}
+	return 0;
+}
+
+void SrtpDeriveKey(const uint8_t *masterKey, int keyLength, const uint8_t *masterSalt, int saltLength,
+                   uint8_t label, uint8_t *out, size_t size)
+{
+	// x = (label || r) ^ master salt with r = 0, the counter in the low 16 bits
+	uint8_t iv[SRTP_AES_BLOCK_SIZE] = { 0 };
+	memcpy(iv, masterSalt, saltLength);
+	iv[7] ^= label;
+
+	CSrtpAes prf;
+	prf.SetKey(masterKey, keyLength);
+	for (size_t offset = 0, j = 0; offset < size; offset += SRTP_AES_BLOCK_SIZE, j++) {
+		uint8_t block[SRTP_AES_BLOCK_SIZE];
+		iv[14] = (uint8_t)(j >> 8);
+		iv[15] = (uint8_t)j;
+		prf.EncryptBlocks(iv, block, 1);
+		memcpy(out + offset, block, size - offset < SRTP_AES_BLOCK_SIZE ? size - offset : SRTP_AES_BLOCK_SIZE);
+		memset(block, 0, sizeof(block));
+	}
+}
+
+//-------------------------------------------------------------------------------------//
+
+CSrtpSession::CSrtpSession(SrtpProfile profile, const uint8_t *masterKey, const uint8_t *masterSalt, int maxStreams)
+	: profile(profile)
+{
+	int keyLength = SrtpMasterKeyLength(profile);
+	int masterSaltLength = SrtpMasterSaltLength(profile);
+	gcm = profile == kSrtpAeadAes128Gcm || profile == kSrtpAeadAes256Gcm;
+	tagLength = gcm ? SRTP_GCM_TAG_SIZE : profile == kSrtpAes128CmHmacSha1_32 ? 4 : 10;
+	rtcpTagLength = gcm ? SRTP_GCM_TAG_SIZE : 10;
+	saltLength = gcm ? SRTP_GCM_SALT_SIZE : SRTP_CM_SALT_SIZE;
+
+	uint8_t key[32];
+	SrtpDeriveKey(masterKey, keyLength, masterSalt, masterSaltLength, SRTP_LABEL_RTP_ENCRYPTION, key, keyLength);
+	rtpCipher.SetKey(key, keyLength);
+	SrtpDeriveKey(masterKey, keyLength, masterSalt, masterSaltLength, SRTP_LABEL_RTCP_ENCRYPTION, key, keyLength);
+	rtcpCipher.SetKey(key, keyLength);
+
+	memset(rtpSalt, 0, sizeof(rtpSalt));
+	memset(rtcpSalt, 0, sizeof(rtcpSalt));
+	SrtpDeriveKey(masterKey, keyLength, masterSalt, masterSaltLength, SRTP_LABEL_RTP_SALT, rtpSalt, saltLength);
+	SrtpDeriveKey(masterKey, keyLength, masterSalt, masterSaltLength, SRTP_LABEL_RTCP_SALT, rtcpSalt, saltLength);
+
+	if (gcm) {
+		// H = E(K, 0^128)
+		uint8_t zero[SRTP_AES_BLOCK_SIZE] = { 0 };
+		rtpCipher.EncryptBlocks(zero, key, 1);
+		rtpGhash.SetKey(key);
+		rtcpCipher.EncryptBlocks(zero, key, 1);
+		rtcpGhash.SetKey(key);
+	}
+	else {
+		SrtpDeriveKey(masterKey, keyLength, masterSalt, masterSaltLength, SRTP_LABEL_RTP_AUTH, key, SRTP_HMAC_KEY_SIZE);
+		rtpAuth.SetKey(key, SRTP_HMAC_KEY_SIZE);
+		SrtpDeriveKey(masterKey, keyLength, masterSalt, masterSaltLength, SRTP_LABEL_RTCP_AUTH, key, SRTP_HMAC_KEY_SIZE);
+		rtcpAuth.SetKey(key, SRTP_HMAC_KEY_SIZE);
+	}
+	memset(key, 0, sizeof(key));
+
+	xorFn = RtpFecSelectXor();
+	streams.resize(maxStreams > 0 ? maxStreams : 1);
+	memset(streams.data(), 0, streams.size() * sizeof(Stream));
+	jobs.reserve(SRTP_BATCH_MAX);
+	counters.reserve(SRTP_BATCH_MAX * 1536);
+}
+
+CSrtpSession::~CSrtpSession()
+{
+	memset(rtpSalt, 0, sizeof(rtpSalt));
+	memset(rtcpSalt, 0, sizeof(rtcpSalt));
+}
+
+CSrtpSession::Stream *CSrtpSession::FindStream(uint32_t ssrc, bool create)
+{
+	Stream *unused = NULL;
+	for (size_t i = 0; i < streams.size(); i++) {
+		if (streams[i].used) {
+			if (streams[i].ssrc == ssrc)
+				return &streams[i];
+		}
+		else if (unused == NULL)
+			unused = &streams[i];
+	}
+	if (!create || unused == NULL)
+		return NULL;
+	memset(unused, 0, sizeof(*unused));
+	unused->used = true;
+	unused->ssrc = ssrc;
+	return unused;
+}
+
+bool CSrtpSession::RemoveStream(uint32_t ssrc)
+{
+	Stream *stream = FindStream(ssrc, false);
+	if (stream == NULL)
+		return false;
+	memset(stream, 0, sizeof(*stream));
+	return true;
+}
+
+int CSrtpSession::StreamCount() const
+{
+	int count = 0;
+	for (const Stream &stream : streams)
+		count += stream.used;
+	return count;
+}
+
+// RFC 3711 3.3.1 : the ROC of the index closest to the highest one seen
+uint32_t CSrtpSession::EstimateRoc(const Stream &stream, uint16_t seq)
+{
+	if (!stream.started)
+		return 0;
+	if (stream.seq < 32768) {
+		if (seq - stream.seq > 32768 && stream.roc > 0)
+			return stream.roc - 1;
+	}
+	else if (stream.seq - 32768 > seq)
+		return stream.roc + 1;
+	return stream.roc;
+}
+
+int CSrtpSession::CheckReplay(uint64_t highest, uint64_t window, uint64_t index, bool started)
+{
+	if (!started || index > highest)
+		return kSrtpOk;
+	uint64_t delta = highest - index;
+	if (delta >= SRTP_REPLAY_WINDOW || ((window >> delta) & 1))
+		return kSrtpErrorReplay;
+	return kSrtpOk;
+}
+
+uint64_t CSrtpSession::UpdateReplay(uint64_t highest, uint64_t window, uint64_t index, bool started)
+{
+	if (!started)
+		return 1;
+	if (index > highest) {
+		uint64_t shift = index - highest;
+		return shift >= SRTP_REPLAY_WINDOW ? 1 : (window << shift) | 1;
+	}
+	return window | ((uint64_t)1 << (highest - index));
+}
+
+void CSrtpSession::WriteIv(uint8_t *iv, const uint8_t *salt, uint32_t ssrc, uint64_t index) const
+{
+	if (gcm) {
+		// RFC 7714 8.1 / 9.1 : 00 00 | SSRC | ROC SEQ or 00 00 index, ^ salt, then J0 = IV || 1
+		memset(iv, 0, SRTP_AES_BLOCK_SIZE);
+		Write32(iv + 2, ssrc);
+		Write32(iv + 6, (uint32_t)(index >> 16));
+		iv[10] = (uint8_t)(index >> 8);
+		iv[11] = (uint8_t)index;
+		for (int i = 0; i < SRTP_GCM_SALT_SIZE; i++)
+			iv[i] ^= salt[i];
+		iv[15] = 1;
+	}
+	else {
+		// RFC 3711 4.1.1 : (salt << 16) ^ (SSRC << 64) ^ (index << 16)
+		memcpy(iv, salt, SRTP_CM_SALT_SIZE);
+		iv[14] = iv[15] = 0;
+		for (int i = 0; i < 4; i++)
+			iv[4 + i] ^= (uint8_t)(ssrc >> (24 - 8 * i));
+		for (int i = 0; i < 6; i++)
+			iv[8 + i] ^= (uint8_t)(index >> (40 - 8 * i));
+	}
+}
+
+size_t CSrtpSession::AddCounters(const uint8_t *iv, size_t blocks)
+{
+	size_t first = counters.size() / SRTP_AES_BLOCK_SIZE;
+	counters.resize(counters.size() + blocks * SRTP_AES_BLOCK_SIZE);
+	uint8_t *block = counters.data() + first * SRTP_AES_BLOCK_SIZE;
+	uint32_t counter = Read32(iv + 12);
+	for (size_t j = 0; j < blocks; j++, block += SRTP_AES_BLOCK_SIZE) {
+		memcpy(block, iv, 12);
+		Write32(block + 12, counter + (uint32_t)j);
+	}
+	return first;
+}
+
+void CSrtpSession::GcmTag(CSrtpGhash &ghash, const uint8_t *aad, size_t aadSize, const uint8_t *text, size_t textSize,
+                          const uint8_t *mask, uint8_t *tag)
+{
+	ghash.Reset();
+	ghash.Update(aad, aadSize);
+	ghash.Update(text, textSize);
+	ghash.Final(aadSize, textSize, tag);
+	for (int i = 0; i < SRTP_GCM_TAG_SIZE; i++)
+		tag[i] ^= mask[i];
+}
+
+//-------------------------------------------------------------------------------------//
+// SRTP
+
+void CSrtpSession::AddJob(uint8_t *packet, size_t size, size_t capacity, bool protect, int *result)
+{
+	size_t header = SrtpRtpHeaderSize(packet, size);
+	if (header == 0 || (!protect && header + tagLength > size)) {
+		*result = kSrtpErrorMalformed;
+		return;
+	}
+	if (protect && size + tagLength > capacity) {
+		*result = kSrtpErrorNoSpace;
+		return;
+	}
+
+	Job job;
+	job.packet = packet;
+	job.size = protect ? size : size - tagLength;
+	job.header = header;
+	job.ssrc = Read32(packet + 8);
+	job.seq = Read16(packet + 2);
+	job.result = result;
+
+	// streams are only created once a packet is through, a forged SSRC takes no slot
+	const Stream *stream = FindStream(job.ssrc, false);
+	job.roc = stream ? EstimateRoc(*stream, job.seq) : 0;
+	uint64_t index = ((uint64_t)job.roc << 16) | job.seq;
+
+	if (!protect) {
+		if (stream && CheckReplay(((uint64_t)stream->roc << 16) | stream->seq, stream->replay, index, stream->started)) {
+			*result = kSrtpErrorReplay;
+			return;
+		}
+		if (!gcm) {
+			// authenticate before any decryption, over the packet and the ROC
+			uint8_t roc[4], mac[SRTP_SHA1_DIGEST_SIZE];
+			Write32(roc, job.roc);
+			rtpAuth.Mac(packet, job.size, roc, sizeof(roc), mac);
+			if (!SrtpTagEqual(mac, packet + job.size, tagLength)) {
+				*result = kSrtpErrorAuth;
+				return;
+			}
+		}
+	}
+
+	uint8_t iv[SRTP_AES_BLOCK_SIZE];
+	WriteIv(iv, rtpSalt, job.ssrc, index);
+	job.blocks = (job.size - header + SRTP_AES_BLOCK_SIZE - 1) / SRTP_AES_BLOCK_SIZE + (gcm ? 1 : 0);
+	job.firstBlock = AddCounters(iv, job.blocks);
+	jobs.push_back(job);
+}
+
+void CSrtpSession::RunJobs(bool protect)
+{
+	rtpCipher.EncryptBlocks(counters.data(), counters.data(), counters.size() / SRTP_AES_BLOCK_SIZE);
+
+	for (size_t n = 0; n < jobs.size(); n++) {
+		Job &job = jobs[n];
+		uint8_t *payload = job.packet + job.header;
+		size_t payloadSize = job.size - job.header;
+		const uint8_t *keystream = counters.data() + job.firstBlock * SRTP_AES_BLOCK_SIZE;
+		uint64_t index = ((uint64_t)job.roc << 16) | job.seq;
+
+		if (!protect && gcm) {
+			uint8_t tag[SRTP_GCM_TAG_SIZE];
+			GcmTag(rtpGhash, job.packet, job.header, payload, payloadSize, keystream, tag);
+			if (!SrtpTagEqual(tag, job.packet + job.size, SRTP_GCM_TAG_SIZE)) {
+				*job.result = kSrtpErrorAuth;
+				continue;
+			}
+		}
+
+		Stream *stream = FindStream(job.ssrc, true);
+		if (stream == NULL) {
+			*job.result = kSrtpErrorStreams;
+			continue;
+		}
+		uint64_t highest = ((uint64_t)stream->roc << 16) | stream->seq;
+		// a duplicate inside the burst gets past the first check
+		if (!protect && CheckReplay(highest, stream->replay, index, stream->started)) {
+			*job.result = kSrtpErrorReplay;
+			continue;
+		}
+
+		xorFn(payload, gcm ? keystream + SRTP_AES_BLOCK_SIZE : keystream, payloadSize);
+
+		if (protect) {
+			if (gcm)
+				GcmTag(rtpGhash, job.packet, job.header, payload, payloadSize, keystream, job.packet + job.size);
+			else {
+				uint8_t roc[4], mac[SRTP_SHA1_DIGEST_SIZE];
+				Write32(roc, job.roc);
+				rtpAuth.Mac(job.packet, job.size, roc, sizeof(roc), mac);
+				memcpy(job.packet + job.size, mac, tagLength);
+			}
+		}
+
+		stream->replay = UpdateReplay(highest, stream->replay, index, stream->started);
+		if (!stream->started || index > highest) {
+			stream->roc = job.roc;
+			stream->seq = job.seq;
+		}
+		stream->started = true;
+		*job.result = protect ? (int)(job.size + tagLength) : (int)job.size;
+	}
+}
+
+int CSrtpSession::ProtectRtp(struct iovec *packets, int count, size_t capacity, int *results)
+{
+	int done = 0;
+	for (int first = 0; first < count; first += SRTP_BATCH_MAX) {
+		int last = count - first > SRTP_BATCH_MAX ? first + SRTP_BATCH_MAX : count;
+		jobs.clear();
+		counters.clear();
+		for (int i = first; i < last; i++)
+			AddJob((uint8_t *)packets[i].iov_base, packets[i].iov_len, capacity, true, &results[i]);
+		RunJobs(true);
+		for (size_t n = 0; n < jobs.size(); n++) {
+			int i = (int)(jobs[n].result - results);
+			if (results[i] >= 0) {
+				packets[i].iov_len = results[i];
+				results[i] = kSrtpOk;
+				done++;
+			}
+		}
+	}
+	return done;
+}
+
+int CSrtpSession::UnprotectRtp(struct iovec *packets, int count, int *results)
+{
+	int done = 0;
+	for (int first = 0; first < count; first += SRTP_BATCH_MAX) {
+		int last = count - first > SRTP_BATCH_MAX ? first + SRTP_BATCH_MAX : count;
+		jobs.clear();
+		counters.clear();
+		for (int i = first; i < last; i++)
+			AddJob((uint8_t *)packets[i].iov_base, packets[i].iov_len, 0, false, &results[i]);
+		RunJobs(false);
+		for (size_t n = 0; n < jobs.size(); n++) {
+			int i = (int)(jobs[n].result - results);
+			if (results[i] >= 0) {
+				packets[i].iov_len = results[i];
+				results[i] = kSrtpOk;
+				done++;
+			}
+		}
+	}
+	return done;
+}
+
+int CSrtpSession::ProtectRtp(uint8_t *packet, size_t size, size_t capacity)
+{
+	struct iovec iov = { packet, size };
+	int result;
+	return ProtectRtp(&iov, 1, capacity, &result) ? (int)iov.iov_len : result;
+}
+
+int CSrtpSession::UnprotectRtp(uint8_t *packet, size_t size)
+{
+	struct iovec iov = { packet, size };
+	int result;
+	return UnprotectRtp(&iov, 1, &result) ? (int)iov.iov_len : result;
+}
+
+//-------------------------------------------------------------------------------------//
+// SRTCP, packet | E index | tag for AES-CM and packet | tag | E index for GCM
+
+int CSrtpSession::CryptRtcp(uint8_t *packet, size_t size, size_t capacity, bool protect)
+{
+	size_t trailer = SRTCP_INDEX_SIZE + rtcpTagLength;
+	if (size < RTCP_HEADER_SIZE || (packet[0] >> 6) != RTP_VERSION || (!protect && size < RTCP_HEADER_SIZE + trailer))
+		return kSrtpErrorMalformed;
+	if (protect && size + trailer > capacity)
+		return kSrtpErrorNoSpace;
+
+	uint32_t ssrc = Read32(packet + 4);
+	size_t textSize = protect ? size : size - trailer;
+	uint8_t *tag = gcm ? packet + textSize : packet + textSize + SRTCP_INDEX_SIZE;
+	uint8_t *eIndex = gcm ? packet + textSize + rtcpTagLength : packet + textSize;
+	Stream *stream;
+	uint32_t word;
+
+	if (protect) {
+		stream = FindStream(ssrc, true);
+		if (stream == NULL)
+			return kSrtpErrorStreams;
+		word = SRTCP_E_BIT | stream->rtcpIndex;
+	}
+	else {
+		stream = FindStream(ssrc, false);
+		word = Read32(eIndex);
+		if (stream && CheckReplay(stream->rtcpIndex, stream->rtcpReplay, word & SRTCP_INDEX_MASK, stream->rtcpStarted))
+			return kSrtpErrorReplay;
+		if (!gcm) {
+			uint8_t mac[SRTP_SHA1_DIGEST_SIZE];
+			rtcpAuth.Mac(packet, textSize + SRTCP_INDEX_SIZE, packet, 0, mac);
+			if (!SrtpTagEqual(mac, tag, rtcpTagLength))
+				return kSrtpErrorAuth;
+		}
+	}
+	uint32_t index = word & SRTCP_INDEX_MASK;
+	bool encrypted = (word & SRTCP_E_BIT) != 0;
+
+	uint8_t iv[SRTP_AES_BLOCK_SIZE];
+	WriteIv(iv, rtcpSalt, ssrc, index);
+	counters.clear();
+	size_t blocks = (textSize - RTCP_HEADER_SIZE + SRTP_AES_BLOCK_SIZE - 1) / SRTP_AES_BLOCK_SIZE + (gcm ? 1 : 0);
+	AddCounters(iv, blocks);
+	rtcpCipher.EncryptBlocks(counters.data(), counters.data(), blocks);
+	const uint8_t *mask = counters.data();
+	const uint8_t *keystream = gcm ? mask + SRTP_AES_BLOCK_SIZE : mask;
+
+	uint8_t *text = packet + RTCP_HEADER_SIZE;
+	size_t payloadSize = textSize - RTCP_HEADER_SIZE;
+	if (gcm && !protect) {
+		uint8_t expected[SRTP_GCM_TAG_SIZE];
+		if (encrypted) {
+			uint8_t header[RTCP_HEADER_SIZE + SRTCP_INDEX_SIZE];
+			memcpy(header, packet, RTCP_HEADER_SIZE);
+			Write32(header + RTCP_HEADER_SIZE, word);
+			GcmTag(rtcpGhash, header, sizeof(header), text, payloadSize, mask, expected);
+		}
+		else {
+			// RFC 7714 9.2 : without encryption the whole packet is AAD
+			aad.assign(packet, packet + textSize);
+			aad.insert(aad.end(), eIndex, eIndex + SRTCP_INDEX_SIZE);
+			GcmTag(rtcpGhash, &aad[0], aad.size(), text, 0, mask, expected);
+		}
+		if (!SrtpTagEqual(expected, tag, SRTP_GCM_TAG_SIZE))
+			return kSrtpErrorAuth;
+	}
+
+	if (!protect) {
+		stream = FindStream(ssrc, true);
+		if (stream == NULL)
+			return kSrtpErrorStreams;
+	}
+	if (encrypted)
+		xorFn(text, keystream, payloadSize);
+
+	if (protect) {
+		Write32(eIndex, word);
+		if (gcm) {
+			uint8_t header[RTCP_HEADER_SIZE + SRTCP_INDEX_SIZE];
+			memcpy(header, packet, RTCP_HEADER_SIZE);
+			Write32(header + RTCP_HEADER_SIZE, word);
+			GcmTag(rtcpGhash, header, sizeof(header), text, payloadSize, mask, tag);
+		}
+		else {
+			uint8_t mac[SRTP_SHA1_DIGEST_SIZE];
+			rtcpAuth.Mac(packet, textSize + SRTCP_INDEX_SIZE, packet, 0, mac);
+			memcpy(tag, mac, rtcpTagLength);
+		}
+		stream->rtcpIndex = (index + 1) & SRTCP_INDEX_MASK;
+		return (int)(size + trailer);
+	}
+
+	stream->rtcpReplay = UpdateReplay(stream->rtcpIndex, stream->rtcpReplay, index, stream->rtcpStarted);
+	if (!stream->rtcpStarted || index > stream->rtcpIndex)
+		stream->rtcpIndex = index;
+	stream->rtcpStarted = true;
+	return (int)textSize;
+}
+
+int CSrtpSession::ProtectRtcp(uint8_t *packet, size_t size, size_t capacity)
+{
+	return CryptRtcp(packet, size, capacity, true);
+}
+
+int CSrtpSession::UnprotectRtcp(uint8_t *packet, size_t size)
+{
+	return CryptRtcp(packet, size, 0, false);
+}
@@ -0,0 +1,147 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/uio.h>
+#include <vector>
+
+#include "srtp_crypto.h"
+#include "../Rtp/rtp_fec_xor.h"
+
+//-------------------------------------------------------------------------------------//
+//
+// SRTP and SRTCP (RFC 3711) with AES-CM + HMAC-SHA1 and AEAD AES-GCM (RFC 7714),
+// the DTLS-SRTP profiles of RFC 5764 and RFC 7714.
+//
+// Packets are protected and unprotected in place, the buffer needs room for the
+// trailer (tag, and index for SRTCP) when protecting. The session keys are
+// derived once from the master key and salt (key derivation rate 0), and each
+// SSRC keeps its rollover counter and a 64 packet replay window.
+//
+// The keystream of a packet is laid out as counter blocks and encrypted in one
+// call before it is XORed over the payload. The batch calls do the same for all
+// the packets of a recvmmsg / sendmmsg burst, so the AES pipeline runs over the
+// burst as a whole :
+//
+//   1. parse, estimate the index, check replay, verify the HMAC (unprotect)
+//   2. one AES pass over the counter blocks of every packet
+//   3. verify the GCM tag (unprotect), XOR, write the tag (protect)
+//
+// A session serves one direction of one DTLS-SRTP association.
+//
+//-------------------------------------------------------------------------------------//
+
+#define SRTP_MAX_STREAMS            32              // default size of the stream table
+#define SRTP_REPLAY_WINDOW          64
+#define SRTP_MAX_TRAILER            (16 + 4)        // GCM tag and SRTCP index
+#define SRTP_BATCH_MAX              64
+
+// DTLS-SRTP protection profile numbers
+enum SrtpProfile {
+	kSrtpAes128CmHmacSha1_80 = 0x0001,
+	kSrtpAes128CmHmacSha1_32 = 0x0002,
+	kSrtpAeadAes128Gcm = 0x0007,
+	kSrtpAeadAes256Gcm = 0x0008,
+};
+
+enum SrtpError {
+	kSrtpOk = 0,
+	kSrtpErrorMalformed = -1,
+	kSrtpErrorNoSpace = -2,         // capacity leaves no room for the trailer
+	kSrtpErrorAuth = -3,
+	kSrtpErrorReplay = -4,
+	kSrtpErrorStreams = -5,         // more SSRCs than the stream table holds
+};
+
+// master key and salt lengths of a profile, 0 for an unknown one
+int SrtpMasterKeyLength(SrtpProfile profile);
+int SrtpMasterSaltLength(SrtpProfile profile);
+
+// RFC 3711 4.3.3 AES-CM PRF : session key 'label' from the master key and salt
+// (a 12 byte GCM salt is zero padded to 14 bytes, as libsrtp does).
+void SrtpDeriveKey(const uint8_t *masterKey, int keyLength, const uint8_t *masterSalt, int saltLength,
+                   uint8_t label, uint8_t *out, size_t size);
+
+class CSrtpSession
+{
+public:
+	CSrtpSession(SrtpProfile profile, const uint8_t *masterKey, const uint8_t *masterSalt, int maxStreams = SRTP_MAX_STREAMS);
+	virtual ~CSrtpSession();
+
+	// Frees the slot of an SSRC that left (RTCP BYE, a renegotiated sender), false
+	// when it has none. The SSRC starts over at ROC 0 with an empty replay window
+	// if it shows up again.
+	bool RemoveStream(uint32_t ssrc);
+	int StreamCount() const;
+
+	// Single packets, return the new size or an SrtpError.
+	int ProtectRtp(uint8_t *packet, size_t size, size_t capacity);
+	int UnprotectRtp(uint8_t *packet, size_t size);
+	int ProtectRtcp(uint8_t *packet, size_t size, size_t capacity);
+	int UnprotectRtcp(uint8_t *packet, size_t size);
+
+	// Bursts : iov_len is the packet size in and out, results[i] is kSrtpOk or
+	// an SrtpError for packet i, which is then left as it was. Returns the number
+	// of packets done.
+	int ProtectRtp(struct iovec *packets, int count, size_t capacity, int *results);
+	int UnprotectRtp(struct iovec *packets, int count, int *results);
+
+protected:
+	struct Stream {
+		bool used;
+		bool started;               // seq and roc hold a packet
+		uint32_t ssrc;
+		uint32_t roc;
+		uint16_t seq;
+		uint64_t replay;            // bit i : index highest - i was received
+		bool rtcpStarted;
+		uint32_t rtcpIndex;         // next one to send, highest received
+		uint64_t rtcpReplay;
+	};
+
+	struct Job {
+		uint8_t *packet;
+		size_t size;                // without the trailer
+		size_t header;
+		uint32_t ssrc;
+		uint32_t roc;               // estimated
+		uint16_t seq;
+		size_t firstBlock;          // in counters
+		size_t blocks;
+		int *result;
+	};
+
+	Stream *FindStream(uint32_t ssrc, bool create);
+	static uint32_t EstimateRoc(const Stream &stream, uint16_t seq);
+	static int CheckReplay(uint64_t highest, uint64_t window, uint64_t index, bool started);
+	static uint64_t UpdateReplay(uint64_t highest, uint64_t window, uint64_t index, bool started);
+
+	void AddJob(uint8_t *packet, size_t size, size_t capacity, bool protect, int *result);
+	void RunJobs(bool protect);
+	int CryptRtcp(uint8_t *packet, size_t size, size_t capacity, bool protect);
+	// the first IV block of a packet, the keystream blocks count up its low 32 bits
+	void WriteIv(uint8_t *iv, const uint8_t *salt, uint32_t ssrc, uint64_t index) const;
+	size_t AddCounters(const uint8_t *iv, size_t blocks);
+	static void GcmTag(CSrtpGhash &ghash, const uint8_t *aad, size_t aadSize, const uint8_t *text, size_t textSize,
+	                   const uint8_t *mask, uint8_t *tag);
+
+	SrtpProfile profile;
+	bool gcm;
+	int tagLength;                  // SRTP
+	int rtcpTagLength;              // SRTCP, 80 bits for both CM profiles
+	int saltLength;
+
+	CSrtpAes rtpCipher;
+	CSrtpAes rtcpCipher;
+	CSrtpHmacSha1 rtpAuth;
+	CSrtpHmacSha1 rtcpAuth;
+	CSrtpGhash rtpGhash;
+	CSrtpGhash rtcpGhash;
+	uint8_t rtpSalt[14];
+	uint8_t rtcpSalt[14];
+	RtpFecXorFn xorFn;
+
+	std::vector<Stream> streams;
+	std::vector<Job> jobs;
+	std::vector<uint8_t> counters;  // counter blocks, then the keystream in place
+	std::vector<uint8_t> aad;       // SRTCP GCM without encryption
+};
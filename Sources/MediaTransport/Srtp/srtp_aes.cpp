@@ -0,0 +1,277 @@
+//
+//  srtp_aes.cpp
+//
+
+#include <string.h>
+
+#include "srtp_crypto.h"
+#include "../Simd/simd_cpu.h"
+
+#if defined(SIMD_HAS_X86_CRYPTO)
+#include <cpuid.h>
+#endif
+
+//-------------------------------------------------------------------------------------//
+// cpu features, off with the SSE4.1 (or NEON) flag of libyuv so MaskCpuFlags()
+// also selects the reference kernels here
+
+#if defined(SIMD_HAS_X86_CRYPTO)
+static bool CpuIdBit(unsigned leaf, int reg, int bit)
+{
+	unsigned regs[4] = { 0, 0, 0, 0 };
+	if (!__get_cpuid_count(leaf, 0, &regs[0], &regs[1], &regs[2], &regs[3]))
+		return false;
+	return (regs[reg] >> bit) & 1;
+}
+#endif
+
+bool SrtpHasAesInstructions()
+{
+#if defined(SIMD_HAS_X86_CRYPTO)
+	return SIMD_TEST_CPU(kCpuHasSSE41) && CpuIdBit(1, 2, 25);      // ecx.AES
+#elif defined(SIMD_HAS_ARM_CRYPTO)
+	return SIMD_TEST_CPU(kCpuHasNEON);
+#else
+	return false;
+#endif
+}
+
+bool SrtpHasClmulInstructions()
+{
+#if defined(SIMD_HAS_X86_CRYPTO)
+	return SIMD_TEST_CPU(kCpuHasSSE41) && CpuIdBit(1, 2, 1);       // ecx.PCLMULQDQ
+#elif defined(SIMD_HAS_ARM_CRYPTO)
+	return SIMD_TEST_CPU(kCpuHasNEON);
+#else
+	return false;
+#endif
+}
+
+bool SrtpHasSha1Instructions()
+{
+#if defined(SIMD_HAS_X86_CRYPTO)
+	return SIMD_TEST_CPU(kCpuHasSSE41) && CpuIdBit(7, 1, 29);      // ebx.SHA
+#elif defined(SIMD_HAS_ARM_CRYPTO)
+	return SIMD_TEST_CPU(kCpuHasNEON);
+#else
+	return false;
+#endif
+}
+
+//-------------------------------------------------------------------------------------//
+// reference : S-box and one T-table built at first use, the other three
+// tables are rotations of it
+
+struct AesTables {
+	uint8_t sbox[256];
+	uint32_t te[256];
+
+	AesTables()
+	{
+		// S(x) = affine(x^-1), the inverse walks the powers of the generator 3
+		uint8_t p = 1, q = 1;
+		do {
+			p = (uint8_t)(p ^ (p << 1) ^ (p & 0x80 ? 0x1B : 0));
+			q ^= q << 1;
+			q ^= q << 2;
+			q ^= q << 4;
+			if (q & 0x80)
+				q ^= 0x09;
+			uint8_t x = (uint8_t)(q ^ Rotl8(q, 1) ^ Rotl8(q, 2) ^ Rotl8(q, 3) ^ Rotl8(q, 4));
+			sbox[p] = x ^ 0x63;
+		} while (p != 1);
+		sbox[0] = 0x63;
+
+		for (int i = 0; i < 256; i++) {
+			uint32_t s = sbox[i];
+			uint32_t s2 = Xtime((uint8_t)s);
+			te[i] = (s2 << 24) | (s << 16) | (s << 8) | (s2 ^ s);
+		}
+	}
+
+	static uint8_t Rotl8(uint8_t x, int n) { return (uint8_t)((x << n) | (x >> (8 - n))); }
+	static uint8_t Xtime(uint8_t x) { return (uint8_t)((x << 1) ^ (x & 0x80 ? 0x1B : 0)); }
+};
+
+static const AesTables &Tables()
+{
+	static const AesTables tables;
+	return tables;
+}
+
+static inline uint32_t Ror32(uint32_t x, int n)
+{
+	return (x >> n) | (x << (32 - n));
+}
+
+static inline uint32_t Load32(const uint8_t *p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline void Store32(uint8_t *p, uint32_t v)
+{
+	p[0] = (uint8_t)(v >> 24);
+	p[1] = (uint8_t)(v >> 16);
+	p[2] = (uint8_t)(v >> 8);
+	p[3] = (uint8_t)v;
+}
+
+static void SrtpAesBlocks_C(const uint8_t *roundKeys, int rounds, const uint8_t *in, uint8_t *out, size_t blocks)
+{
+	const AesTables &t = Tables();
+	const uint32_t *te = t.te;
+
+	for (size_t b = 0; b < blocks; b++, in += 16, out += 16) {
+		const uint8_t *rk = roundKeys;
+		uint32_t s0 = Load32(in) ^ Load32(rk);
+		uint32_t s1 = Load32(in + 4) ^ Load32(rk + 4);
+		uint32_t s2 = Load32(in + 8) ^ Load32(rk + 8);
+		uint32_t s3 = Load32(in + 12) ^ Load32(rk + 12);
+
+		for (int r = 1; r < rounds; r++) {
+			rk += 16;
+			uint32_t t0 = te[s0 >> 24] ^ Ror32(te[(s1 >> 16) & 0xFF], 8) ^ Ror32(te[(s2 >> 8) & 0xFF], 16) ^ Ror32(te[s3 & 0xFF], 24);
+			uint32_t t1 = te[s1 >> 24] ^ Ror32(te[(s2 >> 16) & 0xFF], 8) ^ Ror32(te[(s3 >> 8) & 0xFF], 16) ^ Ror32(te[s0 & 0xFF], 24);
+			uint32_t t2 = te[s2 >> 24] ^ Ror32(te[(s3 >> 16) & 0xFF], 8) ^ Ror32(te[(s0 >> 8) & 0xFF], 16) ^ Ror32(te[s1 & 0xFF], 24);
+			uint32_t t3 = te[s3 >> 24] ^ Ror32(te[(s0 >> 16) & 0xFF], 8) ^ Ror32(te[(s1 >> 8) & 0xFF], 16) ^ Ror32(te[s2 & 0xFF], 24);
+			s0 = t0 ^ Load32(rk);
+			s1 = t1 ^ Load32(rk + 4);
+			s2 = t2 ^ Load32(rk + 8);
+			s3 = t3 ^ Load32(rk + 12);
+		}
+
+		// last round : SubBytes and ShiftRows only
+		rk += 16;
+		const uint8_t *sb = t.sbox;
+		uint32_t o0 = ((uint32_t)sb[s0 >> 24] << 24) | ((uint32_t)sb[(s1 >> 16) & 0xFF] << 16) | ((uint32_t)sb[(s2 >> 8) & 0xFF] << 8) | sb[s3 & 0xFF];
+		uint32_t o1 = ((uint32_t)sb[s1 >> 24] << 24) | ((uint32_t)sb[(s2 >> 16) & 0xFF] << 16) | ((uint32_t)sb[(s3 >> 8) & 0xFF] << 8) | sb[s0 & 0xFF];
+		uint32_t o2 = ((uint32_t)sb[s2 >> 24] << 24) | ((uint32_t)sb[(s3 >> 16) & 0xFF] << 16) | ((uint32_t)sb[(s0 >> 8) & 0xFF] << 8) | sb[s1 & 0xFF];
+		uint32_t o3 = ((uint32_t)sb[s3 >> 24] << 24) | ((uint32_t)sb[(s0 >> 16) & 0xFF] << 16) | ((uint32_t)sb[(s1 >> 8) & 0xFF] << 8) | sb[s2 & 0xFF];
+		Store32(out, o0 ^ Load32(rk));
+		Store32(out + 4, o1 ^ Load32(rk + 4));
+		Store32(out + 8, o2 ^ Load32(rk + 8));
+		Store32(out + 12, o3 ^ Load32(rk + 12));
+	}
+}
+
+//-------------------------------------------------------------------------------------//
+// AES-NI : 8 blocks in flight, the aesenc latency is hidden behind the others
+
+#if defined(SIMD_HAS_X86_CRYPTO)
+SIMD_TARGET_AESNI
+static void SrtpAesBlocks_AESNI(const uint8_t *roundKeys, int rounds, const uint8_t *in, uint8_t *out, size_t blocks)
+{
+	__m128i rk[SRTP_AES_MAX_ROUNDS + 1];
+	for (int r = 0; r <= rounds; r++)
+		rk[r] = _mm_loadu_si128((const __m128i *)(roundKeys + 16 * r));
+
+	size_t b = 0;
+	for (; b + 8 <= blocks; b += 8) {
+		__m128i x[8];
+		for (int i = 0; i < 8; i++)
+			x[i] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(in + 16 * (b + i))), rk[0]);
+		for (int r = 1; r < rounds; r++) {
+			for (int i = 0; i < 8; i++)
+				x[i] = _mm_aesenc_si128(x[i], rk[r]);
+		}
+		for (int i = 0; i < 8; i++)
+			_mm_storeu_si128((__m128i *)(out + 16 * (b + i)), _mm_aesenclast_si128(x[i], rk[rounds]));
+	}
+	for (; b < blocks; b++) {
+		__m128i x = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(in + 16 * b)), rk[0]);
+		for (int r = 1; r < rounds; r++)
+			x = _mm_aesenc_si128(x, rk[r]);
+		_mm_storeu_si128((__m128i *)(out + 16 * b), _mm_aesenclast_si128(x, rk[rounds]));
+	}
+}
+#endif
+
+//-------------------------------------------------------------------------------------//
+// ARMv8 : AESE adds the round key before SubBytes and ShiftRows, so round r
+// takes key r and the last key is a plain XOR, 4 blocks in flight
+
+#if defined(SIMD_HAS_ARM_CRYPTO)
+static void SrtpAesBlocks_ARMV8(const uint8_t *roundKeys, int rounds, const uint8_t *in, uint8_t *out, size_t blocks)
+{
+	uint8x16_t rk[SRTP_AES_MAX_ROUNDS + 1];
+	for (int r = 0; r <= rounds; r++)
+		rk[r] = vld1q_u8(roundKeys + 16 * r);
+
+	size_t b = 0;
+	for (; b + 4 <= blocks; b += 4) {
+		uint8x16_t x0 = vld1q_u8(in + 16 * b);
+		uint8x16_t x1 = vld1q_u8(in + 16 * b + 16);
+		uint8x16_t x2 = vld1q_u8(in + 16 * b + 32);
+		uint8x16_t x3 = vld1q_u8(in + 16 * b + 48);
+		for (int r = 0; r < rounds - 1; r++) {
+			x0 = vaesmcq_u8(vaeseq_u8(x0, rk[r]));
+			x1 = vaesmcq_u8(vaeseq_u8(x1, rk[r]));
+			x2 = vaesmcq_u8(vaeseq_u8(x2, rk[r]));
+			x3 = vaesmcq_u8(vaeseq_u8(x3, rk[r]));
+		}
+		vst1q_u8(out + 16 * b, veorq_u8(vaeseq_u8(x0, rk[rounds - 1]), rk[rounds]));
+		vst1q_u8(out + 16 * b + 16, veorq_u8(vaeseq_u8(x1, rk[rounds - 1]), rk[rounds]));
+		vst1q_u8(out + 16 * b + 32, veorq_u8(vaeseq_u8(x2, rk[rounds - 1]), rk[rounds]));
+		vst1q_u8(out + 16 * b + 48, veorq_u8(vaeseq_u8(x3, rk[rounds - 1]), rk[rounds]));
+	}
+	for (; b < blocks; b++) {
+		uint8x16_t x = vld1q_u8(in + 16 * b);
+		for (int r = 0; r < rounds - 1; r++)
+			x = vaesmcq_u8(vaeseq_u8(x, rk[r]));
+		vst1q_u8(out + 16 * b, veorq_u8(vaeseq_u8(x, rk[rounds - 1]), rk[rounds]));
+	}
+}
+#endif
+
+//-------------------------------------------------------------------------------------//
+
+CSrtpAes::CSrtpAes()
+	: rounds(0)
+{
+	memset(roundKeys, 0, sizeof(roundKeys));
+	fn = SrtpAesBlocks_C;
+#if defined(SIMD_HAS_X86_CRYPTO)
+	if (SrtpHasAesInstructions())
+		fn = SrtpAesBlocks_AESNI;
+#endif
+#if defined(SIMD_HAS_ARM_CRYPTO)
+	if (SrtpHasAesInstructions())
+		fn = SrtpAesBlocks_ARMV8;
+#endif
+}
+
+CSrtpAes::~CSrtpAes()
+{
+	memset(roundKeys, 0, sizeof(roundKeys));
+}
+
+// FIPS 197 5.2, the schedule is kept as bytes in the order every kernel loads it
+void CSrtpAes::SetKey(const uint8_t *key, int keyBytes)
+{
+	const uint8_t *sbox = Tables().sbox;
+	int nk = keyBytes / 4;
+	rounds = nk + 6;
+
+	uint8_t *w = &roundKeys[0][0];
+	memcpy(w, key, keyBytes);
+	uint8_t rcon = 1;
+	for (int i = nk; i < 4 * (rounds + 1); i++) {
+		uint8_t t[4];
+		memcpy(t, w + 4 * (i - 1), 4);
+		if (i % nk == 0) {
+			uint8_t first = t[0];
+			t[0] = (uint8_t)(sbox[t[1]] ^ rcon);
+			t[1] = sbox[t[2]];
+			t[2] = sbox[t[3]];
+			t[3] = sbox[first];
+			rcon = AesTables::Xtime(rcon);
+		}
+		else if (nk > 6 && i % nk == 4) {
+			for (int j = 0; j < 4; j++)
+				t[j] = sbox[t[j]];
+		}
+		for (int j = 0; j < 4; j++)
+			w[4 * i + j] = w[4 * (i - nk) + j] ^ t[j];
+	}
+}
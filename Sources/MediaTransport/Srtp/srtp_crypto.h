@@ -0,0 +1,88 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+//-------------------------------------------------------------------------------------//
+//
+// Block cipher and MAC primitives of SRTP : AES-128/256, GHASH and HMAC-SHA1.
+//
+// Each has a byte-wise reference kernel and, picked at runtime, one on the
+// AES-NI / PCLMULQDQ / SHA-NI instructions of x86 or the ARMv8 crypto
+// extension. AES only runs over whole arrays of blocks : SRTP lays out the
+// counter blocks of a packet, or of a burst of packets, and encrypts them in
+// one call, so the pipelined kernels are kept busy across packet boundaries.
+//
+//-------------------------------------------------------------------------------------//
+
+#define SRTP_AES_BLOCK_SIZE         16
+#define SRTP_AES_MAX_ROUNDS         14
+#define SRTP_SHA1_DIGEST_SIZE       20
+#define SRTP_SHA1_BLOCK_SIZE        64
+#define SRTP_GHASH_SIZE             16
+
+bool SrtpHasAesInstructions();
+bool SrtpHasClmulInstructions();
+bool SrtpHasSha1Instructions();
+
+typedef void (*SrtpAesBlocksFn)(const uint8_t *roundKeys, int rounds, const uint8_t *in, uint8_t *out, size_t blocks);
+
+class CSrtpAes
+{
+public:
+	CSrtpAes();
+	virtual ~CSrtpAes();
+
+	// keyBytes is 16 or 32
+	void SetKey(const uint8_t *key, int keyBytes);
+
+	// ECB over whole blocks, in may be out
+	void EncryptBlocks(const uint8_t *in, uint8_t *out, size_t blocks) const { fn(&roundKeys[0][0], rounds, in, out, blocks); }
+
+protected:
+	uint8_t roundKeys[SRTP_AES_MAX_ROUNDS + 1][SRTP_AES_BLOCK_SIZE];
+	int rounds;
+	SrtpAesBlocksFn fn;
+};
+
+typedef void (*SrtpGhashBlocksFn)(uint64_t *y, const uint64_t *h, const uint8_t *blocks, size_t count);
+
+// GHASH of GCM (NIST SP 800-38D 6.4), y = (y ^ block) * H per 16 byte block.
+class CSrtpGhash
+{
+public:
+	CSrtpGhash();
+	virtual ~CSrtpGhash();
+
+	void SetKey(const uint8_t *h);
+	void Reset() { y[0] = y[1] = 0; }
+	// a partial last block is zero padded, AAD and ciphertext go in separately
+	void Update(const uint8_t *data, size_t size);
+	// closes with the bit lengths and writes the hash
+	void Final(uint64_t aadBytes, uint64_t textBytes, uint8_t *out);
+
+protected:
+	uint64_t h[2];                  // H as a big endian 128 bit number, high word first
+	uint64_t y[2];
+	SrtpGhashBlocksFn fn;
+};
+
+typedef void (*SrtpSha1BlocksFn)(uint32_t *state, const uint8_t *blocks, size_t count);
+
+// HMAC-SHA1 with the key's inner and outer pad states computed once, so a MAC
+// costs the message blocks and two more compressions.
+class CSrtpHmacSha1
+{
+public:
+	CSrtpHmacSha1();
+	virtual ~CSrtpHmacSha1();
+
+	void SetKey(const uint8_t *key, size_t size);
+
+	// MAC of a followed by b (SRTP appends the ROC to the packet this way)
+	void Mac(const uint8_t *a, size_t aSize, const uint8_t *b, size_t bSize, uint8_t *out) const;
+
+protected:
+	uint32_t inner[5];
+	uint32_t outer[5];
+	SrtpSha1BlocksFn fn;
+};
@@ -0,0 +1,171 @@
+//
+//  srtp_ghash.cpp
+//
+
+#include <string.h>
+
+#include "srtp_crypto.h"
+#include "../Simd/simd_cpu.h"
+
+//-------------------------------------------------------------------------------------//
+// A block loaded big endian is a 128 bit number whose most significant bit is
+// the x^0 coefficient of GCM's bit-reflected polynomial. The carry-less product
+// of two such numbers is the reflected product shifted right by one, so it is
+// shifted back and reduced modulo x^128 + x^7 + x^2 + x + 1 with shifts and XORs
+// (Gueron and Kounavis, Intel carry-less multiplication white paper, alg. 4).
+// The kernels differ only in how the four 64x64 products are computed.
+
+static inline uint64_t LoadBe64(const uint8_t *p)
+{
+	return ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48) | ((uint64_t)p[2] << 40) | ((uint64_t)p[3] << 32) |
+		((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16) | ((uint64_t)p[6] << 8) | p[7];
+}
+
+static inline void StoreBe64(uint8_t *p, uint64_t v)
+{
+	for (int i = 7; i >= 0; i--, v >>= 8)
+		p[i] = (uint8_t)v;
+}
+
+// z3:z2:z1:z0 is the 256 bit product, y receives it shifted and reduced
+static inline void GhashReduce(uint64_t *y, uint64_t z3, uint64_t z2, uint64_t z1, uint64_t z0)
+{
+	z3 = (z3 << 1) | (z2 >> 63);
+	z2 = (z2 << 1) | (z1 >> 63);
+	z1 = (z1 << 1) | (z0 >> 63);
+	z0 <<= 1;
+
+	uint64_t d = z1 ^ (z0 << 63) ^ (z0 << 62) ^ (z0 << 57);
+	uint64_t e1 = (d >> 1) ^ (d >> 2) ^ (d >> 7);
+	uint64_t e0 = (z0 >> 1) ^ (d << 63) ^ (z0 >> 2) ^ (d << 62) ^ (z0 >> 7) ^ (d << 57);
+	y[0] = z3 ^ d ^ e1;
+	y[1] = z2 ^ z0 ^ e0;
+}
+
+//-------------------------------------------------------------------------------------//
+// reference : 64x64 carry-less product with masks instead of branches
+
+static inline void Clmul64(uint64_t a, uint64_t b, uint64_t &hi, uint64_t &lo)
+{
+	uint64_t h = 0, l = 0;
+	for (int i = 0; i < 64; i++) {
+		uint64_t mask = 0 - ((b >> i) & 1);
+		l ^= (a << i) & mask;
+		h ^= i ? (a >> (64 - i)) & mask : 0;
+	}
+	hi = h;
+	lo = l;
+}
+
+static void SrtpGhashBlocks_C(uint64_t *y, const uint64_t *h, const uint8_t *blocks, size_t count)
+{
+	for (size_t i = 0; i < count; i++, blocks += 16) {
+		uint64_t x1 = y[0] ^ LoadBe64(blocks);
+		uint64_t x0 = y[1] ^ LoadBe64(blocks + 8);
+		uint64_t hh1, hh0, hl1, hl0, lh1, lh0, ll1, ll0;
+		Clmul64(x1, h[0], hh1, hh0);
+		Clmul64(x1, h[1], hl1, hl0);
+		Clmul64(x0, h[0], lh1, lh0);
+		Clmul64(x0, h[1], ll1, ll0);
+		GhashReduce(y, hh1, hh0 ^ hl1 ^ lh1, ll1 ^ hl0 ^ lh0, ll0);
+	}
+}
+
+//-------------------------------------------------------------------------------------//
+// PCLMULQDQ
+
+#if defined(SIMD_HAS_X86_CRYPTO)
+SIMD_TARGET_CLMUL
+static void SrtpGhashBlocks_CLMUL(uint64_t *y, const uint64_t *h, const uint8_t *blocks, size_t count)
+{
+	const __m128i reverse = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	const __m128i hv = _mm_set_epi64x((long long)h[0], (long long)h[1]);
+	__m128i yv = _mm_set_epi64x((long long)y[0], (long long)y[1]);
+
+	for (size_t i = 0; i < count; i++, blocks += 16) {
+		__m128i x = _mm_xor_si128(yv, _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)blocks), reverse));
+		__m128i ll = _mm_clmulepi64_si128(x, hv, 0x00);
+		__m128i hh = _mm_clmulepi64_si128(x, hv, 0x11);
+		__m128i mid = _mm_xor_si128(_mm_clmulepi64_si128(x, hv, 0x01), _mm_clmulepi64_si128(x, hv, 0x10));
+		uint64_t r[2];
+		GhashReduce(r, (uint64_t)_mm_extract_epi64(hh, 1),
+			(uint64_t)_mm_cvtsi128_si64(hh) ^ (uint64_t)_mm_extract_epi64(mid, 1),
+			(uint64_t)_mm_extract_epi64(ll, 1) ^ (uint64_t)_mm_cvtsi128_si64(mid),
+			(uint64_t)_mm_cvtsi128_si64(ll));
+		yv = _mm_set_epi64x((long long)r[0], (long long)r[1]);
+	}
+	y[0] = (uint64_t)_mm_extract_epi64(yv, 1);
+	y[1] = (uint64_t)_mm_cvtsi128_si64(yv);
+}
+#endif
+
+//-------------------------------------------------------------------------------------//
+// ARMv8 PMULL
+
+#if defined(SIMD_HAS_ARM_CRYPTO)
+static void SrtpGhashBlocks_PMULL(uint64_t *y, const uint64_t *h, const uint8_t *blocks, size_t count)
+{
+	for (size_t i = 0; i < count; i++, blocks += 16) {
+		uint64_t x1 = y[0] ^ LoadBe64(blocks);
+		uint64_t x0 = y[1] ^ LoadBe64(blocks + 8);
+		uint64x2_t hh = vreinterpretq_u64_p128(vmull_p64((poly64_t)x1, (poly64_t)h[0]));
+		uint64x2_t hl = vreinterpretq_u64_p128(vmull_p64((poly64_t)x1, (poly64_t)h[1]));
+		uint64x2_t lh = vreinterpretq_u64_p128(vmull_p64((poly64_t)x0, (poly64_t)h[0]));
+		uint64x2_t ll = vreinterpretq_u64_p128(vmull_p64((poly64_t)x0, (poly64_t)h[1]));
+		uint64x2_t mid = veorq_u64(hl, lh);
+		GhashReduce(y, vgetq_lane_u64(hh, 1), vgetq_lane_u64(hh, 0) ^ vgetq_lane_u64(mid, 1),
+			vgetq_lane_u64(ll, 1) ^ vgetq_lane_u64(mid, 0), vgetq_lane_u64(ll, 0));
+	}
+}
+#endif
+
+//-------------------------------------------------------------------------------------//
+
+CSrtpGhash::CSrtpGhash()
+{
+	h[0] = h[1] = 0;
+	y[0] = y[1] = 0;
+	fn = SrtpGhashBlocks_C;
+#if defined(SIMD_HAS_X86_CRYPTO)
+	if (SrtpHasClmulInstructions())
+		fn = SrtpGhashBlocks_CLMUL;
+#endif
+#if defined(SIMD_HAS_ARM_CRYPTO)
+	if (SrtpHasClmulInstructions())
+		fn = SrtpGhashBlocks_PMULL;
+#endif
+}
+
+CSrtpGhash::~CSrtpGhash()
+{
+	h[0] = h[1] = 0;
+}
+
+void CSrtpGhash::SetKey(const uint8_t *key)
+{
+	h[0] = LoadBe64(key);
+	h[1] = LoadBe64(key + 8);
+	Reset();
+}
+
+void CSrtpGhash::Update(const uint8_t *data, size_t size)
+{
+	size_t whole = size / SRTP_GHASH_SIZE;
+	fn(y, h, data, whole);
+	size_t rest = size - whole * SRTP_GHASH_SIZE;
+	if (rest > 0) {
+		uint8_t last[SRTP_GHASH_SIZE] = { 0 };
+		memcpy(last, data + whole * SRTP_GHASH_SIZE, rest);
+		fn(y, h, last, 1);
+	}
+}
+
+void CSrtpGhash::Final(uint64_t aadBytes, uint64_t textBytes, uint8_t *out)
+{
+	uint8_t lengths[SRTP_GHASH_SIZE];
+	StoreBe64(lengths, aadBytes * 8);
+	StoreBe64(lengths + 8, textBytes * 8);
+	fn(y, h, lengths, 1);
+	StoreBe64(out, y[0]);
+	StoreBe64(out + 8, y[1]);
+}
@@ -0,0 +1,249 @@
+//
+//  srtp_sha1.cpp
+//
+
+#include <string.h>
+
+#include "srtp_crypto.h"
+#include "../Simd/simd_cpu.h"
+
+#define HMAC_IPAD               0x36
+#define HMAC_OPAD               0x5C
+
+static const uint32_t kSha1Init[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+static const uint32_t kSha1K[4] = { 0x5A827999, 0x6ED9EBA1, 0x8F1BBCDC, 0xCA62C1D6 };
+
+static inline uint32_t Rol32(uint32_t x, int n)
+{
+	return (x << n) | (x >> (32 - n));
+}
+
+//-------------------------------------------------------------------------------------//
+// reference (FIPS 180-4 6.1.2) with a 16 word rolling schedule
+
+static void SrtpSha1Blocks_C(uint32_t *state, const uint8_t *blocks, size_t count)
+{
+	for (size_t n = 0; n < count; n++, blocks += SRTP_SHA1_BLOCK_SIZE) {
+		uint32_t w[16];
+		for (int i = 0; i < 16; i++)
+			w[i] = ((uint32_t)blocks[4 * i] << 24) | ((uint32_t)blocks[4 * i + 1] << 16) |
+				((uint32_t)blocks[4 * i + 2] << 8) | blocks[4 * i + 3];
+
+		uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+		for (int i = 0; i < 80; i++) {
+			if (i >= 16)
+				w[i & 15] = Rol32(w[(i - 3) & 15] ^ w[(i - 8) & 15] ^ w[(i - 14) & 15] ^ w[i & 15], 1);
+			uint32_t f;
+			if (i < 20)
+				f = (b & c) | (~b & d);
+			else if (i < 40 || i >= 60)
+				f = b ^ c ^ d;
+			else
+				f = (b & c) | (b & d) | (c & d);
+			uint32_t t = Rol32(a, 5) + f + e + kSha1K[i / 20] + w[i & 15];
+			e = d;
+			d = c;
+			c = Rol32(b, 30);
+			b = a;
+			a = t;
+		}
+		state[0] += a;
+		state[1] += b;
+		state[2] += c;
+		state[3] += d;
+		state[4] += e;
+	}
+}
+
+//-------------------------------------------------------------------------------------//
+// SHA-NI : 4 rounds per SHA1RNDS4, the next E comes out of SHA1NEXTE and the
+// schedule out of SHA1MSG1 / SHA1MSG2
+
+#if defined(SIMD_HAS_X86_CRYPTO)
+SIMD_TARGET_SHANI
+static void SrtpSha1Blocks_SHANI(uint32_t *state, const uint8_t *blocks, size_t count)
+{
+	const __m128i reverse = _mm_set_epi64x(0x0001020304050607LL, 0x08090A0B0C0D0E0FLL);
+	__m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)state), 0x1B);
+	__m128i e0 = _mm_set_epi32((int)state[4], 0, 0, 0);
+
+	for (size_t n = 0; n < count; n++, blocks += SRTP_SHA1_BLOCK_SIZE) {
+		__m128i abcdSaved = abcd, eSaved = e0;
+		__m128i w[4];
+		for (int i = 0; i < 4; i++)
+			w[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(blocks + 16 * i)), reverse);
+
+		__m128i e = _mm_add_epi32(e0, w[0]);
+		__m128i previous = abcd;
+		abcd = _mm_sha1rnds4_epu32(abcd, e, 0);
+		for (int g = 1; g < 20; g++) {
+			__m128i wg;
+			if (g < 4) {
+				wg = w[g];
+			}
+			else {
+				// w[g] from w[g - 4] .. w[g - 1], kept in a ring of four
+				__m128i t = _mm_sha1msg1_epu32(w[g & 3], w[(g + 1) & 3]);
+				t = _mm_xor_si128(t, w[(g + 2) & 3]);
+				wg = _mm_sha1msg2_epu32(t, w[(g + 3) & 3]);
+				w[g & 3] = wg;
+			}
+			e = _mm_sha1nexte_epu32(previous, wg);
+			previous = abcd;
+			switch (g / 5) {
+			case 0: abcd = _mm_sha1rnds4_epu32(abcd, e, 0); break;
+			case 1: abcd = _mm_sha1rnds4_epu32(abcd, e, 1); break;
+			case 2: abcd = _mm_sha1rnds4_epu32(abcd, e, 2); break;
+			default: abcd = _mm_sha1rnds4_epu32(abcd, e, 3); break;
+			}
+		}
+		e0 = _mm_sha1nexte_epu32(previous, eSaved);
+		abcd = _mm_add_epi32(abcd, abcdSaved);
+	}
+
+	_mm_storeu_si128((__m128i *)state, _mm_shuffle_epi32(abcd, 0x1B));
+	state[4] = (uint32_t)_mm_extract_epi32(e0, 3);
+}
+#endif
+
+//-------------------------------------------------------------------------------------//
+// ARMv8 : the same shape, SHA1C/P/M per group of 20 rounds and SHA1H for E
+
+#if defined(SIMD_HAS_ARM_CRYPTO)
+static void SrtpSha1Blocks_ARMV8(uint32_t *state, const uint8_t *blocks, size_t count)
+{
+	uint32x4_t abcd = vld1q_u32(state);
+	uint32_t e0 = state[4];
+
+	for (size_t n = 0; n < count; n++, blocks += SRTP_SHA1_BLOCK_SIZE) {
+		uint32x4_t abcdSaved = abcd;
+		uint32_t e = e0;
+		uint32x4_t w[4];
+		for (int i = 0; i < 4; i++)
+			w[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(blocks + 16 * i)));
+
+		for (int g = 0; g < 20; g++) {
+			uint32x4_t wg;
+			if (g < 4) {
+				wg = w[g];
+			}
+			else {
+				wg = vsha1su1q_u32(vsha1su0q_u32(w[g & 3], w[(g + 1) & 3], w[(g + 2) & 3]), w[(g + 3) & 3]);
+				w[g & 3] = wg;
+			}
+			uint32x4_t wk = vaddq_u32(wg, vdupq_n_u32(kSha1K[g / 5]));
+			uint32_t next = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+			if (g < 5)
+				abcd = vsha1cq_u32(abcd, e, wk);
+			else if (g < 10 || g >= 15)
+				abcd = vsha1pq_u32(abcd, e, wk);
+			else
+				abcd = vsha1mq_u32(abcd, e, wk);
+			e = next;
+		}
+		abcd = vaddq_u32(abcd, abcdSaved);
+		e0 += e;
+	}
+
+	vst1q_u32(state, abcd);
+	state[4] = e0;
+}
+#endif
+
+//-------------------------------------------------------------------------------------//
+
+CSrtpHmacSha1::CSrtpHmacSha1()
+{
+	memset(inner, 0, sizeof(inner));
+	memset(outer, 0, sizeof(outer));
+	fn = SrtpSha1Blocks_C;
+#if defined(SIMD_HAS_X86_CRYPTO)
+	if (SrtpHasSha1Instructions())
+		fn = SrtpSha1Blocks_SHANI;
+#endif
+#if defined(SIMD_HAS_ARM_CRYPTO)
+	if (SrtpHasSha1Instructions())
+		fn = SrtpSha1Blocks_ARMV8;
+#endif
+}
+
+CSrtpHmacSha1::~CSrtpHmacSha1()
+{
+	memset(inner, 0, sizeof(inner));
+	memset(outer, 0, sizeof(outer));
+}
+
+void CSrtpHmacSha1::SetKey(const uint8_t *key, size_t size)
+{
+	uint8_t pad[SRTP_SHA1_BLOCK_SIZE];
+
+	// SRTP keys are 20 bytes, longer ones would be hashed first (RFC 2104)
+	if (size > SRTP_SHA1_BLOCK_SIZE)
+		size = SRTP_SHA1_BLOCK_SIZE;
+	memset(pad, HMAC_IPAD, sizeof(pad));
+	for (size_t i = 0; i < size; i++)
+		pad[i] ^= key[i];
+	memcpy(inner, kSha1Init, sizeof(inner));
+	fn(inner, pad, 1);
+
+	memset(pad, HMAC_OPAD, sizeof(pad));
+	for (size_t i = 0; i < size; i++)
+		pad[i] ^= key[i];
+	memcpy(outer, kSha1Init, sizeof(outer));
+	fn(outer, pad, 1);
+	memset(pad, 0, sizeof(pad));
+}
+
+static void StoreDigest(uint8_t *out, const uint32_t *state)
+{
+	for (int i = 0; i < 5; i++) {
+		out[4 * i] = (uint8_t)(state[i] >> 24);
+		out[4 * i + 1] = (uint8_t)(state[i] >> 16);
+		out[4 * i + 2] = (uint8_t)(state[i] >> 8);
+		out[4 * i + 3] = (uint8_t)state[i];
+	}
+}
+
+// buffer holds the tail and the padding, a message bit length goes last
+static size_t Sha1Pad(uint8_t *buffer, size_t used, uint64_t totalBytes)
+{
+	buffer[used++] = 0x80;
+	size_t end = used + 8 <= SRTP_SHA1_BLOCK_SIZE ? SRTP_SHA1_BLOCK_SIZE : 2 * SRTP_SHA1_BLOCK_SIZE;
+	memset(buffer + used, 0, end - used);
+	uint64_t bits = totalBytes * 8;
+	for (int i = 1; i <= 8; i++, bits >>= 8)
+		buffer[end - i] = (uint8_t)bits;
+	return end / SRTP_SHA1_BLOCK_SIZE;
+}
+
+void CSrtpHmacSha1::Mac(const uint8_t *a, size_t aSize, const uint8_t *b, size_t bSize, uint8_t *out) const
+{
+	uint8_t buffer[2 * SRTP_SHA1_BLOCK_SIZE];
+	uint32_t state[5];
+	uint64_t total = SRTP_SHA1_BLOCK_SIZE + (uint64_t)aSize + bSize;
+
+	// inner hash, the whole blocks of a straight from the packet
+	memcpy(state, inner, sizeof(state));
+	size_t whole = aSize / SRTP_SHA1_BLOCK_SIZE;
+	fn(state, a, whole);
+	size_t used = aSize - whole * SRTP_SHA1_BLOCK_SIZE;
+	memcpy(buffer, a + whole * SRTP_SHA1_BLOCK_SIZE, used);
+	while (bSize > 0) {
+		size_t n = SRTP_SHA1_BLOCK_SIZE - used < bSize ? SRTP_SHA1_BLOCK_SIZE - used : bSize;
+		memcpy(buffer + used, b, n);
+		used += n;
+		b += n;
+		bSize -= n;
+		if (used == SRTP_SHA1_BLOCK_SIZE) {
+			fn(state, buffer, 1);
+			used = 0;
+		}
+	}
+	fn(state, buffer, Sha1Pad(buffer, used, total));
+
+	// outer hash over the inner digest, one block
+	StoreDigest(buffer, state);
+	memcpy(state, outer, sizeof(state));
+	fn(state, buffer, Sha1Pad(buffer, SRTP_SHA1_DIGEST_SIZE, SRTP_SHA1_BLOCK_SIZE + SRTP_SHA1_DIGEST_SIZE));
+	StoreDigest(out, state);
+}
@@ -0,0 +1,40 @@
+//
+//  h264_nalu.h
+//
+//  Annex-B start code scanner. Same result as findNaluIndices in
+//  H264Common.swift, written into a caller-provided array so a frame
+//  is scanned without any allocation.
+//
+
+#ifndef H264_NALU_H
+#define H264_NALU_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define H264_NALU_INDEX_CAPACITY    64      // enough for SPS/PPS/SEI and a sliced frame
+
+typedef struct H264NaluIndex {
+	uint32_t startOffset;           // first byte of the 00 00 01 / 00 00 00 01 start code
+	uint32_t payloadStartOffset;    // first byte of the NAL header
+	uint32_t payloadSize;           // bytes up to the next start code or the end
+} H264NaluIndex;
+
+// Finds the NAL units of an Annex-B buffer. At most capacity entries are written,
+// the return value is the number of NAL units in the buffer, so a result above
+// capacity tells the caller to scan again with a larger array.
+int H264FindNaluIndices(const uint8_t *buffer, size_t count, H264NaluIndex *indices, int capacity);
+
+// Offset of the first 00 00 01 at or after from (the offset of its first zero),
+// count when there is none.
+size_t H264FindStartCode(const uint8_t *buffer, size_t from, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,110 @@
+//
+//  h264_parser.h
+//
+//  SPS, PPS and slice header parsers (H.264 7.3.2.1, 7.3.2.2, 7.3.3). They
+//  read what a forwarding or recording node needs : the resolution, frame_num,
+//  IDR and picture order count fields, and stop before the reference list,
+//  weight and macroblock syntax. NAL units are passed with their header byte
+//  and without the start code.
+//
+
+#ifndef H264_PARSER_H
+#define H264_PARSER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define H264_MAX_SPS_COUNT          32
+#define H264_MAX_PPS_COUNT          256
+
+typedef struct H264Sps {
+	uint8_t profileIdc;
+	uint8_t constraintFlags;        // constraint_set0..5 flags, set0 in bit 7
+	uint8_t levelIdc;
+	uint8_t spsId;
+	uint8_t chromaFormatIdc;        // 1 (4:2:0) unless a high profile says otherwise
+	uint8_t separateColourPlane;
+	uint8_t bitDepthLuma;
+	uint8_t bitDepthChroma;
+	uint8_t log2MaxFrameNum;
+	uint8_t picOrderCntType;
+	uint8_t log2MaxPicOrderCntLsb;  // picOrderCntType 0
+	uint8_t deltaPicOrderAlwaysZero;// picOrderCntType 1
+	uint8_t frameMbsOnly;
+	uint8_t frameCropping;
+	uint8_t vuiPresent;
+	uint8_t maxNumRefFrames;
+	uint32_t widthInMbs;
+	uint32_t heightInMapUnits;
+	uint32_t width;                 // cropped, in pixels
+	uint32_t height;
+} H264Sps;
+
+typedef struct H264Pps {
+	uint8_t ppsId;
+	uint8_t spsId;
+	uint8_t entropyCodingMode;      // 1 for CABAC
+	uint8_t bottomFieldPicOrderInFramePresent;
+	uint8_t numSliceGroups;
+	uint8_t numRefIdxL0Default;
+	uint8_t numRefIdxL1Default;
+	uint8_t weightedPred;
+	uint8_t weightedBipredIdc;
+	uint8_t deblockingFilterControlPresent;
+	uint8_t constrainedIntraPred;
+	uint8_t redundantPicCntPresent;
+	int8_t picInitQp;
+	int8_t picInitQs;
+	int8_t chromaQpIndexOffset;
+} H264Pps;
+
+typedef struct H264SliceHeader {
+	uint8_t nalRefIdc;              // 0 for a picture nothing refers to, which may be dropped
+	uint8_t nalUnitType;
+	uint8_t idr;
+	uint8_t sliceType;              // 0..4, P B I SP SI, the +5 form is folded
+	uint8_t ppsId;
+	uint8_t colourPlaneId;
+	uint8_t fieldPic;
+	uint8_t bottomField;
+	uint32_t firstMbInSlice;
+	uint32_t frameNum;
+	uint32_t idrPicId;
+	uint32_t picOrderCntLsb;
+	int32_t deltaPicOrderCntBottom;
+	int32_t deltaPicOrderCnt[2];
+	uint32_t redundantPicCnt;
+} H264SliceHeader;
+
+// Active parameter sets of a stream, indexed by id.
+typedef struct H264ParameterSets {
+	uint32_t spsValid;                          // bit per sps id
+	uint32_t ppsValid[H264_MAX_PPS_COUNT / 32]; // bit per pps id
+	H264Sps sps[H264_MAX_SPS_COUNT];
+	H264Pps pps[H264_MAX_PPS_COUNT];
+} H264ParameterSets;
+
+// Each returns 1 on success, 0 for a truncated or out of range NAL unit, in
+// which case the output is left unspecified.
+int H264ParseSps(const uint8_t *nal, size_t size, H264Sps *sps);
+int H264ParsePps(const uint8_t *nal, size_t size, H264Pps *pps);
+int H264ParseSliceHeader(const uint8_t *nal, size_t size, const H264Sps *sps, const H264Pps *pps, H264SliceHeader *header);
+
+void H264ParameterSetsReset(H264ParameterSets *sets);
+
+// Stores an SPS or PPS NAL unit, returns 1 when it was one and parsed, 0 otherwise.
+int H264ParameterSetsUpdate(H264ParameterSets *sets, const uint8_t *nal, size_t size);
+
+// Parses a slice header with the PPS it names and that PPS's SPS, returns 0
+// when either has not been seen.
+int H264ParseSliceHeaderWith(const H264ParameterSets *sets, const uint8_t *nal, size_t size, H264SliceHeader *header);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,49 @@
+//
+//  h264_rbsp.h
+//
+//  Emulation prevention (H.264 7.4.1) : a NAL unit carries its RBSP with a
+//  03 byte after every 00 00 that is followed by 00..03, so no start code
+//  shows up inside it. The routines below drop or insert these bytes in one
+//  pass, the zero runs are found 32/64 bytes at a time.
+//
+
+#ifndef H264_RBSP_H
+#define H264_RBSP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// worst case size of an escaped RBSP of n bytes (all zeros)
+#define H264_ESCAPED_SIZE_MAX(n)    ((n) + (n) / 2 + 1)
+
+typedef struct H264RbspView {
+	const uint8_t *data;            // the NAL bytes themselves, or the scratch buffer
+	size_t size;
+	int copied;                     // 1 when emulation prevention bytes were removed into scratch
+} H264RbspView;
+
+// Removes the 03 of every 00 00 03, returns the RBSP length. dst may be src.
+size_t H264UnescapeRbsp(uint8_t *dst, const uint8_t *src, size_t count);
+
+// RBSP of a NAL unit without copying when it has no 00 00 03, which is the usual
+// case for parameter sets and slice headers. Otherwise it is unescaped into scratch,
+// which holds at least count bytes.
+H264RbspView H264RbspViewOf(const uint8_t *nal, size_t count, uint8_t *scratch);
+
+// Length of the escaped form of an RBSP.
+size_t H264EscapedSize(const uint8_t *rbsp, size_t count);
+
+// Inserts the emulation prevention bytes, returns the escaped length, or 0 when
+// it does not fit in capacity (H264_ESCAPED_SIZE_MAX(count) always does) or count is 0.
+// Data ending in 00 00, which only cabac_zero_words leave, gets a final 03.
+size_t H264EscapeRbsp(uint8_t *dst, size_t capacity, const uint8_t *rbsp, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,90 @@
+//
+//  audio_level_tests.cpp
+//
+
+#include <string.h>
+
+#include "media_test.h"
+#include "../../Sources/AudioCodecs/AudioLevel/audio_level.h"
+
+#define TEST_EXTENSION_ID       1
+
+static int BuildPacket(uint8_t *packet, uint32_t ssrc, int level, int voice)
+{
+	memset(packet, 0, 12);
+	packet[0] = 0x80;
+	packet[1] = 0;
+	packet[8] = (uint8_t)(ssrc >> 24);
+	packet[9] = (uint8_t)(ssrc >> 16);
+	packet[10] = (uint8_t)(ssrc >> 8);
+	packet[11] = (uint8_t)ssrc;
+	memset(packet + 12, 0xD5, 160);
+	return AudioLevel_WriteExtension(packet, 12 + 160, 256, TEST_EXTENSION_ID, level, voice);
+}
+
+int MediaTest_ActiveSpeakerWithoutVoiceBit(void)
+{
+	// senders without a VAD, V=0 on every packet
+	CActiveSpeakerDetector detector(TEST_EXTENSION_ID, 8);
+	uint8_t packet[256];
+	uint32_t ranked[8];
+
+	for (uint32_t ms = 0; ms < 3000; ms += 20) {
+		int length = BuildPacket(packet, 0x1111, 20, 0);
+		MEDIA_TEST_CHECK(length > 0);
+		MEDIA_TEST_CHECK(detector.OnPacket(packet, length, ms));
+		length = BuildPacket(packet, 0x2222, 35, 0);
+		MEDIA_TEST_CHECK(detector.OnPacket(packet, length, ms));
+		length = BuildPacket(packet, 0x3333, AUDIO_LEVEL_SILENCE, 0);
+		MEDIA_TEST_CHECK(detector.OnPacket(packet, length, ms));
+	}
+
+	int count = detector.RankSpeakers(ranked, 8, 3000);
+	MEDIA_TEST_CHECK(count == 2);
+	MEDIA_TEST_CHECK(ranked[0] == 0x1111 && ranked[1] == 0x2222);
+	MEDIA_TEST_CHECK(detector.DominantSpeaker() == 0x1111);
+
+	// the loud one goes quiet, the other takes over after the decay
+	for (uint32_t ms = 3000; ms < 6000; ms += 20) {
+		int length = BuildPacket(packet, 0x1111, AUDIO_LEVEL_SILENCE, 0);
+		detector.OnPacket(packet, length, ms);
+		length = BuildPacket(packet, 0x2222, 35, 0);
+		detector.OnPacket(packet, length, ms);
+	}
+	count = detector.RankSpeakers(ranked, 8, 6000);
+	MEDIA_TEST_CHECK(count == 1 && ranked[0] == 0x2222);
+	MEDIA_TEST_CHECK(detector.DominantSpeaker() == 0x2222);
+	return 0;
+}
+
+int MediaTest_ActiveSpeakerVoiceGate(void)
+{
+	CActiveSpeakerDetector detector(TEST_EXTENSION_ID, 8, true);
+	uint8_t packet[256];
+	uint32_t ranked[8];
+
+	for (uint32_t ms = 0; ms < 2000; ms += 20) {
+		int length = BuildPacket(packet, 0x1111, 10, 0);
+		detector.OnPacket(packet, length, ms);
+		length = BuildPacket(packet, 0x2222, 40, 1);
+		detector.OnPacket(packet, length, ms);
+	}
+	int count = detector.RankSpeakers(ranked, 8, 2000);
+	MEDIA_TEST_CHECK(count == 1 && ranked[0] == 0x2222);
+	return 0;
+}
+
+int MediaTest_AudioLevelShortPacket(void)
+{
+	uint8_t packet[32];
+	memset(packet, 0x9F, sizeof(packet));
+	MEDIA_TEST_CHECK(AudioLevel_WriteExtension(packet, 0, sizeof(packet), TEST_EXTENSION_ID, 30, 1) == -1);
+	MEDIA_TEST_CHECK(AudioLevel_WriteExtension(packet, 11, sizeof(packet), TEST_EXTENSION_ID, 30, 1) == -1);
+
+	uint8_t full[256];
+	int voice = 0;
+	int length = BuildPacket(full, 1, 30, 1);
+	MEDIA_TEST_CHECK(length == 12 + 8 + 160);
+	MEDIA_TEST_CHECK(AudioLevel_ReadExtension(full, length, TEST_EXTENSION_ID, &voice) == 30 && voice == 1);
+	return 0;
+}
@@ -0,0 +1,106 @@
+//
+//  audio_mixer_tests.cpp
+//
+
+#include <math.h>
+
+#include "media_test.h"
+#include "../../Sources/AudioCodecs/Mixer/audio_mixer.h"
+
+#define TEST_FRAME_SAMPLES      163     // not a multiple of the vector step
+#define TEST_PARTICIPANTS       5
+
+static int16_t Saturate(int32_t v)
+{
+	return (int16_t)(v > 32767 ? 32767 : v < -32768 ? -32768 : v);
+}
+
+static void Tone(int16_t *frame, double amplitude, double frequency, int frame_index)
+{
+	for (int i = 0; i < TEST_FRAME_SAMPLES; i++) {
+		int n = frame_index * TEST_FRAME_SAMPLES + i;
+		frame[i] = (int16_t)(amplitude * sin(2 * M_PI * frequency * n / 8000.0));
+	}
+}
+
+// Each mixed talker hears the saturated sum of the other mixed talkers, the
+// rest hear the saturated sum of all of them, also when the sum clips.
+int MediaTest_AudioMixerMixMinus(void)
+{
+	CAudioMixer mixer(TEST_FRAME_SAMPLES, TEST_PARTICIPANTS);
+	static int16_t frames[TEST_PARTICIPANTS][TEST_FRAME_SAMPLES];
+	const int16_t *inputs[TEST_PARTICIPANTS];
+	unsigned seed = 3;
+
+	for (int round = 0; round < 20; round++) {
+		for (int p = 0; p < TEST_PARTICIPANTS; p++) {
+			for (int i = 0; i < TEST_FRAME_SAMPLES; i++) {
+				seed = seed * 1103515245 + 12345;
+				frames[p][i] = (int16_t)((int)((seed >> 8) & 0xFFFF) - 32768);
+			}
+			// one missing participant per round
+			inputs[p] = p == round % TEST_PARTICIPANTS ? NULL : frames[p];
+		}
+		mixer.Mix(inputs, TEST_PARTICIPANTS);
+		MEDIA_TEST_CHECK(mixer.MixedCount() == TEST_PARTICIPANTS - 1);
+
+		for (int listener = 0; listener < TEST_PARTICIPANTS; listener++) {
+			const int16_t *heard = mixer.MixMinusFrame(listener);
+			MEDIA_TEST_CHECK(mixer.IsMixed(listener) == (inputs[listener] != NULL));
+			for (int i = 0; i < TEST_FRAME_SAMPLES; i++) {
+				int32_t sum = 0;
+				for (int p = 0; p < TEST_PARTICIPANTS; p++) {
+					if (inputs[p] != NULL && p != listener)
+						sum += inputs[p][i];
+				}
+				MEDIA_TEST_CHECK(heard[i] == Saturate(sum));
+			}
+		}
+	}
+	return 0;
+}
+
+// With two speakers mixed, a talker who goes quiet keeps the place for a few
+// frames on the smoothed energy, then the louder newcomer takes it.
+int MediaTest_AudioMixerTopSpeakers(void)
+{
+	CAudioMixer mixer(TEST_FRAME_SAMPLES, TEST_PARTICIPANTS);
+	static int16_t frames[TEST_PARTICIPANTS][TEST_FRAME_SAMPLES];
+	const int16_t *inputs[TEST_PARTICIPANTS];
+	double amplitudes[TEST_PARTICIPANTS] = { 10000, 8000, 1000, 500, 300 };
+	bool newcomerWaited = false;
+
+	mixer.SetMaxActiveSpeakers(2);
+	for (int frame = 0; frame < 12; frame++) {
+		if (frame == 3) {
+			amplitudes[0] = 1500;       // the first talker drops
+			amplitudes[2] = 4000;       // louder than that, quieter than it was
+		}
+		for (int p = 0; p < TEST_PARTICIPANTS; p++) {
+			Tone(frames[p], amplitudes[p], 300 + 110 * p, frame);
+			inputs[p] = frames[p];
+		}
+		mixer.Mix(inputs, TEST_PARTICIPANTS);
+		MEDIA_TEST_CHECK(mixer.MixedCount() == 2);
+		MEDIA_TEST_CHECK(mixer.IsMixed(1));
+		MEDIA_TEST_CHECK(!mixer.IsMixed(3) && !mixer.IsMixed(4));
+
+		if (frame < 3) {
+			MEDIA_TEST_CHECK(mixer.IsMixed(0));
+		}
+		else if (frame == 3) {
+			MEDIA_TEST_CHECK(mixer.IsMixed(0) && !mixer.IsMixed(2));
+			newcomerWaited = true;
+		}
+		else if (frame >= 10) {
+			MEDIA_TEST_CHECK(mixer.IsMixed(2) && !mixer.IsMixed(0));
+		}
+		// the talkers left out hear the two mixed ones
+		const int16_t *heard = mixer.MixMinusFrame(4);
+		const int *mixed = mixer.MixedParticipants();
+		for (int i = 0; i < TEST_FRAME_SAMPLES; i++)
+			MEDIA_TEST_CHECK(heard[i] == Saturate(frames[mixed[0]][i] + frames[mixed[1]][i]));
+	}
+	MEDIA_TEST_CHECK(newcomerWaited);
+	return 0;
+}
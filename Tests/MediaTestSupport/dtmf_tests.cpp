@@ -0,0 +1,48 @@
+//
+//  dtmf_tests.cpp
+//
+
+#include <math.h>
+#include <string.h>
+
+#include "media_test.h"
+#include "../../Sources/AudioCodecs/Dtmf/dtmf.h"
+
+#define TEST_TONE_MS            40      // minimum digit and pause of Q.24
+#define TEST_SAMPLES_PER_MS     8
+
+static const double kRows[4] = { 697, 770, 852, 941 };
+static const double kColumns[4] = { 1209, 1336, 1477, 1633 };
+static const char kDigits[] = "123A456B789C*0#D";
+
+int MediaTest_DtmfDetects40msDigits(void)
+{
+	const int digitSamples = 2 * TEST_TONE_MS * TEST_SAMPLES_PER_MS;
+	static short pcm[400 + 16 * 2 * TEST_TONE_MS * TEST_SAMPLES_PER_MS + 800];
+
+	// every alignment of the digits against the 102 sample hop
+	for (int offset = 0; offset < DTMF_BLOCK_SIZE; offset += 7) {
+		int length = offset + 16 * digitSamples + 800;
+		unsigned noise = 12345;
+		for (int i = 0; i < length; i++) {
+			noise = noise * 1103515245 + 12345;
+			pcm[i] = (short)((int)((noise >> 16) & 0x1FF) - 256);      // about -42 dBov of noise
+		}
+		for (int k = 0; k < 16; k++) {
+			short *tone = pcm + offset + k * digitSamples;
+			for (int i = 0; i < TEST_TONE_MS * TEST_SAMPLES_PER_MS; i++)
+				tone[i] += (short)(3000 * sin(2 * M_PI * kRows[k / 4] * i / 8000) + 3000 * sin(2 * M_PI * kColumns[k % 4] * i / 8000));
+		}
+
+		CDtmfDetector detector;
+		char digits[32];
+		int count = 0;
+		for (int i = 0; i < length; i += 160) {
+			int n = length - i < 160 ? length - i : 160;
+			count += detector.Process(pcm + i, n, digits + count, 32 - count);
+		}
+		MEDIA_TEST_CHECK(count == 16);
+		MEDIA_TEST_CHECK(memcmp(digits, kDigits, 16) == 0);
+	}
+	return 0;
+}
@@ -0,0 +1,146 @@
+//
+//  g729_dtx_tests.cpp
+//
+
+#include <math.h>
+#include <vector>
+
+#include "media_test.h"
+
+// G729/va_G729a.c, Dtx.c and Tab_dtx.c have no public header
+extern "C" {
+void va_g729a_init_encoder(void);
+void va_g729a_set_dtx(int enable);
+int va_g729a_encoder(short *speech, unsigned char *bitstream);
+void va_g729a_init_decoder(void);
+void va_g729a_decode_frame(unsigned char *buffer, int length, short *synth_short);
+void G729_SetPtime(int ms);
+int G729_Decode(unsigned char *buffer, int length, int offset, short *synth_short, int bfi);
+void qua_sid_gain(float *ener, int nb_ener, float *enerq, int *idx);
+extern float tab_Sidgain[32];
+}
+
+#define TEST_L_FRAME            80
+
+// Annex B Quant_Energy : -12 dB, 4 dB steps from -4 to 12 dB, 2 dB steps from 16 to 66 dB
+static double ReferenceSidEnergy(int index)
+{
+	return index == 0 ? -12.0 : index <= 6 ? 4.0 * index - 8.0 : 2.0 * index + 4.0;
+}
+
+static int ReferenceSidIndex(double dB)
+{
+	if (dB <= -8.0)
+		return 0;
+	if (dB >= 65.0)
+		return 31;
+	if (dB <= 14.0) {
+		int index = (int)floor((dB + 10.0) / 4.0);
+		return index < 1 ? 1 : index;
+	}
+	int index = (int)floor((dB - 3.0) / 2.0);
+	return index < 6 ? 6 : index;
+}
+
+int MediaTest_G729SidEnergyQuantizer(void)
+{
+	// Annex B floating point tab_Sidgain, 2 * 10^(enerq/20)
+	for (int i = 0; i < 32; i++)
+		MEDIA_TEST_CHECK(fabs(tab_Sidgain[i] - 2.0 * pow(10.0, ReferenceSidEnergy(i) / 20.0)) < 1e-3 * tab_Sidgain[i]);
+
+	// energies between the decision thresholds, the decoder side energy of
+	// one frame is normalized by 1/(4 L_FRAME)
+	for (double dB = -20.1; dB < 80.0; dB += 0.25) {
+		float ener = (float)(4 * TEST_L_FRAME * pow(10.0, dB / 10.0));
+		float enerq;
+		int index;
+		qua_sid_gain(&ener, 0, &enerq, &index);
+		int expected = ReferenceSidIndex(dB);
+		MEDIA_TEST_CHECK(index == expected);
+		MEDIA_TEST_CHECK(enerq == (float)ReferenceSidEnergy(expected));
+	}
+	return 0;
+}
+
+// The comfort noise follows the level of the background noise it replaces.
+static int ComfortNoiseLevel(double amplitude, bool colored, double *difference)
+{
+	short in[TEST_L_FRAME], out[TEST_L_FRAME];
+	unsigned char bitstream[10];
+	unsigned seed = 7;
+	double state = 0, energyIn = 0, energyOut = 0;
+	int sid = 0;
+
+	va_g729a_init_encoder();
+	va_g729a_set_dtx(1);
+	va_g729a_init_decoder();
+	for (int frame = 0; frame < 1500; frame++) {
+		for (int i = 0; i < TEST_L_FRAME; i++) {
+			double g = 0;
+			for (int k = 0; k < 4; k++) {
+				seed = seed * 1103515245 + 12345;
+				g += ((seed >> 8) & 0xFFFF) / 32768.0 - 1.0;
+			}
+			state = colored ? 0.9 * state + 0.3 * g : g;
+			double s = amplitude * state;
+			int n = frame * TEST_L_FRAME + i;
+			if (frame < 50)     // a talk spurt first
+				s += 6000 * sin(2 * M_PI * 300 * n / 8000.0) * sin(2 * M_PI * 3 * n / 8000.0);
+			in[i] = (short)s;
+		}
+		int size = va_g729a_encoder(in, bitstream);
+		va_g729a_decode_frame(bitstream, size, out);
+		sid += size == 2;
+		if (frame > 500 && size != 10) {
+			for (int i = 0; i < TEST_L_FRAME; i++) {
+				energyIn += (double)in[i] * in[i];
+				energyOut += (double)out[i] * out[i];
+			}
+		}
+	}
+	va_g729a_set_dtx(0);
+	*difference = energyIn > 0 ? 10.0 * log10(energyOut / energyIn) : 100.0;
+	return sid;
+}
+
+int MediaTest_G729ComfortNoiseLevel(void)
+{
+	static const double amplitudes[3] = { 30, 300, 1000 };
+	for (int i = 0; i < 3; i++) {
+		for (int colored = 0; colored < 2; colored++) {
+			double difference;
+			int sid = ComfortNoiseLevel(amplitudes[i], colored != 0, &difference);
+#ifdef G729_ANNEX_B
+			// the Annex B normalization keeps the comfort noise a little below the input
+			MEDIA_TEST_CHECK(sid > 0);
+			MEDIA_TEST_CHECK(difference > -5.0 && difference < 1.0);
+#else
+			// DTX is not built, silence is coded as speech
+			MEDIA_TEST_CHECK(sid == 0);
+#endif
+		}
+	}
+	return 0;
+}
+
+// An RTP payload is decoded as received : speech frames, a trailing SID or nothing.
+int MediaTest_G729DecodePayloadLength(void)
+{
+	static const int lengths[5] = { 20, 12, 10, 2, 0 };
+	static const int samples[5] = { 160, 160, 80, 80, 0 };
+	short out[2 * TEST_L_FRAME];
+
+	va_g729a_init_decoder();
+	G729_SetPtime(20);
+	for (int i = 0; i < 5; i++) {
+		// exactly the payload, a longer read is caught by the address sanitizer
+		std::vector<unsigned char> payload(lengths[i]);
+		for (int k = 0; k < lengths[i]; k++)
+			payload[k] = (unsigned char)(37 * k + i);
+		MEDIA_TEST_CHECK(G729_Decode(payload.data(), lengths[i], 0, out, 0) == samples[i]);
+	}
+	// a lost payload conceals the whole ptime
+	unsigned char lost[20] = { 0 };
+	MEDIA_TEST_CHECK(G729_Decode(lost, 0, 0, out, 1) == 2 * TEST_L_FRAME);
+	return 0;
+}
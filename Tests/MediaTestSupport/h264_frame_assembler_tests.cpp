@@ -0,0 +1,125 @@
+//
+//  h264_frame_assembler_tests.cpp
+//
+
+#include <string.h>
+
+#include "media_test.h"
+#include "../../Sources/MediaTransport/H264/h264_frame_assembler.h"
+
+#define TEST_FRAGMENT_SIZE      100
+
+static const uint8_t kSps[] = { 0x67, 0x42, 0xC0, 0x1F, 0xDA };
+static const uint8_t kPps[] = { 0x68, 0xCE, 0x3C, 0x80 };
+static const uint8_t kIdr[] = { 0x65, 0x88, 0x84, 0x00, 0x33 };
+
+// RTP packet of one payload, returns its size
+static size_t BuildPacket(uint8_t *packet, uint16_t seq, uint32_t timestamp, bool marker, const uint8_t *payload, size_t size)
+{
+	packet[0] = 0x80;
+	packet[1] = (uint8_t)((marker ? 0x80 : 0) | 96);
+	packet[2] = (uint8_t)(seq >> 8);
+	packet[3] = (uint8_t)seq;
+	packet[4] = (uint8_t)(timestamp >> 24);
+	packet[5] = (uint8_t)(timestamp >> 16);
+	packet[6] = (uint8_t)(timestamp >> 8);
+	packet[7] = (uint8_t)timestamp;
+	memset(packet + 8, 0x11, 4);
+	memcpy(packet + 12, payload, size);
+	return 12 + size;
+}
+
+static int InsertNalu(CH264FrameAssembler &assembler, uint16_t seq, uint32_t timestamp, bool marker, const uint8_t *nal, size_t size)
+{
+	uint8_t packet[12 + 64];
+	return assembler.Insert(packet, BuildPacket(packet, seq, timestamp, marker, nal, size));
+}
+
+static int InsertFragment(CH264FrameAssembler &assembler, uint16_t seq, uint32_t timestamp, bool start, bool end)
+{
+	uint8_t payload[TEST_FRAGMENT_SIZE], packet[12 + TEST_FRAGMENT_SIZE];
+	memset(payload, seq & 0x7F, sizeof(payload));
+	payload[0] = 0x7C;                  // FU-A, NRI 3
+	payload[1] = (uint8_t)((start ? 0x80 : 0) | (end ? 0x40 : 0) | 5);
+	return assembler.Insert(packet, BuildPacket(packet, seq, timestamp, end, payload, sizeof(payload)));
+}
+
+// SPS, PPS and IDR as single NAL packets, returns the frames completed
+static int InsertKeyframe(CH264FrameAssembler &assembler, uint16_t seq, uint32_t timestamp)
+{
+	InsertNalu(assembler, seq, timestamp, false, kSps, sizeof(kSps));
+	InsertNalu(assembler, (uint16_t)(seq + 1), timestamp, false, kPps, sizeof(kPps));
+	return InsertNalu(assembler, (uint16_t)(seq + 2), timestamp, true, kIdr, sizeof(kIdr));
+}
+
+int MediaTest_H264AssemblerKeyframe(void)
+{
+	CH264FrameAssembler assembler;
+
+	MEDIA_TEST_CHECK(InsertKeyframe(assembler, 65534, 1000) == 1);
+	const H264AssembledFrame &frame = assembler.Frame(0);
+	MEDIA_TEST_CHECK(frame.keyframe && frame.hasParameterSets);
+	MEDIA_TEST_CHECK(frame.firstSequenceNumber == 65534 && frame.lastSequenceNumber == 0);
+	MEDIA_TEST_CHECK(frame.size == 3 * 4 + sizeof(kSps) + sizeof(kPps) + sizeof(kIdr));
+	MEDIA_TEST_CHECK(memcmp(frame.data + 4, kSps, sizeof(kSps)) == 0);
+
+	// an FU-A frame out of order
+	MEDIA_TEST_CHECK(InsertFragment(assembler, 3, 4000, false, true) == 0);
+	MEDIA_TEST_CHECK(InsertFragment(assembler, 2, 4000, false, false) == 0);
+	MEDIA_TEST_CHECK(InsertFragment(assembler, 1, 4000, true, false) == 1);
+	MEDIA_TEST_CHECK(assembler.Frame(0).size == 4 + 1 + 3 * (TEST_FRAGMENT_SIZE - 2));
+	MEDIA_TEST_CHECK(assembler.Frame(0).data[4] == 0x65);
+
+	// a late duplicate
+	MEDIA_TEST_CHECK(InsertFragment(assembler, 2, 4000, false, false) == 0);
+	MEDIA_TEST_CHECK(assembler.DroppedPackets() == 1 && assembler.DroppedFrames() == 0);
+	return 0;
+}
+
+// A frame of more packets than the ring has slots pushes out its own start. It
+// is dropped, and the keyframe after it still comes out.
+int MediaTest_H264AssemblerFrameSpanningRing(void)
+{
+	CH264FrameAssembler assembler;
+	uint16_t seq = 100;
+	int frames = 0;
+
+	frames += InsertNalu(assembler, seq++, 3000, false, kSps, sizeof(kSps));
+	for (int i = 0; i < 1100; i++, seq++)
+		frames += InsertFragment(assembler, seq, 3000, i == 0, i == 1099);
+	MEDIA_TEST_CHECK(frames == 0);
+
+	MEDIA_TEST_CHECK(InsertKeyframe(assembler, seq, 6000) == 1);
+	MEDIA_TEST_CHECK(assembler.Frame(0).firstSequenceNumber == seq && assembler.Frame(0).keyframe);
+
+	// exactly as many packets as slots still fit
+	CH264FrameAssembler small(64);
+	seq = 7;
+	frames = InsertNalu(small, seq++, 9000, false, kSps, sizeof(kSps));
+	for (int i = 0; i < 63; i++, seq++)
+		frames += InsertFragment(small, seq, 9000, i == 0, i == 62);
+	MEDIA_TEST_CHECK(frames == 1);
+	MEDIA_TEST_CHECK(small.Frame(0).firstSequenceNumber == 7 && small.Frame(0).lastSequenceNumber == 70);
+	return 0;
+}
+
+// The first packets of a frame waiting for a lost one are pushed out by packets
+// a ring length later. When the missing one shows up the frame is dropped, and
+// the newer packets are left alone.
+int MediaTest_H264AssemblerEvictedPendingFrame(void)
+{
+	CH264FrameAssembler assembler(64);
+
+	MEDIA_TEST_CHECK(InsertNalu(assembler, 0, 1000, false, kSps, sizeof(kSps)) == 0);
+	MEDIA_TEST_CHECK(InsertFragment(assembler, 1, 1000, true, false) == 0);
+	MEDIA_TEST_CHECK(InsertFragment(assembler, 3, 1000, false, true) == 0);
+
+	MEDIA_TEST_CHECK(InsertNalu(assembler, 64, 5000, false, kSps, sizeof(kSps)) == 0);
+	MEDIA_TEST_CHECK(InsertFragment(assembler, 2, 1000, false, false) == 0);
+	MEDIA_TEST_CHECK(assembler.DroppedFrames() == 1);
+
+	MEDIA_TEST_CHECK(InsertNalu(assembler, 65, 5000, false, kPps, sizeof(kPps)) == 0);
+	MEDIA_TEST_CHECK(InsertNalu(assembler, 66, 5000, true, kIdr, sizeof(kIdr)) == 1);
+	MEDIA_TEST_CHECK(assembler.Frame(0).firstSequenceNumber == 64 && assembler.Frame(0).hasParameterSets);
+	return 0;
+}
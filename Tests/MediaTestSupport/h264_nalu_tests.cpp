@@ -0,0 +1,181 @@
+//
+//  h264_nalu_tests.cpp
+//
+
+#include <string.h>
+#include <vector>
+
+#include "media_test.h"
+#include "h264_nalu.h"
+
+#define TEST_NALU_SIZE          200
+
+// byte at a time findNaluIndices of H264Common.swift, the reference for the scanning one
+static std::vector<H264NaluIndex> ReferenceNaluIndices(const uint8_t *buffer, size_t count)
+{
+	std::vector<H264NaluIndex> indices;
+	if (count < 3)
+		return indices;
+	size_t end = count - 3;
+	size_t i = 0;
+	while (i < end) {
+		if (buffer[i + 2] > 1) {
+			i += 3;
+		} else if (buffer[i + 2] == 1) {
+			if (buffer[i + 1] == 0 && buffer[i] == 0) {
+				H264NaluIndex index = { (uint32_t)i, (uint32_t)i + 3, 0 };
+				if (index.startOffset > 0 && buffer[index.startOffset - 1] == 0)
+					index.startOffset--;
+				if (!indices.empty())
+					indices.back().payloadSize = index.startOffset - indices.back().payloadStartOffset;
+				indices.push_back(index);
+			}
+			i += 3;
+		} else {
+			i += 1;
+		}
+	}
+	if (!indices.empty())
+		indices.back().payloadSize = (uint32_t)count - indices.back().payloadStartOffset;
+	return indices;
+}
+
+static bool SameIndex(const H264NaluIndex &a, const H264NaluIndex &b)
+{
+	return a.startOffset == b.startOffset && a.payloadStartOffset == b.payloadStartOffset &&
+		a.payloadSize == b.payloadSize;
+}
+
+// scanNaluIndices of H264Common.swift : a second scan when the array was too small
+static std::vector<H264NaluIndex> ScanNaluIndices(const uint8_t *buffer, size_t count, int capacity)
+{
+	std::vector<H264NaluIndex> indices(capacity);
+	int found = H264FindNaluIndices(buffer, count, indices.data(), capacity);
+	if (found > capacity) {
+		indices.resize(found);
+		found = H264FindNaluIndices(buffer, count, indices.data(), found);
+	}
+	indices.resize(found);
+	return indices;
+}
+
+static int CheckAgainstReference(const std::vector<uint8_t> &frame)
+{
+	// exactly the frame, a read past it is caught by the address sanitizer
+	std::vector<uint8_t> buffer(frame);
+	std::vector<H264NaluIndex> expected = ReferenceNaluIndices(buffer.data(), buffer.size());
+	std::vector<H264NaluIndex> indices = ScanNaluIndices(buffer.data(), buffer.size(), H264_NALU_INDEX_CAPACITY);
+
+	MEDIA_TEST_CHECK(indices.size() == expected.size());
+	for (size_t i = 0; i < expected.size(); i++)
+		MEDIA_TEST_CHECK(SameIndex(indices[i], expected[i]));
+	return 0;
+}
+
+int MediaTest_H264NaluKnownBytes(void)
+{
+	static const uint8_t frame[] = {
+		0x00, 0x00, 0x00, 0x01, 0x67, 0x42, 0x1E,          // 4 byte start code, SPS
+		0x00, 0x00, 0x01, 0x68, 0xCE,                      // 3 byte start code, PPS
+		0x00, 0x00, 0x00, 0x01, 0x65, 0x88, 0x00, 0x00, 0x03, 0x01,
+		0x00, 0x00, 0x01                                   // in the last 3 bytes, no NAL unit
+	};
+	H264NaluIndex indices[4];
+
+	MEDIA_TEST_CHECK(H264FindNaluIndices(frame, sizeof(frame), indices, 4) == 3);
+	MEDIA_TEST_CHECK(indices[0].startOffset == 0 && indices[0].payloadStartOffset == 4 && indices[0].payloadSize == 3);
+	MEDIA_TEST_CHECK(indices[1].startOffset == 7 && indices[1].payloadStartOffset == 10 && indices[1].payloadSize == 2);
+	MEDIA_TEST_CHECK(indices[2].startOffset == 12 && indices[2].payloadStartOffset == 16 && indices[2].payloadSize == 9);
+
+	// one byte of NAL unit after the last start code
+	MEDIA_TEST_CHECK(H264FindNaluIndices(frame + 7, 4, indices, 4) == 1);
+	MEDIA_TEST_CHECK(indices[0].startOffset == 0 && indices[0].payloadStartOffset == 3 && indices[0].payloadSize == 1);
+	MEDIA_TEST_CHECK(H264FindNaluIndices(frame + 7, 3, indices, 4) == 0);
+	MEDIA_TEST_CHECK(H264FindNaluIndices(frame, 0, indices, 4) == 0);
+	return 0;
+}
+
+// One 3 or 4 byte start code at every offset around the 32 (SSE2, NEON) and
+// 64 (AVX2) byte blocks, in frames ending on and just past the block edges.
+int MediaTest_H264NaluBlockBoundaries(void)
+{
+	static const size_t sizes[] = { 31, 32, 33, 34, 35, 63, 64, 65, 66, 67, 96, 127, 128, 129, 130, 131 };
+	unsigned seed = 5;
+
+	for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+		size_t count = sizes[s];
+		for (int length = 3; length <= 4; length++) {
+			for (size_t at = 0; at + length <= count; at++) {
+				std::vector<uint8_t> frame(count);
+				for (size_t i = 0; i < count; i++) {
+					seed = seed * 1103515245 + 12345;
+					frame[i] = (uint8_t)(2 + (seed >> 16) % 254);      // no zero, no start code
+				}
+				memset(&frame[at], 0, length - 1);
+				frame[at + length - 1] = 1;
+				int line = CheckAgainstReference(frame);
+				if (line)
+					return line;
+				// the same with a second start code one block later
+				if (at + 64 + 3 <= count) {
+					frame[at + 64] = 0;
+					frame[at + 65] = 0;
+					frame[at + 66] = 1;
+					line = CheckAgainstReference(frame);
+					if (line)
+						return line;
+				}
+			}
+		}
+	}
+	return 0;
+}
+
+// Zero heavy random frames : runs of zeros, 00 00 00 01 and 00 00 01 everywhere.
+int MediaTest_H264NaluRandomFrames(void)
+{
+	unsigned seed = 17;
+
+	for (int round = 0; round < 3000; round++) {
+		size_t count = 1 + round % TEST_NALU_SIZE;
+		std::vector<uint8_t> frame(count);
+		for (size_t i = 0; i < count; i++) {
+			seed = seed * 1103515245 + 12345;
+			unsigned r = (seed >> 16) & 0xFF;
+			frame[i] = r < 128 ? 0 : r < 192 ? 1 : (uint8_t)r;
+		}
+		int line = CheckAgainstReference(frame);
+		if (line)
+			return line;
+	}
+	return 0;
+}
+
+// Past capacity nothing more is written, the count tells how many to ask for.
+int MediaTest_H264NaluCapacity(void)
+{
+	const int units = 3 * H264_NALU_INDEX_CAPACITY / 2;
+	std::vector<uint8_t> frame;
+	for (int n = 0; n < units; n++) {
+		static const uint8_t unit[] = { 0x00, 0x00, 0x00, 0x01, 0x41, 0x9A, 0x00, 0x00, 0x01, 0x01, 0x02 };
+		frame.insert(frame.end(), unit, unit + 4 + (n % 3) + 2);
+	}
+	std::vector<H264NaluIndex> expected = ReferenceNaluIndices(frame.data(), frame.size());
+	MEDIA_TEST_CHECK((int)expected.size() > H264_NALU_INDEX_CAPACITY);
+
+	for (int capacity = 0; capacity <= (int)expected.size(); capacity += 7) {
+		std::vector<H264NaluIndex> indices(capacity + 1);
+		H264NaluIndex guard = { 0xDEADBEEF, 0xDEADBEEF, 0xDEADBEEF };
+		indices[capacity] = guard;
+		MEDIA_TEST_CHECK(H264FindNaluIndices(frame.data(), frame.size(), indices.data(), capacity) == (int)expected.size());
+		MEDIA_TEST_CHECK(SameIndex(indices[capacity], guard));
+		for (int i = 0; i < capacity; i++)
+			MEDIA_TEST_CHECK(SameIndex(indices[i], expected[i]));
+	}
+
+	std::vector<H264NaluIndex> indices = ScanNaluIndices(frame.data(), frame.size(), H264_NALU_INDEX_CAPACITY);
+	MEDIA_TEST_CHECK(indices.size() == expected.size());
+	for (size_t i = 0; i < expected.size(); i++)
+		MEDIA_TEST_CHECK(SameIndex(indices[i], expected[i]));
+	return 0;
+}
@@ -0,0 +1,278 @@
+//
+//  h264_parser_tests.cpp
+//
+
+#include <string.h>
+#include <vector>
+
+#include "media_test.h"
+#include "h264_parser.h"
+#include "../../Sources/MediaTransport/H264/h264_bit_reader.h"
+
+// x264, High 4.0, 1920x1088 cropped to 1080, VUI, with an emulation prevention byte
+static const uint8_t kSpsX264[] = {
+	0x67, 0x64, 0x00, 0x28, 0xAC, 0xD9, 0x40, 0x78, 0x02, 0x27, 0xE5, 0xC0, 0x44, 0x00, 0x00, 0x03,
+	0x00, 0x04, 0x00, 0x00, 0x03, 0x00, 0xF0, 0x3C, 0x60, 0xC6, 0x58
+};
+
+// High 4.2, sps_id 1, scaling matrix : list 0 with 16 deltas, list 3 falling back to
+// the default at once, list 6 ending after 3 deltas, list 7 with all 64. frame_num
+// 9 bits, POC type 0 with 8 bit lsb, 120x68 MBs cropped by 4 bottom pairs to 1920x1080
+static const uint8_t kSpsHighScaling[] = {
+	0x67, 0x64, 0x0C, 0x2A, 0x4B, 0x66, 0x28, 0xAA, 0x64, 0xC4, 0x1D, 0x48, 0xD1, 0x08, 0x90, 0xA0,
+	0xB0, 0xDC, 0x8C, 0xD5, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xCD, 0x29, 0x00, 0x78, 0x02,
+	0x27, 0xE5, 0x40
+};
+
+// Baseline 3.0, sps_id 0, frame_num 4 bits, POC type 1 with a 3 frame cycle,
+// 40x23 MBs cropped to 640x360
+static const uint8_t kSpsPocType1[] = {
+	0x67, 0x42, 0xC0, 0x1E, 0xD0, 0xA8, 0x84, 0x20, 0x94, 0x05, 0x01, 0x7F, 0xCA, 0x80
+};
+
+// pps_id 2 on sps 1 : CABAC, bottom field POC present, 3 L0 refs, weighted, qp 23
+static const uint8_t kPpsHigh[] = { 0x68, 0x6B, 0xBE, 0x3C, 0xB2 };
+
+// pps_id 0 on sps 0 : 3 slice groups of map type 0 (run lengths), bottom field POC
+// and redundant_pic_cnt present
+static const uint8_t kPpsSliceGroupsRuns[] = { 0x68, 0xD7, 0x14, 0x06, 0x40, 0x06, 0x69, 0x81, 0x08, 0xDE };
+
+// pps_id 3 on sps 0 : 3 slice groups of map type 2 (rectangles), qp 0, qs 51
+static const uint8_t kPpsSliceGroupsBoxes[] = {
+	0x68, 0x24, 0x6C, 0x15, 0x01, 0xFA, 0x00, 0xE6, 0x14, 0x03, 0x50, 0x64, 0x18, 0x50
+};
+
+// on kSpsHighScaling / kPpsHigh
+static const uint8_t kIdrPocType0[] = { 0x65, 0x88, 0x60, 0x02, 0x00, 0x6A, 0xC0 };
+static const uint8_t kSlicePocType0[] = { 0x41, 0x00, 0x25, 0x89, 0x9C, 0xB2, 0x91, 0xAC };
+
+// on kSpsPocType1 / kPpsSliceGroupsRuns
+static const uint8_t kIdrPocType1[] = { 0x65, 0xB8, 0x00, 0x00, 0x40, 0x00, 0x3C, 0xC0 };
+static const uint8_t kSlicePocType1[] = { 0x01, 0x05, 0x3E, 0x8D, 0x33, 0x98 };
+
+int MediaTest_H264ParseSps(void)
+{
+	H264Sps sps;
+
+	MEDIA_TEST_CHECK(H264ParseSps(kSpsX264, sizeof(kSpsX264), &sps));
+	MEDIA_TEST_CHECK(sps.profileIdc == 100 && sps.levelIdc == 40 && sps.spsId == 0);
+	MEDIA_TEST_CHECK(sps.chromaFormatIdc == 1 && sps.bitDepthLuma == 8 && sps.bitDepthChroma == 8);
+	MEDIA_TEST_CHECK(sps.log2MaxFrameNum == 4 && sps.picOrderCntType == 0 && sps.log2MaxPicOrderCntLsb == 6);
+	MEDIA_TEST_CHECK(sps.maxNumRefFrames == 4 && sps.frameMbsOnly && sps.frameCropping && sps.vuiPresent);
+	MEDIA_TEST_CHECK(sps.widthInMbs == 120 && sps.heightInMapUnits == 68);
+	MEDIA_TEST_CHECK(sps.width == 1920 && sps.height == 1080);
+
+	MEDIA_TEST_CHECK(H264ParseSps(kSpsHighScaling, sizeof(kSpsHighScaling), &sps));
+	MEDIA_TEST_CHECK(sps.profileIdc == 100 && sps.constraintFlags == 0x0C && sps.levelIdc == 42 && sps.spsId == 1);
+	MEDIA_TEST_CHECK(sps.log2MaxFrameNum == 9 && sps.picOrderCntType == 0 && sps.log2MaxPicOrderCntLsb == 8);
+	MEDIA_TEST_CHECK(sps.maxNumRefFrames == 3 && sps.frameMbsOnly && sps.frameCropping && !sps.vuiPresent);
+	MEDIA_TEST_CHECK(sps.widthInMbs == 120 && sps.heightInMapUnits == 68);
+	MEDIA_TEST_CHECK(sps.width == 1920 && sps.height == 1080);
+
+	MEDIA_TEST_CHECK(H264ParseSps(kSpsPocType1, sizeof(kSpsPocType1), &sps));
+	MEDIA_TEST_CHECK(sps.profileIdc == 66 && sps.constraintFlags == 0xC0 && sps.levelIdc == 30);
+	MEDIA_TEST_CHECK(sps.chromaFormatIdc == 1 && sps.bitDepthLuma == 8);
+	MEDIA_TEST_CHECK(sps.log2MaxFrameNum == 4 && sps.picOrderCntType == 1 && !sps.deltaPicOrderAlwaysZero);
+	MEDIA_TEST_CHECK(sps.width == 640 && sps.height == 360);
+
+	// every truncation fails, none reads past the NAL unit
+	for (size_t size = 0; size < sizeof(kSpsHighScaling) - 1; size++) {
+		std::vector<uint8_t> nal(kSpsHighScaling, kSpsHighScaling + size);
+		MEDIA_TEST_CHECK(!H264ParseSps(nal.data(), nal.size(), &sps));
+	}
+	MEDIA_TEST_CHECK(!H264ParseSps(kPpsHigh, sizeof(kPpsHigh), &sps));
+	return 0;
+}
+
+int MediaTest_H264ParsePps(void)
+{
+	H264Pps pps;
+
+	MEDIA_TEST_CHECK(H264ParsePps(kPpsHigh, sizeof(kPpsHigh), &pps));
+	MEDIA_TEST_CHECK(pps.ppsId == 2 && pps.spsId == 1 && pps.entropyCodingMode && pps.bottomFieldPicOrderInFramePresent);
+	MEDIA_TEST_CHECK(pps.numSliceGroups == 1 && pps.numRefIdxL0Default == 3 && pps.numRefIdxL1Default == 1);
+	MEDIA_TEST_CHECK(pps.weightedPred && pps.weightedBipredIdc == 2);
+	MEDIA_TEST_CHECK(pps.picInitQp == 23 && pps.picInitQs == 26 && pps.chromaQpIndexOffset == -2);
+	MEDIA_TEST_CHECK(pps.deblockingFilterControlPresent && !pps.constrainedIntraPred && !pps.redundantPicCntPresent);
+
+	MEDIA_TEST_CHECK(H264ParsePps(kPpsSliceGroupsRuns, sizeof(kPpsSliceGroupsRuns), &pps));
+	MEDIA_TEST_CHECK(pps.ppsId == 0 && pps.spsId == 0 && !pps.entropyCodingMode && pps.bottomFieldPicOrderInFramePresent);
+	MEDIA_TEST_CHECK(pps.numSliceGroups == 3 && pps.numRefIdxL0Default == 1 && pps.numRefIdxL1Default == 1);
+	MEDIA_TEST_CHECK(pps.picInitQp == 30 && pps.picInitQs == 27 && pps.chromaQpIndexOffset == 3);
+	MEDIA_TEST_CHECK(pps.deblockingFilterControlPresent && pps.constrainedIntraPred && pps.redundantPicCntPresent);
+
+	MEDIA_TEST_CHECK(H264ParsePps(kPpsSliceGroupsBoxes, sizeof(kPpsSliceGroupsBoxes), &pps));
+	MEDIA_TEST_CHECK(pps.ppsId == 3 && pps.spsId == 0 && pps.numSliceGroups == 3);
+	MEDIA_TEST_CHECK(pps.numRefIdxL0Default == 2 && pps.numRefIdxL1Default == 1);
+	MEDIA_TEST_CHECK(pps.picInitQp == 0 && pps.picInitQs == 51 && pps.chromaQpIndexOffset == 12);
+	MEDIA_TEST_CHECK(!pps.deblockingFilterControlPresent && pps.constrainedIntraPred && !pps.redundantPicCntPresent);
+
+	for (size_t size = 0; size < sizeof(kPpsSliceGroupsBoxes) - 1; size++) {
+		std::vector<uint8_t> nal(kPpsSliceGroupsBoxes, kPpsSliceGroupsBoxes + size);
+		MEDIA_TEST_CHECK(!H264ParsePps(nal.data(), nal.size(), &pps));
+	}
+	return 0;
+}
+
+int MediaTest_H264ParseSliceHeader(void)
+{
+	H264ParameterSets sets;
+	H264SliceHeader header;
+
+	H264ParameterSetsReset(&sets);
+	MEDIA_TEST_CHECK(!H264ParseSliceHeaderWith(&sets, kIdrPocType0, sizeof(kIdrPocType0), &header));
+	MEDIA_TEST_CHECK(H264ParameterSetsUpdate(&sets, kSpsHighScaling, sizeof(kSpsHighScaling)));
+	MEDIA_TEST_CHECK(H264ParameterSetsUpdate(&sets, kSpsPocType1, sizeof(kSpsPocType1)));
+	MEDIA_TEST_CHECK(H264ParameterSetsUpdate(&sets, kPpsHigh, sizeof(kPpsHigh)));
+	MEDIA_TEST_CHECK(H264ParameterSetsUpdate(&sets, kPpsSliceGroupsRuns, sizeof(kPpsSliceGroupsRuns)));
+	MEDIA_TEST_CHECK(!H264ParameterSetsUpdate(&sets, kIdrPocType0, sizeof(kIdrPocType0)));
+
+	// POC type 0, IDR and P
+	MEDIA_TEST_CHECK(H264ParseSliceHeaderWith(&sets, kIdrPocType0, sizeof(kIdrPocType0), &header));
+	MEDIA_TEST_CHECK(header.idr && header.nalUnitType == 5 && header.nalRefIdc == 3);
+	MEDIA_TEST_CHECK(header.firstMbInSlice == 0 && header.sliceType == 2 && header.ppsId == 2);
+	MEDIA_TEST_CHECK(header.frameNum == 0 && header.idrPicId == 3);
+	MEDIA_TEST_CHECK(header.picOrderCntLsb == 0 && header.deltaPicOrderCntBottom == 0);
+
+	MEDIA_TEST_CHECK(H264ParseSliceHeaderWith(&sets, kSlicePocType0, sizeof(kSlicePocType0), &header));
+	MEDIA_TEST_CHECK(!header.idr && header.nalUnitType == 1 && header.nalRefIdc == 2);
+	MEDIA_TEST_CHECK(header.firstMbInSlice == 1200 && header.sliceType == 0 && header.ppsId == 2);
+	MEDIA_TEST_CHECK(header.frameNum == 300 && header.picOrderCntLsb == 0xA4 && header.deltaPicOrderCntBottom == -1);
+
+	// POC type 1, IDR and P, with redundant_pic_cnt
+	MEDIA_TEST_CHECK(H264ParseSliceHeaderWith(&sets, kIdrPocType1, sizeof(kIdrPocType1), &header));
+	MEDIA_TEST_CHECK(header.idr && header.nalRefIdc == 3 && header.sliceType == 2 && header.ppsId == 0);
+	MEDIA_TEST_CHECK(header.frameNum == 0 && header.idrPicId == 65535);
+	MEDIA_TEST_CHECK(header.deltaPicOrderCnt[0] == 0 && header.deltaPicOrderCnt[1] == 0 && header.redundantPicCnt == 0);
+
+	MEDIA_TEST_CHECK(H264ParseSliceHeaderWith(&sets, kSlicePocType1, sizeof(kSlicePocType1), &header));
+	MEDIA_TEST_CHECK(!header.idr && header.nalRefIdc == 0 && header.firstMbInSlice == 40 && header.sliceType == 0);
+	MEDIA_TEST_CHECK(header.frameNum == 13 && header.deltaPicOrderCnt[0] == -6 && header.deltaPicOrderCnt[1] == 3);
+	MEDIA_TEST_CHECK(header.redundantPicCnt == 2);
+
+	// a slice with a parameter set that does not match
+	MEDIA_TEST_CHECK(!H264ParseSliceHeader(kSlicePocType1, sizeof(kSlicePocType1), &sets.sps[1], &sets.pps[0], &header));
+	return 0;
+}
+
+// ue(v) up to 31 leading zeros, on and off the cache refill, and reads past the end.
+int MediaTest_H264BitReaderLimits(void)
+{
+	// 31 zeros, 1, 31 ones : 2^32 - 2, the largest ue(v)
+	static const uint8_t largest[] = { 0x00, 0x00, 0x00, 0x01, 0xFF, 0xFF, 0xFF, 0xFF };
+	{
+		CH264BitReader br(largest, sizeof(largest));
+		MEDIA_TEST_CHECK(br.ReadUe() == 0xFFFFFFFEu);
+		MEDIA_TEST_CHECK(br.ReadFlag() && !br.Overrun() && br.BitsLeft() == 0);
+		br.ReadFlag();
+		MEDIA_TEST_CHECK(br.Overrun());
+	}
+
+	// 10101, then 31 zeros, 1, 0x2AAAAAAA in 31 bits, a 1 and padding
+	static const uint8_t shifted[] = { 0xA8, 0x00, 0x00, 0x00, 0x0A, 0xAA, 0xAA, 0xAA, 0xA8 };
+	{
+		CH264BitReader br(shifted, sizeof(shifted));
+		MEDIA_TEST_CHECK(br.ReadBits(5) == 0x15);
+		MEDIA_TEST_CHECK(br.ReadUe() == 0x7FFFFFFFu + 0x2AAAAAAAu);
+		MEDIA_TEST_CHECK(br.ReadFlag() && br.ReadBits(3) == 0 && !br.Overrun());
+	}
+
+	// 32 leading zeros do not make a ue(v)
+	static const uint8_t tooLong[] = { 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00 };
+	{
+		CH264BitReader br(tooLong, sizeof(tooLong));
+		MEDIA_TEST_CHECK(br.ReadUe() == 0 && br.Overrun());
+	}
+
+	// a code cut by the end of the data, and nothing left at all
+	static const uint8_t truncated[] = { 0x80, 0x01 };
+	{
+		CH264BitReader br(truncated, sizeof(truncated));
+		MEDIA_TEST_CHECK(br.ReadUe() == 0 && !br.Overrun());
+		MEDIA_TEST_CHECK(br.ReadUe() == 0 && br.Overrun());
+		MEDIA_TEST_CHECK(br.ReadUe() == 0 && br.Overrun());
+	}
+	{
+		CH264BitReader br(truncated, 1);
+		MEDIA_TEST_CHECK(br.ReadUe() == 0 && !br.Overrun() && br.BitsLeft() == 7);
+		br.SkipBits(8);
+		MEDIA_TEST_CHECK(br.Overrun());
+	}
+	{
+		CH264BitReader br(truncated, 0);
+		MEDIA_TEST_CHECK(br.BitsLeft() == 0);
+		MEDIA_TEST_CHECK(br.ReadBits(1) == 0 && br.Overrun());
+	}
+	return 0;
+}
+
+// MSB first writer of 9.1, the reference the reader is checked against
+struct TestBitWriter {
+	std::vector<uint8_t> data;
+	size_t bits = 0;
+
+	void Put(uint64_t value, int n)
+	{
+		for (int i = n - 1; i >= 0; i--, bits++) {
+			if ((bits & 7) == 0)
+				data.push_back(0);
+			if ((value >> i) & 1)
+				data.back() |= (uint8_t)(0x80 >> (bits & 7));
+		}
+	}
+	void PutUe(uint32_t value)
+	{
+		uint64_t v = (uint64_t)value + 1;
+		int n = 0;
+		while ((v >> n) > 1)
+			n++;
+		Put(0, n);
+		Put(v, n + 1);
+	}
+	void PutSe(int32_t value)
+	{
+		PutUe(value > 0 ? 2 * (uint32_t)value - 1 : 2 * (uint32_t)-value);
+	}
+};
+
+// Random mixes of u(n), ue(v) and se(v), so every code length lands on every
+// cache position.
+int MediaTest_H264BitReaderRoundTrip(void)
+{
+	unsigned seed = 3;
+
+	for (int round = 0; round < 300; round++) {
+		struct Code { int kind; int n; uint32_t value; };
+		std::vector<Code> codes;
+		TestBitWriter writer;
+		for (int i = 0; i < 200; i++) {
+			seed = seed * 1103515245 + 12345;
+			Code code;
+			code.kind = (seed >> 8) % 3;
+			code.n = 1 + (seed >> 12) % 32;
+			seed = seed * 1103515245 + 12345;
+			uint32_t r = (seed >> 1) ^ (seed << 17);
+			code.value = code.n == 32 ? r : r & ((1u << code.n) - 1);
+			if (code.kind == 0)
+				writer.Put(code.value, code.n);
+			else if (code.kind == 1)
+				writer.PutUe(code.value == 0xFFFFFFFFu ? 0 : code.value);
+			else
+				writer.PutSe((int32_t)(code.value >> 1) * ((code.value & 1) ? -1 : 1));
+			codes.push_back(code);
+		}
+
+		CH264BitReader br(writer.data.data(), writer.data.size());
+		for (size_t i = 0; i < codes.size(); i++) {
+			const Code &code = codes[i];
+			if (code.kind == 0)
+				MEDIA_TEST_CHECK(br.ReadBits(code.n) == code.value);
+			else if (code.kind == 1)
+				MEDIA_TEST_CHECK(br.ReadUe() == (code.value == 0xFFFFFFFFu ? 0 : code.value));
+			else
+				MEDIA_TEST_CHECK(br.ReadSe() == (int32_t)(code.value >> 1) * ((code.value & 1) ? -1 : 1));
+		}
+		MEDIA_TEST_CHECK(!br.Overrun() && br.BitsLeft() == writer.data.size() * 8 - writer.bits);
+	}
+	return 0;
+}
@@ -0,0 +1,83 @@
+//
+//  h264_rbsp_tests.cpp
+//
+
+#include <string.h>
+
+#include "media_test.h"
+#include "h264_rbsp.h"
+
+#define TEST_RBSP_SIZE          300
+
+// byte at a time escape of 7.4.1, the reference for the scanning one
+static size_t ReferenceEscape(uint8_t *dst, const uint8_t *rbsp, size_t count)
+{
+	size_t out = 0;
+	int zeros = 0;
+
+	for (size_t i = 0; i < count; i++) {
+		if (zeros >= 2 && rbsp[i] <= 3) {
+			dst[out++] = 3;
+			zeros = 0;
+		}
+		dst[out++] = rbsp[i];
+		zeros = rbsp[i] == 0 ? zeros + 1 : 0;
+	}
+	if (zeros >= 2)
+		dst[out++] = 3;
+	return out;
+}
+
+int MediaTest_H264RbspKnownBytes(void)
+{
+	static const uint8_t rbsp[] = { 0x67, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x04, 0x00, 0x00 };
+	static const uint8_t escaped[] = { 0x67, 0x00, 0x00, 0x03, 0x01, 0x00, 0x00, 0x03, 0x00, 0x00, 0x03, 0x00, 0x03,
+		0x00, 0x00, 0x04, 0x00, 0x00, 0x03 };
+	uint8_t buffer[H264_ESCAPED_SIZE_MAX(sizeof(rbsp))];
+
+	MEDIA_TEST_CHECK(H264EscapedSize(rbsp, sizeof(rbsp)) == sizeof(escaped));
+	MEDIA_TEST_CHECK(H264EscapeRbsp(buffer, sizeof(buffer), rbsp, sizeof(rbsp)) == sizeof(escaped));
+	MEDIA_TEST_CHECK(memcmp(buffer, escaped, sizeof(escaped)) == 0);
+	MEDIA_TEST_CHECK(H264EscapeRbsp(buffer, sizeof(escaped) - 1, rbsp, sizeof(rbsp)) == 0);
+	MEDIA_TEST_CHECK(H264EscapeRbsp(buffer, sizeof(buffer), rbsp, 0) == 0);
+
+	// in place
+	memcpy(buffer, escaped, sizeof(escaped));
+	MEDIA_TEST_CHECK(H264UnescapeRbsp(buffer, buffer, sizeof(escaped)) == sizeof(rbsp));
+	MEDIA_TEST_CHECK(memcmp(buffer, rbsp, sizeof(rbsp)) == 0);
+	return 0;
+}
+
+// Zero heavy random RBSPs of every length up to a few SIMD blocks, with the
+// 00 00 runs landing on every alignment.
+int MediaTest_H264RbspRoundTrip(void)
+{
+	uint8_t rbsp[TEST_RBSP_SIZE], escaped[H264_ESCAPED_SIZE_MAX(TEST_RBSP_SIZE)];
+	uint8_t reference[H264_ESCAPED_SIZE_MAX(TEST_RBSP_SIZE)], scratch[H264_ESCAPED_SIZE_MAX(TEST_RBSP_SIZE)];
+	unsigned seed = 11;
+
+	for (int round = 0; round < 4000; round++) {
+		size_t count = 1 + round % TEST_RBSP_SIZE;
+		int density = 1 + round % 7;
+		for (size_t i = 0; i < count; i++) {
+			seed = seed * 1103515245 + 12345;
+			int r = (seed >> 16) & 0xFF;
+			rbsp[i] = r % 8 < density ? 0 : r % 4 == 0 ? (uint8_t)(r & 3) : (uint8_t)r;
+		}
+
+		size_t size = ReferenceEscape(reference, rbsp, count);
+		MEDIA_TEST_CHECK(H264EscapedSize(rbsp, count) == size);
+		MEDIA_TEST_CHECK(H264EscapeRbsp(escaped, sizeof(escaped), rbsp, count) == size);
+		MEDIA_TEST_CHECK(memcmp(escaped, reference, size) == 0);
+
+		H264RbspView view = H264RbspViewOf(escaped, size, scratch);
+		MEDIA_TEST_CHECK(view.copied == (size != count));
+		MEDIA_TEST_CHECK(view.data == (view.copied ? scratch : escaped));
+		MEDIA_TEST_CHECK(view.size == count);
+		MEDIA_TEST_CHECK(memcmp(view.data, rbsp, count) == 0);
+
+		MEDIA_TEST_CHECK(H264UnescapeRbsp(escaped, escaped, size) == count);
+		MEDIA_TEST_CHECK(memcmp(escaped, rbsp, count) == 0);
+	}
+	return 0;
+}
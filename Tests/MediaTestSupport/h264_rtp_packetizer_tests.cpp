@@ -0,0 +1,249 @@
+//
+//  h264_rtp_packetizer_tests.cpp
+//
+
+#include <string.h>
+#include <vector>
+
+#include "media_test.h"
+#include "../../Sources/MediaTransport/H264/h264_rtp_packetizer.h"
+#include "../../Sources/MediaTransport/H264/h264_frame_assembler.h"
+
+#define TEST_TYPE_STAPA         24
+#define TEST_TYPE_FUA           28
+
+typedef std::vector<std::vector<uint8_t> > TestNalus;
+
+// NAL unit of size bytes with no zero byte, so no start code shows up inside
+static std::vector<uint8_t> Nalu(uint8_t header, size_t size, unsigned seed)
+{
+	std::vector<uint8_t> nal(size);
+	nal[0] = header;
+	for (size_t i = 1; i < size; i++) {
+		seed = seed * 1103515245 + 12345;
+		nal[i] = (uint8_t)(1 + (seed >> 16) % 255);
+	}
+	return nal;
+}
+
+static std::vector<uint8_t> AnnexB(const TestNalus &nalus)
+{
+	std::vector<uint8_t> frame;
+	for (size_t i = 0; i < nalus.size(); i++) {
+		static const uint8_t startCode[4] = { 0, 0, 0, 1 };
+		frame.insert(frame.end(), startCode, startCode + 4);
+		frame.insert(frame.end(), nalus[i].begin(), nalus[i].end());
+	}
+	return frame;
+}
+
+struct TestRoundTrip {
+	std::vector<int> payloadSizes;
+	std::vector<int> types;             // payload type of each packet : NAL type, 24 or 28
+};
+
+// Packetizes frame, checks every packet against the limits and sends them through
+// the assembler, which has to give back the frame with the same NAL units.
+static int RoundTrip(CH264RtpPacketizer &packetizer, CH264FrameAssembler &assembler,
+                     const TestNalus &nalus, uint32_t timestamp, const H264PayloadSizeLimits &limits,
+                     TestRoundTrip *result)
+{
+	std::vector<uint8_t> frame = AnnexB(nalus);
+	int count = packetizer.Packetize(frame.data(), frame.size(), timestamp);
+	MEDIA_TEST_CHECK(count > 0);
+
+	result->payloadSizes.clear();
+	result->types.clear();
+	for (int i = 0; i < count; i++) {
+		struct iovec iov[H264_RTP_MAX_IOV];
+		uint8_t packet[H264_RTP_HEADER_SIZE + 1500];
+		size_t size = 0;
+		int n = packetizer.PacketIov(i, iov);
+		for (int k = 0; k < n; k++) {
+			MEDIA_TEST_CHECK(size + iov[k].iov_len <= sizeof(packet));
+			memcpy(packet + size, iov[k].iov_base, iov[k].iov_len);
+			size += iov[k].iov_len;
+		}
+		MEDIA_TEST_CHECK(size == packetizer.PacketSize(i));
+
+		int payload = (int)size - H264_RTP_HEADER_SIZE;
+		int room = limits.maxPayloadLength;
+		if (count == 1)
+			room -= limits.singlePacketReductionLength;
+		else if (i == 0)
+			room -= limits.firstPacketReductionLength;
+		else if (i == count - 1)
+			room -= limits.lastPacketReductionLength;
+		MEDIA_TEST_CHECK(payload <= room);
+		MEDIA_TEST_CHECK(((packet[1] & 0x80) != 0) == (i == count - 1));
+		result->payloadSizes.push_back(payload);
+		result->types.push_back(packet[H264_RTP_HEADER_SIZE] & 0x1F);
+
+		int completed = assembler.Insert(packet, size);
+		MEDIA_TEST_CHECK(completed == (i == count - 1 ? 1 : 0));
+	}
+
+	const H264AssembledFrame &assembled = assembler.Frame(0);
+	MEDIA_TEST_CHECK(assembled.timestamp == timestamp);
+	MEDIA_TEST_CHECK(assembled.size == frame.size());
+	MEDIA_TEST_CHECK(memcmp(assembled.data, frame.data(), frame.size()) == 0);
+	MEDIA_TEST_CHECK(assembler.DroppedPackets() == 0 && assembler.DroppedFrames() == 0);
+	return 0;
+}
+
+static TestNalus Keyframe(size_t idrSize)
+{
+	TestNalus nalus;
+	nalus.push_back(Nalu(0x67, 12, 1));
+	nalus.push_back(Nalu(0x68, 4, 2));
+	nalus.push_back(Nalu(0x65, idrSize, 3));
+	return nalus;
+}
+
+static int CountType(const TestRoundTrip &result, int type)
+{
+	int n = 0;
+	for (size_t i = 0; i < result.types.size(); i++)
+		n += result.types[i] == type;
+	return n;
+}
+
+// Single NAL (mode 0 and a NAL unit alone), STAP-A and FU-A packets, each
+// coming out of the assembler as the frame that went in.
+int MediaTest_H264PacketizerPaths(void)
+{
+	H264PayloadSizeLimits limits;
+	TestRoundTrip result;
+
+	// mode 0 : one packet per NAL unit
+	{
+		CH264RtpPacketizer packetizer(96, 0x1234, 65533, kH264SingleNalUnit);
+		CH264FrameAssembler assembler;
+		int line = RoundTrip(packetizer, assembler, Keyframe(900), 3000, limits, &result);
+		if (line)
+			return line;
+		MEDIA_TEST_CHECK(result.types.size() == 3);
+		MEDIA_TEST_CHECK(result.types[0] == 7 && result.types[1] == 8 && result.types[2] == 5);
+		// too large for mode 0
+		std::vector<uint8_t> frame = AnnexB(Keyframe(1300));
+		MEDIA_TEST_CHECK(packetizer.Packetize(frame.data(), frame.size(), 6000) == 0);
+	}
+
+	// mode 1 : SPS and PPS aggregated, the IDR alone, then fragmented
+	CH264RtpPacketizer packetizer(96, 0x1234, 65533);
+	CH264FrameAssembler assembler;
+	int line = RoundTrip(packetizer, assembler, Keyframe(1190), 3000, limits, &result);
+	if (line)
+		return line;
+	MEDIA_TEST_CHECK(result.types.size() == 2);
+	MEDIA_TEST_CHECK(result.types[0] == TEST_TYPE_STAPA && result.types[1] == 5);
+
+	line = RoundTrip(packetizer, assembler, Keyframe(5000), 6000, limits, &result);
+	if (line)
+		return line;
+	MEDIA_TEST_CHECK(result.types[0] == TEST_TYPE_STAPA);
+	MEDIA_TEST_CHECK(CountType(result, TEST_TYPE_FUA) == 5);
+
+	// all of a frame of small slices in one STAP-A
+	TestNalus slices;
+	for (int i = 0; i < 6; i++)
+		slices.push_back(Nalu(0x41, 100 + i, 10 + i));
+	line = RoundTrip(packetizer, assembler, slices, 9000, limits, &result);
+	if (line)
+		return line;
+	MEDIA_TEST_CHECK(result.types.size() == 1 && result.types[0] == TEST_TYPE_STAPA);
+	MEDIA_TEST_CHECK(result.payloadSizes[0] == 1 + 6 * 2 + 6 * 100 + 15);
+	return 0;
+}
+
+// Each of the four reductions of H264PayloadSizeLimits on its own and all of them
+// together, for a frame of one NAL unit, a keyframe and a frame of small slices,
+// across packet counts.
+int MediaTest_H264PacketizerSizeLimits(void)
+{
+	CH264RtpPacketizer packetizer(96, 0x5678, 100);
+	CH264FrameAssembler assembler;
+	TestRoundTrip result;
+	uint32_t timestamp = 0;
+
+	for (int reduction = 0; reduction < 5; reduction++) {
+		H264PayloadSizeLimits limits;
+		limits.maxPayloadLength = 500;
+		if (reduction == 0 || reduction == 4)
+			limits.firstPacketReductionLength = 50;
+		if (reduction == 1 || reduction == 4)
+			limits.lastPacketReductionLength = 70;
+		if (reduction == 2 || reduction == 4)
+			limits.singlePacketReductionLength = 90;
+		if (reduction == 3)
+			limits.maxPayloadLength = 300;
+		packetizer.SetLimits(limits);
+
+		for (size_t size = 380; size < 1700; size += 37) {
+			// a keyframe first, so the assembler finds where the lone IDR frame starts
+			int line = RoundTrip(packetizer, assembler, Keyframe(size), timestamp += 3000, limits, &result);
+			if (line)
+				return line;
+			TestNalus alone;
+			alone.push_back(Nalu(0x65, size, (unsigned)size));
+			line = RoundTrip(packetizer, assembler, alone, timestamp += 3000, limits, &result);
+			if (line)
+				return line;
+			// a single NAL unit packet only when it fits with the single packet reduction
+			bool single = (int)size <= limits.maxPayloadLength - limits.singlePacketReductionLength;
+			MEDIA_TEST_CHECK((result.types.size() == 1) == single);
+			MEDIA_TEST_CHECK(single || CountType(result, TEST_TYPE_FUA) == (int)result.types.size());
+		}
+
+		// STAP-A runs filling the first, middle and last packets to the limits
+		for (size_t size = 20; size < 320; size += 9) {
+			TestNalus slices;
+			for (int i = 0; i < 7; i++)
+				slices.push_back(Nalu(0x41, size + i * 5, (unsigned)(size + i)));
+			int line = RoundTrip(packetizer, assembler, slices, timestamp += 3000, limits, &result);
+			if (line)
+				return line;
+		}
+	}
+	return 0;
+}
+
+// With aggregation off every NAL unit that fits goes alone, as RTPPacketizerH264.swift
+// does, and a larger one is split by seperateEqually : payloads one byte apart at most.
+int MediaTest_H264PacketizerNoAggregation(void)
+{
+	CH264RtpPacketizer packetizer(96, 0x9ABC, 4000);
+	CH264FrameAssembler assembler;
+	H264PayloadSizeLimits limits;
+	TestRoundTrip result;
+	std::vector<int> sizes;
+
+	packetizer.SetAggregation(false);
+	int line = RoundTrip(packetizer, assembler, Keyframe(700), 3000, limits, &result);
+	if (line)
+		return line;
+	MEDIA_TEST_CHECK(result.types.size() == 3);
+	MEDIA_TEST_CHECK(result.types[0] == 7 && result.types[1] == 8 && result.types[2] == 5);
+
+	for (size_t size = 1201; size < 6000; size += 311) {
+		line = RoundTrip(packetizer, assembler, Keyframe(size), 3000 + (uint32_t)size, limits, &result);
+		if (line)
+			return line;
+		MEDIA_TEST_CHECK(result.types[0] == 7 && result.types[1] == 8);
+
+		// the IDR is the last NAL unit of the frame, its FU-A split is seperateEqually's
+		H264PayloadSizeLimits fuLimits = limits;
+		fuLimits.maxPayloadLength -= H264_FUA_HEADER_SIZE;
+		H264SeparateEqually(sizes, (int)size - H264_NAL_HEADER_SIZE, fuLimits);
+		MEDIA_TEST_CHECK(result.types.size() == 2 + sizes.size());
+		int smallest = sizes[0], largest = sizes[0];
+		for (size_t i = 0; i < sizes.size(); i++) {
+			MEDIA_TEST_CHECK(result.types[2 + i] == TEST_TYPE_FUA);
+			MEDIA_TEST_CHECK(result.payloadSizes[2 + i] == H264_FUA_HEADER_SIZE + sizes[i]);
+			smallest = sizes[i] < smallest ? sizes[i] : smallest;
+			largest = sizes[i] > largest ? sizes[i] : largest;
+		}
+		MEDIA_TEST_CHECK(largest - smallest <= 1);
+	}
+	return 0;
+}
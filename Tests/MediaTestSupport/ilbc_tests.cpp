@@ -0,0 +1,132 @@
+//
+//  ilbc_tests.cpp
+//
+
+#include <math.h>
+#include <string.h>
+
+#include "media_test.h"
+
+extern "C" {
+#include "../../Sources/AudioCodecs/iLBC/iLBC_Codec.h"
+}
+
+#define TEST_FRAMES             40
+#define TEST_BLOCKL_MAX         240
+
+static void Speech(short *pcm, int length, int start)
+{
+	for (int i = 0; i < length; i++) {
+		int n = start + i;
+		pcm[i] = (short)(4000 * sin(2 * M_PI * 210 * n / 8000.0) * (1.2 + sin(2 * M_PI * 3 * n / 8000.0))
+		               + 1500 * sin(2 * M_PI * 1170 * n / 8000.0));
+	}
+}
+
+struct TestStream {
+	iLBC_Codec_Inst_t inst;
+	short rtp[TEST_FRAMES][6 + 25];     // RTP header and 30 ms payload, in shorts
+	short out[TEST_FRAMES][TEST_BLOCKL_MAX];
+	int bytes[TEST_FRAMES];
+};
+
+static void Setup(TestStream *stream, int mode, int fixed)
+{
+	memset(stream, 0, sizeof(*stream));
+	iLBC_InitInst(&stream->inst);
+	iLBC_SetMode(&stream->inst, mode);
+	iLBC_SetFixedPoint(&stream->inst, fixed);
+	stream->inst.ssrc = 1000 + mode + fixed;
+}
+
+static void Step(TestStream *stream, int frame)
+{
+	short pcm[TEST_BLOCKL_MAX];
+	int blockl = iLBC_GetMode(&stream->inst) * 8;
+	Speech(pcm, blockl, frame * blockl);
+	stream->bytes[frame] = iLBC_Encode(&stream->inst, pcm, stream->rtp[frame], 97);
+	iLBC_Decode(&stream->inst, stream->rtp[frame], stream->out[frame]);
+}
+
+// Two streams in different modes coded in turn give what each gives alone.
+int MediaTest_iLBCStreamsIndependent(void)
+{
+	static TestStream alone[2], mixed[2];
+	static const int modes[2] = { 20, 30 };
+
+	for (int s = 0; s < 2; s++) {
+		Setup(&alone[s], modes[s], s);
+		for (int frame = 0; frame < TEST_FRAMES; frame++)
+			Step(&alone[s], frame);
+		Setup(&mixed[s], modes[s], s);
+	}
+	for (int frame = 0; frame < TEST_FRAMES; frame++) {
+		Step(&mixed[0], frame);
+		Step(&mixed[1], frame);
+	}
+
+	for (int s = 0; s < 2; s++) {
+		MEDIA_TEST_CHECK(iLBC_GetMode(&mixed[s].inst) == modes[s]);
+		MEDIA_TEST_CHECK(mixed[s].bytes[0] == (modes[s] == 20 ? 38 : 50));
+		MEDIA_TEST_CHECK(memcmp(alone[s].rtp, mixed[s].rtp, sizeof(alone[s].rtp)) == 0);
+		MEDIA_TEST_CHECK(memcmp(alone[s].out, mixed[s].out, sizeof(alone[s].out)) == 0);
+		// each stream numbers its own packets
+		for (int frame = 1; frame < TEST_FRAMES; frame++) {
+			const unsigned char *previous = (const unsigned char *)mixed[s].rtp[frame - 1];
+			const unsigned char *header = (const unsigned char *)mixed[s].rtp[frame];
+			MEDIA_TEST_CHECK(((header[2] << 8) | header[3]) == ((previous[2] << 8) | previous[3]) + 1);
+		}
+	}
+	return 0;
+}
+
+static double Snr(double signal, double noise)
+{
+	return noise > 0 ? 10.0 * log10(signal / noise) : 100.0;
+}
+
+// A stream coded with one implementation decodes with the other : the fixed
+// point decoder follows the float one (enhancer off) in 20 and 30 ms mode.
+// Every frame is received, the two concealments are not expected to agree.
+int MediaTest_iLBCFixedFloatInterop(void)
+{
+	static iLBC_Codec_Inst_t encoder, floatDecoder, fixedDecoder;
+	static const int modes[2] = { 20, 30 };
+	short pcm[TEST_BLOCKL_MAX], rtp[6 + 25];
+	short floatOut[TEST_BLOCKL_MAX], fixedOut[TEST_BLOCKL_MAX];
+
+	for (int m = 0; m < 2; m++) {
+		for (int fixedEncoder = 0; fixedEncoder < 2; fixedEncoder++) {
+			iLBC_InitInst(&encoder);
+			iLBC_SetMode(&encoder, modes[m]);
+			iLBC_SetFixedPoint(&encoder, fixedEncoder);
+			iLBC_InitInst(&floatDecoder);
+			iLBC_SetMode(&floatDecoder, modes[m]);
+			iLBC_SetEnhancer(&floatDecoder, 0);
+			iLBC_InitInst(&fixedDecoder);
+			iLBC_SetMode(&fixedDecoder, modes[m]);
+			iLBC_SetFixedPoint(&fixedDecoder, 1);
+
+			int blockl = modes[m] * 8;
+			double signal = 0, noise = 0;
+			for (int frame = 0; frame < 3 * TEST_FRAMES; frame++) {
+				Speech(pcm, blockl, frame * blockl);
+				iLBC_Encode(&encoder, pcm, rtp, 97);
+				MEDIA_TEST_CHECK(iLBC_Decode(&floatDecoder, rtp, floatOut) == blockl);
+				MEDIA_TEST_CHECK(iLBC_Decode(&fixedDecoder, rtp, fixedOut) == blockl);
+
+				double frameSignal = 0, frameNoise = 0;
+				for (int i = 0; i < blockl; i++) {
+					double error = fixedOut[i] - floatOut[i];
+					frameSignal += (double)floatOut[i] * floatOut[i];
+					frameNoise += error * error;
+				}
+				MEDIA_TEST_CHECK(Snr(frameSignal, frameNoise) > 25.0);
+				signal += frameSignal;
+				noise += frameNoise;
+			}
+			MEDIA_TEST_CHECK(Snr(signal, noise) > 36.0);
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,77 @@
+//
+//  MediaTestSupport.h
+//
+
+#ifndef MediaTestSupport_h
+#define MediaTestSupport_h
+
+// C++ checks of the AudioCodecs and MediaTransport internals for MediaTests.
+// Each returns 0 on success or the source line of the first failed check.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Mixer
+int MediaTest_AudioMixerMixMinus(void);
+int MediaTest_AudioMixerTopSpeakers(void);
+
+// AudioLevel
+int MediaTest_ActiveSpeakerWithoutVoiceBit(void);
+int MediaTest_ActiveSpeakerVoiceGate(void);
+int MediaTest_AudioLevelShortPacket(void);
+
+// G.729 Annex B
+int MediaTest_G729SidEnergyQuantizer(void);
+int MediaTest_G729ComfortNoiseLevel(void);
+int MediaTest_G729DecodePayloadLength(void);
+
+// iLBC
+int MediaTest_iLBCStreamsIndependent(void);
+int MediaTest_iLBCFixedFloatInterop(void);
+
+// Dtmf
+int MediaTest_DtmfDetects40msDigits(void);
+
+// H.264
+int MediaTest_H264RbspKnownBytes(void);
+int MediaTest_H264RbspRoundTrip(void);
+int MediaTest_H264NaluKnownBytes(void);
+int MediaTest_H264NaluBlockBoundaries(void);
+int MediaTest_H264NaluRandomFrames(void);
+int MediaTest_H264NaluCapacity(void);
+int MediaTest_H264ParseSps(void);
+int MediaTest_H264ParsePps(void);
+int MediaTest_H264ParseSliceHeader(void);
+int MediaTest_H264BitReaderLimits(void);
+int MediaTest_H264BitReaderRoundTrip(void);
+int MediaTest_H264AssemblerKeyframe(void);
+int MediaTest_H264AssemblerFrameSpanningRing(void);
+int MediaTest_H264AssemblerEvictedPendingFrame(void);
+int MediaTest_H264PacketizerPaths(void);
+int MediaTest_H264PacketizerSizeLimits(void);
+int MediaTest_H264PacketizerNoAggregation(void);
+
+// RTP
+int MediaTest_RtpFecRecoversMediaSsrc(void);
+int MediaTest_RtpAbsoluteSendTime(void);
+int MediaTest_RtcpParseNack(void);
+int MediaTest_RtpHistoryNackTiming(void);
+int MediaTest_RtpHistoryRtx(void);
+int MediaTest_RtpPacerTokenBucket(void);
+int MediaTest_RtpPacerPriorities(void);
+int MediaTest_RtpPacerDrainRate(void);
+int MediaTest_RtpPacerSchedulerExact(void);
+int MediaTest_RtpPacerSchedulerTicks(void);
+
+// SRTP
+int MediaTest_SrtpKeyDerivation(void);
+int MediaTest_SrtpProtectVectors(void);
+int MediaTest_SrtcpProtectVectors(void);
+int MediaTest_SrtpRemoveStream(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MediaTestSupport_h */
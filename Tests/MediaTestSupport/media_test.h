@@ -0,0 +1,5 @@
+#pragma once
+#include "MediaTestSupport.h"
+
+// returns the line of the first failed check to the Swift side
+#define MEDIA_TEST_CHECK(cond) do { if (!(cond)) return __LINE__; } while (0)
@@ -0,0 +1,109 @@
+//
+//  rtp_fec_tests.cpp
+//
+
+#include <string.h>
+
+#include "media_test.h"
+#include "../../Sources/MediaTransport/Rtp/rtp_fec.h"
+
+#define TEST_MEDIA_SSRC         0x12345678
+#define TEST_FEC_SSRC           0xFEC0FEC0
+#define TEST_MEDIA_PT           96
+#define TEST_FEC_PT             117
+#define TEST_MEDIA_COUNT        12
+
+static uint8_t media[TEST_MEDIA_COUNT][300];
+static struct iovec mediaVec[TEST_MEDIA_COUNT];
+
+// media packets of different sizes and marker bits, from sequence number 65530
+static void BuildMedia(void)
+{
+	unsigned seed = 5;
+	for (int i = 0; i < TEST_MEDIA_COUNT; i++) {
+		uint8_t *p = media[i];
+		uint16_t seq = (uint16_t)(65530 + i);
+		uint32_t timestamp = 90000 + (i / 3) * 3000;
+		size_t size = 12 + 20 + (i * 37) % 260;
+
+		p[0] = 0x80;
+		p[1] = (uint8_t)((i % 3 == 2 ? 0x80 : 0) | TEST_MEDIA_PT);
+		p[2] = (uint8_t)(seq >> 8);
+		p[3] = (uint8_t)seq;
+		p[4] = (uint8_t)(timestamp >> 24);
+		p[5] = (uint8_t)(timestamp >> 16);
+		p[6] = (uint8_t)(timestamp >> 8);
+		p[7] = (uint8_t)timestamp;
+		p[8] = (uint8_t)(TEST_MEDIA_SSRC >> 24);
+		p[9] = (uint8_t)(TEST_MEDIA_SSRC >> 16);
+		p[10] = (uint8_t)(TEST_MEDIA_SSRC >> 8);
+		p[11] = (uint8_t)TEST_MEDIA_SSRC;
+		for (size_t k = 12; k < size; k++) {
+			seed = seed * 1103515245 + 12345;
+			p[k] = (uint8_t)(seed >> 16);
+		}
+		mediaVec[i].iov_base = p;
+		mediaVec[i].iov_len = size;
+	}
+}
+
+// Encodes, loses the media packets in 'lost', feeds the rest and the FEC packets
+// to a decoder and checks every lost packet comes back as it was sent.
+static int RoundTrip(const uint64_t *masks, int fecCount, uint32_t lost)
+{
+	CRtpFecEncoder encoder(TEST_FEC_PT, TEST_FEC_SSRC, 1000);
+	CRtpFecDecoder decoder(TEST_FEC_PT);
+	int rebuilt = 0;
+
+	MEDIA_TEST_CHECK(encoder.Encode(mediaVec, TEST_MEDIA_COUNT, masks, fecCount) == fecCount);
+	for (int i = 0; i < TEST_MEDIA_COUNT; i++) {
+		if (!((lost >> i) & 1))
+			MEDIA_TEST_CHECK(decoder.Insert(media[i], mediaVec[i].iov_len) == 0);
+	}
+	for (int j = 0; j < fecCount; j++) {
+		const uint8_t *packet = encoder.Packet(j);
+		MEDIA_TEST_CHECK(packet[8] == 0xFE && packet[11] == 0xC0);
+		int count = decoder.Insert(packet, encoder.PacketSize(j));
+		for (int r = 0; r < count; r++) {
+			const uint8_t *p = decoder.Recovered(r);
+			int i = (uint16_t)(((p[2] << 8) | p[3]) - 65530);
+			MEDIA_TEST_CHECK(i < TEST_MEDIA_COUNT && ((lost >> i) & 1));
+			MEDIA_TEST_CHECK(decoder.RecoveredSize(r) == mediaVec[i].iov_len);
+			MEDIA_TEST_CHECK(memcmp(p, media[i], mediaVec[i].iov_len) == 0);
+			rebuilt++;
+		}
+	}
+	MEDIA_TEST_CHECK(rebuilt == __builtin_popcount(lost));
+	MEDIA_TEST_CHECK(decoder.RecoveredPackets() == rebuilt && decoder.DroppedPackets() == 0);
+	return 0;
+}
+
+int MediaTest_RtpFecRecoversMediaSsrc(void)
+{
+	uint64_t masks[TEST_MEDIA_COUNT];
+	int line;
+
+	BuildMedia();
+
+	// one loss per interleaved mask, across the sequence number wrap
+	RtpFecGenerateMasks(masks, TEST_MEDIA_COUNT, 3, kRtpFecMaskInterleaved);
+	if ((line = RoundTrip(masks, 3, (1 << 2) | (1 << 7) | (1 << 9))) != 0)
+		return line;
+
+	// bursty masks
+	RtpFecGenerateMasks(masks, TEST_MEDIA_COUNT, 4, kRtpFecMaskBursty);
+	if ((line = RoundTrip(masks, 4, (1 << 0) | (1 << 5) | (1 << 11))) != 0)
+		return line;
+
+	// a second FEC packet completed by the packet the first one rebuilt
+	masks[0] = 0x00F;
+	masks[1] = 0x018;
+	if ((line = RoundTrip(masks, 2, (1 << 1) | (1 << 3))) != 0)
+		return line;
+
+	// a mask of one packet : the SSRC comes from the media stream
+	masks[0] = 1 << 6;
+	if ((line = RoundTrip(masks, 1, 1 << 6)) != 0)
+		return line;
+	return 0;
+}
@@ -0,0 +1,50 @@
+//
+//  rtp_header_extensions_tests.cpp
+//
+
+#include <string.h>
+
+#include "media_test.h"
+#include "../../Sources/MediaTransport/Rtp/rtp_header_extensions.h"
+
+// 6.18 fixed point of the seconds within the 64 s period, rounded
+static uint32_t ExpectedSendTime(int64_t timeUs)
+{
+	int64_t periodUs = ((timeUs % 64000000) + 64000000) % 64000000;
+	return (uint32_t)((periodUs * 262144 + 500000) / 1000000) & 0xFFFFFF;
+}
+
+// Wall clock and monotonic microsecond times are far past the 46 bits that
+// survive a shift by 18, only the position in the 64 s period matters.
+int MediaTest_RtpAbsoluteSendTime(void)
+{
+	static const int64_t times[] = {
+		0, 999999, 63999999, 64000000, 1760000000123456LL, 9000000000000000LL, -1, -64000001
+	};
+	CRtpHeaderExtensionMap map;
+	CRtpHeaderExtensionWriter writer(map);
+	uint8_t packet[64];
+	uint32_t sendTime;
+
+	MEDIA_TEST_CHECK(map.Register(kRtpExtensionAbsoluteSendTime, 3));
+	for (size_t i = 0; i < sizeof(times) / sizeof(times[0]); i++) {
+		memset(packet, 0, sizeof(packet));
+		packet[0] = 0x80;
+		writer.Reset(packet, sizeof(packet));
+		MEDIA_TEST_CHECK(writer.SetAbsoluteSendTime(times[i]));
+		size_t size = writer.HeaderSize();
+		MEDIA_TEST_CHECK(map.GetAbsoluteSendTime(packet, size, &sendTime));
+		MEDIA_TEST_CHECK(sendTime == ExpectedSendTime(times[i]));
+
+		MEDIA_TEST_CHECK(map.RewriteAbsoluteSendTime(packet, size, times[i] + 500000));
+		MEDIA_TEST_CHECK(map.GetAbsoluteSendTime(packet, size, &sendTime));
+		MEDIA_TEST_CHECK(sendTime == ExpectedSendTime(times[i] + 500000));
+	}
+
+	// 1.5 s into the period : 1.5 * 2^18
+	writer.Reset(packet, sizeof(packet));
+	MEDIA_TEST_CHECK(writer.SetAbsoluteSendTime(1760000000000000LL - 1760000000000000LL % 64000000 + 1500000));
+	MEDIA_TEST_CHECK(map.GetAbsoluteSendTime(packet, writer.HeaderSize(), &sendTime));
+	MEDIA_TEST_CHECK(sendTime == 393216);
+	return 0;
+}
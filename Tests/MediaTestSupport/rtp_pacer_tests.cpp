@@ -0,0 +1,325 @@
+//
+//  rtp_pacer_tests.cpp
+//
+
+#include <string.h>
+#include <memory>
+#include <vector>
+
+#include "media_test.h"
+#include "../../Sources/MediaTransport/Rtp/rtp_pacer.h"
+
+#define TEST_PACKET_SIZE        1250        // 10 ms at 1 Mbps
+#define TEST_PACERS             6
+
+struct TestSent {
+	int64_t timeUs;
+	RtpPacerPriority priority;
+	size_t size;
+};
+
+struct TestRecorder {
+	const int64_t *clockUs;
+	std::vector<TestSent> sent;
+};
+
+static void RecordSend(void *context, const RtpPacedPacket &packet)
+{
+	TestRecorder *recorder = (TestRecorder *)context;
+	TestSent sent = { *recorder->clockUs, packet.priority, packet.size };
+	recorder->sent.push_back(sent);
+}
+
+// Runs a pacer alone at the times it asks for until its queues are empty.
+static void Drain(CRtpPacer &pacer, int64_t &clockUs)
+{
+	int64_t nextUs = pacer.Process(clockUs);
+	while (nextUs != RTP_PACER_IDLE) {
+		clockUs = nextUs;
+		nextUs = pacer.Process(clockUs);
+	}
+}
+
+// The bucket lets 1 Mbps out, a packet every 10 ms after the first, and after an
+// idle period a burst of RTP_PACER_MAX_BURST_US worth of bits at most.
+int MediaTest_RtpPacerTokenBucket(void)
+{
+	static uint8_t packet[TEST_PACKET_SIZE];
+	int64_t clockUs = 1000000;
+	TestRecorder recorder = { &clockUs };
+	CRtpPacer pacer(RecordSend, &recorder);
+
+	// 400 kbps with the default multiplier
+	pacer.SetBitrate(400000);
+	for (int i = 0; i < 100; i++)
+		MEDIA_TEST_CHECK(pacer.Enqueue(kRtpPacerVideo, packet, sizeof(packet), NULL, clockUs));
+	MEDIA_TEST_CHECK(pacer.QueuedBytes() == 100 * sizeof(packet));
+	int64_t startUs = clockUs;
+	Drain(pacer, clockUs);
+	MEDIA_TEST_CHECK(recorder.sent.size() == 100 && pacer.QueuedBytes() == 0);
+	MEDIA_TEST_CHECK(recorder.sent[0].timeUs - startUs <= 1);
+	for (size_t i = 1; i < recorder.sent.size(); i++) {
+		int64_t gap = recorder.sent[i].timeUs - recorder.sent[i - 1].timeUs;
+		MEDIA_TEST_CHECK(gap >= 9999 && gap <= 10001);
+	}
+	int64_t elapsed = recorder.sent.back().timeUs - recorder.sent[0].timeUs;
+	MEDIA_TEST_CHECK(elapsed >= 99 * 9999 && elapsed <= 99 * 10001);
+	MEDIA_TEST_CHECK(pacer.SentBytes() == 100 * TEST_PACKET_SIZE);
+
+	// a second idle : one packet at once, the bucket is 5 ms deep
+	recorder.sent.clear();
+	clockUs += 1000000;
+	startUs = clockUs;
+	for (int i = 0; i < 3; i++)
+		MEDIA_TEST_CHECK(pacer.Enqueue(kRtpPacerVideo, packet, sizeof(packet), NULL, clockUs));
+	Drain(pacer, clockUs);
+	MEDIA_TEST_CHECK(recorder.sent.size() == 3);
+	MEDIA_TEST_CHECK(recorder.sent[0].timeUs == startUs);
+	MEDIA_TEST_CHECK(recorder.sent[1].timeUs - startUs >= 4999 && recorder.sent[1].timeUs - startUs <= 5001);
+	MEDIA_TEST_CHECK(recorder.sent[2].timeUs - recorder.sent[1].timeUs >= 9999);
+
+	// no bitrate : everything at once
+	recorder.sent.clear();
+	pacer.SetBitrate(0);
+	for (int i = 0; i < 10; i++)
+		MEDIA_TEST_CHECK(pacer.Enqueue(kRtpPacerVideo, packet, sizeof(packet), NULL, clockUs));
+	MEDIA_TEST_CHECK(pacer.Process(clockUs) == RTP_PACER_IDLE);
+	MEDIA_TEST_CHECK(recorder.sent.size() == 10);
+
+	// a full queue refuses more
+	CRtpPacer small(RecordSend, &recorder, 4);
+	for (int i = 0; i < 4; i++)
+		MEDIA_TEST_CHECK(small.Enqueue(kRtpPacerVideo, packet, sizeof(packet), NULL, clockUs));
+	MEDIA_TEST_CHECK(!small.Enqueue(kRtpPacerVideo, packet, sizeof(packet), NULL, clockUs));
+	MEDIA_TEST_CHECK(small.Enqueue(kRtpPacerAudio, packet, sizeof(packet), NULL, clockUs));
+	return 0;
+}
+
+// Audio goes at once whatever the bucket, then retransmissions, video and padding
+// in that order, each queue first in first out.
+int MediaTest_RtpPacerPriorities(void)
+{
+	static uint8_t packets[16][100];
+	int64_t clockUs = 0;
+	TestRecorder recorder = { &clockUs };
+	CRtpPacer pacer(RecordSend, &recorder);
+	pacer.SetBitrate(1000000, 1.0);
+
+	static const RtpPacerPriority order[] = {
+		kRtpPacerPadding, kRtpPacerVideo, kRtpPacerRetransmission, kRtpPacerVideo,
+		kRtpPacerPadding, kRtpPacerRetransmission, kRtpPacerAudio, kRtpPacerVideo
+	};
+	for (int i = 0; i < 8; i++)
+		MEDIA_TEST_CHECK(pacer.Enqueue(order[i], packets[i], 100 + i, NULL, clockUs));
+	MEDIA_TEST_CHECK(pacer.QueuedPackets(kRtpPacerVideo) == 3 && pacer.QueuedPackets(kRtpPacerPadding) == 2);
+
+	// the bucket is empty, only audio goes
+	MEDIA_TEST_CHECK(pacer.Process(clockUs) > clockUs);
+	MEDIA_TEST_CHECK(recorder.sent.size() == 1 && recorder.sent[0].priority == kRtpPacerAudio);
+
+	// audio queued while video waits goes at the next call
+	clockUs += 10;
+	MEDIA_TEST_CHECK(pacer.Enqueue(kRtpPacerAudio, packets[8], 160, NULL, clockUs));
+	MEDIA_TEST_CHECK(pacer.NextSendTime(clockUs) == clockUs);
+	pacer.Process(clockUs);
+	MEDIA_TEST_CHECK(recorder.sent.size() == 2 && recorder.sent[1].priority == kRtpPacerAudio);
+
+	Drain(pacer, clockUs);
+	static const size_t sizes[] = { 106, 160, 102, 105, 101, 103, 107, 100, 104 };
+	static const RtpPacerPriority sent[] = {
+		kRtpPacerAudio, kRtpPacerAudio, kRtpPacerRetransmission, kRtpPacerRetransmission,
+		kRtpPacerVideo, kRtpPacerVideo, kRtpPacerVideo, kRtpPacerPadding, kRtpPacerPadding
+	};
+	MEDIA_TEST_CHECK(recorder.sent.size() == 9);
+	for (int i = 0; i < 9; i++)
+		MEDIA_TEST_CHECK(recorder.sent[i].priority == sent[i] && recorder.sent[i].size == sizes[i]);
+
+	// audio is charged to the bucket : 266 bytes of it hold back the first
+	// retransmission by about 2.1 ms at 1 Mbps
+	MEDIA_TEST_CHECK(recorder.sent[2].timeUs >= 266 * 8 - 2 && recorder.sent[2].timeUs <= 266 * 8 + 2);
+	return 0;
+}
+
+// Video and retransmissions queued for longer than the maximum queue time at the
+// set rate raise it : the first gaps are those of the drain rate, and the queue
+// empties several times faster than at the set rate.
+int MediaTest_RtpPacerDrainRate(void)
+{
+	static uint8_t packet[1000];
+	int64_t clockUs = 0;
+	TestRecorder recorder = { &clockUs };
+	int64_t elapsed[2];
+
+	for (int drain = 0; drain < 2; drain++) {
+		CRtpPacer pacer(RecordSend, &recorder);
+		pacer.SetBitrate(100000, 1.0);
+		pacer.SetMaxQueueTime(drain ? 100000 : 0);
+		recorder.sent.clear();
+		clockUs = 0;
+		for (int i = 0; i < 50; i++)
+			MEDIA_TEST_CHECK(pacer.Enqueue(i & 1 ? kRtpPacerVideo : kRtpPacerRetransmission, packet, sizeof(packet), NULL, clockUs));
+		Drain(pacer, clockUs);
+		MEDIA_TEST_CHECK(recorder.sent.size() == 50);
+		elapsed[drain] = recorder.sent.back().timeUs - recorder.sent[0].timeUs;
+		// 50 kB to drain in 100 ms : 4 Mbps, 2 ms per packet at first
+		int64_t gap = recorder.sent[2].timeUs - recorder.sent[1].timeUs;
+		if (drain)
+			MEDIA_TEST_CHECK(gap >= 1900 && gap <= 2100);
+		else
+			MEDIA_TEST_CHECK(gap >= 79999 && gap <= 80001);
+	}
+	MEDIA_TEST_CHECK(elapsed[0] >= 49 * 79999 && elapsed[0] <= 49 * 80001);
+	MEDIA_TEST_CHECK(elapsed[1] * 5 < elapsed[0]);
+
+	// padding is not what the receiver waits for, it does not raise the rate
+	CRtpPacer pacer(RecordSend, &recorder);
+	pacer.SetBitrate(100000, 1.0);
+	pacer.SetMaxQueueTime(100000);
+	recorder.sent.clear();
+	clockUs = 0;
+	for (int i = 0; i < 5; i++)
+		MEDIA_TEST_CHECK(pacer.Enqueue(kRtpPacerPadding, packet, sizeof(packet), NULL, clockUs));
+	Drain(pacer, clockUs);
+	MEDIA_TEST_CHECK(recorder.sent.size() == 5);
+	MEDIA_TEST_CHECK(recorder.sent[4].timeUs - recorder.sent[1].timeUs >= 3 * 79999);
+	return 0;
+}
+
+struct TestSchedulerStream {
+	int64_t bitrate;
+	int packets;
+	size_t size;
+};
+
+// From 1 ms between packets on the fine level to 20 s, past the end of the coarse
+// one, for pacers on one scheduler starting just before both levels wrap around.
+static const TestSchedulerStream kStreams[TEST_PACERS] = {
+	{ 10000000, 300, 1200 },        // 0.96 ms
+	{ 2500000, 200, 1200 },         // 3.84 ms, close to the fine level's 4.096
+	{ 1000000, 100, 1250 },         // 10 ms
+	{ 64000, 20, 160 },             // 20 ms
+	{ 8000, 4, 1000 },              // 1 s
+	{ 480, 2, 1200 },               // 20 s
+};
+
+static const int64_t kWrapUs = ((int64_t)3 << (2 * RTP_PACER_WHEEL_BITS)) - 7;
+
+static void Fill(CRtpPacer &pacer, const TestSchedulerStream &stream, int64_t nowUs)
+{
+	static uint8_t packet[1250];
+	pacer.SetBitrate(stream.bitrate, 1.0);
+	pacer.SetMaxQueueTime(0);
+	for (int i = 0; i < stream.packets; i++)
+		pacer.Enqueue(kRtpPacerVideo, packet, stream.size, NULL, nowUs);
+}
+
+// Pacers on the scheduler, run at the deadlines it gives, send at the very times
+// they do alone, across the wrap of both wheel levels and past the coarse level.
+int MediaTest_RtpPacerSchedulerExact(void)
+{
+	int64_t clockUs = kWrapUs;
+	std::vector<TestRecorder> alone(TEST_PACERS), scheduled(TEST_PACERS);
+
+	for (int p = 0; p < TEST_PACERS; p++) {
+		alone[p].clockUs = &clockUs;
+		CRtpPacer pacer(RecordSend, &alone[p]);
+		clockUs = kWrapUs;
+		Fill(pacer, kStreams[p], clockUs);
+		Drain(pacer, clockUs);
+		MEDIA_TEST_CHECK((int)alone[p].sent.size() == kStreams[p].packets);
+	}
+	MEDIA_TEST_CHECK(alone[TEST_PACERS - 1].sent.back().timeUs - kWrapUs > RTP_PACER_WHEEL_HORIZON);
+
+	clockUs = kWrapUs;
+	CRtpPacerScheduler scheduler;
+	std::vector<std::unique_ptr<CRtpPacer> > pacers;
+	for (int p = 0; p < TEST_PACERS; p++) {
+		scheduled[p].clockUs = &clockUs;
+		pacers.emplace_back(new CRtpPacer(RecordSend, &scheduled[p]));
+		scheduler.Add(pacers[p].get(), clockUs);
+		Fill(*pacers[p], kStreams[p], clockUs);
+	}
+	MEDIA_TEST_CHECK(scheduler.NextDeadline() == kWrapUs + 1);
+	int64_t nextUs;
+	while ((nextUs = scheduler.NextDeadline()) != RTP_PACER_IDLE) {
+		MEDIA_TEST_CHECK(nextUs >= clockUs);
+		clockUs = nextUs;
+		MEDIA_TEST_CHECK(scheduler.Run(clockUs) > 0);
+	}
+
+	for (int p = 0; p < TEST_PACERS; p++) {
+		MEDIA_TEST_CHECK(scheduled[p].sent.size() == alone[p].sent.size());
+		for (size_t i = 0; i < alone[p].sent.size(); i++)
+			MEDIA_TEST_CHECK(scheduled[p].sent[i].timeUs == alone[p].sent[i].timeUs);
+	}
+	return 0;
+}
+
+// Run() at a coarse tick and across long jumps leaves no pacer that could send,
+// NextDeadline() is the earliest send time, an enqueue brings a far deadline in,
+// and a removed pacer is gone from both levels.
+int MediaTest_RtpPacerSchedulerTicks(void)
+{
+	static uint8_t packet[100];
+	static const int64_t ticks[] = { 700, 4096, 5000, 9000000, 40000000, 1 };
+	int64_t clockUs = kWrapUs - 20000000;
+	std::vector<TestRecorder> recorders(TEST_PACERS);
+	CRtpPacerScheduler scheduler;
+	std::vector<std::unique_ptr<CRtpPacer> > pacers;
+
+	for (int p = 0; p < TEST_PACERS; p++) {
+		recorders[p].clockUs = &clockUs;
+		pacers.emplace_back(new CRtpPacer(RecordSend, &recorders[p]));
+		Fill(*pacers[p], kStreams[p], clockUs);
+		scheduler.Add(pacers[p].get(), clockUs);
+	}
+
+	for (int round = 0; round < 3000; round++) {
+		clockUs += ticks[round % 6];
+		scheduler.Run(clockUs);
+		// a pacer past the coarse level waits for a deadline brought in, which
+		// only has to be before its send time
+		int64_t earliest = RTP_PACER_IDLE;
+		bool far = false;
+		for (int p = 0; p < TEST_PACERS; p++) {
+			int64_t sendUs = pacers[p]->NextSendTime(clockUs);
+			MEDIA_TEST_CHECK(sendUs == RTP_PACER_IDLE || sendUs > clockUs);
+			if (sendUs != RTP_PACER_IDLE && sendUs - clockUs > RTP_PACER_WHEEL_HORIZON - ticks[4])
+				far = true;
+			else if (sendUs != RTP_PACER_IDLE && (earliest == RTP_PACER_IDLE || sendUs < earliest))
+				earliest = sendUs;
+		}
+		int64_t nextUs = scheduler.NextDeadline();
+		if (far)
+			MEDIA_TEST_CHECK(nextUs > clockUs && (earliest == RTP_PACER_IDLE || nextUs <= earliest));
+		else
+			MEDIA_TEST_CHECK(nextUs == earliest);
+
+		// a far pacer woken up by audio, the time of the last Run() is over
+		if (round == 2) {
+			CRtpPacer *slow = pacers[TEST_PACERS - 1].get();
+			clockUs++;
+			MEDIA_TEST_CHECK(slow->NextSendTime(clockUs) - clockUs > RTP_PACER_WHEEL_SLOTS);
+			MEDIA_TEST_CHECK(slow->Enqueue(kRtpPacerAudio, packet, sizeof(packet), NULL, clockUs));
+			MEDIA_TEST_CHECK(scheduler.NextDeadline() == clockUs);
+			size_t sent = recorders[TEST_PACERS - 1].sent.size();
+			MEDIA_TEST_CHECK(scheduler.Run(clockUs) >= 1);
+			MEDIA_TEST_CHECK(recorders[TEST_PACERS - 1].sent.size() == sent + 1);
+			MEDIA_TEST_CHECK(recorders[TEST_PACERS - 1].sent.back().priority == kRtpPacerAudio);
+		}
+	}
+	for (int p = 0; p < TEST_PACERS; p++)
+		MEDIA_TEST_CHECK(pacers[p]->QueuedBytes() == 0);
+
+	// removed from the fine and the coarse level
+	clockUs++;
+	for (int p = 0; p < TEST_PACERS; p++)
+		Fill(*pacers[p], kStreams[p], clockUs);
+	MEDIA_TEST_CHECK(scheduler.NextDeadline() == clockUs);
+	MEDIA_TEST_CHECK(scheduler.Run(clockUs) == TEST_PACERS);
+	for (int p = 0; p < TEST_PACERS; p++)
+		scheduler.Remove(pacers[p].get());
+	MEDIA_TEST_CHECK(scheduler.NextDeadline() == RTP_PACER_IDLE);
+	MEDIA_TEST_CHECK(scheduler.Run(clockUs + 30000000) == 0);
+	return 0;
+}
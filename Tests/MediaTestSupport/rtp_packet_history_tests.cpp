@@ -0,0 +1,257 @@
+//
+//  rtp_packet_history_tests.cpp
+//
+
+#include <string.h>
+#include <vector>
+
+#include "media_test.h"
+#include "../../Sources/MediaTransport/Rtp/rtcp_nack.h"
+#include "../../Sources/MediaTransport/Rtp/rtp_packet_history.h"
+
+#define TEST_MEDIA_SSRC         0x11223344
+#define TEST_SENDER_SSRC        0x55667788
+#define TEST_RTX_SSRC           0xAABBCCDD
+#define TEST_RTX_PAYLOAD_TYPE   97
+
+struct TestNackItem {
+	uint16_t pid;
+	uint16_t blp;
+};
+
+static void Put16(std::vector<uint8_t> &out, uint16_t value)
+{
+	out.push_back((uint8_t)(value >> 8));
+	out.push_back((uint8_t)value);
+}
+
+static void Put32(std::vector<uint8_t> &out, uint32_t value)
+{
+	Put16(out, (uint16_t)(value >> 16));
+	Put16(out, (uint16_t)value);
+}
+
+// Appends a generic NACK with the given FCIs to a compound packet.
+static void AppendNack(std::vector<uint8_t> &rtcp, uint32_t mediaSsrc, const TestNackItem *items, int count)
+{
+	rtcp.push_back(0x80 | RTCP_FMT_GENERIC_NACK);
+	rtcp.push_back(RTCP_PT_RTPFB);
+	Put16(rtcp, (uint16_t)(2 + count));
+	Put32(rtcp, TEST_SENDER_SSRC);
+	Put32(rtcp, mediaSsrc);
+	for (int i = 0; i < count; i++) {
+		Put16(rtcp, items[i].pid);
+		Put16(rtcp, items[i].blp);
+	}
+}
+
+static std::vector<uint8_t> Nack(uint16_t pid, uint16_t blp = 0)
+{
+	std::vector<uint8_t> rtcp;
+	TestNackItem item = { pid, blp };
+	AppendNack(rtcp, TEST_MEDIA_SSRC, &item, 1);
+	return rtcp;
+}
+
+// RTP packet with csrcs CSRCs, an extension of extensionWords words, a payload
+// of payloadSize bytes and padding bytes of padding (0 : no P bit).
+static std::vector<uint8_t> RtpPacket(uint16_t seq, bool marker, int csrcs, int extensionWords,
+                                      size_t payloadSize, int padding)
+{
+	std::vector<uint8_t> packet;
+	packet.push_back((uint8_t)(0x80 | (padding ? 0x20 : 0) | (extensionWords ? 0x10 : 0) | csrcs));
+	packet.push_back((uint8_t)((marker ? 0x80 : 0) | 96));
+	Put16(packet, seq);
+	Put32(packet, 0x01020304);
+	Put32(packet, TEST_MEDIA_SSRC);
+	for (int i = 0; i < csrcs; i++)
+		Put32(packet, 0xC0000000 + i);
+	if (extensionWords) {
+		Put16(packet, 0xBEDE);
+		Put16(packet, (uint16_t)extensionWords);
+		for (int i = 0; i < extensionWords; i++)
+			Put32(packet, 0xE0000000 + i);
+	}
+	for (size_t i = 0; i < payloadSize; i++)
+		packet.push_back((uint8_t)(seq + i * 7));
+	for (int i = 0; i < padding; i++)
+		packet.push_back(i == padding - 1 ? (uint8_t)padding : 0);
+	return packet;
+}
+
+static std::vector<uint8_t> Gather(const CRtpPacketHistory &history, int index)
+{
+	struct iovec iov[2];
+	std::vector<uint8_t> packet;
+	int count = history.RetransmissionIov(index, iov);
+	for (int i = 0; i < count; i++) {
+		const uint8_t *data = (const uint8_t *)iov[i].iov_base;
+		packet.insert(packet.end(), data, data + iov[i].iov_len);
+	}
+	return packet;
+}
+
+// BLP expansion across the sequence number wrap, NACKs among other reports of a
+// compound packet, NACKs for another media SSRC, capacity and malformed packets.
+int MediaTest_RtcpParseNack(void)
+{
+	uint16_t seqs[64];
+
+	std::vector<uint8_t> rtcp = Nack(100, 0x8005);
+	MEDIA_TEST_CHECK(RtcpParseNack(rtcp.data(), rtcp.size(), TEST_MEDIA_SSRC, seqs, 64) == 4);
+	MEDIA_TEST_CHECK(seqs[0] == 100 && seqs[1] == 101 && seqs[2] == 103 && seqs[3] == 116);
+	rtcp = Nack(65534, 0x0003);
+	MEDIA_TEST_CHECK(RtcpParseNack(rtcp.data(), rtcp.size(), TEST_MEDIA_SSRC, seqs, 64) == 3);
+	MEDIA_TEST_CHECK(seqs[0] == 65534 && seqs[1] == 65535 && seqs[2] == 0);
+	rtcp = Nack(7, 0xFFFF);
+	MEDIA_TEST_CHECK(RtcpParseNack(rtcp.data(), rtcp.size(), TEST_MEDIA_SSRC, seqs, 64) == 17);
+	for (int i = 0; i < 17; i++)
+		MEDIA_TEST_CHECK(seqs[i] == 7 + i);
+
+	// receiver report, NACK for another stream, PLI, NACK with two FCIs
+	static const TestNackItem other[] = { { 5, 0x0001 } };
+	static const TestNackItem items[] = { { 40, 0x0000 }, { 60, 0x0002 } };
+	rtcp.clear();
+	rtcp.push_back(0x80);
+	rtcp.push_back(201);
+	Put16(rtcp, 1);
+	Put32(rtcp, TEST_SENDER_SSRC);
+	AppendNack(rtcp, TEST_MEDIA_SSRC + 1, other, 1);
+	rtcp.push_back(0x81);
+	rtcp.push_back(206);
+	Put16(rtcp, 2);
+	Put32(rtcp, TEST_SENDER_SSRC);
+	Put32(rtcp, TEST_MEDIA_SSRC);
+	AppendNack(rtcp, TEST_MEDIA_SSRC, items, 2);
+	MEDIA_TEST_CHECK(RtcpParseNack(rtcp.data(), rtcp.size(), TEST_MEDIA_SSRC, seqs, 64) == 3);
+	MEDIA_TEST_CHECK(seqs[0] == 40 && seqs[1] == 60 && seqs[2] == 62);
+	MEDIA_TEST_CHECK(RtcpParseNack(rtcp.data(), rtcp.size(), TEST_MEDIA_SSRC + 1, seqs, 64) == 2);
+	MEDIA_TEST_CHECK(seqs[0] == 5 && seqs[1] == 6);
+	MEDIA_TEST_CHECK(RtcpParseNack(rtcp.data(), rtcp.size(), TEST_MEDIA_SSRC + 2, seqs, 64) == 0);
+
+	// no more than capacity, in order
+	MEDIA_TEST_CHECK(RtcpParseNack(rtcp.data(), rtcp.size(), TEST_MEDIA_SSRC, seqs, 2) == 2);
+	MEDIA_TEST_CHECK(seqs[0] == 40 && seqs[1] == 60);
+	MEDIA_TEST_CHECK(RtcpParseNack(rtcp.data(), rtcp.size(), TEST_MEDIA_SSRC, seqs, 0) == 0);
+
+	// a length past the end, a truncated header, another version
+	MEDIA_TEST_CHECK(RtcpParseNack(rtcp.data(), rtcp.size() - 4, TEST_MEDIA_SSRC, seqs, 64) == -1);
+	MEDIA_TEST_CHECK(RtcpParseNack(rtcp.data(), 10, TEST_MEDIA_SSRC, seqs, 64) == -1);
+	rtcp[0] = 0x40;
+	MEDIA_TEST_CHECK(RtcpParseNack(rtcp.data(), rtcp.size(), TEST_MEDIA_SSRC, seqs, 64) == -1);
+	MEDIA_TEST_CHECK(RtcpParseNack(rtcp.data(), 0, TEST_MEDIA_SSRC, seqs, 64) == 0);
+	return 0;
+}
+
+// The first NACK of a packet is served whenever it comes, even under the RTT.
+// Once resent, a packet is not resent again until an RTT after that copy.
+int MediaTest_RtpHistoryNackTiming(void)
+{
+	CRtpPacketHistory history(TEST_MEDIA_SSRC, 64);
+	history.SetRtt(100);
+	for (uint16_t seq = 10; seq < 20; seq++) {
+		std::vector<uint8_t> packet = RtpPacket(seq, false, 0, 0, 100, 0);
+		MEDIA_TEST_CHECK(history.Put(packet.data(), packet.size(), 0) != NULL);
+	}
+
+	// 90 ms after the sending with an RTT of 100
+	std::vector<uint8_t> rtcp = Nack(12);
+	MEDIA_TEST_CHECK(history.OnNack(rtcp.data(), rtcp.size(), 90) == 1);
+	MEDIA_TEST_CHECK(history.Retransmission(0).sequenceNumber == 12);
+	// again 60 ms after the copy, then 101 ms after it
+	MEDIA_TEST_CHECK(history.OnNack(rtcp.data(), rtcp.size(), 150) == 0);
+	MEDIA_TEST_CHECK(history.OnNack(rtcp.data(), rtcp.size(), 191) == 1);
+	MEDIA_TEST_CHECK(history.ResentPackets() == 2 && history.MissedPackets() == 0);
+
+	// 12 held back 9 ms after its copy, 13 named twice and sent once
+	rtcp = Nack(12, 0x0001);
+	static const TestNackItem twice[] = { { 13, 0x0000 } };
+	AppendNack(rtcp, TEST_MEDIA_SSRC, twice, 1);
+	MEDIA_TEST_CHECK(history.OnNack(rtcp.data(), rtcp.size(), 200) == 1);
+	MEDIA_TEST_CHECK(history.Retransmission(0).sequenceNumber == 13);
+
+	// never sent : missed, not resent
+	rtcp = Nack(500);
+	MEDIA_TEST_CHECK(history.OnNack(rtcp.data(), rtcp.size(), 300) == 0);
+	MEDIA_TEST_CHECK(history.ResentPackets() == 3 && history.MissedPackets() == 1);
+	return 0;
+}
+
+// Without RTX the stored packet goes out as it is. With RTX the header gets the
+// RTX payload type, SSRC and sequence numbers, keeps CSRCs, extensions and the
+// marker, drops the padding, and the original sequence number leads the payload.
+int MediaTest_RtpHistoryRtx(void)
+{
+	CRtpPacketHistory history(TEST_MEDIA_SSRC, 16);
+	std::vector<uint8_t> padded = RtpPacket(0xFFFF, true, 2, 3, 300, 5);
+	std::vector<uint8_t> plain = RtpPacket(0x0000, false, 0, 0, 80, 0);
+
+	// the iovecs gathered give the packet, stored in its slot
+	struct iovec iov[3];
+	iov[0].iov_base = padded.data();
+	iov[0].iov_len = 12;
+	iov[1].iov_base = padded.data() + 12;
+	iov[1].iov_len = 100;
+	iov[2].iov_base = padded.data() + 112;
+	iov[2].iov_len = padded.size() - 112;
+	const uint8_t *stored = history.Put(iov, 3, 0);
+	MEDIA_TEST_CHECK(stored != NULL && stored != padded.data());
+	MEDIA_TEST_CHECK(memcmp(stored, padded.data(), padded.size()) == 0);
+	MEDIA_TEST_CHECK(history.Put(plain.data(), plain.size(), 0) != NULL);
+
+	std::vector<uint8_t> rtcp = Nack(0xFFFF, 0x0001);
+	MEDIA_TEST_CHECK(history.OnNack(rtcp.data(), rtcp.size(), 10) == 2);
+	MEDIA_TEST_CHECK(history.Retransmission(0).headerSize == 0 && history.Retransmission(0).payload == stored);
+	MEDIA_TEST_CHECK(Gather(history, 0) == padded);
+	MEDIA_TEST_CHECK(Gather(history, 1) == plain);
+
+	history.SetRtx(TEST_RTX_PAYLOAD_TYPE, TEST_RTX_SSRC, 0xFFFE);
+	for (int round = 0; round < 2; round++) {
+		MEDIA_TEST_CHECK(history.OnNack(rtcp.data(), rtcp.size(), 20 + round) == 2);
+		for (int i = 0; i < 2; i++) {
+			const std::vector<uint8_t> &original = i == 0 ? padded : plain;
+			size_t headerSize = i == 0 ? 12 + 2 * 4 + 4 + 3 * 4 : 12;
+			size_t payloadSize = i == 0 ? 300 : 80;
+			uint16_t rtxSeq = (uint16_t)(0xFFFE + round * 2 + i);
+
+			std::vector<uint8_t> expected(original.begin(), original.begin() + headerSize);
+			expected[0] &= ~0x20;
+			expected[1] = (uint8_t)((original[1] & 0x80) | TEST_RTX_PAYLOAD_TYPE);
+			expected[2] = (uint8_t)(rtxSeq >> 8);
+			expected[3] = (uint8_t)rtxSeq;
+			expected[8] = 0xAA;
+			expected[9] = 0xBB;
+			expected[10] = 0xCC;
+			expected[11] = 0xDD;
+			expected.push_back(original[2]);
+			expected.push_back(original[3]);
+			expected.insert(expected.end(), original.begin() + headerSize, original.begin() + headerSize + payloadSize);
+
+			const RtpRetransmission &resend = history.Retransmission(i);
+			MEDIA_TEST_CHECK(resend.sequenceNumber == (i == 0 ? 0xFFFF : 0x0000));
+			MEDIA_TEST_CHECK(resend.headerSize == headerSize + RTP_RTX_OSN_SIZE);
+			MEDIA_TEST_CHECK(history.RetransmissionSize(i) == expected.size());
+			MEDIA_TEST_CHECK(Gather(history, i) == expected);
+		}
+	}
+	// the media packets are untouched
+	MEDIA_TEST_CHECK(memcmp(stored, padded.data(), padded.size()) == 0);
+
+	// 16 packets later the slot holds another one
+	std::vector<uint8_t> later = RtpPacket(0xFFFF + 16, false, 0, 0, 10, 0);
+	MEDIA_TEST_CHECK(history.Put(later.data(), later.size(), 30) != NULL);
+	rtcp = Nack(0xFFFF);
+	MEDIA_TEST_CHECK(history.OnNack(rtcp.data(), rtcp.size(), 40) == 0);
+	MEDIA_TEST_CHECK(history.MissedPackets() == 1);
+
+	// a malformed packet is not stored and frees its slot, a larger one is refused
+	std::vector<uint8_t> malformed = RtpPacket(0x0000, false, 0, 0, 10, 0);
+	malformed[0] = (uint8_t)((malformed[0] & 0x3F) | 0x40);
+	MEDIA_TEST_CHECK(history.Put(malformed.data(), malformed.size(), 50) == NULL);
+	rtcp = Nack(0x0000);
+	MEDIA_TEST_CHECK(history.OnNack(rtcp.data(), rtcp.size(), 60) == 0);
+	MEDIA_TEST_CHECK(history.MissedPackets() == 2);
+	std::vector<uint8_t> large = RtpPacket(0x0001, false, 0, 0, RTP_HISTORY_MAX_PACKET, 0);
+	MEDIA_TEST_CHECK(history.Put(large.data(), large.size(), 70) == NULL);
+	return 0;
+}
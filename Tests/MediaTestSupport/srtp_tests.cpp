@@ -0,0 +1,147 @@
+//
+//  srtp_tests.cpp
+//
+
+#include <string.h>
+
+#include "media_test.h"
+#include "../../Sources/MediaTransport/Srtp/srtp.h"
+
+// RFC 3711 B.3 master key and salt
+static const char *kMasterKey = "E1F97A0D3E018BE0D64FA32C06DE4139";
+static const char *kMasterSalt = "0EC675AD498AFEEBB6960B3AABE6";
+// RFC 7714 style GCM key and salt, as in the libsrtp test driver
+static const char *kGcmKey = "000102030405060708090a0b0c0d0e0f";
+static const char *kGcmSalt = "a0a1a2a3a4a5a6a7a8a9aaab";
+
+static const char *kRtp = "800f1234decafbadcafebabeabababababababababababababababab";
+static const char *kRtcp = "81c8000bcafebabeabababababababababababababababab";
+
+static size_t Hex(const char *text, uint8_t *out)
+{
+	size_t n = 0;
+	for (; text[2 * n] && text[2 * n + 1]; n++) {
+		int value = 0;
+		for (int k = 0; k < 2; k++) {
+			char c = text[2 * n + k];
+			value = value * 16 + (c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10);
+		}
+		out[n] = (uint8_t)value;
+	}
+	return n;
+}
+
+static bool Equals(const uint8_t *data, size_t size, const char *hex)
+{
+	uint8_t expected[128];
+	return Hex(hex, expected) == size && memcmp(data, expected, size) == 0;
+}
+
+int MediaTest_SrtpKeyDerivation(void)
+{
+	uint8_t key[16], salt[14], out[20];
+
+	Hex(kMasterKey, key);
+	Hex(kMasterSalt, salt);
+	SrtpDeriveKey(key, sizeof(key), salt, sizeof(salt), 0, out, 16);
+	MEDIA_TEST_CHECK(Equals(out, 16, "C61E7A93744F39EE10734AFE3FF7A087"));
+	SrtpDeriveKey(key, sizeof(key), salt, sizeof(salt), 2, out, 14);
+	MEDIA_TEST_CHECK(Equals(out, 14, "30CBBC08863D8C85D49DB34A9AE1"));
+	SrtpDeriveKey(key, sizeof(key), salt, sizeof(salt), 1, out, 20);
+	MEDIA_TEST_CHECK(Equals(out, 20, "CEBE321F6FF7716B6FD4AB49AF256A156D38BAA4"));
+	return 0;
+}
+
+// libsrtp test driver packets : protected by the sender, back to the plaintext
+// on the receiver, rejected when replayed
+static int CheckRtp(SrtpProfile profile, const char *masterKey, const char *masterSalt, const char *expected)
+{
+	uint8_t key[32], salt[14], packet[64], plain[64];
+	Hex(masterKey, key);
+	Hex(masterSalt, salt);
+	CSrtpSession sender(profile, key, salt), receiver(profile, key, salt);
+
+	size_t size = Hex(kRtp, packet);
+	memcpy(plain, packet, size);
+	int n = sender.ProtectRtp(packet, size, sizeof(packet));
+	MEDIA_TEST_CHECK(n > 0 && Equals(packet, n, expected));
+
+	uint8_t copy[64];
+	memcpy(copy, packet, n);
+	MEDIA_TEST_CHECK(receiver.UnprotectRtp(packet, n) == (int)size);
+	MEDIA_TEST_CHECK(memcmp(packet, plain, size) == 0);
+	MEDIA_TEST_CHECK(receiver.UnprotectRtp(copy, n) == kSrtpErrorReplay);
+	return 0;
+}
+
+static int CheckRtcp(SrtpProfile profile, const char *masterKey, const char *masterSalt, const char *expected)
+{
+	uint8_t key[32], salt[14], packet[64], plain[64];
+	Hex(masterKey, key);
+	Hex(masterSalt, salt);
+	CSrtpSession sender(profile, key, salt), receiver(profile, key, salt);
+
+	size_t size = Hex(kRtcp, packet);
+	memcpy(plain, packet, size);
+	int n = sender.ProtectRtcp(packet, size, sizeof(packet));
+	MEDIA_TEST_CHECK(n > 0 && Equals(packet, n, expected));
+
+	packet[n - 1] ^= 1;
+	MEDIA_TEST_CHECK(receiver.UnprotectRtcp(packet, n) == kSrtpErrorAuth);
+	packet[n - 1] ^= 1;
+	MEDIA_TEST_CHECK(receiver.UnprotectRtcp(packet, n) == (int)size);
+	MEDIA_TEST_CHECK(memcmp(packet, plain, size) == 0);
+	return 0;
+}
+
+int MediaTest_SrtpProtectVectors(void)
+{
+	int line;
+	if ((line = CheckRtp(kSrtpAes128CmHmacSha1_80, kMasterKey, kMasterSalt,
+	                     "800f1234decafbadcafebabe4e55dc4ce79978d88ca4d215949d2402b78d6acc99ea179b8dbb")) != 0)
+		return line;
+	if ((line = CheckRtp(kSrtpAeadAes128Gcm, kGcmKey, kGcmSalt,
+	                     "800f1234decafbadcafebabec5002ede04cfdd2eb91159e0880aa06ed2976826f796b201df3131a127e8a392")) != 0)
+		return line;
+	return 0;
+}
+
+int MediaTest_SrtcpProtectVectors(void)
+{
+	int line;
+	if ((line = CheckRtcp(kSrtpAes128CmHmacSha1_80, kMasterKey, kMasterSalt,
+	                      "81c8000bcafebabeb19c219a086b6c7ae61d8e0bfeb4be3f800000005631d6cfc906cdb30f41")) != 0)
+		return line;
+	if ((line = CheckRtcp(kSrtpAeadAes128Gcm, kGcmKey, kGcmSalt,
+	                      "81c8000bcafebabe1f3587a6415de2b37bb8f19d9f2dccbc75daad556903988d1e02a288b06e865c80000000")) != 0)
+		return line;
+	return 0;
+}
+
+// A full stream table refuses a new SSRC until one is removed
+int MediaTest_SrtpRemoveStream(void)
+{
+	uint8_t key[16], salt[14], packet[64];
+	Hex(kMasterKey, key);
+	Hex(kMasterSalt, salt);
+	CSrtpSession session(kSrtpAes128CmHmacSha1_80, key, salt, 2);
+
+	for (uint32_t ssrc = 1; ssrc <= 3; ssrc++) {
+		size_t size = Hex(kRtp, packet);
+		memset(packet + 8, 0, 3);
+		packet[11] = (uint8_t)ssrc;
+		int n = session.ProtectRtp(packet, size, sizeof(packet));
+		MEDIA_TEST_CHECK(ssrc <= 2 ? n > 0 : n == kSrtpErrorStreams);
+	}
+	MEDIA_TEST_CHECK(session.StreamCount() == 2);
+	MEDIA_TEST_CHECK(!session.RemoveStream(3));
+	MEDIA_TEST_CHECK(session.RemoveStream(1));
+	MEDIA_TEST_CHECK(session.StreamCount() == 1);
+
+	size_t size = Hex(kRtp, packet);
+	memset(packet + 8, 0, 3);
+	packet[11] = 3;
+	MEDIA_TEST_CHECK(session.ProtectRtp(packet, size, sizeof(packet)) > 0);
+	MEDIA_TEST_CHECK(session.StreamCount() == 2);
+	return 0;
+}
@@ -0,0 +1,16 @@
+import XCTest
+import MediaTestSupport
+
+final class AudioLevelTests: XCTestCase {
+    func testActiveSpeakerWithoutVoiceBit() throws {
+        XCTAssertEqual(MediaTest_ActiveSpeakerWithoutVoiceBit(), 0)
+    }
+
+    func testActiveSpeakerVoiceGate() throws {
+        XCTAssertEqual(MediaTest_ActiveSpeakerVoiceGate(), 0)
+    }
+
+    func testAudioLevelShortPacket() throws {
+        XCTAssertEqual(MediaTest_AudioLevelShortPacket(), 0)
+    }
+}
@@ -0,0 +1,12 @@
+import XCTest
+import MediaTestSupport
+
+final class AudioMixerTests: XCTestCase {
+    func testMixMinus() throws {
+        XCTAssertEqual(MediaTest_AudioMixerMixMinus(), 0)
+    }
+
+    func testTopSpeakers() throws {
+        XCTAssertEqual(MediaTest_AudioMixerTopSpeakers(), 0)
+    }
+}
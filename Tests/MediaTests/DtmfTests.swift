@@ -0,0 +1,8 @@
+import XCTest
+import MediaTestSupport
+
+final class DtmfTests: XCTestCase {
+    func testDetects40msDigits() throws {
+        XCTAssertEqual(MediaTest_DtmfDetects40msDigits(), 0)
+    }
+}
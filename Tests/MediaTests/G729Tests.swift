@@ -0,0 +1,16 @@
+import XCTest
+import MediaTestSupport
+
+final class G729Tests: XCTestCase {
+    func testSidEnergyQuantizer() throws {
+        XCTAssertEqual(MediaTest_G729SidEnergyQuantizer(), 0)
+    }
+
+    func testComfortNoiseLevel() throws {
+        XCTAssertEqual(MediaTest_G729ComfortNoiseLevel(), 0)
+    }
+
+    func testDecodePayloadLength() throws {
+        XCTAssertEqual(MediaTest_G729DecodePayloadLength(), 0)
+    }
+}
@@ -0,0 +1,72 @@
+import XCTest
+import MediaTestSupport
+
+final class H264Tests: XCTestCase {
+    func testRbspKnownBytes() throws {
+        XCTAssertEqual(MediaTest_H264RbspKnownBytes(), 0)
+    }
+
+    func testRbspRoundTrip() throws {
+        XCTAssertEqual(MediaTest_H264RbspRoundTrip(), 0)
+    }
+
+    func testNaluKnownBytes() throws {
+        XCTAssertEqual(MediaTest_H264NaluKnownBytes(), 0)
+    }
+
+    func testNaluBlockBoundaries() throws {
+        XCTAssertEqual(MediaTest_H264NaluBlockBoundaries(), 0)
+    }
+
+    func testNaluRandomFrames() throws {
+        XCTAssertEqual(MediaTest_H264NaluRandomFrames(), 0)
+    }
+
+    func testNaluCapacity() throws {
+        XCTAssertEqual(MediaTest_H264NaluCapacity(), 0)
+    }
+
+    func testParseSps() throws {
+        XCTAssertEqual(MediaTest_H264ParseSps(), 0)
+    }
+
+    func testParsePps() throws {
+        XCTAssertEqual(MediaTest_H264ParsePps(), 0)
+    }
+
+    func testParseSliceHeader() throws {
+        XCTAssertEqual(MediaTest_H264ParseSliceHeader(), 0)
+    }
+
+    func testBitReaderLimits() throws {
+        XCTAssertEqual(MediaTest_H264BitReaderLimits(), 0)
+    }
+
+    func testBitReaderRoundTrip() throws {
+        XCTAssertEqual(MediaTest_H264BitReaderRoundTrip(), 0)
+    }
+
+    func testAssemblerKeyframe() throws {
+        XCTAssertEqual(MediaTest_H264AssemblerKeyframe(), 0)
+    }
+
+    func testAssemblerFrameSpanningRing() throws {
+        XCTAssertEqual(MediaTest_H264AssemblerFrameSpanningRing(), 0)
+    }
+
+    func testAssemblerEvictedPendingFrame() throws {
+        XCTAssertEqual(MediaTest_H264AssemblerEvictedPendingFrame(), 0)
+    }
+
+    func testPacketizerPaths() throws {
+        XCTAssertEqual(MediaTest_H264PacketizerPaths(), 0)
+    }
+
+    func testPacketizerSizeLimits() throws {
+        XCTAssertEqual(MediaTest_H264PacketizerSizeLimits(), 0)
+    }
+
+    func testPacketizerNoAggregation() throws {
+        XCTAssertEqual(MediaTest_H264PacketizerNoAggregation(), 0)
+    }
+}
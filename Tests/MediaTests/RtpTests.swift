@@ -0,0 +1,44 @@
+import XCTest
+import MediaTestSupport
+
+final class RtpTests: XCTestCase {
+    func testFecRecoversMediaSsrc() throws {
+        XCTAssertEqual(MediaTest_RtpFecRecoversMediaSsrc(), 0)
+    }
+
+    func testAbsoluteSendTime() throws {
+        XCTAssertEqual(MediaTest_RtpAbsoluteSendTime(), 0)
+    }
+
+    func testParseNack() throws {
+        XCTAssertEqual(MediaTest_RtcpParseNack(), 0)
+    }
+
+    func testHistoryNackTiming() throws {
+        XCTAssertEqual(MediaTest_RtpHistoryNackTiming(), 0)
+    }
+
+    func testHistoryRtx() throws {
+        XCTAssertEqual(MediaTest_RtpHistoryRtx(), 0)
+    }
+
+    func testPacerTokenBucket() throws {
+        XCTAssertEqual(MediaTest_RtpPacerTokenBucket(), 0)
+    }
+
+    func testPacerPriorities() throws {
+        XCTAssertEqual(MediaTest_RtpPacerPriorities(), 0)
+    }
+
+    func testPacerDrainRate() throws {
+        XCTAssertEqual(MediaTest_RtpPacerDrainRate(), 0)
+    }
+
+    func testPacerSchedulerExact() throws {
+        XCTAssertEqual(MediaTest_RtpPacerSchedulerExact(), 0)
+    }
+
+    func testPacerSchedulerTicks() throws {
+        XCTAssertEqual(MediaTest_RtpPacerSchedulerTicks(), 0)
+    }
+}
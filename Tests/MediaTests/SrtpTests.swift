@@ -0,0 +1,20 @@
+import XCTest
+import MediaTestSupport
+
+final class SrtpTests: XCTestCase {
+    func testKeyDerivation() throws {
+        XCTAssertEqual(MediaTest_SrtpKeyDerivation(), 0)
+    }
+
+    func testProtectVectors() throws {
+        XCTAssertEqual(MediaTest_SrtpProtectVectors(), 0)
+    }
+
+    func testSrtcpProtectVectors() throws {
+        XCTAssertEqual(MediaTest_SrtcpProtectVectors(), 0)
+    }
+
+    func testRemoveStream() throws {
+        XCTAssertEqual(MediaTest_SrtpRemoveStream(), 0)
+    }
+}
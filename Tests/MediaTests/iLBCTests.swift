@@ -0,0 +1,12 @@
+import XCTest
+import MediaTestSupport
+
+final class iLBCTests: XCTestCase {
+    func testStreamsIndependent() throws {
+        XCTAssertEqual(MediaTest_iLBCStreamsIndependent(), 0)
+    }
+
+    func testFixedFloatInterop() throws {
+        XCTAssertEqual(MediaTest_iLBCFixedFloatInterop(), 0)
+    }
+}